@@ -72,6 +72,7 @@
 #define MIN_VAR_ALLOC	  32
 #define BLOCK_STACK_DEPTH  32
 #define MAX_EXPECTED_ERRORS 10
+#define MAX_COLUMNS	256
 #define QUERY_SEND  1
 #define QUERY_REAP  2
 #ifndef MYSQL_MANAGER_PORT
@@ -209,7 +210,7 @@ Q_ENABLE_RESULT_LOG, Q_DISABLE_RESULT_LOG,
 Q_SERVER_START, Q_SERVER_STOP,Q_REQUIRE_MANAGER,
 Q_WAIT_FOR_SLAVE_TO_STOP,
 Q_REQUIRE_VERSION,
-Q_EXEC,
+Q_EXEC,		    Q_REPLACE_COLUMN,
 Q_UNKNOWN,			       /* Unknown command.   */
 Q_COMMENT,			       /* Comments, ignored. */
 Q_COMMENT_WITH_COMMAND
@@ -276,6 +277,7 @@ const char *command_names[]=
   "wait_for_slave_to_stop",
   "require_version",
   "exec",
+  "replace_column",
   0
 };
 
@@ -316,6 +318,7 @@ struct st_replace *init_replace(my_string *from, my_string *to, uint count,
 uint replace_strings(struct st_replace *rep, my_string *start,
 		     uint *max_length, const char *from);
 void free_replace();
+static void free_replace_column();
 static int insert_pointer_name(reg1 POINTER_ARRAY *pa,my_string name);
 void free_pointer_array(POINTER_ARRAY *pa);
 static int initialize_replace_buffer(void);
@@ -325,6 +328,8 @@ void str_to_file(const char *fname, char *str, int size);
 int do_server_op(struct st_query* q,const char *op);
 
 struct st_replace *glob_replace;
+static char *replace_column[MAX_COLUMNS];
+static uint max_replace_column= 0;
 static char *out_buff;
 static uint out_length;
 static int eval_result = 0;
@@ -434,6 +439,7 @@ static void free_used_memory()
   delete_dynamic(&q_lines);
   dynstr_free(&ds_res);
   free_replace();
+  free_replace_column();
   my_free(pass,MYF(MY_ALLOW_ZERO_PTR));
   free_defaults(default_argv);
   mysql_server_end();
@@ -1350,6 +1356,55 @@ void free_replace()
   DBUG_VOID_RETURN;
 }
 
+
+/*
+  Get arguments for replace_column. The syntax is:
+  replace_column column_number to_string [column_number to_string ...]
+  Where each argument may be quoted with ' or "
+  The given columns of the result of the next query are replaced with
+  the strings.
+*/
+
+static void get_replace_column(struct st_query *q)
+{
+  char *from=q->first_argument;
+  char *buff,*start;
+  DBUG_ENTER("get_replace_column");
+
+  free_replace_column();
+  if (!*from)
+    die("Missing argument in %s\n", q->query);
+  start=buff=my_malloc(strlen(from)+1,MYF(MY_WME | MY_FAE));
+  while (*from)
+  {
+    char *to;
+    uint column_number;
+
+    to=get_string(&buff, &from, q);
+    if (!(column_number= atoi(to)) || column_number > MAX_COLUMNS)
+      die("Wrong column number to replace_column in %s\n", q->query);
+    if (!*from)
+      die("Wrong number of arguments to replace_column in %s\n", q->query);
+    to=get_string(&buff, &from, q);
+    my_free(replace_column[column_number-1], MYF(MY_ALLOW_ZERO_PTR));
+    replace_column[column_number-1]= my_strdup(to, MYF(MY_WME | MY_FAE));
+    set_if_bigger(max_replace_column, column_number);
+  }
+  my_free(start, MYF(0));
+  DBUG_VOID_RETURN;
+}
+
+static void free_replace_column()
+{
+  uint i;
+  for (i=0 ; i < max_replace_column ; i++)
+  {
+    my_free(replace_column[i], MYF(MY_ALLOW_ZERO_PTR));
+    replace_column[i]= 0;
+  }
+  max_replace_column= 0;
+}
+
 int select_connection(char *p)
 {
   char* name;
@@ -2214,7 +2269,12 @@ int run_query(MYSQL* mysql, struct st_query* q, int flags)
 	val = (char*)row[i];
 	len = lengths[i];
 
-	if (!val)
+	if (i < max_replace_column && replace_column[i])
+	{
+	  val = replace_column[i];
+	  len = strlen(val);
+	}
+	else if (!val)
 	{
 	  val = (char*)"NULL";
 	  len = 4;
@@ -2245,6 +2305,7 @@ end:
   if (res)
     mysql_free_result(res);
   last_result=0;
+  free_replace_column();
   if (ds == &ds_tmp)
     dynstr_free(&ds_tmp);
   if (q->type == Q_EVAL)
@@ -2514,6 +2575,9 @@ int main(int argc, char** argv)
       case Q_REPLACE:
 	get_replace(q);
 	break;
+      case Q_REPLACE_COLUMN:
+	get_replace_column(q);
+	break;
       case Q_SAVE_MASTER_POS: do_save_master_pos(); break;
       case Q_SYNC_WITH_MASTER: do_sync_with_master(q); break;
       case Q_SYNC_SLAVE_WITH_MASTER:
@@ -696,6 +696,9 @@
 /* Define to 1 if you have the <sys/dir.h> header file. */
 #define HAVE_SYS_DIR_H 1
 
+/* Define to 1 if you have the <sys/epoll.h> header file. */
+/* #undef HAVE_SYS_EPOLL_H */
+
 /* Define to 1 if you have the <sys/file.h> header file. */
 #define HAVE_SYS_FILE_H 1
 
@@ -19,7 +19,11 @@
 #include "heapdef.h"
 
 static int check_one_key(HP_KEYDEF *keydef, uint keynr, ulong records,
-			 ulong blength, my_bool print_status);
+			 my_bool print_status);
+static int check_one_rb_key(HP_INFO *info, uint keynr, ulong records,
+			    my_bool print_status);
+static int check_hash_table(HP_KEYDEF *keydef, HP_HASH_TABLE *table,
+			    ulong *found, ulong *seek, ulong *max_links);
 
 /*
   Check if keys and rows are ok in a heap table
@@ -47,8 +51,13 @@ int heap_check_heap(HP_INFO *info,my_bool print_status)
   DBUG_ENTER("heap_check_heap");
 
   for (error=key= 0 ; key < share->keys ; key++)
-    error|=check_one_key(share->keydef+key,key, share->records,share->blength,
-			 print_status);
+  {
+    if (share->keydef[key].algorithm == HA_KEY_ALG_BTREE)
+      error|=check_one_rb_key(info,key, share->records, print_status);
+    else
+      error|=check_one_key(share->keydef+key,key, share->records,
+			   print_status);
+  }
 
   /*
     This is basicly the same code as in hp_scan, but we repeat it here to
@@ -90,51 +99,128 @@ int heap_check_heap(HP_INFO *info,my_bool print_status)
 
 
 static int check_one_key(HP_KEYDEF *keydef, uint keynr, ulong records,
-			 ulong blength, my_bool print_status)
+			 my_bool print_status)
 {
   int error;
-  uint i,found,max_links,seek,links;
-  uint rec_link;				/* Only used with debugging */
-  HASH_INFO *hash_info;
+  ulong found,seek,max_links;
 
-  error=0;
-  for (i=found=max_links=seek=0 ; i < records ; i++)
-  {
-    hash_info=hp_find_hash(&keydef->block,i);
-    if (_hp_mask(_hp_rec_hashnr(keydef,hash_info->ptr_to_rec),
-		 blength,records) == i)
-    {
-      found++;
-      seek++;
-      links=1;
-      while ((hash_info=hash_info->next_key) && found < records + 1)
-      {
-	seek+= ++links;
-	if ((rec_link=_hp_mask(_hp_rec_hashnr(keydef,hash_info->ptr_to_rec),
-			       blength,records))
-	    != i)
-	{
-	  DBUG_PRINT("error",("Record in wrong link: Link %d  Record: %lx  Record-link %d", i,hash_info->ptr_to_rec,rec_link));
-	  error=1;
-	}
-	else
-	  found++;
-      }
-      if (links > max_links) max_links=links;
-    }
-  }
+  found=seek=max_links=0;
+  error=check_hash_table(keydef,&keydef->hash,&found,&seek,&max_links);
+  if (keydef->old_hash.slot)
+    error|=check_hash_table(keydef,&keydef->old_hash,&found,&seek,
+			    &max_links);
   if (found != records)
   {
-    DBUG_PRINT("error",("Found %ld of %ld records"));
+    DBUG_PRINT("error",("Found %ld of %ld records",found,records));
     error=1;
   }
   DBUG_PRINT("info",
-	     ("records: %ld   seeks: %d   max links: %d   hitrate: %.2f",
+	     ("records: %ld   seeks: %ld   max links: %ld   hitrate: %.2f",
 	      records,seek,max_links,
 	      (float) seek / (float) (records ? records : 1)));
   if (print_status)
-    printf("Key: %d  records: %ld   seeks: %d   max links: %d   hitrate: %.2f\n",
+    printf("Key: %d  records: %ld   seeks: %ld   max links: %ld   hitrate: %.2f\n",
 	   keynr, records, seek, max_links,
 	   (float) seek / (float) (records ? records : 1));
   return error;
 }
+
+
+	/*
+	  Check that the rb_tree of a BTREE key has one key for every row
+	  and that the keys are in order.
+	*/
+
+static int check_one_rb_key(HP_INFO *info, uint keynr, ulong records,
+			    my_bool print_status)
+{
+  HP_KEYDEF *keydef=info->s->keydef+keynr;
+  HP_RB_PARAM param;
+  int error=0;
+  ulong found=0;
+  byte *key,*prev_key=0;
+
+  param.keydef=keydef;
+  param.key_length=keydef->length;
+  param.compare_ref=1;
+  for (key=(byte*) tree_search_edge(&keydef->rb_tree,info->parents,
+				    &info->last_pos,
+				    offsetof(TREE_ELEMENT,left)) ;
+       key ;
+       key=(byte*) tree_search_next(&keydef->rb_tree,&info->last_pos,
+				    offsetof(TREE_ELEMENT,left),
+				    offsetof(TREE_ELEMENT,right)))
+  {
+    found++;
+    if (prev_key && _hp_rb_key_cmp(&param,prev_key,key) >= 0)
+    {
+      DBUG_PRINT("error",("Key %lu is not in order",found));
+      error=1;
+    }
+    prev_key=key;
+  }
+  if (found != records || keydef->rb_tree.elements_in_tree != records)
+  {
+    DBUG_PRINT("error",("Found %ld of %ld records (tree has %u)",found,
+			records,keydef->rb_tree.elements_in_tree));
+    error=1;
+  }
+  if (print_status)
+    printf("Key: %d  records: %ld   tree elements: %u\n",
+	   keynr, records, keydef->rb_tree.elements_in_tree);
+  return error;
+}
+
+
+	/*
+	  Check that every key has the right hash value and that it is
+	  found from its first slot without passing an empty slot.
+	*/
+
+static int check_hash_table(HP_KEYDEF *keydef, HP_HASH_TABLE *table,
+			    ulong *found, ulong *seek, ulong *max_links)
+{
+  int error=0;
+  ulong i,links,used,deleted;
+  HASH_INFO *hash_info,*pos;
+
+  for (i=used=deleted=0 ; i < table->size ; i++)
+  {
+    hash_info=table->slot+i;
+    if (!hp_slot_used(hash_info))
+    {
+      if (hash_info->ptr_to_rec)
+	deleted++;
+      continue;
+    }
+    used++;
+    if (hash_info->hashnr != _hp_rec_hashnr(keydef,hash_info->ptr_to_rec))
+    {
+      DBUG_PRINT("error",("Wrong hash value: Slot %lu  Record: %lx",
+			  i,hash_info->ptr_to_rec));
+      error=1;
+      continue;
+    }
+    for (pos=hp_first_slot(table,hash_info->hashnr), links=1 ;
+	 pos != hash_info && pos->ptr_to_rec ;
+	 pos=hp_next_slot(table,pos), links++) ;
+    if (pos != hash_info)
+    {
+      DBUG_PRINT("error",("Record in wrong link: Slot %lu  Record: %lx",
+			  i,hash_info->ptr_to_rec));
+      error=1;
+    }
+    *seek+= links;
+    if (links > *max_links)
+      *max_links=links;
+  }
+  *found+= used;
+  if (table == &keydef->hash &&
+      (used != table->records || deleted != table->deleted))
+  {
+    DBUG_PRINT("error",("Found %lu keys (%lu) and %lu deleted (%lu)",
+			used, table->records, deleted, table->deleted));
+    error=1;
+  }
+  return error;
+}
@@ -33,6 +33,15 @@
 #define HP_MIN_RECORDS_IN_BLOCK 16
 #define HP_MAX_RECORDS_IN_BLOCK 8192
 
+/*
+  The hash index of a key starts with HP_MIN_HASH_SLOTS slots. When it
+  is resized, each write moves HP_HASH_MOVE_SLOTS slots of the old hash
+  to the new one (see hp_hash.c)
+*/
+
+#define HP_MIN_HASH_SLOTS	16
+#define HP_HASH_MOVE_SLOTS	16
+
 	/* Some extern variables */
 
 extern LIST *heap_open_list,*heap_share_list;
@@ -40,17 +49,37 @@ extern LIST *heap_open_list,*heap_share_list;
 #define test_active(info) \
 if (!(info->update & HA_STATE_AKTIV))\
 { my_errno=HA_ERR_NO_ACTIVE_RECORD; DBUG_RETURN(-1); }
-#define hp_find_hash(A,B) ((HASH_INFO*) _hp_find_block((A),(B)))
 
 	/* Find pos for record and update it in info->current_ptr */
 #define _hp_find_record(info,pos) (info)->current_ptr= _hp_find_block(&(info)->s->block,pos)
 
 typedef struct st_hp_hash_info
 {
-  struct st_hp_hash_info *next_key;
-  byte *ptr_to_rec;
+  byte *ptr_to_rec;			/* 0 if slot is free */
+  ulong hashnr;				/* _hp_rec_hashnr() of key */
 } HASH_INFO;
 
+#define HP_DELETED_SLOT ((byte*) 1)	/* ptr_to_rec of deleted key */
+#define hp_slot_used(P) ((P)->ptr_to_rec > HP_DELETED_SLOT)
+
+	/* First and next slot to probe for a hash value */
+#define hp_hash_mix(N) ((uint32) ((uint32) (N)*0x9E3779B1UL))
+#define hp_first_slot(T,N) \
+  ((T)->slot+((hp_hash_mix(N) ^ (hp_hash_mix(N) >> 15)) & ((T)->size-1)))
+#define hp_next_slot(T,P) ((P)+1 == (T)->slot+(T)->size ? (T)->slot : (P)+1)
+
+	/* Compare argument of the rb_tree of a BTREE key */
+typedef struct st_hp_rb_param
+{
+  HP_KEYDEF *keydef;
+  uint key_length;			/* Length of search key */
+  my_bool compare_ref;			/* Order equal keys by row pointer */
+} HP_RB_PARAM;
+
+	/* A key in the rb_tree is the key followed by the row pointer */
+#define hp_rb_key_length(K) ((K)->length+sizeof(byte*))
+#define hp_rb_element_size(T) (sizeof(TREE_ELEMENT)+(T)->size_of_element)
+
 	/* Prototypes for intern functions */
 
 extern HP_SHARE *_hp_find_named_heap(const char *name);
@@ -61,11 +90,25 @@ extern int _hp_get_new_block(HP_BLOCK *info, ulong* alloc_length);
 extern void _hp_free(HP_SHARE *info);
 extern byte *_hp_free_level(HP_BLOCK *block,uint level,HP_PTRS *pos,
 				byte *last_pos);
-extern int _hp_write_key(HP_SHARE *info,HP_KEYDEF *keyinfo,
+extern int _hp_write_key(HP_INFO *info,HP_KEYDEF *keyinfo,
 			 const byte *record,byte *recpos);
+extern int _hp_rb_write_key(HP_INFO *info,HP_KEYDEF *keyinfo,
+			    const byte *record,byte *recpos);
+extern int _hp_rb_delete_key(HP_INFO *info,HP_KEYDEF *keyinfo,
+			     const byte *record,byte *recpos,int flag);
+extern int _hp_rb_key_cmp(HP_RB_PARAM *param,const byte *a,const byte *b);
+extern void _hp_rb_make_key(HP_KEYDEF *keydef,byte *key,const byte *rec,
+			    byte *recpos);
+extern byte *_hp_rb_row(HP_KEYDEF *keydef,const byte *key);
+extern byte *_hp_rb_search(HP_INFO *info,HP_KEYDEF *keyinfo,const byte *key,
+			   uint key_length,enum ha_rkey_function find_flag,
+			   my_bool compare_ref);
 extern int _hp_delete_key(HP_INFO *info,HP_KEYDEF *keyinfo,
 			  const byte *record,byte *recpos,int flag);
-extern HASH_INFO *_heap_find_hash(HP_BLOCK *block,ulong pos);
+extern int _hp_hash_reserve(HP_SHARE *info,HP_KEYDEF *keyinfo);
+extern HASH_INFO *_hp_hash_next(HP_KEYDEF *keyinfo,ulong hashnr,
+				const byte *key,HASH_INFO *pos);
+extern void _hp_hash_free(HP_SHARE *info,HP_KEYDEF *keyinfo);
 extern byte *_hp_search(HP_INFO *info,HP_KEYDEF *keyinfo,const byte *key,
 			    uint nextflag);
 extern byte *_hp_search_next(HP_INFO *info, HP_KEYDEF *keyinfo,
@@ -73,9 +116,6 @@ extern byte *_hp_search_next(HP_INFO *info, HP_KEYDEF *keyinfo,
 			     HASH_INFO *pos);
 extern ulong _hp_hashnr(HP_KEYDEF *keyinfo,const byte *key);
 extern ulong _hp_rec_hashnr(HP_KEYDEF *keyinfo,const byte *rec);
-extern ulong _hp_mask(ulong hashnr,ulong buffmax,ulong maxlength);
-extern void _hp_movelink(HASH_INFO *pos,HASH_INFO *next_link,
-			 HASH_INFO *newlink);
 extern int _hp_rec_key_cmp(HP_KEYDEF *keydef,const byte *rec1,
 			       const byte *rec2);
 extern int _hp_key_cmp(HP_KEYDEF *keydef,const byte *rec,
@@ -38,14 +38,13 @@ void _hp_clear(HP_SHARE *info)
   info->block.levels=0;
   for (key=0 ; key < info->keys ; key++)
   {
-    HP_BLOCK *block= &info->keydef[key].block;
-    if (block->levels)
-      VOID(_hp_free_level(block,block->levels,block->root,(byte*) 0));
-    block->levels=0;
-    block->last_allocated=0;
+    HP_KEYDEF *keydef=info->keydef+key;
+    if (keydef->algorithm == HA_KEY_ALG_BTREE)
+      delete_tree(&keydef->rb_tree);
+    else
+      _hp_hash_free(info,keydef);
   }
   info->records=info->deleted=info->data_length=info->index_length=0;
-  info->blength=1;
   info->changed=0;
   info->del_link=0;
   DBUG_VOID_RETURN;
@@ -32,13 +32,14 @@ int heap_delete(HP_INFO *info, const byte *record)
     DBUG_RETURN(my_errno);			/* Record changed */
   share->changed=1;
 
-  if ( --(share->records) < share->blength >> 1) share->blength>>=1;
+  share->records--;
   pos=info->current_ptr;
 
   for (key=0 ; key < share->keys ; key++)
   {
-    if (_hp_delete_key(info,share->keydef+key,record,pos,
-		       key == (uint) info->lastinx))
+    HP_KEYDEF *keydef=share->keydef+key;
+    if ((*keydef->delete_key)(info,keydef,record,pos,
+			      key == (uint) info->lastinx))
       goto err;
   }
 
@@ -54,8 +55,7 @@ int heap_delete(HP_INFO *info, const byte *record)
 
   DBUG_RETURN(0);
  err:
-  if (++(share->records) == share->blength)
-    share->blength+= share->blength;
+  share->records++;
   DBUG_RETURN(my_errno);
 }
 
@@ -65,93 +65,81 @@ int heap_delete(HP_INFO *info, const byte *record)
 int _hp_delete_key(HP_INFO *info, register HP_KEYDEF *keyinfo,
 		   const byte *record, byte *recpos, int flag)
 {
-  ulong blength,pos2,pos_hashnr,lastpos_hashnr;
-  HASH_INFO *lastpos,*gpos,*pos,*pos3,*empty,*last_ptr;
-  HP_SHARE *share=info->s;
+  ulong hashnr;
+  HP_HASH_TABLE *table= &keyinfo->hash;
+  HASH_INFO *pos,*last_ptr;
   DBUG_ENTER("_hp_delete_key");
 
-  blength=share->blength;
-  if (share->records+1 == blength)
-    blength+= blength;
-  lastpos=hp_find_hash(&keyinfo->block,share->records);
+  hashnr=_hp_rec_hashnr(keyinfo,record);
   last_ptr=0;
 
-  /* Search after record with key */
-  pos= hp_find_hash(&keyinfo->block,
-		    _hp_mask(_hp_rec_hashnr(keyinfo,record),blength,
-			     share->records+1));
-  gpos = pos3 = 0;
-
-  while (pos->ptr_to_rec != recpos)
+  /* Search after record with key; first in the new table */
+  for (;;)
   {
-    if (flag && !_hp_rec_key_cmp(keyinfo,record,pos->ptr_to_rec))
-      last_ptr=pos;				/* Previous same key */
-    gpos=pos;
-    if (!(pos=pos->next_key))
+    if (table->slot)
     {
-      DBUG_RETURN(my_errno=HA_ERR_CRASHED);	/* This shouldn't happend */
+      for (pos=hp_first_slot(table,hashnr) ;
+	   pos->ptr_to_rec ;
+	   pos=hp_next_slot(table,pos))
+      {
+	if (pos->ptr_to_rec == recpos)
+	  goto found;
+	if (flag && pos->hashnr == hashnr && hp_slot_used(pos) &&
+	    !_hp_rec_key_cmp(keyinfo,record,pos->ptr_to_rec))
+	  last_ptr=pos;				/* Previous same key */
+      }
     }
+    if (table != &keyinfo->hash || !keyinfo->old_hash.slot)
+      DBUG_RETURN(my_errno=HA_ERR_CRASHED);	/* This shouldn't happend */
+    table= &keyinfo->old_hash;
   }
 
-  /* Remove link to record */
-
+found:
   if (flag)
   {
     /* Save for heap_rnext/heap_rprev */
     info->current_hash_ptr=last_ptr;
+    info->key_version=info->s->key_version;
     info->current_ptr = last_ptr ? last_ptr->ptr_to_rec : 0;
     DBUG_PRINT("info",("Corrected current_ptr to point at: %lx",
 		       info->current_ptr));
   }
-  empty=pos;
-  if (gpos)
-    gpos->next_key=pos->next_key;	/* unlink current ptr */
-  else if (pos->next_key)
-  {
-    empty=pos->next_key;
-    pos->ptr_to_rec=empty->ptr_to_rec;
-    pos->next_key=empty->next_key;
-  }
+  /* Keep the slot used, so that the probe sequences of other keys hold */
+  pos->ptr_to_rec=HP_DELETED_SLOT;
+  table->records--;
+  table->deleted++;
+  DBUG_RETURN(0);
+}
 
-  if (empty == lastpos)			/* deleted last hash key */
-    DBUG_RETURN (0);
 
-  /* Move the last key (lastpos) */
-  lastpos_hashnr=_hp_rec_hashnr(keyinfo,lastpos->ptr_to_rec);
-  /* pos is where lastpos should be */
-  pos=hp_find_hash(&keyinfo->block,_hp_mask(lastpos_hashnr,share->blength,
-					    share->records));
-  if (pos == empty)			/* Move to empty position. */
+/*
+  Remove one key from the rb_tree of a BTREE key
+  If flag is set, heap_rnext() and heap_rprev() go on from the removed key
+*/
+
+int _hp_rb_delete_key(HP_INFO *info, register HP_KEYDEF *keyinfo,
+		      const byte *record, byte *recpos, int flag)
+{
+  HP_RB_PARAM param;
+  TREE *rb_tree= &keyinfo->rb_tree;
+  int error;
+  DBUG_ENTER("_hp_rb_delete_key");
+
+  _hp_rb_make_key(keyinfo,info->recbuf,record,recpos);
+  if (flag)
   {
-    empty[0]=lastpos[0];
-    DBUG_RETURN(0);
-  }
-  pos_hashnr=_hp_rec_hashnr(keyinfo,pos->ptr_to_rec);
-  /* pos3 is where the pos should be */
-  pos3= hp_find_hash(&keyinfo->block,
-		     _hp_mask(pos_hashnr,share->blength,share->records));
-  if (pos != pos3)
-  {					/* pos is on wrong posit */
-    empty[0]=pos[0];			/* Save it here */
-    pos[0]=lastpos[0];			/* This shold be here */
-    _hp_movelink(pos,pos3,empty);	/* Fix link to pos */
-    DBUG_RETURN(0);
+    memcpy(info->lastkey,info->recbuf,hp_rb_key_length(keyinfo));
+    info->lastkey_len=keyinfo->length;
+    info->last_pos=0;				/* Tree is changed */
   }
-  pos2= _hp_mask(lastpos_hashnr,blength,share->records+1);
-  if (pos2 == _hp_mask(pos_hashnr,blength,share->records+1))
-  {					/* Identical key-positions */
-    if (pos2 != share->records)
-    {
-      empty[0]=lastpos[0];
-      _hp_movelink(lastpos,pos,empty);
-      DBUG_RETURN(0);
-    }
-    pos3= pos;				/* Link pos->next after lastpos */
-  }
-  else pos3= 0;				/* Different positions merge */
-
-  empty[0]=lastpos[0];
-  _hp_movelink(pos3,empty,pos->next_key);
-  pos->next_key=empty;
+  param.keydef=keyinfo;
+  param.key_length=keyinfo->length;
+  param.compare_ref=1;
+  rb_tree->custom_arg= (void*) &param;
+  error=tree_delete(rb_tree,info->recbuf);
+  rb_tree->custom_arg=0;
+  if (error)
+    DBUG_RETURN(my_errno=HA_ERR_CRASHED);	/* This shouldn't happend */
+  info->s->index_length-= hp_rb_element_size(rb_tree);
   DBUG_RETURN(0);
 }
@@ -19,6 +19,70 @@
 #include "heapdef.h"
 #include <m_ctype.h>
 
+/*
+  The hash index of a key is an open addressing hash table with linear
+  probing. A slot has the row pointer and the hash value of the key, so a
+  probe reads the row only when the hash values are equal, and the index
+  can be resized without reading the rows.
+
+  A deleted key leaves HP_DELETED_SLOT in its slot, so that a probe
+  continues past it. The slot is reused by a later write.
+
+  When 3/4 of the slots are used (deleted slots included) a new table is
+  allocated, and the following writes each move HP_HASH_MOVE_SLOTS slots
+  of the old table to the new one, so that no single write has to move
+  the whole index. Until all keys are moved, a key is searched in both
+  tables; new keys are always written to the new table.
+*/
+
+/*
+  Find the next key equal to key
+
+  SYNOPSIS
+    _hp_hash_next()
+    keyinfo		Key definition
+    hashnr		_hp_hashnr() of key
+    key			Key to search after
+    pos			Last found slot, or 0 to start from the first
+
+  RETURN
+    0	No more keys
+    #	Slot of key
+*/
+
+HASH_INFO *_hp_hash_next(HP_KEYDEF *keyinfo, ulong hashnr, const byte *key,
+			 HASH_INFO *pos)
+{
+  HP_HASH_TABLE *table= &keyinfo->hash;
+
+  if (pos)
+  {
+    if (pos < table->slot || pos >= table->slot+table->size)
+      table= &keyinfo->old_hash;
+    pos=hp_next_slot(table,pos);
+  }
+  else
+  {
+    if (!table->slot)
+      return 0;
+    pos=hp_first_slot(table,hashnr);
+  }
+  for (;;)
+  {
+    for ( ; pos->ptr_to_rec ; pos=hp_next_slot(table,pos))
+    {
+      if (pos->hashnr == hashnr && pos->ptr_to_rec != HP_DELETED_SLOT &&
+	  !_hp_key_cmp(keyinfo,pos->ptr_to_rec,key))
+	return pos;
+    }
+    if (table != &keyinfo->hash || !keyinfo->old_hash.slot)
+      return 0;
+    table= &keyinfo->old_hash;			/* Search not moved keys */
+    pos=hp_first_slot(table,hashnr);
+  }
+}
+
+
 	/* Search after a record based on a key */
 	/* Sets info->current_ptr to found record */
 	/* next_flag:  Search=0, next=1, prev =2, same =3 */
@@ -27,59 +91,48 @@ byte *_hp_search(HP_INFO *info, HP_KEYDEF *keyinfo, const byte *key,
 		 uint nextflag)
 {
   reg1 HASH_INFO *pos,*prev_ptr;
-  int flag;
   uint old_nextflag;
+  ulong hashnr;
   HP_SHARE *share=info->s;
   DBUG_ENTER("_hp_search");
 
+  info->key_version=share->key_version;
   old_nextflag=nextflag;
-  flag=1;
   prev_ptr=0;
 
   if (share->records)
   {
-    pos=hp_find_hash(&keyinfo->block,_hp_mask(_hp_hashnr(keyinfo,key),
-					      share->blength,share->records));
-    do
+    hashnr=_hp_hashnr(keyinfo,key);
+    for (pos=_hp_hash_next(keyinfo,hashnr,key,(HASH_INFO*) 0) ;
+	 pos ;
+	 pos=_hp_hash_next(keyinfo,hashnr,key,pos))
     {
-      if (!_hp_key_cmp(keyinfo,pos->ptr_to_rec,key))
-      {
-	switch (nextflag) {
-	case 0:					/* Search after key */
-	  DBUG_PRINT("exit",("found key at %d",pos->ptr_to_rec));
+      switch (nextflag) {
+      case 0:					/* Search after key */
+	DBUG_PRINT("exit",("found key at %d",pos->ptr_to_rec));
+	info->current_hash_ptr=pos;
+	DBUG_RETURN(info->current_ptr= pos->ptr_to_rec);
+      case 1:					/* Search next */
+	if (pos->ptr_to_rec == info->current_ptr)
+	  nextflag=0;
+	break;
+      case 2:					/* Search previous */
+	if (pos->ptr_to_rec == info->current_ptr)
+	{
+	  my_errno=HA_ERR_KEY_NOT_FOUND;	/* If gpos == 0 */
+	  info->current_hash_ptr=prev_ptr;
+	  DBUG_RETURN(info->current_ptr=prev_ptr ? prev_ptr->ptr_to_rec : 0);
+	}
+	prev_ptr=pos;				/* Prev. record found */
+	break;
+      case 3:					/* Search same */
+	if (pos->ptr_to_rec == info->current_ptr)
+	{
 	  info->current_hash_ptr=pos;
-	  DBUG_RETURN(info->current_ptr= pos->ptr_to_rec);
-	case 1:					/* Search next */
-	  if (pos->ptr_to_rec == info->current_ptr)
-	    nextflag=0;
-	  break;
-	case 2:					/* Search previous */
-	  if (pos->ptr_to_rec == info->current_ptr)
-	  {
-	    my_errno=HA_ERR_KEY_NOT_FOUND;	/* If gpos == 0 */
-	    info->current_hash_ptr=prev_ptr;
-	    DBUG_RETURN(info->current_ptr=prev_ptr ? prev_ptr->ptr_to_rec : 0);
-	  }
-	  prev_ptr=pos;				/* Prev. record found */
-	  break;
-	case 3:					/* Search same */
-	  if (pos->ptr_to_rec == info->current_ptr)
-	  {
-	    info->current_hash_ptr=pos;
-	    DBUG_RETURN(info->current_ptr);
-	  }
+	  DBUG_RETURN(info->current_ptr);
 	}
       }
-      if (flag)
-      {
-	flag=0;					/* Reset flag */
-	if (hp_find_hash(&keyinfo->block,
-			 _hp_mask(_hp_rec_hashnr(keyinfo,pos->ptr_to_rec),
-				  share->blength,share->records)) != pos)
-	  break;				/* Wrong link */
-      }
     }
-    while ((pos=pos->next_key));
   }
   my_errno=HA_ERR_KEY_NOT_FOUND;
   if (nextflag == 2 && ! info->current_ptr)
@@ -107,13 +160,13 @@ byte *_hp_search_next(HP_INFO *info, HP_KEYDEF *keyinfo, const byte *key,
 {
   DBUG_ENTER("_hp_search_next");
 
-  while ((pos= pos->next_key))
+  info->key_version=info->s->key_version;
+
+  /* A deleted or moved slot keeps the hash value of its key */
+  if ((pos=_hp_hash_next(keyinfo,pos->hashnr,key,pos)))
   {
-    if (!_hp_key_cmp(keyinfo,pos->ptr_to_rec,key))
-    {
-      info->current_hash_ptr=pos;
-      DBUG_RETURN (info->current_ptr= pos->ptr_to_rec);
-    }
+    info->current_hash_ptr=pos;
+    DBUG_RETURN (info->current_ptr= pos->ptr_to_rec);
   }
   my_errno=HA_ERR_KEY_NOT_FOUND;
   DBUG_PRINT("exit",("Error: %d",my_errno));
@@ -122,29 +175,120 @@ byte *_hp_search_next(HP_INFO *info, HP_KEYDEF *keyinfo, const byte *key,
 }
 
 
-	/* Calculate pos according to keys */
+	/* Move slots from old_hash to hash */
 
-ulong _hp_mask(ulong hashnr, ulong buffmax, ulong maxlength)
+static void hp_hash_move(HP_SHARE *info, HP_KEYDEF *keyinfo, ulong slots)
 {
-  if ((hashnr & (buffmax-1)) < maxlength) return (hashnr & (buffmax-1));
-  return (hashnr & ((buffmax >> 1) -1));
+  HP_HASH_TABLE *table= &keyinfo->hash, *old= &keyinfo->old_hash;
+  HASH_INFO *pos,*end,*empty;
+
+  if (slots > old->size - keyinfo->old_pos)
+    slots= old->size - keyinfo->old_pos;
+  info->key_version++;				/* Invalidate current_hash_ptr */
+  for (pos=old->slot+keyinfo->old_pos, end=pos+slots ;
+       pos < end && old->records ;
+       pos++)
+  {
+    if (!hp_slot_used(pos))
+      continue;
+    for (empty=hp_first_slot(table,pos->hashnr) ;
+	 hp_slot_used(empty) ;
+	 empty=hp_next_slot(table,empty)) ;
+    if (empty->ptr_to_rec)
+      table->deleted--;				/* Reuse deleted slot */
+    empty[0]=pos[0];
+    table->records++;
+    pos->ptr_to_rec=HP_DELETED_SLOT;		/* Not found twice */
+    old->records--;
+  }
+  keyinfo->old_pos= (ulong) (pos-old->slot);
+  if (!old->records)
+  {
+    info->index_length-= old->size*sizeof(HASH_INFO);
+    my_free((gptr) old->slot,MYF(0));
+    bzero((char*) old,sizeof(*old));
+    keyinfo->old_pos=0;
+  }
 }
 
 
-	/* Change link from pos to new_link */
+/*
+  Make room for one more key in the hash index
+
+  SYNOPSIS
+    _hp_hash_reserve()
+    info		Table
+    keyinfo		Key definition
+
+  NOTES
+    Moves some keys of a resize in progress, and starts a new resize if
+    3/4 of the slots are used. The new table is at least as big as the
+    old one and twice the number of keys, so it is at most half full
+    when the resize starts. The resize is done after at most
+    size/HP_HASH_MOVE_SLOTS writes, before the new table can be 3/4 full.
+
+  RETURN
+    0	ok
+    -1	Out of memory (my_errno is set)
+*/
 
-void _hp_movelink(HASH_INFO *pos, HASH_INFO *next_link, HASH_INFO *newlink)
+int _hp_hash_reserve(HP_SHARE *info, HP_KEYDEF *keyinfo)
 {
-  HASH_INFO *old_link;
-  do
+  HP_HASH_TABLE *table= &keyinfo->hash;
+  HASH_INFO *slot;
+  ulong size;
+  DBUG_ENTER("_hp_hash_reserve");
+
+  if (keyinfo->old_hash.slot)
+    hp_hash_move(info,keyinfo,HP_HASH_MOVE_SLOTS);
+  if ((table->records+table->deleted+1)*4 <= table->size*3)
+    DBUG_RETURN(0);
+  if (keyinfo->old_hash.slot)			/* Safety */
+    hp_hash_move(info,keyinfo,keyinfo->old_hash.size);
+
+  size= table->size ? table->size : HP_MIN_HASH_SLOTS;
+  while (size < (table->records+1)*2)
+    size<<=1;
+  DBUG_PRINT("info",("keys: %lu  deleted: %lu  slots: %lu -> %lu",
+		     table->records,table->deleted,table->size,size));
+  if (!(slot=(HASH_INFO*) my_malloc(size*sizeof(HASH_INFO),
+				    MYF(MY_ZEROFILL))))
+  {
+    /* We can go on until the table is full */
+    DBUG_RETURN(table->records+table->deleted+1 < table->size ? 0 : -1);
+  }
+  info->index_length+= size*sizeof(HASH_INFO);
+  if (table->records)
   {
-    old_link=next_link;
+    keyinfo->old_hash= *table;
+    keyinfo->old_pos=0;
   }
-  while ((next_link=next_link->next_key) != pos);
-  old_link->next_key=newlink;
-  return;
+  else if (table->slot)
+  {
+    info->index_length-= table->size*sizeof(HASH_INFO);
+    my_free((gptr) table->slot,MYF(0));
+    info->key_version++;
+  }
+  table->slot=slot;
+  table->size=size;
+  table->records=table->deleted=0;
+  DBUG_RETURN(0);
 }
 
+
+	/* Free the hash index of a key */
+
+void _hp_hash_free(HP_SHARE *info, HP_KEYDEF *keyinfo)
+{
+  info->key_version++;
+  my_free((gptr) keyinfo->hash.slot,MYF(MY_ALLOW_ZERO_PTR));
+  my_free((gptr) keyinfo->old_hash.slot,MYF(MY_ALLOW_ZERO_PTR));
+  bzero((char*) &keyinfo->hash,sizeof(keyinfo->hash));
+  bzero((char*) &keyinfo->old_hash,sizeof(keyinfo->old_hash));
+  keyinfo->old_pos=0;
+}
+
+
 #ifndef NEW_HASH_FUNCTION
 
 	/* Calc hashvalue for a key */
@@ -325,12 +469,33 @@ ulong _hp_rec_hashnr(register HP_KEYDEF *keydef, register const byte *rec)
 #endif
 
 
+/*
+  Compare a key of one binary part (keydef->bin_length is set).
+  Keys of 4 and 8 bytes, like most integer keys, are compared as words.
+*/
+
+static inline int hp_bin_cmp(const byte *a, const byte *b, uint length)
+{
+  switch (length) {
+  case 4:
+    return uint4korr(a) != uint4korr(b);
+  case 8:
+    return uint4korr(a) != uint4korr(b) || uint4korr(a+4) != uint4korr(b+4);
+  default:
+    return memcmp(a,b,length) != 0;
+  }
+}
+
+
 	/* Compare keys for two records. Returns 0 if they are identical */
 
 int _hp_rec_key_cmp(HP_KEYDEF *keydef, const byte *rec1, const byte *rec2)
 {
   HP_KEYSEG *seg,*endseg;
 
+  if (keydef->bin_length)
+    return hp_bin_cmp(rec1+keydef->seg->start,rec2+keydef->seg->start,
+		      keydef->bin_length);
   for (seg=keydef->seg,endseg=seg+keydef->keysegs ; seg < endseg ; seg++)
   {
     if (seg->null_bit)
@@ -361,6 +526,8 @@ int _hp_key_cmp(HP_KEYDEF *keydef, const byte *rec, const byte *key)
 {
   HP_KEYSEG *seg,*endseg;
 
+  if (keydef->bin_length)
+    return hp_bin_cmp(rec+keydef->seg->start,key,keydef->bin_length);
   for (seg=keydef->seg,endseg=seg+keydef->keysegs ;
        seg < endseg ;
        key+= (seg++)->length)
@@ -421,3 +588,260 @@ my_bool hp_if_null_in_key(HP_KEYDEF *keydef, const byte *record)
   }
   return 0;
 }
+
+
+/*****************************************************************************
+  BTREE keys
+
+  The rows of a BTREE key are ordered in a red-black tree (mysys/tree.c).
+  A key in the tree is the key made by _hp_make_key() followed by the row
+  pointer, so that rows with equal keys are ordered by their address and
+  every row can be found and deleted.
+*****************************************************************************/
+
+#define hp_cmp_num(A,B) ((A) < (B) ? -1 : (A) == (B) ? 0 : 1)
+
+	/* Compare a not NULL key part of a BTREE key */
+
+static int hp_rb_seg_cmp(HP_KEYSEG *seg, const uchar *a, const uchar *b)
+{
+  switch ((enum ha_base_keytype) seg->type) {
+  case HA_KEYTYPE_TEXT:
+  case HA_KEYTYPE_VARTEXT:
+    return my_sortcmp((const char*) a,(const char*) b,seg->length);
+  case HA_KEYTYPE_INT8:
+    return hp_cmp_num((int) (signed char) *a,(int) (signed char) *b);
+  case HA_KEYTYPE_SHORT_INT:
+    return hp_cmp_num(sint2korr(a),sint2korr(b));
+  case HA_KEYTYPE_USHORT_INT:
+    return hp_cmp_num(uint2korr(a),uint2korr(b));
+  case HA_KEYTYPE_INT24:
+    return hp_cmp_num(sint3korr(a),sint3korr(b));
+  case HA_KEYTYPE_UINT24:
+    return hp_cmp_num(uint3korr(a),uint3korr(b));
+  case HA_KEYTYPE_LONG_INT:
+    return hp_cmp_num(sint4korr(a),sint4korr(b));
+  case HA_KEYTYPE_ULONG_INT:
+    return hp_cmp_num(uint4korr(a),uint4korr(b));
+#ifdef HAVE_LONG_LONG
+  case HA_KEYTYPE_LONGLONG:
+    return hp_cmp_num(sint8korr(a),sint8korr(b));
+  case HA_KEYTYPE_ULONGLONG:
+    return hp_cmp_num(uint8korr(a),uint8korr(b));
+#endif
+  case HA_KEYTYPE_FLOAT:
+  {
+    float f_1,f_2;
+    float4get(f_1,a);
+    float4get(f_2,b);
+    return hp_cmp_num(f_1,f_2);
+  }
+  case HA_KEYTYPE_DOUBLE:
+  {
+    double d_1,d_2;
+    float8get(d_1,a);
+    float8get(d_2,b);
+    return hp_cmp_num(d_1,d_2);
+  }
+  case HA_KEYTYPE_NUM:				/* Right aligned number string */
+  {
+    const uchar *end;
+    uint alength=seg->length, blength=seg->length;
+    int swap_flag=1;
+
+    for ( ; alength && *a == ' ' ; a++, alength--) ;
+    for ( ; blength && *b == ' ' ; b++, blength--) ;
+    if (alength && *a == '-')
+    {
+      if (!blength || *b != '-')
+	return -1;
+      a++; b++; alength--; blength--;
+      swap_flag= -1;				/* Bigger number is smaller */
+    }
+    else if (blength && *b == '-')
+      return 1;
+    for ( ; alength && (*a == '+' || *a == '0') ; a++, alength--) ;
+    for ( ; blength && (*b == '+' || *b == '0') ; b++, blength--) ;
+    if (alength != blength)
+      return alength < blength ? -swap_flag : swap_flag;
+    for (end=a+alength ; a < end ; a++, b++)
+      if (*a != *b)
+	return ((int) *a - (int) *b)*swap_flag;
+    return 0;
+  }
+  default:					/* Binary compare */
+    return memcmp(a,b,seg->length);
+  }
+}
+
+
+/*
+  Compare a key of the rb_tree with a search key
+
+  SYNOPSIS
+    _hp_rb_key_cmp()
+    param		Key definition and length of the search key
+    a			Key in the tree
+    b			Key to compare with
+
+  NOTES
+    Only the key parts in param->key_length bytes are compared, so a
+    search key may be a prefix of the key. NULL is smaller than all other
+    values. If param->compare_ref is set, equal keys are compared by
+    their row pointers.
+
+  RETURN
+    < 0, 0 or > 0 if a is smaller than, equal to or bigger than b
+*/
+
+int _hp_rb_key_cmp(HP_RB_PARAM *param, const byte *a, const byte *b)
+{
+  HP_KEYDEF *keydef=param->keydef;
+  HP_KEYSEG *seg,*endseg;
+  const uchar *key_a=(const uchar*) a, *key_b=(const uchar*) b;
+  int length=(int) param->key_length;
+  int flag;
+
+  for (seg=keydef->seg,endseg=seg+keydef->keysegs ;
+       seg < endseg && length > 0 ;
+       key_a+=seg->length, key_b+=seg->length, length-=(seg++)->length)
+  {
+    if (seg->null_bit)
+    {
+      length--;
+      if (*key_a++ != *key_b++)
+	return key_a[-1] ? -1 : 1;		/* NULL is smallest */
+      if (key_a[-1])
+	continue;				/* Both are NULL */
+    }
+    if ((flag=hp_rb_seg_cmp(seg,key_a,key_b)))
+      return flag;
+  }
+  if (param->compare_ref)
+  {
+    byte *ref_a,*ref_b;
+    memcpy_fixed((byte*) &ref_a,a+keydef->length,sizeof(byte*));
+    memcpy_fixed((byte*) &ref_b,b+keydef->length,sizeof(byte*));
+    return ref_a < ref_b ? -1 : ref_a == ref_b ? 0 : 1;
+  }
+  return 0;
+}
+
+
+	/* Make the key of a row in the rb_tree */
+
+void _hp_rb_make_key(HP_KEYDEF *keydef, byte *key, const byte *rec,
+		     byte *recpos)
+{
+  _hp_make_key(keydef,key,rec);
+  memcpy_fixed(key+keydef->length,(byte*) &recpos,sizeof(byte*));
+}
+
+
+	/* Get the row of a key in the rb_tree */
+
+byte *_hp_rb_row(HP_KEYDEF *keydef, const byte *key)
+{
+  byte *pos;
+  memcpy_fixed((byte*) &pos,key+keydef->length,sizeof(byte*));
+  return pos;
+}
+
+
+/*
+  Search after a row with a BTREE key
+
+  SYNOPSIS
+    _hp_rb_search()
+    info		Table handler. info->last_pos is set for heap_rnext()
+			and heap_rprev()
+    keyinfo		BTREE key
+    key			Key to search after
+    key_length		Length of key; may be a prefix of the key
+    find_flag		How to search
+    compare_ref		Set if key is a whole key of the rb_tree
+
+  RETURN
+    0	Not found (my_errno is set)
+    #	Found row
+*/
+
+byte *_hp_rb_search(HP_INFO *info, HP_KEYDEF *keyinfo, const byte *key,
+		    uint key_length, enum ha_rkey_function find_flag,
+		    my_bool compare_ref)
+{
+  HP_RB_PARAM param;
+  byte *pos;
+  DBUG_ENTER("_hp_rb_search");
+
+  param.keydef=keyinfo;
+  param.key_length=key_length;
+  param.compare_ref=compare_ref;
+  info->lastkey_len=0;
+  if (!(pos=(byte*) tree_search_key(&keyinfo->rb_tree,key,info->parents,
+				     &info->last_pos,find_flag,&param)))
+  {
+    info->last_pos=0;
+    info->current_ptr=0;
+    my_errno=HA_ERR_KEY_NOT_FOUND;
+    DBUG_RETURN(0);
+  }
+  DBUG_RETURN(info->current_ptr=_hp_rb_row(keyinfo,pos));
+}
+
+
+/*
+  Estimate the number of rows between two keys of a BTREE key
+
+  SYNOPSIS
+    hp_rb_records_in_range()
+    info		Table handler
+    inx			Index; must be a BTREE key
+    start_key		Start of range, or 0 for the first row
+    start_key_len	Length of start_key
+    start_search_flag	HA_READ_KEY_EXACT or HA_READ_AFTER_KEY
+    end_key		End of range, or 0 for the last row
+    end_key_len		Length of end_key
+    end_search_flag	HA_READ_BEFORE_KEY or HA_READ_AFTER_KEY
+
+  RETURN
+    HA_POS_ERROR	Not a BTREE key or not supported search flag
+    #			Estimated number of rows
+*/
+
+ha_rows hp_rb_records_in_range(HP_INFO *info, int inx,
+			       const byte *start_key, uint start_key_len,
+			       enum ha_rkey_function start_search_flag,
+			       const byte *end_key, uint end_key_len,
+			       enum ha_rkey_function end_search_flag)
+{
+  ha_rows start_pos,end_pos;
+  HP_KEYDEF *keyinfo= info->s->keydef+inx;
+  TREE *rb_tree= &keyinfo->rb_tree;
+  HP_RB_PARAM param;
+
+  if (keyinfo->algorithm != HA_KEY_ALG_BTREE)
+    return HA_POS_ERROR;
+  param.keydef=keyinfo;
+  param.compare_ref=0;
+  if (start_key)
+  {
+    param.key_length=start_key_len;
+    start_pos=tree_record_pos(rb_tree,start_key,start_search_flag,&param);
+  }
+  else
+    start_pos=0;
+
+  if (end_key)
+  {
+    param.key_length=end_key_len;
+    end_pos=tree_record_pos(rb_tree,end_key,end_search_flag,&param);
+  }
+  else
+    end_pos=rb_tree->elements_in_tree + (ha_rows) 1;
+
+  if (start_pos == HA_POS_ERROR || end_pos == HA_POS_ERROR)
+    return HA_POS_ERROR;
+  return end_pos < start_pos ? (ha_rows) 0 :
+    (end_pos == start_pos ? (ha_rows) 1 : end_pos - start_pos);
+}
@@ -42,7 +42,9 @@ HP_INFO *heap_open(const char *name, int mode, uint keys, HP_KEYDEF *keydef,
     for (i=key_segs=max_length=0 ; i < keys ; i++)
     {
       key_segs+= keydef[i].keysegs;
-      bzero((char*) &keydef[i].block,sizeof(keydef[i].block));
+      bzero((char*) &keydef[i].hash,sizeof(keydef[i].hash));
+      bzero((char*) &keydef[i].old_hash,sizeof(keydef[i].old_hash));
+      keydef[i].old_pos=0;
       for (j=length=0 ; j < keydef[i].keysegs; j++)
       {
 	length+=keydef[i].seg[j].length;
@@ -54,6 +56,14 @@ HP_INFO *heap_open(const char *name, int mode, uint keys, HP_KEYDEF *keydef,
 	}
       }
       keydef[i].length=length;
+      if (keydef[i].algorithm != HA_KEY_ALG_BTREE)
+	keydef[i].algorithm= HA_KEY_ALG_HASH;
+      /* One binary part is compared with a word compare or memcmp() */
+      keydef[i].bin_length= (keydef[i].algorithm == HA_KEY_ALG_HASH &&
+			     keydef[i].keysegs == 1 &&
+			     !keydef[i].seg[0].null_bit &&
+			     keydef[i].seg[0].type != HA_KEYTYPE_TEXT ?
+			     keydef[i].seg[0].length : 0);
       if (length > max_length)
 	max_length=length;
     }
@@ -76,15 +86,25 @@ HP_INFO *heap_open(const char *name, int mode, uint keys, HP_KEYDEF *keydef,
       memcpy(keyseg,keydef[i].seg,
 	     (size_t) (sizeof(keyseg[0])*keydef[i].keysegs));
       keyseg+=keydef[i].keysegs;
-      init_block(&share->keydef[i].block,sizeof(HASH_INFO),min_records,
-		 max_records);
+      if (keydef[i].algorithm == HA_KEY_ALG_BTREE)
+      {
+	init_tree(&share->keydef[i].rb_tree,0,0,
+		  (int) hp_rb_key_length(&keydef[i]),
+		  (qsort_cmp2) _hp_rb_key_cmp,1,NULL,NULL);
+	share->keydef[i].write_key= _hp_rb_write_key;
+	share->keydef[i].delete_key= _hp_rb_delete_key;
+      }
+      else
+      {
+	share->keydef[i].write_key= _hp_write_key;
+	share->keydef[i].delete_key= _hp_delete_key;
+      }
     }
 
     share->min_records=min_records;
     share->max_records=max_records;
     share->data_length=share->index_length=0;
     share->reclength=reclength;
-    share->blength=1;
     share->keys=keys;
     share->max_key_length=max_length;
     share->changed=0;
@@ -101,8 +121,9 @@ HP_INFO *heap_open(const char *name, int mode, uint keys, HP_KEYDEF *keydef,
     share->open_list.data=(void*) share;
     heap_share_list=list_add(heap_share_list,&share->open_list);
   }
+  /* lastkey and recbuf can hold a key of the rb_tree of a BTREE key */
   if (!(info= (HP_INFO*) my_malloc((uint) sizeof(HP_INFO)+
-				  share->max_key_length,
+				  2*(share->max_key_length+sizeof(byte*)),
 				  MYF(MY_ZEROFILL))))
   {
     pthread_mutex_unlock(&THR_LOCK_heap);
@@ -118,6 +139,7 @@ HP_INFO *heap_open(const char *name, int mode, uint keys, HP_KEYDEF *keydef,
 
   info->s=share;
   info->lastkey=(byte*) (info+1);
+  info->recbuf=info->lastkey+share->max_key_length+sizeof(byte*);
   info->mode=mode;
   info->current_record= (ulong) ~0L;		/* No current record */
   info->current_ptr=0;
@@ -16,11 +16,35 @@
 
 #include "heapdef.h"
 
-/* Read first record with the current key */
+/* Read first record with the key inx */
 
-int heap_rfirst(HP_INFO *info, byte *record)
+int heap_rfirst(HP_INFO *info, byte *record, int inx)
 {
+  HP_SHARE *share=info->s;
+  HP_KEYDEF *keyinfo;
   DBUG_ENTER("heap_rfirst");
+  if ((uint) inx >= share->keys)
+    DBUG_RETURN(my_errno=HA_ERR_WRONG_INDEX);
+  info->lastinx=inx;
+  keyinfo=share->keydef+inx;
+  if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
+  {
+    byte *pos;
+    info->lastkey_len=0;
+    if (!(pos=(byte*) tree_search_edge(&keyinfo->rb_tree,info->parents,
+				       &info->last_pos,
+				       offsetof(TREE_ELEMENT,left))))
+    {
+      info->last_pos=0;
+      info->current_ptr=0;
+      info->update=HA_STATE_PREV_FOUND;
+      DBUG_RETURN(my_errno=HA_ERR_END_OF_FILE);
+    }
+    info->current_ptr=_hp_rb_row(keyinfo,pos);
+    memcpy(record,info->current_ptr,(size_t) share->reclength);
+    info->update=HA_STATE_AKTIV | HA_STATE_PREV_FOUND;
+    DBUG_RETURN(0);
+  }
   info->current_record=0;
   info->current_hash_ptr=0;
   info->update=HA_STATE_PREV_FOUND;
@@ -16,10 +16,27 @@
 
 #include "heapdef.h"
 
-int heap_rkey(HP_INFO *info, byte *record, int inx, const byte *key)
+/*
+  Read a row by key
+
+  SYNOPSIS
+    heap_rkey()
+    info		Table handler
+    record		Store found row here
+    inx			Index to use
+    key			Key to search after
+    key_len		Length of key. A hash key must be a whole key;
+			a BTREE key may be a prefix of the key
+    find_flag		How to search a BTREE key (HA_READ_KEY_EXACT etc);
+			a hash key is always searched with HA_READ_KEY_EXACT
+*/
+
+int heap_rkey(HP_INFO *info, byte *record, int inx, const byte *key,
+	      uint key_len, enum ha_rkey_function find_flag)
 {
   byte *pos;
   HP_SHARE *share=info->s;
+  HP_KEYDEF *keyinfo;
   DBUG_ENTER("heap_rkey");
   DBUG_PRINT("enter",("base: %lx  inx: %d",info,inx));
 
@@ -27,18 +44,25 @@ int heap_rkey(HP_INFO *info, byte *record, int inx, const byte *key)
   {
     DBUG_RETURN(my_errno=HA_ERR_WRONG_INDEX);
   }
+  keyinfo=share->keydef+inx;
   info->lastinx=inx;
   info->current_record = (ulong) ~0L;		/* For heap_rrnd() */
 
-  if (!(pos=_hp_search(info,share->keydef+inx,key,0)))
+  if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
+    pos=_hp_rb_search(info,keyinfo,key,min(key_len,keyinfo->length),
+		      find_flag,0);
+  else
+    pos=_hp_search(info,keyinfo,key,0);
+  if (!pos)
   {
     info->update=0;
     DBUG_RETURN(my_errno);
   }
   memcpy(record,pos,(size_t) share->reclength);
   info->update=HA_STATE_AKTIV;
-  if (!(share->keydef[inx].flag & HA_NOSAME))
-    memcpy(info->lastkey,key,(size_t) share->keydef[inx].length);
+  if (keyinfo->algorithm != HA_KEY_ALG_BTREE &&
+      !(keyinfo->flag & HA_NOSAME))
+    memcpy(info->lastkey,key,(size_t) keyinfo->length);
   DBUG_RETURN(0);
 }
 
@@ -47,5 +71,9 @@ int heap_rkey(HP_INFO *info, byte *record, int inx, const byte *key)
 
 gptr heap_find(HP_INFO *info, int inx, const byte *key)
 {
-  return _hp_search(info,info->s->keydef+inx,key,0);
+  HP_KEYDEF *keyinfo=info->s->keydef+inx;
+  if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
+    return _hp_rb_search(info,keyinfo,key,keyinfo->length,
+			 HA_READ_KEY_EXACT,0);
+  return _hp_search(info,keyinfo,key,0);
 }
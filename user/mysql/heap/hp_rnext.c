@@ -22,25 +22,65 @@ int heap_rnext(HP_INFO *info, byte *record)
 {
   byte *pos;
   HP_SHARE *share=info->s;
+  HP_KEYDEF *keyinfo;
   DBUG_ENTER("heap_rnext");
   
   if (info->lastinx < 0)
     DBUG_RETURN(my_errno=HA_ERR_WRONG_INDEX);
 
-  if (info->current_hash_ptr)
-    pos= _hp_search_next(info,share->keydef+info->lastinx, info->lastkey,
+  keyinfo=share->keydef+info->lastinx;
+  if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
+  {
+    if (info->last_pos)
+    {
+      if ((pos=(byte*) tree_search_next(&keyinfo->rb_tree,&info->last_pos,
+					 offsetof(TREE_ELEMENT,left),
+					 offsetof(TREE_ELEMENT,right))))
+	pos=info->current_ptr=_hp_rb_row(keyinfo,pos);
+      else
+      {
+	info->last_pos=0;
+	info->current_ptr=0;
+	my_errno=HA_ERR_KEY_NOT_FOUND;
+      }
+    }
+    else if (info->lastkey_len)			/* Row deleted or tree changed */
+      pos=_hp_rb_search(info,keyinfo,info->lastkey,info->lastkey_len,
+			HA_READ_AFTER_KEY,1);
+    else if (!info->current_ptr && (info->update & HA_STATE_PREV_FOUND))
+    {						/* Read next before first */
+      if ((pos=(byte*) tree_search_edge(&keyinfo->rb_tree,info->parents,
+					&info->last_pos,
+					offsetof(TREE_ELEMENT,left))))
+	pos=info->current_ptr=_hp_rb_row(keyinfo,pos);
+      else
+      {
+	info->last_pos=0;
+	my_errno=HA_ERR_KEY_NOT_FOUND;
+      }
+    }
+    else
+    {
+      pos=0;					/* Read next after last */
+      my_errno=HA_ERR_KEY_NOT_FOUND;
+    }
+  }
+  else if (info->current_hash_ptr &&
+	   info->key_version == share->key_version)
+    pos= _hp_search_next(info,keyinfo,info->lastkey,
 			 info->current_hash_ptr);
   else
   {
+    info->current_hash_ptr=0;			/* Hash slots have moved */
     if (!info->current_ptr && (info->update & HA_STATE_NEXT_FOUND))
     {
       pos=0;					/* Read next after last */
       my_errno=HA_ERR_KEY_NOT_FOUND;
     }
     else if (!info->current_ptr)		/* Deleted or first call */
-      pos= _hp_search(info,share->keydef+info->lastinx, info->lastkey, 0);
+      pos= _hp_search(info,keyinfo,info->lastkey, 0);
     else
-      pos= _hp_search(info,share->keydef+info->lastinx, info->lastkey, 1);
+      pos= _hp_search(info,keyinfo,info->lastkey, 1);
   }
 
   if (!pos)
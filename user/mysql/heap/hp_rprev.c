@@ -23,17 +23,55 @@ int heap_rprev(HP_INFO *info, byte *record)
 {
   byte *pos;
   HP_SHARE *share=info->s;
+  HP_KEYDEF *keyinfo;
   DBUG_ENTER("heap_rprev");
 
   if (info->lastinx < 0)
     DBUG_RETURN(my_errno=HA_ERR_WRONG_INDEX);
 
-  if (info->current_ptr || (info->update & HA_STATE_NEXT_FOUND))
+  keyinfo=share->keydef+info->lastinx;
+  if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
+  {
+    if (info->last_pos)
+    {
+      if ((pos=(byte*) tree_search_next(&keyinfo->rb_tree,&info->last_pos,
+					 offsetof(TREE_ELEMENT,right),
+					 offsetof(TREE_ELEMENT,left))))
+	pos=info->current_ptr=_hp_rb_row(keyinfo,pos);
+      else
+      {
+	info->last_pos=0;
+	info->current_ptr=0;
+	my_errno=HA_ERR_KEY_NOT_FOUND;
+      }
+    }
+    else if (info->lastkey_len)			/* Row deleted or tree changed */
+      pos=_hp_rb_search(info,keyinfo,info->lastkey,info->lastkey_len,
+			HA_READ_BEFORE_KEY,1);
+    else if (!info->current_ptr && (info->update & HA_STATE_NEXT_FOUND))
+    {						/* Read prev after last */
+      if ((pos=(byte*) tree_search_edge(&keyinfo->rb_tree,info->parents,
+					&info->last_pos,
+					offsetof(TREE_ELEMENT,right))))
+	pos=info->current_ptr=_hp_rb_row(keyinfo,pos);
+      else
+      {
+	info->last_pos=0;
+	my_errno=HA_ERR_KEY_NOT_FOUND;
+      }
+    }
+    else
+    {
+      pos=0;					/* Read prev before first */
+      my_errno=HA_ERR_KEY_NOT_FOUND;
+    }
+  }
+  else if (info->current_ptr || (info->update & HA_STATE_NEXT_FOUND))
   {
     if ((info->update & HA_STATE_DELETED))
-      pos= _hp_search(info,share->keydef+info->lastinx, info->lastkey, 3);
+      pos= _hp_search(info,keyinfo,info->lastkey, 3);
     else
-      pos= _hp_search(info,share->keydef+info->lastinx, info->lastkey, 2);
+      pos= _hp_search(info,keyinfo,info->lastkey, 2);
   }
   else
   {
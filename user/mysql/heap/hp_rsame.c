@@ -40,12 +40,26 @@ int heap_rsame(register HP_INFO *info, byte *record, int inx)
     }
     else if (inx != -1)
     {
+      HP_KEYDEF *keyinfo=share->keydef+inx;
       info->lastinx=inx;
-      _hp_make_key(share->keydef+inx,info->lastkey,record);
-      if (!_hp_search(info,share->keydef+inx,info->lastkey,3))
+      if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
       {
-	info->update=0;
-	DBUG_RETURN(my_errno);
+	_hp_rb_make_key(keyinfo,info->recbuf,record,info->current_ptr);
+	if (!_hp_rb_search(info,keyinfo,info->recbuf,keyinfo->length,
+			   HA_READ_KEY_EXACT,1))
+	{
+	  info->update=0;
+	  DBUG_RETURN(my_errno);
+	}
+      }
+      else
+      {
+	_hp_make_key(keyinfo,info->lastkey,record);
+	if (!_hp_search(info,keyinfo,info->lastkey,3))
+	{
+	  info->update=0;
+	  DBUG_RETURN(my_errno);
+	}
       }
     }
     memcpy(record,info->current_ptr,(size_t) share->reclength);
@@ -77,6 +77,7 @@ int main(int argc, char *argv[])
   keyinfo[0].seg=keyseg;
   keyinfo[0].keysegs=1;
   keyinfo[0].flag= 0;
+  keyinfo[0].algorithm= HA_KEY_ALG_HASH;
   keyinfo[0].seg[0].type=HA_KEYTYPE_BINARY;
   keyinfo[0].seg[0].start=0;
   keyinfo[0].seg[0].length=6;
@@ -84,6 +85,7 @@ int main(int argc, char *argv[])
   keyinfo[1].seg=keyseg+1;
   keyinfo[1].keysegs=2;
   keyinfo[1].flag=0;
+  keyinfo[1].algorithm= HA_KEY_ALG_HASH;
   keyinfo[1].seg[0].type=HA_KEYTYPE_BINARY;
   keyinfo[1].seg[0].start=7;
   keyinfo[1].seg[0].length=6;
@@ -95,12 +97,14 @@ int main(int argc, char *argv[])
   keyinfo[2].seg=keyseg+3;
   keyinfo[2].keysegs=1;
   keyinfo[2].flag=HA_NOSAME;
+  keyinfo[2].algorithm= HA_KEY_ALG_HASH;
   keyinfo[2].seg[0].type=HA_KEYTYPE_BINARY;
   keyinfo[2].seg[0].start=12;
   keyinfo[2].seg[0].length=8;
   keyinfo[2].seg[0].null_bit=0;
   keyinfo[3].keysegs=1;
   keyinfo[3].flag=HA_NOSAME;
+  keyinfo[3].algorithm= HA_KEY_ALG_HASH;
   keyinfo[3].seg=keyseg+4;
   keyinfo[3].seg[0].type=HA_KEYTYPE_BINARY;
   keyinfo[3].seg[0].start=37;
@@ -167,7 +171,7 @@ int main(int argc, char *argv[])
     if (j != 0)
     {
       sprintf(key,"%6d",j);
-      if (heap_rkey(file,record,0,key))
+      if (heap_rkey(file,record,0,key,6,HA_READ_KEY_EXACT))
       {
 	printf("can't find key1: \"%s\"\n",key);
 	goto err;
@@ -227,7 +231,7 @@ int main(int argc, char *argv[])
       if (!key1[j])
 	continue;
       sprintf(key,"%6d",j);
-      if (heap_rkey(file,record,0,key))
+      if (heap_rkey(file,record,0,key,6,HA_READ_KEY_EXACT))
       {
 	printf("can't find key1: \"%s\"\n",key);
 	goto err;
@@ -277,7 +281,7 @@ int main(int argc, char *argv[])
       printf("- Read first key - next - delete - next -> last\n");
     DBUG_PRINT("progpos",("first - next - delete - next -> last"));
 
-    if (heap_rkey(file,record,0,key))
+    if (heap_rkey(file,record,0,key,6,HA_READ_KEY_EXACT))
       goto err;
     if (heap_rnext(file,record3)) goto err;
     if (heap_delete(file,record3)) goto err;
@@ -306,7 +310,7 @@ int main(int argc, char *argv[])
     if (!silent)
       printf("- Read last key - delete - prev - prev - opt_delete - prev -> first\n");
 
-    if (heap_rlast(file,record3)) goto err;
+    if (heap_rlast(file,record3,0)) goto err;
     if (heap_delete(file,record3)) goto err;
     key_check-=atoi(record3);
     key1[atoi(record+keyinfo[0].seg[0].start)]--;
@@ -376,13 +380,13 @@ int main(int argc, char *argv[])
   DBUG_PRINT("progpos",("Read rrnd - same"));
   pos=rnd(write_count-opt_delete-5)+5;
   heap_scan_init(file);
-  i=5;
+  i=4;
   while ((error=heap_scan(file,record)) == HA_ERR_RECORD_DELETED ||
 	 (error == 0 && pos))
   {
     if (!error)
       pos--;
-    if (i-- == 0)
+    if (!error && i-- == 0)			/* Position of a found row */
     {
       bmove(record3,record,reclength);
       position=heap_position(file);
@@ -501,7 +505,7 @@ int main(int argc, char *argv[])
   }
   printf("- Read through all keys with first-next-last-prev\n");
   ant=0;
-  for (error=heap_rkey(file,record,0,key) ;
+  for (error=heap_rkey(file,record,0,key,6,HA_READ_KEY_EXACT) ;
       ! error ;
        error=heap_rnext(file,record))
     ant++;
@@ -513,7 +517,7 @@ int main(int argc, char *argv[])
   }
 
   ant=0;
-  for (error=heap_rlast(file,record) ;
+  for (error=heap_rlast(file,record,0) ;
       ! error ;
       error=heap_rprev(file,record))
   {
@@ -538,7 +542,8 @@ int main(int argc, char *argv[])
   {
     if (error == 0)
     {
-      if (heap_rkey(file2,record2,2,record+keyinfo[2].seg[0].start))
+      if (heap_rkey(file2,record2,2,record+keyinfo[2].seg[0].start,8,
+		    HA_READ_KEY_EXACT))
       {
 	printf("can't find key3: \"%.8s\"\n",
 	       record+keyinfo[2].seg[0].start);
@@ -0,0 +1,322 @@
+/* Copyright (C) 2000 MySQL AB & MySQL Finland AB & TCX DataKonsult AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Speed test of the hash and BTREE indexes of heap tables
+
+  Writes rows with a unique 4 byte integer key, a unique 8 byte key and a
+  non unique character key, and times random lookups on each of them,
+  before and after a phase of deletes and writes that leaves deleted
+  slots in the index. Prints rows/s for the writes and lookups/s for the
+  reads; run it on trees with different hash implementations to compare
+  them. With -B all keys are BTREE keys, and a full scan in key order
+  is timed as well.
+*/
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+#include "heap.h"
+
+#if defined(HAVE_LRAND48)
+#define rnd(X) (lrand48() % X)
+#define rnd_init(X) srand48(X)
+#else
+#define rnd(X) (random() % X)
+#define rnd_init(X) srandom(X)
+#endif
+
+#define RECLENGTH 24
+#define INT_POS   0				/* Unique 4 byte key */
+#define LONG_POS  4				/* Unique 8 byte key */
+#define CHAR_POS  12				/* Non unique 10 char key */
+#define CHAR_LENGTH 10
+
+static uint records=200000,lookups=1000000,duplicates=10;
+static int silent=0;
+static uint key_algorithm=HA_KEY_ALG_HASH;
+
+static void get_options(int argc, char *argv[]);
+static void make_record(byte *record, ulong nr);
+static int lookup_test(HP_INFO *file, const char *name);
+static int scan_test(HP_INFO *file);
+static void print_speed(const char *name, ulong count, ulonglong start);
+
+
+int main(int argc, char *argv[])
+{
+  HP_INFO *file;
+  HP_KEYDEF keyinfo[3];
+  HP_KEYSEG keyseg[3];
+  byte record[RECLENGTH];
+  ulong i,nr,next_nr;
+  ulonglong start;
+  MY_INIT(argv[0]);
+  get_options(argc,argv);
+
+  bzero((char*) keyinfo,sizeof(keyinfo));
+  bzero((char*) keyseg,sizeof(keyseg));
+  keyinfo[0].keysegs=1;
+  keyinfo[0].seg=keyseg;
+  keyinfo[0].flag=HA_NOSAME;
+  keyseg[0].type=HA_KEYTYPE_ULONG_INT;
+  keyseg[0].start=INT_POS;
+  keyseg[0].length=4;
+  keyinfo[1].keysegs=1;
+  keyinfo[1].seg=keyseg+1;
+  keyinfo[1].flag=HA_NOSAME;
+  keyseg[1].type=HA_KEYTYPE_BINARY;
+  keyseg[1].start=LONG_POS;
+  keyseg[1].length=8;
+  keyinfo[2].keysegs=1;
+  keyinfo[2].seg=keyseg+2;
+  keyinfo[2].flag=0;
+  keyseg[2].type=HA_KEYTYPE_TEXT;
+  keyseg[2].start=CHAR_POS;
+  keyseg[2].length=CHAR_LENGTH;
+  for (i=0 ; i < 3 ; i++)
+    keyinfo[i].algorithm=key_algorithm;
+
+  if (!silent)
+    printf("records: %u  lookups: %u  rows per character key: %u  keys: %s\n",
+	   records, lookups, duplicates,
+	   key_algorithm == HA_KEY_ALG_BTREE ? "BTREE" : "HASH");
+
+  heap_create("test3");
+  if (!(file=heap_open("test3",2,3,keyinfo,RECLENGTH,records*2,records)))
+    goto err;
+
+  start=my_getsystime();
+  for (nr=0 ; nr < records ; nr++)
+  {
+    make_record(record,nr);
+    if (heap_write(file,record))
+      goto err;
+  }
+  print_speed("write",records,start);
+  if (lookup_test(file,"lookup"))
+    goto err;
+
+  /* Replace half of the rows; leaves deleted slots in the hash index */
+  rnd_init(2);
+  start=my_getsystime();
+  for (i=0, next_nr=records ; i < records/2 ; i++, next_nr++)
+  {
+    char key[4];
+    nr=(ulong) rnd(next_nr);
+    int4store(key,nr);
+    if (heap_rkey(file,record,0,key,4,HA_READ_KEY_EXACT))
+    {
+      if (my_errno != HA_ERR_KEY_NOT_FOUND)
+	goto err;
+      continue;					/* Already deleted */
+    }
+    if (heap_delete(file,record))
+      goto err;
+    make_record(record,next_nr);
+    if (heap_write(file,record))
+      goto err;
+  }
+  print_speed("delete+write",records/2,start);
+  if (lookup_test(file,"lookup after churn"))
+    goto err;
+  if (key_algorithm == HA_KEY_ALG_BTREE && scan_test(file))
+    goto err;
+
+  if (heap_check_heap(file,!silent))
+  {
+    puts("Heap keys crashed");
+    goto err;
+  }
+  heap_close(file);
+  heap_delete_table("test3");
+  heap_panic(HA_PANIC_CLOSE);
+  my_end(MY_CHECK_ERROR);
+  return 0;
+
+err:
+  printf("got error: %d when testing heap\n",my_errno);
+  heap_panic(HA_PANIC_CLOSE);
+  return 1;
+}
+
+
+	/* Random lookups on all keys; keys of deleted rows are not found */
+
+static int lookup_test(HP_INFO *file, const char *name)
+{
+  uint i;
+  int error;
+  ulong found;
+  ulonglong start;
+  byte record[RECLENGTH],key[RECLENGTH];
+  char buff[80];
+
+  rnd_init(1);					/* Same keys every run */
+  start=my_getsystime();
+  for (i=found=0 ; i < lookups ; i++)
+  {
+    ulong nr=(ulong) rnd(records);		/* int4store() uses nr 4 times */
+    int4store(key,nr);
+    if (!heap_rkey(file,record,0,key,4,HA_READ_KEY_EXACT))
+      found++;
+    else if (my_errno != HA_ERR_KEY_NOT_FOUND)
+      return 1;
+  }
+  strxmov(buff,name," int key",NullS);
+  print_speed(buff,lookups,start);
+
+  rnd_init(1);
+  start=my_getsystime();
+  for (i=0 ; i < lookups ; i++)
+  {
+    ulong nr=(ulong) rnd(records);
+    int4store(key,nr);
+    int4store(key+4,~nr);
+    if (heap_rkey(file,record,1,key,8,HA_READ_KEY_EXACT) &&
+	my_errno != HA_ERR_KEY_NOT_FOUND)
+      return 1;
+  }
+  strxmov(buff,name," 8 byte key",NullS);
+  print_speed(buff,lookups,start);
+
+  rnd_init(1);
+  start=my_getsystime();
+  for (i=0 ; i < lookups ; i++)
+  {
+    make_record(record,(ulong) rnd(records));
+    memcpy(key,record+CHAR_POS,CHAR_LENGTH);
+    if (!heap_rkey(file,record,2,key,CHAR_LENGTH,HA_READ_KEY_EXACT))
+    {
+      /* Read all duplicates; a BTREE key continues to the next key */
+      while (!(error=heap_rnext(file,record)) &&
+	     !memcmp(record+CHAR_POS,key,CHAR_LENGTH)) ;
+      if (error && error != HA_ERR_KEY_NOT_FOUND &&
+	  error != HA_ERR_END_OF_FILE)
+	return 1;
+    }
+    else if (my_errno != HA_ERR_KEY_NOT_FOUND)
+      return 1;
+  }
+  strxmov(buff,name," char key",NullS);
+  print_speed(buff,lookups,start);
+  if (!silent)
+    printf("%s: found %lu of %u int keys\n",name,found,lookups);
+  return 0;
+}
+
+
+	/* Read all rows in order of the int key; Only for BTREE keys */
+
+static int scan_test(HP_INFO *file)
+{
+  ulong rows=0,prev_nr=0;
+  ulonglong start;
+  byte record[RECLENGTH];
+  int error;
+
+  start=my_getsystime();
+  for (error=heap_rfirst(file,record,0) ; !error ;
+       error=heap_rnext(file,record))
+  {
+    ulong nr=uint4korr(record+INT_POS);
+    if (rows++ && nr <= prev_nr)
+    {
+      printf("int key %lu is after key %lu\n",nr,prev_nr);
+      return 1;
+    }
+    prev_nr=nr;
+  }
+  if (error != HA_ERR_END_OF_FILE)
+    return 1;
+  print_speed("scan in key order",rows,start);
+  if (rows != file->s->records)
+  {
+    printf("scan found %lu of %lu rows\n",rows,(ulong) file->s->records);
+    return 1;
+  }
+  return 0;
+}
+
+
+static void make_record(byte *record, ulong nr)
+{
+  char buff[CHAR_LENGTH+1];
+  int4store(record+INT_POS,nr);
+  int4store(record+LONG_POS,nr);
+  int4store(record+LONG_POS+4,~nr);
+  sprintf(buff,"%-*lu",CHAR_LENGTH,nr/duplicates);
+  memcpy(record+CHAR_POS,buff,CHAR_LENGTH);
+  bzero(record+CHAR_POS+CHAR_LENGTH,RECLENGTH-CHAR_POS-CHAR_LENGTH);
+}
+
+
+static void print_speed(const char *name, ulong count, ulonglong start)
+{
+  double secs=(double) (my_getsystime()-start)/10000000.0;
+  printf("%-32s %9lu rows  %8.3f s  %10.0f rows/s\n",
+	 name, count, secs, secs > 0.0 ? (double) count/secs : 0.0);
+}
+
+
+	/* Read options */
+
+static void get_options(int argc, char **argv)
+{
+  char *pos,*progname;
+  DEBUGGER_OFF;
+
+  progname= argv[0];
+
+  while (--argc >0 && *(pos = *(++argv)) == '-' ) {
+    switch(*++pos) {
+    case 'r':
+      if ((records=(uint) atoi(++pos)) == 0)
+	records=1;
+      break;
+    case 'l':
+      lookups=(uint) atoi(++pos);
+      break;
+    case 'd':
+      if ((duplicates=(uint) atoi(++pos)) == 0)
+	duplicates=1;
+      break;
+    case 'B':
+      key_algorithm=HA_KEY_ALG_BTREE;
+      break;
+    case 'S':
+      silent=1;
+      break;
+    case '?':
+    case 'I':
+    case 'V':
+      printf("%s  Ver 1.0 for %s at %s\n",progname,SYSTEM_TYPE,MACHINE_TYPE);
+      puts("Speed test of writes and key lookups in heap tables\n");
+      printf("Usage: %s [-?BS] [-r#] [-l#] [-d#]\n",progname);
+      puts("-r# rows in table, -l# lookups per key");
+      puts("-d# rows with the same character key, -B use BTREE keys");
+      exit(0);
+    case '#':
+      DEBUGGER_ON;
+      DBUG_PUSH (++pos);
+      break;
+    default:
+      printf("Illegal option: '%c'\n",*pos);
+      break;
+    }
+  }
+  return;
+}
@@ -30,22 +30,23 @@ int heap_update(HP_INFO *info, const byte *old, const byte *heap_new)
 
   if (info->opt_flag & READ_CHECK_USED && _hp_rectest(info,old))
     DBUG_RETURN(my_errno);				/* Record changed */
-  if (--(share->records) < share->blength >> 1) share->blength>>= 1;
+  share->records--;
   share->changed=1;
 
   for (key=0 ; key < share->keys ; key++)
   {
-    if (_hp_rec_key_cmp(share->keydef+key,old,heap_new))
+    HP_KEYDEF *keydef=share->keydef+key;
+    if (_hp_rec_key_cmp(keydef,old,heap_new))
     {
-      if (_hp_delete_key(info,share->keydef+key,old,pos,key ==
-			 (uint) info->lastinx) ||
-	  _hp_write_key(share,share->keydef+key,heap_new,pos))
+      if ((*keydef->delete_key)(info,keydef,old,pos,key ==
+				(uint) info->lastinx) ||
+	  (*keydef->write_key)(info,keydef,heap_new,pos))
 	goto err;
     }
   }
 
   memcpy(pos,heap_new,(size_t) share->reclength);
-  if (++(share->records) == share->blength) share->blength+= share->blength;
+  share->records++;
 
 #if !defined(DBUG_OFF) && defined(EXTRA_HEAP_DEBUG)
   DBUG_EXECUTE("check_heap",heap_check_heap(info, 0););
@@ -56,16 +57,26 @@ int heap_update(HP_INFO *info, const byte *old, const byte *heap_new)
   if (my_errno == HA_ERR_FOUND_DUPP_KEY)
   {
     info->errkey=key;
-    do
+    if (share->keydef[key].algorithm == HA_KEY_ALG_BTREE)
     {
-      if (_hp_rec_key_cmp(share->keydef+key,old,heap_new))
+      /* The new BTREE key was not written; put back the old one */
+      HP_KEYDEF *keydef=share->keydef+key;
+      if ((*keydef->write_key)(info,keydef,old,pos))
+	key=0;					/* Give up */
+    }
+    else
+      key++;					/* Hash key was written */
+    while (key-- > 0)
+    {
+      HP_KEYDEF *keydef=share->keydef+key;
+      if (_hp_rec_key_cmp(keydef,old,heap_new))
       {
-	if (_hp_delete_key(info,share->keydef+key,heap_new,pos,0) ||
-	    _hp_write_key(share,share->keydef+key,old,pos))
+	if ((*keydef->delete_key)(info,keydef,heap_new,pos,0) ||
+	    (*keydef->write_key)(info,keydef,old,pos))
 	  break;
       }
-    } while (key-- > 0);
+    }
   }
-  if (++(share->records) == share->blength) share->blength+= share->blength;
+  share->records++;
   DBUG_RETURN(my_errno);
 } /* heap_update */
@@ -21,14 +21,10 @@
 #include <fcntl.h>
 #endif
 
-#define LOWFIND 1
-#define LOWUSED 2
-#define HIGHFIND 4
-#define HIGHUSED 8
-
 static byte *next_free_record_pos(HP_SHARE *info);
-static HASH_INFO *_hp_find_free_hash(HP_SHARE *info, HP_BLOCK *block,
-				     ulong records);
+static my_bool hp_dupp_in_table(HP_KEYDEF *keyinfo, HP_HASH_TABLE *table,
+				ulong hashnr, const byte *record,
+				byte *recpos);
 
 int heap_write(HP_INFO *info, const byte *record)
 {
@@ -49,14 +45,14 @@ int heap_write(HP_INFO *info, const byte *record)
 
   for (key=0 ; key < share->keys ; key++)
   {
-    if (_hp_write_key(share,share->keydef+key,record,pos))
+    HP_KEYDEF *keydef=share->keydef+key;
+    if ((*keydef->write_key)(info,keydef,record,pos))
       goto err;
   }
 
   memcpy(pos,record,(size_t) share->reclength);
   pos[share->reclength]=1;		/* Mark record as not deleted */
-  if (++share->records == share->blength)
-    share->blength+= share->blength;
+  share->records++;
   info->current_ptr=pos;
   info->current_hash_ptr=0;
   info->update|=HA_STATE_AKTIV;
@@ -68,11 +64,15 @@ int heap_write(HP_INFO *info, const byte *record)
 err:
   DBUG_PRINT("info",("Duplicate key: %d",key));
   info->errkey= key;
-  do
+  /* A hash key is written also on error; a BTREE key is not */
+  if (share->keydef[key].algorithm != HA_KEY_ALG_BTREE)
+    key++;
+  while (key-- > 0)
   {
-    if (_hp_delete_key(info,share->keydef+key,record,pos,0))
+    HP_KEYDEF *keydef=share->keydef+key;
+    if ((*keydef->delete_key)(info,keydef,record,pos,0))
       break;
-  } while (key-- > 0);
+  }
 
   share->deleted++;
   *((byte**) pos)=share->del_link;
@@ -120,164 +120,113 @@ static byte *next_free_record_pos(HP_SHARE *info)
 
 
 	/* Write a hash-key to the hash-index */
+	/* A duplicate key is left in the index, like a written key */
 
-int _hp_write_key(register HP_SHARE *info, HP_KEYDEF *keyinfo,
+int _hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 		  const byte *record, byte *recpos)
 {
-  int flag;
-  ulong halfbuff,hashnr,first_index;
-  byte *ptr_to_rec,*ptr_to_rec2;
-  HASH_INFO *empty,*gpos,*gpos2,*pos;
+  ulong hashnr;
+  HP_HASH_TABLE *table= &keyinfo->hash;
+  HASH_INFO *pos,*empty;
   DBUG_ENTER("hp_write_key");
 
-  LINT_INIT(gpos); LINT_INIT(gpos2);
-  LINT_INIT(ptr_to_rec); LINT_INIT(ptr_to_rec2);
-
-  flag=0;
-  if (!(empty= _hp_find_free_hash(info,&keyinfo->block,info->records)))
+  if (_hp_hash_reserve(info->s,keyinfo))
     DBUG_RETURN(-1);				/* No more memory */
-  halfbuff= (long) info->blength >> 1;
-  pos=	 hp_find_hash(&keyinfo->block,(first_index=info->records-halfbuff));
 
-  if (pos != empty)				/* If some records */
+  hashnr=_hp_rec_hashnr(keyinfo,record);
+  empty=0;
+  for (pos=hp_first_slot(table,hashnr) ;
+       pos->ptr_to_rec ;
+       pos=hp_next_slot(table,pos))
   {
-    do
-    {
-      hashnr=_hp_rec_hashnr(keyinfo,pos->ptr_to_rec);
-      if (flag == 0)				/* First loop; Check if ok */
-	if (_hp_mask(hashnr,info->blength,info->records) != first_index)
-	  break;
-      if (!(hashnr & halfbuff))
-      {						/* Key will not move */
-	if (!(flag & LOWFIND))
-	{
-	  if (flag & HIGHFIND)
-	  {
-	    flag=LOWFIND | HIGHFIND;
-	    /* key shall be moved to the current empty position */
-	    gpos=empty;
-	    ptr_to_rec=pos->ptr_to_rec;
-	    empty=pos;				/* This place is now free */
-	  }
-	  else
-	  {
-	    flag=LOWFIND | LOWUSED;		/* key isn't changed */
-	    gpos=pos;
-	    ptr_to_rec=pos->ptr_to_rec;
-	  }
-	}
-	else
-	{
-	  if (!(flag & LOWUSED))
-	  {
-	    /* Change link of previous LOW-key */
-	    gpos->ptr_to_rec=ptr_to_rec;
-	    gpos->next_key=pos;
-	    flag= (flag & HIGHFIND) | (LOWFIND | LOWUSED);
-	  }
-	  gpos=pos;
-	  ptr_to_rec=pos->ptr_to_rec;
-	}
-      }
-      else
-      {						/* key will be moved */
-	if (!(flag & HIGHFIND))
-	{
-	  flag= (flag & LOWFIND) | HIGHFIND;
-	  /* key shall be moved to the last (empty) position */
-	  gpos2 = empty; empty=pos;
-	  ptr_to_rec2=pos->ptr_to_rec;
-	}
-	else
-	{
-	  if (!(flag & HIGHUSED))
-	  {
-	    /* Change link of previous hash-key and save */
-	    gpos2->ptr_to_rec=ptr_to_rec2;
-	    gpos2->next_key=pos;
-	    flag= (flag & LOWFIND) | (HIGHFIND | HIGHUSED);
-	  }
-	  gpos2=pos;
-	  ptr_to_rec2=pos->ptr_to_rec;
-	}
-      }
-    }
-    while ((pos=pos->next_key));
-
-    if ((flag & (LOWFIND | LOWUSED)) == LOWFIND)
-    {
-      gpos->ptr_to_rec=ptr_to_rec;
-      gpos->next_key=0;
-    }
-    if ((flag & (HIGHFIND | HIGHUSED)) == HIGHFIND)
+    if (pos->ptr_to_rec == HP_DELETED_SLOT)
     {
-      gpos2->ptr_to_rec=ptr_to_rec2;
-      gpos2->next_key=0;
+      empty=pos;				/* Reuse first deleted slot */
+      break;
     }
   }
-  /* Check if we are at the empty position */
+  if (empty)
+    table->deleted--;
+  else
+    empty=pos;
+  empty->ptr_to_rec=recpos;
+  empty->hashnr=hashnr;
+  table->records++;
+
+  /* Check if duplicated keys */
+  if ((keyinfo->flag & HA_NOSAME) &&
+      (!(keyinfo->flag & HA_NULL_PART_KEY) ||
+       !hp_if_null_in_key(keyinfo, record)) &&
+      (hp_dupp_in_table(keyinfo,table,hashnr,record,recpos) ||
+       (keyinfo->old_hash.slot &&
+	hp_dupp_in_table(keyinfo,&keyinfo->old_hash,hashnr,record,recpos))))
+    DBUG_RETURN(my_errno=HA_ERR_FOUND_DUPP_KEY);
+  DBUG_RETURN(0);
+}
+
+
+	/* Write a key to the rb_tree of a BTREE key */
 
-  pos=hp_find_hash(&keyinfo->block,_hp_mask(_hp_rec_hashnr(keyinfo,record),
-					    info->blength,info->records+1));
-  if (pos == empty)
+int _hp_rb_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
+		     const byte *record, byte *recpos)
+{
+  HP_RB_PARAM param;
+  TREE *rb_tree= &keyinfo->rb_tree;
+  DBUG_ENTER("_hp_rb_write_key");
+
+  if (info->last_pos && info->current_ptr &&
+      keyinfo == info->s->keydef+info->lastinx)
   {
-    pos->ptr_to_rec=recpos;
-    pos->next_key=0;
+    /* The tree is changed; Let heap_rnext() search after the current key */
+    _hp_rb_make_key(keyinfo,info->lastkey,info->current_ptr,
+		    info->current_ptr);
+    info->lastkey_len=keyinfo->length;
+    info->last_pos=0;
   }
-  else
+  _hp_rb_make_key(keyinfo,info->recbuf,record,recpos);
+  param.keydef=keyinfo;
+  param.key_length=keyinfo->length;
+  /* The tree is only changed with a write lock on the table */
+  rb_tree->custom_arg= (void*) &param;
+  if ((keyinfo->flag & HA_NOSAME) &&
+      (!(keyinfo->flag & HA_NULL_PART_KEY) ||
+       !hp_if_null_in_key(keyinfo, record)))
   {
-    /* Check if more records in same hash-nr family */
-    empty[0]=pos[0];
-    gpos=hp_find_hash(&keyinfo->block,
-		      _hp_mask(_hp_rec_hashnr(keyinfo,pos->ptr_to_rec),
-			       info->blength,info->records+1));
-    if (pos == gpos)
+    param.compare_ref=0;
+    if (tree_search(rb_tree,info->recbuf))
     {
-      pos->ptr_to_rec=recpos;
-      pos->next_key=empty;
-    }
-    else
-    {
-      pos->ptr_to_rec=recpos;
-      pos->next_key=0;
-      _hp_movelink(pos,gpos,empty);
-    }
-
-    /* Check if duplicated keys */
-    if ((keyinfo->flag & HA_NOSAME) && pos == gpos &&
-	(!(keyinfo->flag & HA_NULL_PART_KEY) ||
-	 !hp_if_null_in_key(keyinfo, record)))
-    {
-      pos=empty;
-      do
-      {
-	if (! _hp_rec_key_cmp(keyinfo,record,pos->ptr_to_rec))
-	{
-	  DBUG_RETURN(my_errno=HA_ERR_FOUND_DUPP_KEY);
-	}
-      } while ((pos=pos->next_key));
+      rb_tree->custom_arg=0;
+      DBUG_RETURN(my_errno=HA_ERR_FOUND_DUPP_KEY);
     }
   }
+  param.compare_ref=1;
+  if (!tree_insert(rb_tree,info->recbuf,0))
+  {
+    rb_tree->custom_arg=0;
+    DBUG_RETURN(-1);				/* No more memory */
+  }
+  rb_tree->custom_arg=0;
+  info->s->index_length+= hp_rb_element_size(rb_tree);
   DBUG_RETURN(0);
 }
 
-	/* Returns ptr to block, and allocates block if neaded */
 
-static HASH_INFO *_hp_find_free_hash(HP_SHARE *info,
-				     HP_BLOCK *block, ulong records)
+	/* Check if some other record than recpos has the key of record */
+
+static my_bool hp_dupp_in_table(HP_KEYDEF *keyinfo, HP_HASH_TABLE *table,
+				ulong hashnr, const byte *record,
+				byte *recpos)
 {
-  uint block_pos;
-  ulong length;
+  HASH_INFO *pos;
 
-  if (records < block->last_allocated)
-    return hp_find_hash(block,records);
-  if (!(block_pos=(records % block->records_in_block)))
+  for (pos=hp_first_slot(table,hashnr) ;
+       pos->ptr_to_rec ;
+       pos=hp_next_slot(table,pos))
   {
-    if (_hp_get_new_block(block,&length))
-      return(NULL);
-    info->index_length+=length;
+    if (pos->hashnr == hashnr && hp_slot_used(pos) &&
+	pos->ptr_to_rec != recpos &&
+	!_hp_rec_key_cmp(keyinfo,record,pos->ptr_to_rec))
+      return 1;
   }
-  block->last_allocated=records+1;
-  return((HASH_INFO*) ((byte*) block->level_info[0].last_blocks+
-		       block_pos*block->recbuffer));
+  return 0;
 }
@@ -30,6 +30,7 @@ extern "C" {
 #include <my_pthread.h>
 #include <thr_lock.h>
 #endif
+#include <my_tree.h>
 
 	/* defines used by heap-funktions */
 
@@ -82,13 +83,32 @@ typedef struct st_hp_keyseg		/* Key-portion */
   uint null_pos;
 } HP_KEYSEG;
 
+struct st_hp_hash_info;
+struct st_heap_info;
+
+typedef struct st_hp_hash_table		/* Open addressing hash of a key */
+{
+  struct st_hp_hash_info *slot;		/* size slots; size is 2^n */
+  ulong size;
+  ulong records,deleted;		/* Used and deleted slots */
+} HP_HASH_TABLE;
+
 typedef struct st_hp_keydef		/* Key definition with open */
 {
   uint flag;				/* HA_NOSAME |HA_NULL_PART_KEY */
   uint keysegs;				/* Number of key-segment */
   uint length;				/* Length of key (automatic) */
+  uint bin_length;			/* Set if one binary part (automatic) */
   HP_KEYSEG *seg;
-  HP_BLOCK block;			/* Where keys are saved */
+  uint algorithm;			/* HA_KEY_ALG_BTREE or HASH */
+  HP_HASH_TABLE hash;			/* Where keys are saved */
+  HP_HASH_TABLE old_hash;		/* Keys not yet moved to hash */
+  ulong old_pos;			/* Next slot of old_hash to move */
+  TREE rb_tree;				/* Ordered keys of a BTREE key */
+  int (*write_key)(struct st_heap_info *info, struct st_hp_keydef *keyinfo,
+		   const byte *record, byte *recpos);
+  int (*delete_key)(struct st_heap_info *info, struct st_hp_keydef *keyinfo,
+		    const byte *record, byte *recpos, int flag);
 } HP_KEYDEF;
 
 typedef struct st_heap_share
@@ -98,10 +118,10 @@ typedef struct st_heap_share
   ulong min_records,max_records;	/* Params to open */
   ulong data_length,index_length;
   uint records;				/* records */
-  uint blength;
   uint deleted;				/* Deleted records in database */
   uint reclength;			/* Length of one record */
   uint changed;
+  ulong key_version;			/* Changed when hash slots move */
   uint keys,max_key_length;
   uint open_count;
   byte *del_link;			/* Link to next block with del. rec */
@@ -114,18 +134,21 @@ typedef struct st_heap_share
   LIST open_list;
 } HP_SHARE;
 
-struct st_hp_hash_info;
-
 typedef struct st_heap_info
 {
   HP_SHARE *s;
   byte *current_ptr;
   struct st_hp_hash_info *current_hash_ptr;
+  ulong key_version;			/* s->key_version of current_hash_ptr */
   ulong current_record,next_block;
   int lastinx,errkey;
   int  mode;				/* Mode of file (READONLY..) */
   uint opt_flag,update;
   byte *lastkey;			/* Last used key with rkey */
+  byte *recbuf;				/* Key buffer for the rb_tree */
+  uint lastkey_len;			/* Set if lastkey has a deleted key */
+  TREE_ELEMENT *parents[MAX_TREE_HIGHT+1];	/* Path to current BTREE key */
+  TREE_ELEMENT **last_pos;		/* Current BTREE key in parents */
 #ifdef THREAD
   THR_LOCK_DATA lock;
 #endif
@@ -153,13 +176,19 @@ extern int heap_panic(enum ha_panic_function flag);
 extern int heap_rsame(HP_INFO *info,byte *record,int inx);
 extern int heap_rnext(HP_INFO *info,byte *record);
 extern int heap_rprev(HP_INFO *info,byte *record);
-extern int heap_rfirst(HP_INFO *info,byte *record);
-extern int heap_rlast(HP_INFO *info,byte *record);
+extern int heap_rfirst(HP_INFO *info,byte *record,int inx);
+extern int heap_rlast(HP_INFO *info,byte *record,int inx);
 extern void heap_clear(HP_INFO *info);
-extern int heap_rkey(HP_INFO *info,byte *record,int inx,const byte *key);
+extern int heap_rkey(HP_INFO *info,byte *record,int inx,const byte *key,
+		     uint key_len, enum ha_rkey_function find_flag);
 extern gptr heap_find(HP_INFO *info,int inx,const byte *key);
 extern int heap_check_heap(HP_INFO *info, my_bool print_status);
 extern byte *heap_position(HP_INFO *info);
+extern ha_rows hp_rb_records_in_range(HP_INFO *info, int inx,
+				      const byte *start_key,uint start_key_len,
+				      enum ha_rkey_function start_search_flag,
+				      const byte *end_key,uint end_key_len,
+				      enum ha_rkey_function end_search_flag);
 
 /* The following is for programs that uses the old HEAP interface where
    pointer to rows where a long instead of a (byte*).
@@ -119,6 +119,8 @@ extern int NEAR my_errno;		/* Last error in mysys */
 #define MIN_COMPRESS_LENGTH		50	/* Don't compress small bl. */
 #define DEFAULT_KEYCACHE_BLOCK_SIZE	1024
 #define MAX_KEYCACHE_BLOCK_SIZE		16384
+#define MAX_KEY_CACHE_PARTITIONS	64
+#define KEY_CACHE_MIN_PARTITION_SIZE	(512*1024L)
 
 	/* root_alloc flags */
 #define MY_KEEP_PREALLOC	1
@@ -223,7 +225,8 @@ extern char *get_charsets_dir(char *buf);
 extern ulong	_my_cache_w_requests,_my_cache_write,_my_cache_r_requests,
 		_my_cache_read;
 extern ulong	_my_blocks_used,_my_blocks_changed;
-extern uint	key_cache_block_size;
+extern uint	key_cache_block_size, key_cache_partitions;
+extern uint	key_cache_division_limit, key_cache_age_threshold;
 extern ulong	my_file_opened,my_stream_opened, my_tmp_file_created;
 extern my_bool	key_cache_inited, my_init_done;
 
@@ -286,6 +289,13 @@ typedef struct st_record_cache	/* Used when cacheing records */
   enum cache_type type;
 } RECORD_CACHE;
 
+typedef struct st_key_cache_part_stats	/* One partition of key cache */
+{
+  ulong blocks_used, blocks_changed;
+  ulong r_requests, reads, w_requests, writes;
+  ulong lock_waits;			/* Times the partition was busy */
+} KEY_CACHE_PART_STATS;
+
 enum file_type
 {
   UNOPEN = 0, FILE_BY_OPEN, FILE_BY_CREATE, STREAM_BY_FOPEN, STREAM_BY_FDOPEN,
@@ -566,6 +576,7 @@ extern FILE *my_fopen(const char *FileName,int Flags,myf MyFlags);
 extern FILE *my_fdopen(File Filedes,const char *name, int Flags,myf MyFlags);
 extern int my_fclose(FILE *fd,myf MyFlags);
 extern int my_chsize(File fd,my_off_t newlength, int filler, myf MyFlags);
+extern int my_sync(File fd, myf my_flags);
 extern int my_error _VARARGS((int nr,myf MyFlags, ...));
 extern int my_printf_error _VARARGS((uint my_err, const char *format,
 				     myf MyFlags, ...)
@@ -641,6 +652,7 @@ extern int write_cache_record(RECORD_CACHE *info,my_off_t filepos,
 			      const byte *record,uint length);
 extern int flush_write_cache(RECORD_CACHE *info);
 extern long my_clock(void);
+extern ulonglong my_getsystime(void);
 extern sig_handler sigtstp_handler(int signal_number);
 extern void handle_recived_signals(void);
 extern int init_key_cache(ulong use_mem);
@@ -651,10 +663,18 @@ extern int key_cache_write(File file,my_off_t filepos,byte* buff,uint length,
 			   uint block_length,int force_write);
 extern int flush_key_blocks(int file, enum flush_type type);
 extern void end_key_cache(void);
+extern void update_key_cache_stats(void);
+extern void reset_key_cache_stats(void);
+extern void get_key_cache_reads(ulong *r_requests, ulong *reads);
+extern my_bool get_key_cache_part_stats(uint part_no,
+					KEY_CACHE_PART_STATS *stats);
 extern sig_handler my_set_alarm_variable(int signo);
 extern void my_string_ptr_sort(void *base,uint items,size_s size);
 extern void radixsort_for_str_ptr(uchar* base[], uint number_of_elements,
 				  size_s size_of_element,uchar *buffer[]);
+extern my_bool radixsort_for_str_ptr_prefix(uchar* base[],
+					    uint number_of_elements,
+					    size_s size_of_element);
 extern qsort_t qsort2(void *base_ptr, size_t total_elems, size_t size,
 		      qsort2_cmp cmp, void *cmp_argument);
 extern qsort2_cmp get_ptr_compare(uint);
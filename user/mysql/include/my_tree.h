@@ -20,10 +20,13 @@
 extern "C" {
 #endif
 
-#define MAX_TREE_HIGHT	40	/* = max 1048576 leafs in tree */
+#include "my_base.h"			/* get 'enum ha_rkey_function' */
+
+#define MAX_TREE_HIGHT	64	/* = max 2^32 leafs in tree */
 #define ELEMENT_KEY(tree,element)\
 (tree->offset_to_key ? (void*)((byte*) element+tree->offset_to_key) :\
 			*((void**) (element+1)))
+#define ELEMENT_CHILD(element, offs) (*(TREE_ELEMENT**)((char*)element + offs))
 
 #define tree_set_pointer(element,ptr) *((byte **) (element+1))=((byte*) (ptr))
 
@@ -76,6 +79,17 @@ int tree_walk(TREE *tree,tree_walk_action action,
 	      void *argument, TREE_WALK visit);
 int tree_delete(TREE *tree,void *key);
 
+	/* Ordered reads; parents must have room for MAX_TREE_HIGHT+1 */
+void *tree_search_key(TREE *tree, const void *key,
+		      TREE_ELEMENT **parents, TREE_ELEMENT ***last_pos,
+		      enum ha_rkey_function flag, void *custom_arg);
+void *tree_search_edge(TREE *tree, TREE_ELEMENT **parents,
+		       TREE_ELEMENT ***last_pos, int child_offs);
+void *tree_search_next(TREE *tree, TREE_ELEMENT ***last_pos, int l_offs,
+		       int r_offs);
+ha_rows tree_record_pos(TREE *tree, const void *key,
+			enum ha_rkey_function flag, void *custom_arg);
+
 #define TREE_ELEMENT_EXTRA_SIZE (sizeof(TREE_ELEMENT) + sizeof(void*))
 
 #ifdef	__cplusplus
@@ -166,6 +166,8 @@ typedef struct st_mi_decode_tree	/* Decode huff-table */
   uint16 *table;
   uint	 quick_table_bits;
   byte	 *intervalls;
+  uint32 *multi_table;			/* Several chars per lookup */
+  uint	 multi_table_bits;
 } MI_DECODE_TREE;
 
 
@@ -336,7 +338,7 @@ typedef struct st_mi_check_param
 	sort_buffer_length,sort_key_blocks;
   uint out_flag,warning_printed,error_printed,verbose;
   uint opt_sort_key,total_files,max_level;
-  uint testflag;
+  uint testflag, repair_threads;
   uint8 language;
   my_bool using_global_keycache, opt_lock_memory, opt_follow_links;
   my_bool retry_repair, force_sort, calc_checksum;
@@ -384,6 +386,8 @@ typedef struct st_mi_sort_param
   my_off_t pos,max_pos,filepos,start_recpos;
   uint key, key_length,real_key_length,sortbuff_size;
   uint maxbuffers, keys, find_length, sort_keys_length;
+  uint split_count, split_index;	/* Threads sharing one key */
+  ha_rows split_row;
   my_bool fix_datafile, master;
   MI_KEYDEF *keyinfo;
   SORT_INFO *sort_info;
@@ -409,6 +413,8 @@ int chk_data_link(MI_CHECK *param, MI_INFO *info,int extend);
 int mi_repair(MI_CHECK *param, register MI_INFO *info,
 	      my_string name, int rep_quick);
 int mi_sort_index(MI_CHECK *param, register MI_INFO *info, my_string name);
+int mi_copy_table(MI_CHECK *param, MI_INFO *info, MI_INFO *from,
+		  int *from_key);
 int mi_repair_by_sort(MI_CHECK *param, register MI_INFO *info,
 		      const char * name, int rep_quick);
 int mi_repair_parallel(MI_CHECK *param, register MI_INFO *info,
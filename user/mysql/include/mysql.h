@@ -219,6 +219,20 @@ typedef struct st_mysql_res {
   my_bool	eof;			/* Used by mysql_fetch_row */
 } MYSQL_RES;
 
+/*
+  A parameter of a prepared statement. buffer has a number in the format
+  of the host (signed char, short, int, longlong, float or double) or a
+  string of length bytes.
+*/
+
+typedef struct st_mysql_bind
+{
+  enum enum_field_types buffer_type;	/* FIELD_TYPE_XXX */
+  char		*buffer;
+  unsigned long	length;			/* Length of string */
+  my_bool	is_null, is_unsigned;
+} MYSQL_BIND;
+
 #define MAX_MYSQL_MANAGER_ERR 256  
 #define MAX_MYSQL_MANAGER_MSG 256
 
@@ -365,6 +379,13 @@ MYSQL_RES *	STDCALL mysql_list_fields(MYSQL *mysql, const char *table,
 MYSQL_RES *	STDCALL mysql_list_processes(MYSQL *mysql);
 MYSQL_RES *	STDCALL mysql_store_result(MYSQL *mysql);
 MYSQL_RES *	STDCALL mysql_use_result(MYSQL *mysql);
+unsigned long	STDCALL mysql_prepare(MYSQL *mysql, const char *query,
+				      unsigned long length,
+				      unsigned int *param_count);
+MYSQL_RES *	STDCALL mysql_execute(MYSQL *mysql, unsigned long stmt_id,
+				      MYSQL_BIND *params,
+				      unsigned int param_count);
+int		STDCALL mysql_close_stmt(MYSQL *mysql, unsigned long stmt_id);
 int		STDCALL mysql_options(MYSQL *mysql,enum mysql_option option,
 				      const char *arg);
 void		STDCALL mysql_free_result(MYSQL_RES *result);
@@ -40,6 +40,7 @@ enum enum_server_command {
   COM_PROCESS_INFO, COM_CONNECT, COM_PROCESS_KILL, COM_DEBUG, COM_PING,
   COM_TIME, COM_DELAYED_INSERT, COM_CHANGE_USER, COM_BINLOG_DUMP,
   COM_TABLE_DUMP,  COM_CONNECT_OUT, COM_REGISTER_SLAVE,
+  COM_PREPARE, COM_EXECUTE, COM_CLOSE_STMT,
   COM_END					/* Must be last! */
 };
 
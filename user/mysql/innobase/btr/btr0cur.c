@@ -225,7 +225,8 @@ btr_cur_search_to_nth_level(
 	btr_cur_t*	cursor, /* in/out: tree cursor; the cursor page is
 				s- or x-latched, but see also above! */
 	ulint		has_search_latch,/* in: info on the latch mode the
-				caller currently has on btr_search_latch:
+				caller currently has on the latch of the
+				adaptive hash index part of the index:
 				RW_S_LATCH, or 0 */
 	mtr_t*		mtr)	/* in: mtr */
 {
@@ -287,7 +288,7 @@ btr_cur_search_to_nth_level(
 #ifdef UNIV_SEARCH_PERF_STAT
 	info->n_searches++;
 #endif	
-	if (btr_search_latch.writer == RW_LOCK_NOT_LOCKED
+	if (btr_search_get_latch(index->tree->id)->writer == RW_LOCK_NOT_LOCKED
 		&& latch_mode <= BTR_MODIFY_LEAF && info->last_hash_succ
 		&& !estimate
 		&& mode != PAGE_CUR_LE_OR_EXTENDS
@@ -316,7 +317,7 @@ btr_cur_search_to_nth_level(
 
 	if (has_search_latch) {
 		/* Release possible search latch to obey latching order */
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_search_get_latch(index->tree->id));
 	}
 
 	/* Store the position of the tree latch we push to mtr so that we
@@ -508,7 +509,7 @@ retry_page_get:
 
 	if (has_search_latch) {
 		
-		rw_lock_s_lock(&btr_search_latch);
+		rw_lock_s_lock(btr_search_get_latch(index->tree->id));
 	}
 }
 
@@ -1293,7 +1294,7 @@ btr_cur_parse_update_in_place(
 	
 	rec = page + rec_offset;
 	
-	/* We do not need to reserve btr_search_latch, as the page is only
+	/* We do not need to reserve the search latch, as the page is only
 	being recovered, and there cannot be a hash index to it. */
 
 	if (!(flags & BTR_KEEP_SYS_FLAG)) {
@@ -1426,7 +1427,7 @@ btr_cur_update_in_place(
 	                btr_search_update_hash_on_delete(cursor);
 	        }
 
-		rw_lock_x_lock(&btr_search_latch);
+		btr_search_x_lock(btr_search_get_part(index->tree->id));
 	}
 
 	if (!(flags & BTR_KEEP_SYS_FLAG)) {
@@ -1441,7 +1442,7 @@ btr_cur_update_in_place(
 	row_upd_rec_in_place(rec, update);
 
 	if (block->is_hashed) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_search_get_latch(index->tree->id));
 	}
 
 	btr_cur_update_in_place_log(flags, rec, index, update, trx, roll_ptr,
@@ -2013,7 +2014,7 @@ btr_cur_parse_del_mark_set_clust_rec(
 								roll_ptr);
 		}
 
-		/* We do not need to reserve btr_search_latch, as the page
+		/* We do not need to reserve the search latch, as the page
 		is only being recovered, and there cannot be a hash index to
 		it. */
 
@@ -2080,7 +2081,7 @@ btr_cur_del_mark_set_clust_rec(
 	block = buf_block_align(rec);
 
 	if (block->is_hashed) {
-		rw_lock_x_lock(&btr_search_latch);
+		btr_search_x_lock(btr_search_get_part(index->tree->id));
 	}
 
 	rec_set_deleted_flag(rec, val);
@@ -2093,7 +2094,7 @@ btr_cur_del_mark_set_clust_rec(
 	}
 	
 	if (block->is_hashed) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_search_get_latch(index->tree->id));
 	}
 
 	btr_cur_del_mark_set_clust_rec_log(flags, rec, index, val, trx,
@@ -2160,7 +2161,7 @@ btr_cur_parse_del_mark_set_sec_rec(
 	if (page) {
 		rec = page + offset;
 	
-		/* We do not need to reserve btr_search_latch, as the page
+		/* We do not need to reserve the search latch, as the page
 		is only being recovered, and there cannot be a hash index to
 		it. */
 
@@ -2209,13 +2210,15 @@ btr_cur_del_mark_set_sec_rec(
 	block = buf_block_align(rec);
 	
 	if (block->is_hashed) {
-		rw_lock_x_lock(&btr_search_latch);
+		btr_search_x_lock(btr_search_get_part(
+						cursor->index->tree->id));
 	}
 
 	rec_set_deleted_flag(rec, val);
 
 	if (block->is_hashed) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_search_get_latch(
+						cursor->index->tree->id));
 	}
 
 	btr_cur_del_mark_set_sec_rec_log(rec, val, mtr);
@@ -2233,7 +2236,7 @@ btr_cur_del_unmark_for_ibuf(
 	rec_t*	rec,	/* in: record to delete unmark */
 	mtr_t*	mtr)	/* in: mtr */
 {
-	/* We do not need to reserve btr_search_latch, as the page has just
+	/* We do not need to reserve the search latch, as the page has just
 	been read to the buffer pool and there cannot be a hash index to it. */
 
 	rec_set_deleted_flag(rec, FALSE);
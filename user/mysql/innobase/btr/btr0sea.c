@@ -25,24 +25,13 @@ ulint	btr_search_this_is_zero = 0;	/* A dummy variable to fool the
 ulint	btr_search_n_succ	= 0;
 ulint	btr_search_n_hash_fail	= 0;
 
-byte	btr_sea_pad1[64];	/* padding to prevent other memory update
-				hotspots from residing on the same memory
-				cache line as btr_search_latch */
-
-/* The latch protecting the adaptive search system: this latch protects the
-(1) positions of records on those pages where a hash index has been built.
-NOTE: It does not protect values of non-ordering fields within a record from
-being updated in-place! We can use fact (1) to perform unique searches to
-indexes. */
-
-rw_lock_t*	btr_search_latch_temp; /* We will allocate the latch from
-					dynamic memory to get it to the
-					same DRAM page as other hotspot
-					semaphores */
-
-byte	btr_sea_pad2[64];	/* padding to prevent other memory update
-				hotspots from residing on the same memory
-				cache line */
+/* The adaptive search system. The latch of a part of the hash index
+protects the (1) positions of records on those pages where a hash index has
+been built in the part. NOTE: It does not protect values of non-ordering
+fields within a record from being updated in-place! We can use fact (1) to
+perform unique searches to indexes. The parts are allocated from dynamic
+memory to get the latches to the same DRAM page as other hotspot
+semaphores. */
 
 btr_search_sys_t*	btr_search_sys;
 
@@ -86,17 +75,18 @@ allocate a new node to the hash table, it will succeed. However, the check
 will not guarantee success. */
 static
 void
-btr_search_check_free_space_in_heap(void)
-/*=====================================*/
+btr_search_check_free_space_in_heap(
+/*================================*/
+	btr_search_part_t*	part)	/* in: hash index part */
 {
 	buf_frame_t*	frame;
 	hash_table_t*	table;
 	mem_heap_t*	heap;
 
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED)
-			&& !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(&(part->latch), RW_LOCK_SHARED)
+			&& !rw_lock_own(&(part->latch), RW_LOCK_EX));
 
-	table = btr_search_sys->hash_index;
+	table = part->hash_index;
 
 	heap = table->heap;
 			
@@ -107,7 +97,7 @@ btr_search_check_free_space_in_heap(void)
 	if (heap->free_block == NULL) {
 		frame = buf_frame_alloc();
 
-		rw_lock_x_lock(&btr_search_latch);
+		btr_search_x_lock(part);
 
 		if (heap->free_block == NULL) {
 			heap->free_block = frame;
@@ -115,7 +105,7 @@ btr_search_check_free_space_in_heap(void)
 			buf_frame_free(frame);
 		}
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(&(part->latch));
 	}
 }
 
@@ -125,20 +115,37 @@ Creates and initializes the adaptive search system at a database start. */
 void
 btr_search_sys_create(
 /*==================*/
-	ulint	hash_size)	/* in: hash index hash table size */
+	ulint	hash_size,	/* in: hash index hash table size, divided
+				between the parts */
+	ulint	n_parts)	/* in: number of parts of the hash index */
 {
-	/* We allocate the search latch from dynamic memory:
-	see above at the global variable definition */
-	
-	btr_search_latch_temp = mem_alloc(sizeof(rw_lock_t));
-	
-	rw_lock_create(&btr_search_latch);
+	btr_search_part_t*	part;
+	ulint			i;
+
+	if (n_parts == 0) {
+		n_parts = 1;
+	}
+
+	/* We allocate the parts from dynamic memory: see above at the
+	global variable definition */
 
 	btr_search_sys = mem_alloc(sizeof(btr_search_sys_t));
 
-	btr_search_sys->hash_index = ha_create(TRUE, hash_size, 0, 0);
+	btr_search_sys->n_parts = n_parts;
+	btr_search_sys->parts = mem_alloc(n_parts * sizeof(btr_search_part_t));
+
+	for (i = 0; i < n_parts; i++) {
+		part = btr_search_sys->parts + i;
+
+		rw_lock_create(&(part->latch));
+		rw_lock_set_level(&(part->latch), SYNC_SEARCH_SYS);
+
+		part->hash_index = ha_create(TRUE, hash_size / n_parts, 0, 0);
 
-	rw_lock_set_level(&btr_search_latch, SYNC_SEARCH_SYS);
+		part->n_searches = 0;
+		part->n_hits = 0;
+		part->n_latch_waits = 0;
+	}
 }
 
 /*********************************************************************
@@ -194,11 +201,13 @@ btr_search_info_update_hash(
 	ulint		n_unique;
 	int		cmp;
 
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED)
-			&& !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
-
 	index = cursor->index;
 
+	ut_ad(!rw_lock_own(btr_search_get_latch(index->tree->id),
+							RW_LOCK_SHARED)
+	      && !rw_lock_own(btr_search_get_latch(index->tree->id),
+							RW_LOCK_EX));
+
 	if (index->type & DICT_IBUF) {
 		/* So many deletes are performed on an insert buffer tree
 		that we do not consider a hash index useful on it: */
@@ -317,8 +326,10 @@ btr_search_update_block_hash_info(
 	buf_block_t*	block,	/* in: buffer block */
 	btr_cur_t*	cursor)	/* in: cursor */
 {
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED)
-			&& !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(btr_search_get_latch(cursor->index->tree->id),
+							RW_LOCK_SHARED)
+	      && !rw_lock_own(btr_search_get_latch(cursor->index->tree->id),
+							RW_LOCK_EX));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED)
 				|| rw_lock_own(&(block->lock), RW_LOCK_EX));
 	ut_ad(cursor);
@@ -398,7 +409,8 @@ btr_search_update_hash_ref(
 	dulint	tree_id;
 
 	ut_ad(cursor->flag == BTR_CUR_HASH_FAIL);
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(rw_lock_own(btr_search_get_latch(cursor->index->tree->id),
+								RW_LOCK_EX));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED)
 				|| rw_lock_own(&(block->lock), RW_LOCK_EX));
 	if (block->is_hashed
@@ -419,9 +431,8 @@ btr_search_update_hash_ref(
 		fold = rec_fold(rec, block->curr_n_fields,
 						block->curr_n_bytes, tree_id);
 
-		ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_EX));
-
-		ha_insert_for_fold(btr_search_sys->hash_index, fold, rec);
+		ha_insert_for_fold(btr_search_get_part(tree_id)->hash_index,
+								fold, rec);
 	}
 }	
 	
@@ -434,13 +445,16 @@ btr_search_info_update_slow(
 	btr_search_t*	info,	/* in: search info */
 	btr_cur_t*	cursor)	/* in: cursor which was just positioned */
 {
-	buf_block_t*	block;
-	ibool		build_index;
-	ulint*		params;
-	ulint*		params2;
+	btr_search_part_t*	part;
+	buf_block_t*		block;
+	ibool			build_index;
+	ulint*			params;
+	ulint*			params2;
 	
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED)
-			&& !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	part = btr_search_get_part(cursor->index->tree->id);
+
+	ut_ad(!rw_lock_own(&(part->latch), RW_LOCK_SHARED)
+			&& !rw_lock_own(&(part->latch), RW_LOCK_EX));
 
 	block = buf_block_align(btr_cur_get_rec(cursor));
 
@@ -455,7 +469,7 @@ btr_search_info_update_slow(
 
 	if (build_index || (cursor->flag == BTR_CUR_HASH_FAIL)) {
 
-		btr_search_check_free_space_in_heap();
+		btr_search_check_free_space_in_heap(part);
 	}
 	
 	if (cursor->flag == BTR_CUR_HASH_FAIL) {
@@ -463,11 +477,11 @@ btr_search_info_update_slow(
 
 		btr_search_n_hash_fail++;
 
-		rw_lock_x_lock(&btr_search_latch);
+		btr_search_x_lock(part);
 
 		btr_search_update_hash_ref(info, block, cursor);
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(&(part->latch));
 	}
 
 	if (build_index) {
@@ -510,8 +524,8 @@ btr_search_check_guess(
 	btr_cur_t*	cursor,	/* in: guessed cursor position */
 	ibool           can_only_compare_to_cursor_rec,
 	                        /* in: if we do not have a latch on the page
-				of cursor, but only a latch on
-			        btr_search_latch, then ONLY the columns
+				of cursor, but only a latch on the
+			        hash index part, then ONLY the columns
 				of the record UNDER the cursor are
 				protected, not the next or previous record
 				in the chain: we cannot look at the next or
@@ -674,10 +688,12 @@ btr_search_guess_on_hash(
 					to protect the record! */
 	btr_cur_t*	cursor, 	/* out: tree cursor */
 	ulint		has_search_latch,/* in: latch mode the caller
-					currently has on btr_search_latch:
+					currently has on the latch of the
+					hash index part of index:
 					RW_S_LATCH, RW_X_LATCH, or 0 */
 	mtr_t*		mtr)		/* in: mtr */
 {
+	btr_search_part_t* part;
 	buf_block_t*	block;
 	rec_t*		rec;
 	page_t*		page;
@@ -719,6 +735,10 @@ btr_search_guess_on_hash(
 
 	tree_id = (index->tree)->id;
 
+	part = btr_search_get_part(tree_id);
+
+	part->n_searches++;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	info->n_hash_succ++;
 #endif
@@ -728,17 +748,17 @@ btr_search_guess_on_hash(
 	cursor->flag = BTR_CUR_HASH;
 	
 	if (!has_search_latch) {
-		rw_lock_s_lock(&btr_search_latch);
+		btr_search_s_lock(part);
 	}
 
-	ut_a(btr_search_latch.writer != RW_LOCK_EX);
-	ut_a(btr_search_latch.reader_count > 0);
+	ut_a(part->latch.writer != RW_LOCK_EX);
+	ut_a(part->latch.reader_count > 0);
 
-	rec = ha_search_and_get_data(btr_search_sys->hash_index, fold);
+	rec = ha_search_and_get_data(part->hash_index, fold);
 
 	if (!rec) {
 		if (!has_search_latch) {
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(&(part->latch));
 		}
 		
 		goto failure;
@@ -753,7 +773,7 @@ btr_search_guess_on_hash(
 						IB__FILE__, __LINE__,
 						mtr);
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(&(part->latch));
 
 		if (!success) {
 
@@ -793,8 +813,8 @@ btr_search_guess_on_hash(
 				fold);
 */				
 	} else {
-	        /* If we only have the latch on btr_search_latch, not on the
-		page, it only protects the columns of the record the cursor
+	        /* If we only have the latch on the hash index part, not on
+		the page, it only protects the columns of the record the cursor
 		is positioned on. We cannot look at the next of the previous
 		record to determine if our guess for the cursor position is
 		right. */
@@ -858,6 +878,8 @@ btr_search_guess_on_hash(
 	info->last_hash_succ = TRUE;
 #endif
 
+	part->n_hits++;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	btr_search_n_succ++;
 #endif
@@ -869,7 +891,7 @@ btr_search_guess_on_hash(
 	/* Increment the page get statistics though we did not really
 	fix the page: for user info only */
 
-	buf_pool->n_page_gets++;
+	block->buf_pool->n_page_gets++;
 
 	return(TRUE);	
 
@@ -897,6 +919,7 @@ btr_search_drop_page_hash_index(
 /*============================*/
 	page_t*	page)	/* in: index page, s- or x-latched */
 {
+	btr_search_part_t* part;
 	hash_table_t*	table;
 	buf_block_t*	block;
 	ulint		n_fields;
@@ -911,21 +934,28 @@ btr_search_drop_page_hash_index(
 	ulint*		folds;
 	ulint		i;
 	
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED)
-			&& !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	/* If the page is hashed, it is an index page and its index id
+	tells the part of the hash index */
+
+	tree_id = btr_page_get_index_id(page);
+
+	part = btr_search_get_part(tree_id);
+
+	ut_ad(!rw_lock_own(&(part->latch), RW_LOCK_SHARED)
+			&& !rw_lock_own(&(part->latch), RW_LOCK_EX));
 		
-	rw_lock_s_lock(&btr_search_latch);
+	btr_search_s_lock(part);
 
 	block = buf_block_align(page);
 
 	if (!block->is_hashed) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(&(part->latch));
 
 		return;
 	}
 
-	table = btr_search_sys->hash_index;
+	table = part->hash_index;
 
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED)
 	      			|| rw_lock_own(&(block->lock), RW_LOCK_EX)
@@ -936,7 +966,7 @@ btr_search_drop_page_hash_index(
 
 	ut_a(n_fields + n_bytes > 0);
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(&(part->latch));
 	
 	n_recs = page_get_n_recs(page);
 
@@ -960,8 +990,6 @@ btr_search_drop_page_hash_index(
 		}
 	}
 
-	tree_id = btr_page_get_index_id(page);
-	
 	prev_fold = 0;
 
 	while (rec != sup) {
@@ -985,7 +1013,7 @@ next_rec:
 		prev_fold = fold;
 	}
 
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock(part);
 
 	for (i = 0; i < n_cached; i++) {
 
@@ -994,7 +1022,7 @@ next_rec:
 
 	block->is_hashed = FALSE;
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(&(part->latch));
 
 	mem_free(folds);
 }
@@ -1053,6 +1081,7 @@ btr_search_build_page_hash_index(
 				field */
 	ulint		side)	/* in: hash for searches from this side */
 {
+	btr_search_part_t* part;
 	hash_table_t*	table;
 	buf_block_t*	block;
 	rec_t*		rec;
@@ -1068,23 +1097,27 @@ btr_search_build_page_hash_index(
 	ulint		i;
 	
 	block = buf_block_align(page);
-	table = btr_search_sys->hash_index;
 
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	tree_id = btr_page_get_index_id(page);
+
+	part = btr_search_get_part(tree_id);
+	table = part->hash_index;
+
+	ut_ad(!rw_lock_own(&(part->latch), RW_LOCK_EX));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED)
 				|| rw_lock_own(&(block->lock), RW_LOCK_EX));
 
-	rw_lock_s_lock(&btr_search_latch);
+	btr_search_s_lock(part);
 				
 	if (block->is_hashed && ((block->curr_n_fields != n_fields)
 	        			|| (block->curr_n_bytes != n_bytes)
 	        			|| (block->curr_side != side))) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(&(part->latch));
 
 		btr_search_drop_page_hash_index(page);
 	} else {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(&(part->latch));
 	}
 
 	n_recs = page_get_n_recs(page);
@@ -1115,8 +1148,6 @@ btr_search_build_page_hash_index(
 
 	n_cached = 0;
 
-	tree_id = btr_page_get_index_id(page);
-
 	sup = page_get_supremum_rec(page);
 
 	rec = page_get_infimum_rec(page);
@@ -1178,15 +1209,15 @@ btr_search_build_page_hash_index(
 		fold = next_fold;
 	}
 
-	btr_search_check_free_space_in_heap();
+	btr_search_check_free_space_in_heap(part);
 
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock(part);
 
 	if (block->is_hashed && ((block->curr_n_fields != n_fields)
 	        			|| (block->curr_n_bytes != n_bytes)
 	        			|| (block->curr_side != side))) {
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(&(part->latch));
 
 		mem_free(folds);
 		mem_free(recs);
@@ -1206,7 +1237,7 @@ btr_search_build_page_hash_index(
 		ha_insert_for_fold(table, folds[i], recs[i]);
 	}
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(&(part->latch));
 
 	mem_free(folds);
 	mem_free(recs);
@@ -1226,6 +1257,7 @@ btr_search_move_or_delete_hash_entries(
 				copied, and the copied records will be deleted
 				from this page */
 {
+	btr_search_part_t* part;
 	buf_block_t*	block;
 	buf_block_t*	new_block;
 	ulint		n_fields;
@@ -1238,11 +1270,16 @@ btr_search_move_or_delete_hash_entries(
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_EX)
 			&& rw_lock_own(&(new_block->lock), RW_LOCK_EX));
 
-	rw_lock_s_lock(&btr_search_latch);
+	/* The pages belong to the same index, and thus to the same part
+	of the hash index */
+
+	part = btr_search_get_part(btr_page_get_index_id(page));
+
+	btr_search_s_lock(part);
 			
 	if (new_block->is_hashed) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(&(part->latch));
 
 		btr_search_drop_page_hash_index(page);
 
@@ -1259,7 +1296,7 @@ btr_search_move_or_delete_hash_entries(
 		new_block->n_bytes = block->curr_n_bytes;
 		new_block->side = block->curr_side;
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(&(part->latch));
 
 		ut_a(n_fields + n_bytes > 0);
 		
@@ -1272,7 +1309,7 @@ btr_search_move_or_delete_hash_entries(
 		return;
 	}
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(&(part->latch));
 }
 
 /************************************************************************
@@ -1285,6 +1322,7 @@ btr_search_update_hash_on_delete(
 				record to delete using btr_cur_search_...,
 				the record is not yet deleted */
 {
+	btr_search_part_t* part;
 	hash_table_t*	table;
 	buf_block_t*	block;
 	rec_t*		rec;
@@ -1305,17 +1343,19 @@ btr_search_update_hash_on_delete(
 
 	ut_a(block->curr_n_fields + block->curr_n_bytes > 0);
 
-	table = btr_search_sys->hash_index;
-
 	tree_id = cursor->index->tree->id;
 
+	part = btr_search_get_part(tree_id);
+
+	table = part->hash_index;
+
 	fold = rec_fold(rec, block->curr_n_fields, block->curr_n_bytes,
 								tree_id);
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock(part);
 
 	found = ha_search_and_delete_if_found(table, fold, rec);
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(&(part->latch));
 }
 
 /************************************************************************
@@ -1329,6 +1369,7 @@ btr_search_update_hash_node_on_insert(
 				and the new record has been inserted next
 				to the cursor */
 {
+	btr_search_part_t* part;
 	hash_table_t*	table;
 	buf_block_t*	block;
 	rec_t*		rec;
@@ -1344,21 +1385,23 @@ btr_search_update_hash_node_on_insert(
 		return;
 	}
 
-	rw_lock_x_lock(&btr_search_latch);
+	part = btr_search_get_part(cursor->index->tree->id);
+
+	btr_search_x_lock(part);
 
 	if ((cursor->flag == BTR_CUR_HASH)
 	    && (cursor->n_fields == block->curr_n_fields)
 	    && (cursor->n_bytes == block->curr_n_bytes)
 	    && (block->curr_side == BTR_SEARCH_RIGHT_SIDE)) {
 
-	    	table = btr_search_sys->hash_index;
+	    	table = part->hash_index;
 	    	
 	    	ha_search_and_update_if_found(table, cursor->fold, rec,
 						page_rec_get_next(rec));
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(&(part->latch));
 	} else {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(&(part->latch));
 
 		btr_search_update_hash_on_insert(cursor);
 	}
@@ -1375,6 +1418,7 @@ btr_search_update_hash_on_insert(
 				and the new record has been inserted next
 				to the cursor */
 {
+	btr_search_part_t* part;
 	hash_table_t*	table; 
 	buf_block_t*	block;
 	page_t*		page;
@@ -1390,9 +1434,11 @@ btr_search_update_hash_on_insert(
 	ulint		side;
 	ibool		locked	= FALSE;
 
-	table = btr_search_sys->hash_index;
+	part = btr_search_get_part(cursor->index->tree->id);
+
+	table = part->hash_index;
 
-	btr_search_check_free_space_in_heap();
+	btr_search_check_free_space_in_heap(part);
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1427,7 +1473,7 @@ btr_search_update_hash_on_insert(
 	} else {
 		if (side == BTR_SEARCH_LEFT_SIDE) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			btr_search_x_lock(part);
 
 			locked = TRUE;
 
@@ -1441,7 +1487,7 @@ btr_search_update_hash_on_insert(
 
  		if (!locked) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			btr_search_x_lock(part);
 
 			locked = TRUE;
 		}
@@ -1459,7 +1505,7 @@ check_next_rec:
 		if (side == BTR_SEARCH_RIGHT_SIDE) {
 
  			if (!locked) {
-				rw_lock_x_lock(&btr_search_latch);
+				btr_search_x_lock(part);
 
 				locked = TRUE;
 			}
@@ -1474,7 +1520,7 @@ check_next_rec:
 
  		if (!locked) {
 	
-			rw_lock_x_lock(&btr_search_latch);
+			btr_search_x_lock(part);
 
 			locked = TRUE;
 		}
@@ -1493,7 +1539,7 @@ check_next_rec:
 		
 function_exit:
 	if (locked) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(&(part->latch));
 	}
 }
 
@@ -1504,13 +1550,62 @@ void
 btr_search_print_info(void)
 /*=======================*/
 {
+	btr_search_part_t*	part;
+	ulint			i;
+
 	printf("SEARCH SYSTEM INFO\n");
 
-	rw_lock_x_lock(&btr_search_latch);
+	for (i = 0; i < btr_search_sys->n_parts; i++) {
+		part = btr_search_sys->parts + i;
 
-/*	ha_print_info(btr_search_sys->hash_index); */
+		printf("Part %lu: searches %lu, hits %lu, latch waits %lu\n",
+			i, part->n_searches, part->n_hits,
+			part->n_latch_waits);
+	}
+}
 
-	rw_lock_x_unlock(&btr_search_latch);
+/*************************************************************************
+Prints the size and the search and latch statistics of the hash index parts
+to a buffer. */
+
+void
+btr_search_sys_print(
+/*=================*/
+	char*	buf,	/* in/out: buffer where to print */
+	char*	buf_end)/* in: buffer end */
+{
+	btr_search_part_t*	part;
+	ulint			n_searches	= 0;
+	ulint			n_hits		= 0;
+	ulint			n_latch_waits	= 0;
+	ulint			i;
+
+	for (i = 0; i < btr_search_sys->n_parts; i++) {
+		part = btr_search_sys->parts + i;
+
+		if (buf_end - buf < 400) {
+
+			return;
+		}
+
+		if (btr_search_sys->n_parts > 1) {
+			buf += sprintf(buf, "Part %lu: ", i);
+		}
+
+		/* The hash table is read without the latch: the numbers
+		are only approximate */
+
+		ha_print_info(buf, buf_end, part->hash_index);
+		buf += strlen(buf);
+
+		n_searches += part->n_searches;
+		n_hits += part->n_hits;
+		n_latch_waits += part->n_latch_waits;
+	}
+
+	buf += sprintf(buf,
+	"Hash index parts %lu, searches %lu, hits %lu, latch waits %lu\n",
+		btr_search_sys->n_parts, n_searches, n_hits, n_latch_waits);
 }
 
 /************************************************************************
@@ -1522,10 +1617,13 @@ btr_search_index_print_info(
 	dict_index_t*	index)	/* in: index */
 {
 	btr_search_t*	info;
+	rw_lock_t*	latch;
 
 	printf("INDEX SEARCH INFO\n");
 
-	rw_lock_x_lock(&btr_search_latch);
+	latch = btr_search_get_latch(index->tree->id);
+
+	rw_lock_x_lock(latch);
 
 	info = btr_search_get_info(index);
 
@@ -1535,7 +1633,7 @@ btr_search_index_print_info(
 
 	printf("Total of page cur short succ for all indexes %lu\n",
 							page_cur_short_succ);
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 }
 
 /************************************************************************
@@ -1567,13 +1665,15 @@ btr_search_table_print_info(
 }
 
 /************************************************************************
-Validates the search system. */
-
+Validates a part of the search system. */
+static
 ibool
-btr_search_validate(void)
+btr_search_validate_part(
 /*=====================*/
-				/* out: TRUE if ok */
+					/* out: TRUE if ok */
+	btr_search_part_t*	part)	/* in: hash index part */
 {
+	hash_table_t*	table;
 	buf_block_t*	block;
 	page_t*		page;
 	ha_node_t*	node;
@@ -1582,16 +1682,20 @@ btr_search_validate(void)
 	ulint		i;
 	char		rec_str[500];
 	
-	rw_lock_x_lock(&btr_search_latch);
+	table = part->hash_index;
+
+	rw_lock_x_lock(&(part->latch));
 
-	for (i = 0; i < hash_get_n_cells(btr_search_sys->hash_index); i++) {
-		node = hash_get_nth_cell(btr_search_sys->hash_index, i)->node;
+	for (i = 0; i < hash_get_n_cells(table); i++) {
+		node = hash_get_nth_cell(table, i)->node;
 
 		while (node != NULL) {
 			block = buf_block_align(node->data);
 			page = buf_frame_align(node->data);
 
 			if (!block->is_hashed
+			    || btr_search_get_part(btr_page_get_index_id(page))
+								!= part
 			    || node->fold != rec_fold((rec_t*)(node->data),
 						block->curr_n_fields,
 						block->curr_n_bytes,
@@ -1633,12 +1737,34 @@ btr_search_validate(void)
 		}
 	}
 	
-	if (!ha_validate(btr_search_sys->hash_index)) {
+	if (!ha_validate(table)) {
 
 		ok = FALSE;
 	}
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(&(part->latch));
+
+	return(ok);
+}
+
+/************************************************************************
+Validates the search system. */
+
+ibool
+btr_search_validate(void)
+/*=====================*/
+				/* out: TRUE if ok */
+{
+	ibool	ok	= TRUE;
+	ulint	i;
+
+	for (i = 0; i < btr_search_sys->n_parts; i++) {
+
+		if (!btr_search_validate_part(btr_search_sys->parts + i)) {
+
+			ok = FALSE;
+		}
+	}
 
 	return(ok);
 }
@@ -31,6 +31,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "fil0fil.h"
 #include "lock0lock.h"
 #include "btr0sea.h"
+#include "buf0zip.h"
 #include "ibuf0ibuf.h"
 #include "dict0dict.h"
 #include "log0recv.h"
@@ -86,6 +87,19 @@ create a separate mutex for the page hash table. On Pentium,
 accessing the hash table takes 2 microseconds, about half
 of the total buf_pool mutex hold time.
 
+		Buffer pool instances
+		---------------------
+The buffer pool can be split into several instances, each of which has
+its own mutex, page hash table, LRU list, flush list and free list, and
+a fixed part of the control blocks and frames. A file page is always
+buffered in the instance given by buf_pool_get(), which hashes the space
+id and the page number divided by BUF_POOL_INSTANCE_AREA: the pages which
+read-ahead and the flushing of neighbor pages handle together are thus
+in the same instance, and a thread owns at most one instance mutex at a
+time. Memory frames which do not contain a file page are allocated from
+the instances in turn. The instances share one frame array, so that
+buf_block_align() does not need to know the instance.
+
 		Control blocks
 		--------------
 
@@ -199,7 +213,18 @@ in a tablespace) have recently been referenced, we may predict
 that the whole area may be needed in the near future, and issue
 the read requests for the whole area. */
 
-buf_pool_t*	buf_pool = NULL; /* The buffer buf_pool of the database */
+buf_pool_t*	buf_pools[BUF_POOL_MAX_INSTANCES];
+				/* The buffer pool instances of the
+				database */
+ulint		buf_pool_n_instances	= 0;
+byte*		buf_pool_frame_zero	= NULL;
+byte*		buf_pool_high_end	= NULL;
+buf_block_t*	buf_pool_blocks		= NULL;
+ulint		buf_pool_n_blocks	= 0;
+
+ulint		buf_pool_alloc_count	= 0; /* used to choose the instance
+					for buf_frame_alloc; not protected
+					by any mutex */
 
 ulint		buf_dbg_counter	= 0; /* This is used to insert validation
 					operations in excution in the
@@ -428,9 +453,12 @@ static
 void
 buf_block_init(
 /*===========*/
+	buf_pool_t*	buf_pool,/* in: buffer pool instance */
 	buf_block_t*	block,	/* in: pointer to control block */
 	byte*		frame)	/* in: pointer to buffer frame */
 {
+	block->buf_pool = buf_pool;
+
 	block->state = BUF_BLOCK_NOT_USED;
 	
 	block->frame = frame;
@@ -452,20 +480,22 @@ buf_block_init(
 }
 
 /************************************************************************
-Creates a buffer buf_pool object. */
+Creates a buffer pool instance. */
 static
 buf_pool_t*
 buf_pool_create(
 /*============*/
-				/* out, own: buf_pool object, NULL if not
-				enough memory */
-	ulint	max_size,	/* in: maximum size of the buf_pool in
+				/* out, own: buf_pool instance */
+	ulint		id,	/* in: index of the instance in buf_pools */
+	buf_block_t*	blocks,	/* in: control blocks of the instance */
+	byte*		frame,	/* in: first frame of the instance */
+	ulint		max_size,/* in: maximum size of the instance in
 				blocks */
-	ulint	curr_size)	/* in: current size to use, must be <=
+	ulint		curr_size)/* in: current size to use, must be <=
 				max_size, currently must be equal to
 				max_size */
 {
-	byte*		frame;
+	buf_pool_t*	buf_pool;
 	ulint		i;
 	buf_block_t*	block;
 	
@@ -475,40 +505,23 @@ buf_pool_create(
 
 	/* 1. Initialize general fields
 	   ---------------------------- */
+	buf_pool->id = id;
+
 	mutex_create(&(buf_pool->mutex));
 	mutex_set_level(&(buf_pool->mutex), SYNC_BUF_POOL);
 
 	mutex_enter(&(buf_pool->mutex));
 	
-	buf_pool->frame_mem = ut_malloc(UNIV_PAGE_SIZE * (max_size + 1));
-
-	if (buf_pool->frame_mem == NULL) {
-
-		return(NULL);
-	}
-
-	buf_pool->blocks = ut_malloc(sizeof(buf_block_t) * max_size);
-
-	if (buf_pool->blocks == NULL) {
-
-		return(NULL);
-	}
+	buf_pool->blocks = blocks;
 
 	buf_pool->max_size = max_size;
 	buf_pool->curr_size = curr_size;
 
-	/* Align pointer to the first frame */
-
-	frame = ut_align(buf_pool->frame_mem, UNIV_PAGE_SIZE);
-	buf_pool->frame_zero = frame;
-
-	buf_pool->high_end = frame + UNIV_PAGE_SIZE * curr_size;
-
 	/* Init block structs and assign frames for them */
 	for (i = 0; i < max_size; i++) {
 
 		block = buf_pool_get_nth_block(buf_pool, i);
-		buf_block_init(block, frame);
+		buf_block_init(buf_pool, block, frame);
 		frame = frame + UNIV_PAGE_SIZE;
 	}
 	
@@ -560,8 +573,6 @@ buf_pool_create(
 
 	mutex_exit(&(buf_pool->mutex));
 
-	btr_search_sys_create(curr_size * UNIV_PAGE_SIZE / sizeof(void*) / 64);
-
 	return(buf_pool);
 }	
 
@@ -572,12 +583,67 @@ void
 buf_pool_init(
 /*==========*/
 	ulint	max_size,	/* in: maximum size of the buf_pool in blocks */
-	ulint	curr_size)	/* in: current size to use, must be <=
+	ulint	curr_size,	/* in: current size to use, must be <=
 				max_size */
+	ulint	n_instances)	/* in: number of buffer pool instances; this
+				is decreased if an instance would get less
+				than BUF_POOL_MIN_INSTANCE_SIZE blocks */
 {
-	ut_a(buf_pool == NULL);
+	byte*	frame_mem;
+	byte*	frame;
+	ulint	first;
+	ulint	size;
+	ulint	i;
+
+	ut_a(buf_pool_n_instances == 0);
+	ut_a(max_size == curr_size);
+
+	if (n_instances > BUF_POOL_MAX_INSTANCES) {
+		n_instances = BUF_POOL_MAX_INSTANCES;
+	}
 
-	buf_pool_create(max_size, curr_size);
+	if (n_instances > max_size / BUF_POOL_MIN_INSTANCE_SIZE) {
+		n_instances = max_size / BUF_POOL_MIN_INSTANCE_SIZE;
+	}
+
+	if (n_instances == 0) {
+		n_instances = 1;
+	}
+
+	/* All the instances use parts of one frame array and one control
+	block array: then a frame can be mapped to its block without
+	knowing the instance */
+
+	frame_mem = ut_malloc(UNIV_PAGE_SIZE * (max_size + 1));
+
+	buf_pool_blocks = ut_malloc(sizeof(buf_block_t) * max_size);
+
+	ut_a(frame_mem && buf_pool_blocks);
+
+	/* Align pointer to the first frame */
+
+	buf_pool_frame_zero = ut_align(frame_mem, UNIV_PAGE_SIZE);
+	buf_pool_high_end = buf_pool_frame_zero + UNIV_PAGE_SIZE * max_size;
+	buf_pool_n_blocks = max_size;
+
+	first = 0;
+
+	for (i = 0; i < n_instances; i++) {
+		size = (max_size - first) / (n_instances - i);
+
+		frame = buf_pool_frame_zero + UNIV_PAGE_SIZE * first;
+
+		buf_pools[i] = buf_pool_create(i, buf_pool_blocks + first,
+						frame, size, size);
+		first += size;
+	}
+
+	ut_a(first == max_size);
+
+	buf_pool_n_instances = n_instances;
+
+	btr_search_sys_create(curr_size * UNIV_PAGE_SIZE / sizeof(void*) / 64,
+					srv_adaptive_hash_index_parts);
 
 	ut_ad(buf_validate());
 }
@@ -586,13 +652,14 @@ buf_pool_init(
 Allocates a buffer block. */
 UNIV_INLINE
 buf_block_t*
-buf_block_alloc(void)
-/*=================*/
+buf_block_alloc(
+/*============*/
 				/* out, own: the allocated block */
+	buf_pool_t*	buf_pool)/* in: buffer pool instance */
 {
 	buf_block_t*	block;
 
-	block = buf_LRU_get_free_block();
+	block = buf_LRU_get_free_block(buf_pool);
 
 	return(block);
 }
@@ -606,6 +673,8 @@ buf_block_make_young(
 /*=================*/
 	buf_block_t*	block)	/* in: block to make younger */
 {
+	buf_pool_t*	buf_pool	= block->buf_pool;
+
 	if (buf_pool->freed_page_clock >= block->freed_page_clock 
 				+ 1 + (buf_pool->curr_size / 1024)) {
 
@@ -628,15 +697,15 @@ buf_page_make_young(
 {
 	buf_block_t*	block;
 	
-	mutex_enter(&(buf_pool->mutex));
-
 	block = buf_block_align(frame);
 
+	mutex_enter(&(block->buf_pool->mutex));
+
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
 
 	buf_LRU_make_block_young(block);
 
-	mutex_exit(&(buf_pool->mutex));
+	mutex_exit(&(block->buf_pool->mutex));
 }
 
 /************************************************************************
@@ -649,11 +718,11 @@ buf_block_free(
 {
 	ut_ad(block->state != BUF_BLOCK_FILE_PAGE);
 
-	mutex_enter(&(buf_pool->mutex));
+	mutex_enter(&(block->buf_pool->mutex));
 
 	buf_LRU_block_free_non_file_page(block);
 
-	mutex_exit(&(buf_pool->mutex));
+	mutex_exit(&(block->buf_pool->mutex));
 }
 
 /*************************************************************************
@@ -664,7 +733,14 @@ buf_frame_alloc(void)
 /*=================*/
 				/* out: buffer frame */
 {
-	return(buf_block_alloc()->frame);
+	buf_pool_t*	buf_pool;
+
+	/* The frame does not contain a file page: take it from the
+	instances in turn */
+
+	buf_pool = buf_pools[buf_pool_alloc_count++ % buf_pool_n_instances];
+
+	return(buf_block_alloc(buf_pool)->frame);
 }
 
 /*************************************************************************
@@ -692,11 +768,14 @@ buf_page_peek_block(
 	ulint	space,	/* in: space id */
 	ulint	offset)	/* in: page number */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 
+	buf_pool = buf_pool_get(space, offset);
+
 	mutex_enter_fast(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 
 	mutex_exit(&(buf_pool->mutex));
 
@@ -713,11 +792,14 @@ buf_reset_check_index_page_at_flush(
 	ulint	space,	/* in: space id */
 	ulint	offset)	/* in: page number */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 
+	buf_pool = buf_pool_get(space, offset);
+
 	mutex_enter_fast(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 
 	if (block) {
 		block->check_index_page_at_flush = FALSE;
@@ -739,12 +821,15 @@ buf_page_peek_if_search_hashed(
 	ulint	space,	/* in: space id */
 	ulint	offset)	/* in: page number */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	ibool		is_hashed;
 
+	buf_pool = buf_pool_get(space, offset);
+
 	mutex_enter_fast(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 
 	if (!block) {
 		is_hashed = FALSE;
@@ -792,11 +877,14 @@ buf_page_set_file_page_was_freed(
 	ulint	space,	/* in: space id */
 	ulint	offset)	/* in: page number */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 
+	buf_pool = buf_pool_get(space, offset);
+
 	mutex_enter_fast(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 
 	if (block) {
 		block->file_page_was_freed = TRUE;
@@ -821,11 +909,14 @@ buf_page_reset_file_page_was_freed(
 	ulint	space,	/* in: space id */
 	ulint	offset)	/* in: page number */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 
+	buf_pool = buf_pool_get(space, offset);
+
 	mutex_enter_fast(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 
 	if (block) {
 		block->file_page_was_freed = FALSE;
@@ -853,6 +944,7 @@ buf_page_get_gen(
 	ulint		line,	/* in: line where called */
 	mtr_t*		mtr)	/* in: mini-transaction */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	ibool		accessed;
 	ulint		fix_type;
@@ -869,6 +961,8 @@ buf_page_get_gen(
 #ifndef UNIV_LOG_DEBUG
 	ut_ad(!ibuf_inside() || ibuf_page(space, offset));
 #endif
+	buf_pool = buf_pool_get(space, offset);
+
 	buf_pool->n_page_gets++;
 loop:
 	mutex_enter_fast(&(buf_pool->mutex));
@@ -886,7 +980,7 @@ loop:
 	}
 
 	if (block == NULL) {
-		block = buf_page_hash_get(space, offset);
+		block = buf_page_hash_get(buf_pool, space, offset);
 	}
 
 	if (block == NULL) {
@@ -1027,6 +1121,7 @@ buf_page_optimistic_get_func(
 	ulint		line,	/* in: line where called */
 	mtr_t*		mtr)	/* in: mini-transaction */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	ibool		accessed;
 	ibool		success;
@@ -1035,9 +1130,11 @@ buf_page_optimistic_get_func(
 	ut_ad(mtr && guess);
 	ut_ad((rw_latch == RW_S_LATCH) || (rw_latch == RW_X_LATCH));
 
-	buf_pool->n_page_gets++;
-
 	block = buf_block_align(guess);
+
+	buf_pool = block->buf_pool;
+
+	buf_pool->n_page_gets++;
 	
 	mutex_enter(&(buf_pool->mutex));
 
@@ -1152,6 +1249,7 @@ buf_page_get_known_nowait(
 	ulint		line,	/* in: line where called */
 	mtr_t*		mtr)	/* in: mini-transaction */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	ibool		success;
 	ulint		fix_type;
@@ -1159,9 +1257,11 @@ buf_page_get_known_nowait(
 	ut_ad(mtr);
 	ut_ad((rw_latch == RW_S_LATCH) || (rw_latch == RW_X_LATCH));
 
-	buf_pool->n_page_gets++;
-
 	block = buf_block_align(guess);
+
+	buf_pool = block->buf_pool;
+
+	buf_pool->n_page_gets++;
 	
 	mutex_enter(&(buf_pool->mutex));
 
@@ -1285,8 +1385,11 @@ buf_page_init(
 				in units of a page */
 	buf_block_t*	block)	/* in: block to init */
 {
+	buf_pool_t*	buf_pool	= block->buf_pool;
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 	ut_ad(block->state == BUF_BLOCK_READY_FOR_USE);
+	ut_ad(buf_pool == buf_pool_get(space, offset));
 
 	/* Set the state of the block */
 	block->magic_n		= BUF_BLOCK_MAGIC_N;
@@ -1299,6 +1402,11 @@ buf_page_init(
 	
 	block->lock_hash_val	= lock_rec_hash(space, offset);
 	block->lock_mutex	= NULL;
+
+	/* A compressed copy of the page gets out of date when the page
+	is modified in the buffer pool */
+
+	buf_zip_drop(space, offset);
 	
 	/* Insert into the hash table of file pages */
 
@@ -1329,7 +1437,9 @@ already in buf_pool, does nothing. Sets the io_fix flag to BUF_IO_READ and
 sets a non-recursive exclusive lock on the buffer frame. The io-handler must
 take care that the flag is cleared and the lock released later. This is one
 of the functions which perform the state transition NOT_USED => FILE_PAGE to
-a block (the other is buf_page_create). */ 
+a block (the other is buf_page_create). If zip is not NULL, a compressed copy
+of the page is taken out of the compressed page cache: the caller should
+uncompress it to the frame instead of reading the page from the file. */ 
 
 buf_block_t*
 buf_page_init_for_read(
@@ -1337,12 +1447,20 @@ buf_page_init_for_read(
 			/* out: pointer to the block or NULL */
 	ulint	mode,	/* in: BUF_READ_IBUF_PAGES_ONLY, ... */
 	ulint	space,	/* in: space id */
-	ulint	offset)	/* in: page number */
+	ulint	offset,	/* in: page number */
+	buf_zip_page_t** zip)/* out, own: compressed copy of the page, or
+			NULL; the caller must pass NULL if it does not
+			complete the read itself */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	mtr_t		mtr;
 	
-	ut_ad(buf_pool);
+	buf_pool = buf_pool_get(space, offset);
+
+	if (zip) {
+		*zip = NULL;
+	}
 
 	if (mode == BUF_READ_IBUF_PAGES_ONLY) {
 		/* It is a read-ahead within an ibuf routine */
@@ -1362,13 +1480,13 @@ buf_page_init_for_read(
 		ut_ad(mode == BUF_READ_ANY_PAGE);
 	}
 	
-	block = buf_block_alloc();
+	block = buf_block_alloc(buf_pool);
 
 	ut_ad(block);
 
 	mutex_enter(&(buf_pool->mutex));
 	
-	if (NULL != buf_page_hash_get(space, offset)) {
+	if (NULL != buf_page_hash_get(buf_pool, space, offset)) {
 
 		/* The page is already in buf_pool, return */
 
@@ -1384,6 +1502,10 @@ buf_page_init_for_read(
 	}
 
 	ut_ad(block);
+
+	if (zip) {
+		*zip = buf_zip_take(space, offset);
+	}
 	
 	buf_page_init(space, offset, block);
 
@@ -1430,17 +1552,20 @@ buf_page_create(
 			a page */
 	mtr_t*	mtr)	/* in: mini-transaction handle */
 {
+	buf_pool_t*	buf_pool;
 	buf_frame_t*	frame;
 	buf_block_t*	block;
 	buf_block_t*	free_block	= NULL;
 	
 	ut_ad(mtr);
 
-	free_block = buf_LRU_get_free_block();
+	buf_pool = buf_pool_get(space, offset);
+
+	free_block = buf_LRU_get_free_block(buf_pool);
 	
 	mutex_enter(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 
 	if (block != NULL) {
 #ifdef UNIV_IBUF_DEBUG
@@ -1491,7 +1616,7 @@ buf_page_create(
 	ibuf_merge_or_delete_for_page(NULL, space, offset);	
 
 	/* Flush pages from the end of the LRU list if necessary */
-	buf_flush_free_margin();
+	buf_flush_free_margin(buf_pool);
 
 	frame = block->frame;
 #ifdef UNIV_DEBUG
@@ -1516,6 +1641,7 @@ buf_page_io_complete(
 /*=================*/
 	buf_block_t*	block)	/* in: pointer to the block in question */
 {
+	buf_pool_t*	buf_pool;
 	dict_index_t*	index;
 	dulint		id;
 	ulint		io_type;
@@ -1523,6 +1649,8 @@ buf_page_io_complete(
 	
 	ut_ad(block);
 
+	buf_pool = block->buf_pool;
+
 	io_type = block->io_fix;
 
 	if (io_type == BUF_IO_READ) {
@@ -1681,29 +1809,36 @@ void
 buf_pool_invalidate(void)
 /*=====================*/
 {
-	ibool	freed;
+	buf_pool_t*	buf_pool;
+	ibool		freed;
+	ulint		i;
 
 	ut_ad(buf_all_freed());
 	
-	freed = TRUE;
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_pool = buf_pools[i];
 
-	while (freed) {
-		freed = buf_LRU_search_and_free_block(100);
-	}
+		freed = TRUE;
+
+		while (freed) {
+			freed = buf_LRU_search_and_free_block(buf_pool, 100);
+		}
 	
-	mutex_enter(&(buf_pool->mutex));
+		mutex_enter(&(buf_pool->mutex));
 
-	ut_ad(UT_LIST_GET_LEN(buf_pool->LRU) == 0);
+		ut_ad(UT_LIST_GET_LEN(buf_pool->LRU) == 0);
 
-	mutex_exit(&(buf_pool->mutex));
+		mutex_exit(&(buf_pool->mutex));
+	}
 }
 
 /*************************************************************************
-Validates the buffer buf_pool data structure. */
-
+Validates a buffer pool instance. */
+static
 ibool
-buf_validate(void)
-/*==============*/
+buf_validate_low(
+/*=============*/
+	buf_pool_t*	buf_pool)	/* in: buffer pool instance */
 {
 	buf_block_t*	block;
 	ulint		i;
@@ -1723,9 +1858,13 @@ buf_validate(void)
 
 		block = buf_pool_get_nth_block(buf_pool, i);
 
+		ut_a(block->buf_pool == buf_pool);
+
 		if (block->state == BUF_BLOCK_FILE_PAGE) {
 
-			ut_a(buf_page_hash_get(block->space,
+			ut_a(buf_pool_get(block->space, block->offset)
+								== buf_pool);
+			ut_a(buf_page_hash_get(buf_pool, block->space,
 						block->offset) == block);
 			n_page++;
 
@@ -1787,6 +1926,23 @@ buf_validate(void)
 	
 	mutex_exit(&(buf_pool->mutex));
 
+	return(TRUE);
+}	
+
+/*************************************************************************
+Validates the buffer buf_pool data structure. */
+
+ibool
+buf_validate(void)
+/*==============*/
+{
+	ulint	i;
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+
+		ut_a(buf_validate_low(buf_pools[i]));
+	}
+
 	ut_a(buf_LRU_validate());
 	ut_a(buf_flush_validate());
 
@@ -1800,41 +1956,24 @@ void
 buf_print(void)
 /*===========*/
 {
+	buf_pool_t*	buf_pool;
 	dulint*		index_ids;
 	ulint*		counts;
 	ulint		size;
 	ulint		i;
 	ulint		j;
+	ulint		k;
 	dulint		id;
 	ulint		n_found;
 	buf_frame_t* 	frame;
 	dict_index_t*	index;
 	
-	ut_ad(buf_pool);
-
 	size = buf_pool_get_curr_size() / UNIV_PAGE_SIZE;
 
 	index_ids = mem_alloc(sizeof(dulint) * size);
 	counts = mem_alloc(sizeof(ulint) * size);
 
-	mutex_enter(&(buf_pool->mutex));
-	
 	printf("buf_pool size %lu \n", size);
-	printf("database pages %lu \n", UT_LIST_GET_LEN(buf_pool->LRU));
-	printf("free pages %lu \n", UT_LIST_GET_LEN(buf_pool->free));
-	printf("modified database pages %lu \n",
-				UT_LIST_GET_LEN(buf_pool->flush_list));
-
-	printf("n pending reads %lu \n", buf_pool->n_pend_reads);
-
-	printf("n pending flush LRU %lu list %lu single page %lu\n",
-		buf_pool->n_flush[BUF_FLUSH_LRU],
-		buf_pool->n_flush[BUF_FLUSH_LIST],
-		buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE]);
-
-	printf("pages read %lu, created %lu, written %lu\n",
-			buf_pool->n_pages_read, buf_pool->n_pages_created,
-						buf_pool->n_pages_written);
 
 	/* Count the number of blocks belonging to each index in the buffer */
 	
@@ -1844,35 +1983,61 @@ buf_print(void)
 		counts[i] = 0;
 	}
 
-	for (i = 0; i < size; i++) {
-		frame = buf_pool_get_nth_block(buf_pool, i)->frame;
+	for (k = 0; k < buf_pool_n_instances; k++) {
+		buf_pool = buf_pools[k];
+
+		mutex_enter(&(buf_pool->mutex));
+
+		printf("instance %lu size %lu \n", buf_pool->id,
+							buf_pool->curr_size);
+		printf("database pages %lu \n",
+					UT_LIST_GET_LEN(buf_pool->LRU));
+		printf("free pages %lu \n", UT_LIST_GET_LEN(buf_pool->free));
+		printf("modified database pages %lu \n",
+				UT_LIST_GET_LEN(buf_pool->flush_list));
+
+		printf("n pending reads %lu \n", buf_pool->n_pend_reads);
 
-		if (fil_page_get_type(frame) == FIL_PAGE_INDEX) {
+		printf("n pending flush LRU %lu list %lu single page %lu\n",
+			buf_pool->n_flush[BUF_FLUSH_LRU],
+			buf_pool->n_flush[BUF_FLUSH_LIST],
+			buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE]);
 
-			id = btr_page_get_index_id(frame);
+		printf("pages read %lu, created %lu, written %lu\n",
+			buf_pool->n_pages_read, buf_pool->n_pages_created,
+						buf_pool->n_pages_written);
 
-			/* Look for the id in the index_ids array */
-			j = 0;
+		for (i = 0; i < buf_pool->curr_size; i++) {
+			frame = buf_pool_get_nth_block(buf_pool, i)->frame;
 
-			while (j < n_found) {
+			if (fil_page_get_type(frame) == FIL_PAGE_INDEX) {
 
-				if (ut_dulint_cmp(index_ids[j], id) == 0) {
-					(counts[j])++;
+				id = btr_page_get_index_id(frame);
 
-					break;
+				/* Look for the id in the index_ids array */
+				j = 0;
+
+				while (j < n_found) {
+
+					if (ut_dulint_cmp(index_ids[j], id)
+								== 0) {
+						(counts[j])++;
+
+						break;
+					}
+					j++;
 				}
-				j++;
-			}
 
-			if (j == n_found) {
-				n_found++;
-				index_ids[j] = id;
-				counts[j] = 1;
+				if (j == n_found) {
+					n_found++;
+					index_ids[j] = id;
+					counts[j] = 1;
+				}
 			}
 		}
-	}
 
-	mutex_exit(&(buf_pool->mutex));
+		mutex_exit(&(buf_pool->mutex));
+	}
 
 	for (i = 0; i < n_found; i++) {
 		index = dict_index_get_if_in_cache(index_ids[i]);
@@ -1901,10 +2066,61 @@ ulint
 buf_get_n_pending_ios(void)
 /*=======================*/
 {
-	return(buf_pool->n_pend_reads
-		+ buf_pool->n_flush[BUF_FLUSH_LRU]
-		+ buf_pool->n_flush[BUF_FLUSH_LIST]
-		+ buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE]);
+	buf_pool_t*	buf_pool;
+	ulint		n	= 0;
+	ulint		i;
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_pool = buf_pools[i];
+
+		n += buf_pool->n_pend_reads
+			+ buf_pool->n_flush[BUF_FLUSH_LRU]
+			+ buf_pool->n_flush[BUF_FLUSH_LIST]
+			+ buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE];
+	}
+
+	return(n);
+}
+
+/*************************************************************************
+Returns the number of page reads and writes done by all the buffer pool
+instances. The value is only approximate: the counters are read without
+the instance mutexes. */
+
+ulint
+buf_get_n_page_ios(void)
+/*====================*/
+{
+	ulint	n	= 0;
+	ulint	i;
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+
+		n += buf_pools[i]->n_pages_read
+			+ buf_pools[i]->n_pages_written;
+	}
+
+	return(n);
+}
+
+/*************************************************************************
+Returns the number of pages read to all the buffer pool instances. The
+value is only approximate: the counters are read without the instance
+mutexes. */
+
+ulint
+buf_get_n_pages_read(void)
+/*======================*/
+{
+	ulint	n	= 0;
+	ulint	i;
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+
+		n += buf_pools[i]->n_pages_read;
+	}
+
+	return(n);
 }
 
 /*************************************************************************
@@ -1915,23 +2131,31 @@ ulint
 buf_get_modified_ratio_pct(void)
 /*============================*/
 {
-	ulint	ratio;
+	buf_pool_t*	buf_pool;
+	ulint		n_modified	= 0;
+	ulint		n_pages		= 0;
+	ulint		i;
 
-	mutex_enter(&(buf_pool->mutex));
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_pool = buf_pools[i];
 
-	ratio = (100 * UT_LIST_GET_LEN(buf_pool->flush_list))
-		     / (1 + UT_LIST_GET_LEN(buf_pool->LRU)
-		        + UT_LIST_GET_LEN(buf_pool->free));
+		mutex_enter(&(buf_pool->mutex));
 
-		       /* 1 + is there to avoid division by zero */   
+		n_modified += UT_LIST_GET_LEN(buf_pool->flush_list);
+		n_pages += UT_LIST_GET_LEN(buf_pool->LRU)
+				+ UT_LIST_GET_LEN(buf_pool->free);
 
-	mutex_exit(&(buf_pool->mutex));
+		mutex_exit(&(buf_pool->mutex));
+	}
 
-	return(ratio);
+	/* 1 + is there to avoid division by zero */   
+
+	return((100 * n_modified) / (1 + n_pages));
 }
 
 /*************************************************************************
-Prints info of the buffer i/o. */
+Prints info of the buffer i/o. If there are several buffer pool instances,
+the totals are followed by a line per instance. */
 
 void
 buf_print_io(
@@ -1939,80 +2163,135 @@ buf_print_io(
 	char*	buf,	/* in/out: buffer where to print */
 	char*	buf_end)/* in: buffer end */
 {
-	time_t	current_time;
-	double	time_elapsed;
-	ulint	size;
+	buf_pool_t*	buf_pool;
+	time_t		current_time;
+	double		time_elapsed;
+	ulint		size;
+	ulint		n_free		= 0;
+	ulint		n_lru		= 0;
+	ulint		n_modified	= 0;
+	ulint		n_pend_reads	= 0;
+	ulint		n_flush_lru	= 0;
+	ulint		n_flush_list	= 0;
+	ulint		n_flush_single	= 0;
+	ulint		n_read		= 0;
+	ulint		n_created	= 0;
+	ulint		n_written	= 0;
+	ulint		n_gets		= 0;
+	ulint		n_read_old	= 0;
+	ulint		n_created_old	= 0;
+	ulint		n_written_old	= 0;
+	ulint		n_gets_old	= 0;
+	ulint		i;
 	
-	ut_ad(buf_pool);
-
-	if (buf_end - buf < 400) {
+	if (buf_end - buf < 400 + 100 * (buf_pool_n_instances - 1)) {
 
 		return;
 	}
 
 	size = buf_pool_get_curr_size() / UNIV_PAGE_SIZE;
 
-	mutex_enter(&(buf_pool->mutex));
-	
+	current_time = time(NULL);
+	time_elapsed = 0.001 + difftime(current_time,
+					buf_pools[0]->last_printout_time);
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_pool = buf_pools[i];
+
+		mutex_enter(&(buf_pool->mutex));
+
+		n_free += UT_LIST_GET_LEN(buf_pool->free);
+		n_lru += UT_LIST_GET_LEN(buf_pool->LRU);
+		n_modified += UT_LIST_GET_LEN(buf_pool->flush_list);
+		n_pend_reads += buf_pool->n_pend_reads;
+		n_flush_lru += buf_pool->n_flush[BUF_FLUSH_LRU]
+				+ buf_pool->init_flush[BUF_FLUSH_LRU];
+		n_flush_list += buf_pool->n_flush[BUF_FLUSH_LIST]
+				+ buf_pool->init_flush[BUF_FLUSH_LIST];
+		n_flush_single += buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE];
+		n_read += buf_pool->n_pages_read;
+		n_created += buf_pool->n_pages_created;
+		n_written += buf_pool->n_pages_written;
+		n_gets += buf_pool->n_page_gets;
+		n_read_old += buf_pool->n_pages_read_old;
+		n_created_old += buf_pool->n_pages_created_old;
+		n_written_old += buf_pool->n_pages_written_old;
+		n_gets_old += buf_pool->n_page_gets_old;
+
+		mutex_exit(&(buf_pool->mutex));
+	}
+
 	buf += sprintf(buf,
 		"Buffer pool size   %lu\n", size);
 	buf += sprintf(buf,
-		"Free buffers       %lu\n", UT_LIST_GET_LEN(buf_pool->free));
+		"Free buffers       %lu\n", n_free);
 	buf += sprintf(buf,
-		"Database pages     %lu\n", UT_LIST_GET_LEN(buf_pool->LRU));
-/*
+		"Database pages     %lu\n", n_lru);
 	buf += sprintf(buf,
-		"Lock heap buffers  %lu\n", buf_pool->n_lock_heap_pages);
-	buf += sprintf(buf,
-		"Hash index buffers %lu\n", buf_pool->n_adaptive_hash_pages);
-*/
-	buf += sprintf(buf,
-		"Modified db pages  %lu\n",
-				UT_LIST_GET_LEN(buf_pool->flush_list));
+		"Modified db pages  %lu\n", n_modified);
 
-	buf += sprintf(buf, "Pending reads %lu \n", buf_pool->n_pend_reads);
+	buf += sprintf(buf, "Pending reads %lu \n", n_pend_reads);
 
 	buf += sprintf(buf,
 		"Pending writes: LRU %lu, flush list %lu, single page %lu\n",
-		buf_pool->n_flush[BUF_FLUSH_LRU]
-				+ buf_pool->init_flush[BUF_FLUSH_LRU],
-		buf_pool->n_flush[BUF_FLUSH_LIST]
-				+ buf_pool->init_flush[BUF_FLUSH_LIST],
-		buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE]);
-
-	current_time = time(NULL);
-	time_elapsed = 0.001 + difftime(current_time,
-						buf_pool->last_printout_time);
-	buf_pool->last_printout_time = current_time;
+		n_flush_lru, n_flush_list, n_flush_single);
 
 	buf += sprintf(buf, "Pages read %lu, created %lu, written %lu\n",
-			buf_pool->n_pages_read, buf_pool->n_pages_created,
-						buf_pool->n_pages_written);
+			n_read, n_created, n_written);
 	buf += sprintf(buf, "%.2f reads/s, %.2f creates/s, %.2f writes/s\n",
-		(buf_pool->n_pages_read - buf_pool->n_pages_read_old)
-		/ time_elapsed,
-		(buf_pool->n_pages_created - buf_pool->n_pages_created_old)
-		/ time_elapsed,
-		(buf_pool->n_pages_written - buf_pool->n_pages_written_old)
-		/ time_elapsed);
-
-	if (buf_pool->n_page_gets > buf_pool->n_page_gets_old) {
+		(n_read - n_read_old) / time_elapsed,
+		(n_created - n_created_old) / time_elapsed,
+		(n_written - n_written_old) / time_elapsed);
+
+	if (n_gets > n_gets_old) {
 		buf += sprintf(buf, "Buffer pool hit rate %lu / 1000\n",
 		1000
-		- ((1000 *
-		    (buf_pool->n_pages_read - buf_pool->n_pages_read_old))
-		/ (buf_pool->n_page_gets - buf_pool->n_page_gets_old)));
+		- ((1000 * (n_read - n_read_old)) / (n_gets - n_gets_old)));
 	} else {
 		buf += sprintf(buf,
 			"No buffer pool page gets since the last printout\n");
 	}
 
-	buf_pool->n_page_gets_old = buf_pool->n_page_gets;
-	buf_pool->n_pages_read_old = buf_pool->n_pages_read;
-	buf_pool->n_pages_created_old = buf_pool->n_pages_created;
-	buf_pool->n_pages_written_old = buf_pool->n_pages_written;
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_pool = buf_pools[i];
 
-	mutex_exit(&(buf_pool->mutex));
+		mutex_enter(&(buf_pool->mutex));
+
+		if (buf_pool_n_instances > 1) {
+			buf += sprintf(buf,
+"Instance %lu: size %lu, free %lu, db pages %lu, modified %lu, pending reads %lu\n"
+"  read %.2f/s, created %.2f/s, written %.2f/s, hit rate %lu / 1000\n",
+			buf_pool->id, buf_pool->curr_size,
+			UT_LIST_GET_LEN(buf_pool->free),
+			UT_LIST_GET_LEN(buf_pool->LRU),
+			UT_LIST_GET_LEN(buf_pool->flush_list),
+			buf_pool->n_pend_reads,
+			(buf_pool->n_pages_read - buf_pool->n_pages_read_old)
+			/ time_elapsed,
+			(buf_pool->n_pages_created
+				- buf_pool->n_pages_created_old)
+			/ time_elapsed,
+			(buf_pool->n_pages_written
+				- buf_pool->n_pages_written_old)
+			/ time_elapsed,
+			buf_pool->n_page_gets > buf_pool->n_page_gets_old
+			? 1000 - ((1000 * (buf_pool->n_pages_read
+					- buf_pool->n_pages_read_old))
+				/ (buf_pool->n_page_gets
+					- buf_pool->n_page_gets_old))
+			: 1000);
+		}
+
+		buf_pool->last_printout_time = current_time;
+		buf_pool->n_page_gets_old = buf_pool->n_page_gets;
+		buf_pool->n_pages_read_old = buf_pool->n_pages_read;
+		buf_pool->n_pages_created_old = buf_pool->n_pages_created;
+		buf_pool->n_pages_written_old = buf_pool->n_pages_written;
+
+		mutex_exit(&(buf_pool->mutex));
+	}
+
+	buf_zip_print(buf, buf_end);
 }
 
 /**************************************************************************
@@ -2022,11 +2301,18 @@ void
 buf_refresh_io_stats(void)
 /*======================*/
 {
-        buf_pool->last_printout_time = time(NULL);
-	buf_pool->n_page_gets_old = buf_pool->n_page_gets;
-	buf_pool->n_pages_read_old = buf_pool->n_pages_read;
-	buf_pool->n_pages_created_old = buf_pool->n_pages_created;
-	buf_pool->n_pages_written_old = buf_pool->n_pages_written;
+	buf_pool_t*	buf_pool;
+	ulint		i;
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_pool = buf_pools[i];
+
+		buf_pool->last_printout_time = time(NULL);
+		buf_pool->n_page_gets_old = buf_pool->n_page_gets;
+		buf_pool->n_pages_read_old = buf_pool->n_pages_read;
+		buf_pool->n_pages_created_old = buf_pool->n_pages_created;
+		buf_pool->n_pages_written_old = buf_pool->n_pages_written;
+	}
 }
 
 /*************************************************************************
@@ -2036,29 +2322,34 @@ ibool
 buf_all_freed(void)
 /*===============*/
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	ulint		i;
+	ulint		j;
 	
-	ut_ad(buf_pool);
+	for (j = 0; j < buf_pool_n_instances; j++) {
+		buf_pool = buf_pools[j];
 
-	mutex_enter(&(buf_pool->mutex));
+		mutex_enter(&(buf_pool->mutex));
 
-	for (i = 0; i < buf_pool->curr_size; i++) {
+		for (i = 0; i < buf_pool->curr_size; i++) {
 
-		block = buf_pool_get_nth_block(buf_pool, i);
+			block = buf_pool_get_nth_block(buf_pool, i);
 
-		if (block->state == BUF_BLOCK_FILE_PAGE) {
+			if (block->state == BUF_BLOCK_FILE_PAGE) {
 
-			if (!buf_flush_ready_for_replace(block)) {
+				if (!buf_flush_ready_for_replace(block)) {
 
-			    	/* printf("Page %lu %lu still fixed or dirty\n",
+			    		/* printf(
+					"Page %lu %lu still fixed or dirty\n",
 			    		block->space, block->offset); */
-			    	ut_error;
+			    		ut_error;
+				}
 			}
-		}
- 	}
+ 		}
 
-	mutex_exit(&(buf_pool->mutex));
+		mutex_exit(&(buf_pool->mutex));
+	}
 
 	return(TRUE);
 }	
@@ -2072,19 +2363,23 @@ buf_pool_check_no_pending_io(void)
 /*==============================*/
 				/* out: TRUE if there is no pending i/o */
 {
-	ibool	ret;
+	buf_pool_t*	buf_pool;
+	ibool		ret	= TRUE;
+	ulint		i;
 
-	mutex_enter(&(buf_pool->mutex));
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_pool = buf_pools[i];
 
-	if (buf_pool->n_pend_reads + buf_pool->n_flush[BUF_FLUSH_LRU]
+		mutex_enter(&(buf_pool->mutex));
+
+		if (buf_pool->n_pend_reads + buf_pool->n_flush[BUF_FLUSH_LRU]
 				+ buf_pool->n_flush[BUF_FLUSH_LIST]
 				+ buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE]) {
-		ret = FALSE;
-	} else {
-		ret = TRUE;
-	}
+			ret = FALSE;
+		}
 
-	mutex_exit(&(buf_pool->mutex));
+		mutex_exit(&(buf_pool->mutex));
+	}
 
 	return(ret);
 }
@@ -2096,13 +2391,19 @@ ulint
 buf_get_free_list_len(void)
 /*=======================*/
 {
-	ulint	len;
+	buf_pool_t*	buf_pool;
+	ulint		len	= 0;
+	ulint		i;
 
-	mutex_enter(&(buf_pool->mutex));
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_pool = buf_pools[i];
 
-	len = UT_LIST_GET_LEN(buf_pool->free);
+		mutex_enter(&(buf_pool->mutex));
 
-	mutex_exit(&(buf_pool->mutex));
+		len += UT_LIST_GET_LEN(buf_pool->free);
+
+		mutex_exit(&(buf_pool->mutex));
+	}
 
 	return(len);
 }
@@ -32,12 +32,13 @@ flushed along with the original page. */
 					       buf_pool->curr_size / 16)
 
 /**********************************************************************
-Validates the flush list. */
+Validates the flush list of a buffer pool instance. */
 static
 ibool
-buf_flush_validate_low(void);
-/*========================*/
-		/* out: TRUE if ok */
+buf_flush_validate_low(
+/*===================*/
+				/* out: TRUE if ok */
+	buf_pool_t*	buf_pool);/* in: buffer pool instance */
 
 /************************************************************************
 Inserts a modified block into the flush list. */
@@ -47,6 +48,8 @@ buf_flush_insert_into_flush_list(
 /*=============================*/
 	buf_block_t*	block)	/* in: block which is modified */
 {
+	buf_pool_t*	buf_pool	= block->buf_pool;
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 
 	ut_ad((UT_LIST_GET_FIRST(buf_pool->flush_list) == NULL)
@@ -57,7 +60,7 @@ buf_flush_insert_into_flush_list(
 
 	UT_LIST_ADD_FIRST(flush_list, buf_pool->flush_list, block);
 
-	ut_ad(buf_flush_validate_low());
+	ut_ad(buf_flush_validate_low(buf_pool));
 }
 
 /************************************************************************
@@ -70,6 +73,7 @@ buf_flush_insert_sorted_into_flush_list(
 /*====================================*/
 	buf_block_t*	block)	/* in: block which is modified */
 {
+	buf_pool_t*	buf_pool	= block->buf_pool;
 	buf_block_t*	prev_b;
 	buf_block_t*	b;
 	
@@ -91,7 +95,7 @@ buf_flush_insert_sorted_into_flush_list(
 								block);
 	}
 
-	ut_ad(buf_flush_validate_low());
+	ut_ad(buf_flush_validate_low(buf_pool));
 }
 
 /************************************************************************
@@ -105,7 +109,7 @@ buf_flush_ready_for_replace(
 	buf_block_t*	block)	/* in: buffer control block, must be in state
 				BUF_BLOCK_FILE_PAGE and in the LRU list*/
 {
-	ut_ad(mutex_own(&(buf_pool->mutex)));
+	ut_ad(mutex_own(&(block->buf_pool->mutex)));
 	ut_a(block->state == BUF_BLOCK_FILE_PAGE);
 
 	if ((ut_dulint_cmp(block->oldest_modification, ut_dulint_zero) > 0)
@@ -129,7 +133,7 @@ buf_flush_ready_for_flush(
 				BUF_BLOCK_FILE_PAGE */
 	ulint		flush_type)/* in: BUF_FLUSH_LRU or BUF_FLUSH_LIST */
 {
-	ut_ad(mutex_own(&(buf_pool->mutex)));
+	ut_ad(mutex_own(&(block->buf_pool->mutex)));
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
 
 	if ((ut_dulint_cmp(block->oldest_modification, ut_dulint_zero) > 0)
@@ -160,6 +164,8 @@ buf_flush_write_complete(
 /*=====================*/
 	buf_block_t*	block)	/* in: pointer to the block in question */
 {
+	buf_pool_t*	buf_pool	= block->buf_pool;
+
 	ut_ad(block);
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 
@@ -434,15 +440,18 @@ buf_flush_try_page(
 	ulint	flush_type)	/* in: BUF_FLUSH_LRU, BUF_FLUSH_LIST, or
 				BUF_FLUSH_SINGLE_PAGE */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	ibool		locked;
 	
 	ut_ad(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST
 				|| flush_type == BUF_FLUSH_SINGLE_PAGE);
 
+	buf_pool = buf_pool_get(space, offset);
+
 	mutex_enter(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 
 	ut_a(block->state == BUF_BLOCK_FILE_PAGE);
 
@@ -555,15 +564,18 @@ buf_flush_try_page(
 }
 
 /***************************************************************
-Flushes to disk all flushable pages within the flush area. */
+Flushes to disk all flushable pages within the flush area. The flush area
+is inside BUF_POOL_INSTANCE_AREA, so all the pages are buffered in the same
+buffer pool instance. */
 static
 ulint
 buf_flush_try_neighbors(
 /*====================*/
 				/* out: number of pages flushed */
-	ulint	space,		/* in: space id */
-	ulint	offset,		/* in: page offset */
-	ulint	flush_type)	/* in: BUF_FLUSH_LRU or BUF_FLUSH_LIST */
+	buf_pool_t*	buf_pool,/* in: buffer pool instance of the page */
+	ulint		space,	/* in: space id */
+	ulint		offset,	/* in: page offset */
+	ulint		flush_type)/* in: BUF_FLUSH_LRU or BUF_FLUSH_LIST */
 {
 	buf_block_t*	block;
 	ulint		low, high;
@@ -593,7 +605,7 @@ buf_flush_try_neighbors(
 
 	for (i = low; i < high; i++) {
 
-		block = buf_page_hash_get(space, i);
+		block = buf_page_hash_get(buf_pool, space, i);
 
 		if (block && flush_type == BUF_FLUSH_LRU && i != offset
 		    && !block->old) {
@@ -632,25 +644,27 @@ buf_flush_try_neighbors(
 }
 
 /***********************************************************************
-This utility flushes dirty blocks from the end of the LRU list or flush_list.
+This utility flushes dirty blocks from the end of the LRU list or flush_list
+of a buffer pool instance.
 NOTE 1: in the case of an LRU flush the calling thread may own latches to
 pages: to avoid deadlocks, this function must be written so that it cannot
 end up waiting for these latches! NOTE 2: in the case of a flush list flush,
 the calling thread is not allowed to own any latches on pages! */
-
+static
 ulint
-buf_flush_batch(
-/*============*/
+buf_flush_batch_low(
+/*================*/
 				/* out: number of blocks for which the write
 				request was queued; ULINT_UNDEFINED if there
 				was a flush of the same type already running */
-	ulint	flush_type,	/* in: BUF_FLUSH_LRU or BUF_FLUSH_LIST; if
+	buf_pool_t*	buf_pool,/* in: buffer pool instance */
+	ulint		flush_type,/* in: BUF_FLUSH_LRU or BUF_FLUSH_LIST; if
 				BUF_FLUSH_LIST, then the caller must not own
 				any latches on pages */
-	ulint	min_n,		/* in: wished minimum mumber of blocks flushed
+	ulint		min_n,	/* in: wished minimum mumber of blocks flushed
 				(it is not guaranteed that the actual number
 				is that big, though) */
-	dulint	lsn_limit)	/* in the case BUF_FLUSH_LIST all blocks whose
+	dulint		lsn_limit)/* in the case BUF_FLUSH_LIST all blocks whose
 				oldest_modification is smaller than this
 				should be flushed (if their number does not
 				exceed min_n), otherwise ignored */
@@ -728,8 +742,9 @@ buf_flush_batch(
 				
 				/* Try to flush also all the neighbors */
 				page_count +=
-					buf_flush_try_neighbors(space, offset,
-								flush_type);
+					buf_flush_try_neighbors(buf_pool,
+							space, offset,
+							flush_type);
 				/* printf(
 				"Flush type %lu, page no %lu, neighb %lu\n",
 				flush_type, offset,
@@ -784,17 +799,81 @@ buf_flush_batch(
 	return(page_count);
 }
 
+/***********************************************************************
+This utility flushes dirty blocks from the end of the LRU lists or
+flush_lists of all the buffer pool instances. The min_n blocks are divided
+evenly among the instances. NOTE 1: in the case of an LRU flush the calling
+thread may own latches to pages: to avoid deadlocks, this function must be
+written so that it cannot end up waiting for these latches! NOTE 2: in the
+case of a flush list flush, the calling thread is not allowed to own any
+latches on pages! */
+
+ulint
+buf_flush_batch(
+/*============*/
+				/* out: number of blocks for which the write
+				request was queued; ULINT_UNDEFINED if there
+				was a flush of the same type already running
+				in some instance */
+	ulint	flush_type,	/* in: BUF_FLUSH_LRU or BUF_FLUSH_LIST; if
+				BUF_FLUSH_LIST, then the caller must not own
+				any latches on pages */
+	ulint	min_n,		/* in: wished minimum mumber of blocks flushed
+				(it is not guaranteed that the actual number
+				is that big, though) */
+	dulint	lsn_limit)	/* in the case BUF_FLUSH_LIST all blocks whose
+				oldest_modification is smaller than this
+				should be flushed (if their number does not
+				exceed min_n), otherwise ignored */
+{
+	ulint	page_count	= 0;
+	ulint	n_flushed;
+	ibool	running		= FALSE;
+	ulint	i;
+
+	if (min_n != ULINT_MAX) {
+		min_n = (min_n + buf_pool_n_instances - 1)
+						/ buf_pool_n_instances;
+	}
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		n_flushed = buf_flush_batch_low(buf_pools[i], flush_type,
+							min_n, lsn_limit);
+		if (n_flushed == ULINT_UNDEFINED) {
+			/* The caller has to wait for the running batch
+			and retry if it wanted all the instances flushed
+			up to lsn_limit */
+
+			running = TRUE;
+		} else {
+			page_count += n_flushed;
+		}
+	}
+
+	if (running) {
+
+		return(ULINT_UNDEFINED);
+	}
+
+	return(page_count);
+}
+
 /**********************************************************************
-Waits until a flush batch of the given type ends */
+Waits until the flush batches of the given type end in all the buffer pool
+instances */
 
 void
 buf_flush_wait_batch_end(
 /*=====================*/
 	ulint	type)	/* in: BUF_FLUSH_LRU or BUF_FLUSH_LIST */
 {
+	ulint	i;
+
 	ut_ad((type == BUF_FLUSH_LRU) || (type == BUF_FLUSH_LIST));
-	
-	os_event_wait(buf_pool->no_flush[type]);
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		os_event_wait(buf_pools[i]->no_flush[type]);
+	}
 }	
 
 /**********************************************************************
@@ -803,10 +882,11 @@ a big enough margin of replaceable blocks near the end of the LRU list
 and in the free list. */
 static
 ulint
-buf_flush_LRU_recommendation(void)
-/*==============================*/
-			/* out: number of blocks which should be flushed
-			from the end of the LRU list */
+buf_flush_LRU_recommendation(
+/*=========================*/
+				/* out: number of blocks which should be
+				flushed from the end of the LRU list */
+	buf_pool_t*	buf_pool)/* in: buffer pool instance */
 {
 	buf_block_t*	block;
 	ulint		n_replaceable;
@@ -844,40 +924,58 @@ buf_flush_LRU_recommendation(void)
 }
 
 /*************************************************************************
-Flushes pages from the end of the LRU list if there is too small a margin
-of replaceable pages there or in the free list. VERY IMPORTANT: this function
-is called also by threads which have locks on pages. To avoid deadlocks, we
-flush only pages such that the s-lock required for flushing can be acquired
-immediately, without waiting. */ 
+Flushes pages from the end of the LRU list of a buffer pool instance if
+there is too small a margin of replaceable pages there or in the free list.
+VERY IMPORTANT: this function is called also by threads which have locks on
+pages. To avoid deadlocks, we flush only pages such that the s-lock required
+for flushing can be acquired immediately, without waiting. */ 
 
 void
-buf_flush_free_margin(void)
-/*=======================*/
+buf_flush_free_margin(
+/*==================*/
+	buf_pool_t*	buf_pool)	/* in: buffer pool instance */
 {
 	ulint	n_to_flush;
 	ulint	n_flushed;
 
-	n_to_flush = buf_flush_LRU_recommendation();
+	n_to_flush = buf_flush_LRU_recommendation(buf_pool);
 	
 	if (n_to_flush > 0) {
-		n_flushed = buf_flush_batch(BUF_FLUSH_LRU, n_to_flush,
-							ut_dulint_zero);
+		n_flushed = buf_flush_batch_low(buf_pool, BUF_FLUSH_LRU,
+						n_to_flush, ut_dulint_zero);
 		if (n_flushed == ULINT_UNDEFINED) {
 			/* There was an LRU type flush batch already running;
 			let us wait for it to end */
 		   
-		        buf_flush_wait_batch_end(BUF_FLUSH_LRU);
+		        os_event_wait(buf_pool->no_flush[BUF_FLUSH_LRU]);
 		}
 	}
 }
 
+/*************************************************************************
+Flushes pages from the end of the LRU lists of all the buffer pool instances
+if there is too small a margin of replaceable pages there or in the free
+lists. */
+
+void
+buf_flush_free_margins(void)
+/*========================*/
+{
+	ulint	i;
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_flush_free_margin(buf_pools[i]);
+	}
+}
+
 /**********************************************************************
-Validates the flush list. */
+Validates the flush list of a buffer pool instance. */
 static
 ibool
-buf_flush_validate_low(void)
-/*========================*/
-		/* out: TRUE if ok */
+buf_flush_validate_low(
+/*===================*/
+				/* out: TRUE if ok */
+	buf_pool_t*	buf_pool)/* in: buffer pool instance */
 {
 	buf_block_t*	block;
 	dulint		om;
@@ -903,20 +1001,28 @@ buf_flush_validate_low(void)
 }
 
 /**********************************************************************
-Validates the flush list. */
+Validates the flush lists. */
 
 ibool
 buf_flush_validate(void)
 /*====================*/
 		/* out: TRUE if ok */
 {
-	ibool	ret;
-	
-	mutex_enter(&(buf_pool->mutex));
+	buf_pool_t*	buf_pool;
+	ibool		ret	= TRUE;
+	ulint		i;
 
-	ret = buf_flush_validate_low();
-	
-	mutex_exit(&(buf_pool->mutex));
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_pool = buf_pools[i];
+
+		mutex_enter(&(buf_pool->mutex));
+
+		if (!buf_flush_validate_low(buf_pool)) {
+			ret = FALSE;
+		}
+
+		mutex_exit(&(buf_pool->mutex));
+	}
 
 	return(ret);
 }
@@ -25,6 +25,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "buf0buf.h"
 #include "buf0flu.h"
 #include "buf0rea.h"
+#include "buf0zip.h"
 #include "btr0sea.h"
 #include "os0file.h"
 #include "log0recv.h"
@@ -67,9 +68,11 @@ Gets the minimum LRU_position field for the blocks in an initial segment
 guaranteed to be precise, because the ulint_clock may wrap around. */
 
 ulint
-buf_LRU_get_recent_limit(void)
-/*==========================*/
-			/* out: the limit; zero if could not determine it */
+buf_LRU_get_recent_limit(
+/*=====================*/
+				/* out: the limit; zero if could not
+				determine it */
+	buf_pool_t*	buf_pool)/* in: buffer pool instance */
 {
 	buf_block_t*	block;
 	ulint		len;
@@ -104,15 +107,17 @@ ibool
 buf_LRU_search_and_free_block(
 /*==========================*/
 				/* out: TRUE if freed */
-	ulint	n_iterations)   /* in: how many times this has been called
-				repeatedly without result: a high value means
-				that we should search farther; if value is
-				k < 10, then we only search k/10 * [number
+	buf_pool_t*	buf_pool,/* in: buffer pool instance */
+	ulint		n_iterations)/* in: how many times this has been
+				called repeatedly without result: a high value
+				means that we should search farther; if value
+				is k < 10, then we only search k/10 * [number
 				of pages in the buffer pool] from the end
 				of the LRU list */
 {
 	buf_block_t*	block;
 	ulint		distance = 0;
+	ulint		zip_reserv;
 	ibool		freed;
 
 	mutex_enter(&(buf_pool->mutex));
@@ -131,12 +136,21 @@ buf_LRU_search_and_free_block(
 					block->space, block->offset);
 			}
 			
+			zip_reserv = buf_zip_reserve(block->space,
+							block->offset);
+
 			buf_LRU_block_remove_hashed_page(block);
 
 			mutex_exit(&(buf_pool->mutex));
 
 			btr_search_drop_page_hash_index(block->frame);
 
+			/* Nobody can access the frame now, so we can
+			compress it without holding the buf_pool mutex */
+
+			buf_zip_store(block->space, block->offset,
+						zip_reserv, block->frame);
+
 			mutex_enter(&(buf_pool->mutex));
 
 			ut_a(block->buf_fix_count == 0);
@@ -184,10 +198,11 @@ taken out of the buffer pool, and their inserts redirected to the insert
 buffer. Otherwise, the flushed blocks could get modified again before read
 operations need new buffer blocks, and the i/o work done in flushing would be
 wasted. */
-
+static
 void
-buf_LRU_try_free_flushed_blocks(void)
-/*=================================*/
+buf_LRU_try_free_flushed_blocks_low(
+/*================================*/
+	buf_pool_t*	buf_pool)	/* in: buffer pool instance */
 {
 	mutex_enter(&(buf_pool->mutex));
 
@@ -195,7 +210,7 @@ buf_LRU_try_free_flushed_blocks(void)
 
 		mutex_exit(&(buf_pool->mutex));
 
-		buf_LRU_search_and_free_block(1);
+		buf_LRU_search_and_free_block(buf_pool, 1);
 		
 		mutex_enter(&(buf_pool->mutex));
 	}
@@ -204,14 +219,30 @@ buf_LRU_try_free_flushed_blocks(void)
 }	
 
 /**********************************************************************
-Returns a free block from buf_pool. The block is taken off the free list.
-If it is empty, blocks are moved from the end of the LRU list to the free
-list. */
+Tries to remove LRU flushed blocks from the end of the LRU lists of all the
+buffer pool instances and put them to the free lists. */
+
+void
+buf_LRU_try_free_flushed_blocks(void)
+/*=================================*/
+{
+	ulint	i;
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_LRU_try_free_flushed_blocks_low(buf_pools[i]);
+	}
+}	
+
+/**********************************************************************
+Returns a free block from a buf_pool instance. The block is taken off the
+free list. If it is empty, blocks are moved from the end of the LRU list to
+the free list. */
 
 buf_block_t*
-buf_LRU_get_free_block(void)
-/*========================*/
+buf_LRU_get_free_block(
+/*===================*/
 				/* out: the free control block */
+	buf_pool_t*	buf_pool)/* in: buffer pool instance */
 {
 	buf_block_t*	block		= NULL;
 	ibool		freed;
@@ -283,7 +314,7 @@ loop:
 
 	mutex_exit(&(buf_pool->mutex));
 
-	freed = buf_LRU_search_and_free_block(n_iterations);
+	freed = buf_LRU_search_and_free_block(buf_pool, n_iterations);
 
 	if (freed > 0) {
 		goto loop;
@@ -322,7 +353,7 @@ loop:
 
 	/* No free block was found: try to flush the LRU list */
 
-	buf_flush_free_margin();
+	buf_flush_free_margin(buf_pool);
 
 	os_aio_simulated_wake_handler_threads();
 
@@ -335,7 +366,7 @@ loop:
 
 		mutex_exit(&(buf_pool->mutex));
 
-		buf_LRU_try_free_flushed_blocks();
+		buf_LRU_try_free_flushed_blocks_low(buf_pool);
 	} else {
 		mutex_exit(&(buf_pool->mutex));
 	}
@@ -355,8 +386,9 @@ Moves the LRU_old pointer so that the length of the old blocks list
 is inside the allowed limits. */
 UNIV_INLINE
 void
-buf_LRU_old_adjust_len(void)
-/*========================*/
+buf_LRU_old_adjust_len(
+/*===================*/
+	buf_pool_t*	buf_pool)	/* in: buffer pool instance */
 {
 	ulint	old_len;
 	ulint	new_len;
@@ -398,8 +430,9 @@ This function should be called when the LRU list grows to
 BUF_LRU_OLD_MIN_LEN length. */
 static
 void
-buf_LRU_old_init(void)
-/*==================*/
+buf_LRU_old_init(
+/*=============*/
+	buf_pool_t*	buf_pool)	/* in: buffer pool instance */
 {
 	buf_block_t*	block;
 
@@ -419,7 +452,7 @@ buf_LRU_old_init(void)
 	buf_pool->LRU_old = UT_LIST_GET_FIRST(buf_pool->LRU);
 	buf_pool->LRU_old_len = UT_LIST_GET_LEN(buf_pool->LRU);
 	
-	buf_LRU_old_adjust_len();
+	buf_LRU_old_adjust_len(buf_pool);
 }	    	
 
 /**********************************************************************
@@ -430,7 +463,8 @@ buf_LRU_remove_block(
 /*=================*/
 	buf_block_t*	block)	/* in: control block */
 {
-	ut_ad(buf_pool);
+	buf_pool_t*	buf_pool	= block->buf_pool;
+
 	ut_ad(block);
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 		
@@ -470,7 +504,7 @@ buf_LRU_remove_block(
 	}
 
 	/* Adjust the length of the old block list if necessary */
-	buf_LRU_old_adjust_len();
+	buf_LRU_old_adjust_len(buf_pool);
 }	    	
 
 /**********************************************************************
@@ -481,9 +515,9 @@ buf_LRU_add_block_to_end_low(
 /*=========================*/
 	buf_block_t*	block)	/* in: control block */
 {
+	buf_pool_t*	buf_pool	= block->buf_pool;
 	buf_block_t*	last_block;
 	
-	ut_ad(buf_pool);
 	ut_ad(block);
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 
@@ -494,7 +528,7 @@ buf_LRU_add_block_to_end_low(
 	if (last_block) {
 		block->LRU_position = last_block->LRU_position;
 	} else {
-		block->LRU_position = buf_pool_clock_tic();
+		block->LRU_position = buf_pool_clock_tic(buf_pool);
 	}			
 
 	UT_LIST_ADD_LAST(LRU, buf_pool->LRU, block);
@@ -510,14 +544,14 @@ buf_LRU_add_block_to_end_low(
 
 		/* Adjust the length of the old block list if necessary */
 
-		buf_LRU_old_adjust_len();
+		buf_LRU_old_adjust_len(buf_pool);
 
 	} else if (UT_LIST_GET_LEN(buf_pool->LRU) == BUF_LRU_OLD_MIN_LEN) {
 
 		/* The LRU list is now long enough for LRU_old to become
 		defined: init it */
 
-		buf_LRU_old_init();
+		buf_LRU_old_init(buf_pool);
 	}
 }	    	
 
@@ -533,14 +567,14 @@ buf_LRU_add_block_low(
 				LRU list is very short, the block is added to
 				the start, regardless of this parameter */
 {
-	ulint	cl;
+	buf_pool_t*	buf_pool	= block->buf_pool;
+	ulint		cl;
 	
-	ut_ad(buf_pool);
 	ut_ad(block);
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 
 	block->old = old;
-	cl = buf_pool_clock_tic();
+	cl = buf_pool_clock_tic(buf_pool);
 
 	if (!old || (UT_LIST_GET_LEN(buf_pool->LRU) < BUF_LRU_OLD_MIN_LEN)) {
 
@@ -565,14 +599,14 @@ buf_LRU_add_block_low(
 
 		/* Adjust the length of the old block list if necessary */
 
-		buf_LRU_old_adjust_len();
+		buf_LRU_old_adjust_len(buf_pool);
 
 	} else if (UT_LIST_GET_LEN(buf_pool->LRU) == BUF_LRU_OLD_MIN_LEN) {
 
 		/* The LRU list is now long enough for LRU_old to become
 		defined: init it */
 
-		buf_LRU_old_init();
+		buf_LRU_old_init(buf_pool);
 	}	
 }	    	
 
@@ -624,6 +658,8 @@ buf_LRU_block_free_non_file_page(
 /*=============================*/
 	buf_block_t*	block)	/* in: block, must not contain a file page */
 {
+	buf_pool_t*	buf_pool	= block->buf_pool;
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 	ut_ad(block);
 	
@@ -650,6 +686,8 @@ buf_LRU_block_remove_hashed_page(
 				be in a state where it can be freed; there
 				may or may not be a hash index to the page */
 {
+	buf_pool_t*	buf_pool	= block->buf_pool;
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 	ut_ad(block);
 	
@@ -681,7 +719,7 @@ buf_LRU_block_free_hashed_page(
 	buf_block_t*	block)	/* in: block, must contain a file page and
 				be in a state where it can be freed */
 {
-	ut_ad(mutex_own(&(buf_pool->mutex)));
+	ut_ad(mutex_own(&(block->buf_pool->mutex)));
 	ut_ad(block->state == BUF_BLOCK_REMOVE_HASH);
 
 	block->state = BUF_BLOCK_MEMORY;
@@ -690,18 +728,18 @@ buf_LRU_block_free_hashed_page(
 }
 				
 /**************************************************************************
-Validates the LRU list. */
-
+Validates the LRU list of a buffer pool instance. */
+static
 ibool
-buf_LRU_validate(void)
-/*==================*/
+buf_LRU_validate_low(
+/*=================*/
+	buf_pool_t*	buf_pool)	/* in: buffer pool instance */
 {
 	buf_block_t*	block;
 	ulint		old_len;
 	ulint		new_len;
 	ulint		LRU_pos;
 	
-	ut_ad(buf_pool);
 	mutex_enter(&(buf_pool->mutex));
 
 	if (UT_LIST_GET_LEN(buf_pool->LRU) >= BUF_LRU_OLD_MIN_LEN) {
@@ -762,20 +800,37 @@ buf_LRU_validate(void)
 }
 
 /**************************************************************************
-Prints the LRU list. */
+Validates the LRU lists. */
+
+ibool
+buf_LRU_validate(void)
+/*==================*/
+{
+	ulint	i;
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		ut_a(buf_LRU_validate_low(buf_pools[i]));
+	}
 
+	return(TRUE);
+}
+
+/**************************************************************************
+Prints the LRU list of a buffer pool instance. */
+static
 void
-buf_LRU_print(void)
-/*===============*/
+buf_LRU_print_low(
+/*==============*/
+	buf_pool_t*	buf_pool)	/* in: buffer pool instance */
 {
 	buf_block_t*	block;
 	buf_frame_t*	frame;
 	ulint		len;
 	
-	ut_ad(buf_pool);
 	mutex_enter(&(buf_pool->mutex));
 
-	printf("Pool ulint clock %lu\n", buf_pool->ulint_clock);
+	printf("Pool %lu ulint clock %lu\n", buf_pool->id,
+						buf_pool->ulint_clock);
 
 	block = UT_LIST_GET_FIRST(buf_pool->LRU);
 
@@ -819,3 +874,17 @@ buf_LRU_print(void)
 
 	mutex_exit(&(buf_pool->mutex));
 }
+
+/**************************************************************************
+Prints the LRU lists. */
+
+void
+buf_LRU_print(void)
+/*===============*/
+{
+	ulint	i;
+
+	for (i = 0; i < buf_pool_n_instances; i++) {
+		buf_LRU_print_low(buf_pools[i]);
+	}
+}
@@ -14,6 +14,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "buf0buf.h"
 #include "buf0flu.h"
 #include "buf0lru.h"
+#include "buf0zip.h"
 #include "ibuf0ibuf.h"
 #include "log0recv.h"
 #include "trx0sys.h"
@@ -60,6 +61,7 @@ buf_read_page_low(
 	ulint	offset)	/* in: page number */
 {
 	buf_block_t*	block;
+	buf_zip_page_t*	zip;
 	ulint		wake_later;
 
 	wake_later = mode & OS_AIO_SIMULATED_WAKE_LATER;
@@ -97,7 +99,27 @@ buf_read_page_low(
 		sync = TRUE;
 	}
 
-	block = buf_page_init_for_read(mode, space, offset);
+	if (!sync && buf_zip_contains(space, offset)) {
+		/* Do not read ahead a page which is in the compressed
+		page cache: the read of the page will uncompress it */
+
+		return(0);
+	}
+
+	/* Only a synchronous read is completed in this thread: the
+	completion may do an insert buffer merge, and read-ahead may be
+	called when this thread has latches on pages */
+
+	block = buf_page_init_for_read(mode, space, offset,
+						sync ? &zip : NULL);
+
+	if (block != NULL && sync && zip != NULL
+	    && buf_zip_restore(zip, block->frame)) {
+
+		buf_page_io_complete(block);
+
+		return(1);
+	}
 
 	if (block != NULL) {
 		if (buf_debug_prints) {
@@ -142,6 +164,7 @@ buf_read_ahead_random(
 	ulint	offset)	/* in: page number of a page which the current thread
 			wants to access */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	ulint		recent_blocks	= 0;
 	ulint		count;
@@ -164,6 +187,11 @@ buf_read_ahead_random(
 		return(0);
 	}
 
+	/* The area is inside BUF_POOL_INSTANCE_AREA: all its pages are
+	buffered in the same instance */
+
+	buf_pool = buf_pool_get(space, offset);
+
 	low  = (offset / BUF_READ_AHEAD_RANDOM_AREA)
 					* BUF_READ_AHEAD_RANDOM_AREA;
 	high = (offset / BUF_READ_AHEAD_RANDOM_AREA + 1)
@@ -178,7 +206,7 @@ buf_read_ahead_random(
 	of the LRU list, to determine which blocks have recently been added
 	to the start of the list. */
 	
-	LRU_recent_limit = buf_LRU_get_recent_limit();
+	LRU_recent_limit = buf_LRU_get_recent_limit(buf_pool);
 
 	mutex_enter(&(buf_pool->mutex));
 
@@ -194,7 +222,7 @@ buf_read_ahead_random(
 
 	for (i = low; i < high; i++) {
 
-		block = buf_page_hash_get(space, i);
+		block = buf_page_hash_get(buf_pool, space, i);
 
 		if ((block)
 		    && (block->LRU_position > LRU_recent_limit)
@@ -275,7 +303,7 @@ buf_read_page(
 	count2 = buf_read_page_low(TRUE, BUF_READ_ANY_PAGE, space, offset);
 
 	/* Flush pages from the end of the LRU list if necessary */
-	buf_flush_free_margin();
+	buf_flush_free_margin(buf_pool_get(space, offset));
 
 	return(count + count2);
 }
@@ -312,6 +340,7 @@ buf_read_ahead_linear(
 	ulint	offset)	/* in: page number of a page; NOTE: the current thread
 			must want access to this page (see NOTE 3 above) */
 {
+	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	buf_frame_t*	frame;
 	buf_block_t*	pred_block	= NULL;
@@ -339,6 +368,8 @@ buf_read_ahead_linear(
 		return(0);
 	}
 
+	buf_pool = buf_pool_get(space, offset);
+
 	low  = (offset / BUF_READ_AHEAD_LINEAR_AREA)
 					* BUF_READ_AHEAD_LINEAR_AREA;
 	high = (offset / BUF_READ_AHEAD_LINEAR_AREA + 1)
@@ -379,7 +410,7 @@ buf_read_ahead_linear(
 
 	for (i = low; i < high; i++) {
 
-		block = buf_page_hash_get(space, i);
+		block = buf_page_hash_get(buf_pool, space, i);
 		
 		if ((block == NULL) || !block->accessed) {
 
@@ -409,7 +440,7 @@ buf_read_ahead_linear(
 	/* If we got this far, we know that enough pages in the area have
 	been accessed in the right order: linear read-ahead can be sensible */
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 
 	if (block == NULL) {
 		mutex_exit(&(buf_pool->mutex));
@@ -462,6 +493,10 @@ buf_read_ahead_linear(
 		return(0);
 	}
 
+	/* The pages to read can be in another buffer pool instance */
+
+	buf_pool = buf_pool_get(space, new_offset);
+
 	/* If we got this far, read-ahead can be sensible: do it */	    	
 
 	if (ibuf_inside()) {
@@ -496,7 +531,7 @@ buf_read_ahead_linear(
 	os_aio_simulated_wake_handler_threads();
 
 	/* Flush pages from the end of the LRU list if necessary */
-	buf_flush_free_margin();
+	buf_flush_free_margin(buf_pool);
 
 	if (buf_debug_prints && (count > 0)) {
 		printf(
@@ -523,18 +558,21 @@ buf_read_ibuf_merge_pages(
 				highest page number the last in the array */
 	ulint	n_stored)	/* in: number of page numbers in the array */
 {
-	ulint	i;
+	buf_pool_t*	buf_pool;
+	ulint		i;
 
 	ut_ad(!ibuf_inside());
 #ifdef UNIV_IBUF_DEBUG
 	ut_a(n_stored < UNIV_PAGE_SIZE);
 #endif	
-	while (buf_pool->n_pend_reads >
+	for (i = 0; i < n_stored; i++) {
+		buf_pool = buf_pool_get(space, page_nos[i]);
+
+		while (buf_pool->n_pend_reads >
 			buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT) {
-		os_thread_sleep(500000);
-	}	
+			os_thread_sleep(500000);
+		}	
 
-	for (i = 0; i < n_stored; i++) {
 		if ((i + 1 == n_stored) && sync) {
 			buf_read_page_low(TRUE, BUF_READ_ANY_PAGE, space,
 								page_nos[i]);
@@ -544,8 +582,8 @@ buf_read_ibuf_merge_pages(
 		}
 	}
 	
-	/* Flush pages from the end of the LRU list if necessary */
-	buf_flush_free_margin();
+	/* Flush pages from the end of the LRU lists if necessary */
+	buf_flush_free_margins();
 
 	if (buf_debug_prints) {
 		printf("Ibuf merge read-ahead space %lu pages %lu\n",
@@ -567,8 +605,9 @@ buf_read_recv_pages(
 				highest page number the last in the array */
 	ulint	n_stored)	/* in: number of page numbers in the array */
 {
-	ulint	count;
-	ulint	i;
+	buf_pool_t*	buf_pool;
+	ulint		count;
+	ulint		i;
 
 	for (i = 0; i < n_stored; i++) {
 
@@ -576,14 +615,23 @@ buf_read_recv_pages(
 
 		os_aio_print_debug = FALSE;
 
-		while (buf_pool->n_pend_reads >= RECV_POOL_N_FREE_BLOCKS / 2) {
+		/* The free blocks which recovery leaves in the buffer pool
+		are divided among the instances */
+
+		buf_pool = buf_pool_get(space, page_nos[i]);
+
+		while (buf_pool->n_pend_reads >= RECV_POOL_N_FREE_BLOCKS
+					/ (2 * buf_pool_n_instances)) {
+
+			/* Several recovery threads may be waiting here:
+			poll often so that the reads are kept going */
 
 			os_aio_simulated_wake_handler_threads();
-			os_thread_sleep(500000);
+			os_thread_sleep(10000);
 
 			count++;
 
-			if (count > 100) {
+			if (count % 5000 == 0) {
 				fprintf(stderr,
 "InnoDB: Error: InnoDB has waited for 50 seconds for pending\n"
 "InnoDB: reads to the buffer pool to be finished.\n"
@@ -607,8 +655,8 @@ buf_read_recv_pages(
 	
 	os_aio_simulated_wake_handler_threads();
 
-	/* Flush pages from the end of the LRU list if necessary */
-	buf_flush_free_margin();
+	/* Flush pages from the end of the LRU lists if necessary */
+	buf_flush_free_margins();
 
 	if (buf_debug_prints) {
 		printf("Recovery applies read-ahead pages %lu\n", n_stored);
@@ -0,0 +1,445 @@
+/******************************************************
+The compressed page cache of the buffer pool
+
+(c) 2003 Innobase Oy
+
+Created 10/17/2003
+*******************************************************/
+
+#include "buf0zip.h"
+
+#include "ut0mem.h"
+#include "buf0buf.h"
+
+#ifdef HAVE_ZLIB_H
+#include <zlib.h>
+#endif
+
+/* The compressed page cache, or NULL if it is disabled */
+buf_zip_t*	buf_zip	= NULL;
+
+/************************************************************************
+Frees a page of the cache. The caller must own the cache mutex. */
+static
+void
+buf_zip_free_page(
+/*==============*/
+	buf_zip_page_t*	zip)	/* in, own: page to free; it must be
+				removed from the hash table */
+{
+	ut_ad(mutex_own(&(buf_zip->mutex)));
+
+	if (zip->size > 0) {
+		UT_LIST_REMOVE(LRU, buf_zip->LRU, zip);
+		buf_zip->size -= zip->size;
+
+		ut_free(zip->data);
+	}
+
+	ut_free(zip);
+}
+
+/************************************************************************
+Looks for a page in the hash table. The caller must own the cache
+mutex. */
+static
+buf_zip_page_t*
+buf_zip_hash_get(
+/*=============*/
+			/* out: page, or NULL */
+	ulint	space,	/* in: space id */
+	ulint	offset)	/* in: page number */
+{
+	buf_zip_page_t*	zip;
+
+	ut_ad(mutex_own(&(buf_zip->mutex)));
+
+	HASH_SEARCH(hash, buf_zip->hash, buf_page_address_fold(space, offset),
+			zip, (zip->space == space) && (zip->offset == offset));
+	return(zip);
+}
+
+/************************************************************************
+Removes a page from the hash table. The caller must own the cache
+mutex. */
+static
+void
+buf_zip_hash_remove(
+/*================*/
+	buf_zip_page_t*	zip)	/* in: page in the hash table */
+{
+	ut_ad(mutex_own(&(buf_zip->mutex)));
+
+	HASH_DELETE(buf_zip_page_t, hash, buf_zip->hash,
+			buf_page_address_fold(zip->space, zip->offset), zip);
+}
+
+/************************************************************************
+Creates the compressed page cache. */
+
+void
+buf_zip_init(
+/*=========*/
+	ulint	max_size)	/* in: maximum size in bytes of the
+				compressed copies, 0 disables the cache */
+{
+#ifdef HAVE_ZLIB_H
+	if (max_size < UNIV_PAGE_SIZE) {
+
+		return;
+	}
+
+	buf_zip = ut_malloc(sizeof(buf_zip_t));
+
+	mutex_create(&(buf_zip->mutex));
+	mutex_set_level(&(buf_zip->mutex), SYNC_BUF_ZIP);
+
+	/* Text pages usually compress to a quarter or less */
+	buf_zip->hash = hash_create(2 * max_size / (UNIV_PAGE_SIZE / 4));
+
+	UT_LIST_INIT(buf_zip->LRU);
+
+	buf_zip->max_size = max_size;
+	buf_zip->size = 0;
+	buf_zip->reserv_count = 0;
+	buf_zip->n_stored = 0;
+	buf_zip->n_not_stored = 0;
+	buf_zip->n_restored = 0;
+	buf_zip->n_dropped = 0;
+#else
+	if (max_size > 0) {
+		fprintf(stderr,
+"InnoDB: Warning: InnoDB was compiled without zlib; the compressed page\n"
+"InnoDB: cache is not used.\n");
+	}
+#endif
+}
+
+/************************************************************************
+Reserves a place in the compressed page cache for a page which is
+about to be replaced in the buffer pool. The caller must own the
+buf_pool mutex, and the page must be taken out of the page hash before
+the mutex is released. The page is stored with buf_zip_store(). */
+
+ulint
+buf_zip_reserve(
+/*============*/
+			/* out: reservation number which is passed to
+			buf_zip_store, or 0 if the cache is disabled */
+	ulint	space,	/* in: space id */
+	ulint	offset)	/* in: page number */
+{
+	buf_zip_page_t*	zip;
+	buf_zip_page_t*	old;
+	ulint		reserv;
+
+	if (buf_zip == NULL) {
+
+		return(0);
+	}
+
+	ut_ad(mutex_own(&(buf_pool_get(space, offset)->mutex)));
+
+	zip = ut_malloc(sizeof(buf_zip_page_t));
+
+	zip->space = space;
+	zip->offset = offset;
+	zip->size = 0;
+	zip->data = NULL;
+
+	mutex_enter(&(buf_zip->mutex));
+
+	/* The page can have an old reservation which was never stored */
+
+	old = buf_zip_hash_get(space, offset);
+
+	if (old) {
+		buf_zip_hash_remove(old);
+		buf_zip_free_page(old);
+	}
+
+	buf_zip->reserv_count++;
+
+	if (buf_zip->reserv_count == 0) {
+		buf_zip->reserv_count++;
+	}
+
+	reserv = zip->reserv = buf_zip->reserv_count;
+
+	HASH_INSERT(buf_zip_page_t, hash, buf_zip->hash,
+			buf_page_address_fold(space, offset), zip);
+
+	mutex_exit(&(buf_zip->mutex));
+
+	return(reserv);
+}
+
+/************************************************************************
+Compresses a replaced page and stores it in the place reserved with
+buf_zip_reserve(). The page is not stored if the place was dropped
+meanwhile, or if the page does not compress to BUF_ZIP_MAX_SIZE. */
+
+void
+buf_zip_store(
+/*==========*/
+	ulint	space,	/* in: space id */
+	ulint	offset,	/* in: page number */
+	ulint	reserv,	/* in: value returned by buf_zip_reserve */
+	byte*	frame)	/* in: page frame; it is not in the page hash */
+{
+#ifdef HAVE_ZLIB_H
+	buf_zip_page_t*	zip;
+	z_stream	stream;
+	byte*		buf;
+	byte*		data	= NULL;
+	ulint		size	= 0;
+
+	if (reserv == 0) {
+
+		return;
+	}
+
+	/* Compress outside the cache mutex. The window needs not be
+	bigger than the page, which makes deflate use much less memory
+	than with the defaults of compress(). */
+
+	buf = ut_malloc(BUF_ZIP_MAX_SIZE);
+
+	stream.next_in = frame;
+	stream.avail_in = UNIV_PAGE_SIZE;
+	stream.next_out = buf;
+	stream.avail_out = BUF_ZIP_MAX_SIZE;
+	stream.zalloc = (alloc_func) 0;
+	stream.zfree = (free_func) 0;
+	stream.opaque = (voidpf) 0;
+
+	if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, 14, 7,
+					Z_DEFAULT_STRATEGY) == Z_OK) {
+		if (deflate(&stream, Z_FINISH) == Z_STREAM_END) {
+			size = stream.total_out;
+		}
+
+		deflateEnd(&stream);
+	}
+
+	if (size > 0) {
+		data = ut_malloc(size);
+		ut_memcpy(data, buf, size);
+	}
+
+	ut_free(buf);
+
+	mutex_enter(&(buf_zip->mutex));
+
+	zip = buf_zip_hash_get(space, offset);
+
+	if (zip == NULL || zip->reserv != reserv || zip->size > 0) {
+		/* The page was read to the buffer pool meanwhile: the
+		copy may be older than the page */
+
+		mutex_exit(&(buf_zip->mutex));
+
+		if (data) {
+			ut_free(data);
+		}
+
+		return;
+	}
+
+	if (data == NULL) {
+		buf_zip->n_not_stored++;
+
+		buf_zip_hash_remove(zip);
+		buf_zip_free_page(zip);
+
+		mutex_exit(&(buf_zip->mutex));
+
+		return;
+	}
+
+	zip->data = data;
+	zip->size = size;
+
+	UT_LIST_ADD_FIRST(LRU, buf_zip->LRU, zip);
+	buf_zip->size += size;
+	buf_zip->n_stored++;
+
+	/* Make room by dropping the least recently stored pages */
+
+	while (buf_zip->size > buf_zip->max_size) {
+		zip = UT_LIST_GET_LAST(buf_zip->LRU);
+
+		buf_zip_hash_remove(zip);
+		buf_zip_free_page(zip);
+
+		buf_zip->n_dropped++;
+	}
+
+	mutex_exit(&(buf_zip->mutex));
+#endif
+}
+
+/************************************************************************
+Takes the compressed copy of a page out of the cache. The caller must own
+the buf_pool mutex. */
+
+buf_zip_page_t*
+buf_zip_take(
+/*=========*/
+			/* out, own: compressed copy, or NULL */
+	ulint	space,	/* in: space id */
+	ulint	offset)	/* in: page number */
+{
+	buf_zip_page_t*	zip;
+
+	if (buf_zip == NULL) {
+
+		return(NULL);
+	}
+
+	ut_ad(mutex_own(&(buf_pool_get(space, offset)->mutex)));
+
+	mutex_enter(&(buf_zip->mutex));
+
+	zip = buf_zip_hash_get(space, offset);
+
+	if (zip) {
+		buf_zip_hash_remove(zip);
+
+		if (zip->size == 0) {
+			/* Only reserved: buf_zip_store will not find it */
+
+			buf_zip_free_page(zip);
+			zip = NULL;
+		} else {
+			UT_LIST_REMOVE(LRU, buf_zip->LRU, zip);
+			buf_zip->size -= zip->size;
+			buf_zip->n_restored++;
+		}
+	}
+
+	mutex_exit(&(buf_zip->mutex));
+
+	return(zip);
+}
+
+/************************************************************************
+Uncompresses a copy taken with buf_zip_take() to a page frame and frees
+the copy. */
+
+ibool
+buf_zip_restore(
+/*============*/
+				/* out: TRUE if success; if FALSE, the
+				page must be read from the data file */
+	buf_zip_page_t*	zip,	/* in, own: compressed copy */
+	byte*		frame)	/* out: page frame */
+{
+	ibool	success	= FALSE;
+#ifdef HAVE_ZLIB_H
+	uLongf	len	= UNIV_PAGE_SIZE;
+
+	success = uncompress(frame, &len, zip->data, zip->size) == Z_OK
+		  && len == UNIV_PAGE_SIZE;
+
+	if (!success) {
+		fprintf(stderr,
+"InnoDB: Error: could not uncompress space %lu page %lu in the compressed\n"
+"InnoDB: page cache; reading it from the data file\n",
+			zip->space, zip->offset);
+	}
+#endif
+	ut_free(zip->data);
+	ut_free(zip);
+
+	return(success);
+}
+
+/************************************************************************
+Drops the compressed copy of a page, if any. Called when the page enters
+the buffer pool; the caller must own the buf_pool mutex. */
+
+void
+buf_zip_drop(
+/*=========*/
+	ulint	space,	/* in: space id */
+	ulint	offset)	/* in: page number */
+{
+	buf_zip_page_t*	zip;
+
+	if (buf_zip == NULL) {
+
+		return;
+	}
+
+	ut_ad(mutex_own(&(buf_pool_get(space, offset)->mutex)));
+
+	mutex_enter(&(buf_zip->mutex));
+
+	zip = buf_zip_hash_get(space, offset);
+
+	if (zip) {
+		buf_zip_hash_remove(zip);
+		buf_zip_free_page(zip);
+	}
+
+	mutex_exit(&(buf_zip->mutex));
+}
+
+/************************************************************************
+Checks if the cache has a compressed copy of a page. The result is only
+a hint: the copy may be dropped or taken as soon as this returns. */
+
+ibool
+buf_zip_contains(
+/*=============*/
+			/* out: TRUE if a compressed copy exists */
+	ulint	space,	/* in: space id */
+	ulint	offset)	/* in: page number */
+{
+	buf_zip_page_t*	zip;
+	ibool		found;
+
+	if (buf_zip == NULL) {
+
+		return(FALSE);
+	}
+
+	mutex_enter(&(buf_zip->mutex));
+
+	zip = buf_zip_hash_get(space, offset);
+
+	found = zip != NULL && zip->size > 0;
+
+	mutex_exit(&(buf_zip->mutex));
+
+	return(found);
+}
+
+/*************************************************************************
+Prints info of the compressed page cache. */
+
+void
+buf_zip_print(
+/*==========*/
+	char*	buf,	/* in/out: buffer where to print */
+	char*	buf_end)/* in: buffer end */
+{
+	if (buf_zip == NULL || buf_end - buf < 300) {
+
+		return;
+	}
+
+	mutex_enter(&(buf_zip->mutex));
+
+	buf += sprintf(buf,
+		"Compressed pages   %lu, size %lu, max size %lu\n",
+		UT_LIST_GET_LEN(buf_zip->LRU), buf_zip->size,
+		buf_zip->max_size);
+	buf += sprintf(buf,
+	"Compressed page stores %lu, not compressible %lu, reads %lu, drops %lu\n",
+		buf_zip->n_stored, buf_zip->n_not_stored,
+		buf_zip->n_restored, buf_zip->n_dropped);
+
+	mutex_exit(&(buf_zip->mutex));
+}
@@ -111,7 +111,8 @@ btr_cur_search_to_nth_level(
 	btr_cur_t*	cursor, /* in/out: tree cursor; the cursor page is
 				s- or x-latched, but see also above! */
 	ulint		has_search_latch,/* in: latch mode the caller
-				currently has on btr_search_latch:
+				currently has on the latch of the
+				adaptive hash index part of the index:
 				RW_S_LATCH, or 0 */
 	mtr_t*		mtr);	/* in: mtr */
 /*********************************************************************
@@ -23,7 +23,40 @@ Creates and initializes the adaptive search system at a database start. */
 void
 btr_search_sys_create(
 /*==================*/
-	ulint	hash_size);	/* in: hash index hash table size */
+	ulint	hash_size,	/* in: hash index hash table size, divided
+				between the parts */
+	ulint	n_parts);	/* in: number of parts of the hash index */
+/************************************************************************
+Returns the part of the adaptive hash index where the records of an index
+are hashed. */
+UNIV_INLINE
+btr_search_part_t*
+btr_search_get_part(
+/*================*/
+				/* out: hash index part */
+	dulint	index_id);	/* in: index id */
+/************************************************************************
+Returns the latch of the adaptive hash index part of an index. */
+UNIV_INLINE
+rw_lock_t*
+btr_search_get_latch(
+/*=================*/
+				/* out: latch of the hash index part */
+	dulint	index_id);	/* in: index id */
+/************************************************************************
+S-latches a part of the adaptive hash index, and counts the latch waits. */
+UNIV_INLINE
+void
+btr_search_s_lock(
+/*==============*/
+	btr_search_part_t*	part);	/* in: hash index part */
+/************************************************************************
+X-latches a part of the adaptive hash index, and counts the latch waits. */
+UNIV_INLINE
+void
+btr_search_x_lock(
+/*==============*/
+	btr_search_part_t*	part);	/* in: hash index part */
 /************************************************************************
 Returns search info for an index. */
 UNIV_INLINE
@@ -80,7 +113,8 @@ btr_search_guess_on_hash(
 	ulint		latch_mode, 	/* in: BTR_SEARCH_LEAF, ... */
 	btr_cur_t*	cursor, 	/* out: tree cursor */
 	ulint		has_search_latch,/* in: latch mode the caller
-					currently has on btr_search_latch:
+					currently has on the latch of the
+					hash index part of index:
 					RW_S_LATCH, RW_X_LATCH, or 0 */
 	mtr_t*		mtr);		/* in: mtr */
 /************************************************************************
@@ -145,6 +179,15 @@ Prints info of the search system. */
 void
 btr_search_print_info(void);
 /*=======================*/
+/*************************************************************************
+Prints the size and the search and latch statistics of the hash index parts
+to a buffer. */
+
+void
+btr_search_sys_print(
+/*=================*/
+	char*	buf,	/* in/out: buffer where to print */
+	char*	buf_end);/* in: buffer end */
 /************************************************************************
 Prints info of searches on an index. */
 
@@ -223,31 +266,49 @@ struct btr_search_struct{
 
 #define BTR_SEARCH_MAGIC_N	1112765
 
-/* The hash index system */
+/* The hash index system. The hash index is divided into parts by the index
+id: the records of an index are always hashed in the same part, and each
+part has its own latch. Searches in an index then only wait for updates
+of the hash index of the indexes in the same part. */
 
 typedef struct btr_search_sys_struct	btr_search_sys_t;
 
-struct btr_search_sys_struct{
-	hash_table_t*	hash_index;
-};
-
-extern btr_search_sys_t*	btr_search_sys;
-
-/* The latch protecting the adaptive search system: this latch protects the
-(1) hash index;
-(2) columns of a record to which we have a pointer in the hash index;
+/* A part of the hash index. The latch of the part protects the
+(1) hash index of the part;
+(2) columns of a record to which we have a pointer in the hash index of the
+part;
+(3) hash index fields of the buffer blocks of the pages of the indexes in
+the part;
 
 but does NOT protect:
 
-(3) next record offset field in a record;
-(4) next or previous records on the same page.
+(4) next record offset field in a record;
+(5) next or previous records on the same page.
 
-Bear in mind (3) and (4) when using the hash index.
-*/
+Bear in mind (4) and (5) when using the hash index. A thread never holds
+the latches of two parts at the same time. */
 
-extern rw_lock_t*	btr_search_latch_temp;
+struct btr_search_part_struct{
+	rw_lock_t	latch;		/* latch protecting the part */
+	hash_table_t*	hash_index;	/* hash index of the part */
+	/*----------------------*/
+	/* The following 3 fields are statistics for the monitor; they
+	are not protected by any latch and are thus not exact */
+	ulint		n_searches;	/* number of hash searches */
+	ulint		n_hits;		/* number of successful hash
+					searches */
+	ulint		n_latch_waits;	/* number of times a thread had to
+					wait for the latch */
+	byte		pad[64];	/* padding to keep the latches of the
+					parts on different cache lines */
+};
+
+struct btr_search_sys_struct{
+	ulint			n_parts;/* number of parts */
+	btr_search_part_t*	parts;	/* array of the parts */
+};
 
-#define btr_search_latch	(*btr_search_latch_temp)
+extern btr_search_sys_t*	btr_search_sys;
 
 extern ulint	btr_search_n_succ;
 extern ulint	btr_search_n_hash_fail;
@@ -52,7 +52,32 @@ Created 11/5/1995 Heikki Tuuri
 #define BUF_MAKE_YOUNG	51
 #define BUF_KEEP_OLD	52
 
-extern buf_pool_t* 	buf_pool; 	/* The buffer pool of the database */
+/* Maximum number of buffer pool instances */
+#define BUF_POOL_MAX_INSTANCES	64
+
+/* Number of consecutive pages of a tablespace which are always in the same
+buffer pool instance; read-ahead and flushing of neighbor pages work within
+such an area, which must thus be at least BUF_READ_AHEAD_AREA */
+#define BUF_POOL_INSTANCE_AREA	64
+
+/* The smallest number of blocks in a buffer pool instance */
+#define BUF_POOL_MIN_INSTANCE_SIZE	256
+
+extern buf_pool_t*	buf_pools[BUF_POOL_MAX_INSTANCES];
+					/* The buffer pool instances of the
+					database; a file page is always
+					buffered in the instance given by
+					buf_pool_get() */
+extern ulint		buf_pool_n_instances;/* number of instances */
+extern byte*		buf_pool_frame_zero;/* pointer to the first buffer
+					frame; the instances use consecutive
+					parts of one frame array */
+extern byte*		buf_pool_high_end;/* pointer to the end of the
+					frame array */
+extern buf_block_t*	buf_pool_blocks;/* array of the control blocks of
+					all the instances */
+extern ulint		buf_pool_n_blocks;/* number of control blocks in all
+					the instances */
 extern ibool		buf_debug_prints;/* If this is set TRUE, the program
 					prints info whenever read or flush
 					occurs */
@@ -64,8 +89,20 @@ void
 buf_pool_init(
 /*==========*/
 	ulint	max_size,	/* in: maximum size of the pool in blocks */
-	ulint	curr_size);	/* in: current size to use, must be <=
+	ulint	curr_size,	/* in: current size to use, must be <=
 				max_size */
+	ulint	n_instances);	/* in: number of buffer pool instances; this
+				is decreased if an instance would get less
+				than BUF_POOL_MIN_INSTANCE_SIZE blocks */
+/************************************************************************
+Returns the buffer pool instance where a file page is buffered. */
+UNIV_INLINE
+buf_pool_t*
+buf_pool_get(
+/*=========*/
+			/* out: buffer pool instance */
+	ulint	space,	/* in: space id */
+	ulint	offset);/* in: page number */
 /*************************************************************************
 Gets the current size of buffer pool in bytes. */
 UNIV_INLINE
@@ -593,7 +630,9 @@ already in buf_pool, does nothing. Sets the io_fix flag to BUF_IO_READ and
 sets a non-recursive exclusive lock on the buffer frame. The io-handler must
 take care that the flag is cleared and the lock released later. This is one
 of the functions which perform the state transition NOT_USED => FILE_PAGE to
-a block (the other is buf_page_create). */ 
+a block (the other is buf_page_create). If zip is not NULL, a compressed copy
+of the page is taken out of the compressed page cache: the caller should
+uncompress it to the frame instead of reading the page from the file. */ 
 
 buf_block_t*
 buf_page_init_for_read(
@@ -601,7 +640,10 @@ buf_page_init_for_read(
 			/* out: pointer to the block */
 	ulint	mode,	/* in: BUF_READ_IBUF_PAGES_ONLY, ... */
 	ulint	space,	/* in: space id */
-	ulint	offset);/* in: page number */
+	ulint	offset,	/* in: page number */
+	buf_zip_page_t** zip);/* out, own: compressed copy of the page, or
+			NULL; the caller must pass NULL if it does not
+			complete the read itself */
 /************************************************************************
 Completes an asynchronous read or write request of a file page to or from
 the buffer pool. */
@@ -626,23 +668,38 @@ UNIV_INLINE
 buf_block_t*
 buf_page_hash_get(
 /*==============*/
-			/* out: block, NULL if not found */
-	ulint	space,	/* in: space id */
-	ulint	offset);/* in: offset of the page within space */
+				/* out: block, NULL if not found */
+	buf_pool_t*	buf_pool,/* in: buffer pool instance of the page */
+	ulint		space,	/* in: space id */
+	ulint		offset);/* in: offset of the page within space */
 /***********************************************************************
 Increments the pool clock by one and returns its new value. Remember that
 in the 32 bit version the clock wraps around at 4 billion! */
 UNIV_INLINE
 ulint
-buf_pool_clock_tic(void);
-/*====================*/
-			/* out: new clock value */
+buf_pool_clock_tic(
+/*===============*/
+				/* out: new clock value */
+	buf_pool_t*	buf_pool);/* in: buffer pool instance */
 /*************************************************************************
-Gets the current length of the free list of buffer blocks. */
+Gets the current length of the free lists of buffer blocks. */
 
 ulint
 buf_get_free_list_len(void);
 /*=======================*/
+/*************************************************************************
+Returns the number of page reads and writes done by all the buffer pool
+instances. */
+
+ulint
+buf_get_n_page_ios(void);
+/*====================*/
+/*************************************************************************
+Returns the number of pages read to all the buffer pool instances. */
+
+ulint
+buf_get_n_pages_read(void);
+/*======================*/
 
 
 			
@@ -653,6 +710,8 @@ struct buf_block_struct{
 	/* 1. General fields */
 
 	ulint		magic_n;	/* magic number to check */
+	buf_pool_t*	buf_pool;	/* the buffer pool instance which owns
+					the block */
 	ulint		state;		/* state of the control block:
 					BUF_BLOCK_NOT_USED, ... */
 	byte*		frame;		/* pointer to buffer frame which
@@ -763,7 +822,8 @@ struct buf_block_struct{
 					records with the same prefix should be
 					indexed in the hash index */
 					
-	/* The following 4 fields are protected by btr_search_latch: */
+	/* The following 4 fields are protected by the latch of the
+	adaptive hash index part of the index of the page: */
 
 	ibool		is_hashed;	/* TRUE if hash index has already been
 					built on this page; note that it does
@@ -790,24 +850,22 @@ struct buf_block_struct{
 
 #define BUF_BLOCK_MAGIC_N	41526563
 
-/* The buffer pool structure. NOTE! The definition appears here only for
-other modules of this directory (buf) to see it. Do not use from outside! */
+/* The buffer pool instance structure. NOTE! The definition appears here
+only for other modules of this directory (buf) to see it. Do not use from
+outside! */
 
 struct buf_pool_struct{
 
 	/* 1. General fields */
 
-	mutex_t		mutex;		/* mutex protecting the buffer pool
-					struct and control blocks, except the
-					read-write lock in them */
-	byte*		frame_mem;	/* pointer to the memory area which
-					was allocated for the frames */
-	byte*		frame_zero;	/* pointer to the first buffer frame:
-					this may differ from frame_mem, because
-					this is aligned by the frame size */
-	byte*		high_end;	/* pointer to the end of the
-					buffer pool */
-	buf_block_t*	blocks;		/* array of buffer control blocks */
+	ulint		id;		/* index of the instance in
+					buf_pools */
+	mutex_t		mutex;		/* mutex protecting the instance
+					struct and its control blocks, except
+					the read-write lock in them */
+	buf_block_t*	blocks;		/* array of buffer control blocks of
+					the instance: a part of
+					buf_pool_blocks */
 	ulint		max_size;	/* number of control blocks ==
 					maximum pool size in pages */
 	ulint		curr_size;	/* current pool size in pages */
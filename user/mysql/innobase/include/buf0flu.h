@@ -22,12 +22,21 @@ buf_flush_write_complete(
 /*=====================*/
 	buf_block_t*	block);	/* in: pointer to the block in question */
 /*************************************************************************
-Flushes pages from the end of the LRU list if there is too small
-a margin of replaceable pages there. */
+Flushes pages from the end of the LRU list of a buffer pool instance if
+there is too small a margin of replaceable pages there. */
 
 void
-buf_flush_free_margin(void);
-/*=======================*/
+buf_flush_free_margin(
+/*==================*/
+	buf_pool_t*	buf_pool);	/* in: buffer pool instance */
+/*************************************************************************
+Flushes pages from the end of the LRU lists of all the buffer pool instances
+if there is too small a margin of replaceable pages there or in the free
+lists. */
+
+void
+buf_flush_free_margins(void);
+/*========================*/
 /************************************************************************
 Initializes a page for writing to the tablespace. */
 
@@ -39,8 +48,9 @@ buf_flush_init_for_writing(
 	ulint	space,		/* in: space id */
 	ulint	page_no);	/* in: page number */
 /***********************************************************************
-This utility flushes dirty blocks from the end of the LRU list or flush_list.
-NOTE 1: in the case of an LRU flush the calling thread may own latches to
+This utility flushes dirty blocks from the end of the LRU lists or
+flush_lists of all the buffer pool instances. The min_n blocks are divided
+evenly among the instances. NOTE 1: in the case of an LRU flush the calling thread may own latches to
 pages: to avoid deadlocks, this function must be written so that it cannot
 end up waiting for these latches! NOTE 2: in the case of a flush list flush,
 the calling thread is not allowed to own any latches on pages! */
@@ -49,7 +59,9 @@ ulint
 buf_flush_batch(
 /*============*/
 				/* out: number of blocks for which the write
-				request was queued */
+				request was queued; ULINT_UNDEFINED if there
+				was a flush of the same type already running
+				in some instance */
 	ulint	flush_type,	/* in: BUF_FLUSH_LRU or BUF_FLUSH_LIST; if
 				BUF_FLUSH_LIST, then the caller must not own
 				any latches on pages */
@@ -61,7 +73,8 @@ buf_flush_batch(
 				should be flushed (if their number does not
 				exceed min_n), otherwise ignored */
 /**********************************************************************
-Waits until a flush batch of the given type ends */
+Waits until the flush batches of the given type end in all the buffer pool
+instances */
 
 void
 buf_flush_wait_batch_end(
@@ -98,7 +111,7 @@ buf_flush_ready_for_replace(
 	buf_block_t*	block);	/* in: buffer control block, must be in state
 				BUF_BLOCK_FILE_PAGE and in the LRU list */
 /**********************************************************************
-Validates the flush list. */
+Validates the flush lists. */
 
 ibool
 buf_flush_validate(void);
@@ -14,8 +14,8 @@ Created 11/5/1995 Heikki Tuuri
 #include "buf0types.h"
 
 /**********************************************************************
-Tries to remove LRU flushed blocks from the end of the LRU list and put them
-to the free list. This is beneficial for the efficiency of the insert buffer
+Tries to remove LRU flushed blocks from the end of the LRU lists of the
+buffer pool instances and put them to the free lists. This is beneficial for the efficiency of the insert buffer
 operation, as flushed pages from non-unique non-clustered indexes are here
 taken out of the buffer pool, and their inserts redirected to the insert
 buffer. Otherwise, the flushed blocks could get modified again before read
@@ -42,9 +42,11 @@ Gets the minimum LRU_position field for the blocks in an initial segment
 guaranteed to be precise, because the ulint_clock may wrap around. */
 
 ulint
-buf_LRU_get_recent_limit(void);
-/*==========================*/
-			/* out: the limit; zero if could not determine it */
+buf_LRU_get_recent_limit(
+/*=====================*/
+				/* out: the limit; zero if could not
+				determine it */
+	buf_pool_t*	buf_pool);/* in: buffer pool instance */
 /**********************************************************************
 Look for a replaceable block from the end of the LRU list and put it to
 the free list if found. */
@@ -53,21 +55,23 @@ ibool
 buf_LRU_search_and_free_block(
 /*==========================*/
 				/* out: TRUE if freed */
-	ulint	n_iterations);   /* in: how many times this has been called
-				repeatedly without result: a high value means
-				that we should search farther; if value is
-				k < 10, then we only search k/10 * number
+	buf_pool_t*	buf_pool,/* in: buffer pool instance */
+	ulint		n_iterations);/* in: how many times this has been
+				called repeatedly without result: a high value
+				means that we should search farther; if value
+				is k < 10, then we only search k/10 * number
 				of pages in the buffer pool from the end
 				of the LRU list */
 /**********************************************************************
-Returns a free block from the buf_pool. The block is taken off the
+Returns a free block from a buf_pool instance. The block is taken off the
 free list. If it is empty, blocks are moved from the end of the
 LRU list to the free list. */
 
 buf_block_t*
-buf_LRU_get_free_block(void);
-/*=========================*/
+buf_LRU_get_free_block(
+/*===================*/
 				/* out: the free control block */
+	buf_pool_t*	buf_pool);/* in: buffer pool instance */
 /**********************************************************************
 Puts a block back to the free list. */
 
@@ -101,13 +105,13 @@ buf_LRU_make_block_old(
 /*===================*/
 	buf_block_t*	block);	/* in: control block */
 /**************************************************************************
-Validates the LRU list. */
+Validates the LRU lists. */
 
 ibool
 buf_LRU_validate(void);
 /*==================*/
 /**************************************************************************
-Prints the LRU list. */
+Prints the LRU lists. */
 
 void
 buf_LRU_print(void);
@@ -87,7 +87,8 @@ buf_read_recv_pages(
 	ulint	n_stored);	/* in: number of page numbers in the array */
 
 /* The size in pages of the area which the read-ahead algorithms read if
-invoked */
+invoked; NOTE that this refers to the buffer pool instance buf_pool in the
+scope where it is used */
 
 #define	BUF_READ_AHEAD_AREA	ut_min(64, ut_2_power_up(buf_pool->curr_size / 32))
 
@@ -11,6 +11,8 @@ Created 11/17/1995 Heikki Tuuri
 
 typedef	struct buf_block_struct		buf_block_t;
 typedef	struct buf_pool_struct		buf_pool_t;
+typedef	struct buf_zip_struct		buf_zip_t;
+typedef	struct buf_zip_page_struct	buf_zip_page_t;
 
 /* The 'type' used of a buffer frame */
 typedef	byte	buf_frame_t;
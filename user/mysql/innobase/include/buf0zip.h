@@ -0,0 +1,153 @@
+/******************************************************
+The compressed page cache of the buffer pool
+
+(c) 2003 Innobase Oy
+
+Created 10/17/2003
+*******************************************************/
+
+#ifndef buf0zip_h
+#define buf0zip_h
+
+#include "univ.i"
+#include "buf0types.h"
+#include "hash0hash.h"
+#include "ut0lst.h"
+#include "sync0sync.h"
+
+/* The compressed page cache keeps zlib compressed copies of clean pages
+which have been replaced in the buffer pool. A read of such a page is
+then done by uncompressing the copy instead of reading the page from the
+data file. A page has either an uncompressed copy in the buffer pool or
+a compressed copy in this cache, never both: buf_page_init_for_read()
+takes the compressed copy out of the cache and buf_page_init() drops any
+copy of a page which enters the buffer pool. The disk copy of a page can
+change only when the page is in the buffer pool, so the compressed copy
+is always equal to the disk copy. */
+
+/* Compressed copies bigger than this are not stored */
+#define BUF_ZIP_MAX_SIZE	(UNIV_PAGE_SIZE / 2)
+
+/************************************************************************
+Creates the compressed page cache. */
+
+void
+buf_zip_init(
+/*=========*/
+	ulint	max_size);	/* in: maximum size in bytes of the
+				compressed copies, 0 disables the cache */
+/************************************************************************
+Reserves a place in the compressed page cache for a page which is
+about to be replaced in the buffer pool. The caller must own the
+buf_pool mutex, and the page must be taken out of the page hash before
+the mutex is released. The page is stored with buf_zip_store(). */
+
+ulint
+buf_zip_reserve(
+/*============*/
+			/* out: reservation number which is passed to
+			buf_zip_store, or 0 if the cache is disabled */
+	ulint	space,	/* in: space id */
+	ulint	offset);/* in: page number */
+/************************************************************************
+Compresses a replaced page and stores it in the place reserved with
+buf_zip_reserve(). The page is not stored if the place was dropped
+meanwhile, or if the page does not compress to BUF_ZIP_MAX_SIZE. */
+
+void
+buf_zip_store(
+/*==========*/
+	ulint	space,	/* in: space id */
+	ulint	offset,	/* in: page number */
+	ulint	reserv,	/* in: value returned by buf_zip_reserve */
+	byte*	frame);	/* in: page frame; it is not in the page hash */
+/************************************************************************
+Takes the compressed copy of a page out of the cache. The caller must own
+the buf_pool mutex. */
+
+buf_zip_page_t*
+buf_zip_take(
+/*=========*/
+			/* out, own: compressed copy, or NULL */
+	ulint	space,	/* in: space id */
+	ulint	offset);/* in: page number */
+/************************************************************************
+Uncompresses a copy taken with buf_zip_take() to a page frame and frees
+the copy. */
+
+ibool
+buf_zip_restore(
+/*============*/
+				/* out: TRUE if success; if FALSE, the
+				page must be read from the data file */
+	buf_zip_page_t*	zip,	/* in, own: compressed copy */
+	byte*		frame);	/* out: page frame */
+/************************************************************************
+Drops the compressed copy of a page, if any. Called when the page enters
+the buffer pool; the caller must own the buf_pool mutex. */
+
+void
+buf_zip_drop(
+/*=========*/
+	ulint	space,	/* in: space id */
+	ulint	offset);/* in: page number */
+/************************************************************************
+Checks if the cache has a compressed copy of a page. The result is only
+a hint: the copy may be dropped or taken as soon as this returns. */
+
+ibool
+buf_zip_contains(
+/*=============*/
+			/* out: TRUE if a compressed copy exists */
+	ulint	space,	/* in: space id */
+	ulint	offset);/* in: page number */
+/*************************************************************************
+Prints info of the compressed page cache. */
+
+void
+buf_zip_print(
+/*==========*/
+	char*	buf,	/* in/out: buffer where to print */
+	char*	buf_end);/* in: buffer end */
+
+/* The compressed copy of a page */
+
+struct buf_zip_page_struct{
+	ulint		space;		/* space id */
+	ulint		offset;		/* page number */
+	ulint		reserv;		/* reservation number */
+	ulint		size;		/* size of the compressed copy in
+					data; 0 if the page is only
+					reserved and not yet stored */
+	byte*		data;		/* compressed page, allocated with
+					ut_malloc */
+	buf_zip_page_t*	hash;		/* node in the hash table */
+	UT_LIST_NODE_T(buf_zip_page_t) LRU;
+					/* node in the LRU list; reserved
+					pages are not in the list */
+};
+
+/* The compressed page cache */
+
+struct buf_zip_struct{
+	mutex_t		mutex;		/* protects the fields below */
+	hash_table_t*	hash;		/* compressed and reserved pages
+					hashed on the page address */
+	UT_LIST_BASE_NODE_T(buf_zip_page_t) LRU;
+					/* stored pages, the least recently
+					stored last */
+	ulint		max_size;	/* maximum total size of the data
+					of stored pages */
+	ulint		size;		/* current total size */
+	ulint		reserv_count;	/* last reservation number */
+	ulint		n_stored;	/* pages stored */
+	ulint		n_not_stored;	/* pages which did not compress to
+					BUF_ZIP_MAX_SIZE */
+	ulint		n_restored;	/* pages read from the cache */
+	ulint		n_dropped;	/* pages replaced to make room
+					for others */
+};
+
+extern buf_zip_t*	buf_zip;
+
+#endif
@@ -163,7 +163,8 @@ recv_sys_init(
 	ulint	available_memory);	/* in: available memory in bytes */
 /***********************************************************************
 Empties the hash table of stored log records, applying them to appropriate
-pages. */
+pages. The hash table is split into srv_n_recovery_threads partitions by
+the page address, and each partition is applied by its own thread. */
 
 void
 recv_apply_hashed_log_recs(
@@ -326,6 +327,13 @@ struct recv_sys_struct{
 	hash_table_t*	addr_hash;/* hash table of file addresses of pages */
 	ulint		n_addrs;/* number of not processed hashed file
 				addresses in the hash table */
+	ulint		n_apply_threads;
+				/* number of threads applying the current
+				batch, each to its own partition of
+				addr_hash */
+	ulint		n_apply_threads_active;
+				/* number of those threads which have not
+				yet finished */
 };
 
 extern recv_sys_t*	recv_sys;
@@ -346,6 +354,9 @@ times! */
 roll-forward */
 #define RECV_SCAN_SIZE		(4 * UNIV_PAGE_SIZE)
 
+/* Maximum number of threads applying a batch of log records */
+#define RECV_MAX_APPLY_THREADS	64
+
 /* States of recv_addr_struct */
 #define RECV_NOT_PROCESSED	71
 #define RECV_BEING_READ		72
@@ -28,6 +28,17 @@ extern ibool	os_aio_print_debug;
 
 #endif
 
+#if defined(HAVE_LINUX_AIO_ABI_H) && !defined(__WIN__)
+#include <sys/syscall.h>
+#ifdef __NR_io_setup
+/* Linux kernel aio: we call io_submit() and io_getevents() through
+syscall(), so that we do not need to link with libaio. We check at run-time
+whether the kernel actually supports it, and fall back to simulated aio if
+it does not. */
+#define LINUX_NATIVE_AIO
+#endif
+#endif
+
 #ifdef __WIN__
 #define os_file_t	HANDLE
 #else
@@ -389,6 +400,33 @@ os_aio_windows_handle(
 	ulint*	type);		/* out: OS_FILE_WRITE or ..._READ */
 #endif
 
+#ifdef LINUX_NATIVE_AIO
+/**************************************************************************
+This function is only used in Linux native asynchronous i/o.
+Waits for an aio operation to complete in a segment of an aio array.
+The i/o-handler thread of the segment gets the completion events from
+the io context of the segment, and returns the slots one at a time.
+NOTE: this function will also take care of freeing the aio slot,
+therefore no other thread is allowed to do the freeing! */
+
+ibool
+os_aio_linux_handle(
+/*================*/
+				/* out: TRUE if the aio operation succeeded */
+	ulint	global_segment,	/* in: the number of the segment in the aio
+				arrays to wait for; segment 0 is the ibuf
+				i/o thread, segment 1 the log i/o thread,
+				then follow the non-ibuf read threads, and as
+				the last are the non-ibuf write threads */
+	void**	message1,	/* out: the messages passed with the aio
+				request; note that also in the case where
+				the aio operation failed, these output
+				parameters are valid and can be used to
+				restart the operation, for example */
+	void**	message2,
+	ulint*	type);		/* out: OS_FILE_WRITE or ..._READ */
+#endif
+
 /* Currently we do not use Posix async i/o */
 #ifdef POSIX_ASYNC_IO
 /**************************************************************************
@@ -61,10 +61,15 @@ extern ulint	srv_flush_log_at_trx_commit;
 extern byte	srv_latin1_ordering[256];/* The sort order table of the latin1
 					character set */
 extern ulint	srv_pool_size;
+extern ulint	srv_pool_zip_size;
+extern ulint	srv_buf_pool_instances;
+extern ulint	srv_adaptive_hash_index_parts;
 extern ulint	srv_mem_pool_size;
 extern ulint	srv_lock_table_size;
 
 extern ulint	srv_n_file_io_threads;
+extern ulint	srv_n_recovery_threads;
+extern ibool	srv_use_native_aio;
 
 extern ibool	srv_archive_recovery;
 extern dulint	srv_archive_recovery_limit_lsn;
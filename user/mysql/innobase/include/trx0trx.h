@@ -15,6 +15,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "usr0types.h"
 #include "que0types.h"
 #include "mem0mem.h"
+#include "sync0rw.h"
 #include "read0types.h"
 
 extern ulint	trx_n_mysql_transactions;
@@ -166,6 +167,14 @@ trx_commit_complete_for_mysql(
 			/* out: 0 or error number */
 	trx_t*	trx);	/* in: trx handle */
 /**************************************************************************
+Writes, and if required flushes, the log up to its current end, so that
+all transactions committed with trx->flush_log_later == TRUE are made
+durable. Used by the binlog group commit. */
+
+void
+trx_commit_complete_group_for_mysql(void);
+/*=====================================*/
+/**************************************************************************
 Marks the latest SQL statement ended. */
 
 void
@@ -408,6 +417,9 @@ struct trx_struct{
         ibool           has_search_latch;
 			                /* TRUE if this trx has latched the
 			                search system latch in S-mode */
+	rw_lock_t*	search_latch;	/* if has_search_latch, the latch of
+					the adaptive hash index part which
+					this trx has s-latched */
 	ulint		search_latch_timeout;
 					/* If we notice that someone is
 					waiting for our S-lock on the search
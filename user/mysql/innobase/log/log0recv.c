@@ -32,13 +32,14 @@ Created 9/20/1997 Heikki Tuuri
 #include "btr0cur.h"
 #include "dict0boot.h"
 #include "fil0fil.h"
+#include "os0thread.h"
 
 /* Log records are stored in the hash table in chunks at most of this size;
 this must be less than UNIV_PAGE_SIZE as it is stored in the buffer pool */
 #define RECV_DATA_BLOCK_SIZE	(MEM_MAX_ALLOC_IN_BUF - sizeof(recv_data_t))
 
 /* Read-ahead area in applying log records to file pages */
-#define RECV_READ_AHEAD_AREA	32
+#define RECV_READ_AHEAD_AREA	64
 
 recv_sys_t*	recv_sys = NULL;
 ibool		recv_recovery_on = FALSE;
@@ -133,6 +134,8 @@ recv_sys_init(
 	
 	recv_sys->apply_log_recs = FALSE;
 	recv_sys->apply_batch_on = FALSE;
+	recv_sys->n_apply_threads = 0;
+	recv_sys->n_apply_threads_active = 0;
 
 	recv_sys->last_block_buf_start = mem_alloc(2 * OS_FILE_LOG_BLOCK_SIZE);
 
@@ -1017,6 +1020,18 @@ recv_recover_page(
 		return;
 	}
 
+	if (just_read_in && recv_sys->apply_batch_on
+	    && recv_addr->state == RECV_BEING_READ) {
+
+		/* The apply thread which read the page applies the log
+		records, so that the i/o-handler thread does not serialize
+		the application */
+
+		mutex_exit(&(recv_sys->mutex));
+
+		return;
+	}
+
 	recv_addr->state = RECV_BEING_PROCESSED;
 	
 	mutex_exit(&(recv_sys->mutex));
@@ -1161,17 +1176,20 @@ recv_recover_page(
 
 /***********************************************************************
 Reads in pages which have hashed log records, from an area around a given
-page number. */
+page number. The log records are not applied to the pages by the
+i/o-handler: recv_apply_partition() applies them to the returned pages
+with recv_apply_to_page(). */
 static
 ulint
 recv_read_in_area(
 /*==============*/
 			/* out: number of pages found */
 	ulint	space,	/* in: space */
-	ulint	page_no)/* in: page number */
+	ulint	page_no,/* in: page number */
+	ulint*	page_nos)/* out: page numbers of the pages read, an
+			array of size RECV_READ_AHEAD_AREA */
 {
 	recv_addr_t* recv_addr;
-	ulint	page_nos[RECV_READ_AHEAD_AREA];
 	ulint	low_limit;
 	ulint	n;
 
@@ -1205,10 +1223,121 @@ recv_read_in_area(
 	*/
 	return(n);
 }
+
+/***********************************************************************
+Applies the hashed log records to a page, reading the page in if it is
+not in the buffer pool. */
+static
+void
+recv_apply_to_page(
+/*===============*/
+	ulint	space,	/* in: space */
+	ulint	page_no)/* in: page number */
+{
+	page_t*	page;
+	mtr_t	mtr;
+
+	mtr_start(&mtr);
+
+	page = buf_page_get(space, page_no, RW_X_LATCH, &mtr);
+
+	buf_page_dbg_add_level(page, SYNC_NO_ORDER_CHECK);
+
+	recv_recover_page(FALSE, FALSE, page, space, page_no);
+
+	mtr_commit(&mtr);
+}
+
+/***********************************************************************
+Applies the hashed log records to the pages in one partition of the hash
+table. The partition consists of the hash cells whose number modulo
+n_parts is part. */
+static
+void
+recv_apply_partition(
+/*=================*/
+	ulint	part,	/* in: partition number */
+	ulint	n_parts)/* in: number of partitions */
+{
+	recv_addr_t*	recv_addr;
+	ulint		page_nos[RECV_READ_AHEAD_AREA];
+	ulint		space;
+	ulint		page_no;
+	ulint		n;
+	ulint		i;
+	ulint		j;
+
+	for (i = part; i < hash_get_n_cells(recv_sys->addr_hash);
+							i += n_parts) {
+		
+		recv_addr = HASH_GET_FIRST(recv_sys->addr_hash, i);
+
+		while (recv_addr) {
+			space = recv_addr->space;
+			page_no = recv_addr->page_no;
+
+			/* The state is read without the mutex: the
+			state change is checked again under it */
+
+			if (recv_addr->state == RECV_NOT_PROCESSED) {
+
+				if (buf_page_peek(space, page_no)) {
+
+					recv_apply_to_page(space, page_no);
+				} else {
+					/* Start the reads of the whole
+					area, then apply the records to the
+					pages as they arrive */
+
+					n = recv_read_in_area(space, page_no,
+								page_nos);
+					for (j = 0; j < n; j++) {
+						recv_apply_to_page(space,
+								page_nos[j]);
+					}
+				}
+			}
+
+			recv_addr = HASH_GET_NEXT(addr_hash, recv_addr);
+		}
+	}
+}
+
+/***********************************************************************
+A thread which applies the hashed log records in one partition of the
+hash table. */
+static
+
+#ifndef __WIN__
+void*
+#else
+ulint
+#endif
+recv_apply_thread(
+/*==============*/
+	void*	arg)	/* in: pointer to the partition number */
+{
+	recv_apply_partition(*((ulint*)arg), recv_sys->n_apply_threads);
+
+	mutex_enter(&(recv_sys->mutex));
+
+	recv_sys->n_apply_threads_active--;
+
+	mutex_exit(&(recv_sys->mutex));
+
+	os_thread_exit(NULL);
+
+#ifndef __WIN__
+	return(NULL);
+#else
+	return(0);
+#endif
+}
 			
 /***********************************************************************
 Empties the hash table of stored log records, applying them to appropriate
-pages. */
+pages. The hash table is split into srv_n_recovery_threads partitions by
+the page address, and each partition is applied by its own thread. */
 
 void
 recv_apply_hashed_log_recs(
@@ -1223,14 +1352,14 @@ recv_apply_hashed_log_recs(
 				the caller must in this case own the log
 				mutex */
 {
-	recv_addr_t* recv_addr;
-	page_t*	page;
-	ulint	i;
-	ulint	space;
-	ulint	page_no;
-	ulint	n_pages;
-	ibool	has_printed	= FALSE;
-	mtr_t	mtr;
+	ulint		parts[RECV_MAX_APPLY_THREADS];
+	os_thread_id_t	thread_id;
+	ulint		n_total;
+	ulint		percent;
+	ulint		printed_percent	= 0;
+	ulint		n_pages;
+	ulint		i;
+	ibool		has_printed	= FALSE;
 loop:
 	mutex_enter(&(recv_sys->mutex));
 
@@ -1254,67 +1383,55 @@ loop:
 	recv_sys->apply_log_recs = TRUE;
 	recv_sys->apply_batch_on = TRUE;
 
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
-		
-		recv_addr = HASH_GET_FIRST(recv_sys->addr_hash, i);
-
-		while (recv_addr) {
-			space = recv_addr->space;
-			page_no = recv_addr->page_no;
+	n_total = recv_sys->n_addrs;
 
-			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
-	    				ut_print_timestamp(stderr);
-					fprintf(stderr, 
+	if (n_total > 0) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, 
 "  InnoDB: Starting an apply batch of log records to the database...\n"
 "InnoDB: Progress in percents: ");
-					has_printed = TRUE;
-				}
-				
-				mutex_exit(&(recv_sys->mutex));
+		has_printed = TRUE;
+	}
 
-				if (buf_page_peek(space, page_no)) {
+	recv_sys->n_apply_threads = ut_min(ut_max(srv_n_recovery_threads, 1),
+						RECV_MAX_APPLY_THREADS);
+	recv_sys->n_apply_threads_active = recv_sys->n_apply_threads;
 
-					mtr_start(&mtr);
+	mutex_exit(&(recv_sys->mutex));
 
-					page = buf_page_get(space, page_no,
-							RW_X_LATCH, &mtr);
+	for (i = 0; i < recv_sys->n_apply_threads; i++) {
+		parts[i] = i;
 
-					buf_page_dbg_add_level(page,
-							SYNC_NO_ORDER_CHECK);
-					recv_recover_page(FALSE, FALSE, page,
-							space, page_no);
-					mtr_commit(&mtr);
-				} else {
-					recv_read_in_area(space, page_no);
-				}
+		os_thread_create(recv_apply_thread, parts + i, &thread_id);
+	}
 
-				mutex_enter(&(recv_sys->mutex));
-			}
+	/* Wait until all the pages have been processed; a batch can be
+	small if the hash table filled up during the log scan, so poll
+	often */
 
-			recv_addr = HASH_GET_NEXT(addr_hash, recv_addr);
-		}
+	mutex_enter(&(recv_sys->mutex));
 
-		if (has_printed
-		    && (i * 100) / hash_get_n_cells(recv_sys->addr_hash)
-		    != ((i + 1) * 100)
-		             / hash_get_n_cells(recv_sys->addr_hash)) {
+	while (recv_sys->n_apply_threads_active > 0
+	       || recv_sys->n_addrs != 0) {
 
-		        fprintf(stderr, "%lu ",
-			  (i * 100) / hash_get_n_cells(recv_sys->addr_hash));
+		mutex_exit(&(recv_sys->mutex));
 
-		}
-	}
+		os_thread_sleep(10000);
+
+		mutex_enter(&(recv_sys->mutex));
 
-	/* Wait until all the pages have been processed */
+		if (!has_printed) {
 
-	while (recv_sys->n_addrs != 0) {
+			continue;
+		}
 
-		mutex_exit(&(recv_sys->mutex));
+		percent = ((n_total - recv_sys->n_addrs) * 100) / n_total;
 
-		os_thread_sleep(500000);
+		if (percent != printed_percent) {
+			fprintf(stderr, "%lu ", percent);
 
-		mutex_enter(&(recv_sys->mutex));
+			printed_percent = percent;
+		}
 	}	
 
 	if (has_printed) {
@@ -1380,7 +1497,7 @@ recv_apply_log_recs_for_backup(
 	recv_sys->apply_log_recs = TRUE;
 	recv_sys->apply_batch_on = TRUE;
 
-	page = buf_pool->frame_zero;
+	page = buf_pool_frame_zero;
 	
 	for (i = 0; i < n_data_files; i++) {
 		n_pages_total += file_sizes[i];
@@ -1560,13 +1677,16 @@ recv_compare_replicate(
 {
 	page_t*	replica;
 	page_t*	page;
+	buf_pool_t*	buf_pool;
 	mtr_t	mtr;
 
 	mtr_start(&mtr);
 
+	buf_pool = buf_pool_get(space, page_no);
+
 	mutex_enter(&(buf_pool->mutex));
 
-	page = buf_page_hash_get(space, page_no)->frame;
+	page = buf_page_hash_get(buf_pool, space, page_no)->frame;
 
 	mutex_exit(&(buf_pool->mutex));
 
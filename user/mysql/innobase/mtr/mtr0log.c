@@ -55,7 +55,7 @@ mlog_write_initial_log_record(
 
 	ut_ad(type <= MLOG_BIGGEST_TYPE);
 
-	if (ptr < buf_pool->frame_zero || ptr >= buf_pool->high_end) {
+	if (ptr < buf_pool_frame_zero || ptr >= buf_pool_high_end) {
 		fprintf(stderr,
 	"InnoDB: Error: trying to write to a stray memory location %lx\n",
 			(ulint)ptr);
@@ -218,7 +218,7 @@ mlog_write_ulint(
 {
 	byte*	log_ptr;
 	
-	if (ptr < buf_pool->frame_zero || ptr >= buf_pool->high_end) {
+	if (ptr < buf_pool_frame_zero || ptr >= buf_pool_high_end) {
 		fprintf(stderr,
 	"InnoDB: Error: trying to write to a stray memory location %lx\n",
 			(ulint)ptr);
@@ -266,7 +266,7 @@ mlog_write_dulint(
 {
 	byte*	log_ptr;
 
-	if (ptr < buf_pool->frame_zero || ptr >= buf_pool->high_end) {
+	if (ptr < buf_pool_frame_zero || ptr >= buf_pool_high_end) {
 		fprintf(stderr,
 	"InnoDB: Error: trying to write to a stray memory location %lx\n",
 			(ulint)ptr);
@@ -310,7 +310,7 @@ mlog_write_string(
 {
 	byte*	log_ptr;
 
-	if (ptr < buf_pool->frame_zero || ptr >= buf_pool->high_end) {
+	if (ptr < buf_pool_frame_zero || ptr >= buf_pool_high_end) {
 		fprintf(stderr,
 	"InnoDB: Error: trying to write to a stray memory location %lx\n",
 			(ulint)ptr);
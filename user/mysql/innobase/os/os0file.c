@@ -13,9 +13,23 @@ Created 10/21/1995 Heikki Tuuri
 #include "srv0srv.h"
 #include "fil0fil.h"
 #include "buf0buf.h"
+#include "srv0start.h"
 
 #undef HAVE_FDATASYNC
 
+#ifdef LINUX_NATIVE_AIO
+#include <linux/aio_abi.h>
+
+/* How long an i/o-handler thread waits in io_getevents() before it
+checks if the server is shutting down */
+#define OS_AIO_LINUX_WAIT_NSEC	500000000
+
+/* How many times we retry io_submit() if the kernel has no free
+resources for a new request, and how long we sleep before a retry */
+#define OS_AIO_LINUX_SUBMIT_RETRIES	100
+#define OS_AIO_LINUX_SUBMIT_SLEEP	10000
+#endif
+
 #ifdef POSIX_ASYNC_IO
 /* We assume in this case that the OS has standard Posix aio (at least SunOS
 2.6, HP-UX 11i and AIX 4.3 have) */
@@ -70,11 +84,12 @@ struct os_aio_slot_struct{
 	ulint		offset_high;	/* 32 high bits of file offset */
 	os_file_t	file;		/* file where to read or write */
 	char*		name;		/* file name or path */
-	ibool		io_already_done;/* used only in simulated aio:
-					TRUE if the physical i/o already
-					made and only the slot message
-					needs to be passed to the caller
-					of os_aio_simulated_handle */
+	ibool		io_already_done;/* used in simulated and Linux
+					native aio: TRUE if the physical
+					i/o already made and only the slot
+					message needs to be passed to the
+					caller of os_aio_simulated_handle
+					or os_aio_linux_handle */
 	void*		message1;	/* message which is given by the */
 	void*		message2;	/* the requester of an aio operation
 					and which can be used to identify
@@ -85,6 +100,12 @@ struct os_aio_slot_struct{
 					OVERLAPPED struct */
 	OVERLAPPED	control;	/* Windows control block for the
 					aio request */
+#elif defined(LINUX_NATIVE_AIO)
+	struct iocb	control;	/* Linux control block for aio
+					request */
+	long		n_bytes;	/* number of bytes transferred,
+					or -errno if the i/o failed; set
+					when we get the completion event */
 #elif defined(POSIX_ASYNC_IO)
 	struct aiocb	control;	/* Posix control block for aio
 					request */
@@ -118,6 +139,17 @@ struct os_aio_array_struct{
 				  in WaitForMultipleObjects; used only in
 				  Windows */
 #endif
+#ifdef LINUX_NATIVE_AIO
+	aio_context_t*	aio_ctx;  /* Linux io contexts, one for each
+				  segment, so that the i/o-handler thread
+				  of a segment only gets the completion
+				  events of its own slots; NULL if native
+				  aio is not used with this array */
+	struct io_event* aio_events;
+				  /* Buffer for the completion events, one
+				  for each slot; the i/o-handler thread of
+				  a segment uses the part at its slots */
+#endif
 };
 
 /* Array of events used in simulated aio */
@@ -1535,6 +1567,10 @@ os_aio_array_create(
 #ifdef __WIN__
 	array->native_events	= ut_malloc(n * sizeof(os_native_event_t));
 #endif	
+#ifdef LINUX_NATIVE_AIO
+	array->aio_ctx		= NULL;
+	array->aio_events	= NULL;
+#endif
 	for (i = 0; i < n; i++) {
 		slot = os_aio_array_get_nth_slot(array, i);
 
@@ -1554,6 +1590,82 @@ os_aio_array_create(
 	return(array);
 }
 
+#ifdef LINUX_NATIVE_AIO
+/****************************************************************************
+Creates the Linux io contexts for the segments of an aio array. */
+static
+ibool
+os_aio_linux_array_init(
+/*====================*/
+				/* out: TRUE if success, FALSE if the kernel
+				does not support native aio or has not
+				enough resources for it */
+	os_aio_array_t*	array)	/* in: aio array */
+{
+	ulint	n_per_seg;
+	ulint	i;
+
+	n_per_seg = array->n_slots / array->n_segments;
+
+	array->aio_ctx = ut_malloc(array->n_segments * sizeof(aio_context_t));
+	array->aio_events = ut_malloc(array->n_slots
+						* sizeof(struct io_event));
+
+	memset(array->aio_ctx, 0, array->n_segments * sizeof(aio_context_t));
+
+	for (i = 0; i < array->n_segments; i++) {
+		if (0 != syscall(__NR_io_setup, (unsigned) n_per_seg,
+						array->aio_ctx + i)) {
+			fprintf(stderr,
+"InnoDB: Warning: io_setup() failed with OS error number %lu.\n"
+"InnoDB: Linux native aio is not available, using simulated aio.\n",
+				(ulint) errno);
+
+			while (i > 0) {
+				i--;
+				syscall(__NR_io_destroy, array->aio_ctx[i]);
+			}
+
+			ut_free(array->aio_ctx);
+			ut_free(array->aio_events);
+
+			array->aio_ctx = NULL;
+			array->aio_events = NULL;
+
+			return(FALSE);
+		}
+	}
+
+	return(TRUE);
+}
+
+/****************************************************************************
+Frees the Linux io contexts of an aio array. */
+static
+void
+os_aio_linux_array_free(
+/*====================*/
+	os_aio_array_t*	array)	/* in: aio array */
+{
+	ulint	i;
+
+	if (array->aio_ctx == NULL) {
+
+		return;
+	}
+
+	for (i = 0; i < array->n_segments; i++) {
+		syscall(__NR_io_destroy, array->aio_ctx[i]);
+	}
+
+	ut_free(array->aio_ctx);
+	ut_free(array->aio_events);
+
+	array->aio_ctx = NULL;
+	array->aio_events = NULL;
+}
+#endif
+
 /****************************************************************************
 Initializes the asynchronous io system. Calls also os_io_init_simple.
 Creates a separate aio array for
@@ -1619,6 +1731,25 @@ os_aio_init(
 
 	os_aio_n_segments = n_segments;
 
+#ifdef LINUX_NATIVE_AIO
+	/* The sync array needs no io context: synchronous i/o is done
+	with os_file_read and os_file_write in os_aio */
+
+	if (os_aio_use_native_aio
+	    && !(os_aio_linux_array_init(os_aio_ibuf_array)
+		 && os_aio_linux_array_init(os_aio_log_array)
+		 && os_aio_linux_array_init(os_aio_read_array)
+		 && os_aio_linux_array_init(os_aio_write_array))) {
+
+		os_aio_linux_array_free(os_aio_ibuf_array);
+		os_aio_linux_array_free(os_aio_log_array);
+		os_aio_linux_array_free(os_aio_read_array);
+		os_aio_linux_array_free(os_aio_write_array);
+
+		os_aio_use_native_aio = FALSE;
+	}
+#endif
+
 	os_aio_validate();
 
 	os_aio_segment_wait_events = ut_malloc(n_segments * sizeof(void*));
@@ -1864,6 +1995,8 @@ os_aio_array_reserve_slot(
 #ifdef WIN_ASYNC_IO
 	OVERLAPPED*	control;
 
+#elif defined(LINUX_NATIVE_AIO)
+	struct iocb*	control;
 #elif defined(POSIX_ASYNC_IO)
 
 	struct aiocb*	control;
@@ -1924,6 +2057,21 @@ loop:
 	control->OffsetHigh = (DWORD)offset_high;
 	os_event_reset(slot->event);
 
+#elif defined(LINUX_NATIVE_AIO)
+
+	control = &(slot->control);
+	memset(control, 0, sizeof(struct iocb));
+
+	control->aio_fildes = file;
+	control->aio_lio_opcode = type == OS_FILE_READ
+					? IOCB_CMD_PREAD : IOCB_CMD_PWRITE;
+	control->aio_buf = (ulint) buf;
+	control->aio_nbytes = len;
+	control->aio_offset = ((ib_longlong) offset_high << 32) + offset;
+	control->aio_data = (ulint) slot;
+
+	slot->n_bytes = 0;
+
 #elif defined(POSIX_ASYNC_IO)
 
 #if (UNIV_WORD_SIZE == 8)
@@ -2074,6 +2222,55 @@ os_aio_simulated_put_read_threads_to_sleep(void)
 	}
 }
 
+#ifdef LINUX_NATIVE_AIO
+/***********************************************************************
+Submits an aio request of a reserved slot to the Linux io context of
+the segment of the slot. */
+static
+ulint
+os_aio_linux_submit(
+/*================*/
+				/* out: 0 if the request was queued
+				successfully, else 1 and errno is set */
+	os_aio_array_t*	array,	/* in: aio array */
+	os_aio_slot_t*	slot)	/* in: reserved slot */
+{
+	struct iocb*	iocbs[1];
+	ulint		segment;
+	ulint		n_retries	= 0;
+	long		ret;
+
+	segment = slot->pos / (array->n_slots / array->n_segments);
+
+	iocbs[0] = &(slot->control);
+retry:
+	ret = syscall(__NR_io_submit, array->aio_ctx[segment], 1L, iocbs);
+
+	if (ret == 1) {
+
+		return(0);
+	}
+
+	if (ret < 0 && errno == EAGAIN
+	    && n_retries < OS_AIO_LINUX_SUBMIT_RETRIES) {
+		/* The kernel is out of aio resources: wait until some of
+		the pending requests have completed */
+
+		n_retries++;
+
+		os_thread_sleep(OS_AIO_LINUX_SUBMIT_SLEEP);
+
+		goto retry;
+	}
+
+	if (ret == 0) {
+		errno = EAGAIN;
+	}
+
+	return(1);
+}
+#endif
+
 /***********************************************************************
 Requests an asynchronous i/o operation. */
 
@@ -2193,6 +2390,11 @@ try_again:
 			
 			ret = ReadFile(file, buf, (DWORD)n, &len,
 							&(slot->control));
+#elif defined(LINUX_NATIVE_AIO)
+			os_n_file_reads++;
+			os_bytes_read_since_printout += n;
+
+			err = os_aio_linux_submit(array, slot);
 #elif defined(POSIX_ASYNC_IO)
 			slot->control.aio_lio_opcode = LIO_READ;
 			err = (ulint) aio_read(&(slot->control));
@@ -2210,6 +2412,10 @@ try_again:
 			os_n_file_writes++;
 			ret = WriteFile(file, buf, (DWORD)n, &len,
 							&(slot->control));
+#elif defined(LINUX_NATIVE_AIO)
+			os_n_file_writes++;
+
+			err = os_aio_linux_submit(array, slot);
 #elif defined(POSIX_ASYNC_IO)
 			slot->control.aio_lio_opcode = LIO_WRITE;
 			err = (ulint) aio_write(&(slot->control));
@@ -2370,6 +2576,185 @@ os_aio_windows_handle(
 }
 #endif
 
+#ifdef LINUX_NATIVE_AIO
+/**************************************************************************
+Finishes an i/o whose completion event we have got in Linux native aio:
+does the rest of a partial read or write synchronously, and flushes the
+file after a write if needed. */
+static
+ibool
+os_aio_linux_complete(
+/*==================*/
+				/* out: TRUE if the i/o succeeded */
+	os_aio_slot_t*	slot)	/* in: slot whose i/o has completed */
+{
+	ib_longlong	offset;
+	ibool		ret;
+
+	if (slot->n_bytes < 0) {
+		errno = (int) -slot->n_bytes;
+
+		os_file_handle_error(slot->file, slot->name,
+			slot->type == OS_FILE_READ ? "aio read" : "aio write");
+		return(FALSE);
+	}
+
+	ret = TRUE;
+
+	if ((ulint) slot->n_bytes < slot->len) {
+		/* The kernel did only a part of the i/o, for example
+		because of a signal: do the rest with ordinary i/o */
+
+		offset = ((ib_longlong) slot->offset_high << 32)
+					+ slot->offset + slot->n_bytes;
+
+		if (slot->type == OS_FILE_READ) {
+			ret = os_file_read(slot->file,
+				slot->buf + slot->n_bytes,
+				(ulint) (offset & 0xFFFFFFFF),
+				(ulint) (offset >> 32),
+				slot->len - slot->n_bytes);
+		} else {
+			ret = os_file_write(slot->name, slot->file,
+				slot->buf + slot->n_bytes,
+				(ulint) (offset & 0xFFFFFFFF),
+				(ulint) (offset >> 32),
+				slot->len - slot->n_bytes);
+		}
+	} else if (slot->type == OS_FILE_WRITE
+		   && !os_do_not_call_flush_at_each_write) {
+
+		ret = os_file_flush(slot->file);
+	}
+
+	return(ret);
+}
+
+/**************************************************************************
+This function is only used in Linux native asynchronous i/o.
+Waits for an aio operation to complete in a segment of an aio array.
+The i/o-handler thread of the segment gets the completion events from
+the io context of the segment, and returns the slots one at a time.
+NOTE: this function will also take care of freeing the aio slot,
+therefore no other thread is allowed to do the freeing! */
+
+ibool
+os_aio_linux_handle(
+/*================*/
+				/* out: TRUE if the aio operation succeeded */
+	ulint	global_segment,	/* in: the number of the segment in the aio
+				arrays to wait for; segment 0 is the ibuf
+				i/o thread, segment 1 the log i/o thread,
+				then follow the non-ibuf read threads, and as
+				the last are the non-ibuf write threads */
+	void**	message1,	/* out: the messages passed with the aio
+				request; note that also in the case where
+				the aio operation failed, these output
+				parameters are valid and can be used to
+				restart the operation, for example */
+	void**	message2,
+	ulint*	type)		/* out: OS_FILE_WRITE or ..._READ */
+{
+	os_aio_array_t*		array;
+	os_aio_slot_t*		slot;
+	struct io_event*	events;
+	struct timespec		timeout;
+	ulint			segment;
+	ulint			n;
+	ulint			i;
+	long			n_events;
+	ibool			ret;
+
+	segment = os_aio_get_array_and_local_segment(&array, global_segment);
+
+	/* NOTE! We only access constant fields in os_aio_array. Therefore
+	we do not have to acquire the protecting mutex yet */
+
+	ut_ad(os_aio_validate());
+	ut_ad(segment < array->n_segments);
+	ut_a(array->aio_ctx);
+
+	n = array->n_slots / array->n_segments;
+
+	events = array->aio_events + segment * n;
+
+	for (;;) {
+		/* Check if there is a slot for which we have already got
+		the completion event */
+
+		os_mutex_enter(array->mutex);
+
+		for (i = 0; i < n; i++) {
+			slot = os_aio_array_get_nth_slot(array,
+							i + segment * n);
+
+			if (slot->reserved && slot->io_already_done) {
+
+				goto slot_io_done;
+			}
+		}
+
+		os_mutex_exit(array->mutex);
+
+		srv_io_thread_op_info[global_segment] =
+				(char*) "waiting for completed aio requests";
+
+		timeout.tv_sec = 0;
+		timeout.tv_nsec = OS_AIO_LINUX_WAIT_NSEC;
+
+		n_events = syscall(__NR_io_getevents, array->aio_ctx[segment],
+						1L, (long) n, events, &timeout);
+
+		if (srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS) {
+
+			os_thread_exit(NULL);
+		}
+
+		if (n_events < 0) {
+			if (errno == EINTR) {
+
+				continue;
+			}
+
+			ut_print_timestamp(stderr);
+			fprintf(stderr,
+"  InnoDB: Error: io_getevents() failed with OS error number %lu\n",
+				(ulint) errno);
+			ut_error;
+		}
+
+		os_mutex_enter(array->mutex);
+
+		for (i = 0; i < (ulint) n_events; i++) {
+			slot = (os_aio_slot_t*) (ulint) events[i].data;
+
+			ut_a(slot->reserved);
+
+			slot->n_bytes = (long) events[i].res;
+			slot->io_already_done = TRUE;
+		}
+
+		os_mutex_exit(array->mutex);
+	}
+
+slot_io_done:
+	*message1 = slot->message1;
+	*message2 = slot->message2;
+
+	*type = slot->type;
+
+	os_mutex_exit(array->mutex);
+
+	srv_io_thread_op_info[global_segment] = (char*) "complete aio request";
+
+	ret = os_aio_linux_complete(slot);
+
+	os_aio_array_free_slot(array, slot);
+
+	return(ret);
+}
+#endif
+
 #ifdef POSIX_ASYNC_IO
 
 /**************************************************************************
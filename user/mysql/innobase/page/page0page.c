@@ -17,6 +17,7 @@ Created 2/2/1994 Heikki Tuuri
 #include "lock0lock.h"
 #include "fut0lst.h"
 #include "btr0sea.h"
+#include "btr0btr.h"
 #include "buf0buf.h"
 
 /* A cached template page used in page_create */
@@ -171,14 +172,17 @@ page_set_max_trx_id(
 	page_t*	page,	/* in: page */
 	dulint	trx_id)	/* in: transaction id */
 {
-	buf_block_t*	block;
+	buf_block_t*		block;
+	btr_search_part_t*	part	= NULL;
 
 	ut_ad(page);
 
 	block = buf_block_align(page);
 
 	if (block->is_hashed) {
-		rw_lock_x_lock(&btr_search_latch);
+		part = btr_search_get_part(btr_page_get_index_id(page));
+
+		btr_search_x_lock(part);
 	}
 
 	/* It is not necessary to write this change to the redo log, as
@@ -187,8 +191,8 @@ page_set_max_trx_id(
 	
 	mach_write_to_8(page + PAGE_HEADER + PAGE_MAX_TRX_ID, trx_id);
 
-	if (block->is_hashed) {
-		rw_lock_x_unlock(&btr_search_latch);
+	if (part) {
+		rw_lock_x_unlock(&(part->latch));
 	}
 }
 
@@ -934,7 +934,8 @@ row_sel_try_search_shortcut(
 	ut_ad(node->read_view);
 	ut_ad(plan->unique_search);
 	ut_ad(!plan->must_get_clust);
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
+	ut_ad(rw_lock_own(btr_search_get_latch(index->tree->id),
+							RW_LOCK_SHARED));
 	
 	row_sel_open_pcur(node, plan, TRUE, mtr);
 
@@ -1010,6 +1011,11 @@ row_sel(
 	rec_t*		old_vers;
 	rec_t*		clust_rec;
 	ibool		search_latch_locked;
+	rw_lock_t*	search_latch	= NULL;
+					/* if search_latch_locked, the
+					latch of the adaptive hash index
+					part we have s-locked */
+	btr_search_part_t* part;
 	ibool		consistent_read;
 	
 		/* The following flag becomes TRUE when we are doing a
@@ -1090,11 +1096,23 @@ table_loop:
 
 	if (consistent_read && plan->unique_search && !plan->pcur_is_open
 						&& !plan->must_get_clust) {
+		part = btr_search_get_part(plan->index->tree->id);
+
+		if (search_latch_locked && search_latch != &(part->latch)) {
+			/* The index of this table is hashed in another
+			part: a thread never holds two of the latches */
+
+			rw_lock_s_unlock(search_latch);
+
+			search_latch_locked = FALSE;
+		}
+
 		if (!search_latch_locked) {
-			rw_lock_s_lock(&btr_search_latch);
+			btr_search_s_lock(part);
 
+			search_latch = &(part->latch);
 			search_latch_locked = TRUE;
-		} else if (btr_search_latch.writer_is_wait_ex) {
+		} else if (search_latch->writer_is_wait_ex) {
 
 			/* There is an x-latch request waiting: release the
 			s-latch for a moment; as an s-latch here is often
@@ -1103,8 +1121,8 @@ table_loop:
 			from acquiring an s-latch for a long time, lowering
 			performance significantly in multiprocessors. */
 
-			rw_lock_s_unlock(&btr_search_latch);
-			rw_lock_s_lock(&btr_search_latch);
+			rw_lock_s_unlock(search_latch);
+			rw_lock_s_lock(search_latch);
 		}
 
 		found_flag = row_sel_try_search_shortcut(node, plan, &mtr);
@@ -1127,7 +1145,7 @@ table_loop:
 	}
 
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(search_latch);
 
 		search_latch_locked = FALSE;
 	}
@@ -1533,7 +1551,7 @@ next_table_no_mtr:
 		thr->run_node = que_node_get_parent(node);
 
 		if (search_latch_locked) {
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(search_latch);
 		}
 		
 		return(DB_SUCCESS);
@@ -1579,7 +1597,7 @@ table_exhausted_no_mtr:
 			thr->run_node = que_node_get_parent(node);
 
 			if (search_latch_locked) {
-				rw_lock_s_unlock(&btr_search_latch);
+				rw_lock_s_unlock(search_latch);
 			}
 		
 			return(DB_SUCCESS);
@@ -1590,7 +1608,7 @@ table_exhausted_no_mtr:
 		thr->run_node = que_node_get_parent(node);
 
 		if (search_latch_locked) {
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(search_latch);
 		}
 		
 		return(DB_SUCCESS);
@@ -2695,6 +2713,7 @@ row_search_for_mysql(
 	ulint		shortcut;
 	ibool		unique_search			= FALSE;
 	ibool		unique_search_from_clust_index	= FALSE;
+	btr_search_part_t* part;
 	ibool		mtr_has_extra_clust_latch 	= FALSE;
 	ibool		moves_up 			= FALSE;
 	ibool		set_also_gap_locks		= TRUE;
@@ -2731,15 +2750,14 @@ row_search_for_mysql(
 	adaptive hash index latch if there is someone waiting behind */
 
 	if (trx->has_search_latch
-	    && btr_search_latch.writer != RW_LOCK_NOT_LOCKED) {
+	    && trx->search_latch->writer != RW_LOCK_NOT_LOCKED) {
 
 		/* There is an x-latch request on the adaptive hash index:
 		release the s-latch to reduce starvation and wait for
 		BTR_SEA_TIMEOUT rounds before trying to keep it again over
 		calls from MySQL */
 
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = FALSE;
+		trx_search_latch_release_if_reserved(trx);
 
 		trx->search_latch_timeout = BTR_SEA_TIMEOUT;
 	}
@@ -2877,8 +2895,19 @@ row_search_for_mysql(
 			hash index semaphore! */
 
 #ifndef UNIV_SEARCH_DEBUG			
+			part = btr_search_get_part(index->tree->id);
+
+			if (trx->has_search_latch
+			    && trx->search_latch != &(part->latch)) {
+				/* We keep the latch of another part: a
+				thread never holds two of the latches */
+
+				trx_search_latch_release_if_reserved(trx);
+			}
+
 			if (!trx->has_search_latch) {
-				rw_lock_s_lock(&btr_search_latch);
+				btr_search_s_lock(part);
+				trx->search_latch = &(part->latch);
 				trx->has_search_latch = TRUE;
 			}
 #endif
@@ -2901,8 +2930,8 @@ row_search_for_mysql(
 
 					trx->search_latch_timeout--;
 
-			        	rw_lock_s_unlock(&btr_search_latch);
-					trx->has_search_latch = FALSE;
+					trx_search_latch_release_if_reserved(
+									trx);
 				}    	
 				
 				trx->op_info = (char *) "";
@@ -2924,8 +2953,8 @@ row_search_for_mysql(
 
 					trx->search_latch_timeout--;
 
-			        	rw_lock_s_unlock(&btr_search_latch);
-					trx->has_search_latch = FALSE;
+					trx_search_latch_release_if_reserved(
+									trx);
 				}
 
 				trx->op_info = (char *) "";
@@ -2944,10 +2973,7 @@ row_search_for_mysql(
 	/*-------------------------------------------------------------*/
 	/* PHASE 3: Open or restore index cursor position */
 
-	if (trx->has_search_latch) {
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = FALSE;
-	}			
+	trx_search_latch_release_if_reserved(trx);			
 
 	trx_start_if_not_started(trx);
 
@@ -143,11 +143,24 @@ byte	srv_latin1_ordering[256]	/* The sort order table of the latin1
 ulint	srv_pool_size		= ULINT_MAX;	/* size in database pages;
 						MySQL originally sets this
 						value in megabytes */ 
+ulint	srv_pool_zip_size	= 0;		/* size in bytes of the
+						compressed page cache */
+ulint	srv_buf_pool_instances	= 1;		/* number of buffer pool
+						instances */
+ulint	srv_adaptive_hash_index_parts = 8;	/* number of parts of the
+						adaptive hash index */
 ulint	srv_mem_pool_size	= ULINT_MAX;	/* size in bytes */ 
 ulint	srv_lock_table_size	= ULINT_MAX;
 
 ulint	srv_n_file_io_threads	= ULINT_MAX;
 
+/* Number of threads which apply the log records in crash recovery */
+ulint	srv_n_recovery_threads	= 4;
+
+/* If this is TRUE, we use the Linux native aio if InnoDB was compiled
+with it and the kernel supports it */
+ibool	srv_use_native_aio	= TRUE;
+
 ibool	srv_archive_recovery	= 0;
 dulint	srv_archive_recovery_limit_lsn;
 
@@ -2384,7 +2397,7 @@ srv_sprintf_innodb_monitor(
 	buf = buf + strlen(buf);
 	ut_a(buf < buf_end + 1500);
 
-	ha_print_info(buf, buf_end, btr_search_sys->hash_index);
+	btr_search_sys_print(buf, buf_end);
 	buf = buf + strlen(buf);
 	ut_a(buf < buf_end + 1500);
 
@@ -2815,8 +2828,7 @@ loop:
 
 	srv_main_thread_op_info = (char*) "reserving kernel mutex";
 
-	n_ios_very_old = log_sys->n_log_ios + buf_pool->n_pages_read
-						+ buf_pool->n_pages_written;
+	n_ios_very_old = log_sys->n_log_ios + buf_get_n_page_ios();
 	mutex_enter(&kernel_mutex);
 
 	/* Store the user activity counter at the start of this loop */
@@ -2835,8 +2847,7 @@ loop:
 	skip_sleep = FALSE;
 
 	for (i = 0; i < 10; i++) {
-		n_ios_old = log_sys->n_log_ios + buf_pool->n_pages_read
-						+ buf_pool->n_pages_written;
+		n_ios_old = log_sys->n_log_ios + buf_get_n_page_ios();
 		srv_main_thread_op_info = (char*)"sleeping";
 		
 		if (!skip_sleep) {
@@ -2876,8 +2887,7 @@ loop:
 
 		n_pend_ios = buf_get_n_pending_ios()
 						+ log_sys->n_pending_writes;
-		n_ios = log_sys->n_log_ios + buf_pool->n_pages_read
-						+ buf_pool->n_pages_written;
+		n_ios = log_sys->n_log_ios + buf_get_n_page_ios();
 		if (n_pend_ios < 3 && (n_ios - n_ios_old < 5)) {
 			srv_main_thread_op_info =
 					(char*)"doing insert buffer merge";
@@ -2927,8 +2937,7 @@ loop:
 	makes sense to flush 100 pages. */
 
 	n_pend_ios = buf_get_n_pending_ios() + log_sys->n_pending_writes;
-	n_ios = log_sys->n_log_ios + buf_pool->n_pages_read
-						+ buf_pool->n_pages_written;
+	n_ios = log_sys->n_log_ios + buf_get_n_page_ios();
 	if (n_pend_ios < 3 && (n_ios - n_ios_very_old < 200)) {
 
 		srv_main_thread_op_info = (char*) "flushing buffer pool pages";
@@ -17,6 +17,7 @@ Created 2/16/1996 Heikki Tuuri
 #include "buf0buf.h"
 #include "buf0flu.h"
 #include "buf0rea.h"
+#include "buf0zip.h"
 #include "os0file.h"
 #include "os0thread.h"
 #include "fil0fil.h"
@@ -910,7 +911,7 @@ test_measure_cont(
 			kcount++;
 		    }
 
-		    if (buf_pool->mutex.lock_word) {
+		    if (buf_pools[0]->mutex.lock_word) {
 		    	pcount++;
 		    }
 
@@ -918,15 +919,15 @@ test_measure_cont(
 		    	lcount++;
 		    }
 
-		    if (btr_search_latch.reader_count) {
+		    if (btr_search_sys->parts[0].latch.reader_count) {
 		    	s_scount++;
 		    }
 
-		    if (btr_search_latch.writer != RW_LOCK_NOT_LOCKED) {
+		    if (btr_search_sys->parts[0].latch.writer != RW_LOCK_NOT_LOCKED) {
 		    	s_xcount++;
 		    }
 
-		    if (btr_search_latch.mutex.lock_word) {
+		    if (btr_search_sys->parts[0].latch.mutex.lock_word) {
 		    	s_mcount++;
 		    }
 		}
@@ -1040,6 +1041,12 @@ innobase_start_or_create_for_mysql(void)
 	  	os_aio_use_native_aio = TRUE;
 	}
 #endif	
+#ifdef LINUX_NATIVE_AIO
+	/* os_aio_init falls back to simulated aio if the kernel does not
+	support native aio */
+
+	os_aio_use_native_aio = srv_use_native_aio;
+#endif
         if (srv_file_flush_method_str == NULL) {
         	/* These are the default options */
 
@@ -1118,7 +1125,9 @@ innobase_start_or_create_for_mysql(void)
 	
 	fil_init(SRV_MAX_N_OPEN_FILES);
 
-	buf_pool_init(srv_pool_size, srv_pool_size);
+	buf_pool_init(srv_pool_size, srv_pool_size,
+						srv_buf_pool_instances);
+	buf_zip_init(srv_pool_zip_size);
 
 	fsp_init();
 	log_init();
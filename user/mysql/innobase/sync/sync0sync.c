@@ -1022,6 +1022,8 @@ sync_thread_add_level(
 		     || sync_thread_levels_g(array, SYNC_BUF_BLOCK));
 	} else if (level == SYNC_BUF_POOL) {
 		ut_a(sync_thread_levels_g(array, SYNC_BUF_POOL));
+	} else if (level == SYNC_BUF_ZIP) {
+		ut_a(sync_thread_levels_g(array, SYNC_BUF_ZIP));
 	} else if (level == SYNC_SEARCH_SYS) {
 		ut_a(sync_thread_levels_g(array, SYNC_SEARCH_SYS));
 	} else if (level == SYNC_TRX_LOCK_HEAP) {
@@ -143,6 +143,7 @@ trx_create(
 
 	trx->dict_operation_lock_mode = 0;
 	trx->has_search_latch = FALSE;
+	trx->search_latch = NULL;
 	trx->search_latch_timeout = BTR_SEA_TIMEOUT;
 
 	trx->declared_to_be_inside_innodb = FALSE;
@@ -225,9 +226,10 @@ trx_search_latch_release_if_reserved(
         trx_t*     trx) /* in: transaction */
 {
   	if (trx->has_search_latch) {
-    		rw_lock_s_unlock(&btr_search_latch);
+    		rw_lock_s_unlock(trx->search_latch);
 
     		trx->has_search_latch = FALSE;
+		trx->search_latch = NULL;
   	}
 }
 
@@ -1516,21 +1518,14 @@ trx_commit_for_mysql(
 }
 
 /**************************************************************************
-If required, flushes the log to disk if we called trx_commit_for_mysql()
-with trx->flush_log_later == TRUE. */
-
-ulint
-trx_commit_complete_for_mysql(
-/*==========================*/
-			/* out: 0 or error number */
-	trx_t*	trx)	/* in: trx handle */
+Writes the log up to lsn, and flushes it to disk, as required by
+srv_flush_log_at_trx_commit. */
+static
+void
+trx_flush_log_for_mysql(
+/*====================*/
+	dulint	lsn)	/* in: lsn up to which the log must be written */
 {
-        dulint  lsn     = trx->commit_lsn;
-
-        ut_a(trx);
-	
-	trx->op_info = (char*)"flushing log";
-
         if (srv_flush_log_at_trx_commit == 0) {
                 /* Do nothing */
         } else if (srv_flush_log_at_trx_commit == 1) {
@@ -1552,12 +1547,44 @@ trx_commit_complete_for_mysql(
         } else {
                 ut_a(0);
         }
+}
+
+/**************************************************************************
+If required, flushes the log to disk if we called trx_commit_for_mysql()
+with trx->flush_log_later == TRUE. */
+
+ulint
+trx_commit_complete_for_mysql(
+/*==========================*/
+			/* out: 0 or error number */
+	trx_t*	trx)	/* in: trx handle */
+{
+        ut_a(trx);
+	
+	trx->op_info = (char*)"flushing log";
+
+	trx_flush_log_for_mysql(trx->commit_lsn);
 
 	trx->op_info = (char*)"";
 
         return(0);
 }
 
+/**************************************************************************
+Like trx_commit_complete_for_mysql(), but for all transactions committed
+so far with trx->flush_log_later == TRUE: writes, and if required flushes,
+the log up to its current end. Used by the binlog group commit, so that a
+group of transactions is made durable with one log write. The
+trx_commit_complete_for_mysql() calls of the transactions of the group
+then find their commit lsn already flushed. */
+
+void
+trx_commit_complete_group_for_mysql(void)
+/*=====================================*/
+{
+	trx_flush_log_for_mysql(log_get_lsn());
+}
+
 /**************************************************************************
 Marks the latest SQL statement ended. */
 
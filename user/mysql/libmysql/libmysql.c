@@ -85,6 +85,8 @@ ulong		net_write_timeout= CLIENT_NET_WRITE_TIMEOUT;
 
 static MYSQL_DATA *read_rows (MYSQL *mysql,MYSQL_FIELD *fields,
 			      uint field_count);
+static MYSQL_DATA *read_binary_rows(MYSQL *mysql,MYSQL_FIELD *fields,
+				    uint field_count);
 static int read_one_row(MYSQL *mysql,uint fields,MYSQL_ROW row,
 			ulong *lengths);
 static void end_server(MYSQL *mysql);
@@ -92,6 +94,7 @@ static void read_user_name(char *name);
 static void append_wild(char *to,char *end,const char *wild);
 static my_bool mysql_reconnect(MYSQL *mysql);
 static int send_file_to_server(MYSQL *mysql,const char *filename);
+static MYSQL_RES *store_result(MYSQL *mysql, my_bool binary_rows);
 static sig_handler pipe_sig_handler(int sig);
 static ulong mysql_sub_escape_string(CHARSET_INFO *charset_info, char *to,
 				     const char *from, ulong length);
@@ -1087,6 +1090,165 @@ static MYSQL_DATA *read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
 }
 
 
+/*
+  Read all rows of the result of mysql_execute() from server
+
+  The rows are in the binary format: a 0 byte, a bitmap of NULL columns
+  and the non NULL columns. Numbers are converted to the format of the
+  host; other columns are as in read_rows(). Every column is followed
+  by a null byte, so that mysql_fetch_lengths() works.
+*/
+
+static MYSQL_DATA *read_binary_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
+				    uint fields)
+{
+  uint	field;
+  ulong pkt_len;
+  ulong len;
+  uchar *cp,*null_bits,*end;
+  char	*to;
+  MYSQL_DATA *result;
+  MYSQL_ROWS **prev_ptr,*cur;
+  NET *net = &mysql->net;
+  DBUG_ENTER("read_binary_rows");
+
+  if ((pkt_len= net_safe_read(mysql)) == packet_error)
+    DBUG_RETURN(0);
+  if (!(result=(MYSQL_DATA*) my_malloc(sizeof(MYSQL_DATA),
+				       MYF(MY_WME | MY_ZEROFILL))))
+  {
+    net->last_errno=CR_OUT_OF_MEMORY;
+    strmov(net->last_error,ER(net->last_errno));
+    DBUG_RETURN(0);
+  }
+  init_alloc_root(&result->alloc,8192,0);	/* Assume rowlength < 8192 */
+  result->alloc.min_malloc=sizeof(MYSQL_ROWS);
+  prev_ptr= &result->data;
+  result->rows=0;
+  result->fields=fields;
+
+  while (*(cp=net->read_pos) != 254 || pkt_len != 1)
+  {
+    result->rows++;
+    if (!(cur= (MYSQL_ROWS*) alloc_root(&result->alloc,
+					    sizeof(MYSQL_ROWS))) ||
+	!(cur->data= ((MYSQL_ROW)
+		      alloc_root(&result->alloc,
+				     (fields+1)*sizeof(char *)+pkt_len+
+				     fields))))
+    {
+      free_rows(result);
+      net->last_errno=CR_OUT_OF_MEMORY;
+      strmov(net->last_error,ER(net->last_errno));
+      DBUG_RETURN(0);
+    }
+    *prev_ptr=cur;
+    prev_ptr= &cur->next;
+    to= (char*) (cur->data+fields+1);
+    end=cp+pkt_len;
+    null_bits=cp+1;
+    cp=null_bits+(fields+7)/8;
+    if (cp > end)
+      goto malformed;
+    for (field=0 ; field < fields ; field++)
+    {
+      if (null_bits[field/8] & (1 << (field & 7)))
+      {
+	cur->data[field] = 0;
+	continue;
+      }
+      cur->data[field] = to;
+      switch (mysql_fields[field].type) {
+      case FIELD_TYPE_TINY:
+	len=1;
+	if (cp+len > end)
+	  goto malformed;
+	to[0]= (char) cp[0];
+	break;
+      case FIELD_TYPE_SHORT:
+      case FIELD_TYPE_YEAR:
+      {
+	short nr;
+	len=2;
+	if (cp+len > end)
+	  goto malformed;
+	nr=sint2korr(cp);
+	memcpy(to,(char*) &nr,len);
+	break;
+      }
+      case FIELD_TYPE_INT24:
+      case FIELD_TYPE_LONG:
+      {
+	int32 nr;
+	len=4;
+	if (cp+len > end)
+	  goto malformed;
+	nr=sint4korr(cp);
+	memcpy(to,(char*) &nr,len);
+	break;
+      }
+      case FIELD_TYPE_LONGLONG:
+      {
+	longlong nr;
+	len=8;
+	if (cp+len > end)
+	  goto malformed;
+	nr=sint8korr(cp);
+	memcpy(to,(char*) &nr,len);
+	break;
+      }
+      case FIELD_TYPE_FLOAT:
+      {
+	float nr;
+	len=4;
+	if (cp+len > end)
+	  goto malformed;
+	float4get(nr,cp);
+	memcpy(to,(char*) &nr,len);
+	break;
+      }
+      case FIELD_TYPE_DOUBLE:
+      {
+	double nr;
+	len=8;
+	if (cp+len > end)
+	  goto malformed;
+	float8get(nr,cp);
+	memcpy(to,(char*) &nr,len);
+	break;
+      }
+      default:
+	if (cp >= end ||
+	    (len=(ulong) net_field_length(&cp)) > (ulong) (end - cp))
+	  goto malformed;
+	memcpy(to,(char*) cp,len);
+	break;
+      }
+      to[len]=0;
+      to+=len+1;
+      cp+=len;
+      if (mysql_fields[field].max_length < len)
+	mysql_fields[field].max_length=len;
+    }
+    cur->data[field]=to;			/* End of last field */
+    if ((pkt_len=net_safe_read(mysql)) == packet_error)
+    {
+      free_rows(result);
+      DBUG_RETURN(0);
+    }
+  }
+  *prev_ptr=0;					/* last pointer is null */
+  DBUG_PRINT("exit",("Got %d rows",result->rows));
+  DBUG_RETURN(result);
+
+malformed:
+  free_rows(result);
+  net->last_errno=CR_MALFORMED_PACKET;
+  strmov(net->last_error,ER(net->last_errno));
+  DBUG_RETURN(0);
+}
+
+
 /*
   Read one row. Uses packet buffer as storage for fields.
   When next packet is read, the previous field values are destroyed
@@ -2476,11 +2638,16 @@ err:
 MYSQL_RES * STDCALL
 mysql_store_result(MYSQL *mysql)
 {
-  MYSQL_RES *result;
   DBUG_ENTER("mysql_store_result");
-
   /* read from the actually used connection */
-  mysql = mysql->last_used_con;
+  DBUG_RETURN(store_result(mysql->last_used_con,0));
+}
+
+
+static MYSQL_RES *store_result(MYSQL *mysql, my_bool binary_rows)
+{
+  MYSQL_RES *result;
+  DBUG_ENTER("store_result");
 
   if (!mysql->fields)
     DBUG_RETURN(0);
@@ -2502,7 +2669,10 @@ mysql_store_result(MYSQL *mysql)
   }
   result->eof=1;				/* Marker for buffered */
   result->lengths=(ulong*) (result+1);
-  if (!(result->data=read_rows(mysql,mysql->fields,mysql->field_count)))
+  if (!(result->data= (binary_rows ?
+			read_binary_rows(mysql,mysql->fields,
+					 mysql->field_count) :
+			read_rows(mysql,mysql->fields,mysql->field_count))))
   {
     my_free((gptr) result,MYF(0));
     DBUG_RETURN(0);
@@ -2568,6 +2738,186 @@ mysql_use_result(MYSQL *mysql)
 }
 
 
+/**************************************************************************
+  Prepare a statement on the server. The statement may have '?' markers
+  for parameters, that are given to mysql_execute().
+  Returns the id of the statement or 0 on error.
+**************************************************************************/
+
+unsigned long STDCALL
+mysql_prepare(MYSQL *mysql, const char *query, ulong length,
+	      uint *param_count)
+{
+  ulong pkt_len;
+  uchar *pos;
+  DBUG_ENTER("mysql_prepare");
+  DBUG_PRINT("query",("Query = '%-.4096s'",query));
+
+  mysql->last_used_con=mysql;
+  if (simple_command(mysql,COM_PREPARE,query,length,1) ||
+      (pkt_len=net_safe_read(mysql)) == packet_error)
+    DBUG_RETURN(0);
+  pos=(uchar*) mysql->net.read_pos;
+  if (pkt_len < 7 || pos[0] != 0)
+  {
+    mysql->net.last_errno=CR_MALFORMED_PACKET;
+    strmov(mysql->net.last_error,ER(mysql->net.last_errno));
+    DBUG_RETURN(0);
+  }
+  if (param_count)
+    *param_count=uint2korr(pos+5);
+  DBUG_RETURN((ulong) uint4korr(pos+1));
+}
+
+
+static char *store_param_length(char *pos, ulong length)
+{
+  if (length < 251)
+  {
+    *pos= (char) length;
+    return pos+1;
+  }
+  if (length < 65536L)
+  {
+    *pos= (char) 252;
+    int2store(pos+1,length);
+    return pos+3;
+  }
+  if (length < 16777216L)
+  {
+    *pos= (char) 253;
+    int3store(pos+1,length);
+    return pos+4;
+  }
+  *pos= (char) 254;
+  int4store(pos+1,length);
+  int4store(pos+5,0);
+  return pos+9;
+}
+
+
+/**************************************************************************
+  Execute a prepared statement. params has a value for each '?' of the
+  statement.
+  Returns the result set, with numbers in binary (see MYSQL_BIND), or 0
+  if there was an error or if the statement doesn't give a result set
+  (use mysql_errno() and mysql_affected_rows() as after
+  mysql_store_result()).
+**************************************************************************/
+
+MYSQL_RES * STDCALL
+mysql_execute(MYSQL *mysql, ulong stmt_id, MYSQL_BIND *params,
+	      uint param_count)
+{
+  char *buff,*null_bits,*types,*pos;
+  ulong length;
+  uint i;
+  int error;
+  DBUG_ENTER("mysql_execute");
+
+  length=4+(param_count+7)/8+param_count*2;
+  for (i=0 ; i < param_count ; i++)
+  {
+    if (!params[i].is_null)
+      length+=9+params[i].length;		/* Enough also for numbers */
+  }
+  if (!(buff=my_malloc(length,MYF(0))))
+  {
+    mysql->net.last_errno=CR_OUT_OF_MEMORY;
+    strmov(mysql->net.last_error,ER(mysql->net.last_errno));
+    DBUG_RETURN(0);
+  }
+  int4store(buff,stmt_id);
+  null_bits=buff+4;
+  bzero(null_bits,(param_count+7)/8);
+  types=null_bits+(param_count+7)/8;
+  pos=types+param_count*2;
+  for (i=0 ; i < param_count ; i++)
+  {
+    MYSQL_BIND *param=params+i;
+    int2store(types+i*2,(uint) param->buffer_type |
+	      (param->is_unsigned ? 0x8000 : 0));
+    if (param->is_null || param->buffer_type == FIELD_TYPE_NULL)
+    {
+      null_bits[i/8]|= (char) (1 << (i & 7));
+      continue;
+    }
+    switch (param->buffer_type) {
+    case FIELD_TYPE_TINY:
+      *pos++= *param->buffer;
+      break;
+    case FIELD_TYPE_SHORT:
+    {
+      short nr;
+      memcpy((char*) &nr,param->buffer,sizeof(nr));
+      int2store(pos,nr);
+      pos+=2;
+      break;
+    }
+    case FIELD_TYPE_INT24:
+    case FIELD_TYPE_LONG:
+    {
+      int32 nr;
+      memcpy((char*) &nr,param->buffer,sizeof(nr));
+      int4store(pos,nr);
+      pos+=4;
+      break;
+    }
+    case FIELD_TYPE_LONGLONG:
+    {
+      longlong nr;
+      memcpy((char*) &nr,param->buffer,sizeof(nr));
+      int8store(pos,nr);
+      pos+=8;
+      break;
+    }
+    case FIELD_TYPE_FLOAT:
+    {
+      float nr;
+      memcpy((char*) &nr,param->buffer,sizeof(nr));
+      float4store(pos,nr);
+      pos+=4;
+      break;
+    }
+    case FIELD_TYPE_DOUBLE:
+    {
+      double nr;
+      memcpy((char*) &nr,param->buffer,sizeof(nr));
+      float8store(pos,nr);
+      pos+=8;
+      break;
+    }
+    default:
+      pos=store_param_length(pos,param->length);
+      memcpy(pos,param->buffer,param->length);
+      pos+=param->length;
+      break;
+    }
+  }
+
+  mysql->last_used_con=mysql;
+  error=simple_command(mysql,COM_EXECUTE,buff,(ulong) (pos-buff),1);
+  my_free(buff,MYF(0));
+  if (error || mysql_read_query_result(mysql))
+    DBUG_RETURN(0);
+  DBUG_RETURN(store_result(mysql,1));
+}
+
+
+/**************************************************************************
+  Free a prepared statement on the server
+**************************************************************************/
+
+int STDCALL
+mysql_close_stmt(MYSQL *mysql, ulong stmt_id)
+{
+  char buff[4];
+  DBUG_ENTER("mysql_close_stmt");
+  int4store(buff,stmt_id);
+  DBUG_RETURN(simple_command(mysql,COM_CLOSE_STMT,buff,4,1));
+}
+
+
 
 /**************************************************************************
   Return next field of the query results
@@ -1617,6 +1617,94 @@ err2:
 } /* sort_index */
 
 
+/*
+  Give an empty table the rows and the kept keys of another table
+
+  SYNOPSIS
+    mi_copy_table()
+    param		Check parameters
+    info		New, empty table with the same row format as 'from'
+    from		Old table. Must be locked so that it can't change
+    from_key		For every key of 'info' the number of the same key
+			in 'from', or -1 if the key is new
+
+  DESCRIPTION
+    Used by ALTER TABLE when only keys are added or dropped.
+    The data file is copied as it is. The index trees of the kept keys
+    are copied page by page in key order, like in mi_sort_index(), so the
+    index blocks of dropped keys are not copied. The new keys are left
+    out of key_map, to be created with a T_CREATE_MISSING_KEYS repair.
+    The keys must have the same definition and key pointer length in
+    both tables.
+
+  RETURN
+    0	ok
+    1	error
+*/
+
+int mi_copy_table(MI_CHECK *param, MI_INFO *info, MI_INFO *from,
+		  int *from_key)
+{
+  uint key,i;
+  ulong *rec_per_key_part,*from_rec_per_key_part;
+  MYISAM_SHARE *share=info->s, *from_share=from->s;
+  DBUG_ENTER("mi_copy_table");
+
+  /* Nothing of the new table may be in the key cache */
+  if (flush_key_blocks(share->kfile, FLUSH_IGNORE_CHANGED))
+    DBUG_RETURN(1);
+
+  VOID(my_seek(info->dfile,0L,MY_SEEK_SET,MYF(0)));
+  if (from->state->data_file_length &&
+      filecopy(param, info->dfile, from->dfile, 0L,
+	       from->state->data_file_length, "datafile"))
+    DBUG_RETURN(1);
+
+  param->new_file_pos=share->base.keystart;
+  share->state.key_map=0;
+  rec_per_key_part=share->state.rec_per_key_part;
+  for (key=0 ; key < share->base.keys ;
+       rec_per_key_part+=share->keyinfo[key].keysegs, key++)
+  {
+    MI_KEYDEF *keyinfo;
+    share->state.key_root[key]= HA_OFFSET_ERROR;
+    if (from_key[key] < 0)
+      continue;
+    keyinfo=from_share->keyinfo+from_key[key];
+    from_rec_per_key_part=from_share->state.rec_per_key_part;
+    for (i=0 ; i < (uint) from_key[key] ; i++)
+      from_rec_per_key_part+=from_share->keyinfo[i].keysegs;
+    memcpy((char*) rec_per_key_part, (char*) from_rec_per_key_part,
+	   keyinfo->keysegs*sizeof(*rec_per_key_part));
+    if (!(((ulonglong) 1 << from_key[key]) & from_share->state.key_map))
+      continue;					/* Disabled; create it */
+    share->state.key_map|= (ulonglong) 1 << key;
+    if (from_share->state.key_root[from_key[key]] != HA_OFFSET_ERROR)
+    {
+      share->state.key_root[key]=param->new_file_pos;
+      if (sort_one_index(param,from,keyinfo,
+			 from_share->state.key_root[from_key[key]],
+			 share->kfile))
+	DBUG_RETURN(1);
+    }
+  }
+  for (i=0 ; i < share->state.header.max_block_size ; i++)
+    share->state.key_del[i]=  HA_OFFSET_ERROR;
+
+  *info->state= *from->state;
+  info->state->key_file_length=param->new_file_pos;
+  share->state.split=	       from_share->state.split;
+  share->state.dellink=	       from_share->state.dellink;
+  share->state.checksum=       from_share->state.checksum;
+  share->state.auto_increment= from_share->state.auto_increment;
+  share->state.rec_per_key_rows=from_share->state.rec_per_key_rows;
+  share->state.changed|= STATE_CHANGED;
+  share->changed=1;				/* Write state on unlock */
+  info->update= (short) (HA_STATE_CHANGED | HA_STATE_ROW_CHANGED);
+  DBUG_RETURN(0);
+} /* mi_copy_table */
+
+
 	 /* Sort records recursive using one index */
 
 static int sort_one_index(MI_CHECK *param, MI_INFO *info, MI_KEYDEF *keyinfo,
@@ -2147,7 +2235,13 @@ err:
   DESCRIPTION
     Same as mi_repair_by_sort but do it multithreaded
     Each key is handled by a separate thread.
-    TODO: make a number of threads a parameter
+    If param->repair_threads is bigger than the number of keys to
+    create, the run generation of each key is split between
+    param->repair_threads / keys threads. All threads read all rows;
+    thread 'split_index' of a key only sorts every 'split_count' row.
+    The sorted runs of the threads of a key are merged by thr_write_keys().
+    Splitting is only done with rep_quick, as only the master thread knows
+    the new row positions when the data file is rewritten.
 
   RESULT
     0	ok
@@ -2161,7 +2255,7 @@ int mi_repair_parallel(MI_CHECK *param, register MI_INFO *info,
   return mi_repair_by_sort(param, info, name, rep_quick);
 #else
   int got_error;
-  uint i,key, total_key_length, istep;
+  uint i,j,key, total_key_length, split, sort_threads, create_keys;
   ulong rec_length;
   ha_rows start_records;
   my_off_t new_header_length,del;
@@ -2293,8 +2387,29 @@ int mi_repair_parallel(MI_CHECK *param, register MI_INFO *info,
   if (param->testflag & T_CALC_CHECKSUM)
     param->calc_checksum=1;
 
+  /* Find out how many threads to use for each key */
+  for (key=create_keys=sort_threads=0 ; key < share->base.keys ; key++)
+  {
+    if (((ulonglong) 1 << key) & key_map)
+      create_keys++;
+  }
+  split=1;
+  if (rep_quick && create_keys && param->repair_threads > create_keys)
+  {
+    /* Don't split the sort buffer into too small pieces */
+    split=param->repair_threads/create_keys;
+    while (split > 1 &&
+	   param->sort_buffer_length/(create_keys*split) < MIN_SPLIT_SORT_BUFFER)
+      split--;
+  }
+  for (key=0 ; key < share->base.keys ; key++)
+  {
+    if (((ulonglong) 1 << key) & key_map)
+      sort_threads+= (share->keyinfo[key].flag & HA_FULLTEXT) ? 1 : split;
+  }
+
   if (!(sort_param=(MI_SORT_PARAM *)
-        my_malloc((uint) share->base.keys *
+        my_malloc((uint) max(sort_threads,1) *
 		  (sizeof(MI_SORT_PARAM) + share->base.pack_reclength),
 		  MYF(MY_ZEROFILL))))
   {
@@ -2306,22 +2421,20 @@ int mi_repair_parallel(MI_CHECK *param, register MI_INFO *info,
   info->state->records=info->state->del=share->state.split=0;
   info->state->empty=0;
 
-  for (i=key=0, istep=1 ; key < share->base.keys ;
-       rec_per_key_part+=sort_param[i].keyinfo->keysegs, i+=istep, key++)
+  for (i=key=0 ; key < share->base.keys ;
+       rec_per_key_part+=share->keyinfo[key].keysegs, key++)
   {
-    sort_param[i].key=key;
-    sort_param[i].keyinfo=share->keyinfo+key;
     if (!(((ulonglong) 1 << key) & key_map))
     {
       /* Remember old statistics for key */
       memcpy((char*) rec_per_key_part,
 	     (char*) (share->state.rec_per_key_part+
 		      (uint) (rec_per_key_part - param->rec_per_key_part)),
-	     sort_param[i].keyinfo->keysegs*sizeof(*rec_per_key_part));
-      istep=0;
+	     share->keyinfo[key].keysegs*sizeof(*rec_per_key_part));
       continue;
     }
-    istep=1;
+    sort_param[i].key=key;
+    sort_param[i].keyinfo=share->keyinfo+key;
     if ((!(param->testflag & T_SILENT)))
       printf ("- Fixing index %d\n",key+1);
     sort_param[i].key_read= ((sort_param[i].keyinfo->flag & HA_FULLTEXT) ?
@@ -2337,7 +2450,7 @@ int mi_repair_parallel(MI_CHECK *param, register MI_INFO *info,
     sort_param[i].filepos=new_header_length;
     sort_param[i].max_pos=sort_param[i].pos=share->pack.header_length;
 
-    sort_param[i].record= (((char *)(sort_param+share->base.keys))+
+    sort_param[i].record= (((char *)(sort_param+sort_threads))+
 			   (share->base.pack_reclength * i));
 
     sort_param[i].key_length=share->rec_reflength;
@@ -2356,6 +2469,19 @@ int mi_repair_parallel(MI_CHECK *param, register MI_INFO *info,
 
     if (sort_param[i].keyinfo->flag & HA_FULLTEXT)
       sort_param[i].key_length+=ft_max_word_len_for_sort-ft_max_word_len;
+
+    /* Give the other threads of a split key the same parameters */
+    sort_param[i].split_count=
+      (sort_param[i].keyinfo->flag & HA_FULLTEXT) ? 1 : split;
+    for (j=1 ; j < sort_param[i].split_count ; j++)
+    {
+      sort_param[i+j]= sort_param[i];
+      sort_param[i+j].split_index=j;
+      sort_param[i+j].record= sort_param[i].record +
+	share->base.pack_reclength * j;
+      total_key_length+=sort_param[i].key_length;
+    }
+    i+= sort_param[i].split_count;
   }
   sort_info.total_keys=i;
   sort_param[0].master= 1;
@@ -2543,14 +2669,24 @@ static int sort_key_read(MI_SORT_PARAM *sort_param, void *key)
   MI_INFO *info=sort_info->info;
   DBUG_ENTER("sort_key_read");
 
-  if ((error=sort_get_next_record(sort_param)))
-    DBUG_RETURN(error);
-  if (info->state->records == sort_info->max_records)
+  for (;;)
   {
-    mi_check_print_error(sort_info->param,
-			 "Key %d - Found too many records; Can't continue",
-                         sort_param->key+1);
-    DBUG_RETURN(1);
+    if ((error=sort_get_next_record(sort_param)))
+      DBUG_RETURN(error);
+    if (info->state->records == sort_info->max_records)
+    {
+      mi_check_print_error(sort_info->param,
+			   "Key %d - Found too many records; Can't continue",
+			   sort_param->key+1);
+      DBUG_RETURN(1);
+    }
+    /* If the key is split between threads, only use our share of rows */
+    if (sort_param->split_count <= 1 ||
+	sort_param->split_row++ % sort_param->split_count ==
+	sort_param->split_index)
+      break;
+    if (sort_write_record(sort_param))		/* Count row in master */
+      DBUG_RETURN(1);
   }
   sort_param->real_key_length=
     (info->s->rec_reflength+ 
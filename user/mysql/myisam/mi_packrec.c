@@ -20,20 +20,17 @@
 
 #define IS_CHAR ((uint) 32768)		/* Bit if char (not offset) in tree */
 
-#if INT_MAX > 65536L
-#define BITS_SAVED 32
-#define MAX_QUICK_TABLE_BITS 9		/* Because we may shift in 24 bits */
-#else
-#define BITS_SAVED 16
-#define MAX_QUICK_TABLE_BITS 6
-#endif
+#define BITS_SAVED 64
+#define MAX_QUICK_TABLE_BITS 9
+#define MAX_MULTI_TABLE_BITS 12		/* 16K for the table of one tree */
+#define MULTI_TABLE_CHARS 3		/* Max chars in one multi_table entry */
 
 #define get_bit(BU) ((BU)->bits ? \
 		     (BU)->current_byte & ((mi_bit_type) 1 << --(BU)->bits) :\
-		     (fill_buffer(BU), (BU)->bits= BITS_SAVED-1,\
-		      (BU)->current_byte & ((mi_bit_type) 1 << (BITS_SAVED-1))))
+		     (fill_buffer(BU), \
+		      (BU)->current_byte & ((mi_bit_type) 1 << --(BU)->bits)))
 #define skipp_to_next_byte(BU) ((BU)->bits&=~7)
-#define get_bits(BU,count) (((BU)->bits >= count) ? (((BU)->current_byte >> ((BU)->bits-=count)) & mask[count]) : fill_and_get_bits(BU,count))
+#define get_bits(BU,count) (((BU)->bits >= count) ? (uint) (((BU)->current_byte >> ((BU)->bits-=count)) & mask[count]) : fill_and_get_bits(BU,count))
 
 #define decode_bytes_test_bit(bit) \
   if (low_byte & (1 << (7-bit))) \
@@ -54,6 +51,9 @@ static void fill_quick_table(uint16 *table,uint bits, uint max_bits,
 static uint copy_decode_table(uint16 *to_pos,uint offset,
 			      uint16 *decode_table);
 static uint find_longest_bitstream(uint16 *table);
+static void make_multi_table(MI_DECODE_TREE *decode_tree);
+static uint decode_quick(MI_DECODE_TREE *decode_tree, uint value, uint bits,
+			 uint *chr);
 static void (*get_unpack_function(MI_COLUMNDEF *rec))(MI_COLUMNDEF *field,
 						    MI_BIT_BUFF *buff,
 						    uchar *to,
@@ -98,6 +98,7 @@ static uint decode_pos(MI_BIT_BUFF *bit_buff,MI_DECODE_TREE *decode_tree);
 static void init_bit_buffer(MI_BIT_BUFF *bit_buff,uchar *buffer,uint length);
 static uint fill_and_get_bits(MI_BIT_BUFF *bit_buff,uint count);
 static void fill_buffer(MI_BIT_BUFF *bit_buff);
+static uint fill_bits(MI_BIT_BUFF *bit_buff, uint bits);
 static uint max_bit(uint value);
 #ifdef HAVE_MMAP
 static uchar *_mi_mempack_get_block_info(MI_INFO *myisam,MI_BLOCK_INFO *info,
@@ -111,12 +112,10 @@ static mi_bit_type mask[]=
    0x0000001f, 0x0000003f, 0x0000007f, 0x000000ff,
    0x000001ff, 0x000003ff, 0x000007ff, 0x00000fff,
    0x00001fff, 0x00003fff, 0x00007fff, 0x0000ffff,
-#if BITS_SAVED > 16
    0x0001ffff, 0x0003ffff, 0x0007ffff, 0x000fffff,
    0x001fffff, 0x003fffff, 0x007fffff, 0x00ffffff,
    0x01ffffff, 0x03ffffff, 0x07ffffff, 0x0fffffff,
    0x1fffffff, 0x3fffffff, 0x7fffffff, 0xffffffff,
-#endif
  };
 
 
@@ -215,17 +214,36 @@ my_bool _mi_read_pack_info(MI_INFO *info, pbool fix_keys)
   for (i=0 ; i < trees ; i++)
     read_huff_table(&bit_buff,share->decode_trees+i,&decode_table,
 		    &intervall_buff,tmp_buff);
-  decode_table=(uint16*)
-    my_realloc((gptr) share->decode_tables,
-	       (uint) ((byte*) decode_table - (byte*) share->decode_tables),
-	       MYF(MY_HOLD_ON_ERROR));
+  /* The multi char tables are stored after the decode tables */
+  length=(uint) (decode_table - share->decode_tables);
+  length=(length+1) & ~1;			/* Align for uint32 */
+  for (i=0, elements=0 ; i < trees ; i++)
+    if (share->decode_trees[i].multi_table_bits)
+      elements+= 1L << share->decode_trees[i].multi_table_bits;
+  if (!(decode_table=(uint16*)
+	my_realloc((gptr) share->decode_tables,
+		   (uint) (length*sizeof(uint16)+elements*sizeof(uint32)),
+		   MYF(MY_WME | MY_FREE_ON_ERROR))))
+  {
+    my_free((gptr) share->decode_trees,MYF(0));
+    DBUG_RETURN(1);
+  }
   {
     long diff=PTR_BYTE_DIFF(decode_table,share->decode_tables);
+    uint32 *multi_table=(uint32*) (decode_table+length);
     share->decode_tables=decode_table;
     for (i=0 ; i < trees ; i++)
-      share->decode_trees[i].table=ADD_TO_PTR(share->decode_trees[i].table,
-					      diff,
-					      uint16*);
+    {
+      MI_DECODE_TREE *decode_tree=share->decode_trees+i;
+      decode_tree->table=ADD_TO_PTR(decode_tree->table,diff,uint16*);
+      decode_tree->multi_table=0;
+      if (decode_tree->multi_table_bits)
+      {
+	decode_tree->multi_table=multi_table;
+	make_multi_table(decode_tree);
+	multi_table+= 1L << decode_tree->multi_table_bits;
+      }
+    }
   }
 
 	/* Fix record-ref-length for keys */
@@ -280,6 +298,7 @@ static void read_huff_table(MI_BIT_BUFF *bit_buff, MI_DECODE_TREE *decode_tree,
     char_bits=get_bits(bit_buff,5);
     offset_bits=get_bits(bit_buff,5);
     decode_tree->quick_table_bits=0;
+    decode_tree->multi_table_bits=0;
     ptr= *decode_table;
   }
   size=elements*2-2;
@@ -298,6 +317,8 @@ static void read_huff_table(MI_BIT_BUFF *bit_buff, MI_DECODE_TREE *decode_tree,
   if (! intervall_length)
   {
     table_bits=find_longest_bitstream(tmp_buff);
+    decode_tree->multi_table_bits=min(table_bits*MULTI_TABLE_CHARS,
+				      MAX_MULTI_TABLE_BITS);
     if (table_bits > myisam_quick_table_bits)
       table_bits=myisam_quick_table_bits;
     next_free_offset= (1 << table_bits);
@@ -405,6 +426,89 @@ static uint find_longest_bitstream(uint16 *table)
 }
 
 
+/*
+  Make the table that decode_bytes() uses to decode several chars at once
+
+  NOTES
+    The table is indexed by the next multi_table_bits bits of a row.
+    Each entry holds up to MULTI_TABLE_CHARS chars decoded from those
+    bits, the first char in the lowest byte, the number of bits the
+    chars use in bits 24-27 and the number of chars in bits 28-29.
+    The number of chars is 0 if the first code is longer than
+    multi_table_bits.
+*/
+
+static void make_multi_table(MI_DECODE_TREE *decode_tree)
+{
+  uint value,bits,used,count,length,chr;
+  uint32 entry;
+
+  bits=decode_tree->multi_table_bits;
+  for (value=0 ; value < (1U << bits) ; value++)
+  {
+    entry=0;
+    for (count=used=0 ; count < MULTI_TABLE_CHARS ; count++, used+=length)
+    {
+      if (!(length=decode_quick(decode_tree,
+				value & ((1U << (bits-used))-1),
+				bits-used, &chr)))
+	break;
+      entry|= (uint32) chr << (count*8);
+    }
+    decode_tree->multi_table[value]= entry | (used << 24) | (count << 28);
+  }
+}
+
+
+/*
+  Decode one char from the highest bits of value
+
+  SYNOPSIS
+    decode_quick()
+    decode_tree		Decode tree with its quick_table
+    value		Bits to decode
+    bits		Number of bits in value
+    chr			Store decoded char here
+
+  RETURN
+    0	The code is longer than bits
+    #	Number of bits used
+*/
+
+static uint decode_quick(MI_DECODE_TREE *decode_tree, uint value, uint bits,
+			 uint *chr)
+{
+  uint16 *pos;
+  uint low_byte,used,table_bits=decode_tree->quick_table_bits;
+
+  if (bits >= table_bits)
+    low_byte=value >> (bits-table_bits);
+  else
+    low_byte=value << (table_bits-bits);
+  low_byte=decode_tree->table[low_byte & ((1 << table_bits)-1)];
+  if (low_byte & IS_CHAR)
+  {
+    if ((used=(low_byte >> 8) & 31) > bits)
+      return 0;
+    *chr=low_byte & 255;
+    return used;
+  }
+  pos=decode_tree->table+low_byte;
+  for (used=table_bits ; used < bits ; )
+  {
+    if (value & (1 << (bits - ++used)))
+      pos++;
+    if (*pos & IS_CHAR)
+    {
+      *chr= *pos & 255;
+      return used;
+    }
+    pos+= *pos;
+  }
+  return 0;
+}
+
+
 	/* Read record from datafile */
 	/* Returns length of packed record, -1 if error */
 
@@ -772,72 +876,15 @@ static void uf_varchar(MI_COLUMNDEF *rec, MI_BIT_BUFF *bit_buff,
 
 	/* Functions to decode of buffer of bits */
 
-#if BITS_SAVED == 64
-
-static void decode_bytes(MI_COLUMNDEF *rec,MI_BIT_BUFF *bit_buff,uchar *to,
-			 uchar *end)
-{
-  reg1 uint bits,low_byte;
-  reg3 uint16 *pos;
-  reg4 uint table_bits,table_and;
-  MI_DECODE_TREE *decode_tree;
-
-  decode_tree=rec->decode_tree;
-  bits=bit_buff->bits;			/* Save in reg for quicker access */
-  table_bits=decode_tree->quick_table_bits;
-  table_and= (1 << table_bits)-1;
-
-  do
-  {
-    if (bits <= 32)
-    {
-      if (bit_buff->pos > bit_buff->end+4)
-      {
-	bit_buff->error=1;
-	return;				/* Can't be right */
-      }
-      bit_buff->current_byte= (bit_buff->current_byte << 32) +
-	((((uint) bit_buff->pos[3])) +
-	 (((uint) bit_buff->pos[2]) << 8) +
-	 (((uint) bit_buff->pos[1]) << 16) +
-	 (((uint) bit_buff->pos[0]) << 24));
-      bit_buff->pos+=4;
-      bits+=32;
-    }
-	/* First use info in quick_table */
-    low_byte=(uint) (bit_buff->current_byte >> (bits - table_bits)) & table_and;
-    low_byte=decode_tree->table[low_byte];
-    if (low_byte & IS_CHAR)
-    {
-      *to++ = (low_byte & 255);		/* Found char in quick table */
-      bits-=  ((low_byte >> 8) & 31);	/* Remove bits used */
-    }
-    else
-    {					/* Map through rest of decode-table */
-      pos=decode_tree->table+low_byte;
-      bits-=table_bits;
-      for (;;)
-      {
-	low_byte=(uint) (bit_buff->current_byte >> (bits-8));
-	decode_bytes_test_bit(0);
-	decode_bytes_test_bit(1);
-	decode_bytes_test_bit(2);
-	decode_bytes_test_bit(3);
-	decode_bytes_test_bit(4);
-	decode_bytes_test_bit(5);
-	decode_bytes_test_bit(6);
-	decode_bytes_test_bit(7);
-	bits-=8;
-      }
-      *to++ = *pos;
-    }
-  } while (to != end);
-
-  bit_buff->bits=bits;
-  return;
-}
+/*
+  Decode the chars of a field
 
-#else
+  NOTES
+    Up to MULTI_TABLE_CHARS chars are decoded with one lookup in the
+    multi_table of the tree while that many chars are left of the field.
+    Codes that don't fit in the multi_table, and the last chars of the
+    field, are decoded through the quick_table and the rest of the tree.
+*/
 
 static void decode_bytes(MI_COLUMNDEF *rec, MI_BIT_BUFF *bit_buff, uchar *to,
 			 uchar *end)
@@ -845,48 +892,46 @@ static void decode_bytes(MI_COLUMNDEF *rec, MI_BIT_BUFF *bit_buff, uchar *to,
   reg1 uint bits,low_byte;
   reg3 uint16 *pos;
   reg4 uint table_bits,table_and;
+  uint multi_bits,multi_and;
+  uint32 *multi_table,entry;
   MI_DECODE_TREE *decode_tree;
 
   decode_tree=rec->huff_tree;
   bits=bit_buff->bits;			/* Save in reg for quicker access */
   table_bits=decode_tree->quick_table_bits;
   table_and= (1 << table_bits)-1;
+  multi_table=decode_tree->multi_table;
+  multi_bits=decode_tree->multi_table_bits;
+  multi_and= (1 << multi_bits)-1;
 
   do
   {
-    if (bits < table_bits)
+    if (bits < 32)
     {
-      if (bit_buff->pos > bit_buff->end+1)
+      if (bit_buff->pos > bit_buff->end+8)
       {
 	bit_buff->error=1;
 	return;				/* Can't be right */
       }
-#if BITS_SAVED == 32
-      bit_buff->current_byte= (bit_buff->current_byte << 24) +
-	(((uint) ((uchar) bit_buff->pos[2]))) +
-	  (((uint) ((uchar) bit_buff->pos[1])) << 8) +
-	    (((uint) ((uchar) bit_buff->pos[0])) << 16);
-      bit_buff->pos+=3;
-      bits+=24;
-#else
-      if (bits)				/* We must have at leasts 9 bits */
-      {
-	bit_buff->current_byte=  (bit_buff->current_byte << 8) +
-	  (uint) ((uchar) bit_buff->pos[0]);
-	bit_buff->pos++;
-	bits+=8;
-      }
-      else
+      bits=fill_bits(bit_buff,bits);
+    }
+    if (to+MULTI_TABLE_CHARS <= end)
+    {
+      entry=multi_table[(uint) (bit_buff->current_byte >> (bits-multi_bits)) &
+			multi_and];
+      if (entry >> 28)
       {
-	bit_buff->current_byte= ((uint) ((uchar) bit_buff->pos[0]) << 8) +
-	  ((uint) ((uchar) bit_buff->pos[1]));
-	bit_buff->pos+=2;
-	bits+=16;
+	/* Store all chars; The unused ones are overwritten by the next ones */
+	to[0]= (uchar) entry;
+	to[1]= (uchar) (entry >> 8);
+	to[2]= (uchar) (entry >> 16);
+	to+=   entry >> 28;
+	bits-= (entry >> 24) & 15;
+	continue;
       }
-#endif
     }
-	/* First use info in quick_table */
-    low_byte=(bit_buff->current_byte >> (bits - table_bits)) & table_and;
+	/* Use info in quick_table */
+    low_byte=(uint) (bit_buff->current_byte >> (bits - table_bits)) & table_and;
     low_byte=decode_tree->table[low_byte];
     if (low_byte & IS_CHAR)
     {
@@ -900,21 +945,7 @@ static void decode_bytes(MI_COLUMNDEF *rec, MI_BIT_BUFF *bit_buff, uchar *to,
       for (;;)
       {
 	if (bits < 8)
-	{				/* We don't need to check end */
-#if BITS_SAVED == 32
-	  bit_buff->current_byte= (bit_buff->current_byte << 24) +
-	    (((uint) ((uchar) bit_buff->pos[2]))) +
-	      (((uint) ((uchar) bit_buff->pos[1])) << 8) +
-		(((uint) ((uchar) bit_buff->pos[0])) << 16);
-	  bit_buff->pos+=3;
-	  bits+=24;
-#else
-	  bit_buff->current_byte=  (bit_buff->current_byte << 8) +
-	    (uint) ((uchar) bit_buff->pos[0]);
-	  bit_buff->pos+=1;
-	  bits+=8;
-#endif
-	}
+	  bits=fill_bits(bit_buff,bits);  /* We don't need to check end */
 	low_byte=(uint) (bit_buff->current_byte >> (bits-8));
 	decode_bytes_test_bit(0);
 	decode_bytes_test_bit(1);
@@ -933,7 +964,6 @@ static void decode_bytes(MI_COLUMNDEF *rec, MI_BIT_BUFF *bit_buff, uchar *to,
   bit_buff->bits=bits;
   return;
 }
-#endif /* BIT_SAVED == 64 */
 
 
 static uint decode_pos(MI_BIT_BUFF *bit_buff, MI_DECODE_TREE *decode_tree)
@@ -1081,7 +1111,7 @@ uint _mi_pack_get_block_info(MI_INFO *myisam, MI_BLOCK_INFO *info, File file,
 
 
 	/* rutines for bit buffer */
-	/* Note buffer must be 6 byte bigger than longest row */
+	/* Bytes after the end of the buffer are never read */
 
 static void init_bit_buffer(MI_BIT_BUFF *bit_buff, uchar *buffer, uint length)
 {
@@ -1093,49 +1123,55 @@ static void init_bit_buffer(MI_BIT_BUFF *bit_buff, uchar *buffer, uint length)
 
 static uint fill_and_get_bits(MI_BIT_BUFF *bit_buff, uint count)
 {
-  uint tmp;
-  count-=bit_buff->bits;
-  tmp=(bit_buff->current_byte & mask[bit_buff->bits]) << count;
   fill_buffer(bit_buff);
-  bit_buff->bits=BITS_SAVED - count;
-  return tmp+(bit_buff->current_byte >> (BITS_SAVED - count));
+  return (uint) ((bit_buff->current_byte >> (bit_buff->bits-=count)) &
+		 mask[count]);
 }
 
-	/* Fill in empty bit_buff->current_byte from buffer */
+	/* Fill bit_buff->current_byte from buffer when bits are needed */
 	/* Sets bit_buff->error if buffer is exhausted */
 
 static void fill_buffer(MI_BIT_BUFF *bit_buff)
 {
   if (bit_buff->pos >= bit_buff->end)
-  {
     bit_buff->error= 1;
-    bit_buff->current_byte=0;
-    return;
+  bit_buff->bits=fill_bits(bit_buff,bit_buff->bits);
+}
+
+
+/*
+  Shift whole bytes from the buffer into bit_buff->current_byte
+
+  SYNOPSIS
+    fill_bits()
+    bit_buff		Bit buffer
+    bits		Number of unused bits in current_byte, at most 32
+
+  NOTES
+    Bytes after bit_buff->end are shifted in as zero bits, but are still
+    counted in bit_buff->pos, so that a row that uses them fails the
+    end check in _mi_pack_rec_unpack().
+
+  RETURN
+    New number of unused bits in current_byte; At least BITS_SAVED-8
+*/
+
+static uint fill_bits(MI_BIT_BUFF *bit_buff, uint bits)
+{
+  uchar *pos=bit_buff->pos;
+  if (pos+8 <= bit_buff->end)
+  {
+    uint shift= (BITS_SAVED-1-bits) & ~7;	/* Whole bytes that fit */
+    bit_buff->current_byte= ((bit_buff->current_byte << shift) +
+			     (mi_uint8korr(pos) >> (BITS_SAVED-shift)));
+    bit_buff->pos=pos+shift/8;
+    return bits+shift;
   }
-#if BITS_SAVED == 64
-  bit_buff->current_byte=  ((((uint) ((uchar) bit_buff->pos[7]))) +
-			     (((uint) ((uchar) bit_buff->pos[6])) << 8) +
-			     (((uint) ((uchar) bit_buff->pos[5])) << 16) +
-			     (((uint) ((uchar) bit_buff->pos[4])) << 24) +
-			     ((ulonglong)
-			      ((((uint) ((uchar) bit_buff->pos[3]))) +
-			       (((uint) ((uchar) bit_buff->pos[2])) << 8) +
-			       (((uint) ((uchar) bit_buff->pos[1])) << 16) +
-			       (((uint) ((uchar) bit_buff->pos[0])) << 24)) << 32));
-  bit_buff->pos+=8;
-#else
-#if BITS_SAVED == 32
-  bit_buff->current_byte=  (((uint) ((uchar) bit_buff->pos[3])) +
-			     (((uint) ((uchar) bit_buff->pos[2])) << 8) +
-			     (((uint) ((uchar) bit_buff->pos[1])) << 16) +
-			     (((uint) ((uchar) bit_buff->pos[0])) << 24));
-  bit_buff->pos+=4;
-#else
-  bit_buff->current_byte=  (uint) (((uint) ((uchar) bit_buff->pos[1]))+
-				    (((uint) ((uchar) bit_buff->pos[0])) << 8));
-  bit_buff->pos+=2;
-#endif
-#endif
+  for ( ; bits <= BITS_SAVED-8 ; bits+=8, pos++)
+    bit_buff->current_byte= ((bit_buff->current_byte << 8) +
+			     (pos < bit_buff->end ? (uint) *pos : 0));
+  bit_buff->pos=pos;
+  return bits;
 }
 
 	/* Get number of bits neaded to represent value */
@@ -22,6 +22,7 @@
 	   One may have done a write, update or delete of the previous row.
 	   NOTE! Even if one changes the previous row, the next read is done
 	   based on the position of the last used key!
+	   If buf is 0 only info->lastpos is set, like with mi_rkey().
 	*/
 
 int mi_rnext_same(MI_INFO *info, byte *buf)
@@ -69,6 +70,11 @@ int mi_rnext_same(MI_INFO *info, byte *buf)
     if (my_errno == HA_ERR_KEY_NOT_FOUND)
       my_errno=HA_ERR_END_OF_FILE;
   }
+  else if (!buf)
+  {
+    /* Only the position of the row was wanted (info->lastpos) */
+    DBUG_RETURN(0);
+  }
   else if (!(*info->read_record)(info,info->lastpos,buf))
   {
     info->update|= HA_STATE_AKTIV;		/* Record is read */
@@ -810,6 +810,7 @@ end:
       puts("Locking used");
     if (use_blob)
       puts("blobs used");
+    update_key_cache_stats();
     printf("key cache status: \n\
 blocks used:%10lu\n\
 w_requests: %10lu\n\
@@ -0,0 +1,231 @@
+/* Copyright (C) 2000 MySQL AB & MySQL Finland AB & TCX DataKonsult AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Test of key cache block replacement
+
+  Does random reads of a small set of hot index blocks, with a full scan
+  of the whole index file now and then, first with a plain LRU key cache
+  and then with the midpoint insertion LRU (key_cache_division_limit and
+  key_cache_age_threshold). Prints the hit rate of the point lookups and
+  of the scans for both runs.
+*/
+
+#include "myisamdef.h"
+
+#if defined(HAVE_LRAND48)
+#define rnd(X) (lrand48() % X)
+#define rnd_init(X) srand48(X)
+#else
+#define rnd(X) (random() % X)
+#define rnd_init(X) srandom(X)
+#endif
+
+#define BLOCK_OVERHEAD	64		/* Approx. memory for block header */
+
+const char *filename= "test4.MYI";
+static uint file_blocks=1024,cache_blocks=512,hot_blocks=256;
+static uint lookups=200000,scan_interval=20000;
+static uint division_limit=50,age_threshold=300,partitions=1;
+static int silent=0;
+
+struct test_result {
+  ulong lookup_requests,lookup_reads,scan_requests,scan_reads;
+};
+
+static void get_options(int argc, char *argv[]);
+static int run_test(File file, uint test_division_limit,
+		    struct test_result *res);
+static void print_result(const char *name, uint test_division_limit,
+			 struct test_result *res);
+
+
+int main(int argc, char *argv[])
+{
+  File file;
+  uint i;
+  byte *buff;
+  struct test_result lru,midpoint;
+  MY_INIT(argv[0]);
+  get_options(argc,argv);
+
+  if (!(buff=(byte*) my_malloc(key_cache_block_size,MYF(MY_WME))))
+    exit(1);
+  if ((file=my_create(filename,0,O_RDWR | O_TRUNC,MYF(MY_WME))) < 0)
+    goto err;
+  for (i=0 ; i < file_blocks ; i++)
+  {
+    int4store(buff,i);
+    bfill(buff+4,key_cache_block_size-4,(char) i);
+    if (my_write(file,buff,key_cache_block_size,MYF(MY_NABP | MY_WME)))
+      goto err;
+  }
+
+  if (!silent)
+    printf("file blocks: %u  cache blocks: %u  hot blocks: %u  lookups: %u  scan every: %u lookups\n",
+	   file_blocks, cache_blocks, hot_blocks, lookups, scan_interval);
+
+  if (run_test(file, 100, &lru) ||
+      run_test(file, division_limit, &midpoint))
+    goto err;
+  print_result("LRU", 100, &lru);
+  print_result("Midpoint", division_limit, &midpoint);
+
+  my_close(file,MYF(0));
+  my_delete(filename,MYF(0));
+  my_free(buff,MYF(0));
+  my_end(MY_CHECK_ERROR);
+  return 0;
+
+err:
+  printf("got error: %d when testing key cache\n",my_errno);
+  my_delete(filename,MYF(0));
+  return 1;
+}
+
+
+	/* Run the lookup + scan workload with a fresh key cache */
+
+static int run_test(File file, uint test_division_limit,
+		    struct test_result *res)
+{
+  uint i,j;
+  ulong requests,reads;
+  byte *buff;
+  int error=1;
+
+  bzero((char*) res,sizeof(*res));
+  key_cache_division_limit=test_division_limit;
+  key_cache_age_threshold=age_threshold;
+  key_cache_partitions=partitions;
+  if (!init_key_cache((ulong) cache_blocks *
+		      (key_cache_block_size+BLOCK_OVERHEAD)))
+    return 1;
+  if (!(buff=(byte*) my_malloc(key_cache_block_size,MYF(MY_WME))))
+    goto end;
+
+  rnd_init(1);					/* Same workload every run */
+  for (i=1 ; i <= lookups ; i++)
+  {
+    uint block=(uint) rnd(hot_blocks);
+    if (!key_cache_read(file,(my_off_t) block*key_cache_block_size,buff,
+			key_cache_block_size,key_cache_block_size,0) ||
+	uint4korr(buff) != block)
+      goto end;
+    if (scan_interval && i % scan_interval == 0)
+    {
+      update_key_cache_stats();
+      requests=_my_cache_r_requests; reads=_my_cache_read;
+      for (j=0 ; j < file_blocks ; j++)
+      {
+	if (!key_cache_read(file,(my_off_t) j*key_cache_block_size,buff,
+			    key_cache_block_size,key_cache_block_size,0))
+	  goto end;
+      }
+      update_key_cache_stats();
+      res->scan_requests+= _my_cache_r_requests-requests;
+      res->scan_reads+=    _my_cache_read-reads;
+    }
+  }
+  update_key_cache_stats();
+  res->lookup_requests=_my_cache_r_requests-res->scan_requests;
+  res->lookup_reads=   _my_cache_read-res->scan_reads;
+  error=0;
+
+end:
+  end_key_cache();
+  my_free(buff,MYF(MY_ALLOW_ZERO_PTR));
+  return error;
+}
+
+
+static void print_result(const char *name, uint test_division_limit,
+			 struct test_result *res)
+{
+  printf("%-9s division_limit: %3u  age_threshold: %4u  lookup hit rate: %6.2f%%  scan hit rate: %6.2f%%\n",
+	 name, test_division_limit, age_threshold,
+	 res->lookup_requests ?
+	 100.0 - 100.0*res->lookup_reads/res->lookup_requests : 0.0,
+	 res->scan_requests ?
+	 100.0 - 100.0*res->scan_reads/res->scan_requests : 0.0);
+}
+
+
+	/* Read options */
+
+static void get_options(int argc, char **argv)
+{
+  char *pos,*progname;
+  DEBUGGER_OFF;
+
+  progname= argv[0];
+
+  while (--argc >0 && *(pos = *(++argv)) == '-' ) {
+    switch(*++pos) {
+    case 'b':
+      file_blocks=(uint) atoi(++pos);
+      break;
+    case 'k':
+      cache_blocks=(uint) atoi(++pos);
+      break;
+    case 'h':
+      if ((hot_blocks=(uint) atoi(++pos)) == 0)
+	hot_blocks=1;
+      break;
+    case 'l':
+      lookups=(uint) atoi(++pos);
+      break;
+    case 's':
+      scan_interval=(uint) atoi(++pos);
+      break;
+    case 'd':
+      division_limit=(uint) atoi(++pos);
+      if (division_limit < 1 || division_limit > 100)
+	division_limit=100;
+      break;
+    case 'a':
+      age_threshold=(uint) atoi(++pos);
+      break;
+    case 'p':
+      partitions=(uint) atoi(++pos);
+      break;
+    case 'S':
+      silent=1;
+      break;
+    case '?':
+    case 'I':
+    case 'V':
+      printf("%s  Ver 1.0 for %s at %s\n",progname,SYSTEM_TYPE,MACHINE_TYPE);
+      puts("Test of key cache replacement with point lookups and index scans\n");
+      printf("Usage: %s [-?S] [-b#] [-k#] [-h#] [-l#] [-s#] [-d#] [-a#] [-p#]\n",progname);
+      puts("-b# blocks in index file, -k# blocks in key cache, -h# hot blocks");
+      puts("-l# number of lookups, -s# lookups between full scans (0 = no scans)");
+      puts("-d# key_cache_division_limit, -a# key_cache_age_threshold");
+      puts("-p# key_cache_partitions");
+      exit(0);
+    case '#':
+      DEBUGGER_ON;
+      DBUG_PUSH (++pos);
+      break;
+    default:
+      printf("Illegal option: '%c'\n",*pos);
+      break;
+    }
+  }
+  if (hot_blocks > file_blocks)
+    hot_blocks=file_blocks;
+  return;
+}
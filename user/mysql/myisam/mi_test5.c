@@ -0,0 +1,282 @@
+/* Copyright (C) 2000 MySQL AB & MySQL Finland AB & TCX DataKonsult AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Speed test of full scans of compressed tables
+
+  'mi_test5 -c' creates the table test5 with text like columns. Compress
+  it with 'myisampack test5' and 'myisamchk -rq test5', after which
+  'mi_test5' scans the table a number of times and prints the rows/s and
+  the MB/s of unpacked rows, and a checksum of all rows that must be the
+  same as for the table before it was packed. With -m the data file is
+  read through mmap() instead of through the read cache.
+*/
+
+#include "myisamdef.h"
+
+#if defined(HAVE_LRAND48)
+#define rnd(X) (lrand48() % X)
+#define rnd_init(X) srand48(X)
+#else
+#define rnd(X) (random() % X)
+#define rnd_init(X) srandom(X)
+#endif
+
+#define NAME_LENGTH	40
+#define CITY_LENGTH	20
+#define TEXT_LENGTH	120
+#define NUMBER_LENGTH	10
+#define RECLENGTH	(4+NAME_LENGTH+CITY_LENGTH+TEXT_LENGTH+NUMBER_LENGTH)
+
+const char *filename= "test5";
+static uint records=100000,loops=10;
+static int silent=0,create=0,use_mmap=0;
+
+static const char *words[]=
+{
+  "the","of","and","to","in","is","that","for","it","as","was","with",
+  "be","by","on","not","he","this","are","or","his","from","at","which",
+  "but","have","an","had","they","you","were","their","one","all","we",
+  "can","her","has","there","been","if","more","when","will","would",
+  "who","so","no","order","customer","shipped","returned","payment",
+  "invoice","account","delivery","warehouse","product","quantity","price",
+  "discount","between","archive","record","table","compressed","reading"
+};
+static const char *cities[]=
+{
+  "Helsinki","Stockholm","Uppsala","Oslo","Copenhagen","Berlin","Munich",
+  "Paris","London","Madrid","Lisbon","Rome","Vienna","Prague","Warsaw",
+  "Tallinn","Riga","Vilnius","Dublin","Amsterdam","Brussels","Zurich"
+};
+
+static void get_options(int argc, char *argv[]);
+static int create_table(void);
+static int scan_table(void);
+static void make_words(char *to, uint length, uint min_words,
+		       uint max_words);
+
+
+int main(int argc, char *argv[])
+{
+  int error;
+  MY_INIT(argv[0]);
+  get_options(argc,argv);
+
+  if (!init_key_cache(IO_SIZE*16))
+    exit(1);
+  error= create ? create_table() : scan_table();
+  if (error)
+    printf("got error: %d when testing compressed table\n",my_errno);
+  end_key_cache();
+  my_end(MY_CHECK_ERROR);
+  return error;
+}
+
+
+	/* Create and fill the table that should be compressed */
+
+static int create_table(void)
+{
+  MI_INFO *file;
+  MI_COLUMNDEF recinfo[5];
+  MI_KEYDEF keyinfo[1];
+  MI_KEYSEG keyseg[1];
+  byte record[RECLENGTH];
+  char buff[NUMBER_LENGTH+1];
+  uint i;
+
+  bzero((char*) recinfo,sizeof(recinfo));
+  bzero((char*) keyinfo,sizeof(keyinfo));
+  bzero((char*) keyseg,sizeof(keyseg));
+  recinfo[0].type=FIELD_NORMAL;        recinfo[0].length=4;
+  recinfo[1].type=FIELD_SKIP_ENDSPACE; recinfo[1].length=NAME_LENGTH;
+  recinfo[2].type=FIELD_SKIP_ENDSPACE; recinfo[2].length=CITY_LENGTH;
+  recinfo[3].type=FIELD_SKIP_ENDSPACE; recinfo[3].length=TEXT_LENGTH;
+  recinfo[4].type=FIELD_SKIP_PRESPACE; recinfo[4].length=NUMBER_LENGTH;
+  keyinfo[0].seg=keyseg;
+  keyinfo[0].keysegs=1;
+  keyinfo[0].flag=HA_NOSAME;
+  keyseg[0].type=HA_KEYTYPE_LONG_INT;
+  keyseg[0].start=0;
+  keyseg[0].length=4;
+
+  if (mi_create(filename,1,keyinfo,5,recinfo,0,(MI_UNIQUEDEF*) 0,
+		(MI_CREATE_INFO*) 0,0))
+    return 1;
+  if (!(file=mi_open(filename,2,HA_OPEN_ABORT_IF_LOCKED)))
+    return 1;
+  rnd_init(1);
+  for (i=0 ; i < records ; i++)
+  {
+    char *pos=record;
+    int4store(pos,i);
+    pos+=4;
+    make_words(pos,NAME_LENGTH,2,4);
+    pos+=NAME_LENGTH;
+    make_words(pos,CITY_LENGTH,0,0);
+    pos+=CITY_LENGTH;
+    make_words(pos,TEXT_LENGTH,5,15);
+    pos+=TEXT_LENGTH;
+    sprintf(buff,"%*lu",NUMBER_LENGTH,(ulong) rnd(1000000));
+    memcpy(pos,buff,NUMBER_LENGTH);
+    if (mi_write(file,record))
+    {
+      mi_close(file);
+      return 1;
+    }
+  }
+  if (mi_close(file))
+    return 1;
+  if (!silent)
+    printf("Created %s with %u rows; Pack it with 'myisampack %s' and 'myisamchk -rq %s'\n",
+	   filename, records, filename, filename);
+  return 0;
+}
+
+
+	/* Fill a column with random words; max_words == 0 gives a city */
+
+static void make_words(char *to, uint length, uint min_words,
+		       uint max_words)
+{
+  char *end=to+length,*pos=to;
+  uint count;
+
+  if (!max_words)
+    pos=strnmov(pos,cities[rnd(array_elements(cities))],length);
+  else
+  {
+    count=min_words+(uint) rnd(max_words-min_words+1);
+    while (count--)
+    {
+      /* Make the first words more common than the rest */
+      uint first=(uint) rnd(array_elements(words))+1;
+      const char *word=words[rnd(first)];
+      if (pos+strlen(word)+1 > end)
+	break;
+      if (pos != to)
+	*pos++=' ';
+      pos=strmov(pos,word);
+    }
+  }
+  bfill(pos,(uint) (end-pos),' ');
+}
+
+
+	/* Scan the compressed table; Prints the speed and a checksum */
+
+static int scan_table(void)
+{
+  MI_INFO *file;
+  byte record[RECLENGTH];
+  uint i,j;
+  int error;
+  ulong rows;
+  ha_checksum crc;
+  ulonglong start;
+  double secs;
+
+  if (!(file=mi_open(filename,0,HA_OPEN_ABORT_IF_LOCKED)))
+    return 1;
+  if (!(file->s->options & HA_OPTION_COMPRESS_RECORD) && !silent)
+    printf("Warning: %s is not compressed\n",filename);
+#ifdef HAVE_MMAP
+  if (use_mmap && !_mi_memmap_file(file))
+    printf("Warning: Could not mmap() %s\n",filename);
+#endif
+  if (!use_mmap)
+    mi_extra(file,HA_EXTRA_CACHE,0);
+
+  start=my_getsystime();
+  for (i=rows=crc=0 ; i < loops ; i++)
+  {
+    if (mi_scan_init(file))
+      goto err;
+    while (!(error=mi_scan(file,record)) || error == HA_ERR_RECORD_DELETED)
+    {
+      if (error)
+	continue;
+      rows++;
+      if (i == 0)
+	for (j=0 ; j < RECLENGTH ; j++)
+	  crc=(crc << 8) + (crc >> (8*sizeof(ha_checksum)-8)) +
+	    (uchar) record[j];
+    }
+    if (error != HA_ERR_END_OF_FILE)
+      goto err;
+  }
+  secs=(double) (my_getsystime()-start)/10000000.0;
+  printf("%s: %lu rows  %8.3f s  %10.0f rows/s  %8.2f MB/s  checksum: %lu\n",
+	 use_mmap ? "mmap" : "read cache", rows, secs,
+	 secs > 0.0 ? (double) rows/secs : 0.0,
+	 secs > 0.0 ? (double) rows*RECLENGTH/secs/(1024*1024) : 0.0,
+	 (ulong) crc);
+  return mi_close(file) != 0;
+
+err:
+  mi_close(file);
+  return 1;
+}
+
+
+	/* Read options */
+
+static void get_options(int argc, char **argv)
+{
+  char *pos,*progname;
+  DEBUGGER_OFF;
+
+  progname= argv[0];
+
+  while (--argc >0 && *(pos = *(++argv)) == '-' ) {
+    switch(*++pos) {
+    case 'c':
+      create=1;
+      break;
+    case 'r':
+      if ((records=(uint) atoi(++pos)) == 0)
+	records=1;
+      break;
+    case 'l':
+      if ((loops=(uint) atoi(++pos)) == 0)
+	loops=1;
+      break;
+    case 'm':
+      use_mmap=1;
+      break;
+    case 'S':
+      silent=1;
+      break;
+    case '?':
+    case 'I':
+    case 'V':
+      printf("%s  Ver 1.0 for %s at %s\n",progname,SYSTEM_TYPE,MACHINE_TYPE);
+      puts("Speed test of full scans of a compressed table\n");
+      printf("Usage: %s [-?cmS] [-r#] [-l#]\n",progname);
+      puts("-c create the table to compress, -r# rows in created table");
+      puts("-l# number of scans, -m read the table through mmap()");
+      exit(0);
+    case '#':
+      DEBUGGER_ON;
+      DBUG_PUSH (++pos);
+      break;
+    default:
+      printf("Illegal option: '%c'\n",*pos);
+      break;
+    }
+  }
+  return;
+}
@@ -208,7 +208,7 @@ typedef struct st_mi_isam_share {	/* Shared between opens */
 } MYISAM_SHARE;
 
 
-typedef uint mi_bit_type;
+typedef ulonglong mi_bit_type;
 
 typedef struct st_mi_bit_buff {		/* Used for packing of record */
   mi_bit_type current_byte;
@@ -593,6 +593,7 @@ typedef struct st_mi_block_info {	/* Parameter to _mi_get_block_info */
 #define READ_BUFFER_INIT	(1024L*256L-MALLOC_OVERHEAD)
 #define SORT_BUFFER_INIT	(2048L*1024L-MALLOC_OVERHEAD)
 #define MIN_SORT_BUFFER		(4096-MALLOC_OVERHEAD)
+#define MIN_SPLIT_SORT_BUFFER	(64L*1024L)	/* Per thread of a split key */
 
 enum myisam_log_commands {
   MI_LOG_OPEN,MI_LOG_WRITE,MI_LOG_UPDATE,MI_LOG_DELETE,MI_LOG_CLOSE,MI_LOG_EXTRA,MI_LOG_LOCK,MI_LOG_DELETE_ALL
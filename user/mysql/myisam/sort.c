@@ -74,6 +74,9 @@ static int NEAR_F merge_buffers(MI_SORT_PARAM *info,uint keys,
                                 BUFFPEK *Fb, BUFFPEK *Tb);
 static int NEAR_F merge_index(MI_SORT_PARAM *,uint,uchar **,BUFFPEK *, int,
                               IO_CACHE *);
+#ifdef THREAD
+static int NEAR_F thr_gather_runs(MI_SORT_PARAM *sort_param);
+#endif
 
 
 /*
@@ -303,6 +306,8 @@ pthread_handler_decl(thr_find_all_keys,arg)
 
   memavl=max(info->sortbuff_size, MIN_SORT_MEMORY);
   idx=      info->sort_info->max_records;
+  if (info->split_count > 1)
+    idx=idx/info->split_count+1;		/* Our share of the rows */
   sort_length=  info->key_length;
   maxbuffer= 1;
 
@@ -379,7 +384,11 @@ pthread_handler_decl(thr_find_all_keys,arg)
   }
   if (error > 0)
     goto err;
-  if (info->buffpek.elements)
+  /*
+    The keys of a split key are merged from the temporary files of all
+    its threads, so a thread that shares a key always writes its last run
+  */
+  if (info->buffpek.elements || (info->split_count > 1 && idx))
   {
     if (write_keys(info,sort_keys, idx,
 		   (BUFFPEK *) alloc_dynamic(&info->buffpek), &info->tempfile))
@@ -417,9 +426,9 @@ int thr_write_keys(MI_SORT_PARAM *sort_param)
   SORT_INFO *sort_info=sort_param->sort_info;
   MI_CHECK *param=sort_info->param;
   ulong length, keys;
-  ulong *rec_per_key_part=param->rec_per_key_part;
+  ulong *rec_per_key_part;
   int got_error=sort_info->got_error;
-  uint i;
+  uint i,key;
   MI_INFO *info=sort_info->info;
   MYISAM_SHARE *share=info->s;
   MI_SORT_PARAM *sinfo;
@@ -428,20 +437,19 @@ int thr_write_keys(MI_SORT_PARAM *sort_param)
 
   for (i= 0, sinfo= sort_param ;
        i < sort_info->total_keys ;
-       i++, rec_per_key_part+=sinfo->keyinfo->keysegs, sinfo++)
+       i++, sinfo++)
   {
     if (!sinfo->sort_keys)
     {
       got_error=1;
       continue;
     }
-    if (!got_error)
+    if (!got_error && !sinfo->split_index)
     {
       share->state.key_map|=(ulonglong) 1 << sinfo->key;
-      if (param->testflag & T_STATISTICS)
-        update_key_parts(sinfo->keyinfo, rec_per_key_part,
-                         sinfo->unique, (ulonglong) info->state->records);
-      if (!sinfo->buffpek.elements)
+      if (sinfo->split_count > 1 && thr_gather_runs(sinfo))
+        got_error=1;
+      else if (!sinfo->buffpek.elements)
       {
         if (param->testflag & T_VERBOSE)
         {
@@ -541,10 +549,85 @@ int thr_write_keys(MI_SORT_PARAM *sort_param)
 	  got_error=1;
       }
     }
+    /*
+      unique[] is counted when the sorted keys are written, so the
+      statistics can only be updated here.
+      Statistics are stored for all keys, not only the created ones.
+    */
+    if (!sinfo->split_index && (param->testflag & T_STATISTICS))
+    {
+      rec_per_key_part=param->rec_per_key_part;
+      for (key=0 ; key < sinfo->key ; key++)
+        rec_per_key_part+=share->keyinfo[key].keysegs;
+      update_key_parts(sinfo->keyinfo, rec_per_key_part,
+                       sinfo->unique, (ulonglong) info->state->records);
+    }
   }
   my_free((gptr) mergebuf,MYF(MY_ALLOW_ZERO_PTR));
   return got_error;
 }
+
+
+/*
+  Move the sorted runs of all threads of a split key to the first thread
+
+  SYNOPSIS
+    thr_gather_runs()
+    sort_param		First of the split_count threads that sorted the key
+
+  NOTES
+    The runs of the other threads are appended to the temporary file of
+    the first thread, so that merge_index() can merge all of them in one
+    pass. The keys of the other threads are then only in the temporary
+    file of the first thread.
+
+  RETURN
+    0	ok
+    1	error
+*/
+
+static int NEAR_F thr_gather_runs(MI_SORT_PARAM *sort_param)
+{
+  MI_SORT_PARAM *sinfo, *end= sort_param + sort_param->split_count;
+  byte buff[IO_SIZE*4];
+  DBUG_ENTER("thr_gather_runs");
+
+  for (sinfo= sort_param+1 ; sinfo != end ; sinfo++)
+  {
+    my_off_t offset, length;
+    uint i;
+    if (!sinfo->buffpek.elements)
+      continue;
+    if (!my_b_inited(&sort_param->tempfile) &&
+        open_cached_file(&sort_param->tempfile, sort_param->tmpdir, "ST",
+                         DISK_BUFFER_SIZE, sort_param->sort_info->param->myf_rw))
+      DBUG_RETURN(1);
+    offset=my_b_tell(&sort_param->tempfile);
+    length=my_b_tell(&sinfo->tempfile);
+    if (flush_io_cache(&sinfo->tempfile) ||
+        reinit_io_cache(&sinfo->tempfile,READ_CACHE,0L,0,0))
+      DBUG_RETURN(1);
+    while (length)
+    {
+      uint count= (uint) min(length, sizeof(buff));
+      if (my_b_read(&sinfo->tempfile, buff, count) ||
+          my_b_write(&sort_param->tempfile, buff, count))
+        DBUG_RETURN(1);
+      length-=count;
+    }
+    for (i=0 ; i < sinfo->buffpek.elements ; i++)
+    {
+      BUFFPEK *buffpek= dynamic_element(&sinfo->buffpek, i, BUFFPEK*);
+      buffpek->file_pos+=offset;
+      if (insert_dynamic(&sort_param->buffpek, (gptr) buffpek))
+        DBUG_RETURN(1);
+    }
+    sort_param->keys+=sinfo->keys;
+    sinfo->buffpek.elements=0;
+    close_cached_file(&sinfo->tempfile);
+  }
+  DBUG_RETURN(0);
+} /* thr_gather_runs */
 #endif /* THREAD */
 
         /* Write all keys in memory to file for later merge */
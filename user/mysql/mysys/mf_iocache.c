@@ -459,14 +459,21 @@ void remove_io_thread(IO_CACHE *info)
 
   pthread_mutex_lock(&s->mutex);
   s->total--;
-  if (! s->count--)
-    pthread_cond_signal(&s->cond);
+  if (! s->count--)				/* We were the last reader */
+    pthread_cond_broadcast(&s->cond);
   pthread_mutex_unlock(&s->mutex);
 }
 
+/*
+  Wait until the block at 'pos' is read into the shared buffer
+
+  RETURN
+    0	Block is in the buffer
+    1	We have to read the block; mutex is locked
+*/
+
 static int lock_io_cache(IO_CACHE *info, my_off_t pos)
 {
-  int total;
   IO_CACHE_SHARE *s=info->share;
 
   pthread_mutex_lock(&s->mutex);
@@ -476,14 +483,21 @@ static int lock_io_cache(IO_CACHE *info, my_off_t pos)
     return 1;
   }
 
-  total=s->total;
   s->count--;
   while (!s->active || s->active->pos_in_file < pos)
+  {
+    /*
+      The thread that should have read the block has left.
+      Don't read the block again if it was already read before that, as
+      the file position is then already after the block.
+    */
+    if (s->count < 0)
+    {
+      s->count=s->total;
+      return 1;
+    }
     pthread_cond_wait(&s->cond, &s->mutex);
-
-  if (s->total < total)
-    return 1;
-
+  }
   pthread_mutex_unlock(&s->mutex);
   return 0;
 }
@@ -43,46 +43,218 @@
 
 typedef struct sec_link {
   struct sec_link *next_hash,**prev_hash;/* Blocks linked acc. to hash-value */
-  struct sec_link *next_used,*prev_used;
+  struct sec_link *next_used,*prev_used;	/* LRU chain, oldest first */
   struct sec_link *next_changed,**prev_changed;
   File file;
   my_off_t diskpos;
   byte *buffer;
+  ulong last_hit;				/* part->time of last request */
+  uint hits_left;				/* Hits before it may get hot */
   my_bool changed;
+  uchar temperature;				/* BLOCK_WARM or BLOCK_HOT */
 } SEC_LINK;
 
+/*
+  Replacement of blocks is done with a midpoint insertion LRU.
+  The used chain of a partition is split in a warm part (from used_first
+  up to hot_first) and a hot part (from hot_first to used_last).
+  New blocks are linked in as the most recently used warm block and blocks
+  are always replaced from the warm end of the chain. A warm block is
+  moved to the hot part only after it has been hit KEY_CACHE_WARM_HITS
+  more times while it was in the cache and there are more than
+  min_warm_blocks warm blocks. A block that is only touched once, like
+  the blocks read by a full index scan, can thus not push the blocks that
+  are used all the time out of the cache.
+  A hot block that has not been used within the last
+  blocks_used*key_cache_age_threshold/100 requests to the partition is
+  moved back to the warm part. key_cache_division_limit is the minimum
+  percentage of warm blocks; With the default of 100 there are no hot
+  blocks and the chain is a plain LRU.
+*/
 
-static SEC_LINK *find_key_block(int file,my_off_t filepos,int *error);
+#define BLOCK_WARM		0
+#define BLOCK_HOT		1
+#define KEY_CACHE_WARM_HITS	2
+
+/*
+  The key cache is split in key_cache_partitions independent partitions.
+  A block belongs to the partition selected by the hash of its file and
+  position; Each partition has its own mutex, memory, hash, LRU chain and
+  changed/file block lists, so that threads working on different blocks
+  don't have to wait for each other.
+  The partition structures are never freed; resize_key_cache() locks all
+  of them and a reader that got the wrong partition because the number of
+  partitions changed will notice this and retry.
+*/
+
+typedef struct st_key_cache_part {
+  pthread_mutex_t lock;
+  SEC_LINK *block_root,**hash_root,*used_first,*used_last;
+  SEC_LINK *hot_first;				/* First hot block or 0 */
+  uint	warm_blocks, hot_blocks, min_warm_blocks;
+  ulong	time;					/* Requests, for block age */
+  byte	HUGE_PTR *block_mem;
+  int	disk_blocks;
+  uint	disk_blocks_used, hash_blocks;
+  ulong	blocks_used, blocks_changed;
+  ulong	w_requests, writes, r_requests, reads, lock_waits;
+  SEC_LINK *changed_blocks[CHANGED_BLOCKS_HASH];
+  SEC_LINK *file_blocks[CHANGED_BLOCKS_HASH];
+} KEY_CACHE_PART;
+
+#define KEY_CACHE_HASH(F,P) ((ulong) ((P) >> key_cache_shift) + (ulong) (F))
+#define KEY_CACHE_BUCKET(part,H) \
+  (((H) / key_cache_parts) & ((part)->hash_blocks-1))
+
+static SEC_LINK *find_key_block(KEY_CACHE_PART *part, int file,
+				my_off_t filepos, int *error);
 static int flush_all_key_blocks();
 
 	/* static variables in this file */
-static SEC_LINK *_my_block_root,**_my_hash_root,
-		*_my_used_first,*_my_used_last;
-static int	_my_disk_blocks;
-static uint	_my_disk_blocks_used, _my_hash_blocks;
+static KEY_CACHE_PART key_cache_part[MAX_KEY_CACHE_PARTITIONS];
+static uint	key_cache_parts;		/* Active partitions */
+static my_bool	key_cache_part_locks_inited;
 static uint	key_cache_shift;
 ulong		_my_blocks_used,_my_blocks_changed;
 ulong		_my_cache_w_requests,_my_cache_write,_my_cache_r_requests,
 		_my_cache_read;
 uint		key_cache_block_size=DEFAULT_KEYCACHE_BLOCK_SIZE;
-static byte	HUGE_PTR *_my_block_mem;
-static SEC_LINK *changed_blocks[CHANGED_BLOCKS_HASH];
-static SEC_LINK *file_blocks[CHANGED_BLOCKS_HASH];
+uint		key_cache_partitions=1;
+uint		key_cache_division_limit=100, key_cache_age_threshold=300;
+static ulong	uncached_w_requests,uncached_writes,uncached_r_requests,
+		uncached_reads;		/* I/O done outside of the partitions */
 #ifndef DBUG_OFF
 static my_bool	_my_printed;
 #endif
 
 
+static void init_key_cache_part_locks()
+{
+  if (!key_cache_part_locks_inited)
+  {
+    uint i;
+    for (i=0 ; i < MAX_KEY_CACHE_PARTITIONS ; i++)
+      pthread_mutex_init(&key_cache_part[i].lock, MY_MUTEX_INIT_FAST);
+    key_cache_part_locks_inited=1;
+  }
+}
+
+
+static void lock_all_key_cache_parts()
+{
+  uint i;
+  for (i=0 ; i < MAX_KEY_CACHE_PARTITIONS ; i++)
+    pthread_mutex_lock(&key_cache_part[i].lock);
+}
+
+
+static void unlock_all_key_cache_parts()
+{
+  uint i;
+  for (i=0 ; i < MAX_KEY_CACHE_PARTITIONS ; i++)
+    pthread_mutex_unlock(&key_cache_part[i].lock);
+}
+
+
+/*
+  Find and lock the partition that caches a block
+
+  RETURN
+    0	No key cache (not initialized or a resize failed)
+    #	Locked partition
+*/
+
+static KEY_CACHE_PART *lock_key_cache_part(File file, my_off_t filepos)
+{
+  KEY_CACHE_PART *part;
+  uint parts;
+  while ((parts= key_cache_parts))
+  {
+    part= key_cache_part + KEY_CACHE_HASH(file, filepos) % parts;
+    if (pthread_mutex_trylock(&part->lock))
+    {
+      pthread_mutex_lock(&part->lock);
+      part->lock_waits++;
+    }
+    if (parts == key_cache_parts)
+      return part;
+    pthread_mutex_unlock(&part->lock);	/* Resized while we waited */
+  }
+  return 0;
+}
+
+
+	/* Init one partition; Returns blocks in use */
+
+static int init_key_cache_part(KEY_CACHE_PART *part, ulong use_mem)
+{
+  uint blocks,length;
+  DBUG_ENTER("init_key_cache_part");
+
+  blocks= (uint) (use_mem/(sizeof(SEC_LINK)+sizeof(SEC_LINK*)*5/4+
+			   key_cache_block_size));
+  /* No use to have very few blocks */
+  if (blocks >= 8 && part->disk_blocks < 0)
+  {
+    for (;;)
+    {
+      /* Set hash_blocks to the next bigger 2 power */
+      part->hash_blocks=(uint) 1 << (my_bit_log2(blocks*5/4)+1);
+      while ((length=(uint) blocks*sizeof(SEC_LINK)+
+	      sizeof(SEC_LINK*)*part->hash_blocks)+
+	     ((ulong) blocks << key_cache_shift) >
+	     use_mem)
+	blocks--;
+      if ((part->block_mem=my_malloc_lock((ulong) blocks << key_cache_shift,
+					  MYF(0))))
+      {
+	if ((part->block_root=(SEC_LINK*) my_malloc((uint) length,MYF(0))) != 0)
+	  break;
+	my_free_lock(part->block_mem,MYF(0));
+      }
+      if (blocks < 8)
+	goto err;
+      blocks=blocks/4*3;
+    }
+    part->disk_blocks=(int) blocks;
+    part->hash_root= (SEC_LINK**) (part->block_root+blocks);
+    bzero((byte*) part->hash_root,part->hash_blocks*sizeof(SEC_LINK*));
+    part->used_first=part->used_last=part->hot_first=0;
+    part->warm_blocks=part->hot_blocks=0;
+    part->min_warm_blocks= (uint) ((ulonglong) blocks *
+				   key_cache_division_limit / 100);
+    if (!part->min_warm_blocks)
+      part->min_warm_blocks=1;
+    part->time=0;
+    part->blocks_used=part->disk_blocks_used=part->blocks_changed=0;
+    part->w_requests=part->r_requests=part->reads=part->writes=0;
+    part->lock_waits=0;
+    DBUG_PRINT("exit",("disk_blocks: %d  block_root: %lx  hash_blocks: %d  hash_root: %lx",
+		       part->disk_blocks,part->block_root,part->hash_blocks,
+		       part->hash_root));
+  }
+  bzero((gptr) part->changed_blocks,
+	sizeof(part->changed_blocks[0])*CHANGED_BLOCKS_HASH);
+  bzero((gptr) part->file_blocks,
+	sizeof(part->file_blocks[0])*CHANGED_BLOCKS_HASH);
+  DBUG_RETURN((int) blocks);
+
+err:
+  DBUG_RETURN(0);
+}
+
+
 	/* Init of disk_buffert */
 	/* Returns blocks in use */
 	/* ARGSUSED */
 
 int init_key_cache(ulong use_mem)
 {
-  uint blocks,length;
+  uint i,parts;
+  int blocks,part_blocks;
   DBUG_ENTER("init_key_cache");
 
-  if (key_cache_inited && _my_disk_blocks > 0)
+  if (key_cache_inited && key_cache_parts)
   {
     DBUG_PRINT("warning",("key cache already in use")); /* purecov: inspected */
     DBUG_RETURN(0); /* purecov: inspected */
@@ -90,7 +262,8 @@ int init_key_cache(ulong use_mem)
   if (! key_cache_inited)
   {
     key_cache_inited=TRUE;
-    _my_disk_blocks= -1;
+    for (i=0 ; i < MAX_KEY_CACHE_PARTITIONS ; i++)
+      key_cache_part[i].disk_blocks= -1;
     key_cache_shift=my_bit_log2(key_cache_block_size);
     DBUG_PRINT("info",("key_cache_block_size: %u  key_cache_shift: %u",
 		       key_cache_block_size, key_cache_shift));
@@ -98,45 +271,39 @@ int init_key_cache(ulong use_mem)
     _my_printed=0;
 #endif
   }
-
-  blocks= (uint) (use_mem/(sizeof(SEC_LINK)+sizeof(SEC_LINK*)*5/4+
-			   key_cache_block_size));
-  /* No use to have very few blocks */
-  if (blocks >= 8 && _my_disk_blocks < 0)
+  init_key_cache_part_locks();
+
+  parts= key_cache_partitions;
+  if (parts > MAX_KEY_CACHE_PARTITIONS)
+    parts= MAX_KEY_CACHE_PARTITIONS;
+  /* Don't let the partitions get so small that they are useless */
+  while (parts > 1 && use_mem / parts < KEY_CACHE_MIN_PARTITION_SIZE)
+    parts--;
+  if (!parts)
+    parts=1;
+
+  blocks=0;
+  for (i=0 ; i < parts ; i++)
   {
-    for (;;)
+    if (!(part_blocks=init_key_cache_part(key_cache_part+i, use_mem/parts)))
     {
-      /* Set my_hash_blocks to the next bigger 2 power */
-      _my_hash_blocks=(uint) 1 << (my_bit_log2(blocks*5/4)+1);
-      while ((length=(uint) blocks*sizeof(SEC_LINK)+
-	      sizeof(SEC_LINK*)*_my_hash_blocks)+
-	     ((ulong) blocks << key_cache_shift) >
-	     use_mem)
-	blocks--;
-      if ((_my_block_mem=my_malloc_lock((ulong) blocks << key_cache_shift,
-					MYF(0))))
+      while (i--)
       {
-	if ((_my_block_root=(SEC_LINK*) my_malloc((uint) length,MYF(0))) != 0)
-	  break;
-	my_free_lock(_my_block_mem,MYF(0));
+	KEY_CACHE_PART *part= key_cache_part+i;
+	my_free_lock((gptr) part->block_mem,MYF(0));
+	my_free((gptr) part->block_root,MYF(0));
+	part->disk_blocks= -1;
       }
-      if (blocks < 8)
-	goto err;
-      blocks=blocks/4*3;
+      goto err;
     }
-    _my_disk_blocks=(int) blocks;
-    _my_hash_root= (SEC_LINK**) (_my_block_root+blocks);
-    bzero((byte*) _my_hash_root,_my_hash_blocks*sizeof(SEC_LINK*));
-    _my_used_first=_my_used_last=0;
-    _my_blocks_used=_my_disk_blocks_used=_my_blocks_changed=0;
-    _my_cache_w_requests=_my_cache_r_requests=_my_cache_read=_my_cache_write=0;
-    DBUG_PRINT("exit",("disk_blocks: %d  block_root: %lx  _my_hash_blocks: %d  hash_root: %lx",
-		       _my_disk_blocks,_my_block_root,_my_hash_blocks,
-		       _my_hash_root));
-  }
-  bzero((gptr) changed_blocks,sizeof(changed_blocks[0])*CHANGED_BLOCKS_HASH);
-  bzero((gptr) file_blocks,sizeof(file_blocks[0])*CHANGED_BLOCKS_HASH);
-  DBUG_RETURN((int) blocks);
+    blocks+= part_blocks;
+  }
+  _my_blocks_used=_my_blocks_changed=0;
+  _my_cache_w_requests=_my_cache_r_requests=_my_cache_read=_my_cache_write=0;
+  uncached_w_requests=uncached_writes=uncached_r_requests=uncached_reads=0;
+  key_cache_parts= parts;
+  DBUG_PRINT("exit",("partitions: %u  blocks: %d", parts, blocks));
+  DBUG_RETURN(blocks);
 
 err:
   my_errno=ENOMEM;
@@ -151,6 +318,9 @@ err:
     resize_key_cache()
     use_mem		Bytes to use for new key cache
 
+  NOTES
+    The number of partitions is taken from key_cache_partitions.
+
   RETURN VALUES
     0	Error
     #	number of blocks in key cache
@@ -161,15 +331,19 @@ int resize_key_cache(ulong use_mem)
 {
   int block;
   pthread_mutex_lock(&THR_LOCK_keycache);
+  init_key_cache_part_locks();
+  lock_all_key_cache_parts();
   if (flush_all_key_blocks())
   {
     /* TODO: If this happens, we should write a warning in the log file ! */
+    unlock_all_key_cache_parts();
     pthread_mutex_unlock(&THR_LOCK_keycache);
     return 0;
   }
   end_key_cache();
   /* The following will work even if memory is 0 */
   block=init_key_cache(use_mem);
+  unlock_all_key_cache_parts();
   pthread_mutex_unlock(&THR_LOCK_keycache);  
   return block;
 }
@@ -179,29 +353,127 @@ int resize_key_cache(ulong use_mem)
 
 void end_key_cache(void)
 {
+  uint i;
   DBUG_ENTER("end_key_cache");
-  if (! _my_blocks_changed)
+  update_key_cache_stats();
+  for (i=0 ; i < key_cache_parts ; i++)
   {
-    if (_my_disk_blocks > 0)
+    KEY_CACHE_PART *part= key_cache_part+i;
+    if (! part->blocks_changed && part->disk_blocks > 0)
     {
-      my_free_lock((gptr) _my_block_mem,MYF(0));
-      my_free((gptr) _my_block_root,MYF(0));
-      _my_disk_blocks= -1;
+      my_free_lock((gptr) part->block_mem,MYF(0));
+      my_free((gptr) part->block_root,MYF(0));
+      part->disk_blocks= -1;
     }
+    part->hash_blocks=0;
+    part->blocks_used=0;
   }
+  key_cache_parts=0;
   key_cache_inited=0;
-  _my_hash_blocks=_my_blocks_used=0;
   DBUG_PRINT("status",
 	     ("used: %d  changed: %d  w_requests: %ld  writes: %ld  r_requests: %ld  reads: %ld",
 	      _my_blocks_used,_my_blocks_changed,_my_cache_w_requests,
 	      _my_cache_write,_my_cache_r_requests,_my_cache_read));
+  _my_blocks_used=0;
   DBUG_VOID_RETURN;
 } /* end_key_cache */
 
 
-static inline void link_into_file_blocks(SEC_LINK *next, int file)
+/*
+  Get the read requests and reads of all partitions; Like
+  update_key_cache_stats(), but doesn't touch the global variables
+*/
+
+void get_key_cache_reads(ulong *r_requests, ulong *reads)
+{
+  uint i;
+  ulong requests_sum=uncached_r_requests, reads_sum=uncached_reads;
+  for (i=0 ; i < key_cache_parts ; i++)
+  {
+    requests_sum+= key_cache_part[i].r_requests;
+    reads_sum+=    key_cache_part[i].reads;
+  }
+  *r_requests=requests_sum;
+  *reads=reads_sum;
+}
+
+
+/*
+  Collect the statistics of all partitions into the _my_cache_xxx and
+  _my_blocks_xxx variables. The counters are read without locks; they
+  are only used for SHOW STATUS and similar reports.
+*/
+
+void update_key_cache_stats(void)
+{
+  uint i;
+  ulong blocks_used=0, blocks_changed=0;
+  ulong w_requests=uncached_w_requests, writes=uncached_writes;
+  ulong r_requests=uncached_r_requests, reads=uncached_reads;
+  for (i=0 ; i < key_cache_parts ; i++)
+  {
+    KEY_CACHE_PART *part= key_cache_part+i;
+    blocks_used+=    part->blocks_used;
+    blocks_changed+= part->blocks_changed;
+    w_requests+=     part->w_requests;
+    writes+=         part->writes;
+    r_requests+=     part->r_requests;
+    reads+=          part->reads;
+  }
+  _my_blocks_used=blocks_used;
+  _my_blocks_changed=blocks_changed;
+  _my_cache_w_requests=w_requests;
+  _my_cache_write=writes;
+  _my_cache_r_requests=r_requests;
+  _my_cache_read=reads;
+}
+
+
+	/* Clear the request and wait counters of all partitions */
+
+void reset_key_cache_stats(void)
+{
+  uint i;
+  uncached_w_requests=uncached_writes=uncached_r_requests=uncached_reads=0;
+  for (i=0 ; i < key_cache_parts ; i++)
+  {
+    KEY_CACHE_PART *part= key_cache_part+i;
+    part->w_requests=part->writes=part->r_requests=part->reads=0;
+    part->lock_waits=0;
+  }
+  update_key_cache_stats();
+}
+
+
+/*
+  Get statistics for one partition of the key cache
+
+  RETURN
+    0	ok
+    1	No such partition
+*/
+
+my_bool get_key_cache_part_stats(uint part_no, KEY_CACHE_PART_STATS *stats)
 {
-  reg1 SEC_LINK **ptr= &file_blocks[(uint) file & CHANGED_BLOCKS_MASK];
+  KEY_CACHE_PART *part;
+  if (part_no >= key_cache_parts)
+    return 1;
+  part= key_cache_part+part_no;
+  stats->blocks_used=    part->blocks_used;
+  stats->blocks_changed= part->blocks_changed;
+  stats->r_requests=     part->r_requests;
+  stats->reads=          part->reads;
+  stats->w_requests=     part->w_requests;
+  stats->writes=         part->writes;
+  stats->lock_waits=     part->lock_waits;
+  return 0;
+}
+
+
+static inline void link_into_file_blocks(KEY_CACHE_PART *part, SEC_LINK *next,
+					 int file)
+{
+  reg1 SEC_LINK **ptr= &part->file_blocks[(uint) file & CHANGED_BLOCKS_MASK];
   next->prev_changed= ptr;
   if ((next->next_changed= *ptr))
     (*ptr)->prev_changed= &next->next_changed;
@@ -209,9 +481,10 @@ static inline void link_into_file_blocks(SEC_LINK *next, int file)
 }
 
 
-static inline void relink_into_file_blocks(SEC_LINK *next, int file)
+static inline void relink_into_file_blocks(KEY_CACHE_PART *part,
+					   SEC_LINK *next, int file)
 {
-  reg1 SEC_LINK **ptr= &file_blocks[(uint) file & CHANGED_BLOCKS_MASK];
+  reg1 SEC_LINK **ptr= &part->file_blocks[(uint) file & CHANGED_BLOCKS_MASK];
   if (next->next_changed)
     next->next_changed->prev_changed=next->prev_changed;
   *next->prev_changed=next->next_changed;
@@ -221,9 +494,10 @@ static inline void relink_into_file_blocks(SEC_LINK *next, int file)
   *ptr=next;
 }
 
-static inline void link_changed_to_file(SEC_LINK *next,int file)
+static inline void link_changed_to_file(KEY_CACHE_PART *part, SEC_LINK *next,
+					int file)
 {
-  reg1 SEC_LINK **ptr= &file_blocks[(uint) file & CHANGED_BLOCKS_MASK];
+  reg1 SEC_LINK **ptr= &part->file_blocks[(uint) file & CHANGED_BLOCKS_MASK];
   if (next->next_changed)
     next->next_changed->prev_changed=next->prev_changed;
   *next->prev_changed=next->next_changed;
@@ -232,12 +506,13 @@ static inline void link_changed_to_file(SEC_LINK *next,int file)
     (*ptr)->prev_changed= &next->next_changed;
   *ptr=next;
   next->changed=0;
-  _my_blocks_changed--;
+  part->blocks_changed--;
 }
 
-static inline void link_file_to_changed(SEC_LINK *next)
+static inline void link_file_to_changed(KEY_CACHE_PART *part, SEC_LINK *next)
 {
-  reg1 SEC_LINK **ptr= &changed_blocks[(uint) next->file & CHANGED_BLOCKS_MASK];
+  reg1 SEC_LINK **ptr= &part->changed_blocks[(uint) next->file &
+					     CHANGED_BLOCKS_MASK];
   if (next->next_changed)
     next->next_changed->prev_changed=next->prev_changed;
   *next->prev_changed=next->next_changed;
@@ -246,7 +521,96 @@ static inline void link_file_to_changed(SEC_LINK *next)
     (*ptr)->prev_changed= &next->next_changed;
   *ptr=next;
   next->changed=1;
-  _my_blocks_changed++;
+  part->blocks_changed++;
+}
+
+
+/*
+  Maintenance of the used chain (see the comment at the start of the file)
+  All functions are called with the partition locked
+*/
+
+static void unlink_used_block(KEY_CACHE_PART *part, SEC_LINK *block)
+{
+  if (block == part->hot_first)
+    part->hot_first=block->next_used;
+  if (block->prev_used)
+    block->prev_used->next_used=block->next_used;
+  else
+    part->used_first=block->next_used;
+  if (block->next_used)
+    block->next_used->prev_used=block->prev_used;
+  else
+    part->used_last=block->prev_used;
+  if (block->temperature == BLOCK_HOT)
+    part->hot_blocks--;
+  else
+    part->warm_blocks--;
+}
+
+
+	/* Link a block as warm before 'next' (0 = last in chain) */
+
+static void link_warm_block(KEY_CACHE_PART *part, SEC_LINK *block,
+			    SEC_LINK *next)
+{
+  block->temperature=BLOCK_WARM;
+  if ((block->next_used=next))
+  {
+    block->prev_used=next->prev_used;
+    next->prev_used=block;
+  }
+  else
+  {
+    block->prev_used=part->used_last;
+    part->used_last=block;
+  }
+  if (block->prev_used)
+    block->prev_used->next_used=block;
+  else
+    part->used_first=block;
+  part->warm_blocks++;
+}
+
+
+	/* Link a block as the most recently used hot block */
+
+static void link_hot_block(KEY_CACHE_PART *part, SEC_LINK *block)
+{
+  block->temperature=BLOCK_HOT;
+  block->next_used=0;
+  if ((block->prev_used=part->used_last))
+    part->used_last->next_used=block;
+  else
+    part->used_first=block;
+  part->used_last=block;
+  if (!part->hot_first)
+    part->hot_first=block;
+  part->hot_blocks++;
+}
+
+
+/*
+  Move hot blocks that are too old, or that are needed to keep
+  min_warm_blocks warm blocks, to the warm part of the chain. The oldest
+  hot block is next to the most recently used warm block, so only the
+  border between the parts has to be moved.
+*/
+
+static void cool_key_cache_part(KEY_CACHE_PART *part)
+{
+  SEC_LINK *block;
+  ulong max_age= (ulong) ((ulonglong) part->blocks_used *
+			  key_cache_age_threshold / 100);
+  while ((block=part->hot_first) &&
+	 (part->warm_blocks < part->min_warm_blocks ||
+	  part->time - block->last_hit > max_age))
+  {
+    block->temperature=BLOCK_WARM;
+    part->hot_first=block->next_used;
+    part->hot_blocks--;
+    part->warm_blocks++;
+  }
 }
 
 
@@ -256,6 +620,7 @@ static inline void link_file_to_changed(SEC_LINK *next)
 
 #ifndef DBUG_OFF
 static void test_key_cache(const char *where, my_bool lock);
+static void test_key_cache_part(KEY_CACHE_PART *part, const char *where);
 #endif
 
 
@@ -272,6 +637,8 @@ byte *key_cache_read(File file, my_off_t filepos, byte *buff, uint length,
 		     int return_buffer __attribute__((unused)))
 {
   reg1 SEC_LINK *next;
+  KEY_CACHE_PART *part;
+  byte *start=buff;
   int error=0;
   DBUG_ENTER("key_cache_read");
   DBUG_PRINT("enter", ("file %u, filepos %lu, length %u",
@@ -281,39 +648,34 @@ byte *key_cache_read(File file, my_off_t filepos, byte *buff, uint length,
   if (block_length > key_cache_block_size)
     return_buffer=0;
 #endif
-  if (_my_disk_blocks > 0)
+  if (key_cache_parts)
   {						/* We have key_cacheing */
-    byte *start=buff;
     uint read_length;
-    pthread_mutex_lock(&THR_LOCK_keycache);
-    if (_my_disk_blocks <= 0)			/* Resize failed */
-    {
-      pthread_mutex_unlock(&THR_LOCK_keycache);
-      goto no_key_cache;
-    }
     do
     {
-      _my_cache_r_requests++;
+      if (!(part=lock_key_cache_part(file,filepos)))
+	goto no_key_cache;			/* Resize failed */
+      part->r_requests++;
       read_length= (length > key_cache_block_size ? key_cache_block_size :
 		    length);
-      if (!(next=find_key_block(file,filepos,&error)))
+      if (!(next=find_key_block(part,file,filepos,&error)))
       {
-	pthread_mutex_unlock(&THR_LOCK_keycache);
+	pthread_mutex_unlock(&part->lock);
 	DBUG_RETURN ((byte*) 0);       		/* Got a fatal error */
       }
       if (error)
       {					/* Didn't find it in cache */
 	if (my_pread(file,next->buffer,read_length,filepos,MYF(MY_NABP)))
 	{
-	  pthread_mutex_unlock(&THR_LOCK_keycache);
+	  pthread_mutex_unlock(&part->lock);
 	  DBUG_RETURN((byte*) 0);
 	}
-	_my_cache_read++;
+	part->reads++;
       }
 #ifndef THREAD				/* buffer may be used a long time */
       if (return_buffer)
       {
-	pthread_mutex_unlock(&THR_LOCK_keycache);
+	pthread_mutex_unlock(&part->lock);
 	DBUG_RETURN (next->buffer);
       }
 #endif
@@ -321,19 +683,19 @@ byte *key_cache_read(File file, my_off_t filepos, byte *buff, uint length,
 	bmove512(buff,next->buffer,read_length);
       else
 	memcpy(buff,next->buffer,(size_t) read_length);
+      pthread_mutex_unlock(&part->lock);
       buff+=read_length;
       filepos+=read_length;
     } while ((length-= read_length));
-    pthread_mutex_unlock(&THR_LOCK_keycache);
     DBUG_RETURN(start);
   }
 
 no_key_cache:
-  _my_cache_r_requests++;
-  _my_cache_read++;
+  uncached_r_requests++;
+  uncached_reads++;
   if (my_pread(file,(byte*) buff,length,filepos,MYF(MY_NABP)))
     error=1;
-  DBUG_RETURN(error ? (byte*) 0 : buff);
+  DBUG_RETURN(error ? (byte*) 0 : start);
 } /* key_cache_read */
 
 
@@ -346,14 +708,16 @@ int key_cache_write(File file, my_off_t filepos, byte *buff, uint length,
 		    int dont_write)
 {
   reg1 SEC_LINK *next;
+  KEY_CACHE_PART *part;
   int error=0;
+  my_bool counted=0;
   DBUG_ENTER("key_cache_write");
   DBUG_PRINT("enter", ("file %u, filepos %lu, length %u",
 		       (uint) file, (ulong) filepos, length));
 
   if (!dont_write)
   {						/* Forced write of buffer */
-    _my_cache_write++;
+    uncached_writes++;
     if (my_pwrite(file,buff,length,filepos,MYF(MY_NABP | MY_WAIT_IF_FULL)))
       DBUG_RETURN(1);
   }
@@ -361,47 +725,49 @@ int key_cache_write(File file, my_off_t filepos, byte *buff, uint length,
 #if !defined(DBUG_OFF) && defined(EXTRA_DEBUG)
   DBUG_EXECUTE("check_keycache",test_key_cache("start of key_cache_write",1););
 #endif
-  if (_my_disk_blocks > 0)
+  if (key_cache_parts)
   {						/* We have key_cacheing */
     uint read_length;
-    pthread_mutex_lock(&THR_LOCK_keycache);
-    if (_my_disk_blocks <= 0)			/* If resize failed */
-    {
-      pthread_mutex_unlock(&THR_LOCK_keycache);
-      goto no_key_cache;
-    }
-
-    _my_cache_w_requests++;
     do
     {
+      if (!(part=lock_key_cache_part(file,filepos)))
+	goto no_key_cache;			/* If resize failed */
+      if (!counted)
+      {
+	part->w_requests++;
+	counted=1;
+      }
       read_length= length > key_cache_block_size ? key_cache_block_size : length;
-      if (!(next=find_key_block(file,filepos,&error)))
+      if (!(next=find_key_block(part,file,filepos,&error)))
+      {
+	pthread_mutex_unlock(&part->lock);
 	goto end;				/* Fatal error */
+      }
       if (!dont_write)				/* If we wrote buff at start */
       {
 	if (next->changed)			/* Unlink from changed list */
-	  link_changed_to_file(next,next->file);
+	  link_changed_to_file(part,next,next->file);
       }
       else if (!next->changed)
-	link_file_to_changed(next);		/* Add to changed list */
+	link_file_to_changed(part,next);	/* Add to changed list */
 
       if (!(read_length & 511))
 	bmove512(next->buffer,buff,read_length);
       else
 	memcpy(next->buffer,buff,(size_t) read_length);
+      pthread_mutex_unlock(&part->lock);
       buff+=read_length;
       filepos+=read_length;
     } while ((length-= read_length));
     error=0;
-    pthread_mutex_unlock(&THR_LOCK_keycache);
     goto end;
   }
 
 no_key_cache:
   if (dont_write)
   {						/* We must write, no cache */
-    _my_cache_w_requests++;
-    _my_cache_write++;
+    uncached_w_requests++;
+    uncached_writes++;
     if (my_pwrite(file,(byte*) buff,length,filepos,
 		  MYF(MY_NABP | MY_WAIT_IF_FULL)))
       error=1;
@@ -417,8 +783,10 @@ end:
 
 	/* Find block in cache */
 	/* IF found sector and error is set then next->changed is cleared */
+	/* The partition must be locked */
 
-static SEC_LINK *find_key_block(int file, my_off_t filepos, int *error)
+static SEC_LINK *find_key_block(KEY_CACHE_PART *part, int file,
+				my_off_t filepos, int *error)
 {
   reg1 SEC_LINK *next,**start;
   DBUG_ENTER("find_key_block");
@@ -426,50 +794,48 @@ static SEC_LINK *find_key_block(int file, my_off_t filepos, int *error)
 		       (uint) file, (ulong) filepos));
 
 #if !defined(DBUG_OFF) && defined(EXTRA_DEBUG)
-  DBUG_EXECUTE("check_keycache2",test_key_cache("start of find_key_block",0););
+  DBUG_EXECUTE("check_keycache2",
+	       test_key_cache_part(part,"start of find_key_block"););
 #endif
 
   *error=0;
-  next= *(start= &_my_hash_root[((ulong) (filepos >> key_cache_shift)+(ulong) file) &
-				(_my_hash_blocks-1)]);
+  next= *(start= &part->hash_root[KEY_CACHE_BUCKET(part,
+						   KEY_CACHE_HASH(file,
+								  filepos))]);
   while (next && (next->diskpos != filepos || next->file != file))
     next= next->next_hash;
 
+  part->time++;
   if (next)
   {						/* Found block */
-    if (next != _my_used_last)
-    {						/* Relink used-chain */
-      if (next == _my_used_first)
-	_my_used_first=next->next_used;
-      else
-      {
-	next->prev_used->next_used = next->next_used;
-	next->next_used->prev_used = next->prev_used;
-      }
-      next->prev_used=_my_used_last;
-      _my_used_last->next_used=next;
+    unlink_used_block(part,next);
+    if (next->temperature == BLOCK_HOT ||
+	(!next->hits_left && part->warm_blocks >= part->min_warm_blocks))
+      link_hot_block(part,next);		/* Hit in hot or proven block */
+    else
+    {
+      if (next->hits_left)
+	next->hits_left--;
+      link_warm_block(part,next,part->hot_first);
     }
   }
   else
   {						/* New block */
-    if (_my_disk_blocks_used+1 <= (uint) _my_disk_blocks)
+    if (part->disk_blocks_used+1 <= (uint) part->disk_blocks)
     {						/* There are unused blocks */
-      next= &_my_block_root[_my_blocks_used++]; /* Link in hash-chain */
-      next->buffer=ADD_TO_PTR(_my_block_mem,
-			      ((ulong) _my_disk_blocks_used << key_cache_shift),
+      next= &part->block_root[part->blocks_used++]; /* Link in hash-chain */
+      next->buffer=ADD_TO_PTR(part->block_mem,
+			      ((ulong) part->disk_blocks_used <<
+			       key_cache_shift),
 			      byte*);
       /* link first in file_blocks */
       next->changed=0;
-      link_into_file_blocks(next,file);
-      _my_disk_blocks_used++;
-      if (!_my_used_first)
-	_my_used_first=next;
-      if (_my_used_last)
-	_my_used_last->next_used=next; /* Last in used-chain */
+      link_into_file_blocks(part,next,file);
+      part->disk_blocks_used++;
     }
     else
     {						/* Reuse old block */
-      next= _my_used_first;
+      next= part->used_first;			/* Oldest warm block */
       if (next->changed)
       {
 	if (my_pwrite(next->file,next->buffer,key_cache_block_size,
@@ -479,56 +845,48 @@ static SEC_LINK *find_key_block(int file, my_off_t filepos, int *error)
 	  *error=1;
 	  return((SEC_LINK*) 0);
 	}
-	_my_cache_write++;
-	link_changed_to_file(next,file);
+	part->writes++;
+	link_changed_to_file(part,next,file);
       }
       else
       {
 	if (next->file == -1)
-	  link_into_file_blocks(next,file);
+	  link_into_file_blocks(part,next,file);
 	else
-	  relink_into_file_blocks(next,file);
+	  relink_into_file_blocks(part,next,file);
       }
       if (next->prev_hash)			/* If in hash-link */
 	if ((*next->prev_hash=next->next_hash) != 0) /* Remove from link */
 	  next->next_hash->prev_hash= next->prev_hash;
-
-      _my_used_last->next_used=next;
-      _my_used_first=next->next_used;
+      unlink_used_block(part,next);
     }
     if (*start)					/* Link in first in h.-chain */
       (*start)->prev_hash= &next->next_hash;
     next->next_hash= *start; next->prev_hash=start; *start=next;
-    next->prev_used=_my_used_last;
     next->file=file;
     next->diskpos=filepos;
+    /* A new block is the most recently used warm block */
+    next->hits_left= KEY_CACHE_WARM_HITS;
+    link_warm_block(part,next,part->hot_first);
     *error=1;					/* Block wasn't in memory */
   }
-  _my_used_last=next;
+  next->last_hit= part->time;
+  cool_key_cache_part(part);
 #if !defined(DBUG_OFF) && defined(EXTRA_DEBUG)
-  DBUG_EXECUTE("check_keycache2",test_key_cache("end of find_key_block",0););
+  DBUG_EXECUTE("check_keycache2",
+	       test_key_cache_part(part,"end of find_key_block"););
 #endif
   DBUG_RETURN(next);
 } /* find_key_block */
 
 
-static void free_block(SEC_LINK *used)
+static void free_block(KEY_CACHE_PART *part, SEC_LINK *used)
 {
   used->file= -1;
   used->changed=0;
-  if (used != _my_used_first)			/* Relink used-chain */
-  {
-    if (used == _my_used_last)
-      _my_used_last=used->prev_used;
-    else
-    {
-      used->prev_used->next_used = used->next_used;
-      used->next_used->prev_used = used->prev_used;
-    }
-    used->next_used=_my_used_first;
-    used->next_used->prev_used=used;
-    _my_used_first=used;
-  }
+  unlink_used_block(part,used);		/* Reuse this block first */
+  link_warm_block(part,used,part->used_first);
+  cool_key_cache_part(part);
   if ((*used->prev_hash=used->next_hash))	/* Relink hash-chain */
     used->next_hash->prev_hash= used->prev_hash;
   if (used->next_changed)			/* Relink changed/file list */
@@ -565,7 +923,10 @@ static int flush_cached_blocks(File file, SEC_LINK **cache, uint count)
 }
 
 
-static int flush_key_blocks_int(File file, enum flush_type type)
+	/* Flush the blocks of one file in one partition; part is locked */
+
+static int flush_key_blocks_int(KEY_CACHE_PART *part, File file,
+				enum flush_type type)
 {
   int error=0,last_errno=0;
   uint count=0;
@@ -573,21 +934,22 @@ static int flush_key_blocks_int(File file, enum flush_type type)
   SEC_LINK *used,*next;
   DBUG_ENTER("flush_key_blocks_int");
   DBUG_PRINT("enter",("file: %d  blocks_used: %d  blocks_changed: %d",
-		      file,_my_blocks_used,_my_blocks_changed));
+		      file,part->blocks_used,part->blocks_changed));
 
   cache=cache_buff;				/* If no key cache */
-  if (_my_disk_blocks > 0 &&
+  if (part->disk_blocks > 0 &&
       (!my_disable_flush_key_blocks || type != FLUSH_KEEP))
   {
 #if !defined(DBUG_OFF) && defined(EXTRA_DEBUG)
-    DBUG_EXECUTE("check_keycache",test_key_cache("start of flush_key_blocks",0););
+    DBUG_EXECUTE("check_keycache",
+		 test_key_cache_part(part,"start of flush_key_blocks"););
 #endif
     if (type != FLUSH_IGNORE_CHANGED)
     {
       /* Count how many key blocks we have to cache to be able to
 	 write everything with so few seeks as possible */
 
-      for (used=changed_blocks[(uint) file & CHANGED_BLOCKS_MASK];
+      for (used=part->changed_blocks[(uint) file & CHANGED_BLOCKS_MASK];
 	   used ;
 	   used=used->next_changed)
       {
@@ -607,7 +969,7 @@ static int flush_key_blocks_int(File file, enum flush_type type)
 
     /* Go through the keys and write them to buffer to be flushed */
     end=(pos=cache)+count;
-    for (used=changed_blocks[(uint) file & CHANGED_BLOCKS_MASK];
+    for (used=part->changed_blocks[(uint) file & CHANGED_BLOCKS_MASK];
 	 used ;
 	 used=next)
     {
@@ -623,16 +985,16 @@ static int flush_key_blocks_int(File file, enum flush_type type)
 	    pos=cache;
 	  }
 	  *pos++=used;
-	  _my_cache_write++;
+	  part->writes++;
 	}
 	if (type != FLUSH_KEEP && type != FLUSH_FORCE_WRITE)
 	{
 	  /* This will not destroy position or data */
-	  _my_blocks_changed--;
-	  free_block(used);
+	  part->blocks_changed--;
+	  free_block(part,used);
 	}
 	else
-	  link_changed_to_file(used,file);
+	  link_changed_to_file(part,used,file);
       }
     }
     if (pos != cache)
@@ -643,18 +1005,19 @@ static int flush_key_blocks_int(File file, enum flush_type type)
     /* The following happens very seldom */
     if (type != FLUSH_KEEP && type != FLUSH_FORCE_WRITE)
     {
-      for (used=file_blocks[(uint) file & CHANGED_BLOCKS_MASK];
+      for (used=part->file_blocks[(uint) file & CHANGED_BLOCKS_MASK];
 	   used ;
 	   used=next)
       {
 	next=used->next_changed;
 	if (used->file == file && (!used->changed ||
 				   type == FLUSH_IGNORE_CHANGED))
-	  free_block(used);
+	  free_block(part,used);
       }
     }
 #ifndef DBUG_OFF
-    DBUG_EXECUTE("check_keycache",test_key_cache("end of flush_key_blocks",0););
+    DBUG_EXECUTE("check_keycache",
+		 test_key_cache_part(part,"end of flush_key_blocks"););
 #endif
   }
   if (cache != cache_buff)
@@ -673,6 +1036,10 @@ static int flush_key_blocks_int(File file, enum flush_type type)
     file	File descriptor
     type	Type of flush operation
 
+  NOTES
+    The blocks of a file may be in any partition; The partitions are
+    locked and flushed one at a time.
+
   RETURN VALUES
     0		Ok
     1		Error
@@ -680,10 +1047,24 @@ static int flush_key_blocks_int(File file, enum flush_type type)
 
 int flush_key_blocks(File file, enum flush_type type)
 {
-  int res;
-  pthread_mutex_lock(&THR_LOCK_keycache);
-  res=flush_key_blocks_int(file, type);
+  int res=0,last_errno=0;
+  uint i;
+  pthread_mutex_lock(&THR_LOCK_keycache);	/* Protect against resize */
+  for (i=0 ; i < key_cache_parts ; i++)
+  {
+    KEY_CACHE_PART *part= key_cache_part+i;
+    pthread_mutex_lock(&part->lock);
+    if (flush_key_blocks_int(part, file, type))
+    {
+      if (!last_errno)
+	last_errno=errno;
+      res=1;
+    }
+    pthread_mutex_unlock(&part->lock);
+  }
   pthread_mutex_unlock(&THR_LOCK_keycache);
+  if (last_errno)
+    errno=last_errno;				/* Return first error */
   return res;
 }
 
@@ -695,7 +1076,8 @@ int flush_key_blocks(File file, enum flush_type type)
     flush_all_key_blocks()
 
   NOTE
-    We must have a lock on THR_LOCK_keycache before calling this function
+    We must have a lock on THR_LOCK_keycache and all partitions before
+    calling this function
 
   RETURN VALUES
     0		Ok
@@ -706,15 +1088,20 @@ int flush_key_blocks(File file, enum flush_type type)
 static int flush_all_key_blocks()
 {
   SEC_LINK **block, **end;
-  for (block= changed_blocks, end= block+CHANGED_BLOCKS_HASH;
-       block < end;
-       block++
-       )
+  uint i;
+  for (i=0 ; i < key_cache_parts ; i++)
   {
-    while (*block)
+    KEY_CACHE_PART *part= key_cache_part+i;
+    for (block= part->changed_blocks, end= block+CHANGED_BLOCKS_HASH;
+	 block < end;
+	 block++
+	 )
     {
-      if (flush_key_blocks_int((*block)->file, FLUSH_RELEASE))
-	return 1;
+      while (*block)
+      {
+	if (flush_key_blocks_int(part, (*block)->file, FLUSH_RELEASE))
+	  return 1;
+      }
     }
   }
   return 0;
@@ -725,27 +1112,18 @@ static int flush_all_key_blocks()
 
 	/* Test if disk-cache is ok */
 
-static void test_key_cache(const char *where, my_bool lock)
+static void test_key_cache_part(KEY_CACHE_PART *part, const char *where)
 {
   reg1 uint i,error;
   ulong found,changed;
   SEC_LINK *pos,**prev;
 
-  if (lock)
-  {
-    pthread_mutex_lock(&THR_LOCK_keycache);
-    if (_my_disk_blocks <= 0)			/* No active key cache */
-    {
-      pthread_mutex_unlock(&THR_LOCK_keycache);
-      return;
-    }
-  }
   found=error=0;
-  for (i= 0 ; i < _my_hash_blocks ; i++)
+  for (i= 0 ; i < part->hash_blocks ; i++)
   {
 
-    for (pos= *(prev= &_my_hash_root[i]) ;
-	 pos && found < _my_blocks_used+2 ;
+    for (pos= *(prev= &part->hash_root[i]) ;
+	 pos && found < part->blocks_used+2 ;
 	 found++, pos= *(prev= &pos->next_hash))
     {
       if (prev != pos->prev_hash)
@@ -756,7 +1134,8 @@ static void test_key_cache(const char *where, my_bool lock)
 		    i,(ulong) pos,(ulong) prev,(ulong) pos->prev_hash));
       }
 
-      if (((pos->diskpos >> key_cache_shift)+pos->file) % _my_hash_blocks != i)
+      if (KEY_CACHE_BUCKET(part, KEY_CACHE_HASH(pos->file, pos->diskpos)) !=
+	  i)
       {
 	DBUG_PRINT("error",("hash: %d  pos: %lx  : Wrong disk_buffer %ld",
 			    i,(ulong) pos,(ulong) pos->diskpos));
@@ -764,7 +1143,7 @@ static void test_key_cache(const char *where, my_bool lock)
       }
     }
   }
-  if (found > _my_blocks_used)
+  if (found > part->blocks_used)
   {
     DBUG_PRINT("error",("Found too many hash_pointers"));
     error=1;
@@ -772,10 +1151,10 @@ static void test_key_cache(const char *where, my_bool lock)
   if (error && !_my_printed)
   {						/* Write all hash-pointers */
     _my_printed=1;
-    for (i=0 ; i < _my_hash_blocks ; i++)
+    for (i=0 ; i < part->hash_blocks ; i++)
     {
-      DBUG_PRINT("loop",("hash: %d  _my_hash_root: %lx",i,&_my_hash_root[i]));
-      pos= _my_hash_root[i]; found=0;
+      DBUG_PRINT("loop",("hash: %d  part->hash_root: %lx",i,&part->hash_root[i]));
+      pos= part->hash_root[i]; found=0;
       while (pos && found < 10)
       {
 	DBUG_PRINT("loop",("pos: %lx  prev: %lx  next: %lx  file: %d  disk_buffer: %ld", (ulong) pos, (ulong) pos->prev_hash, (ulong) pos->next_hash, (ulong) pos->file, (ulong) pos->diskpos));
@@ -785,39 +1164,51 @@ static void test_key_cache(const char *where, my_bool lock)
   }
 
   found=changed=0;
-
-  if ((pos=_my_used_first))
   {
-    while (pos != _my_used_last && found < _my_blocks_used+2)
+    uint hot=0;
+    my_bool in_hot=0;
+    for (pos=part->used_first ;
+	 pos && found < part->blocks_used+2 ;
+	 pos=pos->next_used)
     {
       found++;
       if (pos->changed)
 	changed++;
-      if (pos->next_used->prev_used != pos)
+      if (pos == part->hot_first)
+	in_hot=1;
+      if (in_hot != (pos->temperature == BLOCK_HOT))
       {
-	DBUG_PRINT("error",("pos: %lx  next_used: %lx  next_used->prev: %lx",
-			    (ulong) pos,
-			    (ulong) pos->next_used,
-			    (ulong) pos->next_used->prev_hash));
+	DBUG_PRINT("error",("pos: %lx  is in wrong part of used chain",
+			    (ulong) pos));
 	error=1;
       }
-      pos=pos->next_used;
+      hot+= in_hot;
+      if (pos->next_used ? pos->next_used->prev_used != pos :
+	  pos != part->used_last)
+      {
+	DBUG_PRINT("error",("pos: %lx  next_used: %lx  is not linked back",
+			    (ulong) pos, (ulong) pos->next_used));
+	error=1;
+      }
+    }
+    if (hot != part->hot_blocks || found - hot != part->warm_blocks)
+    {
+      DBUG_PRINT("error",("Found %u hot blocks, expected %u hot and %u warm",
+			  hot, part->hot_blocks, part->warm_blocks));
+      error=1;
     }
-    found++;
-    if (pos->changed)
-      changed++;
   }
-  if (found != _my_blocks_used)
+  if (found != part->blocks_used)
   {
-    DBUG_PRINT("error",("Found %lu of %lu keyblocks",found,_my_blocks_used));
+    DBUG_PRINT("error",("Found %lu of %lu keyblocks",found,part->blocks_used));
     error=1;
   }
 
   for (i= 0 ; i < CHANGED_BLOCKS_HASH ; i++)
   {
     found=0;
-    prev= &changed_blocks[i];
-    for (pos= *prev ;  pos && found < _my_blocks_used+2; pos=pos->next_changed)
+    prev= &part->changed_blocks[i];
+    for (pos= *prev ;  pos && found < part->blocks_used+2; pos=pos->next_changed)
     {
       found++;
       if (pos->prev_changed != prev)
@@ -840,8 +1231,8 @@ static void test_key_cache(const char *where, my_bool lock)
     }
 
     found=0;
-    prev= &file_blocks[i];
-    for (pos= *prev ;  pos && found < _my_blocks_used+2; pos=pos->next_changed)
+    prev= &part->file_blocks[i];
+    for (pos= *prev ;  pos && found < part->blocks_used+2; pos=pos->next_changed)
     {
       found++;
       if (pos->prev_changed != prev)
@@ -870,8 +1261,22 @@ static void test_key_cache(const char *where, my_bool lock)
   }
   if (error)
     DBUG_PRINT("error",("Found error at %s",where));
-  if (lock)
-    pthread_mutex_unlock(&THR_LOCK_keycache);
   return;
+} /* test_key_cache_part */
+
+
+static void test_key_cache(const char *where, my_bool lock)
+{
+  uint i;
+  for (i=0 ; i < key_cache_parts ; i++)
+  {
+    KEY_CACHE_PART *part= key_cache_part+i;
+    if (lock)
+      pthread_mutex_lock(&part->lock);
+    if (part->disk_blocks > 0)
+      test_key_cache_part(part, where);
+    if (lock)
+      pthread_mutex_unlock(&part->lock);
+  }
 } /* test_key_cache */
 #endif
@@ -53,3 +53,113 @@ void radixsort_for_str_ptr(uchar **base, uint number_of_elements, size_s size_of
   next:;
   }
 }
+
+
+/*
+  Sort pointers to fixed length strings on a normalized key prefix.
+
+  SYNOPSIS
+    radixsort_for_str_ptr_prefix()
+    base			Pointers to sort
+    number_of_elements		Number of pointers
+    size_of_element		Length of the strings
+
+  DESCRIPTION
+    Bytes that are the same in all strings are skipped. The next 8
+    bytes of each string are stored as a big endian integer together
+    with the pointer in an extra array. The array is
+    radix sorted on the integer, which only needs sequential access to
+    memory and no string compares. Strings with the same prefix are
+    then sorted with qsort2() on the whole string.
+    This is useful for long sort keys, for which radixsort_for_str_ptr()
+    would need too many passes.
+
+  RETURN
+    0	ok
+    1	Out of memory (nothing sorted)
+*/
+
+typedef struct st_prefix_ptr
+{
+  ulonglong prefix;
+  uchar *ptr;
+} PREFIX_PTR;
+
+#define PREFIX_LENGTH 8
+
+my_bool radixsort_for_str_ptr_prefix(uchar **base, uint number_of_elements,
+				     size_s size_of_element)
+{
+  PREFIX_PTR *keys,*buffer,*ptr,*end,*tmp;
+  uchar **to,**run;
+  uint32 count[PREFIX_LENGTH][256],*count_ptr,*count_end;
+  uint i,skip,prefix_length;
+  int pass;
+
+  if (!number_of_elements)
+    return 0;
+  if (!(keys=(PREFIX_PTR*) my_malloc(sizeof(PREFIX_PTR)*number_of_elements*2,
+				     MYF(0))))
+    return 1;
+  buffer=keys+number_of_elements;
+  end=keys+number_of_elements;
+
+  /* Find the number of leading bytes that are the same in all strings */
+  skip=size_of_element;
+  for (to=base+1 ; to < base+number_of_elements && skip ; to++)
+  {
+    for (i=0 ; i < skip && (*to)[i] == base[0][i] ; i++) ;
+    skip=i;
+  }
+  prefix_length=min(size_of_element-skip,PREFIX_LENGTH);
+
+  /* Make the prefixes and count the bytes for all passes at once */
+  bzero((gptr) count,sizeof(count));
+  for (ptr=keys, to=base ; ptr < end ; ptr++, to++)
+  {
+    ulonglong prefix=0;
+    for (i=0 ; i < prefix_length ; i++)
+      prefix= (prefix << 8) | (*to)[skip+i];
+    prefix<<= (PREFIX_LENGTH-prefix_length)*8;
+    ptr->prefix=prefix;
+    ptr->ptr= *to;
+    for (i=0 ; i < PREFIX_LENGTH ; i++)
+      count[i][(uchar) (prefix >> (i*8))]++;
+  }
+
+  /* LSD radix sort on the prefix; skip bytes that are the same in all keys */
+  for (pass=0 ; pass < PREFIX_LENGTH ; pass++)
+  {
+    count_ptr=count[pass]; count_end=count_ptr+256;
+    if (*count_ptr == number_of_elements)
+      continue;
+    for (count_ptr++ ; count_ptr < count_end ; count_ptr++)
+    {
+      if (*count_ptr == number_of_elements)
+	goto next;
+      (*count_ptr)+= *(count_ptr-1);
+    }
+    count_ptr=count[pass];
+    for (ptr=end ; ptr-- != keys ;)
+      buffer[--count_ptr[(uchar) (ptr->prefix >> (pass*8))]]= *ptr;
+    tmp=keys; keys=buffer; buffer=tmp;
+    end=keys+number_of_elements;
+  next:;
+  }
+
+  /* Copy the pointers back and sort the strings with equal prefixes */
+  for (ptr=keys, to=base ; ptr < end ;)
+  {
+    ulonglong prefix=ptr->prefix;
+    for (run=to ; ptr < end && ptr->prefix == prefix ; ptr++)
+      *to++= ptr->ptr;
+    if (to - run > 1 && size_of_element > skip+PREFIX_LENGTH)
+    {
+      uint size_arg=size_of_element;
+      qsort2((void*) run,(size_t) (to-run),sizeof(uchar*),
+	     get_ptr_compare(size_of_element),(void*) &size_arg);
+    }
+  }
+  my_free((gptr) min(keys,buffer),MYF(0));
+  return 0;
+}
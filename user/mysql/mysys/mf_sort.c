@@ -29,14 +29,16 @@ void my_string_ptr_sort(void *base, uint items, size_s size)
   {
     radixsort_for_str_ptr((uchar**) base,items,size,ptr);
     my_free((gptr) ptr,MYF(0));
+    return;
   }
-  else
+  /* Long strings are sorted on a prefix, if we get memory for it */
+  if (size > 20 && items >= 1000 &&
+      !radixsort_for_str_ptr_prefix((uchar**) base,items,size))
+    return;
 #endif
+  if (size && items)
   {
-    if (size && items)
-    {
-      uint size_arg=size;
-      qsort2(base,items,sizeof(byte*),get_ptr_compare(size),(void*) &size_arg);
-    }
+    uint size_arg=size;
+    qsort2(base,items,sizeof(byte*),get_ptr_compare(size),(void*) &size_arg);
   }
 }
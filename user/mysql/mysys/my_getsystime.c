@@ -0,0 +1,39 @@
+/* Copyright (C) 2004 MySQL AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Get current system time in 100 nanosecond units.
+  Used for measuring short intervals (wait times, statement phases),
+  where the one second resolution of time() is too coarse.
+*/
+
+#include "mysys_priv.h"
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+ulonglong my_getsystime(void)
+{
+#ifdef __WIN__
+  FILETIME ft;
+  GetSystemTimeAsFileTime(&ft);
+  return ((ulonglong) ft.dwHighDateTime << 32 | ft.dwLowDateTime);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (ulonglong) tv.tv_sec*10000000L + (ulonglong) tv.tv_usec*10;
+#endif
+}
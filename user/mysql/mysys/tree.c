@@ -323,6 +323,215 @@ void *tree_search(TREE *tree, void *key)
 }
 
 
+/*
+  Search after a key for an ordered read
+
+  SYNOPSIS
+    tree_search_key()
+    tree		Tree
+    key			Key to search after
+    parents		Gets the path from the root to the found element;
+			parents[0] is the null element
+    last_pos		Gets the position of the found element in parents,
+			for tree_search_next()
+    flag		How to search (HA_READ_KEY_EXACT etc)
+    custom_arg		Argument to the compare function, instead of
+			tree->custom_arg, so that readers can search with
+			different key lengths at the same time
+
+  RETURN
+    0	Not found
+    #	Key of found element
+*/
+
+void *tree_search_key(TREE *tree, const void *key,
+		      TREE_ELEMENT **parents, TREE_ELEMENT ***last_pos,
+		      enum ha_rkey_function flag, void *custom_arg)
+{
+  int cmp;
+  TREE_ELEMENT *element= tree->root;
+  TREE_ELEMENT **last_left_step_parent= NULL, **last_right_step_parent= NULL;
+  TREE_ELEMENT **last_equal_element= NULL;
+
+  *parents= &tree->null_element;
+  while (element != &tree->null_element)
+  {
+    *++parents= element;
+    if ((cmp= (*tree->compare)(custom_arg, ELEMENT_KEY(tree, element),
+			       key)) == 0)
+    {
+      switch (flag) {
+      case HA_READ_KEY_EXACT:
+      case HA_READ_KEY_OR_NEXT:
+      case HA_READ_BEFORE_KEY:
+      case HA_READ_PREFIX:
+	last_equal_element= parents;		/* Go on with the first one */
+	cmp= 1;
+	break;
+      case HA_READ_AFTER_KEY:
+	cmp= -1;
+	break;
+      case HA_READ_KEY_OR_PREV:
+      case HA_READ_PREFIX_LAST:
+	last_equal_element= parents;		/* Go on with the last one */
+	cmp= -1;
+	break;
+      default:
+	return NULL;
+      }
+    }
+    if (cmp < 0)				/* element < key */
+    {
+      last_right_step_parent= parents;
+      element= element->right;
+    }
+    else
+    {
+      last_left_step_parent= parents;
+      element= element->left;
+    }
+  }
+  switch (flag) {
+  case HA_READ_KEY_EXACT:
+  case HA_READ_PREFIX:
+  case HA_READ_PREFIX_LAST:
+    *last_pos= last_equal_element;
+    break;
+  case HA_READ_KEY_OR_NEXT:
+    *last_pos= last_equal_element ? last_equal_element : last_left_step_parent;
+    break;
+  case HA_READ_AFTER_KEY:
+    *last_pos= last_left_step_parent;
+    break;
+  case HA_READ_KEY_OR_PREV:
+    *last_pos= last_equal_element ? last_equal_element : last_right_step_parent;
+    break;
+  case HA_READ_BEFORE_KEY:
+    *last_pos= last_right_step_parent;
+    break;
+  default:
+    return NULL;
+  }
+  return *last_pos ? ELEMENT_KEY(tree, **last_pos) : NULL;
+}
+
+
+/*
+  Search the first (child_offs is offsetof(TREE_ELEMENT, left)) or the
+  last (child_offs is offsetof(TREE_ELEMENT, right)) element of the tree.
+  parents and last_pos are set as in tree_search_key().
+*/
+
+void *tree_search_edge(TREE *tree, TREE_ELEMENT **parents,
+		       TREE_ELEMENT ***last_pos, int child_offs)
+{
+  TREE_ELEMENT *element= tree->root;
+
+  *parents= &tree->null_element;
+  while (element != &tree->null_element)
+  {
+    *++parents= element;
+    element= ELEMENT_CHILD(element, child_offs);
+  }
+  *last_pos= parents;
+  return **last_pos != &tree->null_element ?
+    ELEMENT_KEY(tree, **last_pos) : NULL;
+}
+
+
+/*
+  Step to the next (l_offs= left, r_offs= right) or previous
+  (l_offs= right, r_offs= left) element from the one at *last_pos.
+  The tree must not have changed since *last_pos was set.
+*/
+
+void *tree_search_next(TREE *tree, TREE_ELEMENT ***last_pos, int l_offs,
+		       int r_offs)
+{
+  TREE_ELEMENT *x= **last_pos;
+
+  if (ELEMENT_CHILD(x, r_offs) != &tree->null_element)
+  {
+    x= ELEMENT_CHILD(x, r_offs);
+    *++*last_pos= x;
+    while (ELEMENT_CHILD(x, l_offs) != &tree->null_element)
+    {
+      x= ELEMENT_CHILD(x, l_offs);
+      *++*last_pos= x;
+    }
+    return ELEMENT_KEY(tree, x);
+  }
+  else
+  {
+    TREE_ELEMENT *y= *--*last_pos;
+    while (y != &tree->null_element && x == ELEMENT_CHILD(y, r_offs))
+    {
+      x= y;
+      y= *--*last_pos;
+    }
+    return y == &tree->null_element ? NULL : ELEMENT_KEY(tree, y);
+  }
+}
+
+
+/*
+  Estimate the position of a key in the tree, for records_in_range().
+  Assumes that the tree is about balanced: every step down halves the
+  range of possible positions.
+
+  RETURN
+    HA_POS_ERROR	flag is not supported
+    #			Approximate number of elements before the key
+*/
+
+ha_rows tree_record_pos(TREE *tree, const void *key,
+			enum ha_rkey_function flag, void *custom_arg)
+{
+  int cmp;
+  TREE_ELEMENT *element= tree->root;
+  double left= 1;
+  double right= tree->elements_in_tree;
+
+  while (element != &tree->null_element)
+  {
+    if ((cmp= (*tree->compare)(custom_arg, ELEMENT_KEY(tree, element),
+			       key)) == 0)
+    {
+      switch (flag) {
+      case HA_READ_KEY_EXACT:
+      case HA_READ_BEFORE_KEY:
+	cmp= 1;
+	break;
+      case HA_READ_AFTER_KEY:
+	cmp= -1;
+	break;
+      default:
+	return HA_POS_ERROR;
+      }
+    }
+    if (cmp < 0)				/* element < key */
+    {
+      element= element->right;
+      left= (left + right) / 2;
+    }
+    else
+    {
+      element= element->left;
+      right= (left + right) / 2;
+    }
+  }
+  switch (flag) {
+  case HA_READ_KEY_EXACT:
+  case HA_READ_BEFORE_KEY:
+    return (ha_rows) right;
+  case HA_READ_AFTER_KEY:
+    return (ha_rows) left;
+  default:
+    return HA_POS_ERROR;
+  }
+}
+
+
 int tree_walk(TREE *tree, tree_walk_action action, void *argument, TREE_WALK visit)
 {
   switch (visit) {
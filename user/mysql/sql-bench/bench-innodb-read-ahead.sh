@@ -0,0 +1,155 @@
+#!@PERL@
+# Copyright (C) 2000 MySQL AB & MySQL Finland AB & TCX DataKonsult AB
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Library General Public
+# License as published by the Free Software Foundation; either
+# version 2 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Library General Public License for more details.
+#
+# You should have received a copy of the GNU Library General Public
+# License along with this library; if not, write to the Free
+# Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+# MA 02111-1307, USA
+#
+# Test of InnoDB read-ahead throughput on a cold buffer pool
+#
+# The test table is made several times bigger than the InnoDB buffer pool,
+# so that every full table scan has to read the whole table from disk
+# through the linear read-ahead of InnoDB. Run it once with the server
+# started with --innodb-use-native-aio and once with
+# --skip-innodb-use-native-aio to compare the Linux native aio with the
+# simulated aio. Use a small --innodb-buffer-pool-size, and preferably
+# --innodb-flush-method=O_DIRECT so that the OS file cache does not hide
+# the disk reads.
+#
+##################### Standard benchmark inits ##############################
+
+use Cwd;
+use DBI;
+use Getopt::Long;
+use Benchmark;
+
+$opt_loop_count=400000;
+$opt_small_loop_count=5;
+
+$pwd = cwd(); $pwd = "." if ($pwd eq '');
+require "$pwd/bench-init.pl" || die "Can't read Configuration file: $!\n";
+
+if ($opt_small_test)
+{
+  $opt_loop_count/=10;
+  $opt_small_loop_count=2;
+}
+
+print "Testing the speed of InnoDB read-ahead on a cold buffer pool\n";
+print "The test-table has $opt_loop_count rows of about 250 bytes, and is scanned $opt_small_loop_count times.\n\n";
+
+####
+####  Connect and start timeing
+####
+
+$dbh = $server->connect();
+$start_time=new Benchmark;
+
+$row=$dbh->selectrow_arrayref("show variables like 'innodb_use_native_aio'");
+print "innodb_use_native_aio: " . ($row ? $row->[1] : "unknown") . "\n";
+$row=$dbh->selectrow_arrayref("show variables like 'innodb_buffer_pool_size'");
+print "innodb_buffer_pool_size: " . ($row ? $row->[1] : "unknown") . "\n\n";
+
+####
+#### Create needed tables
+####
+
+goto select_test if ($opt_skip_create);
+
+print "Creating table\n";
+$dbh->do("drop table bench1" . $server->{'drop_attr'});
+
+do_many($dbh,$server->create("bench1",
+			     ["id integer(10) NOT NULL",
+			      "grp integer(10) NOT NULL",
+			      "pad char(240) NOT NULL"],
+			     ["primary key (id)"],
+			     "type=innodb"));
+
+print "Inserting $opt_loop_count rows\n";
+
+$loop_time=new Benchmark;
+$pad="x" x 200;
+do_query($dbh,"set autocommit=0");
+for ($id=0 ; $id < $opt_loop_count ; )
+{
+  $query="insert into bench1 values ";
+  for ($i=0 ; $i < 100 && $id < $opt_loop_count ; $i++, $id++)
+  {
+    $query.="," if ($i);
+    $query.="($id," . ($id % 1000) . ",'$pad$id')";
+  }
+  do_query($dbh,$query);
+  do_query($dbh,"commit") if ($id % 10000 == 0);
+}
+do_query($dbh,"commit");
+do_query($dbh,"set autocommit=1");
+
+$end_time=new Benchmark;
+print "Time to insert ($opt_loop_count): " .
+    timestr(timediff($end_time, $loop_time),"all") . "\n\n";
+
+####
+#### Scan the table; every scan reads the table from disk with read-ahead
+####
+
+select_test:
+
+print "Scanning the table\n";
+
+$pages_read=innodb_pages_read($dbh);
+$loop_time=new Benchmark;
+$rows=$count=0;
+for ($i=0 ; $i < $opt_small_loop_count ; $i++)
+{
+  $count++;
+  $rows+=fetch_all_rows($dbh,"select sum(grp) from bench1 where pad like 'y%'");
+}
+$end_time=new Benchmark;
+$pages_read=innodb_pages_read($dbh)-$pages_read;
+
+print "Time for full_scan ($count:$rows): " .
+    timestr(timediff($end_time, $loop_time),"all") . "\n";
+
+$seconds=timediff($end_time, $loop_time)->[0];
+$seconds=1 if ($seconds <= 0);
+printf("Pages read: %d  pages/s: %.0f  MB/s: %.2f\n\n",
+       $pages_read, $pages_read/$seconds, $pages_read*16/1024/$seconds);
+
+####
+#### End of benchmark
+####
+
+if (!$opt_skip_delete)
+{
+  do_query($dbh,"drop table bench1" . $server->{'drop_attr'});
+}
+
+$dbh->disconnect;				# close connection
+
+end_benchmark($start_time);
+
+#
+# Get the number of pages InnoDB has read from disk from SHOW INNODB STATUS
+#
+
+sub innodb_pages_read
+{
+  my ($dbh)=@_;
+  my ($row);
+
+  $row=$dbh->selectrow_arrayref("show innodb status");
+  return 0 if (!$row || $row->[0] !~ /Pages read (\d+)/);
+  return $1;
+}
@@ -0,0 +1,382 @@
+/* Copyright (C) 2003 MySQL AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  In-memory hash table for aggregation over fixed length keys
+
+  Used by GROUP BY into a HEAP temporary table (see end_update_hash() in
+  sql_select.cc) and by COUNT(DISTINCT). The keys are made so that equal
+  values have equal bytes (Field::sort_string()), which makes a lookup a
+  hash probe and a memcmp().
+
+  Each element is allocated from a MEM_ROOT and holds the key followed by
+  data_length bytes of data that belong to the caller. The slot array is
+  probed linearly and holds pointers to the elements; the hash value is
+  kept in the element so that the array can be grown without reading the
+  keys. The elements are also linked in insertion order.
+
+  When the elements use more than max_in_memory_size bytes,
+  find_or_insert() returns 0 and the caller decides what to do. For
+  COUNT(DISTINCT), unique_add() writes the keys in memory to partition
+  files on the high bits of their hash and starts over. unique_count()
+  then counts each partition separately; a partition that doesn't fit in
+  memory is split again on the next bits of the hash.
+*/
+
+#include "mysql_priv.h"
+
+#define AGGR_HASH_MIN_SLOTS	256
+#define AGGR_HASH_PARTITIONS	(1 << AGGR_HASH_PART_BITS)
+#define AGGR_HASH_MAX_LEVEL	(32 / AGGR_HASH_PART_BITS - 2)
+
+
+static inline uint32 aggr_hashnr(const byte *key, uint length)
+{
+  register uint32 nr=1, nr2=4;
+  const byte *end= key+length;
+  for (; key < end ; key++)
+  {
+    nr^= (((nr & 63)+nr2)*((uint) (uchar) *key))+ (nr << 8);
+    nr2+=3;
+  }
+  /* Spread the bits; The partitions are taken from the high bits */
+  nr^= nr >> 16;
+  nr*= 0x85ebca6b;
+  nr^= nr >> 13;
+  return nr;
+}
+
+
+Aggr_hash::Aggr_hash(uint key_length_arg, uint data_length_arg,
+		     ulong max_in_memory_size_arg)
+  :key_length(key_length_arg), data_length(data_length_arg),
+   max_in_memory_size(max_in_memory_size_arg), elements(0)
+{
+  element_length= ALIGN_SIZE(ALIGN_SIZE(sizeof(AGGR_HASH_LINK))+key_length+
+			      data_length);
+  init_alloc_root(&mem_root, 8192, 0);
+  slot_count= 0;
+  slots= 0;
+  first_link= 0;
+  last_link= &first_link;
+  spilled= 0;
+  unique_counted= 0;
+  unique_elements= 0;
+  part_files= 0;
+}
+
+
+Aggr_hash::~Aggr_hash()
+{
+  close_partitions(part_files);
+  my_free((gptr) slots, MYF(MY_ALLOW_ZERO_PTR));
+  free_root(&mem_root, MYF(0));
+}
+
+
+/* Forget all elements; Keeps the memory for the next ones */
+
+void Aggr_hash::reset()
+{
+  if (slots)
+    bzero((char*) slots, slot_count*sizeof(AGGR_HASH_LINK*));
+  free_root(&mem_root, MYF(MY_MARK_BLOCKS_FREE));
+  elements= 0;
+  first_link= 0;
+  last_link= &first_link;
+}
+
+
+/* Double the slot array; Returns 1 if out of memory */
+
+bool Aggr_hash::grow()
+{
+  uint new_count= slot_count ? slot_count*2 : AGGR_HASH_MIN_SLOTS;
+  AGGR_HASH_LINK **new_slots, *link;
+  if (!(new_slots= (AGGR_HASH_LINK**)
+	my_malloc(new_count*sizeof(AGGR_HASH_LINK*), MYF(MY_ZEROFILL))))
+    return 1;
+  /* Rehash with the hash values in the elements */
+  for (link= first_link ; link ; link= link->next)
+  {
+    uint i= link->hashnr & (new_count-1);
+    while (new_slots[i])
+      i= (i+1) & (new_count-1);
+    new_slots[i]= link;
+  }
+  my_free((gptr) slots, MYF(MY_ALLOW_ZERO_PTR));
+  slots= new_slots;
+  slot_count= new_count;
+  return 0;
+}
+
+
+/*
+  Find the element with the given key, or add one
+
+  SYNOPSIS
+    find_or_insert()
+    key		Key of key_length bytes
+    inserted	Set to 1 if a new element was added; its data is not
+		initialized
+
+  RETURN
+    The data of the element
+    0	The table is full or out of memory (test is_full())
+*/
+
+byte *Aggr_hash::find_or_insert(const byte *key, bool *inserted)
+{
+  return find_or_insert(key, aggr_hashnr(key, key_length), inserted);
+}
+
+
+byte *Aggr_hash::find_or_insert(const byte *key, uint32 hashnr,
+				bool *inserted)
+{
+  AGGR_HASH_LINK *link;
+  uint i;
+  *inserted= 0;
+
+  if (slot_count)
+  {
+    for (i= hashnr & (slot_count-1) ; (link= slots[i]) ;
+	 i= (i+1) & (slot_count-1))
+    {
+      if (link->hashnr == hashnr &&
+	  !memcmp(link_key(link), key, key_length))
+	return link_key(link) + key_length;
+    }
+  }
+  if (is_full() ||
+      ((elements+1)*4 > slot_count*3 && grow()) ||
+      !(link= (AGGR_HASH_LINK*) alloc_root(&mem_root, element_length)))
+    return 0;
+  for (i= hashnr & (slot_count-1) ; slots[i] ; i= (i+1) & (slot_count-1)) ;
+  slots[i]= link;
+  link->hashnr= hashnr;
+  link->next= 0;
+  *last_link= link;
+  last_link= &link->next;
+  memcpy(link_key(link), key, key_length);
+  elements++;
+  *inserted= 1;
+  return link_key(link) + key_length;
+}
+
+
+bool Aggr_hash::is_full()
+{
+  return (elements * element_length + slot_count * sizeof(AGGR_HASH_LINK*) >
+	  max_in_memory_size && elements);
+}
+
+
+/*
+  Functions for COUNT(DISTINCT); The elements have no data
+*/
+
+void Aggr_hash::close_partitions(IO_CACHE *files)
+{
+  if (files)
+  {
+    for (uint i= 0 ; i < AGGR_HASH_PARTITIONS ; i++)
+      close_cached_file(files+i);
+    my_free((gptr) files, MYF(0));
+  }
+}
+
+
+IO_CACHE *Aggr_hash::open_partitions()
+{
+  IO_CACHE *files;
+  if (!(files= (IO_CACHE*) my_malloc(sizeof(IO_CACHE)*AGGR_HASH_PARTITIONS,
+				     MYF(MY_WME | MY_ZEROFILL))))
+    return 0;
+  for (uint i= 0 ; i < AGGR_HASH_PARTITIONS ; i++)
+  {
+    if (open_cached_file(files+i, mysql_tmpdir, TEMP_PREFIX,
+			 DISK_BUFFER_SIZE, MYF(MY_WME)))
+    {
+      close_partitions(files);
+      return 0;
+    }
+  }
+  return files;
+}
+
+
+/* Write the keys in memory to the partition files of level; Clears table */
+
+bool Aggr_hash::flush_to_partitions(IO_CACHE *files, uint level)
+{
+  uint shift= 32 - AGGR_HASH_PART_BITS * (level+1);
+  for (AGGR_HASH_LINK *link= first_link ; link ; link= link->next)
+  {
+    IO_CACHE *file= files + ((link->hashnr >> shift) &
+			     (AGGR_HASH_PARTITIONS-1));
+    if (my_b_write(file, link_key(link), key_length))
+      return 1;
+  }
+  reset();
+  return 0;
+}
+
+
+/* Forget all keys given to unique_add(); Used between groups */
+
+bool Aggr_hash::unique_reset()
+{
+  reset();
+  unique_counted= 0;
+  if (spilled)
+  {
+    spilled= 0;
+    for (uint i= 0 ; i < AGGR_HASH_PARTITIONS ; i++)
+      if (reinit_io_cache(part_files+i, WRITE_CACHE, 0L, 0, 1))
+	return 1;
+  }
+  return 0;
+}
+
+
+/*
+  Add a key to count; Returns 1 on error
+*/
+
+bool Aggr_hash::unique_add(const byte *key)
+{
+  bool inserted;
+  uint32 hashnr= aggr_hashnr(key, key_length);
+  unique_counted= 0;
+  if (find_or_insert(key, hashnr, &inserted))
+    return 0;
+  if (!is_full())
+    return 1;					// Out of memory
+  /* Move the keys in memory to the partitions and start over */
+  if (!part_files && !(part_files= open_partitions()))
+    return 1;
+  spilled= 1;
+  if (flush_to_partitions(part_files, 0))
+    return 1;
+  return !find_or_insert(key, hashnr, &inserted);
+}
+
+
+/*
+  Count the different keys in a partition file
+
+  SYNOPSIS
+    count_partition()
+    file	Partition file of level; Is reused
+    level	0 for the partitions made by unique_add()
+    count	The count is added here
+*/
+
+bool Aggr_hash::count_partition(IO_CACHE *file, uint level, ulonglong *count)
+{
+  IO_CACHE *sub_files= 0;
+  byte *key;
+  bool inserted, error= 1;
+
+  if (!my_b_tell(file))
+    return 0;					// Empty partition
+  if (!(key= (byte*) my_malloc(key_length+1, MYF(MY_WME))) ||
+      reinit_io_cache(file, READ_CACHE, 0L, 0, 0))
+    goto end;
+
+  while (!my_b_read(file, key, key_length))
+  {
+    uint32 hashnr= aggr_hashnr(key, key_length);
+    if (find_or_insert(key, hashnr, &inserted))
+      continue;
+    if (!is_full())
+      goto end;
+    if (level >= AGGR_HASH_MAX_LEVEL)
+    {
+      /* Out of hash bits; Let the table grow over the limit */
+      ulong save_max= max_in_memory_size;
+      max_in_memory_size= ~(ulong) 0;
+      inserted= find_or_insert(key, hashnr, &inserted) != 0;
+      max_in_memory_size= save_max;
+      if (!inserted)
+	goto end;
+      continue;
+    }
+    /* Split this partition on the next bits of the hash */
+    if (!sub_files && !(sub_files= open_partitions()))
+      goto end;
+    if (flush_to_partitions(sub_files, level+1) ||
+	!find_or_insert(key, hashnr, &inserted))
+      goto end;
+  }
+  if (sub_files)
+  {
+    if (flush_to_partitions(sub_files, level+1))
+      goto end;
+    for (uint i= 0 ; i < AGGR_HASH_PARTITIONS ; i++)
+      if (count_partition(sub_files+i, level+1, count))
+	goto end;
+  }
+  else
+  {
+    *count+= elements;
+    reset();
+  }
+  error= 0;
+
+end:
+  close_partitions(sub_files);
+  my_free((gptr) key, MYF(MY_ALLOW_ZERO_PTR));
+  return error;
+}
+
+
+/*
+  Get the number of different keys given to unique_add()
+
+  NOTES
+    If the keys were written to partitions, the keys in memory are moved
+    there too and each partition is counted. The count is remembered until
+    the next unique_add().
+*/
+
+bool Aggr_hash::unique_count(ulonglong *count)
+{
+  if (!spilled)
+  {
+    *count= elements;
+    return 0;
+  }
+  if (!unique_counted)
+  {
+    unique_elements= 0;
+    if (flush_to_partitions(part_files, 0))
+      return 1;
+    for (uint i= 0 ; i < AGGR_HASH_PARTITIONS ; i++)
+    {
+      my_off_t end= my_b_tell(part_files+i);
+      if (count_partition(part_files+i, 0, &unique_elements))
+	return 1;
+      /* Continue at the end, if more keys are added */
+      if (end && reinit_io_cache(part_files+i, WRITE_CACHE, end, 0, 0))
+	return 1;
+    }
+    unique_counted= 1;
+  }
+  *count= unique_elements;
+  return 0;
+}
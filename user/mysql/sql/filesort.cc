@@ -51,6 +51,48 @@ static int merge_index(SORTPARAM *param,uchar *sort_buffer,
 static bool save_index(SORTPARAM *param,uchar **sort_keys, uint count);
 static uint sortlength(SORT_FIELD *sortorder,uint length);
 
+/*
+  A part of the sort buffer that is sorted by one thread.
+  key is the current key when the sorted slices are merged.
+*/
+
+typedef struct st_sort_slice {
+  uchar **keys;
+  uchar *key;
+  uint count;
+  uint sort_length;
+} SORT_SLICE;
+
+/* A group of runs that is merged to one run in merge_many_buff() */
+
+typedef struct st_merge_group {
+  BUFFPEK *first,*last;			/* Runs to merge */
+  my_off_t to_pos;			/* Where the result is written */
+  BUFFPEK result;
+} MERGE_GROUP;
+
+/* The groups of a merge pass that are merged by one thread */
+
+typedef struct st_merge_job {
+  SORTPARAM param;			/* With this thread's part of memory */
+  uchar *sort_buffer;
+  IO_CACHE *from_file;
+  File to_file;
+  MERGE_GROUP *group,*end;
+  uint step;
+} MERGE_JOB;
+
+typedef int (*sort_job_func)(void *);
+
+static bool run_sort_jobs(sort_job_func func, byte *jobs, uint job_length,
+			  uint count);
+static uint sort_keys_in_slices(SORTPARAM *param, uchar **sort_keys,
+				uint count, SORT_SLICE *slices);
+static int merge_pass_in_threads(SORTPARAM *param, uchar *sort_buffer,
+				 BUFFPEK *buffpek, uint maxbuffer,
+				 BUFFPEK **lastbuff,
+				 IO_CACHE *from_file, IO_CACHE *to_file);
+
 	/*
 	  Creates a set of pointers that can be used to read the rows
 	  in sorted order. This should be done with the functions
@@ -76,6 +118,7 @@ ha_rows filesort(TABLE *table, SORT_FIELD *sortorder, uint s_length,
   IO_CACHE tempfile, buffpek_pointers, *selected_records_file, *outfile; 
   SORTPARAM param;
   THD *thd= current_thd;
+  uint profile_stage= thd->profiling.status("filesort");
 
   DBUG_ENTER("filesort");
   DBUG_EXECUTE("info",TEST_filesort(sortorder,s_length,special););
@@ -93,6 +136,8 @@ ha_rows filesort(TABLE *table, SORT_FIELD *sortorder, uint s_length,
   param.ref_length= table->file->ref_length;
   param.sort_length=sortlength(sortorder,s_length)+ param.ref_length;
   param.max_rows= max_rows;
+  param.killed= &thd->killed;
+  param.threads= (uint) thd->variables.sort_threads;
 
   if (select && select->quick)
   {
@@ -233,6 +278,7 @@ ha_rows filesort(TABLE *table, SORT_FIELD *sortorder, uint s_length,
   else
     statistic_add(filesort_rows, (ulong) records, &LOCK_status);
   *examined_rows= param.examined_rows;
+  thd->profiling.resume(profile_stage);
 #ifdef SKIP_DBUG_IN_FILESORT
   DBUG_POP();			/* Ok to DBUG */
 #endif
@@ -408,34 +454,46 @@ static ha_rows find_all_keys(SORTPARAM *param, SQL_SELECT *select,
 
 	/* Skriver en buffert med nycklar till filen */
 
+/*
+  Sort the keys and write them to tempfile
+
+  NOTES
+    If the keys are sorted by several threads each sorted slice is
+    written as a run of its own.
+*/
+
 static int
 write_keys(SORTPARAM *param, register uchar **sort_keys, uint count,
 	   IO_CACHE *buffpek_pointers, IO_CACHE *tempfile)
 {
-  uint sort_length;
+  uint sort_length,slice_count;
   uchar **end;
   BUFFPEK buffpek;
+  SORT_SLICE slices[MAX_SORT_THREADS],*slice;
   DBUG_ENTER("write_keys");
 
   sort_length=param->sort_length;
-#ifdef MC68000
-  quicksort(sort_keys,count,sort_length);
-#else
-  my_string_ptr_sort((gptr) sort_keys,(uint) count,sort_length);
-#endif
+  if (!(slice_count=sort_keys_in_slices(param,sort_keys,count,slices)))
+    goto err;
   if (!my_b_inited(tempfile) &&
       open_cached_file(tempfile,mysql_tmpdir,TEMP_PREFIX,DISK_BUFFER_SIZE,
 			MYF(MY_WME)))
     goto err;					/* purecov: inspected */
-  buffpek.file_pos=my_b_tell(tempfile);
-  if ((ha_rows) count > param->max_rows)
-    count=(uint) param->max_rows;		/* purecov: inspected */
-  buffpek.count=(ha_rows) count;
-  for (end=sort_keys+count ; sort_keys != end ; sort_keys++)
-    if (my_b_write(tempfile,(byte*) *sort_keys,(uint) sort_length))
+  for (slice=slices ; slice < slices+slice_count ; slice++)
+  {
+    buffpek.file_pos=my_b_tell(tempfile);
+    count=slice->count;
+    if ((ha_rows) count > param->max_rows)
+      count=(uint) param->max_rows;		/* purecov: inspected */
+    buffpek.count=(ha_rows) count;
+    for (sort_keys=slice->keys, end=sort_keys+count ;
+	 sort_keys != end ;
+	 sort_keys++)
+      if (my_b_write(tempfile,(byte*) *sort_keys,(uint) sort_length))
+	goto err;
+    if (my_b_write(buffpek_pointers, (byte*) &buffpek, sizeof(buffpek)))
       goto err;
-  if (my_b_write(buffpek_pointers, (byte*) &buffpek, sizeof(buffpek)))
-    goto err;
+  }
   DBUG_RETURN(0);
 
 err:
@@ -613,13 +671,24 @@ static void make_sortkey(register SORTPARAM *param,
 }
 
 
+/*
+  Sort the keys in memory and save the row references of them in
+  table->record_pointers
+
+  NOTES
+    If the keys were sorted in several slices, the slices are merged
+    here.
+*/
+
 static bool save_index(SORTPARAM *param, uchar **sort_keys, uint count)
 {
-  uint offset,ref_length;
+  uint offset,ref_length,slice_count;
   byte *to;
+  SORT_SLICE slices[MAX_SORT_THREADS],*slice;
   DBUG_ENTER("save_index");
 
-  my_string_ptr_sort((gptr) sort_keys,(uint) count,param->sort_length);
+  if (!(slice_count=sort_keys_in_slices(param,sort_keys,count,slices)))
+    DBUG_RETURN(1);
   ref_length=param->ref_length;
   offset=param->sort_length-ref_length;
   if ((ha_rows) count > param->max_rows)
@@ -627,15 +696,229 @@ static bool save_index(SORTPARAM *param, uchar **sort_keys, uint count)
   if (!(to=param->sort_form->record_pointers=
 	(byte*) my_malloc(ref_length*count,MYF(MY_WME))))
     DBUG_RETURN(1);				/* purecov: inspected */
-  for (uchar **end=sort_keys+count ; sort_keys != end ; sort_keys++)
+  if (slice_count == 1)
   {
-    memcpy(to,*sort_keys+offset,ref_length);
-    to+=ref_length;
+    for (uchar **end=sort_keys+count ; sort_keys != end ; sort_keys++)
+    {
+      memcpy(to,*sort_keys+offset,ref_length);
+      to+=ref_length;
+    }
+  }
+  else
+  {
+    QUEUE queue;
+    uint sort_length=param->sort_length;
+    if (init_queue(&queue,slice_count,offsetof(SORT_SLICE,key),0,
+		   (queue_compare) get_ptr_compare(sort_length),
+		   (void*) &sort_length))
+      DBUG_RETURN(1);				/* purecov: inspected */
+    for (slice=slices ; slice < slices+slice_count ; slice++)
+    {
+      slice->key= *slice->keys;
+      queue_insert(&queue,(byte*) slice);
+    }
+    for (; count ; count--)
+    {
+      slice=(SORT_SLICE*) queue_top(&queue);
+      memcpy(to,slice->key+offset,ref_length);
+      to+=ref_length;
+      if (--slice->count)
+      {
+	slice->key= *++slice->keys;
+	queue_replaced(&queue);
+      }
+      else
+	VOID(queue_remove(&queue,0));
+    }
+    delete_queue(&queue);
   }
   DBUG_RETURN(0);
 }
 
 
+	/* Sort one slice of the sort buffer */
+
+static int sort_slice(void *arg)
+{
+  SORT_SLICE *slice=(SORT_SLICE*) arg;
+#ifdef MC68000
+  quicksort(slice->keys,slice->count,slice->sort_length);
+#else
+  my_string_ptr_sort((gptr) slice->keys,slice->count,slice->sort_length);
+#endif
+  return 0;
+}
+
+
+/*
+  Sort the keys in the sort buffer
+
+  SYNOPSIS
+    sort_keys_in_slices()
+    param		Sort parameters
+    sort_keys		Pointers to the keys
+    count		Number of keys
+    slices		Array of MAX_SORT_THREADS slices
+
+  NOTES
+    If param->threads > 1 and there are enough keys, the keys are split
+    in up to param->threads slices that are sorted in parallel.
+    Each slice is in order but the slices are not merged.
+
+  RETURN
+    0	error
+    #	Number of sorted slices
+*/
+
+static uint sort_keys_in_slices(SORTPARAM *param, uchar **sort_keys,
+				uint count, SORT_SLICE *slices)
+{
+  uint i,slice_count,slice_keys;
+  DBUG_ENTER("sort_keys_in_slices");
+
+  slice_count=min(param->threads,count/MIN_SORT_THREAD_KEYS);
+  set_if_smaller(slice_count,MAX_SORT_THREADS);
+  set_if_bigger(slice_count,1);
+  slice_keys=count/slice_count;
+  for (i=0 ; i < slice_count ; i++)
+  {
+    slices[i].keys= sort_keys+i*slice_keys;
+    slices[i].count= (i == slice_count-1 ? count-i*slice_keys : slice_keys);
+    slices[i].sort_length= param->sort_length;
+  }
+  DBUG_PRINT("info",("keys: %u  slices: %u",count,slice_count));
+  if (slice_count == 1)
+    sort_slice((void*) slices);
+  else if (run_sort_jobs(sort_slice,(byte*) slices,sizeof(*slices),
+			 slice_count))
+    DBUG_RETURN(0);
+  DBUG_RETURN(slice_count);
+}
+
+
+#ifdef THREAD
+
+/* Threads started by run_sort_jobs() */
+
+typedef struct st_sort_threads {
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  uint running;
+  bool got_error;
+} SORT_THREADS;
+
+typedef struct st_sort_thread_arg {
+  SORT_THREADS *threads;
+  sort_job_func func;
+  void *job;
+} SORT_THREAD_ARG;
+
+
+pthread_handler_decl(handle_sort_job,arg)
+{
+  SORT_THREAD_ARG *thread_arg=(SORT_THREAD_ARG*) arg;
+  SORT_THREADS *threads=thread_arg->threads;
+  int error=1;
+
+  if (!my_thread_init())
+    error=(*thread_arg->func)(thread_arg->job);
+  pthread_mutex_lock(&threads->mutex);
+  if (error)
+    threads->got_error=1;
+  threads->running--;
+  pthread_cond_signal(&threads->cond);
+  pthread_mutex_unlock(&threads->mutex);
+  my_thread_end();
+  return 0;
+}
+#endif /* THREAD */
+
+
+/*
+  Run sort jobs in parallel
+
+  SYNOPSIS
+    run_sort_jobs()
+    func		Function that does one job
+    jobs		Array of job arguments
+    job_length		Length of one job argument
+    count		Number of jobs
+
+  NOTES
+    The first job is done by the calling thread, the others by one new
+    thread each. If a thread can't be created, the calling thread does
+    the job.
+    Returns when all jobs are done.
+
+  RETURN
+    0	ok
+    1	Some job failed
+*/
+
+static bool run_sort_jobs(sort_job_func func, byte *jobs, uint job_length,
+			  uint count)
+{
+  bool error=0;
+  uint i;
+  DBUG_ENTER("run_sort_jobs");
+#ifdef THREAD
+  SORT_THREADS threads;
+  SORT_THREAD_ARG thread_args[MAX_SORT_THREADS];
+  pthread_attr_t thr_attr;
+  pthread_t thr;
+
+  pthread_mutex_init(&threads.mutex,MY_MUTEX_INIT_FAST);
+  pthread_cond_init(&threads.cond,0);
+  threads.running=0;
+  threads.got_error=0;
+  (void) pthread_attr_init(&thr_attr);
+  (void) pthread_attr_setdetachstate(&thr_attr,PTHREAD_CREATE_DETACHED);
+
+  for (i=1 ; i < count ; i++)
+  {
+    thread_args[i].threads= &threads;
+    thread_args[i].func= func;
+    thread_args[i].job= (void*) (jobs+i*job_length);
+    pthread_mutex_lock(&threads.mutex);
+    if (pthread_create(&thr,&thr_attr,handle_sort_job,
+		       (void*) (thread_args+i)))
+    {
+      pthread_mutex_unlock(&threads.mutex);
+      DBUG_PRINT("warning",("Can't create sort thread; error: %d",errno));
+      if ((*func)(thread_args[i].job))
+	error=1;
+    }
+    else
+    {
+      threads.running++;
+      pthread_mutex_unlock(&threads.mutex);
+    }
+  }
+  (void) pthread_attr_destroy(&thr_attr);
+
+  if ((*func)((void*) jobs))
+    error=1;
+
+  /* Wait for all threads to finish */
+  pthread_mutex_lock(&threads.mutex);
+  while (threads.running)
+    pthread_cond_wait(&threads.cond,&threads.mutex);
+  pthread_mutex_unlock(&threads.mutex);
+  if (threads.got_error)
+    error=1;
+  pthread_cond_destroy(&threads.cond);
+  pthread_mutex_destroy(&threads.mutex);
+#else
+  for (i=0 ; i < count ; i++)
+  {
+    if ((*func)((void*) (jobs+i*job_length)))
+      error=1;
+  }
+#endif /* THREAD */
+  DBUG_RETURN(error);
+}
+
+
 	/* Merge buffers to make < MERGEBUFF2 buffers */
 
 int merge_many_buff(SORTPARAM *param, uchar *sort_buffer,
@@ -659,6 +942,15 @@ int merge_many_buff(SORTPARAM *param, uchar *sort_buffer,
     reinit_io_cache(from_file,READ_CACHE,0L,0,0);
     reinit_io_cache(to_file,WRITE_CACHE,0L,0,0);
     lastbuff=buffpek;
+    if ((i=merge_pass_in_threads(param,sort_buffer,buffpek,*maxbuffer,
+				 &lastbuff,from_file,to_file)) <= 0)
+    {
+      if (i < 0)
+	break;					/* purecov: inspected */
+      temp=from_file; from_file=to_file; to_file=temp;
+      *maxbuffer= (uint) (lastbuff-buffpek)-1;
+      continue;
+    }
     for (i=0 ; i <= (int) *maxbuffer-MERGEBUFF*3/2 ; i+=MERGEBUFF)
     {
       if (merge_buffers(param,from_file,to_file,sort_buffer,lastbuff++,
@@ -681,6 +973,169 @@ int merge_many_buff(SORTPARAM *param, uchar *sort_buffer,
 } /* merge_many_buff */
 
 
+/*
+  IO_CACHE write functions that write with my_pwrite() at pos_in_file.
+  This lets the threads of merge_pass_in_threads() write to different
+  parts of the same file.
+*/
+
+static int pwrite_io_cache_flush(IO_CACHE *info)
+{
+  uint length=(uint) (info->write_pos - info->write_buffer);
+  if (length && my_pwrite(info->file,info->write_buffer,length,
+			  info->pos_in_file,MYF(MY_WME | MY_NABP)))
+    return (info->error= -1);
+  info->pos_in_file+=length;
+  info->write_pos=info->write_buffer;
+  info->write_end=info->write_buffer+info->buffer_length;
+  return 0;
+}
+
+
+static int pwrite_io_cache_write(IO_CACHE *info, const byte *Buffer,
+				 uint Count)
+{
+  uint rest_length=(uint) (info->write_end - info->write_pos);
+  memcpy(info->write_pos,Buffer,(size_t) rest_length);
+  Buffer+=rest_length;
+  Count-=rest_length;
+  info->write_pos+=rest_length;
+  if (pwrite_io_cache_flush(info))
+    return 1;
+  if (Count >= info->buffer_length)
+  {
+    if (my_pwrite(info->file,Buffer,Count,info->pos_in_file,
+		  MYF(MY_WME | MY_NABP)))
+      return (info->error= -1);
+    info->pos_in_file+=Count;
+    return 0;
+  }
+  memcpy(info->write_pos,Buffer,(size_t) Count);
+  info->write_pos+=Count;
+  return 0;
+}
+
+
+	/* Merge the groups of one merge pass job */
+
+static int merge_job(void *arg)
+{
+  MERGE_JOB *job=(MERGE_JOB*) arg;
+  MERGE_GROUP *group;
+  IO_CACHE to_file;
+  int error=0;
+
+  if (init_io_cache(&to_file,job->to_file,DISK_BUFFER_SIZE,WRITE_CACHE,0L,
+		    0,MYF(MY_WME)))
+    return 1;					/* purecov: inspected */
+  to_file.write_function=pwrite_io_cache_write;
+  for (group=job->group ; group < job->end ; group+=job->step)
+  {
+    to_file.pos_in_file=group->to_pos;
+    if (merge_buffers(&job->param,job->from_file,&to_file,job->sort_buffer,
+		      &group->result,group->first,group->last,0) ||
+	pwrite_io_cache_flush(&to_file))
+    {
+      error=1;
+      break;
+    }
+  }
+  to_file.write_pos=to_file.write_buffer;	/* Nothing left to flush */
+  end_io_cache(&to_file);
+  return error;
+}
+
+
+/*
+  Do one pass of merge_many_buff() with several threads
+
+  SYNOPSIS
+    merge_pass_in_threads()
+    param		Sort parameters
+    sort_buffer		Buffer of param->keys keys
+    buffpek		Runs to merge
+    maxbuffer		Index of last run
+    lastbuff		Set to after the last merged run in buffpek
+    from_file		File with the runs
+    to_file		File to write the merged runs to
+
+  NOTES
+    The runs are merged in groups of MERGEBUFF, as in merge_many_buff().
+    Each thread gets its own part of the sort buffer and merges every
+    n'th group. The result of a group is written at the position its
+    runs had in from_file, so the threads don't need to wait for each
+    other.
+
+  RETURN
+    -1	error
+    0	ok
+    1	Not done; Use only one thread for this pass
+*/
+
+static int merge_pass_in_threads(SORTPARAM *param, uchar *sort_buffer,
+				 BUFFPEK *buffpek, uint maxbuffer,
+				 BUFFPEK **lastbuff,
+				 IO_CACHE *from_file, IO_CACHE *to_file)
+{
+  MERGE_GROUP *groups,*group;
+  MERGE_JOB jobs[MAX_SORT_THREADS],*job;
+  uint i,group_count,thread_count,thread_keys;
+  my_off_t pos;
+  bool error;
+  DBUG_ENTER("merge_pass_in_threads");
+
+  if (param->threads <= 1 || param->unique_buff)
+    DBUG_RETURN(1);
+  group_count=(maxbuffer+1)/MERGEBUFF;
+  thread_count=min(min(param->threads,group_count),MAX_SORT_THREADS);
+  /* Each thread needs memory for a few keys of each run in a group */
+  while (thread_count > 1 && param->keys/thread_count < MERGEBUFF2)
+    thread_count--;
+  if (thread_count <= 1)
+    DBUG_RETURN(1);
+
+  if (to_file->file < 0 && real_open_cached_file(to_file))
+    DBUG_RETURN(-1);				/* purecov: inspected */
+  if (!(groups=(MERGE_GROUP*) my_malloc(sizeof(MERGE_GROUP)*group_count,
+					MYF(MY_WME))))
+    DBUG_RETURN(-1);				/* purecov: inspected */
+
+  /* Groups of MERGEBUFF runs; The last group gets the remaining runs */
+  pos=0;
+  for (i=0, group=groups ; group < groups+group_count ; group++)
+  {
+    group->first=buffpek+i;
+    i= (group == groups+group_count-1 ? maxbuffer+1 : i+MERGEBUFF);
+    group->last=buffpek+i-1;
+    group->to_pos=pos;
+    for (BUFFPEK *run=group->first ; run <= group->last ; run++)
+      pos+= run->count*param->sort_length;
+  }
+
+  thread_keys=param->keys/thread_count;
+  for (i=0, job=jobs ; i < thread_count ; i++, job++)
+  {
+    job->param= *param;
+    job->param.keys= thread_keys;
+    job->sort_buffer= sort_buffer+i*thread_keys*param->sort_length;
+    job->from_file= from_file;
+    job->to_file= to_file->file;
+    job->group= groups+i;
+    job->end= groups+group_count;
+    job->step= thread_count;
+  }
+  DBUG_PRINT("info",("runs: %u  groups: %u  threads: %u",
+		     maxbuffer+1, group_count, thread_count));
+  error=run_sort_jobs(merge_job,(byte*) jobs,sizeof(*jobs),thread_count);
+
+  for (i=0 ; i < group_count ; i++)
+    buffpek[i]=groups[i].result;
+  *lastbuff=buffpek+group_count;
+  my_free((gptr) groups,MYF(0));
+  DBUG_RETURN(error ? -1 : 0);
+}
+
+
 	/* Read data to buffer */
 	/* This returns (uint) -1 if something goes wrong */
 
@@ -720,7 +1175,7 @@ int merge_buffers(SORTPARAM *param, IO_CACHE *from_file,
   BUFFPEK *buffpek,**refpek;
   QUEUE queue;
   qsort2_cmp    cmp;
-  volatile bool *killed= &current_thd->killed;
+  volatile bool *killed= param->killed ? param->killed : &current_thd->killed;
   bool not_killable;
   DBUG_ENTER("merge_buffers");
 
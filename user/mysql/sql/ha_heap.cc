@@ -56,13 +56,24 @@ int ha_heap::open(const char *name, int mode, uint test_if_locked)
 
     keydef[key].keysegs=(uint) pos->key_parts;
     keydef[key].flag = (pos->flags & (HA_NOSAME | HA_NULL_ARE_EQUAL));
+    keydef[key].algorithm= (pos->algorithm == HA_KEY_ALG_BTREE ?
+			    HA_KEY_ALG_BTREE : HA_KEY_ALG_HASH);
     keydef[key].seg=seg;
 
     for (; key_part != key_part_end ; key_part++, seg++)
     {
       uint flag=key_part->key_type;
       Field *field=key_part->field;
-      if (!f_is_packed(flag) &&
+      if (pos->algorithm == HA_KEY_ALG_BTREE)
+      {
+	/* The rb_tree compares the keys by type to get them in order */
+	seg->type= (int) field->key_type();
+	if (seg->type == (int) HA_KEYTYPE_VARTEXT)
+	  seg->type= (int) HA_KEYTYPE_TEXT;
+	else if (seg->type == (int) HA_KEYTYPE_VARBINARY)
+	  seg->type= (int) HA_KEYTYPE_BINARY;
+      }
+      else if (!f_is_packed(flag) &&
 	  f_packtype(flag) == (int) FIELD_TYPE_DECIMAL &&
 	  !(flag & FIELDFLAG_BINARY))
 	seg->type= (int) HA_KEYTYPE_TEXT;
@@ -126,23 +137,19 @@ int ha_heap::delete_row(const byte * buf)
 }
 
 int ha_heap::index_read(byte * buf, const byte * key,
-			uint key_len __attribute__((unused)),
-			enum ha_rkey_function find_flag
-			__attribute__((unused)))
+			uint key_len, enum ha_rkey_function find_flag)
 {
   statistic_increment(ha_read_key_count,&LOCK_status);
-  int error=heap_rkey(file,buf,active_index, key);
+  int error=heap_rkey(file,buf,active_index, key, key_len, find_flag);
   table->status=error ? STATUS_NOT_FOUND: 0;
   return error;
 }
 
 int ha_heap::index_read_idx(byte * buf, uint index, const byte * key,
-			    uint key_len __attribute__((unused)),
-			    enum ha_rkey_function find_flag
-			    __attribute__((unused)))
+			    uint key_len, enum ha_rkey_function find_flag)
 {
   statistic_increment(ha_read_key_count,&LOCK_status);
-  int error=heap_rkey(file, buf, index, key);
+  int error=heap_rkey(file, buf, index, key, key_len, find_flag);
   table->status=error ? STATUS_NOT_FOUND: 0;
   return error;
 }
@@ -167,7 +174,7 @@ int ha_heap::index_prev(byte * buf)
 int ha_heap::index_first(byte * buf)
 {
   statistic_increment(ha_read_first_count,&LOCK_status);
-  int error=heap_rfirst(file, buf);
+  int error=heap_rfirst(file, buf, active_index);
   table->status=error ? STATUS_NOT_FOUND: 0;
   return error;
 }
@@ -175,7 +182,7 @@ int ha_heap::index_first(byte * buf)
 int ha_heap::index_last(byte * buf)
 {
   statistic_increment(ha_read_last_count,&LOCK_status);
-  int error=heap_rlast(file, buf);
+  int error=heap_rlast(file, buf, active_index);
   table->status=error ? STATUS_NOT_FOUND: 0;
   return error;
 }
@@ -193,6 +200,28 @@ int ha_heap::rnd_next(byte *buf)
   return error;
 }
 
+int ha_heap::rnd_next_batch(byte *buf, uint row_length, uint max_rows,
+			    uint *rows_read)
+{
+  int error=0;
+  uint rows;
+  for (rows=0 ; rows < max_rows ; )
+  {
+    if ((error=heap_scan(file, buf)))
+    {
+      if (error == HA_ERR_RECORD_DELETED)
+	continue;
+      break;
+    }
+    rows++;
+    buf+=row_length;
+  }
+  statistic_add(ha_read_rnd_next_count,rows,&LOCK_status);
+  table->status=rows ? 0 : STATUS_NOT_FOUND;
+  *rows_read=rows;
+  return error;
+}
+
 int ha_heap::rnd_pos(byte * buf, byte *pos)
 {
   int error;
@@ -280,6 +309,10 @@ ha_rows ha_heap::records_in_range(int inx,
 				  enum ha_rkey_function end_search_flag)
 {
   KEY *pos=table->key_info+inx;
+  if (pos->algorithm == HA_KEY_ALG_BTREE)
+    return hp_rb_records_in_range(file, inx, start_key, start_key_len,
+				  start_search_flag, end_key, end_key_len,
+				  end_search_flag);
   if (start_key_len != end_key_len ||
       start_key_len != pos->key_length ||
       start_search_flag != HA_READ_KEY_EXACT ||
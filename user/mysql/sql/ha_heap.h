@@ -41,7 +41,7 @@ class ha_heap: public handler
   {
     return (HA_READ_RND_SAME | HA_NO_INDEX | HA_KEYPOS_TO_RNDPOS |
 	    HA_NO_BLOBS | HA_NULL_KEY | HA_REC_NOT_IN_SEQ |
-	    HA_NO_AUTO_INCREMENT);
+	    HA_NO_AUTO_INCREMENT | HA_READ_BATCH);
   }
   ulong index_flags(uint inx) const
   {
@@ -74,6 +74,8 @@ class ha_heap: public handler
   int index_last(byte * buf);
   int rnd_init(bool scan=1);
   int rnd_next(byte *buf);
+  int rnd_next_batch(byte *buf, uint row_length, uint max_rows,
+		     uint *rows_read);
   int rnd_pos(byte * buf, byte *pos);
   void position(const byte *record);
   void info(uint);
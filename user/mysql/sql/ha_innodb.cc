@@ -69,6 +69,7 @@ extern "C" {
 #include "../innobase/include/btr0cur.h"
 #include "../innobase/include/btr0btr.h"
 #include "../innobase/include/fsp0fsp.h"
+#include "../innobase/include/buf0buf.h"
 }
 
 #define HA_INNOBASE_ROWS_IN_TABLE 10000 /* to get optimization right */
@@ -83,9 +84,12 @@ are declared in mysqld.cc: */
 
 long innobase_mirrored_log_groups, innobase_log_files_in_group,
      innobase_log_file_size, innobase_log_buffer_size,
-     innobase_buffer_pool_size, innobase_additional_mem_pool_size,
+     innobase_buffer_pool_size, innobase_buffer_pool_zip_size,
+     innobase_buffer_pool_instances, innobase_adaptive_hash_index_parts,
+     innobase_additional_mem_pool_size,
      innobase_file_io_threads, innobase_lock_wait_timeout,
-     innobase_thread_concurrency, innobase_force_recovery;
+     innobase_thread_concurrency, innobase_force_recovery,
+     innobase_recovery_threads;
 
 /* The default values for the following char* start-up parameters
 are determined in innobase_init below: */
@@ -103,7 +107,7 @@ values */
 
 uint	innobase_flush_log_at_trx_commit	= 1;
 my_bool innobase_log_archive			= FALSE;
-my_bool	innobase_use_native_aio			= FALSE;
+my_bool	innobase_use_native_aio			= TRUE;
 my_bool	innobase_fast_shutdown			= TRUE;
 
 static char *internal_innobase_data_file_path	= NULL;
@@ -815,10 +819,16 @@ innobase_init(void)
 	srv_flush_log_at_trx_commit = (ulint) innobase_flush_log_at_trx_commit;
 
 	srv_pool_size = (ulint) innobase_buffer_pool_size;
+	srv_pool_zip_size = (ulint) innobase_buffer_pool_zip_size;
+	srv_buf_pool_instances = (ulint) innobase_buffer_pool_instances;
+	srv_adaptive_hash_index_parts =
+				(ulint) innobase_adaptive_hash_index_parts;
 
 	srv_mem_pool_size = (ulint) innobase_additional_mem_pool_size;
 
 	srv_n_file_io_threads = (ulint) innobase_file_io_threads;
+	srv_n_recovery_threads = (ulint) innobase_recovery_threads;
+	srv_use_native_aio = (ibool) innobase_use_native_aio;
 
 	srv_lock_wait_timeout = (ulint) innobase_lock_wait_timeout;
 	srv_thread_concurrency = (ulint) innobase_thread_concurrency;
@@ -854,6 +864,9 @@ innobase_init(void)
 		DBUG_RETURN(1);
 	}
 
+	/* Show in SHOW VARIABLES if InnoDB fell back to simulated aio */
+	innobase_use_native_aio = (my_bool) os_aio_use_native_aio;
+
 	(void) hash_init(&innobase_open_tables,32,0,0,
 			 		(hash_get_key) innobase_get_key,0,0);
 	pthread_mutex_init(&innobase_mutex,MY_MUTEX_INIT_FAST);
@@ -930,6 +943,18 @@ innobase_get_free_space(void)
 	return((uint) fsp_get_available_space_in_free_extents(0));
 }
 
+/*************************************************************************
+Gets the number of pages read to the buffer pool since startup; used by
+SHOW PROFILE. */
+
+ulong
+innobase_get_pages_read(void)
+/*=========================*/
+			/* out: pages read */
+{
+	return((ulong) buf_get_n_pages_read());
+}
+
 /*********************************************************************
 Commits a transaction in an InnoDB database. */
 
@@ -956,6 +981,15 @@ innobase_commit_low(
 					 (active_mi->rli.master_log_pos +
 					  active_mi->rli.event_len +
 					  active_mi->rli.pending));
+
+		/* A worker of a parallel slave commits the group of events
+		it applies; the end of the group is the position */
+
+		if (current_thd->slave_worker
+		    && current_thd->slave_worker->group_master_log_pos) {
+			trx->mysql_master_log_pos = (ib_longlong)
+			current_thd->slave_worker->group_master_log_pos;
+		}
         }
 
 	trx_commit_for_mysql(trx);
@@ -1095,6 +1129,26 @@ innobase_commit_complete(
 	return(0);
 }
 
+/*********************************************************************
+This is called by the leader of a binlog group commit after it has written
+the binlog entries of the group. Flushes the InnoDB log files, if required,
+for all transactions of the group with one write. */
+
+int
+innobase_group_commit_complete(void)
+/*================================*/
+				/* out: 0 */
+{
+	if (srv_flush_log_at_trx_commit == 0) {
+
+	        return(0);
+	}
+
+	trx_commit_complete_group_for_mysql();
+
+	return(0);
+}
+
 /*********************************************************************
 Rolls back a transaction or the latest SQL statement. */
 
@@ -194,9 +194,13 @@ extern char *innobase_home, *innobase_tmpdir, *innobase_logdir;
 extern long innobase_lock_scan_time;
 extern long innobase_mirrored_log_groups, innobase_log_files_in_group;
 extern long innobase_log_file_size, innobase_log_buffer_size;
-extern long innobase_buffer_pool_size, innobase_additional_mem_pool_size;
+extern long innobase_buffer_pool_size, innobase_buffer_pool_zip_size;
+extern long innobase_buffer_pool_instances;
+extern long innobase_adaptive_hash_index_parts;
+extern long innobase_additional_mem_pool_size;
 extern long innobase_file_io_threads, innobase_lock_wait_timeout;
 extern long innobase_force_recovery, innobase_thread_concurrency;
+extern long innobase_recovery_threads;
 extern char *innobase_data_home_dir, *innobase_data_file_path;
 extern char *innobase_log_group_home_dir, *innobase_log_arch_dir;
 extern char *innobase_unix_file_flush_method;
@@ -213,6 +217,7 @@ bool innobase_init(void);
 bool innobase_end(void);
 bool innobase_flush_logs(void);
 uint innobase_get_free_space(void);
+ulong innobase_get_pages_read(void);
 
 int innobase_commit(THD *thd, void* trx_handle);
 int innobase_report_binlog_offset_and_commit(
@@ -222,6 +227,7 @@ int innobase_report_binlog_offset_and_commit(
         my_off_t end_offset);
 int innobase_commit_complete(
         void*   trx_handle);
+int innobase_group_commit_complete(void);
 int innobase_rollback(THD *thd, void* trx_handle);
 int innobase_rollback_to_savepoint(
 	THD*	thd,
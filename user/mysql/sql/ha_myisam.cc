@@ -584,8 +584,13 @@ int ha_myisam::repair(THD *thd, MI_CHECK &param, bool optimize)
       if (current_thd->variables.myisam_repair_threads>1)
       {
         char buf[40];
-        /* TODO: respect myisam_repair_threads variable */
-        my_snprintf(buf, 40, "Repair with %d threads", my_count_bits(key_map));
+        /*
+          Each key gets its own thread; if there are more threads than
+          keys, the sorting of each key is split between the threads
+        */
+        param.repair_threads= (uint) thd->variables.myisam_repair_threads;
+        my_snprintf(buf, 40, "Repair with %d threads",
+                    max(my_count_bits(key_map), param.repair_threads));
         thd->proc_info=buf;
         error = mi_repair_parallel(&param, file, fixed_name,
             param.testflag & T_QUICK);
@@ -754,6 +759,152 @@ bool ha_myisam::activate_all_index(THD *thd)
 }
 
 
+/*
+  Check if two MyISAM tables store their rows in the same way
+*/
+
+static bool same_row_format(MYISAM_SHARE *a, MYISAM_SHARE *b)
+{
+  if (a->data_file_type != b->data_file_type ||
+      a->data_file_type == COMPRESSED_RECORD ||
+      ((a->options ^ b->options) &
+       (HA_OPTION_PACK_RECORD | HA_OPTION_CHECKSUM |
+	HA_OPTION_COMPRESS_RECORD | HA_OPTION_READ_ONLY_DATA)) ||
+      a->base.reclength != b->base.reclength ||
+      a->base.pack_reclength != b->base.pack_reclength ||
+      a->base.min_pack_length != b->base.min_pack_length ||
+      a->base.max_pack_length != b->base.max_pack_length ||
+      a->base.min_block_length != b->base.min_block_length ||
+      a->base.fields != b->base.fields ||
+      a->base.blobs != b->base.blobs ||
+      a->base.pack_bits != b->base.pack_bits ||
+      a->base.rec_reflength != b->base.rec_reflength ||
+      a->base.key_reflength != b->base.key_reflength ||
+      a->base.raid_type || b->base.raid_type)
+    return 0;
+  for (uint i=0 ; i < a->base.fields ; i++)
+  {
+    MI_COLUMNDEF *col_a=a->rec+i, *col_b=b->rec+i;
+    if (col_a->type != col_b->type || col_a->length != col_b->length ||
+	col_a->null_bit != col_b->null_bit ||
+	col_a->null_pos != col_b->null_pos)
+      return 0;
+  }
+  return 1;
+}
+
+
+/*
+  Check if two MyISAM keys have the same definition and index pages
+*/
+
+static bool same_key(MI_KEYDEF *a, MI_KEYDEF *b)
+{
+  if (a->flag != b->flag || a->keysegs != b->keysegs ||
+      a->key_alg != b->key_alg || a->block_length != b->block_length ||
+      a->keylength != b->keylength || a->minlength != b->minlength ||
+      a->maxlength != b->maxlength)
+    return 0;
+  for (MI_KEYSEG *seg_a=a->seg, *seg_b=b->seg ;
+       seg_a->type != HA_KEYTYPE_END ; seg_a++, seg_b++)
+  {
+    if (seg_a->type != seg_b->type || seg_a->language != seg_b->language ||
+	seg_a->null_bit != seg_b->null_bit || seg_a->flag != seg_b->flag ||
+	seg_a->length != seg_b->length || seg_a->start != seg_b->start ||
+	seg_a->null_pos != seg_b->null_pos ||
+	seg_a->bit_start != seg_b->bit_start)
+      return 0;
+  }
+  return 1;
+}
+
+
+/*
+  Create the table from a table with the same columns but other keys
+
+  SYNOPSIS
+    build_keys_from()
+    thd			Thread handler
+    from		Old table; Must be locked against writes
+
+  DESCRIPTION
+    Used by ALTER TABLE when only keys are added or dropped.
+    The data file and the index trees of the kept keys are copied with
+    mi_copy_table(); only the new keys are then created with a sort,
+    which with myisam_repair_threads > 1 is done by several threads.
+
+  RETURN
+    0			ok
+    HA_ERR_WRONG_COMMAND The rows must be copied one by one; This is the
+			case when the row format differs or when a new key
+			is unique, as a duplicate must then give an error
+    1			Error; The error message is given
+*/
+
+int ha_myisam::build_keys_from(THD *thd, TABLE *from)
+{
+  MI_CHECK param;
+  MI_INFO *from_file;
+  MYISAM_SHARE *share=file->s, *from_share;
+  int from_key[MI_MAX_KEY];
+  uint key;
+  DBUG_ENTER("ha_myisam::build_keys_from");
+
+  if (from->db_type != DB_TYPE_MYISAM)
+    DBUG_RETURN(HA_ERR_WRONG_COMMAND);
+  from_file= ((ha_myisam*) from->file)->file;
+  from_share= from_file->s;
+  if (mi_is_crashed(from_file) || file->state->records ||
+      !same_row_format(share, from_share))
+    DBUG_RETURN(HA_ERR_WRONG_COMMAND);
+
+  /* Find the keys that are kept */
+  for (key=0 ; key < share->base.keys ; key++)
+  {
+    uint i;
+    from_key[key]= -1;
+    for (i=0 ; i < from_share->base.keys ; i++)
+    {
+      if (!my_strcasecmp(table->key_info[key].name, from->key_info[i].name))
+      {
+	if (same_key(share->keyinfo+key, from_share->keyinfo+i))
+	  from_key[key]= (int) i;
+	break;
+      }
+    }
+    if (from_key[key] < 0 && (share->keyinfo[key].flag & HA_NOSAME))
+      DBUG_RETURN(HA_ERR_WRONG_COMMAND);
+  }
+  if (share->base.auto_key &&
+      (!from_share->base.auto_key ||
+       from_key[share->base.auto_key-1] != (int) from_share->base.auto_key-1))
+    DBUG_RETURN(HA_ERR_WRONG_COMMAND);
+
+  /* Keys changed by earlier writes may only be in the key cache */
+  if (flush_key_blocks(from_share->kfile, FLUSH_KEEP))
+  {
+    print_error(my_errno, MYF(0));
+    DBUG_RETURN(1);
+  }
+
+  myisamchk_init(&param);
+  param.thd= thd;
+  param.op_name= (char*) "alter";
+  param.db_name= table->table_cache_key;
+  param.table_name= table->table_name;
+  param.testflag= T_SILENT | T_CREATE_MISSING_KEYS;	// Errors to client
+  param.myf_rw&= ~MY_WAIT_IF_FULL;
+  param.tmpdir= mysql_tmpdir;
+  thd->proc_info="copy data file";
+  if (mi_copy_table(&param, file, from_file, from_key))
+    DBUG_RETURN(1);
+
+  /* Create the new keys */
+  enable_activate_all_index=1;
+  DBUG_RETURN(activate_all_index(thd) ? 1 : 0);
+}
+
+
 bool ha_myisam::check_and_repair(THD *thd)
 {
   int error=0;
@@ -870,6 +1021,85 @@ int ha_myisam::index_next_same(byte * buf,
 }
 
 
+static int mrr_row_cmp(const MYISAM_MRR_ROW *a, const MYISAM_MRR_ROW *b)
+{
+  return a->pos < b->pos ? -1 : a->pos > b->pos ? 1 : 0;
+}
+
+
+/*
+  Find the rows of many key ranges and sort them in data file order
+
+  NOTES
+    The ranges are looked up in the index only, remembering the position
+    of every matching row.  multi_range_read_next() then reads the rows
+    in order of their position, which turns one random seek per key into
+    one forward sweep over the data file.
+    With a covering index there are no rows to read; the ranges are then
+    read in the given order by the default implementation.
+*/
+
+int ha_myisam::multi_range_read_init(KEY_MULTI_RANGE *ranges,
+				     uint range_count)
+{
+  KEY_MULTI_RANGE *range,*end;
+  MYISAM_MRR_ROW row;
+  int error;
+  DBUG_ENTER("ha_myisam::multi_range_read_init");
+
+  delete_dynamic(&mrr_rows);
+  mrr_next_row=0;
+  if (table->key_read)
+    DBUG_RETURN(handler::multi_range_read_init(ranges,range_count));
+
+  if (my_init_dynamic_array(&mrr_rows,sizeof(MYISAM_MRR_ROW),range_count,
+			    range_count))
+    DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+  for (range=ranges, end=ranges+range_count ; range != end ; range++)
+  {
+    statistic_increment(ha_read_key_count,&LOCK_status);
+    error=mi_rkey(file, (byte*) 0, active_index, range->key, range->length,
+		  HA_READ_KEY_EXACT);
+    row.range_ptr=range->ptr;
+    while (!error)
+    {
+      row.pos=mi_position(file);
+      if (insert_dynamic(&mrr_rows,(gptr) &row))
+	DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+      statistic_increment(ha_read_next_count,&LOCK_status);
+      error=mi_rnext_same(file, (byte*) 0);
+    }
+    if (error != HA_ERR_KEY_NOT_FOUND && error != HA_ERR_END_OF_FILE)
+      DBUG_RETURN(error);
+  }
+  qsort(mrr_rows.buffer, mrr_rows.elements, sizeof(MYISAM_MRR_ROW),
+	(qsort_cmp) mrr_row_cmp);
+  DBUG_PRINT("info",("ranges: %u  rows: %u", range_count, mrr_rows.elements));
+  DBUG_RETURN(0);
+}
+
+
+int ha_myisam::multi_range_read_next(byte *buf, char **range_ptr)
+{
+  int error;
+  if (!mrr_rows.buffer)
+    return handler::multi_range_read_next(buf, range_ptr);
+  while (mrr_next_row < mrr_rows.elements)
+  {
+    MYISAM_MRR_ROW *row=dynamic_element(&mrr_rows, mrr_next_row++,
+					MYISAM_MRR_ROW*);
+    statistic_increment(ha_read_rnd_count,&LOCK_status);
+    if ((error=mi_rrnd(file, buf, row->pos)) == HA_ERR_RECORD_DELETED)
+      continue;
+    table->status=error ? STATUS_NOT_FOUND: 0;
+    *range_ptr=row->range_ptr;
+    return error;
+  }
+  table->status=STATUS_NOT_FOUND;
+  return HA_ERR_END_OF_FILE;
+}
+
+
 int ha_myisam::rnd_init(bool scan)
 {
   if (scan)
@@ -885,6 +1115,28 @@ int ha_myisam::rnd_next(byte *buf)
   return error;
 }
 
+int ha_myisam::rnd_next_batch(byte *buf, uint row_length, uint max_rows,
+			      uint *rows_read)
+{
+  int error=0;
+  uint rows;
+  for (rows=0 ; rows < max_rows ; )
+  {
+    if ((error=mi_scan(file, buf)))
+    {
+      if (error == HA_ERR_RECORD_DELETED)
+	continue;
+      break;
+    }
+    rows++;
+    buf+=row_length;
+  }
+  statistic_add(ha_read_rnd_next_count,rows,&LOCK_status);
+  table->status=rows ? 0 : STATUS_NOT_FOUND;
+  *rows_read=rows;
+  return error;
+}
+
 int ha_myisam::restart_rnd_next(byte *buf, byte *pos)
 {
   return rnd_pos(buf,pos);
@@ -34,22 +34,35 @@ extern ulong myisam_sort_buffer_size;
 extern TYPELIB myisam_recover_typelib;
 extern ulong myisam_recover_options;
 
+/* A row found by multi_range_read_init() */
+
+typedef struct st_myisam_mrr_row
+{
+  my_off_t pos;
+  char *range_ptr;
+} MYISAM_MRR_ROW;
+
 class ha_myisam: public handler
 {
   MI_INFO *file;
   uint    int_table_flags;
   char    *data_file_name, *index_file_name;
   bool enable_activate_all_index;
+  DYNAMIC_ARRAY mrr_rows;		/* Rows of ranges in file order */
+  uint mrr_next_row;
   int repair(THD *thd, MI_CHECK &param, bool optimize);
 
  public:
   ha_myisam(TABLE *table): handler(table), file(0),
     int_table_flags(HA_READ_RND_SAME | HA_KEYPOS_TO_RNDPOS | HA_LASTKEY_ORDER |
 		    HA_NULL_KEY | HA_CAN_FULLTEXT | HA_CAN_SQL_HANDLER |
-		    HA_DUPP_POS | HA_BLOB_KEY | HA_AUTO_PART_KEY),
+		    HA_DUPP_POS | HA_BLOB_KEY | HA_AUTO_PART_KEY |
+		    HA_MULTI_RANGE_READ | HA_READ_BATCH),
     enable_activate_all_index(1)
-  {}
-  ~ha_myisam() {}
+  {
+    bzero((char*) &mrr_rows,sizeof(mrr_rows));
+  }
+  ~ha_myisam() { delete_dynamic(&mrr_rows); }
   const char *table_type() const { return "MyISAM"; }
   const char *index_type(uint key_number);
   const char **bas_ext() const;
@@ -80,6 +93,9 @@ class ha_myisam: public handler
   int index_first(byte * buf);
   int index_last(byte * buf);
   int index_next_same(byte *buf, const byte *key, uint keylen);
+  int multi_range_read_init(KEY_MULTI_RANGE *ranges, uint range_count);
+  int multi_range_read_next(byte *buf, char **range_ptr);
+  void multi_range_read_end() { delete_dynamic(&mrr_rows); }
   int index_end() { ft_handler=NULL; return 0; }
   int ft_init()
   {
@@ -94,6 +110,8 @@ class ha_myisam: public handler
   int ft_read(byte *buf);
   int rnd_init(bool scan=1);
   int rnd_next(byte *buf);
+  int rnd_next_batch(byte *buf, uint row_length, uint max_rows,
+		     uint *rows_read);
   int rnd_pos(byte * buf, byte *pos);
   int restart_rnd_next(byte *buf, byte *pos);
   void position(const byte *record);
@@ -106,6 +124,7 @@ class ha_myisam: public handler
   int delete_all_rows(void);
   void deactivate_non_unique_index(ha_rows rows);
   bool activate_all_index(THD *thd);
+  int build_keys_from(THD *thd, TABLE *from);
   ha_rows records_in_range(int inx,
 			   const byte *start_key,uint start_key_len,
 			   enum ha_rkey_function start_search_flag,
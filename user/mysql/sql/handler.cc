@@ -307,6 +307,24 @@ int ha_commit_complete(THD *thd)
   return 0;
 }
 
+/*
+  Flushes the handler log files for all transactions committed so far with
+  ha_report_binlog_offset_and_commit(). This is called by the leader of a
+  binlog group commit when LOCK_log has been released; the following
+  ha_commit_complete() calls of the group then have nothing to flush.
+
+  return value:  always 0
+*/
+
+int ha_group_commit_complete(void)
+{
+#ifdef HAVE_INNOBASE_DB
+  if (have_innodb == SHOW_OPTION_YES)
+    innobase_group_commit_complete();
+#endif
+  return 0;
+}
+
 /*
   This function should be called when MySQL sends rows of a SELECT result set
   or the EOF mark to the client. It releases a possible adaptive hash index
@@ -1019,6 +1037,113 @@ int handler::index_next_same(byte *buf, const byte *key, uint keylen)
 }
 
 
+/*
+  Start reading the rows of many key ranges on the active index
+
+  SYNOPSIS
+    multi_range_read_init()
+    ranges		Ranges to read, see KEY_MULTI_RANGE
+    range_count		Number of ranges
+
+  NOTES
+    The ranges must stay allocated until all rows are read.
+    The default implementation reads the ranges one by one in the given
+    order with index_read() and index_next_same().  A handler that sets
+    HA_MULTI_RANGE_READ instead returns the rows in data file order.
+
+  RETURN
+    0	ok
+    #	Error code
+*/
+
+int handler::multi_range_read_init(KEY_MULTI_RANGE *ranges, uint range_count)
+{
+  mrr_range=ranges;
+  mrr_range_end=ranges+range_count;
+  mrr_in_range=0;
+  return 0;
+}
+
+
+/*
+  Read next row of the ranges given to multi_range_read_init()
+
+  SYNOPSIS
+    multi_range_read_next()
+    buf			Store row here
+    range_ptr		Store 'ptr' of the range of the row here
+
+  RETURN
+    0			ok
+    HA_ERR_END_OF_FILE	No more rows
+    #			Error code
+*/
+
+int handler::multi_range_read_next(byte *buf, char **range_ptr)
+{
+  int error;
+  for (; mrr_range != mrr_range_end ; mrr_range++, mrr_in_range=0)
+  {
+    if (mrr_in_range)
+      error=index_next_same(buf, mrr_range->key, mrr_range->length);
+    else
+      error=index_read(buf, mrr_range->key, mrr_range->length,
+		       HA_READ_KEY_EXACT);
+    if (!error)
+    {
+      mrr_in_range=1;
+      *range_ptr=mrr_range->ptr;
+      return 0;
+    }
+    if (error != HA_ERR_KEY_NOT_FOUND && error != HA_ERR_END_OF_FILE)
+      return error;
+  }
+  return HA_ERR_END_OF_FILE;
+}
+
+
+/*
+  Read many rows of a table scan at once
+
+  SYNOPSIS
+    rnd_next_batch()
+    buf			Store the rows here
+    row_length		Distance between the rows in buf
+    max_rows		Read at most this many rows
+    rows_read		Store number of read rows here
+
+  NOTES
+    Deleted rows are skipped.  The handler is positioned on the last
+    read row, so position() can't be used for the other rows.
+    The default implementation calls rnd_next() for every row.
+
+  RETURN
+    0			ok, max_rows rows read
+    #			Error code (like HA_ERR_END_OF_FILE) that ended the
+			batch; the *rows_read rows before it are valid
+*/
+
+int handler::rnd_next_batch(byte *buf, uint row_length, uint max_rows,
+			    uint *rows_read)
+{
+  int error=0;
+  uint rows;
+  for (rows=0 ; rows < max_rows ; )
+  {
+    if ((error=rnd_next(buf)))
+    {
+      if (error == HA_ERR_RECORD_DELETED)
+	continue;
+      break;
+    }
+    rows++;
+    buf+=row_length;
+  }
+  *rows_read=rows;
+  return error;
+}
+
+
 /*
   This is called to delete all rows in a table
   If the handler don't support this, then this function will
@@ -73,6 +73,10 @@
   if database is updated after read).  Not used at this point.
 */
 #define HA_LASTKEY_ORDER	(HA_NO_AUTO_INCREMENT*2)
+/* multi_range_read_next() reads the rows in data file order */
+#define HA_MULTI_RANGE_READ	(HA_LASTKEY_ORDER*2)
+/* rnd_next_batch() is faster than calling rnd_next() for every row */
+#define HA_READ_BATCH		(HA_MULTI_RANGE_READ*2)
 
 
 /* bits in index_flags(index_number) for what you can do with index */
@@ -167,6 +171,20 @@ typedef struct st_ha_create_information
 } HA_CREATE_INFO;
 
 
+/*
+  A key range for multi_range_read_init(): all rows whose key starts with
+  the first 'length' bytes of 'key'.  'ptr' is given back by
+  multi_range_read_next() with every row of the range.
+*/
+
+typedef struct st_key_multi_range
+{
+  const byte *key;
+  uint length;
+  char *ptr;
+} KEY_MULTI_RANGE;
+
+
 /* The handler for a table type.  Will be included in the TABLE structure */
 
 struct st_table;
@@ -210,6 +228,9 @@ public:
   uint raid_type,raid_chunks;
   FT_INFO *ft_handler;
   bool  auto_increment_column_changed;
+  /* Used by the default multi_range_read_next() */
+  KEY_MULTI_RANGE *mrr_range,*mrr_range_end;
+  bool mrr_in_range;
 
   handler(TABLE *table_arg) :table(table_arg),
     ref(0), data_file_length(0), max_data_file_length(0), index_file_length(0),
@@ -260,6 +281,10 @@ public:
   {
     return (my_errno=HA_ERR_WRONG_COMMAND);
   }
+  virtual int multi_range_read_init(KEY_MULTI_RANGE *ranges,
+				    uint range_count);
+  virtual int multi_range_read_next(byte *buf, char **range_ptr);
+  virtual void multi_range_read_end() {}
   virtual int ft_init()
     { return -1; }
   virtual FT_INFO *ft_init_ext(uint mode,uint inx,const byte *key, uint keylen,
@@ -269,6 +294,8 @@ public:
   virtual int rnd_init(bool scan=1)=0;
   virtual int rnd_end() { return 0; }
   virtual int rnd_next(byte *buf)=0;
+  virtual int rnd_next_batch(byte *buf, uint row_length, uint max_rows,
+			     uint *rows_read);
   virtual int rnd_pos(byte * buf, byte *pos)=0;
   virtual int read_first_row(byte *buf, uint primary_key);
   virtual int restart_rnd_next(byte *buf, byte *pos);
@@ -307,6 +334,13 @@ public:
   virtual int dump(THD* thd, int fd = -1) { return ER_DUMP_NOT_IMPLEMENTED; }
   virtual void deactivate_non_unique_index(ha_rows rows) {}
   virtual bool activate_all_index(THD *thd) {return 0;}
+  /*
+    Fill this empty table with the rows of 'from', that has the same
+    columns but other keys, by only creating the keys that 'from' hasn't.
+    Returns HA_ERR_WRONG_COMMAND if the rows must be copied one by one.
+  */
+  virtual int build_keys_from(THD *thd, TABLE *from)
+  { return HA_ERR_WRONG_COMMAND; }
   // not implemented by default
   virtual int net_read_dump(NET* net)
   { return ER_DUMP_NOT_IMPLEMENTED; }
@@ -375,6 +409,7 @@ int ha_start_stmt(THD *thd);
 int ha_report_binlog_offset_and_commit(THD *thd, char *log_file_name,
 				       my_off_t end_offset);
 int ha_commit_complete(THD *thd);
+int ha_group_commit_complete(void);
 int ha_release_temporary_latches(THD *thd);
 int ha_commit_trans(THD *thd, THD_TRANS *trans);
 int ha_rollback_trans(THD *thd, THD_TRANS *trans);
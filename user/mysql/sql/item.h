@@ -32,7 +32,8 @@ public:
   enum Type {FIELD_ITEM,FUNC_ITEM,SUM_FUNC_ITEM,STRING_ITEM,
 	     INT_ITEM,REAL_ITEM,NULL_ITEM,VARBIN_ITEM,
 	     COPY_STR_ITEM,FIELD_AVG_ITEM, DEFAULT_ITEM,
-	     PROC_ITEM,COND_ITEM,REF_ITEM,FIELD_STD_ITEM, CONST_ITEM};
+	     PROC_ITEM,COND_ITEM,REF_ITEM,FIELD_STD_ITEM, CONST_ITEM,
+	     PARAM_ITEM};
   enum cond_result { COND_UNDEF,COND_OK,COND_TRUE,COND_FALSE };
 
   String str_value;			/* used to store value */
@@ -192,6 +193,27 @@ public:
 };
 
 
+/*
+  A '?' in the query of a prepared statement. The item only marks where
+  the parameter is when the statement is prepared; the values bound by
+  COM_EXECUTE are used directly by sql_prepare.cc, so the item is NULL
+  if it's ever evaluated.
+*/
+
+class Item_param :public Item_null
+{
+public:
+  uint pos_in_query;				/* Offset of '?' in the query */
+  uint param_number;
+  Item_param(uint pos_in_query_arg, uint param_number_arg)
+    :Item_null((char*) "?"), pos_in_query(pos_in_query_arg),
+     param_number(param_number_arg)
+  {}
+  enum Type type() const { return PARAM_ITEM; }
+  unsigned int size_of() { return sizeof(*this);}  
+};
+
+
 class Item_int :public Item
 {
 public:
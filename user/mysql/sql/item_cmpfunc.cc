@@ -169,6 +169,132 @@ int Item_bool_func2::compare_int()
 }
 
 
+/*
+  Test if the comparison is 'column op constant' for a column of table
+  that val_int_batch() can evaluate
+*/
+
+bool Item_bool_func2::can_eval_batch(TABLE *table)
+{
+  uint field_arg;
+  if (cmp_func != &Item_bool_func2::compare_int &&
+      cmp_func != &Item_bool_func2::compare_real)
+    return 0;
+  if (args[0]->type() == FIELD_ITEM && args[1]->basic_const_item())
+    field_arg=0;
+  else if (args[1]->type() == FIELD_ITEM && args[0]->basic_const_item())
+    field_arg=1;
+  else
+    return 0;
+  if (((Item_field*) args[field_arg])->field->table != table)
+    return 0;
+  switch (field_arg ? rev_functype() : functype()) {
+  case EQ_FUNC:
+  case NE_FUNC:
+  case LT_FUNC:
+  case LE_FUNC:
+  case GE_FUNC:
+  case GT_FUNC:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+
+/* Result of 'op' for a comparison that gave cmp (<0, 0 or >0) */
+
+static inline bool cmp_result(Item_func::Functype op, int cmp)
+{
+  switch (op) {
+  case Item_func::EQ_FUNC: return cmp == 0;
+  case Item_func::NE_FUNC: return cmp != 0;
+  case Item_func::LT_FUNC: return cmp < 0;
+  case Item_func::LE_FUNC: return cmp <= 0;
+  case Item_func::GE_FUNC: return cmp >= 0;
+  default:		   return cmp > 0;
+  }
+}
+
+
+/*
+  Evaluate the comparison for a batch of rows
+
+  SYNOPSIS
+    val_int_batch()
+    rows		Rows in the record format of the table
+    row_length		Distance between the rows
+    n_rows		Number of rows
+    match		One flag for each row; cleared for the rows where
+			the comparison isn't true
+
+  NOTES
+    Only for comparisons where can_eval_batch() is true.
+    The constant is evaluated once, and the column is read from each
+    row by moving the field to it, instead of calling val_int() for
+    every row.
+*/
+
+void Item_bool_func2::val_int_batch(const byte *rows, uint row_length,
+				    uint n_rows, bool *match)
+{
+  uint field_arg= args[0]->type() == FIELD_ITEM ? 0 : 1;
+  Field *field= ((Item_field*) args[field_arg])->field;
+  Item *value= args[1-field_arg];
+  Functype op= field_arg ? rev_functype() : functype();
+  my_ptrdiff_t diff= (my_ptrdiff_t) (rows - field->table->record[0]);
+  bool *match_end= match+n_rows;
+
+  if (cmp_func == &Item_bool_func2::compare_int)
+  {
+    longlong const_value= value->val_int();
+    if (value->null_value)
+    {
+      bzero((char*) match, n_rows*sizeof(bool));
+      return;
+    }
+    for (; match != match_end ; match++, diff+=row_length)
+    {
+      if (!*match)
+	continue;
+      field->move_field(diff);
+      if (field->is_real_null())
+	*match=0;
+      else
+      {
+	longlong field_value= field->val_int();
+	*match= cmp_result(op, field_value < const_value ? -1 :
+			   field_value == const_value ? 0 : 1);
+      }
+      field->move_field(-diff);
+    }
+  }
+  else
+  {
+    double const_value= value->val();
+    if (value->null_value)
+    {
+      bzero((char*) match, n_rows*sizeof(bool));
+      return;
+    }
+    for (; match != match_end ; match++, diff+=row_length)
+    {
+      if (!*match)
+	continue;
+      field->move_field(diff);
+      if (field->is_real_null())
+	*match=0;
+      else
+      {
+	double field_value= field->val_real();
+	*match= cmp_result(op, field_value < const_value ? -1 :
+			   field_value == const_value ? 0 : 1);
+      }
+      field->move_field(-diff);
+    }
+  }
+}
+
 
 longlong Item_func_eq::val_int()
 {
@@ -48,6 +48,9 @@ public:
   bool have_rev_func() const { return rev_functype() != UNKNOWN_FUNC; }
   void print(String *str) { Item_func::print_op(str); }
   bool is_null() { return test(args[0]->is_null() || args[1]->is_null()); }
+  bool can_eval_batch(TABLE *table);
+  void val_int_batch(const byte *rows, uint row_length, uint n_rows,
+		     bool *match);
   unsigned int size_of() { return sizeof(*this);}  
 };
 
@@ -917,6 +917,27 @@ int dump_leaf(byte* key, uint32 count __attribute__((unused)),
 }
 
 
+/*
+  Check if the keys can be counted in a hash table
+
+  The key of a row is Field::sort_string() of each field, which gives
+  equal bytes for equal values unless the character set uses strcoll()
+*/
+
+static bool hash_distinct_usable(TABLE *table)
+{
+#ifdef USE_STRCOLL
+  if (use_strcoll(default_charset_info))
+  {
+    for (Field **field=table->field ; *field ; field++)
+      if (!(*field)->binary())
+	return 0;
+  }
+#endif
+  return 1;
+}
+
+
 Item_sum_count_distinct::~Item_sum_count_distinct()
 {
   if (table)
@@ -924,6 +945,7 @@ Item_sum_count_distinct::~Item_sum_count_distinct()
   delete tmp_table_param;
   if (use_tree)
     delete_tree(&tree);
+  delete hash;
 }
 
 bool Item_sum_count_distinct::fix_fields(THD *thd,TABLE_LIST *tables)
@@ -958,6 +980,8 @@ bool Item_sum_count_distinct::setup(THD *thd)
     free_tmp_table(thd, table);
     tmp_table_param->cleanup();
   }
+  delete hash;
+  hash=0;
   if (!(table=create_tmp_table(thd, tmp_table_param, list, (ORDER*) 0, 1,
 			       0, 0,
 			       current_lex->select->options | thd->options)))
@@ -975,6 +999,18 @@ bool Item_sum_count_distinct::setup(THD *thd)
     // to make things easier for dump_leaf if we ever have to dump to MyISAM
     restore_record(table,2);
 
+    if (hash_distinct_usable(table))
+    {
+      key_length=0;
+      for (Field **field=table->field ; *field ; field++)
+	key_length+= (*field)->pack_length();
+      if (!(hash_key= (byte*) thd->alloc(key_length+1)) ||
+	  !(hash= new Aggr_hash(key_length, 0,
+				thd->variables.max_heap_table_size)))
+	return 1;
+      return 0;
+    }
+
     if (table->fields == 1)
     {
       /*
@@ -1070,7 +1106,9 @@ int Item_sum_count_distinct::tree_to_myisam()
 
 void Item_sum_count_distinct::reset()
 {
-  if (use_tree)
+  if (hash)
+    hash->unique_reset();
+  else if (use_tree)
     reset_tree(&tree);
   else if (table)
   {
@@ -1093,18 +1131,26 @@ bool Item_sum_count_distinct::add()
     if ((*field)->is_real_null(0))
       return 0;					// Don't count NULL
 
+  if (hash)
+  {
+    byte *to=hash_key;
+    for (Field **field=table->field ; *field ; field++)
+    {
+      uint length=(*field)->pack_length();
+      (*field)->sort_string((char*) to, length);
+      to+=length;
+    }
+    return hash->unique_add(hash_key);
+  }
   if (use_tree)
   {
     /*
-      If the tree got too big, convert to MyISAM, otherwise insert into the
-      tree.
+      If the tree got too big, convert to MyISAM. The row is inserted
+      first, as dump_leaf() overwrites the record.
     */
-    if (tree.elements_in_tree > max_elements_in_tree)
-    {
-      if (tree_to_myisam())
-	return 1;
-    }
-    else if (!tree_insert(&tree, table->record[0] + rec_offset, 0))
+    if (!tree_insert(&tree, table->record[0] + rec_offset, 0))
+      return 1;
+    if (tree.elements_in_tree > max_elements_in_tree && tree_to_myisam())
       return 1;
   }
   else if ((error=table->file->write_row(table->record[0])))
@@ -1124,6 +1170,13 @@ longlong Item_sum_count_distinct::val_int()
 {
   if (!table)					// Empty query
     return LL(0);
+  if (hash)
+  {
+    ulonglong count;
+    if (hash->unique_count(&count))
+      return LL(0);
+    return (longlong) count;
+  }
   if (use_tree)
     return tree.elements_in_tree;
   table->file->info(HA_STATUS_VARIABLE | HA_STATUS_NO_LOCK);
@@ -148,6 +148,7 @@ class Item_sum_count :public Item_sum_int
 
 
 class TMP_TABLE_PARAM;
+class Aggr_hash;
 
 class Item_sum_count_distinct :public Item_sum_int
 {
@@ -174,6 +175,11 @@ class Item_sum_count_distinct :public Item_sum_int
   bool use_tree;
   bool always_null;		// Set to 1 if the result is always NULL
 
+  // If the fields can be compared as bytes after Field::sort_string(),
+  // the keys are counted in a hash table instead of the tree
+  Aggr_hash *hash;
+  byte *hash_key;
+
   int tree_to_myisam();
 
   friend int composite_key_cmp(void* arg, byte* key1, byte* key2);
@@ -183,7 +189,7 @@ class Item_sum_count_distinct :public Item_sum_int
   public:
   Item_sum_count_distinct(List<Item> &list)
     :Item_sum_int(list),table(0),used_table_cache(~(table_map) 0),
-     tmp_table_param(0),use_tree(0),always_null(0)
+     tmp_table_param(0),use_tree(0),always_null(0),hash(0)
   { quick_group=0; }
   ~Item_sum_count_distinct();
 
@@ -74,6 +74,7 @@ static SYMBOL symbols[] = {
   { "BOOL",		SYM(BOOL_SYM),0,0},
   { "BOOLEAN",		SYM(BOOLEAN_SYM),0,0},
   { "BOTH",		SYM(BOTH),0,0},
+  { "BTREE",		SYM(BTREE_SYM),0,0},
   { "BY",		SYM(BY),0,0},
   { "CACHE",		SYM(CACHE_SYM),0,0},
   { "CASCADE",		SYM(CASCADE),0,0},
@@ -167,6 +168,7 @@ static SYMBOL symbols[] = {
   { "GROUP",		SYM(GROUP),0,0},
   { "HAVING",		SYM(HAVING),0,0},
   { "HANDLER",		SYM(HANDLER_SYM),0,0},
+  { "HASH",		SYM(HASH_SYM),0,0},
   { "HEAP",		SYM(HEAP_SYM),0,0},
   { "HIGH_PRIORITY",	SYM(HIGH_PRIORITY),0,0},
   { "HOUR",		SYM(HOUR_SYM),0,0},
@@ -280,6 +282,8 @@ static SYMBOL symbols[] = {
   { "PROCEDURE",	SYM(PROCEDURE),0,0},
   { "PROCESS"	,	SYM(PROCESS),0,0},
   { "PROCESSLIST",	SYM(PROCESSLIST_SYM),0,0},
+  { "PROFILE",		SYM(PROFILE_SYM),0,0},
+  { "PROFILES",		SYM(PROFILES_SYM),0,0},
   { "PRIVILEGES",	SYM(PRIVILEGES),0,0},
   { "QUERY",		SYM(QUERY_SYM),0,0},
   { "QUICK",	        SYM(QUICK),0,0},
@@ -372,6 +376,7 @@ static SYMBOL symbols[] = {
   { "VARBINARY",	SYM(VARBINARY),0,0},
   { "WITH",		SYM(WITH),0,0},
   { "WORK",		SYM(WORK_SYM),0,0},
+  { "WORKERS",		SYM(WORKERS_SYM),0,0},
   { "WRITE",		SYM(WRITE_SYM),0,0},
   { "WHEN",		SYM(WHEN_SYM),0,0},
   { "WHERE",		SYM(WHERE),0,0},
@@ -109,7 +109,7 @@ MYSQL_LOCK *mysql_lock_tables(THD *thd,TABLE **tables,uint count)
       }
     }
 
-    thd->proc_info="System lock";
+    thd->set_proc_info("System lock");
     if (lock_external(thd, tables, count))
     {
       my_free((gptr) sql_lock,MYF(0));
@@ -117,7 +117,7 @@ MYSQL_LOCK *mysql_lock_tables(THD *thd,TABLE **tables,uint count)
       thd->proc_info=0;
       break;
     }
-    thd->proc_info="Table lock";
+    thd->set_proc_info("Table lock");
     thd->locked=1;
     if (thr_multi_lock(sql_lock->locks,sql_lock->lock_count))
     {
@@ -499,7 +499,7 @@ int lock_table_name(THD *thd, TABLE_LIST *table_list)
   for (table=(TABLE*) hash_search(&open_cache,(byte*) key,key_length) ;
        table ;
        table = (TABLE*) hash_next(&open_cache,(byte*) key,key_length))
-    if (table->in_use == thd)
+    if (table->in_use == thd && !table->thread_cached)
       DBUG_RETURN(0);
 
   /*
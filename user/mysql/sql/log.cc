@@ -81,7 +81,10 @@ static int find_uniq_filename(char *name)
 
 
 MYSQL_LOG::MYSQL_LOG()
-  :bytes_written(0), last_time(0), query_start(0), name(0),
+  :commit_seq(0), synced_seq(0), flushed_seq(0), failed_seq_start(0),
+   failed_seq_end(0), group_commit_errno(0), group_commit_leader(0),
+   group_handler_commit(0),
+   bytes_written(0), last_time(0), query_start(0), name(0),
    file_id(1), open_count(1), log_type(LOG_CLOSED), write_error(0), inited(0),
    need_start_event(1)
 {
@@ -113,6 +116,8 @@ void MYSQL_LOG::cleanup()
     (void) pthread_mutex_destroy(&LOCK_log);
     (void) pthread_mutex_destroy(&LOCK_index);
     (void) pthread_cond_destroy(&update_cond);
+    (void) pthread_mutex_destroy(&LOCK_group_commit);
+    (void) pthread_cond_destroy(&COND_group_commit);
   }
 }
 
@@ -157,6 +162,8 @@ void MYSQL_LOG::init_pthread_objects()
   (void) pthread_mutex_init(&LOCK_log,MY_MUTEX_INIT_SLOW);
   (void) pthread_mutex_init(&LOCK_index, MY_MUTEX_INIT_SLOW);
   (void) pthread_cond_init(&update_cond, 0);
+  (void) pthread_mutex_init(&LOCK_group_commit, MY_MUTEX_INIT_FAST);
+  (void) pthread_cond_init(&COND_group_commit, 0);
 }
 
 
@@ -1048,6 +1055,7 @@ bool MYSQL_LOG::write(Log_event* event_info)
   THD *thd=event_info->thd;
   bool called_handler_commit=0;
   bool error=0;
+  ulonglong seq=0;
   DBUG_ENTER("MYSQL_LOG::write(event)");
   
   pthread_mutex_lock(&LOCK_log);
@@ -1194,9 +1202,14 @@ bool MYSQL_LOG::write(Log_event* event_info)
 
     if (file == &log_file) // we are writing to the real log (disk)
     {
+      /*
+        Flush while we hold LOCK_log, so that nobody can read a partial
+        event at the end of the log; only the sync to disk is left to
+        group_commit()
+      */
       if (flush_io_cache(file))
 	goto err;
- 
+
       if (opt_using_transactions && !my_b_tell(&thd->transaction.trans_log))
       {
         /*
@@ -1210,10 +1223,12 @@ bool MYSQL_LOG::write(Log_event* event_info)
             event_info->get_type_code() == EXEC_LOAD_EVENT)
         {
           error = ha_report_binlog_offset_and_commit(thd, log_file_name,
-                                                     file->pos_in_file);
+                                                     my_b_tell(file));
           called_handler_commit=1;
+          group_handler_commit=1;
         }
       }
+      seq= ++commit_seq;
       /* We wrote to the real log, check automatic rotation; */
       DBUG_PRINT("info",("max_size: %lu",max_size));      
       should_rotate= (my_b_tell(file) >= (my_off_t) max_size); 
@@ -1234,6 +1249,8 @@ err:
     if (should_rotate)
     {
       pthread_mutex_lock(&LOCK_index);      
+      if (sync_log(1))
+	write_error=1;
       new_file(0); // inside mutex
       pthread_mutex_unlock(&LOCK_index);
     }
@@ -1242,11 +1259,16 @@ err:
   pthread_mutex_unlock(&LOCK_log);
 
   /*
-    Flush the transactional handler log file now that we have released
-    LOCK_log; the flush is placed here to eliminate the bottleneck on the
-    group commit
+    Sync the binlog and flush the transactional handler log file now that
+    we have released LOCK_log, together with the other threads that have
+    written to the log meanwhile
   */
 
+  if (seq && group_commit(seq))
+  {
+    my_error(ER_ERROR_ON_WRITE, MYF(0), name, group_commit_errno);
+    error=1;
+  }
   if (called_handler_commit)
     ha_commit_complete(thd);
 
@@ -1254,6 +1276,124 @@ err:
 }
 
 
+/*
+  Sync log_file to disk if this is due by sync_binlog
+
+  SYNOPSIS
+    sync_log()
+    force		Sync if sync_binlog is set, even if it is not due
+
+  NOTES
+    Must be called with LOCK_log locked.  log_file is already flushed;
+    the writers flush it before they release LOCK_log.
+    sync_binlog counts transactions (commit_seq), not groups; A group
+    that reaches the count syncs all its transactions at once.
+
+  RETURN
+    0	ok
+    1	Error
+*/
+
+bool MYSQL_LOG::sync_log(bool force)
+{
+  if (sync_binlog_period && commit_seq != synced_seq &&
+      (force || commit_seq - synced_seq >= sync_binlog_period))
+  {
+    synced_seq=commit_seq;
+    if (my_sync(log_file.file, MYF(MY_WME)))
+      return 1;
+  }
+  return 0;
+}
+
+
+/*
+  Wait until a transaction written to the binlog is flushed
+
+  SYNOPSIS
+    group_commit()
+    seq			commit_seq of the transaction
+
+  NOTES
+    Transactions are written to log_file, which is flushed, and committed
+    in the handlers under LOCK_log, but neither log is synced to disk
+    there.  The first thread that comes here when no flush is going on
+    becomes the leader of a group: it syncs log_file once for all
+    transactions written so far, and then flushes the handler logs with
+    ha_group_commit_complete().  Threads that write transactions meanwhile
+    wait for the leader, and one of them leads the next group.
+
+    A failed group extends failed_seq_start..failed_seq_end instead of
+    replacing it, so that a thread of an earlier failed group that wakes
+    up late still gets its error.
+
+  RETURN
+    0	ok
+    1	Flushing the group of the transaction failed
+*/
+
+bool MYSQL_LOG::group_commit(ulonglong seq)
+{
+  ulonglong group_start, group_end;
+  bool error=0, handler_commit;
+  int error_no=0;
+  DBUG_ENTER("MYSQL_LOG::group_commit");
+
+  pthread_mutex_lock(&LOCK_group_commit);
+  while (flushed_seq < seq && group_commit_leader)
+    pthread_cond_wait(&COND_group_commit, &LOCK_group_commit);
+  if (flushed_seq >= seq)
+  {
+    /* Flushed by another thread */
+    error= seq > failed_seq_start && seq <= failed_seq_end;
+    pthread_mutex_unlock(&LOCK_group_commit);
+    DBUG_RETURN(error);
+  }
+  group_commit_leader=1;
+  group_start=flushed_seq;
+  pthread_mutex_unlock(&LOCK_group_commit);
+
+  pthread_mutex_lock(&LOCK_log);
+  group_end=commit_seq;
+  handler_commit=group_handler_commit;
+  group_handler_commit=0;
+  if (is_open())
+  {
+    if (sync_log(0))
+    {
+      error=1;
+      error_no=my_errno;
+      if (!write_error)
+      {
+	write_error=1;
+	sql_print_error(ER(ER_ERROR_ON_WRITE), name, error_no);
+      }
+    }
+  }
+  pthread_mutex_unlock(&LOCK_log);
+
+  if (handler_commit)
+    ha_group_commit_complete();
+
+  pthread_mutex_lock(&LOCK_group_commit);
+  DBUG_PRINT("info",("group: %lu", (ulong) (group_end - group_start)));
+  if (error)
+  {
+    if (failed_seq_start == failed_seq_end)	// No group has failed
+      failed_seq_start=group_start;
+    failed_seq_end=group_end;
+    group_commit_errno=error_no;
+  }
+  flushed_seq=group_end;
+  group_commit_leader=0;
+  binlog_group_commits++;
+  binlog_group_commit_trx+= (ulong) (group_end - group_start);
+  pthread_cond_broadcast(&COND_group_commit);
+  pthread_mutex_unlock(&LOCK_group_commit);
+  DBUG_RETURN(error);
+}
+
+
 uint MYSQL_LOG::next_file_id()
 {
   uint res;
@@ -1289,6 +1429,7 @@ uint MYSQL_LOG::next_file_id()
 
 bool MYSQL_LOG::write(THD *thd, IO_CACHE *cache, bool commit_or_rollback)
 {
+  ulonglong seq=0;
   VOID(pthread_mutex_lock(&LOCK_log));
   DBUG_ENTER("MYSQL_LOG::write(cache");
   
@@ -1355,14 +1496,23 @@ bool MYSQL_LOG::write(THD *thd, IO_CACHE *cache, bool commit_or_rollback)
       write_error=1;				// Don't give more errors
       goto err;
     }
+    /*
+      Commit in the handler while we hold LOCK_log, so that the
+      transactions are in the same order in the handler log as in the
+      binlog.  Both logs are synced later by group_commit().
+    */
     if ((ha_report_binlog_offset_and_commit(thd, log_file_name,
-					    log_file.pos_in_file)))
+					    my_b_tell(&log_file))))
       goto err;
+    group_handler_commit=1;
+    seq= ++commit_seq;
     signal_update();
     DBUG_PRINT("info",("max_size: %lu",max_size));
     if (my_b_tell(&log_file) >= (my_off_t) max_size)
     {
       pthread_mutex_lock(&LOCK_index);
+      if (sync_log(1))
+	goto err_index;
       new_file(0); // inside mutex
       pthread_mutex_unlock(&LOCK_index);
     }
@@ -1370,14 +1520,24 @@ bool MYSQL_LOG::write(THD *thd, IO_CACHE *cache, bool commit_or_rollback)
   }
   VOID(pthread_mutex_unlock(&LOCK_log));
 
-  /* Flush the transactional handler log file now that we have released
-  LOCK_log; the flush is placed here to eliminate the bottleneck on the
-  group commit */  
+  /*
+    Sync the binlog and flush the transactional handler log file now that
+    we have released LOCK_log, together with the other threads that have
+    committed meanwhile
+  */
 
+  if (seq && group_commit(seq))
+  {
+    ha_commit_complete(thd);
+    DBUG_RETURN(1);
+  }
   ha_commit_complete(thd);
 
   DBUG_RETURN(0);
 
+err_index:
+  pthread_mutex_unlock(&LOCK_index);
+
 err:
   if (!write_error)
   {
@@ -218,8 +218,10 @@ int Log_event::exec_event(struct st_relay_log_info* rli)
     Strictly speaking, if we were sure that rli is null
     only in the case discussed above, 'if (rli)' is useless here.
     But as we are not 100% sure, keep it for now.
+    A slave worker does not move the position; the SQL thread moves it
+    when the whole group of events is applied.
   */
-  if (rli)  
+  if (rli && !thd->slave_worker)
   {
     if (rli->inside_transaction)
       rli->inc_pending(get_event_len());
@@ -1779,7 +1781,8 @@ int Query_log_event::exec_event(struct st_relay_log_info* rli)
     position to store is really pos + pending + event_len
     since we must store the pos of the END of the current log event
   */
-  rli->event_len= get_event_len();
+  if (!thd->slave_worker)
+    rli->event_len= get_event_len();
 
   if (db_ok(thd->db, replicate_do_db, replicate_ignore_db))
   {
@@ -1813,10 +1816,14 @@ int Query_log_event::exec_event(struct st_relay_log_info* rli)
 	This will only be done if we are supporting transactional tables
 	in the slave.
       */
-      if (!strcmp(thd->query,"BEGIN"))
-	rli->inside_transaction= opt_using_transactions;
-      else if (!(strcmp(thd->query,"COMMIT") && strcmp(thd->query,"ROLLBACK")))
-	rli->inside_transaction=0;
+      if (!thd->slave_worker)			// Else the SQL thread does it
+      {
+	if (!strcmp(thd->query,"BEGIN"))
+	  rli->inside_transaction= opt_using_transactions;
+	else if (!(strcmp(thd->query,"COMMIT") &&
+		   strcmp(thd->query,"ROLLBACK")))
+	  rli->inside_transaction=0;
+      }
 
       /*
         If we expected a non-zero error code, and we don't get the same error
@@ -1847,8 +1854,11 @@ Default database: '%s'",
 	       ignored_error_code(actual_error))
       {
 	thd->query_error = 0;
-	*rli->last_slave_error = 0;
-	rli->last_slave_errno = 0;
+	if (!thd->slave_worker)
+	{
+	  *rli->last_slave_error = 0;
+	  rli->last_slave_errno = 0;
+	}
       }
       /*
         Other cases: mostly we expected no error and get one.
@@ -2229,7 +2239,8 @@ int Intvar_log_event::exec_event(struct st_relay_log_info* rli)
     thd->next_insert_id = val;
     break;
   }
-  rli->inc_pending(get_event_len());
+  if (!thd->slave_worker)
+    rli->inc_pending(get_event_len());
   return 0;
 }
 
@@ -2237,7 +2248,8 @@ int Rand_log_event::exec_event(struct st_relay_log_info* rli)
 {
   thd->rand.seed1 = (ulong) seed1;
   thd->rand.seed2 = (ulong) seed2;
-  rli->inc_pending(get_event_len());
+  if (!thd->slave_worker)
+    rli->inc_pending(get_event_len());
   return 0;
 }
 
@@ -301,6 +301,7 @@ inline THD *_current_thd(void)
 #include "field.h"				/* Field definitions */
 #include "sql_udf.h"
 #include "item.h"
+#include "sql_profile.h"
 #include "sql_class.h"
 #include "opt_range.h"
 
@@ -345,6 +346,8 @@ int quick_rm_table(enum db_type base,const char *db,
 bool mysql_rename_tables(THD *thd, TABLE_LIST *table_list);
 bool mysql_change_db(THD *thd,const char *name);
 void mysql_parse(THD *thd,char *inBuf,uint length);
+void mysql_init_query(THD *thd);
+void free_items(THD *thd);
 void mysql_init_select(LEX *lex);
 bool mysql_new_select(LEX *lex);
 void mysql_init_multi_delete(LEX *lex);
@@ -357,6 +360,8 @@ void end_thread(THD *thd,bool put_in_cache);
 void flush_thread_cache();
 void mysql_execute_command(void);
 bool do_command(THD *thd);
+bool login_connection(THD *thd);
+void end_connection(THD *thd);
 bool dispatch_command(enum enum_server_command command, THD *thd,
 		      char* packet, uint packet_length);
 #ifndef EMBEDDED_LIBRARY
@@ -412,6 +417,7 @@ bool net_store_data(String* packet, I_List<i_string>* str_list);
 bool net_store_data(String *packet,CONVERT *convert, const char *from,
 		    uint length);
 bool net_store_data(String *packet, CONVERT *convert, const char *from);
+bool net_store_binary_row(THD *thd, String *packet, List<Item> &items);
 
 SORT_FIELD * make_unireg_sortorder(ORDER *order, uint *length);
 int setup_order(THD *thd,TABLE_LIST *tables, List<Item> &fields,
@@ -463,7 +469,8 @@ int mysql_multi_update(THD *thd, TABLE_LIST *table_list,
 		       COND *conds, ulong options,
 		       enum enum_duplicates handle_duplicates);
 int mysql_insert(THD *thd,TABLE_LIST *table,List<Item> &fields,
-		 List<List_item> &values, enum_duplicates flag);
+		 List<List_item> &values, List<INSERT_ROW> &literal_values,
+		 enum_duplicates flag);
 void kill_delayed_threads(void);
 int mysql_delete(THD *thd, TABLE_LIST *table, COND *conds, ORDER *order,
                  ha_rows rows, ulong options);
@@ -533,6 +540,12 @@ int mysql_ha_closeall(THD *thd, TABLE_LIST *tables);
 int mysql_ha_read(THD *, TABLE_LIST *,enum enum_ha_read_modes,char *,
                List<Item> *,enum ha_rkey_function,Item *,ha_rows,ha_rows);
 
+/* sql_prepare.cc */
+void mysql_stmt_prepare(THD *thd, char *packet, uint packet_length);
+void mysql_stmt_execute(THD *thd, char *packet, uint packet_length);
+void mysql_stmt_close(THD *thd, char *packet, uint packet_length);
+void free_prepared_statements(THD *thd);
+
 /* sql_base.cc */
 void set_item_name(Item *item,char *pos,uint length);
 bool add_field_to_list(char *field_name, enum enum_field_types type,
@@ -577,6 +590,7 @@ void free_io_cache(TABLE *entry);
 void intern_close_table(TABLE *entry);
 bool close_thread_table(THD *thd, TABLE **table_ptr);
 void close_thread_tables(THD *thd,bool locked=0);
+void close_cached_thread_tables(THD *thd);
 bool close_thread_table(THD *thd, TABLE **table_ptr);
 void close_temporary_tables(THD *thd);
 TABLE **find_temporary_table(THD *thd, const char *db, const char *table_name);
@@ -592,6 +606,7 @@ bool close_cached_tables(THD *thd, bool wait_for_refresh, TABLE_LIST *tables);
 void copy_field_from_tmp_record(Field *field,int offset);
 int fill_record(List<Item> &fields,List<Item> &values, bool ignore_errors);
 int fill_record(Field **field,List<Item> &values, bool ignore_errors);
+int fill_record(Field **field,INSERT_ROW *row);
 OPEN_TABLE_LIST *list_open_tables(THD *thd, const char *wild);
 
 /* sql_calc.cc */
@@ -670,7 +685,7 @@ extern ulong filesort_rows, filesort_range_count, filesort_scan_count;
 extern ulong filesort_merge_passes;
 extern ulong select_range_check_count, select_range_count, select_scan_count;
 extern ulong select_full_range_join_count,select_full_join_count;
-extern ulong slave_open_temp_tables, query_cache_size;
+extern ulong slave_open_temp_tables, query_cache_size, query_cache_partitions;
 extern ulong thd_startup_options, slow_launch_threads, slow_launch_time;
 extern ulong server_id, concurrency;
 extern ulong ha_read_count, ha_write_count, ha_delete_count, ha_update_count;
@@ -678,14 +693,18 @@ extern ulong ha_read_key_count, ha_read_next_count, ha_read_prev_count;
 extern ulong ha_read_first_count, ha_read_last_count;
 extern ulong ha_read_rnd_count, ha_read_rnd_next_count;
 extern ulong ha_commit_count, ha_rollback_count,table_cache_size;
+extern ulong table_cache_per_thread;
 extern ulong max_connections,max_connect_errors, connect_timeout;
 extern ulong max_insert_delayed_threads, max_user_connections;
 extern ulong long_query_count, what_to_log,flush_time,opt_sql_mode;
 extern ulong query_buff_size, thread_stack,thread_stack_min;
 extern ulong binlog_cache_size, max_binlog_cache_size, open_files_limit;
 extern ulong max_binlog_size, max_relay_log_size;
+extern ulong sync_binlog_period, binlog_group_commits, binlog_group_commit_trx;
 extern ulong rpl_recovery_rank, thread_cache_size;
 extern ulong com_stat[(uint) SQLCOM_END], com_other, back_log;
+extern ulong com_stmt_prepare, com_stmt_execute, com_stmt_close;
+extern ulong prepared_stmt_plan_hits;
 extern ulong specialflag, current_pid;
 
 extern uint test_flags,select_errors,ha_open_options;
@@ -799,6 +818,8 @@ extern "C" void unireg_abort(int exit_code);
 void init_read_record(READ_RECORD *info, THD *thd, TABLE *reg_form,
 		      SQL_SELECT *select,
 		      int use_record_cache, bool print_errors);
+void init_read_record_batch(READ_RECORD *info, byte *buff, bool *match,
+			    uint rows, Item **conds, uint cond_count);
 void end_read_record(READ_RECORD *info);
 ha_rows filesort(TABLE *form,struct st_sort_field *sortorder, uint s_length,
 		 SQL_SELECT *select, ha_rows special,ha_rows max_rows,
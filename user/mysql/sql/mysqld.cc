@@ -22,6 +22,7 @@
 #include "sql_repl.h"
 #include "repl_failsafe.h"
 #include "stacktrace.h"
+#include "scheduler.h"
 #ifdef HAVE_BERKELEY_DB
 #include "ha_berkeley.h"
 #endif
@@ -350,7 +351,7 @@ uint protocol_version=PROTOCOL_VERSION;
 struct system_variables global_system_variables;
 struct system_variables max_system_variables;
 ulonglong keybuff_size;
-ulong table_cache_size,
+ulong table_cache_size, table_cache_per_thread,
       thread_stack,
       thread_stack_min,what_to_log= ~ (1L << (uint) COM_TIME),
       query_buff_size,
@@ -358,9 +359,12 @@ ulong table_cache_size,
       slave_open_temp_tables=0,
       open_files_limit=0, max_binlog_size, max_relay_log_size;
 ulong com_stat[(uint) SQLCOM_END], com_other;
+ulong com_stmt_prepare, com_stmt_execute, com_stmt_close;
+ulong prepared_stmt_plan_hits;
 ulong slave_net_timeout;
 ulong thread_cache_size=0, binlog_cache_size=0, max_binlog_cache_size=0;
-ulong query_cache_size=0;
+ulong sync_binlog_period=0, binlog_group_commits=0, binlog_group_commit_trx=0;
+ulong query_cache_size=0, query_cache_partitions=1;
 #ifdef HAVE_QUERY_CACHE
 ulong query_cache_limit=0;
 Query_cache query_cache;
@@ -633,6 +637,9 @@ static void close_connections(void)
   }
   (void) pthread_mutex_unlock(&LOCK_thread_count); // For unlink from list
 
+  /* Let the scheduler release connections that are waiting for input */
+  thread_scheduler.end();
+
   if (thread_count)
     sleep(1);					// Give threads time to die
 
@@ -2371,6 +2378,20 @@ Now disabling --log-slave-updates.");
     }
   }
   (void) thr_setconcurrency(concurrency);	// 10 by default
+
+  if (thread_handling == SCHEDULER_POOL_OF_THREADS &&
+      !(test_flags & TEST_NO_THREADS))
+  {
+    if (pool_of_threads_scheduler(&thread_scheduler) ||
+	thread_scheduler.init())
+    {
+      sql_print_error("Warning: Can't start pool-of-threads scheduler; \
+Using one-thread-per-connection");
+      thread_handling= SCHEDULER_ONE_THREAD_PER_CONNECTION;
+      thread_handling_str= thread_handling_typelib.type_names[0];
+      one_thread_per_connection_scheduler(&thread_scheduler);
+    }
+  }
 #if defined(__WIN__) && !defined(EMBEDDED_LIBRARY)	  //IRENA
   {
     hEventShutdown=CreateEvent(0, FALSE, FALSE, shutdown_event_name);
@@ -2762,41 +2783,57 @@ static void create_new_thread(THD *thd)
   }
   else
 #endif
+    thread_scheduler.add_connection(thd);
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Give a new connection a thread of its own; either one from the
+  thread cache or a newly created one.
+  This is the add_connection() function of the
+  one-thread-per-connection scheduler.
+
+  LOCK_thread_count is locked on entry and is unlocked on return.
+*/
+
+void create_thread_to_handle_connection(THD *thd)
+{
+  NET *net=&thd->net;
+  DBUG_ENTER("create_thread_to_handle_connection");
+
+  if (cached_thread_count > wake_thread)
   {
-    if (cached_thread_count > wake_thread)
-    {
-      start_cached_thread(thd);
-    }
-    else
+    start_cached_thread(thd);
+  }
+  else
+  {
+    int error;
+    thread_count++;
+    thread_created++;
+    threads.append(thd);
+    DBUG_PRINT("info",(("creating thread %d"), thd->thread_id));
+    thd->connect_time = time(NULL);
+    if ((error=pthread_create(&thd->real_id,&connection_attrib,
+			      handle_one_connection,
+			      (void*) thd)))
     {
-      int error;
-      thread_count++;
-      thread_created++;
-      threads.append(thd);
-      DBUG_PRINT("info",(("creating thread %d"), thd->thread_id));
-      thd->connect_time = time(NULL);
-      if ((error=pthread_create(&thd->real_id,&connection_attrib,
-				handle_one_connection,
-				(void*) thd)))
-      {
-	DBUG_PRINT("error",
-		   ("Can't create thread to handle request (error %d)",
-		    error));
-	thread_count--;
-	thd->killed=1;				// Safety
-	(void) pthread_mutex_unlock(&LOCK_thread_count);
-	statistic_increment(aborted_connects,&LOCK_status);
-	net_printf(net,ER_CANT_CREATE_THREAD,error);
-	(void) pthread_mutex_lock(&LOCK_thread_count);
-	close_connection(net,0,0);
-	delete thd;
-	(void) pthread_mutex_unlock(&LOCK_thread_count);
-	DBUG_VOID_RETURN;
-      }
+      DBUG_PRINT("error",
+		 ("Can't create thread to handle request (error %d)",
+		  error));
+      thread_count--;
+      thd->killed=1;				// Safety
+      (void) pthread_mutex_unlock(&LOCK_thread_count);
+      statistic_increment(aborted_connects,&LOCK_status);
+      net_printf(net,ER_CANT_CREATE_THREAD,error);
+      (void) pthread_mutex_lock(&LOCK_thread_count);
+      close_connection(net,0,0);
+      delete thd;
+      (void) pthread_mutex_unlock(&LOCK_thread_count);
+      DBUG_VOID_RETURN;
     }
-    (void) pthread_mutex_unlock(&LOCK_thread_count);
-
   }
+  (void) pthread_mutex_unlock(&LOCK_thread_count);
   DBUG_PRINT("info",("Thread created"));
   DBUG_VOID_RETURN;
 }
@@ -3182,6 +3219,7 @@ enum options_mysqld {
   OPT_INNODB_FLUSH_LOG_AT_TRX_COMMIT, 
   OPT_INNODB_FLUSH_METHOD, 
   OPT_INNODB_FAST_SHUTDOWN, 
+  OPT_INNODB_USE_NATIVE_AIO,
   OPT_SAFE_SHOW_DB,
   OPT_INNODB_SKIP, OPT_SKIP_SAFEMALLOC,
   OPT_TEMP_POOL, OPT_TX_ISOLATION,
@@ -3199,13 +3237,15 @@ enum options_mysqld {
   OPT_RECKLESS_SLAVE,
   OPT_SSL_SSL, OPT_SSL_KEY, OPT_SSL_CERT, OPT_SSL_CA,
   OPT_SSL_CAPATH, OPT_SSL_CIPHER,
-  OPT_BACK_LOG, OPT_BINLOG_CACHE_SIZE,
+  OPT_BACK_LOG, OPT_BATCHED_KEY_ACCESS, OPT_BINLOG_CACHE_SIZE,
   OPT_CONNECT_TIMEOUT, OPT_DELAYED_INSERT_TIMEOUT,
   OPT_DELAYED_INSERT_LIMIT, OPT_DELAYED_QUEUE_SIZE,
   OPT_FLUSH_TIME, OPT_FT_MIN_WORD_LEN,
   OPT_FT_MAX_WORD_LEN, OPT_FT_MAX_WORD_LEN_FOR_SORT, OPT_FT_STOPWORD_FILE,
   OPT_INTERACTIVE_TIMEOUT, OPT_JOIN_BUFF_SIZE,
-  OPT_KEY_BUFFER_SIZE, OPT_LONG_QUERY_TIME,
+  OPT_KEY_BUFFER_SIZE, OPT_KEY_CACHE_AGE_THRESHOLD,
+  OPT_KEY_CACHE_DIVISION_LIMIT, OPT_KEY_CACHE_PARTITIONS, OPT_LOAD_DATA_THREADS,
+  OPT_LONG_QUERY_TIME,
   OPT_LOWER_CASE_TABLE_NAMES, OPT_MAX_ALLOWED_PACKET,
   OPT_MAX_BINLOG_CACHE_SIZE, OPT_MAX_BINLOG_SIZE,
   OPT_MAX_CONNECTIONS, OPT_MAX_CONNECT_ERRORS,
@@ -3217,14 +3257,17 @@ enum options_mysqld {
   OPT_MYISAM_MAX_SORT_FILE_SIZE, OPT_MYISAM_SORT_BUFFER_SIZE,
   OPT_NET_BUFFER_LENGTH, OPT_NET_RETRY_COUNT,
   OPT_NET_READ_TIMEOUT, OPT_NET_WRITE_TIMEOUT,
-  OPT_OPEN_FILES_LIMIT, 
-  OPT_QUERY_CACHE_LIMIT, OPT_QUERY_CACHE_SIZE,
-  OPT_QUERY_CACHE_TYPE, OPT_RECORD_BUFFER,
+  OPT_OPEN_FILES_LIMIT, OPT_PROFILING, OPT_PROFILING_HISTORY_SIZE,
+  OPT_QUERY_CACHE_LIMIT, OPT_QUERY_CACHE_PARTITIONS, OPT_QUERY_CACHE_SIZE,
+  OPT_QUERY_CACHE_TYPE, OPT_READ_BATCH_ROWS, OPT_RECORD_BUFFER,
   OPT_RECORD_RND_BUFFER, OPT_RELAY_LOG_SPACE_LIMIT,
   OPT_SLAVE_NET_TIMEOUT, OPT_SLAVE_COMPRESSED_PROTOCOL, OPT_SLOW_LAUNCH_TIME,
+  OPT_SLAVE_PARALLEL_WORKERS,
   OPT_READONLY, OPT_DEBUGGING,
-  OPT_SORT_BUFFER, OPT_TABLE_CACHE,
+  OPT_SORT_BUFFER, OPT_SORT_THREADS, OPT_SYNC_BINLOG, OPT_TABLE_CACHE,
+  OPT_TABLE_CACHE_PER_THREAD,
   OPT_THREAD_CONCURRENCY, OPT_THREAD_CACHE_SIZE,
+  OPT_THREAD_HANDLING, OPT_THREAD_POOL_SIZE,
   OPT_TMP_TABLE_SIZE, OPT_THREAD_STACK,
   OPT_WAIT_TIMEOUT, OPT_MYISAM_REPAIR_THREADS,
   OPT_INNODB_MIRRORED_LOG_GROUPS,
@@ -3232,11 +3275,15 @@ enum options_mysqld {
   OPT_INNODB_LOG_FILE_SIZE,
   OPT_INNODB_LOG_BUFFER_SIZE,
   OPT_INNODB_BUFFER_POOL_SIZE,
+  OPT_INNODB_BUFFER_POOL_ZIP_SIZE,
+  OPT_INNODB_BUFFER_POOL_INSTANCES,
+  OPT_INNODB_ADAPTIVE_HASH_INDEX_PARTS,
   OPT_INNODB_ADDITIONAL_MEM_POOL_SIZE,
   OPT_INNODB_FILE_IO_THREADS,
   OPT_INNODB_LOCK_WAIT_TIMEOUT,
   OPT_INNODB_THREAD_CONCURRENCY,
   OPT_INNODB_FORCE_RECOVERY,
+  OPT_INNODB_RECOVERY_THREADS,
   OPT_INNODB_MAX_DIRTY_PAGES_PCT,
   OPT_BDB_CACHE_SIZE,
   OPT_BDB_LOG_BUFFER_SIZE,
@@ -3394,6 +3441,10 @@ struct my_option my_long_options[] =
   {"innodb_fast_shutdown", OPT_INNODB_FAST_SHUTDOWN,
    "Speeds up server shutdown process", (gptr*) &innobase_fast_shutdown,
    (gptr*) &innobase_fast_shutdown, 0, GET_BOOL, OPT_ARG, 1, 0, 0, 0, 0, 0},
+  {"innodb_use_native_aio", OPT_INNODB_USE_NATIVE_AIO,
+   "Use the Linux native asynchronous I/O for the InnoDB data and log files, if the kernel supports it. Disable with --skip-innodb-use-native-aio to use the simulated asynchronous I/O",
+   (gptr*) &innobase_use_native_aio, (gptr*) &innobase_use_native_aio, 0,
+   GET_BOOL, NO_ARG, 1, 0, 0, 0, 0, 0},
   {"innodb_max_dirty_pages_pct", OPT_INNODB_MAX_DIRTY_PAGES_PCT,
    "Percentage of dirty pages allowed in bufferpool", (gptr*) &srv_max_buf_pool_modified_pct,
    (gptr*) &srv_max_buf_pool_modified_pct, 0, GET_ULONG, REQUIRED_ARG, 90, 0, 100, 0, 0, 0},
@@ -3741,6 +3792,11 @@ replicating a LOAD DATA INFILE command",
    (gptr*) &berkeley_max_lock, (gptr*) &berkeley_max_lock, 0, GET_ULONG,
    REQUIRED_ARG, 10000, 0, (long) ~0, 0, 1, 0},
 #endif /* HAVE_BERKELEY_DB */
+  {"batched_key_access", OPT_BATCHED_KEY_ACCESS,
+   "Join tables read by key (ref and eq_ref) in batches of the join buffer. The keys of a batch are sorted and the rows are read in data file order. Changes the order of rows returned without ORDER BY.",
+   (gptr*) &global_system_variables.batched_key_access,
+   (gptr*) &max_system_variables.batched_key_access,
+   0, GET_BOOL, OPT_ARG, 0, 0, 0, 0, 0, 0},
   {"binlog_cache_size", OPT_BINLOG_CACHE_SIZE,
    "The size of the cache to hold the SQL statements for the binary log during a transaction. If you often use big, multi-statement transactions you can increase this to get more performance.",
    (gptr*) &binlog_cache_size, (gptr*) &binlog_cache_size, 0, GET_ULONG,
@@ -3803,6 +3859,21 @@ replicating a LOAD DATA INFILE command",
    "The size of the memory buffer InnoDB uses to cache data and indexes of its tables.",
    (gptr*) &innobase_buffer_pool_size, (gptr*) &innobase_buffer_pool_size, 0,
    GET_LONG, REQUIRED_ARG, 8*1024*1024L, 1024*1024L, ~0L, 0, 1024*1024L, 0},
+  {"innodb_buffer_pool_zip_size", OPT_INNODB_BUFFER_POOL_ZIP_SIZE,
+   "The size of the memory InnoDB uses to keep zlib compressed copies of pages replaced in the buffer pool. Reading such a page uncompresses the copy instead of reading the page from disk. 0 disables the compressed page cache.",
+   (gptr*) &innobase_buffer_pool_zip_size,
+   (gptr*) &innobase_buffer_pool_zip_size, 0,
+   GET_LONG, REQUIRED_ARG, 0, 0, ~0L, 0, 1024*1024L, 0},
+  {"innodb_buffer_pool_instances", OPT_INNODB_BUFFER_POOL_INSTANCES,
+   "The number of parts the InnoDB buffer pool is split into. Each part has its own mutex, LRU list and flush list, which reduces contention when many threads access the buffer pool. A part gets at least 256 pages; the number is reduced for a small buffer pool.",
+   (gptr*) &innobase_buffer_pool_instances,
+   (gptr*) &innobase_buffer_pool_instances, 0,
+   GET_LONG, REQUIRED_ARG, 1, 1, 64, 0, 1, 0},
+  {"innodb_adaptive_hash_index_parts", OPT_INNODB_ADAPTIVE_HASH_INDEX_PARTS,
+   "The number of parts the InnoDB adaptive hash index is split into. The indexes are spread over the parts by their id, and each part has its own latch, so that searches and page modifications in different indexes do not wait for each other.",
+   (gptr*) &innobase_adaptive_hash_index_parts,
+   (gptr*) &innobase_adaptive_hash_index_parts, 0,
+   GET_LONG, REQUIRED_ARG, 8, 1, 64, 0, 1, 0},
   {"innodb_additional_mem_pool_size", OPT_INNODB_ADDITIONAL_MEM_POOL_SIZE,
    "Size of a memory pool InnoDB uses to store data dictionary information and other internal data structures.",
    (gptr*) &innobase_additional_mem_pool_size,
@@ -3824,6 +3895,10 @@ replicating a LOAD DATA INFILE command",
    "Helps to save your data in case the disk image of the database becomes corrupt.",
    (gptr*) &innobase_force_recovery, (gptr*) &innobase_force_recovery, 0,
    GET_LONG, REQUIRED_ARG, 0, 0, 6, 0, 1, 0},
+  {"innodb_recovery_threads", OPT_INNODB_RECOVERY_THREADS,
+   "Number of threads which apply the log records to the data pages in InnoDB crash recovery.",
+   (gptr*) &innobase_recovery_threads, (gptr*) &innobase_recovery_threads, 0,
+   GET_LONG, REQUIRED_ARG, 4, 1, 64, 0, 1, 0},
 #endif /* HAVE_INNOBASE_DB */
   {"interactive_timeout", OPT_INTERACTIVE_TIMEOUT,
    "The number of seconds the server waits for activity on an interactive connection before closing it.",
@@ -3841,6 +3916,23 @@ replicating a LOAD DATA INFILE command",
    (gptr*) &keybuff_size, (gptr*) &keybuff_size, 0, GET_ULL,
    REQUIRED_ARG, KEY_CACHE_SIZE, MALLOC_OVERHEAD, (long) ~0, MALLOC_OVERHEAD,
    IO_SIZE, 0},
+  {"key_cache_age_threshold", OPT_KEY_CACHE_AGE_THRESHOLD,
+   "Move a hot block in the key buffer to the warm part if it has not been used during a number of key requests that is key_cache_age_threshold percent of the number of blocks in the buffer.",
+   (gptr*) &key_cache_age_threshold, (gptr*) &key_cache_age_threshold, 0,
+   GET_UINT, REQUIRED_ARG, 300, 100, INT_MAX32, 0, 100, 0},
+  {"key_cache_division_limit", OPT_KEY_CACHE_DIVISION_LIMIT,
+   "The minimum percentage of warm blocks in the key buffer. New blocks are read into the warm part; 100 gives a plain LRU buffer.",
+   (gptr*) &key_cache_division_limit, (gptr*) &key_cache_division_limit, 0,
+   GET_UINT, REQUIRED_ARG, 100, 1, 100, 0, 1, 0},
+  {"key_cache_partitions", OPT_KEY_CACHE_PARTITIONS,
+   "Number of independently locked partitions of the key buffer. More partitions lets more threads access index blocks at the same time.",
+   (gptr*) &key_cache_partitions, (gptr*) &key_cache_partitions, 0, GET_UINT,
+   REQUIRED_ARG, 1, 1, MAX_KEY_CACHE_PARTITIONS, 0, 1, 0},
+  {"load_data_threads", OPT_LOAD_DATA_THREADS,
+   "Number of threads to use to parse the lines of LOAD DATA INFILE with FIELDS TERMINATED BY and no ENCLOSED BY. The value of 1 disables parallel parsing.",
+   (gptr*) &global_system_variables.load_data_threads,
+   (gptr*) &max_system_variables.load_data_threads, 0, GET_ULONG, REQUIRED_ARG,
+   1, 1, MAX_LOAD_THREADS, 0, 1, 0},
   {"long_query_time", OPT_LONG_QUERY_TIME,
    "Log all queries that have taken more than long_query_time seconds to execute to file.",
    (gptr*) &global_system_variables.long_query_time,
@@ -3946,7 +4038,7 @@ this value; if zero (the default): when the size exceeds max_binlog_size. \
    GET_ULL, REQUIRED_ARG, (longlong) LONG_MAX, 0, (ulonglong) MAX_FILE_SIZE,
    0, 1024*1024, 0},
   {"myisam_repair_threads", OPT_MYISAM_REPAIR_THREADS,
-   "Number of threads to use when repairing MyISAM tables. The value of 1 disables parallel repair.",
+   "Number of threads to use when repairing MyISAM tables or creating their keys with a sort. If there are more threads than keys, the sorting of each key is split between the threads. The value of 1 disables parallel repair.",
    (gptr*) &global_system_variables.myisam_repair_threads,
    (gptr*) &max_system_variables.myisam_repair_threads, 0,
    GET_ULONG, REQUIRED_ARG, 1, 1, ~0L, 0, 1, 0},
@@ -3979,6 +4071,16 @@ this value; if zero (the default): when the size exceeds max_binlog_size. \
    "If this is not 0, then mysqld will use this value to reserve file descriptors to use with setrlimit(). If this value is 0 then mysqld will reserve max_connections*5 or max_connections + table_cache*2 (whichever is larger) number of files.",
    (gptr*) &open_files_limit, (gptr*) &open_files_limit, 0, GET_ULONG,
    REQUIRED_ARG, 0, 0, 65535, 0, 1, 0},
+  {"profiling", OPT_PROFILING,
+   "Keep a profile of the stages of each statement for SHOW PROFILE and SHOW PROFILES.",
+   (gptr*) &global_system_variables.profiling,
+   (gptr*) &max_system_variables.profiling,
+   0, GET_BOOL, OPT_ARG, 0, 0, 0, 0, 0, 0},
+  {"profiling_history_size", OPT_PROFILING_HISTORY_SIZE,
+   "Number of statements of a connection kept for SHOW PROFILES.",
+   (gptr*) &global_system_variables.profiling_history_size,
+   (gptr*) &max_system_variables.profiling_history_size, 0, GET_ULONG,
+   REQUIRED_ARG, 15, 0, PROFILE_MAX_HISTORY, 0, 1, 0},
   {"query_alloc_block_size", OPT_QUERY_ALLOC_BLOCK_SIZE,
    "Allocation block size for query parsing and execution",
    (gptr*) &global_system_variables.query_alloc_block_size,
@@ -3989,6 +4091,10 @@ this value; if zero (the default): when the size exceeds max_binlog_size. \
    "Don't cache results that are bigger than this.",
    (gptr*) &query_cache_limit, (gptr*) &query_cache_limit, 0, GET_ULONG,
    REQUIRED_ARG, 1024*1024L, 0, (longlong) ULONG_MAX, 0, 1, 0},
+  {"query_cache_partitions", OPT_QUERY_CACHE_PARTITIONS,
+   "Number of independently locked parts the query cache is split in. Fewer are used if a part would get less than 256K.",
+   (gptr*) &query_cache_partitions, (gptr*) &query_cache_partitions, 0,
+   GET_ULONG, REQUIRED_ARG, 1, 1, QUERY_CACHE_MAX_PARTITIONS, 0, 1, 0},
 #endif /*HAVE_QUERY_CACHE*/
   {"query_cache_size", OPT_QUERY_CACHE_SIZE,
    "The memory allocated to store results from old queries.",
@@ -4006,6 +4112,11 @@ this value; if zero (the default): when the size exceeds max_binlog_size. \
    (gptr*) &max_system_variables.query_prealloc_size, 0, GET_ULONG,
    REQUIRED_ARG, QUERY_ALLOC_PREALLOC_SIZE, 1024, ~0L, 0, 1024, 0},
 #endif /*HAVE_QUERY_CACHE*/
+  {"read_batch_rows", OPT_READ_BATCH_ROWS,
+   "Full table scans of MyISAM and HEAP tables in a SELECT read this many rows at a time, and test simple conditions on the batch before the rows are given one by one to the join. 0 or 1 reads one row at a time.",
+   (gptr*) &global_system_variables.read_batch_rows,
+   (gptr*) &max_system_variables.read_batch_rows, 0, GET_ULONG, REQUIRED_ARG,
+   64, 0, 4096, 0, 1, 0},
   {"read_buffer_size", OPT_RECORD_BUFFER,
    "Each thread that does a sequential scan allocates a buffer of this size for each table it scans. If you do many sequential scans, you may want to increase this value.",
    (gptr*) &global_system_variables.read_buff_size,
@@ -4036,6 +4147,10 @@ this value; if zero (the default): when the size exceeds max_binlog_size. \
    "Number of seconds to wait for more data from a master/slave connection before aborting the read.",
    (gptr*) &slave_net_timeout, (gptr*) &slave_net_timeout, 0,
    GET_ULONG, REQUIRED_ARG, SLAVE_NET_TIMEOUT, 1, LONG_TIMEOUT, 0, 1, 0},
+  {"slave_parallel_workers", OPT_SLAVE_PARALLEL_WORKERS,
+   "Number of threads that apply the events of different databases in parallel on a slave. 0 applies all events in the slave SQL thread. Read when the slave SQL thread starts.",
+   (gptr*) &slave_parallel_workers, (gptr*) &slave_parallel_workers, 0,
+   GET_ULONG, REQUIRED_ARG, 0, 0, SLAVE_MAX_WORKERS, 0, 1, 0},
   {"range_alloc_block_size", OPT_RANGE_ALLOC_BLOCK_SIZE,
    "Allocation block size for storing ranges during optimization",
    (gptr*) &global_system_variables.range_alloc_block_size,
@@ -4056,10 +4171,23 @@ this value; if zero (the default): when the size exceeds max_binlog_size. \
    (gptr*) &max_system_variables.sortbuff_size, 0, GET_ULONG, REQUIRED_ARG,
    MAX_SORT_MEMORY, MIN_SORT_MEMORY+MALLOC_OVERHEAD*2, ~0L, MALLOC_OVERHEAD,
    1, 0},
+  {"sort_threads", OPT_SORT_THREADS,
+   "Number of threads to use to sort and merge the rows of a big ORDER BY or GROUP BY. The value of 1 disables parallel sorting.",
+   (gptr*) &global_system_variables.sort_threads,
+   (gptr*) &max_system_variables.sort_threads, 0, GET_ULONG, REQUIRED_ARG,
+   1, 1, MAX_SORT_THREADS, 0, 1, 0},
+  {"sync_binlog", OPT_SYNC_BINLOG,
+   "Sync the binary log to disk when # transactions have been written to it since the last sync. The sync is done when a group commit flushes the log, so one sync may cover more transactions. 0 (the default) leaves the syncing to the operating system.",
+   (gptr*) &sync_binlog_period, (gptr*) &sync_binlog_period, 0, GET_ULONG,
+   REQUIRED_ARG, 0, 0, ~0L, 0, 1, 0},
   {"table_cache", OPT_TABLE_CACHE,
    "The number of open tables for all threads.", (gptr*) &table_cache_size,
    (gptr*) &table_cache_size, 0, GET_ULONG, REQUIRED_ARG, 64, 1, 16384, 0, 1,
    0},
+  {"table_cache_per_thread", OPT_TABLE_CACHE_PER_THREAD,
+   "The number of tables a thread keeps open between statements. These tables are opened again without locking the table cache, and are not freed to keep the table cache within table_cache. 0 disables the per thread cache.",
+   (gptr*) &table_cache_per_thread, (gptr*) &table_cache_per_thread, 0,
+   GET_ULONG, REQUIRED_ARG, 8, 0, 1024, 0, 1, 0},
   {"thread_concurrency", OPT_THREAD_CONCURRENCY,
    "Permits the application to give the threads system a hint for the desired number of threads that should be run at the same time.",
    (gptr*) &concurrency, (gptr*) &concurrency, 0, GET_ULONG, REQUIRED_ARG,
@@ -4073,6 +4201,13 @@ this value; if zero (the default): when the size exceeds max_binlog_size. \
    (gptr*) &global_system_variables.tmp_table_size,
    (gptr*) &max_system_variables.tmp_table_size, 0, GET_ULONG,
    REQUIRED_ARG, 32*1024*1024L, 1024, ~0L, 0, 1, 0},
+  {"thread_handling", OPT_THREAD_HANDLING,
+   "How connections are mapped to threads; One of: one-thread-per-connection, pool-of-threads.",
+   0, 0, 0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"thread_pool_size", OPT_THREAD_POOL_SIZE,
+   "Number of worker threads used by --thread-handling=pool-of-threads.",
+   (gptr*) &thread_pool_size, (gptr*) &thread_pool_size, 0, GET_ULONG,
+   REQUIRED_ARG, POOL_DEFAULT_SIZE, 1, POOL_MAX_SIZE, 0, 1, 0},
   {"thread_stack", OPT_THREAD_STACK,
    "The stack size for each thread.", (gptr*) &thread_stack,
    (gptr*) &thread_stack, 0, GET_ULONG, REQUIRED_ARG,DEFAULT_THREAD_STACK,
@@ -4104,6 +4239,9 @@ this value; if zero (the default): when the size exceeds max_binlog_size. \
 struct show_var_st status_vars[]= {
   {"Aborted_clients",          (char*) &aborted_threads,        SHOW_LONG},
   {"Aborted_connects",         (char*) &aborted_connects,       SHOW_LONG},
+  {"Binlog_group_commits",     (char*) &binlog_group_commits,   SHOW_LONG},
+  {"Binlog_group_commit_trx",  (char*) &binlog_group_commit_trx, SHOW_LONG},
+  {"Binlog_group_commit_avg_size", (char*) 0,                   SHOW_BINLOG_GROUP_SIZE},
   {"Bytes_received",           (char*) &bytes_received,         SHOW_LONG},
   {"Bytes_sent",               (char*) &bytes_sent,             SHOW_LONG},
   {"Com_admin_commands",       (char*) &com_other,		SHOW_LONG},
@@ -4162,14 +4300,20 @@ struct show_var_st status_vars[]= {
   {"Com_show_new_master",      (char*) (com_stat+(uint) SQLCOM_SHOW_NEW_MASTER),SHOW_LONG},
   {"Com_show_open_tables",     (char*) (com_stat+(uint) SQLCOM_SHOW_OPEN_TABLES),SHOW_LONG},
   {"Com_show_processlist",     (char*) (com_stat+(uint) SQLCOM_SHOW_PROCESSLIST),SHOW_LONG},
+  {"Com_show_profile",	       (char*) (com_stat+(uint) SQLCOM_SHOW_PROFILE),SHOW_LONG},
+  {"Com_show_profiles",	       (char*) (com_stat+(uint) SQLCOM_SHOW_PROFILES),SHOW_LONG},
   {"Com_show_slave_hosts",     (char*) (com_stat+(uint) SQLCOM_SHOW_SLAVE_HOSTS),SHOW_LONG},
   {"Com_show_slave_status",    (char*) (com_stat+(uint) SQLCOM_SHOW_SLAVE_STAT),SHOW_LONG},
+  {"Com_show_slave_workers",   (char*) (com_stat+(uint) SQLCOM_SHOW_SLAVE_WORKERS),SHOW_LONG},
   {"Com_show_status",	       (char*) (com_stat+(uint) SQLCOM_SHOW_STATUS),SHOW_LONG},
   {"Com_show_innodb_status",   (char*) (com_stat+(uint) SQLCOM_SHOW_INNODB_STATUS),SHOW_LONG},
   {"Com_show_tables",	       (char*) (com_stat+(uint) SQLCOM_SHOW_TABLES),SHOW_LONG},
   {"Com_show_variables",       (char*) (com_stat+(uint) SQLCOM_SHOW_VARIABLES),SHOW_LONG},
   {"Com_slave_start",	       (char*) (com_stat+(uint) SQLCOM_SLAVE_START),SHOW_LONG},
   {"Com_slave_stop",	       (char*) (com_stat+(uint) SQLCOM_SLAVE_STOP),SHOW_LONG},
+  {"Com_stmt_close",	       (char*) &com_stmt_close,		SHOW_LONG},
+  {"Com_stmt_execute",	       (char*) &com_stmt_execute,	SHOW_LONG},
+  {"Com_stmt_prepare",	       (char*) &com_stmt_prepare,	SHOW_LONG},
   {"Com_truncate",	       (char*) (com_stat+(uint) SQLCOM_TRUNCATE),SHOW_LONG},
   {"Com_unlock_tables",	       (char*) (com_stat+(uint) SQLCOM_UNLOCK_TABLES),SHOW_LONG},
   {"Com_update",	       (char*) (com_stat+(uint) SQLCOM_UPDATE),SHOW_LONG},
@@ -4193,6 +4337,7 @@ struct show_var_st status_vars[]= {
   {"Handler_update",           (char*) &ha_update_count,        SHOW_LONG},
   {"Handler_write",            (char*) &ha_write_count,         SHOW_LONG},
   {"Key_blocks_used",          (char*) &_my_blocks_used,        SHOW_LONG_CONST},
+  {"Key_cache_part",           NullS,                           SHOW_KEY_CACHE_PARTS},
   {"Key_read_requests",        (char*) &_my_cache_r_requests,   SHOW_LONG},
   {"Key_reads",                (char*) &_my_cache_read,         SHOW_LONG},
   {"Key_write_requests",       (char*) &_my_cache_w_requests,   SHOW_LONG},
@@ -4204,12 +4349,14 @@ struct show_var_st status_vars[]= {
   {"Open_files",               (char*) &my_file_opened,         SHOW_LONG_CONST},
   {"Open_streams",             (char*) &my_stream_opened,       SHOW_LONG_CONST},
   {"Opened_tables",            (char*) &opened_tables,          SHOW_LONG},
+  {"Prepared_stmt_plan_hits",  (char*) &prepared_stmt_plan_hits, SHOW_LONG},
   {"Questions",                (char*) 0,                       SHOW_QUESTION},
 #ifdef HAVE_QUERY_CACHE
   {"Qcache_queries_in_cache",  (char*) &query_cache.queries_in_cache, SHOW_LONG_CONST},
   {"Qcache_inserts",           (char*) &query_cache.inserts,    SHOW_LONG},
   {"Qcache_hits",              (char*) &query_cache.hits,       SHOW_LONG},
   {"Qcache_lowmem_prunes",     (char*) &query_cache.lowmem_prunes, SHOW_LONG},
+  {"Qcache_lock_waits",        (char*) &query_cache.lock_waits, SHOW_LONG},
   {"Qcache_not_cached",        (char*) &query_cache.refused,    SHOW_LONG},
   {"Qcache_free_memory",       (char*) &query_cache.free_memory, 
    SHOW_LONG_CONST},
@@ -4263,6 +4410,11 @@ struct show_var_st status_vars[]= {
   {"Threads_created",	       (char*) &thread_created,		SHOW_LONG_CONST},
   {"Threads_connected",        (char*) &thread_count,           SHOW_INT_CONST},
   {"Threads_running",          (char*) &thread_running,         SHOW_INT_CONST},
+  {"Threadpool_idle_threads",  (char*) &pool_idle_threads,      SHOW_LONG_CONST},
+  {"Threadpool_queue_depth",   (char*) &pool_queue_depth,       SHOW_LONG_CONST},
+  {"Threadpool_queue_max",     (char*) &pool_queue_max,         SHOW_LONG_CONST},
+  {"Threadpool_queued_events", (char*) &pool_queued_events,     SHOW_LONG},
+  {"Threadpool_wait_time",     (char*) &pool_wait_time,         SHOW_LONGLONG},
   {"Uptime",                   (char*) 0,                       SHOW_STARTTIME},
   {NullS, NullS, SHOW_LONG}
 };
@@ -4327,6 +4479,8 @@ static void set_options(void)
   (void) strmake(mysql_real_data_home, get_relative_path(DATADIR),
 		 sizeof(mysql_real_data_home)-1);
 
+  one_thread_per_connection_scheduler(&thread_scheduler);
+
   /* Set default values for some variables */
   global_system_variables.table_type=DB_TYPE_MYISAM;
   global_system_variables.tx_isolation=ISO_REPEATABLE_READ;
@@ -4713,6 +4867,18 @@ get_one_option(int optid, const struct my_option *opt __attribute__((unused)),
     strmake(mysql_charsets_dir, argument, sizeof(mysql_charsets_dir)-1);
     charsets_dir = mysql_charsets_dir;
     break;
+  case OPT_THREAD_HANDLING:
+  {
+    int type;
+    if ((type=find_type(argument, &thread_handling_typelib, 2)) <= 0)
+    {
+      fprintf(stderr,"Unknown thread handling type: %s\n",argument);
+      exit(1);
+    }
+    thread_handling= (ulong) (type-1);
+    thread_handling_str= thread_handling_typelib.type_names[type-1];
+    break;
+  }
   case OPT_TX_ISOLATION:
   {
     int type;
@@ -384,6 +384,118 @@ net_store_data(String *packet, CONVERT *convert, const char *from)
   return net_store_data(packet,from,length);
 }
 
+
+/*
+  Store a row in the binary format used for the result of COM_EXECUTE
+
+  SYNOPSIS
+    net_store_binary_row()
+    thd			Thread handler. thd->binary_row_types has the type
+			of each column, as sent by send_fields()
+    packet		The row is stored here
+    items		Columns of the row
+
+  NOTES
+    The row starts with a 0 byte and a bitmap with one bit set for each
+    column that is NULL. The 0 byte doesn't tell the row from a text row,
+    where an empty first column also starts with a 0 length; Binary rows
+    are sent only while thd->binary_rows is set for COM_EXECUTE, and the
+    client reads them as such because it sent the COM_EXECUTE.
+    The non NULL columns follow. Integer and floating point columns are
+    stored in binary, low byte first: TINY as 1 byte, SHORT and YEAR as
+    2, INT24 and LONG as 4 and LONGLONG as 8 bytes, FLOAT and DOUBLE
+    as 4 and 8 byte IEEE values. Other columns are stored as in the
+    text format.
+
+  RETURN
+    0  ok
+    1  Out of memory
+*/
+
+bool net_store_binary_row(THD *thd, String *packet, List<Item> &items)
+{
+  List_iterator_fast<Item> it(items);
+  uchar *types= thd->binary_row_types;
+  uint column,length;
+  Item *item;
+  DBUG_ENTER("net_store_binary_row");
+
+  packet->length(0);
+  if (packet->fill(1+(items.elements+7)/8,0))
+    DBUG_RETURN(1);
+  for (column=0 ; (item=it++) ; column++)
+  {
+    char *pos;
+    bool null_value;
+    length=packet->length();
+    if (packet->realloc(length+8))
+      DBUG_RETURN(1);
+    pos=(char*) packet->ptr()+length;
+    switch ((enum enum_field_types) types[column]) {
+    case FIELD_TYPE_TINY:
+      pos[0]=(char) item->val_int();
+      length++;
+      break;
+    case FIELD_TYPE_SHORT:
+    case FIELD_TYPE_YEAR:
+    {
+      longlong nr=item->val_int();
+      int2store(pos,(uint) nr);
+      length+=2;
+      break;
+    }
+    case FIELD_TYPE_INT24:
+    case FIELD_TYPE_LONG:
+    {
+      longlong nr=item->val_int();
+      int4store(pos,(uint32) nr);
+      length+=4;
+      break;
+    }
+    case FIELD_TYPE_LONGLONG:
+    {
+      longlong nr=item->val_int();
+      int8store(pos,nr);
+      length+=8;
+      break;
+    }
+    case FIELD_TYPE_FLOAT:
+    {
+      float nr=(float) item->val();
+      float4store(pos,nr);
+      length+=4;
+      break;
+    }
+    case FIELD_TYPE_DOUBLE:
+    {
+      double nr=item->val();
+      float8store(pos,nr);
+      length+=8;
+      break;
+    }
+    default:
+      if (item->send(thd,packet))
+	DBUG_RETURN(1);
+      /* send() stores a NULL as the single byte 251 */
+      null_value= (packet->length() == length+1 &&
+		   (uchar) packet->ptr()[length] == 251);
+      if (!null_value)
+	continue;
+      packet->length(length);
+      goto store_null;
+    }
+    if (!item->null_value)
+    {
+      packet->length(length);
+      continue;
+    }
+store_null:
+    ((char*) packet->ptr())[1+column/8]|= (char) (1 << (column & 7));
+  }
+  DBUG_RETURN(0);
+}
+
+
 /*
   Function called by my_net_init() to set some check variables
 */
@@ -21,6 +21,7 @@
 
 static int rr_quick(READ_RECORD *info);
 static int rr_sequential(READ_RECORD *info);
+static int rr_sequential_batch(READ_RECORD *info);
 static int rr_from_tempfile(READ_RECORD *info);
 static int rr_from_pointers(READ_RECORD *info);
 static int rr_from_cache(READ_RECORD *info);
@@ -111,6 +112,45 @@ void init_read_record(READ_RECORD *info,THD *thd, TABLE *table,
 } /* init_read_record */
 
 
+/*
+  Read a table scan in batches of rows
+
+  SYNOPSIS
+    init_read_record_batch()
+    info		Initialized by init_read_record()
+    buff		Buffer for rows records of table->reclength
+    match		Buffer for rows flags
+    rows		Number of rows in a batch
+    conds		Comparisons for which can_eval_batch() is true
+    cond_count		Number of conds
+
+  NOTES
+    Only changes info if init_read_record() chose rr_sequential().
+    The conds are evaluated on the whole batch with val_int_batch(), and
+    only the rows where all are true are returned. The conds must be
+    ANDed to the condition the caller tests for the rows, as they are
+    only a filter. As the handler is positioned on the last row of the
+    batch, this can't be used if the caller needs position().
+*/
+
+void init_read_record_batch(READ_RECORD *info, byte *buff, bool *match,
+			    uint rows, Item **conds, uint cond_count)
+{
+  if (info->read_record != rr_sequential)
+    return;
+  DBUG_PRINT("info",("using rr_sequential_batch"));
+  info->read_record=rr_sequential_batch;
+  info->reclength=info->table->reclength;
+  info->batch_buff=buff;
+  info->batch_match=match;
+  info->batch_rows=rows;
+  info->batch_conds=conds;
+  info->batch_cond_count=cond_count;
+  info->batch_count=info->batch_next=0;
+  info->batch_error=0;
+}
+
+
 void end_read_record(READ_RECORD *info)
 {					/* free cache if used */
   if (info->cache)
@@ -175,6 +215,54 @@ static int rr_sequential(READ_RECORD *info)
 }
 
 
+static int rr_sequential_batch(READ_RECORD *info)
+{
+  int tmp;
+  for (;;)
+  {
+    while (info->batch_next < info->batch_count)
+    {
+      uint i=info->batch_next++;
+      if (info->batch_match[i])
+      {
+	memcpy(info->record,info->batch_buff+i*info->reclength,
+	       info->reclength);
+	info->table->status=0;
+	return 0;
+      }
+    }
+    if ((tmp=info->batch_error))
+    {
+      if (tmp == HA_ERR_END_OF_FILE)
+      {
+	info->table->status=STATUS_NOT_FOUND;
+	return -1;
+      }
+      if (info->print_error)
+	info->table->file->print_error(tmp,MYF(0));
+      if (tmp < 0)				// Fix negative BDB errno
+	tmp=1;
+      return tmp;
+    }
+    if (info->thd->killed)
+    {
+      my_error(ER_SERVER_SHUTDOWN,MYF(0));
+      return 1;
+    }
+    info->batch_error=info->file->rnd_next_batch(info->batch_buff,
+						 info->reclength,
+						 info->batch_rows,
+						 &info->batch_count);
+    info->batch_next=0;
+    memset((char*) info->batch_match,1,info->batch_count*sizeof(bool));
+    for (uint i=0 ; i < info->batch_cond_count ; i++)
+      ((Item_bool_func2*) info->batch_conds[i])->
+	val_int_batch(info->batch_buff,info->reclength,info->batch_count,
+		      info->batch_match);
+  }
+}
+
+
 static int rr_from_tempfile(READ_RECORD *info)
 {
   int tmp;
@@ -0,0 +1,502 @@
+/* Copyright (C) 2004 MySQL AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Connection schedulers
+
+  one-thread-per-connection:
+    The classic model; every connection gets a thread of its own
+    (see create_thread_to_handle_connection() in mysqld.cc).
+
+  pool-of-threads:
+    thread_pool_size worker threads serve all connections. A connection
+    that waits for its next command is not bound to any thread; its
+    socket is registered (EPOLLONESHOT) in an epoll set that is watched
+    by a single listener thread. When a packet arrives the listener
+    puts the THD in a FIFO queue and one of the workers runs exactly one
+    do_command() for it, after which the socket is re-armed.
+
+    Idle connections are checked for wait_timeout and for KILL by the
+    listener every POOL_REAP_INTERVAL seconds, or at once when
+    post_kill_notification() wakes it up through a pipe.
+
+  Locking order: LOCK_thread_count, LOCK_pool, thd->LOCK_delete
+*/
+
+#include "mysql_priv.h"
+#include "scheduler.h"
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
+static const char *thread_handling_names[]=
+{ "one-thread-per-connection", "pool-of-threads", NullS};
+
+TYPELIB thread_handling_typelib=
+{ array_elements(thread_handling_names)-1, "", thread_handling_names};
+
+scheduler_functions thread_scheduler;
+const char *thread_handling_str= "one-thread-per-connection";
+ulong thread_handling= SCHEDULER_ONE_THREAD_PER_CONNECTION;
+ulong thread_pool_size= POOL_DEFAULT_SIZE;
+
+/* Status variables; Only used by pool-of-threads */
+ulong pool_idle_threads, pool_queue_depth, pool_queue_max;
+ulong pool_queued_events;
+ulonglong pool_wait_time;			// In microseconds
+
+
+/*****************************************************************************
+  One thread per connection
+*****************************************************************************/
+
+static bool init_dummy(void) { return 0; }
+static void post_kill_dummy(THD *thd __attribute__((unused))) {}
+static void end_dummy(void) {}
+
+void one_thread_per_connection_scheduler(scheduler_functions *func)
+{
+  func->init= init_dummy;
+  func->add_connection= create_thread_to_handle_connection;
+  func->post_kill_notification= post_kill_dummy;
+  func->end= end_dummy;
+}
+
+
+/*****************************************************************************
+  Pool of threads
+*****************************************************************************/
+
+#ifdef HAVE_SYS_EPOLL_H
+
+#define POOL_MAX_EVENTS		64
+#define POOL_REAP_INTERVAL	5		// Seconds
+
+static pthread_mutex_t LOCK_pool;
+static pthread_cond_t COND_pool;
+static THD *pool_queue_first, **pool_queue_last= &pool_queue_first;
+static int pool_epoll_fd= -1, pool_wakeup_pipe[2]= {-1, -1};
+static bool volatile pool_abort, pool_kill_pending;
+
+extern "C" pthread_handler_decl(pool_listener, arg);
+extern "C" pthread_handler_decl(pool_worker, arg);
+
+
+/* Add a connection to the work queue. LOCK_pool is locked */
+
+static void pool_enqueue(THD *thd)
+{
+  thd->scheduler_next= 0;
+  thd->scheduler_queue_time= my_getsystime();
+  *pool_queue_last= thd;
+  pool_queue_last= &thd->scheduler_next;
+  if (++pool_queue_depth > pool_queue_max)
+    pool_queue_max= pool_queue_depth;
+  pool_queued_events++;
+  pthread_cond_signal(&COND_pool);
+}
+
+
+/* Take the oldest connection from the work queue. LOCK_pool is locked */
+
+static THD *pool_dequeue()
+{
+  THD *thd;
+  if ((thd= pool_queue_first))
+  {
+    if (!(pool_queue_first= thd->scheduler_next))
+      pool_queue_last= &pool_queue_first;
+    pool_queue_depth--;
+    pool_wait_time+= (my_getsystime() - thd->scheduler_queue_time) / 10;
+  }
+  return thd;
+}
+
+
+static void pool_wake_listener()
+{
+  char c= 0;
+  (void) write(pool_wakeup_pipe[1], &c, 1);
+}
+
+
+/*
+  Take an idle connection out of the poll set.
+  LOCK_pool is locked; The connection is not in the queue
+*/
+
+static void pool_unpark(THD *thd)
+{
+  pthread_mutex_lock(&thd->LOCK_delete);
+  thd->scheduler_idle= 0;
+  pthread_mutex_unlock(&thd->LOCK_delete);
+}
+
+
+/*
+  Make a connection wait for its next command in the poll set
+
+  RETURN
+    0	ok; thd now belongs to the listener
+    1	connection should be closed
+*/
+
+static bool pool_park(THD *thd)
+{
+  struct epoll_event ev;
+  st_my_thread_var *thread_var= thd->mysys_var;
+
+  pthread_mutex_lock(&LOCK_pool);
+  pthread_mutex_lock(&thd->LOCK_delete);
+  if (pool_abort || thd->killed)
+  {
+    pthread_mutex_unlock(&thd->LOCK_delete);
+    pthread_mutex_unlock(&LOCK_pool);
+    return 1;
+  }
+  /* The worker's thread variables must not follow the connection */
+  thread_var->abort= 0;
+  thd->mysys_var= 0;
+  thd->scheduler_idle= 1;
+  pthread_mutex_unlock(&thd->LOCK_delete);
+  thd->scheduler_idle_since= time((time_t*) 0);
+
+  ev.events= EPOLLIN | EPOLLONESHOT;
+  ev.data.ptr= (void*) thd;
+  if (epoll_ctl(pool_epoll_fd,
+		thd->scheduler_in_poll ? EPOLL_CTL_MOD : EPOLL_CTL_ADD,
+		vio_fd(thd->net.vio), &ev))
+  {
+    pool_unpark(thd);
+    thd->mysys_var= thread_var;
+    pthread_mutex_unlock(&LOCK_pool);
+    return 1;
+  }
+  thd->scheduler_in_poll= 1;
+  pthread_mutex_unlock(&LOCK_pool);
+  return 0;
+}
+
+
+/*
+  Give idle connections that are killed, have been idle for longer
+  than wait_timeout or (on shutdown) all idle connections to the
+  workers, which will close them.
+
+  On shutdown pool_abort is set under the same lock, so no connection
+  can park after the idle ones are queued.
+*/
+
+static void pool_reap_idle(bool all)
+{
+  THD *thd;
+  time_t now= time((time_t*) 0);
+
+  (void) pthread_mutex_lock(&LOCK_thread_count);
+  pthread_mutex_lock(&LOCK_pool);
+  I_List_iterator<THD> it(threads);
+  while ((thd=it++))
+  {
+    if (!thd->scheduler_idle)
+      continue;
+    if (!all && !thd->killed &&
+	(ulong) (now - thd->scheduler_idle_since) <
+	thd->variables.net_wait_timeout)
+      continue;
+    (void) epoll_ctl(pool_epoll_fd, EPOLL_CTL_DEL, vio_fd(thd->net.vio), 0);
+    thd->scheduler_in_poll= 0;
+    thd->killed= 1;
+    pool_unpark(thd);
+    pool_enqueue(thd);
+  }
+  if (all)
+  {
+    pool_abort= 1;				// No more parking
+    pthread_cond_broadcast(&COND_pool);
+  }
+  pthread_mutex_unlock(&LOCK_pool);
+  (void) pthread_mutex_unlock(&LOCK_thread_count);
+}
+
+
+/* Free a connection that is handled by a worker thread */
+
+static void pool_end_thread(THD *thd)
+{
+  thd->cleanup();
+  (void) pthread_mutex_lock(&LOCK_thread_count);
+  thread_count--;
+  delete thd;
+  (void) pthread_mutex_unlock(&LOCK_thread_count);
+  /* It's safe to broadcast outside a lock (COND... is not deleted here) */
+  (void) pthread_cond_broadcast(&COND_thread_count);
+}
+
+
+/* Run the login or one command for a connection */
+
+static void pool_process(THD *thd)
+{
+  NET *net= &thd->net;
+  bool end= 0;
+
+  thd->real_id= pthread_self();
+  thd->thread_stack= (char*) &thd;
+  if (thd->store_globals())
+  {
+    close_connection(net, ER_OUT_OF_RESOURCES);
+    statistic_increment(aborted_connects, &LOCK_status);
+    pool_end_thread(thd);
+    return;
+  }
+
+  if (!thd->scheduler_logged_in)
+  {
+#if !defined(__WIN__) && !defined(OS2) && !defined(__NETWARE__)
+    sigset_t set;
+    VOID(sigemptyset(&set));			// Get mask in use
+    VOID(pthread_sigmask(SIG_UNBLOCK, &set, &thd->block_signals));
+#endif
+    if (login_connection(thd))
+    {
+      close_connection(net);
+      pool_end_thread(thd);
+      return;
+    }
+    thd->scheduler_logged_in= 1;
+  }
+  else if (thd->killed)
+    end= 1;
+  else
+    end= do_command(thd);
+
+  if (!end && !net->error && net->vio != 0 && !thd->killed)
+  {
+    /* Compressed packets may already have the next command buffered */
+    if (net->compress && net->remain_in_buf)
+    {
+      pthread_mutex_lock(&LOCK_pool);
+      pool_enqueue(thd);
+      pthread_mutex_unlock(&LOCK_pool);
+      return;
+    }
+    if (!pool_park(thd))
+      return;
+  }
+  end_connection(thd);
+  close_connection(net);
+  pool_end_thread(thd);
+}
+
+
+extern "C" pthread_handler_decl(pool_worker, arg __attribute__((unused)))
+{
+  THD *thd;
+
+  my_thread_init();
+  pthread_detach_this_thread();
+
+  pthread_mutex_lock(&LOCK_pool);
+  for (;;)
+  {
+    /* On shutdown, exit only when the queue is empty */
+    while (!(thd= pool_dequeue()) && !pool_abort)
+    {
+      pool_idle_threads++;
+      pthread_cond_wait(&COND_pool, &LOCK_pool);
+      pool_idle_threads--;
+    }
+    if (!thd)
+      break;
+    pthread_mutex_unlock(&LOCK_pool);
+    pool_process(thd);
+    /* thd may be freed by another worker from now on */
+    (void) my_pthread_setspecific_ptr(THR_THD, 0);
+    (void) my_pthread_setspecific_ptr(THR_MALLOC, 0);
+    pthread_mutex_lock(&LOCK_pool);
+  }
+  pthread_mutex_unlock(&LOCK_pool);
+  my_thread_end();
+  pthread_exit(0);
+  return 0;					// Never reached
+}
+
+
+extern "C" pthread_handler_decl(pool_listener, arg __attribute__((unused)))
+{
+  struct epoll_event events[POOL_MAX_EVENTS];
+  time_t next_reap= time((time_t*) 0) + POOL_REAP_INTERVAL;
+
+  my_thread_init();
+  pthread_detach_this_thread();
+
+  for (;;)
+  {
+    int i, count;
+    count= epoll_wait(pool_epoll_fd, events, POOL_MAX_EVENTS,
+		      POOL_REAP_INTERVAL*1000);
+    if (count < 0)
+    {
+      if (errno != EINTR)
+	sql_print_error("Error %d from epoll_wait() in pool-of-threads",
+			errno);
+      count= 0;
+    }
+    pthread_mutex_lock(&LOCK_pool);
+    if (pool_abort)
+    {
+      pthread_mutex_unlock(&LOCK_pool);
+      break;
+    }
+    for (i= 0 ; i < count ; i++)
+    {
+      THD *thd= (THD*) events[i].data.ptr;
+      if (!thd)
+      {
+	char buff[16];
+	while (read(pool_wakeup_pipe[0], buff, sizeof(buff)) > 0) ;
+	continue;
+      }
+      if (thd->scheduler_idle)
+      {
+	pool_unpark(thd);
+	pool_enqueue(thd);
+      }
+    }
+    pthread_mutex_unlock(&LOCK_pool);
+
+    if (pool_kill_pending || time((time_t*) 0) >= next_reap)
+    {
+      pool_kill_pending= 0;
+      pool_reap_idle(0);
+      next_reap= time((time_t*) 0) + POOL_REAP_INTERVAL;
+    }
+  }
+  my_thread_end();
+  pthread_exit(0);
+  return 0;					// Never reached
+}
+
+
+static bool pool_init(void)
+{
+  struct epoll_event ev;
+  pthread_t tmp;
+  uint i;
+  DBUG_ENTER("pool_init");
+
+  if ((pool_epoll_fd= epoll_create(POOL_MAX_EVENTS)) < 0)
+    DBUG_RETURN(1);
+  if (pipe(pool_wakeup_pipe))
+  {
+    (void) close(pool_epoll_fd);
+    DBUG_RETURN(1);
+  }
+  (void) fcntl(pool_wakeup_pipe[0], F_SETFL, O_NONBLOCK);
+  (void) fcntl(pool_wakeup_pipe[1], F_SETFL, O_NONBLOCK);
+  ev.events= EPOLLIN;
+  ev.data.ptr= 0;
+  if (epoll_ctl(pool_epoll_fd, EPOLL_CTL_ADD, pool_wakeup_pipe[0], &ev))
+    goto err;
+
+  (void) pthread_mutex_init(&LOCK_pool, MY_MUTEX_INIT_FAST);
+  (void) pthread_cond_init(&COND_pool, NULL);
+
+  if (pthread_create(&tmp, &connection_attrib, pool_listener, 0))
+    goto err;
+  for (i= 0 ; i < thread_pool_size ; i++)
+  {
+    if (pthread_create(&tmp, &connection_attrib, pool_worker, 0))
+    {
+      if (i)
+      {
+	sql_print_error("Warning: Could only create %u of %lu pool threads",
+			i, thread_pool_size);
+	break;
+      }
+      pool_abort= 1;
+      pool_wake_listener();
+      DBUG_RETURN(1);
+    }
+  }
+  DBUG_RETURN(0);
+
+err:
+  (void) close(pool_wakeup_pipe[0]);
+  (void) close(pool_wakeup_pipe[1]);
+  (void) close(pool_epoll_fd);
+  DBUG_RETURN(1);
+}
+
+
+/* LOCK_thread_count is locked on entry and is unlocked on return */
+
+static void pool_add_connection(THD *thd)
+{
+  thread_count++;
+  threads.append(thd);
+  thd->connect_time= time(NULL);
+  (void) pthread_mutex_unlock(&LOCK_thread_count);
+
+  pthread_mutex_lock(&LOCK_pool);
+  pool_enqueue(thd);
+  pthread_mutex_unlock(&LOCK_pool);
+}
+
+
+static void pool_post_kill_notification(THD *thd __attribute__((unused)))
+{
+  pool_kill_pending= 1;
+  pool_wake_listener();
+}
+
+
+/*
+  Server shutdown. Hand all idle connections to the workers, which close
+  them, and let the listener and the workers exit when the queue is empty.
+*/
+
+static void pool_end(void)
+{
+  DBUG_ENTER("pool_end");
+  pool_reap_idle(1);
+  pool_wake_listener();
+  DBUG_VOID_RETURN;
+}
+
+#endif /* HAVE_SYS_EPOLL_H */
+
+
+/*
+  Set up the pool-of-threads scheduler
+
+  RETURN
+    0	ok
+    1	pool-of-threads is not supported on this platform
+*/
+
+bool pool_of_threads_scheduler(scheduler_functions *func)
+{
+#ifdef HAVE_SYS_EPOLL_H
+  func->init= pool_init;
+  func->add_connection= pool_add_connection;
+  func->post_kill_notification= pool_post_kill_notification;
+  func->end= pool_end;
+  return 0;
+#else
+  return 1;
+#endif
+}
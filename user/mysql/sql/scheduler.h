@@ -0,0 +1,62 @@
+/* Copyright (C) 2004 MySQL AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Connection scheduler
+
+  Decides which OS thread runs the commands of a client connection.
+  The classic scheduler gives every connection its own thread (reused
+  through thread_cache). The pool-of-threads scheduler keeps a fixed
+  set of worker threads and only hands a connection to a worker when
+  a packet from the client is ready to be read.
+*/
+
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+enum enum_thread_handling
+{
+  SCHEDULER_ONE_THREAD_PER_CONNECTION=0, SCHEDULER_POOL_OF_THREADS
+};
+
+struct scheduler_functions
+{
+  /* Called once at startup; Returns 1 if the scheduler can't be used */
+  bool (*init)(void);
+  /* Start handling a new connection. LOCK_thread_count is locked */
+  void (*add_connection)(THD *thd);
+  /* thd was killed; called with thd->LOCK_delete locked */
+  void (*post_kill_notification)(THD *thd);
+  /* Server shutdown; all threads have been marked as killed */
+  void (*end)(void);
+};
+
+#define POOL_DEFAULT_SIZE		16
+#define POOL_MAX_SIZE			1024
+
+extern scheduler_functions thread_scheduler;
+extern TYPELIB thread_handling_typelib;
+extern const char *thread_handling_str;
+extern ulong thread_handling, thread_pool_size;
+extern ulong pool_idle_threads, pool_queue_depth, pool_queue_max;
+extern ulong pool_queued_events;
+extern ulonglong pool_wait_time;
+
+void one_thread_per_connection_scheduler(scheduler_functions *func);
+bool pool_of_threads_scheduler(scheduler_functions *func);
+void create_thread_to_handle_connection(THD *thd);
+
+#endif /* _SCHEDULER_H */
@@ -46,6 +46,7 @@
 #include "mysql_priv.h"
 #include "slave.h"
 #include "sql_acl.h"
+#include "scheduler.h"
 #include <my_getopt.h>
 #include <thr_alarm.h>
 #include <myisam.h>
@@ -96,6 +97,8 @@ static void fix_max_connections(THD *thd, enum_var_type type);
   alphabetic order
 */
 
+sys_var_thd_bool	sys_batched_key_access("batched_key_access",
+					       &SV::batched_key_access);
 sys_var_long_ptr	sys_binlog_cache_size("binlog_cache_size",
 					      &binlog_cache_size);
 sys_var_thd_ulong	sys_bulk_insert_buff_size("bulk_insert_buffer_size",
@@ -128,6 +131,8 @@ sys_var_thd_ulong	sys_join_buffer_size("join_buffer_size",
 sys_var_ulonglong_ptr	sys_key_buffer_size("key_buffer_size",
 					    &keybuff_size,
 					    fix_key_buffer_size);
+sys_var_thd_ulong	sys_load_data_threads("load_data_threads",
+					      &SV::load_data_threads);
 sys_var_bool_ptr	sys_local_infile("local_infile",
 					 &opt_local_infile);
 sys_var_thd_bool	sys_log_warnings("log_warnings", &SV::log_warnings);
@@ -195,6 +200,11 @@ sys_var_thd_ulong	sys_net_retry_count("net_retry_count",
 					    &SV::net_retry_count,
 					    fix_net_retry_count);
 sys_var_thd_bool	sys_new_mode("new", &SV::new_mode);
+sys_var_thd_bool	sys_profiling("profiling", &SV::profiling);
+sys_var_thd_ulong	sys_profiling_history_size("profiling_history_size",
+						   &SV::profiling_history_size);
+sys_var_thd_ulong	sys_read_batch_rows("read_batch_rows",
+					    &SV::read_batch_rows);
 sys_var_thd_ulong	sys_read_buff_size("read_buffer_size",
 					   &SV::read_buff_size);
 sys_var_bool_ptr	sys_readonly("read_only", &opt_readonly);
@@ -229,14 +239,22 @@ sys_var_bool_ptr	sys_slave_compressed_protocol("slave_compressed_protocol",
 						      &opt_slave_compressed_protocol);
 sys_var_long_ptr	sys_slave_net_timeout("slave_net_timeout",
 					      &slave_net_timeout);
+sys_var_long_ptr	sys_slave_parallel_workers("slave_parallel_workers",
+						   &slave_parallel_workers);
 sys_var_long_ptr	sys_slow_launch_time("slow_launch_time",
 					     &slow_launch_time);
 sys_var_thd_ulong	sys_sort_buffer("sort_buffer_size",
 					&SV::sortbuff_size);
+sys_var_thd_ulong	sys_sort_threads("sort_threads",
+					 &SV::sort_threads);
 sys_var_thd_enum	sys_table_type("table_type", &SV::table_type,
 				       &ha_table_typelib);
+sys_var_long_ptr	sys_sync_binlog_period("sync_binlog",
+					       &sync_binlog_period);
 sys_var_long_ptr	sys_table_cache_size("table_cache",
 					     &table_cache_size);
+sys_var_long_ptr	sys_table_cache_per_thread("table_cache_per_thread",
+						   &table_cache_per_thread);
 sys_var_long_ptr	sys_thread_cache_size("thread_cache_size",
 					      &thread_cache_size);
 sys_var_thd_enum	sys_tx_isolation("tx_isolation",
@@ -335,6 +353,7 @@ sys_var *sys_variables[]=
 {
   &sys_auto_is_null,
   &sys_autocommit,
+  &sys_batched_key_access,
   &sys_big_tables,
   &sys_big_selects,
   &sys_binlog_cache_size,
@@ -357,6 +376,7 @@ sys_var *sys_variables[]=
   &sys_join_buffer_size,
   &sys_key_buffer_size,
   &sys_last_insert_id,
+  &sys_load_data_threads,
   &sys_local_infile,
   &sys_log_binlog,
   &sys_log_off,
@@ -388,6 +408,8 @@ sys_var *sys_variables[]=
   &sys_net_wait_timeout,
   &sys_net_write_timeout,
   &sys_new_mode,
+  &sys_profiling,
+  &sys_profiling_history_size,
   &sys_query_alloc_block_size,
   &sys_query_cache_size,
   &sys_query_prealloc_size,
@@ -399,6 +421,7 @@ sys_var *sys_variables[]=
   &sys_rand_seed1,
   &sys_rand_seed2,
   &sys_range_alloc_block_size,
+  &sys_read_batch_rows,
   &sys_read_buff_size,
   &sys_read_rnd_buff_size,
   &sys_rpl_recovery_rank,
@@ -407,15 +430,19 @@ sys_var *sys_variables[]=
   &sys_server_id,
   &sys_slave_compressed_protocol,
   &sys_slave_net_timeout,
+  &sys_slave_parallel_workers,
   &sys_slave_skip_counter,
   &sys_readonly,
   &sys_slow_launch_time,
   &sys_sort_buffer,
+  &sys_sort_threads,
   &sys_sql_big_tables,
   &sys_sql_low_priority_updates,
   &sys_sql_max_join_size,
   &sys_sql_warnings,
+  &sys_sync_binlog_period,
   &sys_table_cache_size,
+  &sys_table_cache_per_thread,
   &sys_table_type,
   &sys_thread_cache_size,
   &sys_timestamp,
@@ -447,6 +474,7 @@ struct show_var_st init_vars[]= {
   {"bdb_tmpdir",              (char*) &berkeley_tmpdir,             SHOW_CHAR_PTR},
   {"bdb_version",             (char*) DB_VERSION_STRING,            SHOW_CHAR},
 #endif
+  {sys_batched_key_access.name,(char*) &sys_batched_key_access,     SHOW_SYS},
   {sys_binlog_cache_size.name,(char*) &sys_binlog_cache_size,	    SHOW_SYS},
   {sys_bulk_insert_buff_size.name,(char*) &sys_bulk_insert_buff_size,SHOW_SYS},
   {sys_charset.name, 	      (char*) &sys_charset,		     SHOW_SYS},
@@ -477,15 +505,20 @@ struct show_var_st init_vars[]= {
   {"have_query_cache",        (char*) &have_query_cache,            SHOW_HAVE},
   {"init_file",               (char*) &opt_init_file,               SHOW_CHAR_PTR},
 #ifdef HAVE_INNOBASE_DB
+  {"innodb_adaptive_hash_index_parts", (char*) &innobase_adaptive_hash_index_parts, SHOW_LONG },
   {"innodb_additional_mem_pool_size", (char*) &innobase_additional_mem_pool_size, SHOW_LONG },
+  {"innodb_buffer_pool_instances", (char*) &innobase_buffer_pool_instances, SHOW_LONG },
   {"innodb_buffer_pool_size", (char*) &innobase_buffer_pool_size, SHOW_LONG },
+  {"innodb_buffer_pool_zip_size", (char*) &innobase_buffer_pool_zip_size, SHOW_LONG },
   {"innodb_data_file_path", (char*) &innobase_data_file_path,	    SHOW_CHAR_PTR},
   {"innodb_data_home_dir",  (char*) &innobase_data_home_dir,	    SHOW_CHAR_PTR},
   {"innodb_file_io_threads", (char*) &innobase_file_io_threads, SHOW_LONG },
   {"innodb_force_recovery", (char*) &innobase_force_recovery, SHOW_LONG },
+  {"innodb_recovery_threads", (char*) &innobase_recovery_threads, SHOW_LONG },
   {"innodb_thread_concurrency", (char*) &innobase_thread_concurrency, SHOW_LONG },
   {"innodb_flush_log_at_trx_commit", (char*) &innobase_flush_log_at_trx_commit, SHOW_INT},
   {"innodb_fast_shutdown", (char*) &innobase_fast_shutdown, SHOW_MY_BOOL},
+  {"innodb_use_native_aio", (char*) &innobase_use_native_aio, SHOW_MY_BOOL},
   {"innodb_flush_method",    (char*) &innobase_unix_file_flush_method, SHOW_CHAR_PTR},
   {"innodb_lock_wait_timeout", (char*) &innobase_lock_wait_timeout, SHOW_LONG },
   {"innodb_log_arch_dir",   (char*) &innobase_log_arch_dir, 	    SHOW_CHAR_PTR},
@@ -500,8 +533,12 @@ struct show_var_st init_vars[]= {
   {sys_interactive_timeout.name,(char*) &sys_interactive_timeout,   SHOW_SYS},
   {sys_join_buffer_size.name,   (char*) &sys_join_buffer_size,	    SHOW_SYS},
   {sys_key_buffer_size.name,	(char*) &sys_key_buffer_size,	    SHOW_SYS},
+  {"key_cache_age_threshold", (char*) &key_cache_age_threshold,     SHOW_INT},
+  {"key_cache_division_limit",(char*) &key_cache_division_limit,    SHOW_INT},
+  {"key_cache_partitions",    (char*) &key_cache_partitions,        SHOW_INT},
   {"language",                language,                             SHOW_CHAR},
   {"large_files_support",     (char*) &opt_large_files,             SHOW_BOOL},	
+  {sys_load_data_threads.name,(char*) &sys_load_data_threads,	    SHOW_SYS},
   {sys_local_infile.name,     (char*) &sys_local_infile,	    SHOW_SYS},
 #ifdef HAVE_MLOCKALL
   {"locked_in_memory",	      (char*) &locked_in_memory,	    SHOW_BOOL},
@@ -550,23 +587,29 @@ struct show_var_st init_vars[]= {
   {"pid_file",                (char*) pidfile_name,                 SHOW_CHAR},
   {"log_error",               (char*) log_error_file,               SHOW_CHAR},
   {"port",                    (char*) &mysql_port,                  SHOW_INT},
+  {sys_profiling.name,        (char*) &sys_profiling,               SHOW_SYS},
+  {sys_profiling_history_size.name, (char*) &sys_profiling_history_size,
+   SHOW_SYS},
   {"protocol_version",        (char*) &protocol_version,            SHOW_INT},
   {sys_query_alloc_block_size.name, (char*) &sys_query_alloc_block_size,
    SHOW_SYS},
 #ifdef HAVE_QUERY_CACHE
   {sys_query_cache_limit.name,(char*) &sys_query_cache_limit,	    SHOW_SYS},
+  {"query_cache_partitions",  (char*) &query_cache_partitions,      SHOW_LONG},
   {sys_query_cache_size.name, (char*) &sys_query_cache_size,	    SHOW_SYS},
   {sys_query_cache_type.name, (char*) &sys_query_cache_type,        SHOW_SYS},
 #endif /* HAVE_QUERY_CACHE */
   {sys_query_prealloc_size.name, (char*) &sys_query_prealloc_size,  SHOW_SYS},
   {sys_range_alloc_block_size.name, (char*) &sys_range_alloc_block_size,
    SHOW_SYS},
+  {sys_read_batch_rows.name,  (char*) &sys_read_batch_rows,	    SHOW_SYS},
   {sys_read_buff_size.name,   (char*) &sys_read_buff_size,	    SHOW_SYS},
   {sys_readonly.name,         (char*) &sys_readonly,                SHOW_SYS},
   {sys_read_rnd_buff_size.name,(char*) &sys_read_rnd_buff_size,	    SHOW_SYS},
   {sys_rpl_recovery_rank.name,(char*) &sys_rpl_recovery_rank,       SHOW_SYS},
   {sys_server_id.name,	      (char*) &sys_server_id,		    SHOW_SYS},
   {sys_slave_net_timeout.name,(char*) &sys_slave_net_timeout,	    SHOW_SYS},
+  {sys_slave_parallel_workers.name,(char*) &sys_slave_parallel_workers, SHOW_SYS},
   {"skip_external_locking",   (char*) &my_disable_locking,          SHOW_MY_BOOL},
   {"skip_networking",         (char*) &opt_disable_networking,      SHOW_BOOL},
   {"skip_show_database",      (char*) &opt_skip_show_db,            SHOW_BOOL},
@@ -575,12 +618,19 @@ struct show_var_st init_vars[]= {
   {"socket",                  (char*) &mysql_unix_port,             SHOW_CHAR_PTR},
 #endif
   {sys_sort_buffer.name,      (char*) &sys_sort_buffer, 	    SHOW_SYS},
+  {sys_sort_threads.name,     (char*) &sys_sort_threads,	    SHOW_SYS},
   {"sql_mode",                (char*) &opt_sql_mode,                SHOW_LONG},
+  {sys_sync_binlog_period.name,(char*) &sys_sync_binlog_period,     SHOW_SYS},
   {"table_cache",             (char*) &table_cache_size,            SHOW_LONG},
+  {sys_table_cache_per_thread.name,(char*) &sys_table_cache_per_thread, SHOW_SYS},
   {sys_table_type.name,	      (char*) &sys_table_type,	            SHOW_SYS},
   {sys_thread_cache_size.name,(char*) &sys_thread_cache_size,       SHOW_SYS},
 #ifdef HAVE_THR_SETCONCURRENCY
   {"thread_concurrency",      (char*) &concurrency,                 SHOW_LONG},
+#endif
+#ifndef EMBEDDED_LIBRARY
+  {"thread_handling",         (char*) &thread_handling_str,         SHOW_CHAR_PTR},
+  {"thread_pool_size",        (char*) &thread_pool_size,            SHOW_LONG},
 #endif
   {"thread_stack",            (char*) &thread_stack,                SHOW_LONG},
   {sys_tx_isolation.name,     (char*) &sys_tx_isolation,	    SHOW_SYS},
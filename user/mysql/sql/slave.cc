@@ -52,6 +52,7 @@ ulonglong relay_log_space_limit = 0;
 int disconnect_slave_event_count = 0, abort_slave_event_count = 0;
 int events_till_abort = -1;
 static int events_till_disconnect = -1;
+ulong slave_parallel_workers = 0;
 
 typedef enum { SLAVE_THD_IO, SLAVE_THD_SQL} SLAVE_THD_TYPE;
 
@@ -74,6 +75,12 @@ static int request_table_dump(MYSQL* mysql, const char* db, const char* table);
 static int create_table_from_dump(THD* thd, NET* net, const char* db,
 				  const char* table_name, bool overwrite);
 static int check_master_version(MYSQL* mysql, MASTER_INFO* mi);
+static int apply_relay_log_event(THD* thd, RELAY_LOG_INFO* rli, Log_event* ev);
+static int dispatch_relay_log_event(THD* thd, RELAY_LOG_INFO* rli,
+				    Log_event* ev);
+static int wait_for_slave_workers(THD* thd, RELAY_LOG_INFO* rli);
+static int start_slave_workers(RELAY_LOG_INFO* rli);
+static void stop_slave_workers(THD* thd, RELAY_LOG_INFO* rli);
 
 
 /*
@@ -1765,6 +1772,56 @@ int show_master_info(THD* thd, MASTER_INFO* mi)
   DBUG_RETURN(0);
 }
 
+/*
+  SHOW SLAVE WORKERS: one row per worker of a parallel slave
+*/
+
+int show_slave_workers(THD* thd, MASTER_INFO* mi)
+{
+  RELAY_LOG_INFO *rli= &mi->rli;
+  String *packet= &thd->packet;
+  time_t now= time((time_t*) 0);
+  DBUG_ENTER("show_slave_workers");
+  List<Item> field_list;
+  field_list.push_back(new Item_empty_string("Worker", 4));
+  field_list.push_back(new Item_empty_string("Thread_id", 12));
+  field_list.push_back(new Item_empty_string("State", 20));
+  field_list.push_back(new Item_empty_string("Db", NAME_LEN));
+  field_list.push_back(new Item_empty_string("Queued_groups", 12));
+  field_list.push_back(new Item_empty_string("Applied_groups", 12));
+  field_list.push_back(new Item_empty_string("Master_log_pos", 12));
+  field_list.push_back(new Item_empty_string("Seconds_behind_master", 12));
+  if (send_fields(thd, field_list, 1))
+    DBUG_RETURN(-1);
+
+  pthread_mutex_lock(&rli->worker_lock);
+  for (uint i= 0 ; i < rli->n_workers ; i++)
+  {
+    SLAVE_WORKER *worker= rli->workers + i;
+    SLAVE_GROUP *oldest= worker->current ? worker->current : worker->first;
+    long lag= oldest && oldest->when ? (long) (now - oldest->when) : 0;
+    packet->length(0);
+    net_store_data(packet, (uint32) worker->id);
+    net_store_data(packet, (uint32) (worker->thd ? worker->thd->thread_id :
+				     0));
+    net_store_data(packet, (worker->current ? "Applying" :
+			    worker->running ? "Waiting" : "Stopped"));
+    net_store_data(packet, oldest ? oldest->db : "");
+    net_store_data(packet, (uint32) worker->queued);
+    net_store_data(packet, (longlong) worker->groups_applied);
+    net_store_data(packet, (longlong) worker->last_master_log_pos);
+    net_store_data(packet, (uint32) max(lag, 0));
+    if (my_net_write(&thd->net, (char*) packet->ptr(), packet->length()))
+    {
+      pthread_mutex_unlock(&rli->worker_lock);
+      DBUG_RETURN(-1);
+    }
+  }
+  pthread_mutex_unlock(&rli->worker_lock);
+  send_eof(&thd->net);
+  DBUG_RETURN(0);
+}
+
 
 bool flush_master_info(MASTER_INFO* mi)
 {
@@ -1790,7 +1847,9 @@ st_relay_log_info::st_relay_log_info()
    slave_skip_counter(0), abort_pos_wait(0), slave_run_id(0),
    sql_thd(0), last_slave_errno(0), inited(0), abort_slave(0),
    slave_running(0), skip_log_purge(0),
-   inside_transaction(0) /* the default is autocommit=1 */
+   inside_transaction(0) /* the default is autocommit=1 */,
+   workers(0), n_workers(0), group(0), order_first(0),
+   worker_error(0), stop_workers(0)
 {
   relay_log_name[0] = master_log_name[0] = 0;
   last_slave_error[0]=0;
@@ -1801,10 +1860,13 @@ st_relay_log_info::st_relay_log_info()
   pthread_mutex_init(&run_lock, MY_MUTEX_INIT_FAST);
   pthread_mutex_init(&data_lock, MY_MUTEX_INIT_FAST);
   pthread_mutex_init(&log_space_lock, MY_MUTEX_INIT_FAST);
+  pthread_mutex_init(&worker_lock, MY_MUTEX_INIT_FAST);
   pthread_cond_init(&data_cond, NULL);
   pthread_cond_init(&start_cond, NULL);
   pthread_cond_init(&stop_cond, NULL);
   pthread_cond_init(&log_space_cond, NULL);
+  pthread_cond_init(&worker_cond, NULL);
+  order_last= &order_first;
   relay_log.init_pthread_objects();
 }
 
@@ -1814,10 +1876,12 @@ st_relay_log_info::~st_relay_log_info()
   pthread_mutex_destroy(&run_lock);
   pthread_mutex_destroy(&data_lock);
   pthread_mutex_destroy(&log_space_lock);
+  pthread_mutex_destroy(&worker_lock);
   pthread_cond_destroy(&data_cond);
   pthread_cond_destroy(&start_cond);
   pthread_cond_destroy(&stop_cond);
   pthread_cond_destroy(&log_space_cond);
+  pthread_cond_destroy(&worker_cond);
 }
 
 /*
@@ -2241,49 +2305,9 @@ static int exec_relay_log_event(THD* thd, RELAY_LOG_INFO* rli)
   }
   if (ev)
   {
-    int type_code = ev->get_type_code();
-    int exec_res;
-    pthread_mutex_lock(&rli->data_lock);
-
-    /*
-      Skip queries originating from this server or number of
-      queries specified by the user in slave_skip_counter
-      We can't however skip event's that has something to do with the
-      log files themselves.
-    */
-
-    if (ev->server_id == (uint32) ::server_id ||
-	(rli->slave_skip_counter && type_code != ROTATE_EVENT))
-    {
-      /* TODO: I/O thread should not even log events with the same server id */
-      rli->inc_pos(ev->get_event_len(),
-		   type_code != STOP_EVENT ? ev->log_pos : LL(0),
-		   1/* skip lock*/);
-      flush_relay_log_info(rli);
-
-      /*
-	Protect against common user error of setting the counter to 1
-	instead of 2 while recovering from an failed auto-increment insert
-      */
-      if (rli->slave_skip_counter && 
-	  !((type_code == INTVAR_EVENT || type_code == STOP_EVENT) &&
-	    rli->slave_skip_counter == 1))
-        --rli->slave_skip_counter;
-      pthread_mutex_unlock(&rli->data_lock);
-      delete ev;     
-      return 0;					// avoid infinite update loops
-    }
-    pthread_mutex_unlock(&rli->data_lock);
-  
-    thd->server_id = ev->server_id; // use the original server id for logging
-    thd->set_time();				// time the query
-    if (!ev->when)
-      ev->when = time(NULL);
-    ev->thd = thd;
-    exec_res = ev->exec_event(rli);
-    DBUG_ASSERT(rli->sql_thd==thd);
-    delete ev;
-    return exec_res;
+    if (rli->n_workers)
+      return dispatch_relay_log_event(thd, rli, ev);
+    return apply_relay_log_event(thd, rli, ev);
   }
   else
   {
@@ -2301,6 +2325,586 @@ on this slave.\
 }
 
 
+/* Apply one event in the SQL thread */
+
+static int apply_relay_log_event(THD* thd, RELAY_LOG_INFO* rli, Log_event* ev)
+{
+  int type_code = ev->get_type_code();
+  int exec_res;
+  pthread_mutex_lock(&rli->data_lock);
+
+  /*
+    Skip queries originating from this server or number of
+    queries specified by the user in slave_skip_counter
+    We can't however skip event's that has something to do with the
+    log files themselves.
+  */
+
+  if (ev->server_id == (uint32) ::server_id ||
+      (rli->slave_skip_counter && type_code != ROTATE_EVENT))
+  {
+    /* TODO: I/O thread should not even log events with the same server id */
+    rli->inc_pos(ev->get_event_len(),
+		 type_code != STOP_EVENT ? ev->log_pos : LL(0),
+		 1/* skip lock*/);
+    flush_relay_log_info(rli);
+
+    /*
+      Protect against common user error of setting the counter to 1
+      instead of 2 while recovering from an failed auto-increment insert
+    */
+    if (rli->slave_skip_counter && 
+	!((type_code == INTVAR_EVENT || type_code == STOP_EVENT) &&
+	  rli->slave_skip_counter == 1))
+      --rli->slave_skip_counter;
+    pthread_mutex_unlock(&rli->data_lock);
+    delete ev;     
+    return 0;					// avoid infinite update loops
+  }
+  pthread_mutex_unlock(&rli->data_lock);
+
+  thd->server_id = ev->server_id; // use the original server id for logging
+  thd->set_time();				// time the query
+  if (!ev->when)
+    ev->when = time(NULL);
+  ev->thd = thd;
+  exec_res = ev->exec_event(rli);
+  DBUG_ASSERT(rli->sql_thd==thd);
+  delete ev;
+  return exec_res;
+}
+
+
+/*****************************************************************************
+  Parallel applier
+
+  The SQL thread collects the events of a group in rli->group while it
+  reads them; see SLAVE_GROUP in slave.h. The bytes of the events are
+  added to rli->pending as they are read, and moved to relay_log_pos by
+  account_slave_groups() when the group and all groups before it have
+  been applied.
+*****************************************************************************/
+
+static SLAVE_GROUP *new_slave_group()
+{
+  SLAVE_GROUP *group;
+  if (!(group= (SLAVE_GROUP*) my_malloc(sizeof(SLAVE_GROUP),
+					MYF(MY_WME | MY_ZEROFILL))))
+    return 0;
+  if (my_init_dynamic_array(&group->events, sizeof(Log_event*), 16, 16))
+  {
+    my_free((gptr) group, MYF(0));
+    return 0;
+  }
+  return group;
+}
+
+
+static void free_slave_group(SLAVE_GROUP *group)
+{
+  for (uint i= 0 ; i < group->events.elements ; i++)
+    delete *dynamic_element(&group->events, i, Log_event**);
+  delete_dynamic(&group->events);
+  my_free((gptr) group, MYF(0));
+}
+
+
+/*
+  Add a query to the group being read
+
+  RETURN
+    0	More events belong to the group
+    1	The group is complete
+*/
+
+static bool add_query_to_group(SLAVE_GROUP *group, Query_log_event *qev)
+{
+  const char *query= qev->query, *pos;
+  bool temporary= 0;
+
+  if (!strcmp(query, "BEGIN"))
+  {
+    group->in_transaction= 1;
+    return 0;
+  }
+  if (!strcmp(query, "COMMIT") || !strcmp(query, "ROLLBACK"))
+  {
+    group->commit_in_order= group->in_transaction && query[0] == 'C';
+    return 1;
+  }
+  /* SET CHARACTER SET and SET FOREIGN_KEY_CHECKS belong to the statement */
+  if (!my_casecmp(query, "SET ", 4))
+    return 0;
+
+  /*
+    Temporary tables only exist in the SQL thread, and a statement
+    without a default database may update any database
+  */
+  for (pos= query ; *pos && !temporary ; pos++)
+    temporary= !my_casecmp(pos, "TEMPORARY", 9);
+  if (!qev->db_len || temporary)
+    group->serial= 1;
+  else if (!group->db[0])
+    strmake(group->db, qev->db, sizeof(group->db)-1);
+  else if (strcmp(group->db, qev->db))
+    group->serial= 1;
+  return !group->in_transaction;
+}
+
+
+/*
+  Move the position over the groups that have been applied
+
+  NOTES
+    rli->worker_lock is locked
+*/
+
+static void account_slave_groups(RELAY_LOG_INFO* rli)
+{
+  SLAVE_GROUP *group;
+  if (!(group= rli->order_first) || !group->done)
+    return;
+  pthread_mutex_lock(&rli->data_lock);
+  do
+  {
+    rli->relay_log_pos+= group->event_len;
+    rli->pending-= group->event_len;
+    if (group->master_log_pos)
+      rli->master_log_pos= group->master_log_pos;
+    if (!(rli->order_first= group->next_in_order))
+      rli->order_last= &rli->order_first;
+    free_slave_group(group);
+  } while ((group= rli->order_first) && group->done);
+  flush_relay_log_info(rli);
+  pthread_mutex_unlock(&rli->data_lock);
+  pthread_cond_broadcast(&rli->data_cond);
+}
+
+
+/*
+  Wait until the workers have applied all queued groups
+
+  RETURN
+    0	ok
+    1	A worker failed, or the SQL thread was killed
+*/
+
+static int wait_for_slave_workers(THD* thd, RELAY_LOG_INFO* rli)
+{
+  int error;
+  pthread_mutex_lock(&rli->worker_lock);
+  const char *old_msg= thd->enter_cond(&rli->worker_cond, &rli->worker_lock,
+				       "Waiting for the slave workers to \
+apply their events");
+  while (rli->order_first && !rli->worker_error &&
+	 !sql_slave_killed(thd, rli))
+    pthread_cond_wait(&rli->worker_cond, &rli->worker_lock);
+  error= rli->order_first != 0 || rli->worker_error;
+  thd->exit_cond(old_msg);
+  pthread_mutex_unlock(&rli->worker_lock);
+  return error;
+}
+
+
+/* Apply the events of the group being read in the SQL thread */
+
+static int apply_slave_group_serially(THD* thd, RELAY_LOG_INFO* rli)
+{
+  SLAVE_GROUP *group= rli->group;
+  int error= 0;
+  uint i;
+  rli->group= 0;
+
+  /* The events move the position themselves */
+  pthread_mutex_lock(&rli->data_lock);
+  rli->pending-= group->event_len;
+  pthread_mutex_unlock(&rli->data_lock);
+
+  for (i= 0 ; i < group->events.elements && !error ; i++)
+  {
+    Log_event **ev= dynamic_element(&group->events, i, Log_event**);
+    error= apply_relay_log_event(thd, rli, *ev);
+    *ev= 0;
+  }
+  free_slave_group(group);
+  return error;
+}
+
+
+/* Give a complete group to a worker, or apply it in the SQL thread */
+
+static int queue_slave_group(THD* thd, RELAY_LOG_INFO* rli)
+{
+  SLAVE_GROUP *group= rli->group;
+  SLAVE_WORKER *worker;
+  const char *pos;
+  ulong nr= 1;
+
+  if (group->serial || !group->db[0] || thd->temporary_tables)
+  {
+    if (wait_for_slave_workers(thd, rli))
+      return 1;
+    return apply_slave_group_serially(thd, rli);
+  }
+
+  for (pos= group->db ; *pos ; pos++)
+    nr= nr*31 + (uchar) *pos;
+  worker= rli->workers + nr % rli->n_workers;
+
+  pthread_mutex_lock(&rli->worker_lock);
+  if (worker->queued >= SLAVE_WORKER_MAX_QUEUE)
+  {
+    const char *old_msg= thd->enter_cond(&rli->worker_cond,
+					 &rli->worker_lock,
+					 "Waiting for a slave worker to \
+apply its queue");
+    while (worker->queued >= SLAVE_WORKER_MAX_QUEUE && !rli->worker_error &&
+	   !sql_slave_killed(thd, rli))
+      pthread_cond_wait(&rli->worker_cond, &rli->worker_lock);
+    thd->exit_cond(old_msg);
+    if (worker->queued >= SLAVE_WORKER_MAX_QUEUE)
+    {
+      pthread_mutex_unlock(&rli->worker_lock);
+      return 1;
+    }
+  }
+  rli->group= 0;
+  *worker->last= group;
+  worker->last= &group->next;
+  worker->queued++;
+  *rli->order_last= group;
+  rli->order_last= &group->next_in_order;
+  pthread_cond_signal(&worker->cond);
+  pthread_mutex_unlock(&rli->worker_lock);
+  return 0;
+}
+
+
+/* Read one event when there are slave workers */
+
+static int dispatch_relay_log_event(THD* thd, RELAY_LOG_INFO* rli,
+				    Log_event* ev)
+{
+  int type_code= ev->get_type_code();
+  SLAVE_GROUP *group;
+
+  if ((type_code == QUERY_EVENT || type_code == INTVAR_EVENT ||
+       type_code == RAND_EVENT) &&
+      !rli->inside_transaction && !rli->slave_skip_counter &&
+      ev->server_id != (uint32) ::server_id)
+  {
+    if (!(group= rli->group) && !(group= rli->group= new_slave_group()))
+    {
+      delete ev;
+      return 1;
+    }
+    if (insert_dynamic(&group->events, (gptr) &ev))
+    {
+      delete ev;
+      return 1;
+    }
+    if (!group->when)
+      group->when= ev->when;
+    group->event_len+= ev->get_event_len();
+    if (ev->log_pos)
+      group->master_log_pos= ev->log_pos + ev->get_event_len();
+    pthread_mutex_lock(&rli->data_lock);
+    rli->inc_pending(ev->get_event_len());
+    pthread_mutex_unlock(&rli->data_lock);
+
+    if (type_code == QUERY_EVENT &&
+	add_query_to_group(group, (Query_log_event*) ev))
+      return queue_slave_group(thd, rli);
+    return 0;
+  }
+
+  /* Apply the event here, after everything that was read before it */
+  if (wait_for_slave_workers(thd, rli) ||
+      (rli->group && apply_slave_group_serially(thd, rli)))
+  {
+    delete ev;
+    return 1;
+  }
+  return apply_relay_log_event(thd, rli, ev);
+}
+
+
+/*
+  Wait until all groups before the given one have been applied
+
+  RETURN
+    0	ok
+    1	The slave is stopping or a worker failed
+*/
+
+static int wait_for_prior_groups(THD* thd, RELAY_LOG_INFO* rli,
+				 SLAVE_GROUP *group)
+{
+  int error;
+  pthread_mutex_lock(&rli->worker_lock);
+  const char *old_msg= thd->enter_cond(&rli->worker_cond, &rli->worker_lock,
+				       "Waiting for prior transactions to \
+commit");
+  while (rli->order_first != group && !rli->worker_error &&
+	 !rli->stop_workers && !thd->killed)
+    pthread_cond_wait(&rli->worker_cond, &rli->worker_lock);
+  error= rli->order_first != group;
+  thd->exit_cond(old_msg);
+  pthread_mutex_unlock(&rli->worker_lock);
+  return error;
+}
+
+
+/*
+  Apply a group in a worker thread
+
+  NOTES
+    The events do not move the position when thd->slave_worker is set
+*/
+
+static int apply_slave_group(THD* thd, SLAVE_WORKER* worker,
+			     SLAVE_GROUP* group)
+{
+  RELAY_LOG_INFO *rli= worker->rli;
+  int error= 0;
+
+  worker->group_master_log_pos= group->master_log_pos;
+  for (uint i= 0 ; i < group->events.elements && !error ; i++)
+  {
+    Log_event *ev= *dynamic_element(&group->events, i, Log_event**);
+    if (group->commit_in_order && i == group->events.elements-1 &&
+	wait_for_prior_groups(thd, rli, group))
+      return -1;
+    thd->server_id= ev->server_id;
+    thd->set_time();
+    if (!ev->when)
+      ev->when= time(NULL);
+    ev->thd= thd;
+    error= ev->exec_event(rli);
+  }
+  /* The environment of one statement must not leak to the next group */
+  thd->options&= ~OPTION_NO_FOREIGN_KEY_CHECKS;
+  thd->variables.convert_set= 0;
+  return error;
+}
+
+
+/* Slave worker thread */
+
+extern "C" pthread_handler_decl(handle_slave_worker,arg)
+{
+  THD *thd;			/* needs to be first for thread_stack */
+  SLAVE_WORKER *worker= (SLAVE_WORKER*) arg;
+  RELAY_LOG_INFO *rli= worker->rli;
+  SLAVE_GROUP *group;
+  int error;
+
+  my_thread_init();
+  DBUG_ENTER("handle_slave_worker");
+
+  thd= new THD;
+  THD_CHECK_SENTRY(thd);
+  pthread_detach_this_thread();
+  if (init_slave_thread(thd, SLAVE_THD_SQL))
+  {
+    pthread_mutex_lock(&rli->worker_lock);
+    worker->started= 1;
+    pthread_cond_broadcast(&rli->worker_cond);
+    pthread_mutex_unlock(&rli->worker_lock);
+    sql_print_error("Failed during slave worker thread initialization");
+    my_thread_end();
+    pthread_exit(0);
+    DBUG_RETURN(0);
+  }
+  thd->thread_stack= (char*) &thd;
+  thd->slave_worker= worker;
+  pthread_mutex_lock(&LOCK_thread_count);
+  threads.append(thd);
+  pthread_mutex_unlock(&LOCK_thread_count);
+
+  pthread_mutex_lock(&rli->worker_lock);
+  worker->thd= thd;
+  worker->started= worker->running= 1;
+  pthread_cond_broadcast(&rli->worker_cond);
+
+  for (;;)
+  {
+    const char *old_msg= thd->enter_cond(&worker->cond, &rli->worker_lock,
+					 "Waiting for an event group from \
+the SQL thread");
+    while (!worker->first && !rli->stop_workers && !rli->worker_error &&
+	   !thd->killed)
+      pthread_cond_wait(&worker->cond, &rli->worker_lock);
+    thd->exit_cond(old_msg);
+    /* Groups that are not applied are read again when the slave restarts */
+    if (rli->stop_workers || rli->worker_error || thd->killed)
+    {
+      if (!rli->stop_workers)
+	rli->worker_error= 1;			// Stops the SQL thread
+      pthread_cond_broadcast(&rli->worker_cond);
+      break;
+    }
+
+    group= worker->first;
+    if (!(worker->first= group->next))
+      worker->last= &worker->first;
+    worker->queued--;
+    worker->current= group;
+    pthread_cond_broadcast(&rli->worker_cond);	// Queue has room
+    pthread_mutex_unlock(&rli->worker_lock);
+
+    thd->proc_info= "Applying event group";
+    error= apply_slave_group(thd, worker, group);
+
+    pthread_mutex_lock(&rli->worker_lock);
+    worker->current= 0;
+    if (error)
+    {
+      /* -1: stopped while waiting for an earlier group */
+      if (error > 0 && !rli->stop_workers)
+      {
+	sql_print_error("Error running query in slave worker %u, slave \
+SQL thread aborted", worker->id);
+	rli->worker_error= 1;
+      }
+      pthread_cond_broadcast(&rli->worker_cond);
+      break;
+    }
+    group->done= 1;
+    worker->groups_applied++;
+    worker->last_master_log_pos= group->master_log_pos;
+    account_slave_groups(rli);
+    pthread_cond_broadcast(&rli->worker_cond);
+  }
+  worker->thd= 0;
+  pthread_mutex_unlock(&rli->worker_lock);
+
+  /* Rolls back a transaction that was not committed */
+  thd->cleanup();
+  VOID(pthread_mutex_lock(&LOCK_thread_count));
+  thd->query= thd->db= 0;			// extra safety
+  VOID(pthread_mutex_unlock(&LOCK_thread_count));
+  net_end(&thd->net);
+  pthread_mutex_lock(&LOCK_thread_count);
+  THD_CHECK_SENTRY(thd);
+  delete thd;
+  pthread_mutex_unlock(&LOCK_thread_count);
+
+  pthread_mutex_lock(&rli->worker_lock);
+  worker->running= 0;
+  pthread_cond_broadcast(&rli->worker_cond);
+  pthread_mutex_unlock(&rli->worker_lock);
+  my_thread_end();
+  pthread_exit(0);
+  DBUG_RETURN(0);				// Can't return anything here
+}
+
+
+/*
+  Start slave_parallel_workers worker threads for the SQL thread
+
+  RETURN
+    0	ok (also when no workers are used)
+    1	error; no workers are running
+*/
+
+static int start_slave_workers(RELAY_LOG_INFO* rli)
+{
+  uint i, n_workers= (uint) min(slave_parallel_workers, SLAVE_MAX_WORKERS);
+  DBUG_ENTER("start_slave_workers");
+
+  rli->group= 0;
+  rli->order_first= 0;
+  rli->order_last= &rli->order_first;
+  rli->worker_error= rli->stop_workers= 0;
+  if (!n_workers)
+    DBUG_RETURN(0);
+  if (!(rli->workers= (SLAVE_WORKER*) my_malloc(n_workers *
+						 sizeof(SLAVE_WORKER),
+						 MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(1);
+  for (i= 0 ; i < n_workers ; i++)
+  {
+    SLAVE_WORKER *worker= rli->workers + i;
+    pthread_t th;
+    worker->rli= rli;
+    worker->id= i;
+    worker->last= &worker->first;
+    pthread_cond_init(&worker->cond, NULL);
+    rli->n_workers= i+1;
+
+    pthread_mutex_lock(&rli->worker_lock);
+    if (pthread_create(&th, &connection_attrib, handle_slave_worker,
+		       (void*) worker))
+    {
+      pthread_mutex_unlock(&rli->worker_lock);
+      sql_print_error("Could not create slave worker thread (errno: %d)",
+		      errno);
+      stop_slave_workers(rli->sql_thd, rli);
+      DBUG_RETURN(1);
+    }
+    while (!worker->started)
+      pthread_cond_wait(&rli->worker_cond, &rli->worker_lock);
+    pthread_mutex_unlock(&rli->worker_lock);
+    if (!worker->running)
+    {
+      stop_slave_workers(rli->sql_thd, rli);
+      DBUG_RETURN(1);
+    }
+  }
+  DBUG_PRINT("info",("started %u slave workers", n_workers));
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Stop the worker threads. A worker finishes the group it is applying;
+  queued groups are thrown away and read again when the slave restarts.
+*/
+
+static void stop_slave_workers(THD* thd, RELAY_LOG_INFO* rli)
+{
+  SLAVE_GROUP *group;
+  uint i;
+  DBUG_ENTER("stop_slave_workers");
+
+  if (!rli->workers)
+    DBUG_VOID_RETURN;
+  pthread_mutex_lock(&rli->worker_lock);
+  rli->stop_workers= 1;
+  for (i= 0 ; i < rli->n_workers ; i++)
+    pthread_cond_signal(&rli->workers[i].cond);
+  const char *old_msg= thd->enter_cond(&rli->worker_cond, &rli->worker_lock,
+				       "Waiting for the slave workers to \
+stop");
+  for (i= 0 ; i < rli->n_workers ; i++)
+  {
+    while (rli->workers[i].running)
+      pthread_cond_wait(&rli->worker_cond, &rli->worker_lock);
+  }
+  thd->exit_cond(old_msg);
+  pthread_mutex_unlock(&rli->worker_lock);
+
+  while ((group= rli->order_first))
+  {
+    rli->order_first= group->next_in_order;
+    free_slave_group(group);
+  }
+  rli->order_last= &rli->order_first;
+  if (rli->group)
+  {
+    free_slave_group(rli->group);
+    rli->group= 0;
+  }
+  for (i= 0 ; i < rli->n_workers ; i++)
+    pthread_cond_destroy(&rli->workers[i].cond);
+  my_free((gptr) rli->workers, MYF(0));
+  rli->workers= 0;
+  rli->n_workers= 0;
+  DBUG_VOID_RETURN;
+}
+
+
 /* slave I/O thread */
 extern "C" pthread_handler_decl(handle_slave_io,arg)
 {
@@ -2683,6 +3287,11 @@ slave_begin:
   DBUG_ASSERT(rli->relay_log_pos >= BIN_LOG_HEADER_SIZE);
   DBUG_ASSERT(my_b_tell(rli->cur_log) == rli->relay_log_pos);
   DBUG_ASSERT(rli->sql_thd == thd);
+  if (start_slave_workers(rli))
+  {
+    sql_print_error("Could not start the slave worker threads");
+    goto err;
+  }
 
   DBUG_PRINT("master_info",("log_file_name: %s  position: %s",
 			    rli->master_log_name,
@@ -2702,6 +3311,8 @@ log '%s' at position %s, relay log '%s' position: %s", RPL_LOG_NAME,
     THD_CHECK_SENTRY(thd);
     if (exec_relay_log_event(thd,rli))
     {
+      /* The position is not final until the running groups are applied */
+      stop_slave_workers(thd, rli);
       // do not scare the user if SQL thread was simply killed or stopped
       if (!sql_slave_killed(thd,rli))
         sql_print_error("\
@@ -2712,6 +3323,7 @@ the slave SQL thread with \"SLAVE START\". We stopped at log \
       goto err;
     }
   }
+  stop_slave_workers(thd, rli);
 
   /* Thread stopped. Print the current replication position to the log */
   sql_print_error("Slave SQL thread exiting, replication stopped in log \
@@ -3433,6 +4045,23 @@ rli->relay_log_pos=%s rli->pending=%lu",
         pthread_mutex_lock(&rli->data_lock);
 	continue;
       }
+      /*
+	The position of the next log starts from 0 pending bytes; let the
+	workers move the position over this log first
+      */
+      if (rli->n_workers)
+      {
+	pthread_mutex_unlock(&rli->data_lock);
+	int error= wait_for_slave_workers(thd, rli);
+	pthread_mutex_lock(&rli->data_lock);
+	if (error)
+	{
+	  errmsg= "a slave worker failed";
+	  goto err;
+	}
+	if (rli->group)
+	  rli->group->event_len= 0;
+      }
       /*
 	If the log was not hot, we need to move to the next log in
 	sequence. The next log could be hot or cold, we deal with both
@@ -97,6 +97,59 @@ enum enum_binlog_formats {
   To clean up, call end_relay_log_info()
  */
 
+/*
+  Parallel applier
+
+  With slave_parallel_workers > 0 the SQL thread only reads the relay log
+  and cuts it into groups: one statement together with the Intvar, Rand
+  and SET events that describe its environment, or a whole BEGIN ... COMMIT
+  transaction. A group whose statements all have the same default database
+  is queued to the worker thread chosen by hashing the database name, so
+  that the updates of one database are applied in master order. All other
+  events and groups are applied by the SQL thread itself, after the workers
+  have applied everything that was queued before them.
+
+  Groups are applied out of order across databases, but the relay log and
+  master log positions only advance over groups which have all been
+  applied, so that a restarted slave continues from a consistent point.
+  The COMMIT of a transaction waits for all earlier groups to be applied,
+  so that transactions also commit in master order.
+*/
+
+#define SLAVE_MAX_WORKERS	64
+#define SLAVE_WORKER_MAX_QUEUE	100
+
+typedef struct st_slave_group
+{
+  struct st_slave_group *next;			/* Next in worker queue */
+  struct st_slave_group *next_in_order;		/* Next group in relay log */
+  DYNAMIC_ARRAY events;				/* Log_event* to apply */
+  ulonglong event_len;				/* Bytes in relay log */
+  my_off_t master_log_pos;			/* End in master log, or 0 */
+  time_t when;					/* Master time of first event */
+  char db[NAME_LEN+1];				/* Default database of group */
+  bool in_transaction;				/* Started with BEGIN */
+  bool commit_in_order;				/* Ends with COMMIT */
+  bool serial;					/* Must be applied by SQL thread */
+  bool done;					/* Applied by a worker */
+} SLAVE_GROUP;
+
+typedef struct st_slave_worker
+{
+  struct st_relay_log_info *rli;
+  THD *thd;					/* 0 if not running */
+  uint id;
+  pthread_cond_t cond;				/* Signaled when group queued */
+  SLAVE_GROUP *first, **last;			/* Groups to apply */
+  SLAVE_GROUP *current;				/* Group being applied */
+  uint queued;
+  ulong groups_applied;
+  my_off_t group_master_log_pos;		/* End of current group */
+  my_off_t last_master_log_pos;			/* End of last applied group */
+  bool started, running;
+} SLAVE_WORKER;
+
+
 typedef struct st_relay_log_info
 {
   /*** The following variables can only be read when protect by data lock ****/
@@ -207,6 +260,21 @@ typedef struct st_relay_log_info
   bool skip_log_purge;
   bool inside_transaction;
 
+  /*
+    Parallel applier, see SLAVE_GROUP above. worker_lock protects the
+    worker queues and the list of queued groups that are not yet accounted
+    for in relay_log_pos; it is locked before data_lock. The bytes of
+    these groups, and of the group the SQL thread is reading, are counted
+    in pending.
+  */
+  SLAVE_WORKER *workers;
+  uint n_workers;
+  pthread_mutex_t worker_lock;
+  pthread_cond_t worker_cond;			/* Group applied, worker stopped */
+  SLAVE_GROUP *group;				/* Group being read */
+  SLAVE_GROUP *order_first, **order_last;	/* Groups in relay log order */
+  bool worker_error, stop_workers;
+
   st_relay_log_info();
   ~st_relay_log_info();
   inline void inc_pending(ulonglong val)
@@ -390,6 +458,7 @@ int fetch_master_table(THD* thd, const char* db_name, const char* table_name,
 		       MASTER_INFO* mi, MYSQL* mysql, bool overwrite);
 
 int show_master_info(THD* thd, MASTER_INFO* mi);
+int show_slave_workers(THD* thd, MASTER_INFO* mi);
 int show_binlog_info(THD* thd);
 
 /* See if the query uses any tables that should not be replicated */
@@ -445,6 +514,7 @@ extern bool do_table_inited, ignore_table_inited,
 extern bool table_rules_on;
 
 extern int disconnect_slave_event_count, abort_slave_event_count ;
+extern ulong slave_parallel_workers;
 
 /* the master variables are defaults read from my.cnf or command line */
 extern uint master_port, master_connect_retry, report_port;
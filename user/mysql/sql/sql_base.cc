@@ -34,6 +34,11 @@ HASH open_cache;				/* Used by mysql_test */
 static int open_unireg_entry(THD *thd,TABLE *entry,const char *db,
 			     const char *name, const char *alias);
 static void free_cache_entry(TABLE *entry);
+static void link_unused(TABLE *table);
+static void cache_thread_tables(THD *thd);
+static TABLE *get_cached_thread_table(THD *thd, const char *key,
+				      uint key_length);
+static void uncache_thread_table(TABLE *table, bool all_versions);
 static void mysql_rm_tmp_tables(void);
 static key_map get_key_map_from_key_list(TABLE *table,
 					 List<String> *index_list);
@@ -166,7 +171,7 @@ OPEN_TABLE_LIST *list_open_tables(THD *thd, const char *wild)
       if (!strcmp(table->table,entry->real_name) &&
 	  !strcmp(table->db,entry->table_cache_key))
       {
-	if (entry->in_use)
+	if (entry->in_use && !entry->thread_cached)
 	  table->in_use++;
 	if (entry->locked_by_name)
 	  table->locked++;
@@ -185,7 +190,7 @@ OPEN_TABLE_LIST *list_open_tables(THD *thd, const char *wild)
 	   strmov(((*start_list)->db= (char*) ((*start_list)+1)),
 		  entry->table_cache_key)+1,
 	   entry->real_name);
-    (*start_list)->in_use= entry->in_use ? 1 : 0;
+    (*start_list)->in_use= entry->in_use && !entry->thread_cached ? 1 : 0;
     (*start_list)->locked= entry->locked_by_name ? 1 : 0;
     start_list= &(*start_list)->next;
     *start_list=0;
@@ -223,11 +228,19 @@ send_fields(THD *thd,List<Item> &list,uint flag)
     char *pos=net_store_length(buff,(uint) list.elements);
     (void) my_net_write(&thd->net, buff,(uint) (pos-buff));
   }
-  while ((item=it++))
+  if (thd->binary_rows)
+  {
+    /* The rows are sent with net_store_binary_row(), which needs the types */
+    if (!(thd->binary_row_types=(uchar*) thd->alloc(list.elements+1)))
+      goto err;
+  }
+  for (uint column=0 ; (item=it++) ; column++)
   {
     char *pos;
     Send_field field;
     item->make_field(&field);
+    if (thd->binary_rows)
+      thd->binary_row_types[column]=(uchar) field.type;
     packet->length(0);
 
     if (convert)
@@ -354,6 +367,9 @@ bool close_cached_tables(THD *thd, bool if_wait_for_refresh,
   VOID(pthread_mutex_lock(&LOCK_open));
   if (!tables)
   {
+    refresh_version++;				// Force close of open tables
+    for (uint idx=0 ; idx < open_cache.records ; idx++)
+      uncache_thread_table((TABLE*) hash_element(&open_cache,idx),0);
     while (unused_tables)
     {
 #ifdef EXTRA_DEBUG
@@ -363,7 +379,6 @@ bool close_cached_tables(THD *thd, bool if_wait_for_refresh,
       VOID(hash_delete(&open_cache,(byte*) unused_tables));
 #endif
     }
-    refresh_version++;				// Force close of open tables
   }
   else
   {
@@ -450,6 +465,15 @@ void close_thread_tables(THD *thd, bool locked)
   {
     mysql_unlock_tables(thd, thd->lock); thd->lock=0;
   }
+  if (table_cache_per_thread && thd->open_tables && !locked)
+  {
+    cache_thread_tables(thd);
+    if (!thd->open_tables)
+    {
+      thd->some_tables_deleted=0;
+      DBUG_VOID_RETURN;				// All tables were cached
+    }
+  }
   /* VOID(pthread_sigmask(SIG_SETMASK,&thd->block_signals,NULL)); */
   if (!locked)
     VOID(pthread_mutex_lock(&LOCK_open));
@@ -506,19 +530,27 @@ bool close_thread_table(THD *thd, TABLE **table_ptr)
       table->file->extra(HA_EXTRA_RESET);
     }
     table->in_use=0;
-    if (unused_tables)
-    {
-      table->next=unused_tables;		/* Link in last */
-      table->prev=unused_tables->prev;
-      unused_tables->prev=table;
-      table->prev->next=table;
-    }
-    else
-      unused_tables=table->next=table->prev=table;
+    link_unused(table);
   }
   DBUG_RETURN(found_old_table);
 }
 
+
+	/* Link a table not in use last in unused links */
+
+static void link_unused(TABLE *table)
+{
+  if (unused_tables)
+  {
+    table->next=unused_tables;			/* Link in last */
+    table->prev=unused_tables->prev;
+    unused_tables->prev=table;
+    table->prev->next=table;
+  }
+  else
+    unused_tables=table->next=table->prev=table;
+}
+
 	/* Close and delete temporary tables */
 
 void close_temporary(TABLE *table,bool delete_table)
@@ -653,6 +685,195 @@ static void relink_unused(TABLE *table)
 }
 
 
+/*****************************************************************************
+  Per thread cache of open tables
+
+  close_thread_tables() keeps up to table_cache_per_thread tables in
+  thd->cached_tables, and open_table() takes them from there without
+  locking LOCK_open. A cached table stays in open_cache with in_use set
+  to its thread and thread_cached set, so for all code that uses
+  LOCK_open it looks like a table that is in use.
+
+  thd->cached_tables and table->thread_cached are protected by
+  thd->LOCK_cached_tables. The thread itself locks only this mutex.
+  Code that lowers table->version or increments refresh_version must,
+  before it unlocks LOCK_open, call uncache_thread_table() for every
+  table it changed. This locks the LOCK_cached_tables of the thread that
+  uses the table, so that the thread sees the new version when it
+  closes the table, and frees the table if it is already cached.
+*****************************************************************************/
+
+/*
+  Move tables that are still current from thd->open_tables to the cache
+  of the thread
+*/
+
+static void cache_thread_tables(THD *thd)
+{
+  TABLE *table,*next,**prev= &thd->open_tables;
+  DBUG_ENTER("cache_thread_tables");
+
+  VOID(pthread_mutex_lock(&thd->LOCK_cached_tables));
+  for (table= *prev ; table ; table=next)
+  {
+    next=table->next;
+    if (table->version == refresh_version &&
+	thd->version == refresh_version && table->db_stat &&
+	table->flush_version == flush_version &&
+	thd->cached_tables_count < table_cache_per_thread)
+    {
+      DBUG_ASSERT(table->key_read == 0);
+      *prev=next;
+      table->file->extra(HA_EXTRA_RESET);
+      table->prev=0;
+      if ((table->next=thd->cached_tables))
+	table->next->prev=table;
+      thd->cached_tables=table;
+      thd->cached_tables_count++;
+      table->thread_cached=1;
+    }
+    else
+      prev= &table->next;
+  }
+  VOID(pthread_mutex_unlock(&thd->LOCK_cached_tables));
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Remove a table from the cache of its thread
+
+  NOTE
+    The thread's LOCK_cached_tables must be locked
+*/
+
+static void unlink_cached_thread_table(TABLE *table)
+{
+  THD *thd=table->in_use;
+  if (table->prev)
+    table->prev->next=table->next;
+  else
+    thd->cached_tables=table->next;
+  if (table->next)
+    table->next->prev=table->prev;
+  thd->cached_tables_count--;
+  table->thread_cached=0;
+}
+
+
+/*
+  Take a current table from the cache of the thread
+
+  SYNOPSIS
+    get_cached_thread_table()
+    thd			Thread handler
+    key			Table cache key
+    key_length		Length of key
+
+  RETURN
+    0	No table found; The caller must use open_cache
+    #	Table; It is in use by thd but not linked in thd->open_tables
+*/
+
+static TABLE *get_cached_thread_table(THD *thd, const char *key,
+				      uint key_length)
+{
+  TABLE *table;
+  VOID(pthread_mutex_lock(&thd->LOCK_cached_tables));
+  if (!thd->open_tables)
+    thd->version=refresh_version;
+  if (thd->version == refresh_version)
+  {
+    for (table=thd->cached_tables ; table ; table=table->next)
+    {
+      if (table->key_length == key_length &&
+	  !memcmp(table->table_cache_key,key,key_length) &&
+	  table->version == refresh_version)
+      {
+	unlink_cached_thread_table(table);
+	break;
+      }
+    }
+  }
+  else
+    table=0;					// Let open_table() handle it
+  VOID(pthread_mutex_unlock(&thd->LOCK_cached_tables));
+  return table;
+}
+
+
+/*
+  Free a table if it's in the cache of some thread
+
+  SYNOPSIS
+    uncache_thread_table()
+    table		Table in open_cache
+    all_versions	Free also a table with the current version
+
+  NOTES
+    Must be called with LOCK_open locked. A freed table is put first in
+    unused links with version 0; the caller should free it with
+    while (unused_tables && !unused_tables->version) hash_delete().
+    Called also for tables that are in use, to make sure that the
+    thread that uses the table sees the new table version.
+*/
+
+static void uncache_thread_table(TABLE *table, bool all_versions)
+{
+  THD *in_use;
+  safe_mutex_assert_owner(&LOCK_open);
+
+  if ((in_use=table->in_use) && !table->locked_by_name)
+  {
+    VOID(pthread_mutex_lock(&in_use->LOCK_cached_tables));
+    if (table->thread_cached &&
+	(all_versions || table->version != refresh_version))
+    {
+      unlink_cached_thread_table(table);
+      table->in_use=0;
+      table->version=0;
+      link_unused(table);
+      unused_tables=table;			// Put it first
+    }
+    VOID(pthread_mutex_unlock(&in_use->LOCK_cached_tables));
+  }
+}
+
+
+/*
+  Give back the tables in the cache of a thread to open_cache
+
+  SYNOPSIS
+    close_cached_thread_tables()
+    thd			Thread handler
+
+  NOTES
+    Called when the thread ends or changes user.
+*/
+
+void close_cached_thread_tables(THD *thd)
+{
+  TABLE *table;
+  DBUG_ENTER("close_cached_thread_tables");
+
+  VOID(pthread_mutex_lock(&LOCK_open));
+  VOID(pthread_mutex_lock(&thd->LOCK_cached_tables));
+  while ((table=thd->cached_tables))
+  {
+    unlink_cached_thread_table(table);
+    table->in_use=0;
+    link_unused(table);
+  }
+  VOID(pthread_mutex_unlock(&thd->LOCK_cached_tables));
+  /* Free tables to hold down open files */
+  while (open_cache.records > table_cache_size && unused_tables)
+    VOID(hash_delete(&open_cache,(byte*) unused_tables));
+  check_unused();
+  VOID(pthread_mutex_unlock(&LOCK_open));
+  DBUG_VOID_RETURN;
+}
+
+
 /*
   Remove all instances of table from the current open list
   Free all locks on tables that are done with LOCK TABLES
@@ -813,6 +1034,17 @@ TABLE *open_table(THD *thd,const char *db,const char *table_name,
     my_printf_error(ER_TABLE_NOT_LOCKED,ER(ER_TABLE_NOT_LOCKED),MYF(0),alias);
     DBUG_RETURN(0);
   }
+
+  /* Use a table the thread kept from an earlier statement */
+  if (refresh && thd->cached_tables &&
+      (table=get_cached_thread_table(thd,key,key_length)))
+  {
+    table->next=thd->open_tables;		/* Link into simple list */
+    thd->open_tables=table;
+    table->reginfo.lock_type=TL_READ;		/* Assume read */
+    goto reset;
+  }
+
   VOID(pthread_mutex_lock(&LOCK_open));
 
   if (!thd->open_tables)
@@ -1367,7 +1599,7 @@ int open_tables(THD *thd,TABLE_LIST *start)
   DBUG_ENTER("open_tables");
 
  restart:
-  thd->proc_info="Opening tables";
+  thd->set_proc_info("Opening tables");
   for (tables=start ; tables ; tables=tables->next)
   {
     if (!tables->table &&
@@ -1483,7 +1715,7 @@ TABLE *open_ltable(THD *thd, TABLE_LIST *table_list, thr_lock_type lock_type)
   bool refresh;
   DBUG_ENTER("open_ltable");
 
-  thd->proc_info="Opening table";
+  thd->set_proc_info("Opening table");
   while (!(table=open_table(thd,table_list->db,
 			    table_list->real_name,table_list->alias,
 			    &refresh)) && refresh) ;
@@ -2153,6 +2385,44 @@ fill_record(Field **ptr,List<Item> &values, bool ignore_errors)
 }
 
 
+/*
+  Store a row of literals read by the lexer (see scan_insert_values())
+  The values are stored as the Item_null, Item_int, Item_real and
+  Item_string that the parser makes of them would store them
+*/
+
+int
+fill_record(Field **ptr,INSERT_ROW *row)
+{
+  INSERT_LITERAL *value=row->values;
+  Field *field;
+  DBUG_ENTER("fill_record");
+
+  for (; (field= *ptr) ; ptr++, value++)
+  {
+    switch (value->type) {
+    case INSERT_LITERAL_NULL:
+      if (set_field_to_null_with_conversions(field, 0))
+	DBUG_RETURN(1);
+      break;
+    case INSERT_LITERAL_INT:
+      field->set_notnull();
+      field->store((longlong) strtoll(value->str, NULL, 10));
+      break;
+    case INSERT_LITERAL_REAL:
+      field->set_notnull();
+      field->store(atof(value->str));
+      break;
+    case INSERT_LITERAL_STRING:
+      field->set_notnull();
+      field->store(value->str, value->length);
+      break;
+    }
+  }
+  DBUG_RETURN(0);
+}
+
+
 static void mysql_rm_tmp_tables(void)
 {
   uint idx;
@@ -2239,6 +2509,7 @@ void remove_db_from_cache(const my_string db)
     if (!strcmp(table->table_cache_key,db))
     {
       table->version=0L;			/* Free when thread is ready */
+      uncache_thread_table(table,0);
       if (!table->in_use)
 	relink_unused(table);
     }
@@ -2255,6 +2526,8 @@ void remove_db_from_cache(const my_string db)
 void flush_tables()
 {
   (void) pthread_mutex_lock(&LOCK_open);
+  for (uint idx=0 ; idx < open_cache.records ; idx++)
+    uncache_thread_table((TABLE*) hash_element(&open_cache,idx),1);
   while (unused_tables)
     hash_delete(&open_cache,(byte*) unused_tables);
   (void) pthread_mutex_unlock(&LOCK_open);
@@ -2282,6 +2555,7 @@ bool remove_table_from_cache(THD *thd, const char *db, const char *table_name,
   {
     THD *in_use;
     table->version=0L;			/* Free when thread is ready */
+    uncache_thread_table(table,0);
     if (!(in_use=table->in_use))
     {
       DBUG_PRINT("info",("Table was not in use"));
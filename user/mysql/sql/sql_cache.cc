@@ -308,11 +308,11 @@ TODO list:
 #define RW_UNLOCK(M) {DBUG_PRINT("lock", ("rwlock unlock 0x%lx",(ulong)(M))); \
   if (!rw_unlock(M)) DBUG_PRINT("lock", ("rwlock unlock ok")) \
   else DBUG_PRINT("lock", ("rwlock unlock FAILED %d", errno)); }
-#define STRUCT_LOCK(M) {DBUG_PRINT("lock", ("%d struct lock...",__LINE__)); \
-  pthread_mutex_lock(M);DBUG_PRINT("lock", ("struct lock OK"));}
-#define STRUCT_UNLOCK(M) { \
+#define STRUCT_LOCK(P) {DBUG_PRINT("lock", ("%d struct lock...",__LINE__)); \
+  (P)->struct_lock();DBUG_PRINT("lock", ("struct lock OK"));}
+#define STRUCT_UNLOCK(P) { \
   DBUG_PRINT("lock", ("%d struct unlock...",__LINE__)); \
-  pthread_mutex_unlock(M);DBUG_PRINT("lock", ("struct unlock OK"));}
+  (P)->struct_unlock();DBUG_PRINT("lock", ("struct unlock OK"));}
 #define BLOCK_LOCK_WR(B) {DBUG_PRINT("lock", ("%d LOCK_WR 0x%lx",\
   __LINE__,(ulong)(B))); \
   B->query()->lock_writing();}
@@ -333,8 +333,8 @@ TODO list:
 #define RW_WLOCK(M) rw_wrlock(M)
 #define RW_RLOCK(M) rw_rdlock(M)
 #define RW_UNLOCK(M) rw_unlock(M)
-#define STRUCT_LOCK(M) pthread_mutex_lock(M)
-#define STRUCT_UNLOCK(M) pthread_mutex_unlock(M)
+#define STRUCT_LOCK(P) (P)->struct_lock()
+#define STRUCT_UNLOCK(P) (P)->struct_unlock()
 #define BLOCK_LOCK_WR(B) B->query()->lock_writing()
 #define BLOCK_LOCK_RD(B) B->query()->lock_reading()
 #define BLOCK_UNLOCK_WR(B) B->query()->unlock_writing()
@@ -561,6 +561,7 @@ byte *query_cache_query_get_key(const byte *record, uint *length,
 
 void query_cache_insert(NET *net, const char *packet, ulong length)
 {
+  Query_cache_part *part;
   DBUG_ENTER("query_cache_insert");
 
 #ifndef DBUG_OFF
@@ -569,41 +570,38 @@ void query_cache_insert(NET *net, const char *packet, ulong length)
     DBUG_VOID_RETURN;
 #endif
 
-  STRUCT_LOCK(&query_cache.structure_guard_mutex);
-  Query_cache_block *query_block = ((Query_cache_block*)
-				    net->query_cache_query);
-  if (query_block)
+  if ((part= query_cache.lock_writer_partition(net)))
   {
+    Query_cache_block *query_block = ((Query_cache_block*)
+				      net->query_cache_query);
     Query_cache_query *header = query_block->query();
     Query_cache_block *result = header->result();
 
-    DUMP(&query_cache);
+    DUMP(part);
     BLOCK_LOCK_WR(query_block);
     DBUG_PRINT("qcache", ("insert packet %lu bytes long",length));
 
     /*
-      On success STRUCT_UNLOCK(&query_cache.structure_guard_mutex) will be
-      done by query_cache.append_result_data if success (if not we need
-      query_cache.structure_guard_mutex locked to free query)
+      On success STRUCT_UNLOCK(part) will be done by
+      part->append_result_data if success (if not we need
+      the partition locked to free query)
     */
-    if (!query_cache.append_result_data(&result, length, (gptr) packet,
-					query_block))
+    if (!part->append_result_data(&result, length, (gptr) packet,
+				  query_block))
     {
-      query_cache.refused++;
+      part->refused++;
       DBUG_PRINT("warning", ("Can't append data"));
       header->result(result);
       DBUG_PRINT("qcache", ("free query 0x%lx", (ulong) query_block));
       // The following call will remove the lock on query_block
-      query_cache.free_query(query_block);
+      part->free_query(query_block);
       // append_result_data no success => we need unlock
-      STRUCT_UNLOCK(&query_cache.structure_guard_mutex);
+      STRUCT_UNLOCK(part);
       DBUG_VOID_RETURN;
     }
     header->result(result);
     BLOCK_UNLOCK_WR(query_block);
   }
-  else
-    STRUCT_UNLOCK(&query_cache.structure_guard_mutex);
   DBUG_EXECUTE("check_querycache",query_cache.check_integrity(0););
   DBUG_VOID_RETURN;
 }
@@ -611,6 +609,7 @@ void query_cache_insert(NET *net, const char *packet, ulong length)
 
 void query_cache_abort(NET *net)
 {
+  Query_cache_part *part;
   DBUG_ENTER("query_cache_abort");
 
 #ifndef DBUG_OFF
@@ -620,19 +619,18 @@ void query_cache_abort(NET *net)
 #endif
   if (net->query_cache_query != 0)	// Quick check on unlocked structure
   {
-    STRUCT_LOCK(&query_cache.structure_guard_mutex);
-    Query_cache_block *query_block = ((Query_cache_block*)
-				       net->query_cache_query);
-    if (query_block)			// Test if changed by other thread
+    if ((part= query_cache.lock_writer_partition(net)))
     {
-      DUMP(&query_cache);
+      Query_cache_block *query_block = ((Query_cache_block*)
+					net->query_cache_query);
+      DUMP(part);
       BLOCK_LOCK_WR(query_block);
       // The following call will remove the lock on query_block
-      query_cache.free_query(query_block);
+      part->free_query(query_block);
+      DBUG_EXECUTE("check_querycache",part->check_integrity(1););
+      STRUCT_UNLOCK(part);
     }
     net->query_cache_query=0;
-    DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
-    STRUCT_UNLOCK(&query_cache.structure_guard_mutex);
   }
   DBUG_VOID_RETURN;
 }
@@ -640,6 +638,7 @@ void query_cache_abort(NET *net)
 
 void query_cache_end_of_result(NET *net)
 {
+  Query_cache_part *part;
   DBUG_ENTER("query_cache_end_of_result");
 
 #ifndef DBUG_OFF
@@ -649,20 +648,19 @@ void query_cache_end_of_result(NET *net)
 
   if (net->query_cache_query != 0)	// Quick check on unlocked structure
   {
-    STRUCT_LOCK(&query_cache.structure_guard_mutex);
-    Query_cache_block *query_block = ((Query_cache_block*)
-				      net->query_cache_query);
-    if (query_block)
+    if ((part= query_cache.lock_writer_partition(net)))
     {
-      DUMP(&query_cache);
+      Query_cache_block *query_block = ((Query_cache_block*)
+					net->query_cache_query);
+      DUMP(part);
       BLOCK_LOCK_WR(query_block);
       Query_cache_query *header = query_block->query();
       Query_cache_block *last_result_block = header->result()->prev;
       ulong allign_size = ALIGN_SIZE(last_result_block->used);
-      ulong len = max(query_cache.min_allocation_unit, allign_size);
-      if (last_result_block->length >= query_cache.min_allocation_unit + len)
-	query_cache.split_block(last_result_block,len);
-      STRUCT_UNLOCK(&query_cache.structure_guard_mutex);
+      ulong len = max(part->min_allocation_unit, allign_size);
+      if (last_result_block->length >= part->min_allocation_unit + len)
+	part->split_block(last_result_block,len);
+      STRUCT_UNLOCK(part);
 
 #ifndef DBUG_OFF
       if (header->result() == 0)
@@ -678,11 +676,7 @@ void query_cache_end_of_result(NET *net)
       header->writer(0);
       BLOCK_UNLOCK_WR(query_block);
     }
-    else
-    {
-      // Cache was flushed or resized and query was deleted => do nothing
-      STRUCT_UNLOCK(&query_cache.structure_guard_mutex);
-    }
+    /* else cache was flushed or resized and query was deleted => do nothing */
     net->query_cache_query=0;
     DBUG_EXECUTE("check_querycache",query_cache.check_integrity(0););
   }
@@ -698,17 +692,420 @@ void query_cache_invalidate_by_MyISAM_filename(const char *filename)
 
 /*****************************************************************************
    Query_cache methods
+
+   The query cache is split in 'partitions' Query_cache_part objects.
+   A query is stored in, and looked up from, the partition given by
+   the hash of the query text. Each partition has its own
+   structure_guard_mutex, so only queries that map to the same
+   partition are serialized.
+   To invalidate a table we have to look in all partitions. Each
+   partition keeps a count of its cached tables per table_map_pos()
+   of the table key; partitions with a zero count are skipped without
+   taking their mutex.
+*****************************************************************************/
+
+/*
+  Hash function for partition and table map lookups.
+  Same as calc_hashnr() in mysys/hash.c
+*/
+
+static uint query_cache_hashnr(const byte *key, uint length, my_bool fold_case)
+{
+  register uint nr=1, nr2=4;
+  while (length--)
+  {
+    uint chr= fold_case ? (uint) (uchar) toupper(*key) : (uint) (uchar) *key;
+    nr^= (((nr & 63)+nr2)*chr)+ (nr << 8);
+    nr2+=3;
+    key++;
+  }
+  return((uint) nr);
+}
+
+
+Query_cache::Query_cache()
+  :query_cache_size(0), query_cache_limit(ULONG_MAX),
+   free_memory(0), queries_in_cache(0), hits(0), inserts(0), refused(0),
+   free_memory_blocks(0), total_blocks(0), lowmem_prunes(0), lock_waits(0),
+   partitions(0), max_partitions(0)
+{}
+
+
+inline Query_cache_part *Query_cache::partition(const char *query,
+						 uint query_length)
+{
+  if (partitions <= 1)
+    return parts;
+  return parts + (query_cache_hashnr((const byte*) query, query_length, 0) %
+		  partitions);
+}
+
+
+/*
+  Position of a table key in Query_cache_part::table_map
+
+  NOTE
+    The key is always case folded, as the tables hash may be
+    case insensitive (see Query_cache_part::init_cache())
+*/
+
+uint Query_cache::table_map_pos(const byte *key, uint32 key_length)
+{
+  return query_cache_hashnr(key, key_length, 1) % QUERY_CACHE_TABLE_MAP_SIZE;
+}
+
+
+/*
+  Resize the query cache
+
+  SYNOPSIS
+    resize()
+    query_cache_size_arg	New total size of the cache
+
+  NOTES
+    The memory is divided evenly between query_cache_partitions
+    partitions. If a partition would get less than
+    QUERY_CACHE_MIN_PARTITION_SIZE we use fewer partitions.
+
+  RETURN
+    Real size of the cache, 0 if disabled
+*/
+
+ulong Query_cache::resize(ulong query_cache_size_arg)
+{
+  uint i, new_partitions;
+  ulong size= 0;
+  DBUG_ENTER("Query_cache::resize");
+
+  new_partitions= (uint) min(query_cache_partitions,
+			     QUERY_CACHE_MAX_PARTITIONS);
+  while (new_partitions > 1 &&
+	 query_cache_size_arg / new_partitions < QUERY_CACHE_MIN_PARTITION_SIZE)
+    new_partitions--;
+  set_if_bigger(new_partitions, 1);
+  DBUG_PRINT("qcache", ("from %lu to %lu in %u partitions",
+			query_cache_size, query_cache_size_arg,
+			new_partitions));
+
+  /* Don't let new queries into the cache while it's resized */
+  query_cache_size= 0;
+  set_if_bigger(max_partitions, new_partitions);
+  for (i=0 ; i < max_partitions ; i++)
+  {
+    if (i < new_partitions)
+      size+= parts[i].resize(query_cache_size_arg / new_partitions);
+    else
+      parts[i].resize(0);
+  }
+  partitions= new_partitions;
+  DBUG_RETURN(::query_cache_size= query_cache_size= size);
+}
+
+
+void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
+{
+  if (query_cache_size > 0)
+    partition(thd->query, thd->query_length)->store_query(thd, tables_used);
+}
+
+
+int Query_cache::send_result_to_client(THD *thd, char *sql, uint query_length)
+{
+  if (query_cache_size == 0)
+    return 0;
+  return partition(sql, query_length)->send_result_to_client(thd, sql,
+							     query_length);
+}
+
+
+/*
+  Remove all cached queries that uses any of the tables in the list
+*/
+
+void Query_cache::invalidate(THD *thd, TABLE_LIST *tables_used,
+			     my_bool using_transactions)
+{
+  DBUG_ENTER("Query_cache::invalidate (table list)");
+  if (query_cache_size > 0)
+  {
+    using_transactions = using_transactions &&
+      (thd->options & (OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN));
+    for (; tables_used; tables_used=tables_used->next)
+    {
+      DBUG_ASSERT(!using_transactions || tables_used->table!=0);
+      if (using_transactions && 
+	  tables_used->table->file->has_transactions())
+	/* 
+	   Tables_used->table can't be 0 in transaction.
+	   Only 'drop' invalidate not opened table, but 'drop' 
+	   force transaction finish.
+	*/
+	thd->add_changed_table(tables_used->table);
+      else
+	invalidate_table(tables_used);
+    }
+  }
+  DBUG_VOID_RETURN;
+}
+
+void Query_cache::invalidate(CHANGED_TABLE_LIST *tables_used)
+{
+  DBUG_ENTER("Query_cache::invalidate (changed table list)");
+  if (query_cache_size > 0)
+  {
+    for (; tables_used; tables_used=tables_used->next)
+    {
+      invalidate_table((byte*) tables_used->key, tables_used->key_length);
+      DBUG_PRINT("qcache", (" db %s, table %s", tables_used->key,
+			    tables_used->key+
+			    strlen(tables_used->key)+1));
+    }
+  }
+  DBUG_VOID_RETURN;
+}
+
+/*
+  Remove all cached queries that uses the given table
+*/
+
+void Query_cache::invalidate(THD *thd, TABLE *table, 
+			     my_bool using_transactions)
+{
+  DBUG_ENTER("Query_cache::invalidate (table)");
+  if (query_cache_size > 0)
+  {
+    using_transactions = using_transactions &&
+      (thd->options & (OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN));
+    if (using_transactions && table->file->has_transactions())
+      thd->add_changed_table(table);
+    else
+      invalidate_table(table);
+  }
+  DBUG_VOID_RETURN;
+}
+
+void Query_cache::invalidate(THD *thd, const char *key, uint32  key_length,
+			     my_bool using_transactions)
+{
+  DBUG_ENTER("Query_cache::invalidate (key)");
+  if (query_cache_size > 0)
+  {
+    using_transactions = using_transactions &&
+      (thd->options & (OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN));
+    if (using_transactions) // used for innodb => has_transactions() is TRUE
+      thd->add_changed_table(key, key_length);
+    else
+      invalidate_table((byte*)key, key_length);
+  }
+  DBUG_VOID_RETURN;
+}
+
+/*
+  Remove all cached queries that uses the given database
+*/
+
+void Query_cache::invalidate(char *db)
+{
+  DBUG_ENTER("Query_cache::invalidate (db)");
+  for (uint i=0 ; i < max_partitions && query_cache_size > 0 ; i++)
+  {
+    Query_cache_part *part= parts + i;
+    if (part->query_cache_size > 0)
+    {
+      STRUCT_LOCK(part);
+      part->invalidate_all();
+      STRUCT_UNLOCK(part);
+    }
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+void Query_cache::invalidate_by_MyISAM_filename(const char *filename)
+{
+  DBUG_ENTER("Query_cache::invalidate_by_MyISAM_filename");
+  if (query_cache_size > 0)
+  {
+    /* Calculate the key outside the lock to make the lock shorter */
+    char key[MAX_DBKEY_LENGTH];
+    uint32 db_length;
+    uint key_length= Query_cache_part::filename_2_table_key(key, filename,
+							    &db_length);
+    invalidate_table((byte*) key, key_length);
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+void Query_cache::invalidate_table(TABLE_LIST *table_list)
+{
+  if (table_list->table != 0)
+    invalidate_table(table_list->table);	// Table is open
+  else
+  {
+    char key[MAX_DBKEY_LENGTH];
+    uint key_length;
+    key_length=(uint) (strmov(strmov(key,table_list->db)+1,
+			      table_list->real_name) -key)+ 1;
+
+    // We don't store temporary tables => no key_length+=4 ...
+    invalidate_table((byte*) key, key_length);
+  }
+}
+
+void Query_cache::invalidate_table(TABLE *table)
+{
+  invalidate_table((byte*) table->table_cache_key, table->key_length);
+}
+
+
+/*
+  Remove all queries that use the table from all partitions
+
+  NOTES
+    Partitions that don't have any table that hash to the same
+    table_map position are skipped without locking them.
+*/
+
+void Query_cache::invalidate_table(byte *key, uint32 key_length)
+{
+  uint pos= table_map_pos(key, key_length);
+  for (uint i=0 ; i < max_partitions ; i++)
+  {
+    Query_cache_part *part= parts + i;
+    if (part->query_cache_size > 0 && part->table_map[pos])
+    {
+      STRUCT_LOCK(part);
+      if (part->query_cache_size > 0)		// Safety if cache removed
+	part->invalidate_table(key, key_length);
+      STRUCT_UNLOCK(part);
+    }
+  }
+}
+
+
+  /* Remove all queries from cache */
+
+void Query_cache::flush()
+{
+  DBUG_ENTER("Query_cache::flush");
+  for (uint i=0 ; i < max_partitions ; i++)
+    parts[i].flush();
+  DBUG_VOID_RETURN;
+}
+
+
+void Query_cache::pack(ulong join_limit, uint iteration_limit)
+{
+  DBUG_ENTER("Query_cache::pack");
+  for (uint i=0 ; i < max_partitions ; i++)
+    parts[i].pack(join_limit, iteration_limit);
+  DBUG_VOID_RETURN;
+}
+
+
+void Query_cache::destroy()
+{
+  DBUG_ENTER("Query_cache::destroy");
+  for (uint i=0 ; i < max_partitions ; i++)
+    parts[i].destroy();
+  query_cache_size= 0;
+  partitions= max_partitions= 0;
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Sum the statistics of all partitions for SHOW STATUS
+*/
+
+void Query_cache::update_stats()
+{
+  free_memory= queries_in_cache= hits= inserts= refused= 0;
+  free_memory_blocks= total_blocks= lowmem_prunes= lock_waits= 0;
+  for (uint i=0 ; i < max_partitions ; i++)
+  {
+    Query_cache_part *part= parts + i;
+    free_memory+=	 part->free_memory;
+    queries_in_cache+=	 part->queries_in_cache;
+    hits+=		 part->hits;
+    inserts+=		 part->inserts;
+    refused+=		 part->refused;
+    free_memory_blocks+= part->free_memory_blocks;
+    total_blocks+=	 part->total_blocks;
+    lowmem_prunes+=	 part->lowmem_prunes;
+    lock_waits+=	 part->lock_waits;
+  }
+}
+
+
+/*
+  Reset the counters of all partitions (FLUSH STATUS)
+*/
+
+void Query_cache::reset_stats()
+{
+  for (uint i=0 ; i < max_partitions ; i++)
+  {
+    Query_cache_part *part= parts + i;
+    part->hits= part->inserts= part->refused= 0;
+    part->lowmem_prunes= part->lock_waits= 0;
+  }
+  hits= inserts= refused= lowmem_prunes= lock_waits= 0;
+}
+
+
+/*
+  Find and lock the partition that has the query that is written to net
+
+  SYNOPSIS
+    lock_writer_partition()
+    net		Net of the thread that stores a query result
+
+  NOTES
+    The query block can be freed (and the partition resized) until we
+    have the lock of the partition, so we have to check that the query
+    is still there after locking.
+
+  RETURN
+    0	  net doesn't store a query in the cache any more
+    #	  Locked partition with the query block
+*/
+
+Query_cache_part *Query_cache::lock_writer_partition(NET *net)
+{
+  gptr block;
+  while ((block= net->query_cache_query))
+  {
+    Query_cache_part *part, *end;
+    for (part= parts, end= parts + max_partitions; part < end ; part++)
+    {
+      if (part->query_cache_size > 0 && part->in_cache_memory(block))
+	break;
+    }
+    if (part == end)
+      return 0;
+    STRUCT_LOCK(part);
+    if (net->query_cache_query == block && part->query_cache_size > 0 &&
+	part->in_cache_memory(block))
+      return part;
+    STRUCT_UNLOCK(part);
+  }
+  return 0;
+}
+
+
+/*****************************************************************************
+   Query_cache_part methods
 *****************************************************************************/
 
-Query_cache::Query_cache(ulong query_cache_limit_arg,
-			 ulong min_allocation_unit_arg,
+Query_cache_part::Query_cache_part(ulong min_allocation_unit_arg,
 			 ulong min_result_data_size_arg,
 			 uint def_query_hash_size_arg,
 			 uint def_table_hash_size_arg)
   :query_cache_size(0),
-   query_cache_limit(query_cache_limit_arg),
    queries_in_cache(0), hits(0), inserts(0), refused(0),
-   total_blocks(0), lowmem_prunes(0),
+   total_blocks(0), lowmem_prunes(0), lock_waits(0),
    min_allocation_unit(ALIGN_SIZE(min_allocation_unit_arg)),
    min_result_data_size(ALIGN_SIZE(min_result_data_size_arg)),
    def_query_hash_size(ALIGN_SIZE(def_query_hash_size_arg)),
@@ -721,25 +1118,26 @@ Query_cache::Query_cache(ulong query_cache_limit_arg,
   set_if_bigger(min_allocation_unit,min_needed);
   this->min_allocation_unit= ALIGN_SIZE(min_allocation_unit);
   set_if_bigger(this->min_result_data_size,min_allocation_unit);
+  bzero((char*) table_map, sizeof(table_map));
 }
 
 
-ulong Query_cache::resize(ulong query_cache_size_arg)
+ulong Query_cache_part::resize(ulong query_cache_size_arg)
 {
-  DBUG_ENTER("Query_cache::resize");
+  DBUG_ENTER("Query_cache_part::resize");
   DBUG_PRINT("qcache", ("from %lu to %lu",query_cache_size,
 			query_cache_size_arg));
   free_cache(0);
   query_cache_size= query_cache_size_arg;
-  DBUG_RETURN(::query_cache_size= init_cache());
+  DBUG_RETURN(init_cache());
 }
 
 
-void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
+void Query_cache_part::store_query(THD *thd, TABLE_LIST *tables_used)
 {
   TABLE_COUNTER_TYPE local_tables;
   ulong tot_length;
-  DBUG_ENTER("Query_cache::store_query");
+  DBUG_ENTER("Query_cache_part::store_query");
   if (query_cache_size == 0)
     DBUG_VOID_RETURN;
 
@@ -748,10 +1146,13 @@ void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
   {
     NET *net= &thd->net;
     byte flags= (thd->client_capabilities & CLIENT_LONG_FLAG ? 0x80 : 0);
-    STRUCT_LOCK(&structure_guard_mutex);
+    STRUCT_LOCK(this);
 
     if (query_cache_size == 0)
+    {
+      STRUCT_UNLOCK(this);
       DBUG_VOID_RETURN;
+    }
     DUMP(this);
 
     /* Key is query + database + flag */
@@ -805,7 +1206,7 @@ void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
 	  DBUG_PRINT("qcache", ("insertion in query hash"));
 	  header->unlock_n_destroy();
 	  free_memory_block(query_block);
-	  STRUCT_UNLOCK(&structure_guard_mutex);
+	  STRUCT_UNLOCK(this);
 	  goto end;
 	}
 	if (!register_all_tables(query_block, tables_used, local_tables))
@@ -815,13 +1216,13 @@ void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
 	  hash_delete(&queries, (byte *) query_block);
 	  header->unlock_n_destroy();
 	  free_memory_block(query_block);
-	  STRUCT_UNLOCK(&structure_guard_mutex);
+	  STRUCT_UNLOCK(this);
 	  goto end;
 	}
 	double_linked_list_simple_include(query_block, &queries_blocks);
 	inserts++;
 	queries_in_cache++;
-	STRUCT_UNLOCK(&structure_guard_mutex);
+	STRUCT_UNLOCK(this);
 
 	net->query_cache_query= (gptr) query_block;
 	header->writer(net);
@@ -832,7 +1233,7 @@ void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
       {
 	// We have not enough memory to store query => do nothing
 	refused++;
-	STRUCT_UNLOCK(&structure_guard_mutex);
+	STRUCT_UNLOCK(this);
 	DBUG_PRINT("warning", ("Can't allocate query"));
       }
     }
@@ -840,7 +1241,7 @@ void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
     {
       // Another thread is processing the same query => do nothing
       refused++;
-      STRUCT_UNLOCK(&structure_guard_mutex);
+      STRUCT_UNLOCK(this);
       DBUG_PRINT("qcache", ("Another thread process same query"));
     }
   }
@@ -865,14 +1266,14 @@ end:
 
 
 int
-Query_cache::send_result_to_client(THD *thd, char *sql, uint query_length)
+Query_cache_part::send_result_to_client(THD *thd, char *sql, uint query_length)
 {
   Query_cache_query *query;
   Query_cache_block *first_result_block, *result_block;
   Query_cache_block_table *block_table, *block_table_end;
   ulong tot_length;
   byte flags;
-  DBUG_ENTER("Query_cache::send_result_to_client");
+  DBUG_ENTER("Query_cache_part::send_result_to_client");
 
   if (query_cache_size == 0 ||
       /*
@@ -904,7 +1305,7 @@ Query_cache::send_result_to_client(THD *thd, char *sql, uint query_length)
     goto err;
   }
 
-  STRUCT_LOCK(&structure_guard_mutex);
+  STRUCT_LOCK(this);
   if (query_cache_size == 0)
   {
     DBUG_PRINT("qcache", ("query cache disabled"));
@@ -982,7 +1383,7 @@ Query_cache::send_result_to_client(THD *thd, char *sql, uint query_length)
 		 ("probably no SELECT access to %s.%s =>  return to normal processing",
 		  table_list.db, table_list.alias));
       refused++;				// This is actually a hit
-      STRUCT_UNLOCK(&structure_guard_mutex);
+      STRUCT_UNLOCK(this);
       thd->safe_to_cache_query=0;		// Don't try to cache this
       BLOCK_UNLOCK_RD(query_block);
       DBUG_RETURN(-1);				// Privilege error
@@ -998,7 +1399,7 @@ Query_cache::send_result_to_client(THD *thd, char *sql, uint query_length)
   }
   move_to_query_list_end(query_block);
   hits++;
-  STRUCT_UNLOCK(&structure_guard_mutex);
+  STRUCT_UNLOCK(this);
 
   /*
     Send cached result to client
@@ -1025,171 +1426,37 @@ Query_cache::send_result_to_client(THD *thd, char *sql, uint query_length)
   DBUG_RETURN(1);				// Result sent to client
 
 err_unlock:
-  STRUCT_UNLOCK(&structure_guard_mutex);
+  STRUCT_UNLOCK(this);
 err:
   DBUG_RETURN(0);				// Query was not cached
 }
 
 
 /*
-  Remove all cached queries that uses any of the tables in the list
-*/
-
-void Query_cache::invalidate(THD *thd, TABLE_LIST *tables_used,
-			     my_bool using_transactions)
-{
-  DBUG_ENTER("Query_cache::invalidate (table list)");
-  if (query_cache_size > 0)
-  {
-    STRUCT_LOCK(&structure_guard_mutex);
-    if (query_cache_size > 0)
-    {
-      DUMP(this);
-
-      using_transactions = using_transactions &&
-	(thd->options & (OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN));
-      for (; tables_used; tables_used=tables_used->next)
-      {
-	DBUG_ASSERT(!using_transactions || tables_used->table!=0);
-	if (using_transactions && 
-	   tables_used->table->file->has_transactions())
-	  /* 
-	     Tables_used->table can't be 0 in transaction.
-	     Only 'drop' invalidate not opened table, but 'drop' 
-	     force transaction finish.
-	  */
-	  thd->add_changed_table(tables_used->table);
-	else
-	  invalidate_table(tables_used);
-      }
-    }
-    STRUCT_UNLOCK(&structure_guard_mutex);
-  }
-  DBUG_VOID_RETURN;
-}
-
-void Query_cache::invalidate(CHANGED_TABLE_LIST *tables_used)
-{
-  DBUG_ENTER("Query_cache::invalidate (changed table list)");
-  if (query_cache_size > 0 && tables_used)
-  {
-    STRUCT_LOCK(&structure_guard_mutex);
-    if (query_cache_size > 0)
-    {
-      DUMP(this);
-      for (; tables_used; tables_used=tables_used->next)
-      {
-	invalidate_table((byte*) tables_used->key, tables_used->key_length);
-	DBUG_PRINT("qcache", (" db %s, table %s", tables_used->key,
-			      tables_used->key+
-			      strlen(tables_used->key)+1));
-      }
-    }
-    STRUCT_UNLOCK(&structure_guard_mutex);
-  }
-  DBUG_VOID_RETURN;
-}
-
-/*
-  Remove all cached queries that uses the given table
+  Remove all cached queries that uses any table
+  The partition must be locked
 */
 
-void Query_cache::invalidate(THD *thd, TABLE *table, 
-			     my_bool using_transactions)
+void Query_cache_part::invalidate_all()
 {
-  DBUG_ENTER("Query_cache::invalidate (table)");
-  
+  DBUG_ENTER("Query_cache_part::invalidate_all");
   if (query_cache_size > 0)
   {
-    STRUCT_LOCK(&structure_guard_mutex);
-    if (query_cache_size > 0)
-    {
-      using_transactions = using_transactions &&
-	(thd->options & (OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN));
-      if (using_transactions && table->file->has_transactions())
-	thd->add_changed_table(table);
-      else
-	invalidate_table(table);
-    }
-    STRUCT_UNLOCK(&structure_guard_mutex);
-  }
-  DBUG_VOID_RETURN;
-}
-
-void Query_cache::invalidate(THD *thd, const char *key, uint32  key_length,
-			     my_bool using_transactions)
-{
-  DBUG_ENTER("Query_cache::invalidate (key)");
-  
-  if (query_cache_size > 0)
-  {
-    using_transactions = using_transactions &&
-      (thd->options & (OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN));
-    if (using_transactions) // used for innodb => has_transactions() is TRUE
-      thd->add_changed_table(key, key_length);
-    else
-    {
-      STRUCT_LOCK(&structure_guard_mutex);
-      if (query_cache_size > 0)
-	invalidate_table((byte*)key, key_length);
-      STRUCT_UNLOCK(&structure_guard_mutex);  
-    }
-  }
-  DBUG_VOID_RETURN;
-}
-
-/*
-  Remove all cached queries that uses the given database
-*/
-
-void Query_cache::invalidate(char *db)
-{
-  DBUG_ENTER("Query_cache::invalidate (db)");
-  if (query_cache_size > 0)
-  {
-    STRUCT_LOCK(&structure_guard_mutex);
-    if (query_cache_size > 0)
-    {
-      DUMP(this);
-	/* invalidate_table reduce list while only root of list remain */
-      while (tables_blocks !=0 )
-	invalidate_table(tables_blocks);
-    }
-    STRUCT_UNLOCK(&structure_guard_mutex);
+    DUMP(this);
+    /* invalidate_table reduce list while only root of list remain */
+    while (tables_blocks !=0 )
+      invalidate_table(tables_blocks);
   }
   DBUG_VOID_RETURN;
 }
 
 
-void Query_cache::invalidate_by_MyISAM_filename(const char *filename)
-{
-  DBUG_ENTER("Query_cache::invalidate_by_MyISAM_filename");
-  if (query_cache_size > 0)
-  {
-    /* Calculate the key outside the lock to make the lock shorter */
-    char key[MAX_DBKEY_LENGTH];
-    uint32 db_length;
-    uint key_length= filename_2_table_key(key, filename, &db_length);
-    STRUCT_LOCK(&structure_guard_mutex);
-    if (query_cache_size > 0)			// Safety if cache removed
-    {
-      Query_cache_block *table_block;
-      if ((table_block = (Query_cache_block*) hash_search(&tables,
-							  (byte*) key,
-							  key_length)))
-	invalidate_table(table_block);
-    }
-    STRUCT_UNLOCK(&structure_guard_mutex);
-  }
-  DBUG_VOID_RETURN;
-}
-
   /* Remove all queries from cache */
 
-void Query_cache::flush()
+void Query_cache_part::flush()
 {
-  DBUG_ENTER("Query_cache::flush");
-  STRUCT_LOCK(&structure_guard_mutex);
+  DBUG_ENTER("Query_cache_part::flush");
+  STRUCT_LOCK(this);
   if (query_cache_size > 0)
   {
     DUMP(this);
@@ -1197,16 +1464,16 @@ void Query_cache::flush()
     DUMP(this);
   }
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
-  STRUCT_UNLOCK(&structure_guard_mutex);
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
+  STRUCT_UNLOCK(this);
   DBUG_VOID_RETURN;
 }
 
   /* Join result in cache in 1 block (if result length > join_limit) */
 
-void Query_cache::pack(ulong join_limit, uint iteration_limit)
+void Query_cache_part::pack(ulong join_limit, uint iteration_limit)
 {
-  DBUG_ENTER("Query_cache::pack");
+  DBUG_ENTER("Query_cache_part::pack");
   uint i = 0;
   do
   {
@@ -1216,9 +1483,9 @@ void Query_cache::pack(ulong join_limit, uint iteration_limit)
 }
 
 
-void Query_cache::destroy()
+void Query_cache_part::destroy()
 {
-  DBUG_ENTER("Query_cache::destroy");
+  DBUG_ENTER("Query_cache_part::destroy");
   if (!initialized)
   {
     DBUG_PRINT("qcache", ("Query Cache not initialized"));
@@ -1237,26 +1504,26 @@ void Query_cache::destroy()
   init/destroy
 *****************************************************************************/
 
-void Query_cache::init()
+void Query_cache_part::init()
 {
-  DBUG_ENTER("Query_cache::init");
+  DBUG_ENTER("Query_cache_part::init");
   pthread_mutex_init(&structure_guard_mutex,MY_MUTEX_INIT_FAST);
   initialized = 1;
   DBUG_VOID_RETURN;
 }
 
 
-ulong Query_cache::init_cache()
+ulong Query_cache_part::init_cache()
 {
   uint mem_bin_count, num, step;
   ulong mem_bin_size, prev_size, inc;
   ulong additional_data_size, max_mem_bin_size, approx_additional_data_size;
   int align;
 
-  DBUG_ENTER("Query_cache::init_cache");
+  DBUG_ENTER("Query_cache_part::init_cache");
   if (!initialized)
     init();
-  approx_additional_data_size = (sizeof(Query_cache) +
+  approx_additional_data_size = (sizeof(Query_cache_part) +
 				 sizeof(gptr)*(def_query_hash_size+
 					       def_query_hash_size));
   if (query_cache_size < approx_additional_data_size)
@@ -1313,12 +1580,12 @@ ulong Query_cache::init_cache()
     goto err;
   query_cache_size -= additional_data_size;
 
-  STRUCT_LOCK(&structure_guard_mutex);
+  STRUCT_LOCK(this);
 
   if (!(cache = (byte *)
 	 my_malloc_lock(query_cache_size+additional_data_size, MYF(0))))
   {
-    STRUCT_UNLOCK(&structure_guard_mutex);
+    STRUCT_UNLOCK(this);
     goto err;
   }
 
@@ -1400,7 +1667,7 @@ ulong Query_cache::init_cache()
 
   queries_in_cache = 0;
   queries_blocks = 0;
-  STRUCT_UNLOCK(&structure_guard_mutex);
+  STRUCT_UNLOCK(this);
   DBUG_RETURN(query_cache_size +
 	      additional_data_size + approx_additional_data_size);
 
@@ -1412,9 +1679,9 @@ err:
 
 /* Disable the use of the query cache */
 
-void Query_cache::make_disabled()
+void Query_cache_part::make_disabled()
 {
-  DBUG_ENTER("Query_cache::make_disabled");
+  DBUG_ENTER("Query_cache_part::make_disabled");
   query_cache_size= 0;
   free_memory= 0;
   bins= 0;
@@ -1427,13 +1694,13 @@ void Query_cache::make_disabled()
 }
 
 
-void Query_cache::free_cache(my_bool destruction)
+void Query_cache_part::free_cache(my_bool destruction)
 {
-  DBUG_ENTER("Query_cache::free_cache");
+  DBUG_ENTER("Query_cache_part::free_cache");
   if (query_cache_size > 0)
   {
     if (!destruction)
-      STRUCT_LOCK(&structure_guard_mutex);
+      STRUCT_LOCK(this);
 
     flush_cache();
 #ifndef DBUG_OFF
@@ -1457,7 +1724,7 @@ void Query_cache::free_cache(my_bool destruction)
     hash_free(&queries);
     hash_free(&tables);
     if (!destruction)
-      STRUCT_UNLOCK(&structure_guard_mutex);
+      STRUCT_UNLOCK(this);
   }
   DBUG_VOID_RETURN;
 }
@@ -1470,7 +1737,7 @@ void Query_cache::free_cache(my_bool destruction)
   The following assumes we have a lock on the cache
 */
 
-void Query_cache::flush_cache()
+void Query_cache_part::flush_cache()
 {
   while (queries_blocks != 0)
   {
@@ -1484,9 +1751,9 @@ void Query_cache::flush_cache()
   Returns 1 if we couldn't remove anything
 */
 
-my_bool Query_cache::free_old_query()
+my_bool Query_cache_part::free_old_query()
 {
-  DBUG_ENTER("Query_cache::free_old_query");
+  DBUG_ENTER("Query_cache_part::free_old_query");
   if (queries_blocks)
   {
     /*
@@ -1528,9 +1795,9 @@ my_bool Query_cache::free_old_query()
   This function will remove (and destroy) the lock for the query.
 */
 
-void Query_cache::free_query(Query_cache_block *query_block)
+void Query_cache_part::free_query(Query_cache_block *query_block)
 {
-  DBUG_ENTER("Query_cache::free_query");
+  DBUG_ENTER("Query_cache_part::free_query");
   DBUG_PRINT("qcache", ("free query 0x%lx %lu bytes result",
 		      (ulong) query_block,
 		      query_block->query()->length() ));
@@ -1579,7 +1846,7 @@ void Query_cache::free_query(Query_cache_block *query_block)
 *****************************************************************************/
 
 Query_cache_block *
-Query_cache::write_block_data(ulong data_len, gptr data,
+Query_cache_part::write_block_data(ulong data_len, gptr data,
 			      ulong header_len,
 			      Query_cache_block::block_type type,
 			      TABLE_COUNTER_TYPE ntab,
@@ -1590,7 +1857,7 @@ Query_cache::write_block_data(ulong data_len, gptr data,
 			   header_len);
   ulong len = data_len + all_headers_len;
   ulong align_len= ALIGN_SIZE(len);
-  DBUG_ENTER("Query_cache::write_block_data");
+  DBUG_ENTER("Query_cache_part::write_block_data");
   DBUG_PRINT("qcache", ("data: %ld, header: %ld, all header: %ld",
 		      data_len, header_len, all_headers_len));
   Query_cache_block *block = allocate_block(max(align_len, 
@@ -1610,30 +1877,30 @@ Query_cache::write_block_data(ulong data_len, gptr data,
 
 
 /*
-  On success STRUCT_UNLOCK(&query_cache.structure_guard_mutex) will be done.
+  On success STRUCT_UNLOCK(this) will be done.
 */
 
 my_bool
-Query_cache::append_result_data(Query_cache_block **current_block,
+Query_cache_part::append_result_data(Query_cache_block **current_block,
 				ulong data_len, gptr data,
 				Query_cache_block *query_block)
 {
-  DBUG_ENTER("Query_cache::append_result_data");
+  DBUG_ENTER("Query_cache_part::append_result_data");
   DBUG_PRINT("qcache", ("append %lu bytes to 0x%lx query",
 		      data_len, query_block));
 
-  if (query_block->query()->add(data_len) > query_cache_limit)
+  if (query_block->query()->add(data_len) > query_cache.query_cache_limit)
   {
     DBUG_PRINT("qcache", ("size limit reached %lu > %lu",
 			query_block->query()->length(),
-			query_cache_limit));
+			query_cache.query_cache_limit));
     DBUG_RETURN(0);
   }
   if (*current_block == 0)
   {
     DBUG_PRINT("qcache", ("allocated first result data block %lu", data_len));
     /*
-      STRUCT_UNLOCK(&structure_guard_mutex) Will be done by
+      STRUCT_UNLOCK(this) Will be done by
       write_result_data if success;
     */
     DBUG_RETURN(write_result_data(current_block, data_len, data, query_block,
@@ -1667,7 +1934,7 @@ Query_cache::append_result_data(Query_cache_block **current_block,
 			data_len-last_block_free_space));
     Query_cache_block *new_block = 0;
     /*
-      On success STRUCT_UNLOCK(&structure_guard_mutex) will be done
+      On success STRUCT_UNLOCK(this) will be done
       by the next call
     */
     success = write_result_data(&new_block, data_len-last_block_free_space,
@@ -1684,7 +1951,7 @@ Query_cache::append_result_data(Query_cache_block **current_block,
   else
   {
     // It is success (nobody can prevent us write data)
-    STRUCT_UNLOCK(&structure_guard_mutex);
+    STRUCT_UNLOCK(this);
   }
 
   // Now finally write data to the last block
@@ -1701,12 +1968,12 @@ Query_cache::append_result_data(Query_cache_block **current_block,
 }
 
 
-my_bool Query_cache::write_result_data(Query_cache_block **result_block,
+my_bool Query_cache_part::write_result_data(Query_cache_block **result_block,
 				       ulong data_len, gptr data,
 				       Query_cache_block *query_block,
 				       Query_cache_block::block_type type)
 {
-  DBUG_ENTER("Query_cache::write_result_data");
+  DBUG_ENTER("Query_cache_part::write_result_data");
   DBUG_PRINT("qcache", ("data_len %lu",data_len));
 
   /*
@@ -1723,7 +1990,7 @@ my_bool Query_cache::write_result_data(Query_cache_block **result_block,
   if (success)
   {
     // It is success (nobody can prevent us write data)
-    STRUCT_UNLOCK(&structure_guard_mutex);
+    STRUCT_UNLOCK(this);
     byte *rest = (byte*) data;
     Query_cache_block *block = *result_block;
     uint headers_len = (ALIGN_SIZE(sizeof(Query_cache_block)) +
@@ -1764,16 +2031,16 @@ my_bool Query_cache::write_result_data(Query_cache_block **result_block,
   DBUG_RETURN(success);
 }
 
-inline ulong Query_cache::get_min_first_result_data_size()
+inline ulong Query_cache_part::get_min_first_result_data_size()
 {
   if (queries_in_cache < QUERY_CACHE_MIN_ESTIMATED_QUERIES_NUMBER)
     return min_result_data_size;
   ulong avg_result = (query_cache_size - free_memory) / queries_in_cache;
-  avg_result = min(avg_result, query_cache_limit);
+  avg_result = min(avg_result, query_cache.query_cache_limit);
   return max(min_result_data_size, avg_result);
 }
 
-inline ulong Query_cache::get_min_append_result_data_size()
+inline ulong Query_cache_part::get_min_append_result_data_size()
 {
   return min_result_data_size;
 }
@@ -1782,7 +2049,7 @@ inline ulong Query_cache::get_min_append_result_data_size()
   Allocate one or more blocks to hold data
 */
 
-my_bool Query_cache::allocate_data_chain(Query_cache_block **result_block,
+my_bool Query_cache_part::allocate_data_chain(Query_cache_block **result_block,
 					 ulong data_len,
 					 Query_cache_block *query_block,
 					 my_bool first_block_arg)
@@ -1791,7 +2058,7 @@ my_bool Query_cache::allocate_data_chain(Query_cache_block **result_block,
 			   ALIGN_SIZE(sizeof(Query_cache_result)));
   ulong len= data_len + all_headers_len;
   ulong align_len= ALIGN_SIZE(len);
-  DBUG_ENTER("Query_cache::allocate_data_chain");
+  DBUG_ENTER("Query_cache_part::allocate_data_chain");
   DBUG_PRINT("qcache", ("data_len %lu, all_headers_len %lu",
 		      data_len, all_headers_len));
 
@@ -1845,34 +2112,11 @@ my_bool Query_cache::allocate_data_chain(Query_cache_block **result_block,
 *****************************************************************************/
 
 /*
-  Invalidate the first table in the table_list
+  Invalidate all queries that uses a table
+  The partition must be locked
 */
 
-void Query_cache::invalidate_table(TABLE_LIST *table_list)
-{
-  if (table_list->table != 0)
-    invalidate_table(table_list->table);	// Table is open
-  else
-  {
-    char key[MAX_DBKEY_LENGTH];
-    uint key_length;
-    Query_cache_block *table_block;
-    key_length=(uint) (strmov(strmov(key,table_list->db)+1,
-			      table_list->real_name) -key)+ 1;
-
-    // We don't store temporary tables => no key_length+=4 ...
-    if ((table_block = (Query_cache_block*)
-	 hash_search(&tables,(byte*) key,key_length)))
-      invalidate_table(table_block);
-  }
-}
-
-void Query_cache::invalidate_table(TABLE *table)
-{
-  invalidate_table((byte*) table->table_cache_key, table->key_length);
-}
-
-void Query_cache::invalidate_table(byte * key, uint32  key_length)
+void Query_cache_part::invalidate_table(byte * key, uint32  key_length)
 {
   Query_cache_block *table_block;
   if ((table_block = ((Query_cache_block*)
@@ -1880,7 +2124,7 @@ void Query_cache::invalidate_table(byte * key, uint32  key_length)
     invalidate_table(table_block);
 }
 
-void Query_cache::invalidate_table(Query_cache_block *table_block)
+void Query_cache_part::invalidate_table(Query_cache_block *table_block)
 {
   Query_cache_block_table *list_root =	table_block->table(0);
   while (list_root->next != list_root)
@@ -1901,7 +2145,7 @@ void Query_cache::invalidate_table(Query_cache_block *table_block)
     tables_arg		Not used ?
 */
 
-my_bool Query_cache::register_all_tables(Query_cache_block *block,
+my_bool Query_cache_part::register_all_tables(Query_cache_block *block,
 					 TABLE_LIST *tables_used,
 					 TABLE_COUNTER_TYPE tables_arg)
 {
@@ -1965,11 +2209,11 @@ err:
 */
 
 my_bool
-Query_cache::insert_table(uint key_len, char *key,
+Query_cache_part::insert_table(uint key_len, char *key,
 			  Query_cache_block_table *node,
 			  uint32 db_length)
 {
-  DBUG_ENTER("Query_cache::insert_table");
+  DBUG_ENTER("Query_cache_part::insert_table");
   DBUG_PRINT("qcache", ("insert table node 0x%lx, len %d",
 		      (ulong)node, key_len));
 
@@ -2005,6 +2249,7 @@ Query_cache::insert_table(uint key_len, char *key,
     }
     char *db = header->db();
     header->table(db + db_length + 1);
+    table_map[Query_cache::table_map_pos((byte*) key, key_len)]++;
   }
 
   Query_cache_block_table *list_root = table_block->table(0);
@@ -2017,9 +2262,9 @@ Query_cache::insert_table(uint key_len, char *key,
 }
 
 
-void Query_cache::unlink_table(Query_cache_block_table *node)
+void Query_cache_part::unlink_table(Query_cache_block_table *node)
 {
-  DBUG_ENTER("Query_cache::unlink_table");
+  DBUG_ENTER("Query_cache_part::unlink_table");
   node->prev->next = node->next;
   node->next->prev = node->prev;
   Query_cache_block_table *neighbour = node->next;
@@ -2027,6 +2272,9 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
   {
     // list is empty (neighbor is root of list)
     Query_cache_block *table_block = neighbour->block();
+    uint key_length;
+    byte *key= query_cache_table_get_key((byte*) table_block, &key_length, 0);
+    table_map[Query_cache::table_map_pos(key, key_length)]--;
     double_linked_list_exclude(table_block,
 			       &tables_blocks);
     hash_delete(&tables,(byte *) table_block);
@@ -2040,22 +2288,22 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
 *****************************************************************************/
 
 Query_cache_block *
-Query_cache::allocate_block(ulong len, my_bool not_less, ulong min,
+Query_cache_part::allocate_block(ulong len, my_bool not_less, ulong min,
 			    my_bool under_guard)
 {
-  DBUG_ENTER("Query_cache::allocate_block");
+  DBUG_ENTER("Query_cache_part::allocate_block");
   DBUG_PRINT("qcache", ("len %lu, not less %d, min %lu, uder_guard %d",
 		      len, not_less,min,under_guard));
 
-  if (len >= min(query_cache_size, query_cache_limit))
+  if (len >= min(query_cache_size, query_cache.query_cache_limit))
   {
     DBUG_PRINT("qcache", ("Query cache hase only %lu memory and limit %lu",
-			query_cache_size, query_cache_limit));
+			query_cache_size, query_cache.query_cache_limit));
     DBUG_RETURN(0); // in any case we don't have such piece of memory
   }
 
   if (!under_guard)
-    STRUCT_LOCK(&structure_guard_mutex);
+    STRUCT_LOCK(this);
 
   /* Free old queries until we have enough memory to store this block */
   Query_cache_block *block;
@@ -2072,16 +2320,16 @@ Query_cache::allocate_block(ulong len, my_bool not_less, ulong min,
   }
 
   if (!under_guard)
-    STRUCT_UNLOCK(&structure_guard_mutex);
+    STRUCT_UNLOCK(this);
   DBUG_RETURN(block);
 }
 
 
 Query_cache_block *
-Query_cache::get_free_block(ulong len, my_bool not_less, ulong min)
+Query_cache_part::get_free_block(ulong len, my_bool not_less, ulong min)
 {
   Query_cache_block *block = 0, *first = 0;
-  DBUG_ENTER("Query_cache::get_free_block");
+  DBUG_ENTER("Query_cache_part::get_free_block");
   DBUG_PRINT("qcache",("length %lu, not_less %d, min %lu", len,
 		     (int)not_less, min));
 
@@ -2154,9 +2402,9 @@ Query_cache::get_free_block(ulong len, my_bool not_less, ulong min)
 }
 
 
-void Query_cache::free_memory_block(Query_cache_block *block)
+void Query_cache_part::free_memory_block(Query_cache_block *block)
 {
-  DBUG_ENTER("Query_cache::free_memory_block");
+  DBUG_ENTER("Query_cache_part::free_memory_block");
   block->used=0;
   DBUG_PRINT("qcache",("first_block 0x%lx, block 0x%lx, pnext 0x%lx pprev 0x%lx",
 		     (ulong) first_block, (ulong) block,block->pnext,
@@ -2171,9 +2419,9 @@ void Query_cache::free_memory_block(Query_cache_block *block)
 }
 
 
-void Query_cache::split_block(Query_cache_block *block, ulong len)
+void Query_cache_part::split_block(Query_cache_block *block, ulong len)
 {
-  DBUG_ENTER("Query_cache::split_block");
+  DBUG_ENTER("Query_cache_part::split_block");
   Query_cache_block *new_block = (Query_cache_block*)(((byte*) block)+len);
 
   new_block->init(block->length - len);
@@ -2199,11 +2447,11 @@ void Query_cache::split_block(Query_cache_block *block, ulong len)
 
 
 Query_cache_block *
-Query_cache::join_free_blocks(Query_cache_block *first_block_arg,
+Query_cache_part::join_free_blocks(Query_cache_block *first_block_arg,
 			      Query_cache_block *block_in_list)
 {
   Query_cache_block *second_block;
-  DBUG_ENTER("Query_cache::join_free_blocks");
+  DBUG_ENTER("Query_cache_part::join_free_blocks");
   DBUG_PRINT("qcache",
 	     ("join first 0x%lx, pnext 0x%lx, in list 0x%lx",
 	      (ulong) first_block_arg, (ulong) first_block_arg->pnext,
@@ -2224,11 +2472,11 @@ Query_cache::join_free_blocks(Query_cache_block *first_block_arg,
 }
 
 
-my_bool Query_cache::append_next_free_block(Query_cache_block *block,
+my_bool Query_cache_part::append_next_free_block(Query_cache_block *block,
 					    ulong add_size)
 {
   Query_cache_block *next_block = block->pnext;
-  DBUG_ENTER("Query_cache::append_next_free_block");
+  DBUG_ENTER("Query_cache_part::append_next_free_block");
   DBUG_PRINT("enter", ("block 0x%lx, add_size %lu", (ulong) block,
 		       add_size));
 
@@ -2252,9 +2500,9 @@ my_bool Query_cache::append_next_free_block(Query_cache_block *block,
 }
 
 
-void Query_cache::exclude_from_free_memory_list(Query_cache_block *free_block)
+void Query_cache_part::exclude_from_free_memory_list(Query_cache_block *free_block)
 {
-  DBUG_ENTER("Query_cache::exclude_from_free_memory_list");
+  DBUG_ENTER("Query_cache_part::exclude_from_free_memory_list");
   Query_cache_memory_bin *bin = *((Query_cache_memory_bin **)
 				  free_block->data());
   double_linked_list_exclude(free_block, &bin->free_blocks);
@@ -2266,9 +2514,9 @@ void Query_cache::exclude_from_free_memory_list(Query_cache_block *free_block)
   DBUG_VOID_RETURN;
 }
 
-void Query_cache::insert_into_free_memory_list(Query_cache_block *free_block)
+void Query_cache_part::insert_into_free_memory_list(Query_cache_block *free_block)
 {
-  DBUG_ENTER("Query_cache::insert_into_free_memory_list");
+  DBUG_ENTER("Query_cache_part::insert_into_free_memory_list");
   uint idx = find_bin(free_block->length);
   insert_into_free_memory_sorted_list(free_block, &bins[idx].free_blocks);
   /*
@@ -2284,9 +2532,9 @@ void Query_cache::insert_into_free_memory_list(Query_cache_block *free_block)
   DBUG_VOID_RETURN;
 }
 
-uint Query_cache::find_bin(ulong size)
+uint Query_cache_part::find_bin(ulong size)
 {
-  DBUG_ENTER("Query_cache::find_bin");
+  DBUG_ENTER("Query_cache_part::find_bin");
   // Binary search
   int left = 0, right = mem_bin_steps;
   do
@@ -2318,21 +2566,21 @@ uint Query_cache::find_bin(ulong size)
  Lists management
 *****************************************************************************/
 
-void Query_cache::move_to_query_list_end(Query_cache_block *query_block)
+void Query_cache_part::move_to_query_list_end(Query_cache_block *query_block)
 {
-  DBUG_ENTER("Query_cache::move_to_query_list_end");
+  DBUG_ENTER("Query_cache_part::move_to_query_list_end");
   double_linked_list_exclude(query_block, &queries_blocks);
   double_linked_list_simple_include(query_block, &queries_blocks);
   DBUG_VOID_RETURN;
 }
 
 
-void Query_cache::insert_into_free_memory_sorted_list(Query_cache_block *
+void Query_cache_part::insert_into_free_memory_sorted_list(Query_cache_block *
 						      new_block,
 						      Query_cache_block **
 						      list)
 {
-  DBUG_ENTER("Query_cache::insert_into_free_memory_sorted_list");
+  DBUG_ENTER("Query_cache_part::insert_into_free_memory_sorted_list");
   /*
      list sorted by size in ascendant order, because we need small blocks
      more frequently than bigger ones
@@ -2374,11 +2622,11 @@ void Query_cache::insert_into_free_memory_sorted_list(Query_cache_block *
 
 
 void
-Query_cache::double_linked_list_simple_include(Query_cache_block *point,
+Query_cache_part::double_linked_list_simple_include(Query_cache_block *point,
 						Query_cache_block **
 						list_pointer)
 {
-  DBUG_ENTER("Query_cache::double_linked_list_simple_include");
+  DBUG_ENTER("Query_cache_part::double_linked_list_simple_include");
   DBUG_PRINT("qcache", ("including block 0x%lx", (ulong) point));
   if (*list_pointer == 0)
     *list_pointer=point->next=point->prev=point;
@@ -2394,10 +2642,10 @@ Query_cache::double_linked_list_simple_include(Query_cache_block *point,
 }
 
 void
-Query_cache::double_linked_list_exclude(Query_cache_block *point,
+Query_cache_part::double_linked_list_exclude(Query_cache_block *point,
 					Query_cache_block **list_pointer)
 {
-  DBUG_ENTER("Query_cache::double_linked_list_exclude");
+  DBUG_ENTER("Query_cache_part::double_linked_list_exclude");
   DBUG_PRINT("qcache", ("excluding block 0x%lx, list 0x%lx",
 		      (ulong) point, (ulong) list_pointer));
   if (point->next == point)
@@ -2413,7 +2661,7 @@ Query_cache::double_linked_list_exclude(Query_cache_block *point,
 }
 
 
-void Query_cache::double_linked_list_join(Query_cache_block *head_tail,
+void Query_cache_part::double_linked_list_join(Query_cache_block *head_tail,
 					  Query_cache_block *tail_head)
 {
   Query_cache_block *head_head = head_tail->next,
@@ -2433,12 +2681,12 @@ void Query_cache::double_linked_list_join(Query_cache_block *head_tail,
   (query without tables are not cached)
 */
 
-TABLE_COUNTER_TYPE Query_cache::is_cacheable(THD *thd, uint32 query_len,
+TABLE_COUNTER_TYPE Query_cache_part::is_cacheable(THD *thd, uint32 query_len,
 					     char *query,
 					     LEX *lex, TABLE_LIST *tables_used)
 {
   TABLE_COUNTER_TYPE table_count = 0;
-  DBUG_ENTER("Query_cache::is_cacheable");
+  DBUG_ENTER("Query_cache_part::is_cacheable");
 
   if (lex->sql_command == SQLCOM_SELECT &&
       (thd->variables.query_cache_type == 1 ||
@@ -2506,11 +2754,11 @@ TABLE_COUNTER_TYPE Query_cache::is_cacheable(THD *thd, uint32 query_len,
   Packing
 *****************************************************************************/
 
-void Query_cache::pack_cache()
+void Query_cache_part::pack_cache()
 {
-  DBUG_ENTER("Query_cache::pack_cache");
-  STRUCT_LOCK(&structure_guard_mutex);
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_ENTER("Query_cache_part::pack_cache");
+  STRUCT_LOCK(this);
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
 
   byte *border = 0;
   Query_cache_block *before = 0;
@@ -2542,17 +2790,17 @@ void Query_cache::pack_cache()
     DUMP(this);
   }
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
-  STRUCT_UNLOCK(&structure_guard_mutex);
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
+  STRUCT_UNLOCK(this);
   DBUG_VOID_RETURN;
 }
 
 
-my_bool Query_cache::move_by_type(byte **border,
+my_bool Query_cache_part::move_by_type(byte **border,
 				  Query_cache_block **before, ulong *gap,
 				  Query_cache_block *block)
 {
-  DBUG_ENTER("Query_cache::move_by_type");
+  DBUG_ENTER("Query_cache_part::move_by_type");
 
   my_bool ok = 1;
   switch (block->type) {
@@ -2784,7 +3032,7 @@ my_bool Query_cache::move_by_type(byte **border,
 }
 
 
-void Query_cache::relink(Query_cache_block *oblock,
+void Query_cache_part::relink(Query_cache_block *oblock,
 			 Query_cache_block *nblock,
 			 Query_cache_block *next, Query_cache_block *prev,
 			 Query_cache_block *pnext, Query_cache_block *pprev)
@@ -2811,12 +3059,12 @@ void Query_cache::relink(Query_cache_block *oblock,
 }
 
 
-my_bool Query_cache::join_results(ulong join_limit)
+my_bool Query_cache_part::join_results(ulong join_limit)
 {
   my_bool has_moving = 0;
-  DBUG_ENTER("Query_cache::join_results");
+  DBUG_ENTER("Query_cache_part::join_results");
 
-  STRUCT_LOCK(&structure_guard_mutex);
+  STRUCT_LOCK(this);
   if (queries_blocks != 0)
   {
     Query_cache_block *block = queries_blocks;
@@ -2879,16 +3127,16 @@ my_bool Query_cache::join_results(ulong join_limit)
       block = block->next;
     } while ( block != queries_blocks );
   }
-  STRUCT_UNLOCK(&structure_guard_mutex);
+  STRUCT_UNLOCK(this);
   DBUG_RETURN(has_moving);
 }
 
 
-uint Query_cache::filename_2_table_key (char *key, const char *path,
+uint Query_cache_part::filename_2_table_key (char *key, const char *path,
 					uint32 *db_length)
 {
   char tablename[FN_REFLEN+2], *filename, *dbname;
-  DBUG_ENTER("Query_cache::filename_2_table_key");
+  DBUG_ENTER("Query_cache_part::filename_2_table_key");
 
   /* Safety if filename didn't have a directory name */
   tablename[0]= FN_LIBCHAR;
@@ -2923,10 +3171,10 @@ my_bool in_blocks(Query_cache_block * point) { return 0; }
 
 #else
 
-void Query_cache::wreck(uint line, const char *message)
+void Query_cache_part::wreck(uint line, const char *message)
 {
   THD *thd=current_thd;
-  DBUG_ENTER("Query_cache::wreck");
+  DBUG_ENTER("Query_cache_part::wreck");
   query_cache_size = 0;
   if (*message)
     DBUG_PRINT("error", (" %s", message));
@@ -2942,7 +3190,27 @@ void Query_cache::wreck(uint line, const char *message)
 }
 
 
-void Query_cache::bins_dump()
+void Query_cache::wreck(uint line, const char *message)
+{
+  DBUG_ENTER("Query_cache::wreck");
+  query_cache_size = 0;
+  for (uint i=0 ; i < max_partitions ; i++)
+    if (parts[i].query_cache_size > 0)
+      parts[i].wreck(line, message);
+  DBUG_VOID_RETURN;
+}
+
+
+my_bool Query_cache::check_integrity(bool not_locked)
+{
+  my_bool result = 0;
+  for (uint i=0 ; i < max_partitions ; i++)
+    result|= parts[i].check_integrity(not_locked);
+  return result;
+}
+
+
+void Query_cache_part::bins_dump()
 {
   uint i;
   
@@ -2985,7 +3253,7 @@ void Query_cache::bins_dump()
 }
 
 
-void Query_cache::cache_dump()
+void Query_cache_part::cache_dump()
 {
   if (!initialized)
   {
@@ -3011,7 +3279,7 @@ void Query_cache::cache_dump()
 }
 
 
-void Query_cache::queries_dump()
+void Query_cache_part::queries_dump()
 {
 
   if (!initialized)
@@ -3074,7 +3342,7 @@ void Query_cache::queries_dump()
 }
 
 
-void Query_cache::tables_dump()
+void Query_cache_part::tables_dump()
 {
   if (!initialized)
   {
@@ -3101,7 +3369,7 @@ void Query_cache::tables_dump()
 }
 
 
-my_bool Query_cache::check_integrity(bool not_locked)
+my_bool Query_cache_part::check_integrity(bool not_locked)
 {
   my_bool result = 0;
   uint i;
@@ -3113,7 +3381,7 @@ my_bool Query_cache::check_integrity(bool not_locked)
     DBUG_RETURN(0);
   }
   if (!not_locked)
-    STRUCT_LOCK(&structure_guard_mutex);
+    STRUCT_LOCK(this);
 
   if (hash_check(&queries))
   {
@@ -3359,12 +3627,12 @@ my_bool Query_cache::check_integrity(bool not_locked)
   }
   DBUG_ASSERT(result == 0);
   if (!not_locked)
-    STRUCT_UNLOCK(&structure_guard_mutex);
+    STRUCT_UNLOCK(this);
   DBUG_RETURN(result);
 }
 
 
-my_bool Query_cache::in_blocks(Query_cache_block * point)
+my_bool Query_cache_part::in_blocks(Query_cache_block * point)
 {
   my_bool result = 0;
   Query_cache_block *block = point;
@@ -3419,7 +3687,7 @@ err2:
 }
 
 
-my_bool Query_cache::in_list(Query_cache_block * root,
+my_bool Query_cache_part::in_list(Query_cache_block * root,
 			     Query_cache_block * point,
 			     const char *name)
 {
@@ -3488,7 +3756,7 @@ void dump_node(Query_cache_block_table * node,
 			(ulong) node->prev));
 }
 
-my_bool Query_cache::in_table_list(Query_cache_block_table * root,
+my_bool Query_cache_part::in_table_list(Query_cache_block_table * root,
 				   Query_cache_block_table * point,
 				   const char *name)
 {
@@ -63,11 +63,22 @@
 
 #define TABLE_COUNTER_TYPE uint
 
+/* Max number of independently locked parts of the query cache */
+#define QUERY_CACHE_MAX_PARTITIONS		64
+/* Use fewer partitions if a partition would get less memory than this */
+#define QUERY_CACHE_MIN_PARTITION_SIZE		(256*1024L)
+/*
+  Number of counters in a partition that tells if the partition may have
+  queries that use a table (see Query_cache_part::table_map)
+*/
+#define QUERY_CACHE_TABLE_MAP_SIZE		256
+
 struct Query_cache_block;
 struct Query_cache_block_table;
 struct Query_cache_table;
 struct Query_cache_query;
 struct Query_cache_result;
+class Query_cache_part;
 class Query_cache;
 
 
@@ -212,14 +223,29 @@ struct Query_cache_memory_bin_step
   }
 };
 
-class Query_cache
+/*
+  One partition of the query cache.
+  Each partition has its own memory, query and table hashes and
+  structure_guard_mutex. A query is always stored in the partition
+  given by the hash of the query text (see Query_cache::partition()).
+*/
+
+class Query_cache_part
 {
 public:
   /* Info */
-  ulong query_cache_size, query_cache_limit;
+  ulong query_cache_size;
   /* statistics */
   ulong free_memory, queries_in_cache, hits, inserts, refused,
     free_memory_blocks, total_blocks, lowmem_prunes;
+  ulong lock_waits;			// Times structure_guard_mutex was busy
+  /*
+    Number of cached tables per hash value of the table key
+    (see Query_cache::table_map_pos()). Updated under
+    structure_guard_mutex but read without it to skip partitions that
+    don't have queries that use a table that is invalidated.
+  */
+  uint table_map[QUERY_CACHE_TABLE_MAP_SIZE];
 
 protected:
   /*
@@ -229,6 +255,7 @@ protected:
     LOCK SEQUENCE (to prevent deadlocks):
       1. structure_guard_mutex
       2. query block (for operation inside query (query block/results))
+    A thread never has more than one structure_guard_mutex locked.
   */
   pthread_mutex_t structure_guard_mutex;
   byte *cache;					// cache memory
@@ -267,9 +294,6 @@ protected:
 			      ulong data_len,
 			      Query_cache_block *query_block,
 			      my_bool first_block);
-  void invalidate_table(TABLE_LIST *table);
-  void invalidate_table(TABLE *table);
-  void invalidate_table(byte *key, uint32  key_length);
   void invalidate_table(Query_cache_block *table_block);
   my_bool register_all_tables(Query_cache_block *block,
 			      TABLE_LIST *tables_used,
@@ -337,15 +361,32 @@ protected:
 				  LEX *lex, TABLE_LIST *tables_used);
  public:
 
-  Query_cache(ulong query_cache_limit = ULONG_MAX,
-	      ulong min_allocation_unit = QUERY_CACHE_MIN_ALLOCATION_UNIT,
+  Query_cache_part(ulong min_allocation_unit = QUERY_CACHE_MIN_ALLOCATION_UNIT,
 	      ulong min_result_data_size = QUERY_CACHE_MIN_RESULT_DATA_SIZE,
 	      uint def_query_hash_size = QUERY_CACHE_DEF_QUERY_HASH_SIZE,
 	      uint def_table_hash_size = QUERY_CACHE_DEF_TABLE_HASH_SIZE);
 
   /* resize query cache (return real query size, 0 if disabled) */
   ulong resize(ulong query_cache_size);
-  inline void result_size_limit(ulong limit){query_cache_limit=limit;}
+  /* Lock structure_guard_mutex and count if we had to wait for it */
+  inline void struct_lock()
+  {
+    if (pthread_mutex_trylock(&structure_guard_mutex))
+    {
+      pthread_mutex_lock(&structure_guard_mutex);
+      lock_waits++;
+    }
+  }
+  inline void struct_unlock()
+  {
+    pthread_mutex_unlock(&structure_guard_mutex);
+  }
+  /* Check if a block is in the memory of this partition */
+  inline my_bool in_cache_memory(gptr ptr)
+  {
+    return ((byte*) ptr >= (byte*) first_block &&
+	    (byte*) ptr < (byte*) first_block + query_cache_size);
+  }
 
   /* register query in cache */
   void store_query(THD *thd, TABLE_LIST *used_tables);
@@ -356,19 +397,11 @@ protected:
   */
   int send_result_to_client(THD *thd, char *query, uint query_length);
 
-  /* Remove all queries that uses any of the listed following tables */
-  void invalidate(THD* thd, TABLE_LIST *tables_used,
-		  my_bool using_transactions);
-  void invalidate(CHANGED_TABLE_LIST *tables_used);
-  void invalidate(THD* thd, TABLE *table, my_bool using_transactions);
-  void invalidate(THD *thd, const char *key, uint32  key_length,
-		  my_bool using_transactions);
-
-  /* Remove all queries that uses any of the tables in following database */
-  void invalidate(char *db);
+  /* Remove all queries that uses the table. Partition must be locked */
+  void invalidate_table(byte *key, uint32  key_length);
 
-  /* Remove all queries that uses any of the listed following table */
-  void invalidate_by_MyISAM_filename(const char *filename);
+  /* Remove all queries that uses any table */
+  void invalidate_all();
 
   void flush();
   void pack(ulong join_limit = QUERY_CACHE_PACK_LIMIT,
@@ -376,6 +409,7 @@ protected:
 
   void destroy();
 
+  friend class Query_cache;
   friend void query_cache_insert(NET *net, const char *packet, ulong length);
   friend void query_cache_end_of_result(NET *net);
   friend void query_cache_abort(NET *net);
@@ -399,6 +433,84 @@ protected:
   my_bool in_blocks(Query_cache_block * point);
 };
 
+
+/*
+  The query cache.
+  Splits the cache in query_cache_partitions Query_cache_part objects so
+  that lookups, inserts and invalidations of queries in different
+  partitions don't wait for each other.
+*/
+
+class Query_cache
+{
+public:
+  /* Info */
+  ulong query_cache_size, query_cache_limit;
+  /*
+    Statistics. These are sums over all partitions and are only
+    updated by update_stats()
+  */
+  ulong free_memory, queries_in_cache, hits, inserts, refused,
+    free_memory_blocks, total_blocks, lowmem_prunes, lock_waits;
+
+protected:
+  Query_cache_part parts[QUERY_CACHE_MAX_PARTITIONS];
+  uint partitions;				// Partitions in use
+  uint max_partitions;				// Partitions ever used
+
+  inline Query_cache_part *partition(const char *query, uint query_length);
+  void invalidate_table(TABLE_LIST *table);
+  void invalidate_table(TABLE *table);
+  void invalidate_table(byte *key, uint32  key_length);
+
+public:
+  Query_cache();
+  static uint table_map_pos(const byte *key, uint32 key_length);
+
+  /* resize query cache (return real query size, 0 if disabled) */
+  ulong resize(ulong query_cache_size);
+  inline void result_size_limit(ulong limit){query_cache_limit=limit;}
+
+  /* register query in cache */
+  void store_query(THD *thd, TABLE_LIST *used_tables);
+
+  /*
+    Check if the query is in the cache and if this is true send the
+    data to client.
+  */
+  int send_result_to_client(THD *thd, char *query, uint query_length);
+
+  /* Remove all queries that uses any of the listed following tables */
+  void invalidate(THD* thd, TABLE_LIST *tables_used,
+		  my_bool using_transactions);
+  void invalidate(CHANGED_TABLE_LIST *tables_used);
+  void invalidate(THD* thd, TABLE *table, my_bool using_transactions);
+  void invalidate(THD *thd, const char *key, uint32  key_length,
+		  my_bool using_transactions);
+
+  /* Remove all queries that uses any of the tables in following database */
+  void invalidate(char *db);
+
+  /* Remove all queries that uses any of the listed following table */
+  void invalidate_by_MyISAM_filename(const char *filename);
+
+  void flush();
+  void pack(ulong join_limit = QUERY_CACHE_PACK_LIMIT,
+	    uint iteration_limit = QUERY_CACHE_PACK_ITERATION);
+
+  void destroy();
+
+  /* Sum the statistics of the partitions / reset them for FLUSH STATUS */
+  void update_stats();
+  void reset_stats();
+
+  /* Find and lock the partition of the query that net is storing */
+  Query_cache_part *lock_writer_partition(NET *net);
+
+  void wreck(uint line, const char *message);
+  my_bool check_integrity(bool not_locked);
+};
+
 extern Query_cache query_cache;
 extern TYPELIB query_cache_type_typelib;
 void query_cache_end_of_result(NET *net);
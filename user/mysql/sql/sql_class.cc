@@ -27,6 +27,7 @@
 #endif
 
 #include "mysql_priv.h"
+#include "scheduler.h"
 #include "sql_acl.h"
 #include <m_ctype.h>
 #include <sys/stat.h>
@@ -90,6 +91,10 @@ THD::THD():user_time(0),fatal_error(0),last_insert_id_used(0),
   query_error=0;
   next_insert_id=last_insert_id=0;
   open_tables=temporary_tables=handler_tables=0;
+  prepared_stmts=0;
+  last_stmt_id=0;
+  binary_row_types=0;
+  binary_rows=0;
   current_tablenr=0;
   handler_items=0;
   tmp_table=0;
@@ -100,9 +105,12 @@ THD::THD():user_time(0),fatal_error(0),last_insert_id_used(0),
   current_linfo =  0;
   slave_thread = 0;
   slave_proxy_id = 0;
+  slave_worker = 0;
   file_id = 0;
   cond_count=0;
   mysys_var=0;
+  scheduler_next=0;
+  scheduler_idle=scheduler_logged_in=scheduler_in_poll=0;
 #ifndef DBUG_OFF
   dbug_sentry=THD_SENTRY_MAGIC;
 #endif  
@@ -119,6 +127,9 @@ THD::THD():user_time(0),fatal_error(0),last_insert_id_used(0),
   active_vio = 0;
 #endif  
   pthread_mutex_init(&LOCK_delete, MY_MUTEX_INIT_FAST);
+  cached_tables=0;
+  cached_tables_count=0;
+  pthread_mutex_init(&LOCK_cached_tables, MY_MUTEX_INIT_FAST);
 
   /* Variables with default values */
   proc_info="login";
@@ -221,6 +232,8 @@ void THD::cleanup(void)
     close_thread_tables(this);
   }
   close_temporary_tables(this);
+  close_cached_thread_tables(this);
+  free_prepared_statements(this);
   hash_free(&user_vars);
   if (global_read_lock)
     unlock_global_read_lock(this);
@@ -271,6 +284,7 @@ THD::~THD()
   free_root(&transaction.mem_root,MYF(0));
   mysys_var=0;					// Safety (shouldn't be needed)
   pthread_mutex_destroy(&LOCK_delete);
+  pthread_mutex_destroy(&LOCK_cached_tables);
 #ifndef DBUG_OFF
   dbug_sentry = THD_SENTRY_GONE;
 #endif  
@@ -285,6 +299,19 @@ void THD::awake(bool prepare_to_die)
 
   if (prepare_to_die)
     killed = 1;
+#ifndef EMBEDDED_LIBRARY
+  if (scheduler_idle)
+  {
+    /*
+      The connection is waiting for input in the pool-of-threads
+      scheduler; real_id and mysys_var belong to some other connection
+      now. Let the scheduler close the connection.
+    */
+    if (killed)
+      thread_scheduler.post_kill_notification(this);
+    return;
+  }
+#endif
   thr_alarm_kill(real_id);
 #ifdef SIGNAL_WITH_VIO_CLOSE
   close_active_vio();
@@ -479,18 +506,32 @@ bool select_send::send_data(List<Item> &items)
     DBUG_RETURN(0);
   }
   packet->length(0);				// Reset packet
-  Item *item;
-  while ((item=li++))
+  if (thd->binary_rows)
   {
-    if (item->send(thd, packet))
+    if (net_store_binary_row(thd,packet,items))
     {
       packet->free();				// Free used
       my_error(ER_OUT_OF_RESOURCES,MYF(0));
       DBUG_RETURN(1);
     }
   }
+  else
+  {
+    Item *item;
+    while ((item=li++))
+    {
+      if (item->send(thd, packet))
+      {
+	packet->free();				// Free used
+	my_error(ER_OUT_OF_RESOURCES,MYF(0));
+	DBUG_RETURN(1);
+      }
+    }
+  }
   thd->sent_row_count++;
+  uint profile_stage= thd->profiling.status("writing to net");
   bool error=my_net_write(&thd->net,(char*) packet->ptr(),packet->length());
+  thd->profiling.resume(profile_stage);
   DBUG_RETURN(error);
 }
 
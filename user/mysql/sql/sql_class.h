@@ -69,6 +69,19 @@ class MYSQL_LOG
   /* LOCK_log and LOCK_index are inited by init_pthread_objects() */
   pthread_mutex_t LOCK_log, LOCK_index;
   pthread_cond_t update_cond;
+  /*
+    Binlog group commit, see group_commit().  commit_seq counts the
+    transactions written to log_file and synced_seq those synced to disk
+    (both protected by LOCK_log).  flushed_seq counts those flushed with
+    the handler logs (protected by LOCK_group_commit).
+  */
+  pthread_mutex_t LOCK_group_commit;
+  pthread_cond_t COND_group_commit;
+  ulonglong commit_seq, synced_seq, flushed_seq;
+  ulonglong failed_seq_start, failed_seq_end;	// Groups that failed
+  int group_commit_errno;
+  bool group_commit_leader;			// A group is being flushed
+  bool group_handler_commit;			// Group committed in handler
   ulonglong bytes_written;
   time_t last_time,query_start;
   IO_CACHE log_file;
@@ -101,6 +114,8 @@ class MYSQL_LOG
   */
   ulong max_size;
   friend class Log_event;
+  bool sync_log(bool force);
+  bool group_commit(ulonglong seq);
 
 public:
   MYSQL_LOG();
@@ -243,8 +258,9 @@ public:
   List<key_part_spec> columns;
   const char *Name;
 
-  Key(enum Keytype type_par,const char *name_arg,List<key_part_spec> &cols)
-    :type(type_par), algorithm(HA_KEY_ALG_UNDEF), columns(cols), Name(name_arg)
+  Key(enum Keytype type_par, const char *name_arg, enum ha_key_alg alg_par,
+      List<key_part_spec> &cols)
+    :type(type_par), algorithm(alg_par), columns(cols), Name(name_arg)
   {}
   ~Key() {}
   const char *name() { return Name; }
@@ -291,6 +307,7 @@ public:
 
 
 class delayed_insert;
+class Prepared_statement;
 
 #define THD_SENTRY_MAGIC 0xfeedd1ff
 #define THD_SENTRY_GONE  0xdeadbeef
@@ -305,6 +322,7 @@ struct system_variables
   ha_rows max_join_size;
   ulong bulk_insert_buff_size;
   ulong join_buff_size;
+  ulong load_data_threads;
   ulong long_query_time;
   ulong max_allowed_packet;
   ulong max_heap_table_size;
@@ -319,9 +337,11 @@ struct system_variables
   ulong net_write_timeout;
   ulong net_retry_count;
   ulong query_cache_type;
+  ulong read_batch_rows;
   ulong read_buff_size;
   ulong read_rnd_buff_size;
   ulong sortbuff_size;
+  ulong sort_threads;
   ulong tmp_table_size;
   ulong tx_isolation;
   ulong table_type;
@@ -332,10 +352,13 @@ struct system_variables
   ulong query_prealloc_size;
   ulong trans_alloc_block_size;
   ulong trans_prealloc_size;
+  ulong profiling_history_size;
 
+  my_bool batched_key_access;
   my_bool log_warnings;
   my_bool low_priority_updates;
   my_bool new_mode;
+  my_bool profiling;
 
   CONVERT *convert_set;
 };
@@ -381,6 +404,7 @@ public:
   uint16 peer_port;
   /* Points to info-string that will show in SHOW PROCESSLIST */
   const char *proc_info;
+  PROFILING profiling;			// For SHOW PROFILE
   /* points to host if host is available, otherwise points to ip */
   const char *host_or_ip;
 
@@ -398,6 +422,13 @@ public:
      and are still in use by this thread
   */
   TABLE   *open_tables,*temporary_tables, *handler_tables;
+  /*
+    cached_tables - tables closed by earlier statements that this thread
+     keeps for open_table(); protected by LOCK_cached_tables
+  */
+  TABLE   *cached_tables;
+  uint	  cached_tables_count;
+  pthread_mutex_t LOCK_cached_tables;
   // TODO: document the variables below
   MYSQL_LOCK *lock,*locked_tables;
   ULL	  *ull;
@@ -411,6 +442,15 @@ public:
   const char *where;
   time_t     start_time,time_after_lock,user_time;
   time_t     connect_time,thr_create_time; // track down slow pthread_create
+  /*
+    State used by the pool-of-threads scheduler (see scheduler.cc).
+    scheduler_idle is set while the connection waits for client input
+    and no thread is attached to it; it is protected by LOCK_delete.
+  */
+  THD	     *scheduler_next;
+  ulonglong  scheduler_queue_time;
+  time_t     scheduler_idle_since;
+  bool	     scheduler_idle, scheduler_logged_in, scheduler_in_poll;
   thr_lock_type update_lock_default;
   delayed_insert *di;
   struct st_transactions {
@@ -434,6 +474,16 @@ public:
   } transaction;
   Item	     *free_list, *handler_items;
   Field      *dupp_field;
+  /*
+    Statements prepared with COM_PREPARE (see sql_prepare.cc).
+    binary_rows is set while COM_EXECUTE runs a statement; the result is
+    then sent with net_store_binary_row(), which uses the column types
+    that send_fields() stored in binary_row_types.
+  */
+  Prepared_statement *prepared_stmts;
+  ulong	     last_stmt_id;
+  uchar	     *binary_row_types;
+  bool	     binary_rows;
 #ifndef __WIN__
   sigset_t signals,block_signals;
 #endif
@@ -477,6 +527,8 @@ public:
   */
   ulong	     slave_proxy_id;
   NET*       slave_net;			// network connection from slave -> m.
+  /* Set in the worker threads of a parallel slave */
+  struct st_slave_worker *slave_worker;
    
   /* Used by the sys_var class to store temporary values */
   union
@@ -524,6 +576,12 @@ public:
     proc_info = old_msg;
     pthread_mutex_unlock(&mysys_var->mutex);
   }
+  /* Set proc_info; Starts a new stage in SHOW PROFILE */
+  inline void set_proc_info(const char *info)
+  {
+    proc_info= info;
+    profiling.status(info);
+  }
   inline time_t query_start() { query_start_used=1; return start_time; }
   inline void	set_time()    { if (user_time) start_time=time_after_lock=user_time; else time_after_lock=time(&start_time); }
   inline void	end_time()    { time(&start_time); }
@@ -825,6 +883,59 @@ public:
   friend int unique_write_to_ptrs(gptr key, element_count count, Unique *unique);
 };
 
+/*
+  Hash table for GROUP BY and COUNT(DISTINCT) on fixed length keys;
+  See aggr_hash.cc
+*/
+
+typedef struct st_aggr_hash_link
+{
+  struct st_aggr_hash_link *next;		/* In insertion order */
+  uint32 hashnr;
+} AGGR_HASH_LINK;
+
+class Aggr_hash :public Sql_alloc
+{
+  MEM_ROOT mem_root;
+  AGGR_HASH_LINK **slots, *first_link, **last_link;
+  uint key_length, data_length, element_length, slot_count;
+  ulong max_in_memory_size;
+  IO_CACHE *part_files;
+  ulonglong unique_elements;
+  bool spilled, unique_counted;
+
+  inline byte *link_key(AGGR_HASH_LINK *link)
+  { return (byte*) link + ALIGN_SIZE(sizeof(AGGR_HASH_LINK)); }
+  bool grow();
+  byte *find_or_insert(const byte *key, uint32 hashnr, bool *inserted);
+  IO_CACHE *open_partitions();
+  void close_partitions(IO_CACHE *files);
+  bool flush_to_partitions(IO_CACHE *files, uint level);
+  bool count_partition(IO_CACHE *file, uint level, ulonglong *count);
+
+public:
+  ulong elements;
+  Aggr_hash(uint key_length_arg, uint data_length_arg,
+	    ulong max_in_memory_size_arg);
+  ~Aggr_hash();
+  byte *find_or_insert(const byte *key, bool *inserted);
+  bool is_full();
+  void reset();
+  /* Iterate in insertion order; Returns the key, data is after it */
+  inline byte *first() { return first_link ? link_key(first_link) : 0; }
+  inline byte *next(byte *key)
+  {
+    AGGR_HASH_LINK *link=((AGGR_HASH_LINK*)
+			  (key - ALIGN_SIZE(sizeof(AGGR_HASH_LINK))))->next;
+    return link ? link_key(link) : 0;
+  }
+  inline byte *data(byte *key) { return key + key_length; }
+
+  bool unique_add(const byte *key);
+  bool unique_count(ulonglong *count);
+  bool unique_reset();
+};
+
 class multi_delete : public select_result
 {
   TABLE_LIST *delete_tables, *table_being_deleted;
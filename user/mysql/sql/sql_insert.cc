@@ -49,11 +49,11 @@ static void unlink_blobs(register TABLE *table);
 
 static int
 check_insert_fields(THD *thd,TABLE *table,List<Item> &fields,
-		    List<Item> &values, ulong counter)
+		    uint value_count, ulong counter)
 {
-  if (fields.elements == 0 && values.elements != 0)
+  if (fields.elements == 0 && value_count != 0)
   {
-    if (values.elements != table->fields)
+    if (value_count != table->fields)
     {
       my_printf_error(ER_WRONG_VALUE_COUNT_ON_ROW,
 		      ER(ER_WRONG_VALUE_COUNT_ON_ROW),
@@ -67,7 +67,7 @@ check_insert_fields(THD *thd,TABLE *table,List<Item> &fields,
   }
   else
   {						// Part field list
-    if (fields.elements != values.elements)
+    if (fields.elements != value_count)
     {
       my_printf_error(ER_WRONG_VALUE_COUNT_ON_ROW,
 		      ER(ER_WRONG_VALUE_COUNT_ON_ROW),
@@ -101,8 +101,17 @@ check_insert_fields(THD *thd,TABLE *table,List<Item> &fields,
 }
 
 
+/*
+  INSERT ... VALUES
+
+  The rows are given in two lists: literal_values has the first rows if
+  they were read by the lexer (see scan_insert_values()) and values_list
+  has the rows after them
+*/
+
 int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
-		 List<List_item> &values_list,enum_duplicates duplic)
+		 List<List_item> &values_list,
+		 List<INSERT_ROW> &literal_values, enum_duplicates duplic)
 {
   int error;
   /*
@@ -113,13 +122,16 @@ int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
   int log_on= DELAYED_LOG_UPDATE | DELAYED_LOG_BIN ;
 
   bool transactional_table, log_delayed, bulk_insert;
-  uint value_count;
-  ulong counter = 1;
+  uint value_count, row_count;
+  ulong counter = 0;
   ulonglong id;
   COPY_INFO info;
   TABLE *table;
   List_iterator_fast<List_item> its(values_list);
   List_item *values;
+  List_iterator_fast<INSERT_ROW> lits(literal_values);
+  INSERT_ROW *row;
+  Field **value_fields;
   char *query=thd->query;
   thr_lock_type lock_type = table_list->lock_type;
   DBUG_ENTER("mysql_insert");
@@ -166,25 +178,43 @@ int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
     DBUG_RETURN(-1);
   thd->proc_info="init";
   thd->used_tables=0;
-  values= its++;
-  if (check_insert_fields(thd,table,fields,*values,1) ||
-      setup_tables(table_list) || setup_fields(thd,table_list,*values,0,0,0))
+  row_count= literal_values.elements + values_list.elements;
+  value_count= (literal_values.elements ? literal_values.head()->elements :
+		values_list.head()->elements);
+  if (check_insert_fields(thd,table,fields,value_count,1) ||
+      setup_tables(table_list))
     goto abort;
-  value_count= values->elements;
+  while ((row = lits++))
+  {
+    counter++;
+    if (row->elements != value_count)
+      goto wrong_count;
+  }
   while ((values = its++))
   {
     counter++;
     if (values->elements != value_count)
-    {
-      my_printf_error(ER_WRONG_VALUE_COUNT_ON_ROW,
-		      ER(ER_WRONG_VALUE_COUNT_ON_ROW),
-		      MYF(0),counter);
-      goto abort;
-    }
+      goto wrong_count;
     if (setup_fields(thd,table_list,*values,0,0,0))
       goto abort;
   }
+  lits.rewind();
   its.rewind ();
+
+  /* The literal rows are stored directly in the fields */
+  value_fields= table->field;
+  if (literal_values.elements && fields.elements)
+  {
+    List_iterator_fast<Item> f(fields);
+    Item_field *field;
+    Field **ptr;
+    if (!(value_fields= ptr= (Field**) thd->alloc(sizeof(Field*)*
+						   (fields.elements+1))))
+      goto abort;
+    while ((field= (Item_field*) f++))
+      *ptr++= field->field;
+    *ptr= 0;
+  }
   /*
     Fill in the given fields and dump it to the table file
   */
@@ -192,7 +222,7 @@ int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
   info.records=info.deleted=info.copied=0;
   info.handle_duplicates=duplic;
   // Don't count warnings for simple inserts
-  if (values_list.elements > 1 || (thd->options & OPTION_WARNINGS))
+  if (row_count > 1 || (thd->options & OPTION_WARNINGS))
     thd->count_cuted_fields = 1;
   thd->cuted_fields = 0L;
   table->next_number_field=table->found_next_number_field;
@@ -203,25 +233,27 @@ int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
   if (duplic == DUP_IGNORE || duplic == DUP_REPLACE)
     table->file->extra(HA_EXTRA_IGNORE_DUP_KEY);
   if ((lock_type != TL_WRITE_DELAYED && !(specialflag & SPECIAL_SAFE_MODE)) &&
-      values_list.elements >= MIN_ROWS_TO_USE_BULK_INSERT)
+      row_count >= MIN_ROWS_TO_USE_BULK_INSERT)
   {
     table->file->extra_opt(HA_EXTRA_WRITE_CACHE,
 			   min(thd->variables.read_buff_size,
-			       table->avg_row_length*values_list.elements));
-    table->file->deactivate_non_unique_index(values_list.elements);
+			       table->avg_row_length*row_count));
+    table->file->deactivate_non_unique_index(row_count);
     bulk_insert=1;
   }
   else
     bulk_insert=0;
 
-  while ((values= its++))
+  while ((row= lits++) || (values= its++))
   {
     if (fields.elements || !value_count)
     {
       restore_record(table,2);			// Get empty record
-      if (fill_record(fields, *values, 0) || check_null_fields(thd,table))
+      if ((row ? fill_record(value_fields, row) :
+	   fill_record(fields, *values, 0)) ||
+	  check_null_fields(thd,table))
       {
-	if (values_list.elements != 1)
+	if (row_count != 1)
 	{
 	  info.records++;
 	  continue;
@@ -236,9 +268,10 @@ int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
 	restore_record(table,2);		// Get empty record
       else
 	table->record[0][0]=table->record[2][0]; // Fix delete marker
-      if (fill_record(table->field, *values, 0))
+      if (row ? fill_record(value_fields, row) :
+	  fill_record(table->field, *values, 0))
       {
-	if (values_list.elements != 1)
+	if (row_count != 1)
 	{
 	  info.records++;
 	  continue;
@@ -272,7 +305,7 @@ int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
     if (!error)
     {
       id=0;					// No auto_increment id
-      info.copied=values_list.elements;
+      info.copied=row_count;
       end_delayed_insert(thd);
     }
     query_cache_invalidate3(thd, table_list, 1);
@@ -298,7 +331,7 @@ int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
 	}
       }
     }
-    if (id && values_list.elements != 1)
+    if (id && row_count != 1)
       thd->insert_id(id);			// For update log
     else if (table->next_number_field)
       id=table->next_number_field->val_int();	// Return auto_increment value
@@ -344,7 +377,7 @@ int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
   if (error)
     goto abort;
 
-  if (values_list.elements == 1 && (!(thd->options & OPTION_WARNINGS) ||
+  if (row_count == 1 && (!(thd->options & OPTION_WARNINGS) ||
 				    !thd->cuted_fields))
     send_ok(&thd->net,info.copied+info.deleted,id);
   else
@@ -362,6 +395,10 @@ int mysql_insert(THD *thd,TABLE_LIST *table_list, List<Item> &fields,
   }
   DBUG_RETURN(0);
 
+wrong_count:
+  my_printf_error(ER_WRONG_VALUE_COUNT_ON_ROW,
+		  ER(ER_WRONG_VALUE_COUNT_ON_ROW),
+		  MYF(0),counter);
 abort:
   if (lock_type == TL_WRITE_DELAYED)
     end_delayed_insert(thd);
@@ -1295,7 +1332,7 @@ select_insert::prepare(List<Item> &values)
 {
   DBUG_ENTER("select_insert::prepare");
 
-  if (check_insert_fields(thd,table,*fields,values,1))
+  if (check_insert_fields(thd,table,*fields,values.elements,1))
     DBUG_RETURN(1);
 
   restore_record(table,2);			// Get empty record
@@ -152,6 +152,8 @@ LEX *lex_start(THD *thd, uchar *buf,uint length)
   lex->ignore_space=test(thd->sql_mode & MODE_IGNORE_SPACE);
   lex->slave_thd_opt=0;
   lex->sql_command=SQLCOM_END;
+  lex->param_list.empty();
+  lex->literal_values.empty();
   bzero((char *)&lex->mi,sizeof(lex->mi));
   return lex;
 }
@@ -415,6 +417,171 @@ inline static uint int_token(const char *str,uint length)
 }
 
 
+static void skip_space(LEX *lex)
+{
+  uchar c;
+  for (c=yyGet() ; state_map[c] == STATE_SKIP ; c=yyGet())
+  {
+    if (c == '\n')
+      lex->yylineno++;
+  }
+  yyUnget();
+}
+
+
+/*
+  Read a literal for scan_insert_values()
+  Returns 0 if the value is not a literal that we handle here
+*/
+
+static bool scan_insert_literal(LEX *lex, INSERT_LITERAL *value)
+{
+  uchar c, *start=lex->ptr;
+
+  switch (state_map[c=yyGet()]) {
+  case STATE_STRING:
+    lex->tok_start=start;
+    if (!(value->str=get_text(lex)))
+      return 0;					// Unexpected end of query
+    value->length=lex->yytoklen;
+    value->type=INSERT_LITERAL_STRING;
+    return 1;
+  case STATE_ESCAPE:				// \N
+    if (yyGet() != 'N')
+      return 0;
+    value->type=INSERT_LITERAL_NULL;
+    break;
+  case STATE_IDENT:
+    if ((c != 'N' && c != 'n') || lex->end_of_query - start < 4 ||
+	my_casecmp((char*) start, "NULL", 4))
+      return 0;
+    lex->ptr=start+4;
+    value->type=INSERT_LITERAL_NULL;
+    break;
+  case STATE_SIGNED_NUMBER:
+    if (!isdigit(yyPeek()))
+      return 0;					// Operator or comment
+    /* fall through */
+  case STATE_NUMBER_IDENT:
+    value->type=INSERT_LITERAL_INT;
+    while (isdigit(c=yyGet())) ;
+    if (c == '.')
+    {
+      value->type=INSERT_LITERAL_REAL;
+      while (isdigit(c=yyGet())) ;
+    }
+    if (c == 'e' || c == 'E')
+    {
+      c=yyGet();
+      if (c == '-' || c == '+')
+	c=yyGet();
+      if (!isdigit(c))
+	return 0;
+      while (isdigit(c=yyGet())) ;
+      value->type=INSERT_LITERAL_REAL;
+    }
+    yyUnget();
+    value->str=(char*) start;
+    value->length=(uint) (lex->ptr - start);
+    /* Numbers that the parser makes to Item_uint are left to it */
+    if (value->type == INSERT_LITERAL_INT)
+    {
+      switch (int_token(value->str, value->length)) {
+      case NUM:
+      case LONG_NUM:
+	break;
+      case REAL_NUM:
+	value->type=INSERT_LITERAL_REAL;
+	break;
+      default:
+	return 0;
+      }
+    }
+    break;
+  default:
+    return 0;
+  }
+  /* Check that the value doesn't continue as an identifier, as in 1abc */
+  c=yyPeek();
+  return !(state_map[c] == STATE_IDENT || state_map[c] == STATE_NUMBER_IDENT ||
+	   c == '.');
+}
+
+
+/*
+  Read the rows of INSERT ... VALUES that have only literals
+
+  SYNOPSIS
+    scan_insert_values()
+    lex		lex->ptr is after VALUES
+
+  DESCRIPTION
+    Making an Item of each value of a big multi-row INSERT costs more than
+    storing the row. This reads rows like (1,-2.5,'abc',NULL) directly into
+    lex->literal_values and stops at the first row that has anything else.
+    lex->ptr is then set before the ',' in front of that row, and the parser
+    reads the rest of the rows as usual (see insert_values in sql_yacc.yy).
+    The numbers are typed as in yylex(); fill_record() stores the values
+    as the Items that the parser would have made would store them.
+*/
+
+static void scan_insert_values(LEX *lex)
+{
+  THD *thd=lex->thd;
+  uchar *row_end=lex->ptr;
+  uint row_lineno=lex->yylineno, count, max_count=16;
+  INSERT_LITERAL *values;
+  INSERT_ROW *row;
+
+  if (!(values=(INSERT_LITERAL*) thd->alloc(sizeof(*values)*max_count)))
+    return;
+  for (;;)
+  {
+    skip_space(lex);
+    if (yyGet() != '(')
+      break;
+    for (count=0 ;; )
+    {
+      if (count == max_count)
+      {
+	INSERT_LITERAL *tmp;
+	if (!(tmp=(INSERT_LITERAL*) thd->alloc(sizeof(*values)*max_count*2)))
+	  goto end;
+	memcpy((char*) tmp, (char*) values, sizeof(*values)*count);
+	values=tmp;
+	max_count*=2;
+      }
+      skip_space(lex);
+      if (!scan_insert_literal(lex, values+count))
+	goto end;
+      count++;
+      skip_space(lex);
+      uchar c=yyGet();
+      if (c == ')')
+	break;
+      if (c != ',')
+	goto end;
+    }
+    if (!(row=(INSERT_ROW*) thd->alloc(sizeof(INSERT_ROW)+
+				       sizeof(*values)*count)))
+      goto end;
+    row->values=(INSERT_LITERAL*) (row+1);
+    row->elements=count;
+    memcpy((char*) row->values, (char*) values, sizeof(*values)*count);
+    if (lex->literal_values.push_back(row))
+      goto end;
+    row_end=lex->ptr;
+    row_lineno=lex->yylineno;
+    skip_space(lex);
+    if (yyGet() != ',')
+      break;
+  }
+end:
+  lex->ptr=row_end;
+  lex->yylineno=row_lineno;
+}
+
+
 // yylex remember the following states from the following yylex()
 // STATE_EOQ ; found end of query
 // STATE_OPERATOR_OR_IDENT ; last state was an ident, text or number
@@ -518,6 +685,10 @@ int yylex(void *arg)
 	if ((tokval = find_keyword(lex,length,c == '(')))
 	{
 	  lex->next_state= STATE_START;	// Allow signed numbers
+	  if (tokval == VALUES &&
+	      (lex->sql_command == SQLCOM_INSERT ||
+	       lex->sql_command == SQLCOM_REPLACE))
+	    scan_insert_values(lex);
 	  return(tokval);		// Was keyword
 	}
 	yySkip();			// next state does a unget
@@ -64,7 +64,8 @@ enum enum_sql_command {
   SQLCOM_HA_OPEN, SQLCOM_HA_CLOSE, SQLCOM_HA_READ,
   SQLCOM_SHOW_SLAVE_HOSTS, SQLCOM_DELETE_MULTI, SQLCOM_MULTI_UPDATE,
   SQLCOM_SHOW_BINLOG_EVENTS, SQLCOM_SHOW_NEW_MASTER, SQLCOM_DO,
-  SQLCOM_EMPTY_QUERY,
+  SQLCOM_EMPTY_QUERY, SQLCOM_SHOW_SLAVE_WORKERS,
+  SQLCOM_SHOW_PROFILES, SQLCOM_SHOW_PROFILE,
   SQLCOM_END
 };
 
@@ -82,6 +83,31 @@ enum lex_states
 
 typedef List<Item> List_item;
 
+/*
+  A row of INSERT ... VALUES that has only literals. These rows are read
+  by the lexer and stored in the fields by mysql_insert() without making
+  an Item of each value; See scan_insert_values() in sql_lex.cc
+*/
+
+enum enum_insert_literal
+{
+  INSERT_LITERAL_NULL, INSERT_LITERAL_INT, INSERT_LITERAL_REAL,
+  INSERT_LITERAL_STRING
+};
+
+typedef struct st_insert_literal
+{
+  const char *str;			/* Unescaped string or number text */
+  uint length;
+  enum enum_insert_literal type;
+} INSERT_LITERAL;
+
+typedef struct st_insert_row
+{
+  INSERT_LITERAL *values;
+  uint elements;
+} INSERT_ROW;
+
 typedef struct st_lex_master_info
 {
   char *host, *user, *password, *log_file_name;
@@ -152,7 +178,9 @@ typedef struct st_lex
   List<create_field>  create_list;
   List<Item>	      *insert_list,field_list,value_list;
   List<List_item>     many_values;
+  List<INSERT_ROW>    literal_values;		/* Rows read by the lexer */
   List<set_var_base>  var_list;
+  List<Item>	      param_list;		/* '?' of a prepared statement */
   SQL_LIST	      proc_list, auxilliary_table_list, save_list;
   TYPELIB	      *interval;
   create_field	      *last_field;
@@ -169,6 +197,7 @@ typedef struct st_lex
   LEX_MASTER_INFO mi;				// used by CHANGE MASTER
   USER_RESOURCES mqh;
   ulong thread_id,type;
+  ulong profile_query_id;			// SHOW PROFILE FOR QUERY #
   enum_sql_command sql_command;
   enum lex_states next_state;
   enum enum_duplicates duplicates;
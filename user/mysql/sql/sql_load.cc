@@ -34,9 +34,13 @@ class READ_INFO {
   int	*stack,*stack_pos;
   bool	found_end_of_line,start_of_line,eof;
   bool  need_end_io_cache;
+  bool	in_memory;			/* Reads text given to set_data() */
   IO_CACHE cache;
   NET *io_net;
 
+  void init(uint tot_length, String &field_term, String &line_start,
+	    String &line_term, String &enclosed);
+
 public:
   bool error,line_cuted,found_null,enclosed;
   byte	*row_start,			/* Found row starts here */
@@ -45,7 +49,11 @@ public:
   READ_INFO(File file,uint tot_length,
 	    String &field_term,String &line_start,String &line_term,
 	    String &enclosed,int escape,bool get_it_from_net, bool is_fifo);
+  READ_INFO(uint tot_length, String &field_term, String &line_start,
+	    String &line_term, String &enclosed, int escape);
   ~READ_INFO();
+  void set_data(byte *data, uint length);
+  uint read_block(byte *to, uint length);
   int read_field();
   int read_fixed_length(void);
   int next_line(void);
@@ -75,6 +83,13 @@ static int read_fixed_length(THD *thd,COPY_INFO &info,TABLE *table,
 static int read_sep_field(THD *thd,COPY_INFO &info,TABLE *table,
 			  List<Item> &fields, READ_INFO &read_info,
 			  String &enclosed);
+#ifdef THREAD
+static bool load_lines_can_be_split(sql_exchange *ex, int escape_char);
+static int read_sep_field_threads(THD *thd, COPY_INFO &info, TABLE *table,
+				  List<Item> &fields, READ_INFO &read_info,
+				  sql_exchange *ex, uint tot_length,
+				  uint thread_count);
+#endif
 
 
 int mysql_load(THD *thd,sql_exchange *ex,TABLE_LIST *table_list,
@@ -261,6 +276,13 @@ int mysql_load(THD *thd,sql_exchange *ex,TABLE_LIST *table_list,
     table->copy_blobs=1;
     if (!field_term->length() && !enclosed->length())
       error=read_fixed_length(thd,info,table,fields,read_info);
+#ifdef THREAD
+    else if (thd->variables.load_data_threads > 1 &&
+	     load_lines_can_be_split(ex,info.escape_char))
+      error=read_sep_field_threads(thd,info,table,fields,read_info,ex,
+				   tot_length,
+				   (uint) thd->variables.load_data_threads);
+#endif
     else
       error=read_sep_field(thd,info,table,fields,read_info,*enclosed);
     if (table->file->extra(HA_EXTRA_NO_CACHE))
@@ -441,6 +463,22 @@ read_fixed_length(THD *thd,COPY_INFO &info,TABLE *table,List<Item> &fields,
 
 
 
+/* Store a NULL from the file; NOT NULL fields get their default value */
+
+static void set_field_to_load_null(THD *thd, TABLE *table, Field *field)
+{
+  field->reset();
+  field->set_null();
+  if (!field->maybe_null())
+  {
+    if (field->type() == FIELD_TYPE_TIMESTAMP)
+      ((Field_timestamp*) field)->set_time();
+    else if (field != table->next_number_field)
+      thd->cuted_fields++;
+  }
+}
+
+
 static int
 read_sep_field(THD *thd,COPY_INFO &info,TABLE *table,
 	       List<Item> &fields, READ_INFO &read_info,
@@ -477,15 +515,7 @@ read_sep_field(THD *thd,COPY_INFO &info,TABLE *table,
 	  (enclosed_length && length == 4 && !memcmp(pos,"NULL",4)) ||
 	  (length == 1 && read_info.found_null))
       {
-	field->reset();
-	field->set_null();
-	if (!field->maybe_null())
-	{
-	  if (field->type() == FIELD_TYPE_TIMESTAMP)
-	    ((Field_timestamp*) field)->set_time();
-	  else if (field != table->next_number_field)
-	    thd->cuted_fields++;
-	}
+	set_field_to_load_null(thd,table,field);
 	continue;
       }
       field->set_notnull();
@@ -528,6 +558,500 @@ read_sep_field(THD *thd,COPY_INFO &info,TABLE *table,
 }
 
 
+#ifdef THREAD
+
+/****************************************************************************
+** Parsing of lines in several threads
+**
+** The connection thread reads the file in chunks that end after a line
+** terminator. The chunks are parsed by load_data_threads threads into
+** rows of field values, which the connection thread then stores in the
+** table in file order. Reading the file and storing the rows are not
+** done in the parser threads: the file may come from the client and is
+** logged to the binary log block by block, and Field::store() and
+** write_record() need the THD. Only the chunks in the ring of
+** LOAD_THREADS are read ahead; if no parser has taken the next chunk to
+** store, the connection thread parses it itself.
+****************************************************************************/
+
+#define LOAD_NULL_FIELD		((uint32) ~0)	/* Length of a NULL field */
+#define LOAD_ROW_CUTED		1		/* Row flag: Line was too long */
+
+typedef struct st_load_chunk
+{
+  byte *text;				/* Text read from the file */
+  uint text_size;
+  uint read_length;			/* Bytes in text */
+  uint text_length;			/* Whole lines in text */
+  byte *rows;				/* See parse_load_chunk() */
+  uint rows_size, rows_length;
+  bool parsed, error;
+} LOAD_CHUNK;
+
+typedef struct st_load_threads
+{
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;			/* Signaled on any change below */
+  LOAD_CHUNK *chunks;			/* Ring of chunk_count chunks */
+  uint chunk_count;
+  ulong next_read, next_parse, next_store;	/* Chunk numbers */
+  uint running;				/* Parser threads */
+  bool end_of_file, abort;
+  sql_exchange *ex;
+  uint tot_length, field_count;
+  int escape_char;
+} LOAD_THREADS;
+
+
+/*
+  Check if lines can be found without parsing the fields
+
+  Enclosed fields and multi-byte characters can hide a line terminator,
+  and LINES STARTING BY can start a line in the middle of the text.
+  A line terminator is escaped if it follows an odd number of escape
+  characters, which is true only if the terminators share no characters.
+*/
+
+static bool load_lines_can_be_split(sql_exchange *ex, int escape_char)
+{
+  String *field_term=ex->field_term, *line_term=ex->line_term;
+  if (ex->enclosed->length() || ex->line_start->length() ||
+      !field_term->length() || !line_term->length() ||
+      use_mb(default_charset_info))
+    return 0;
+  for (uint i=0 ; i < line_term->length() ; i++)
+  {
+    char chr=(*line_term)[i];
+    if ((int) (uchar) chr == escape_char ||
+	memchr(field_term->ptr(),chr,field_term->length()) ||
+	(i && chr == (*line_term)[0]))
+      return 0;
+  }
+  return 1;
+}
+
+
+/* Find the end of the last line in text; Returns 0 if there is none */
+
+static uint find_last_line_end(byte *text, uint length, String *line_term,
+			       int escape_char)
+{
+  const char *term=line_term->ptr();
+  uint term_length=line_term->length();
+  byte *pos,*esc;
+  if (length < term_length)
+    return 0;
+  for (pos=text+length-term_length ;; pos--)
+  {
+    if (*pos == (byte) term[0] && !memcmp(pos,term,term_length))
+    {
+      for (esc=pos ; esc != text && (int) (uchar) esc[-1] == escape_char ;
+	   esc--) ;
+      if (!((pos-esc) & 1))
+	return (uint) (pos-text)+term_length;
+    }
+    if (pos == text)
+      return 0;
+  }
+}
+
+
+/*
+  Read the next chunk of whole lines
+
+  SYNOPSIS
+    read_load_chunk()
+    read_info		Reads the file
+    load		Parallel load
+    chunk		Chunk to fill
+    prev		Last chunk read, or 0. The text after its last line
+			starts the chunk
+
+  RETURN
+    0	ok; chunk->read_length is 0 at end of file
+    1	Out of memory
+*/
+
+static bool read_load_chunk(READ_INFO &read_info, LOAD_THREADS *load,
+			    LOAD_CHUNK *chunk, LOAD_CHUNK *prev)
+{
+  uint length= prev ? prev->read_length - prev->text_length : 0;
+  uint size= length+LOAD_CHUNK_SIZE;
+
+  if (chunk->text_size < size)
+  {
+    my_free((gptr) chunk->text,MYF(MY_ALLOW_ZERO_PTR));
+    chunk->text_size=0;
+    if (!(chunk->text=(byte*) my_malloc(size,MYF(MY_WME))))
+      return 1;
+    chunk->text_size=size;
+  }
+  if (length)
+    memcpy(chunk->text,prev->text+prev->text_length,length);
+  for (;;)
+  {
+    length+=read_info.read_block(chunk->text+length,
+				 chunk->text_size-length);
+    if (length < chunk->text_size)
+    {						// End of file
+      chunk->read_length=chunk->text_length=length;
+      return 0;
+    }
+    if ((chunk->text_length=find_last_line_end(chunk->text,length,
+					       load->ex->line_term,
+					       load->escape_char)))
+      break;
+    /* No line ends in the chunk; Make room for a longer line */
+    size=chunk->text_size*2;
+    if (!(chunk->text=(byte*) my_realloc((gptr) chunk->text,size,
+					 MYF(MY_WME | MY_FREE_ON_ERROR))))
+    {
+      chunk->text_size=0;
+      return 1;
+    }
+    chunk->text_size=size;
+  }
+  chunk->read_length=length;
+  return 0;
+}
+
+
+/* Add length bytes to the rows of a chunk; Returns 0 if out of memory */
+
+static byte *alloc_load_row(LOAD_CHUNK *chunk, uint length)
+{
+  if (chunk->rows_length+length > chunk->rows_size)
+  {
+    uint size=max(chunk->rows_size*2,chunk->rows_length+length+IO_SIZE);
+    byte *rows;
+    if (!(rows=(byte*) my_realloc((gptr) chunk->rows,size,
+				  MYF(MY_ALLOW_ZERO_PTR))))
+      return 0;
+    chunk->rows=rows;
+    chunk->rows_size=size;
+  }
+  chunk->rows_length+=length;
+  return chunk->rows+chunk->rows_length-length;
+}
+
+
+/*
+  Parse the lines of a chunk into rows
+
+  NOTES
+    Does what read_sep_field() does before Field::store(). A row is
+    stored as the number of fields found (4 bytes) and the row flags
+    (1 byte), followed by each field as its length (4 bytes, or
+    LOAD_NULL_FIELD for NULL), its text and a '\0'.
+
+  RETURN
+    0	ok
+    1	Out of memory
+*/
+
+static bool parse_load_chunk(READ_INFO *read_info, LOAD_CHUNK *chunk,
+			     uint field_count)
+{
+  chunk->rows_length=0;
+  read_info->set_data(chunk->text,chunk->text_length);
+  for (;;)
+  {
+    uint row=chunk->rows_length,count;
+    bool end;
+    byte *pos;
+
+    if (!alloc_load_row(chunk,5))
+      return 1;
+    for (count=0 ; count < field_count ; count++)
+    {
+      if (read_info->read_field())
+	break;
+      uint length=(uint) (read_info->row_end-read_info->row_start);
+      if (length == 1 && read_info->found_null)
+      {
+	if (!(pos=alloc_load_row(chunk,4)))
+	  return 1;
+	int4store(pos,LOAD_NULL_FIELD);
+	continue;
+      }
+      if (!(pos=alloc_load_row(chunk,length+5)))
+	return 1;
+      int4store(pos,length);
+      memcpy(pos+4,read_info->row_start,length);
+      pos[length+4]=0;
+    }
+    if (read_info->error)
+      return 1;
+    if (!count)
+    {
+      chunk->rows_length=row;			// No more lines
+      return 0;
+    }
+    end=read_info->next_line();
+    pos=chunk->rows+row;
+    int4store(pos,count);
+    pos[4]= (!end && read_info->line_cuted) ? LOAD_ROW_CUTED : 0;
+    if (end)
+      return 0;
+  }
+}
+
+
+/*
+  Store the parsed rows of a chunk in the table
+
+  RETURN
+    0	ok
+    1	Error; The error is sent
+*/
+
+static int store_load_chunk(THD *thd, COPY_INFO &info, TABLE *table,
+			    List<Item> &fields, LOAD_CHUNK *chunk,
+			    ulonglong *id)
+{
+  List_iterator_fast<Item> it(fields);
+  Item_field *sql_field;
+  byte *pos=chunk->rows, *end=pos+chunk->rows_length;
+
+  while (pos != end)
+  {
+    uint count=uint4korr(pos);
+    bool line_cuted=pos[4] & LOAD_ROW_CUTED;
+    pos+=5;
+    if (thd->killed)
+    {
+      my_error(ER_SERVER_SHUTDOWN,MYF(0));
+      return 1;
+    }
+    for (it.rewind() ; count-- ; )
+    {
+      Field *field=((Item_field*) it++)->field;
+      uint32 length=uint4korr(pos);
+      pos+=4;
+      if (length == LOAD_NULL_FIELD)
+      {
+	set_field_to_load_null(thd,table,field);
+	continue;
+      }
+      field->set_notnull();
+      field->store((char*) pos,length);
+      pos+=length+1;
+    }
+    while ((sql_field=(Item_field*) it++))
+    {						// Not enough fields
+      sql_field->field->set_null();
+      sql_field->field->reset();
+      thd->cuted_fields++;
+    }
+    if (write_record(table,&info))
+      return 1;
+    /* Save the first auto_increment value; See read_sep_field() */
+    if (!*id && thd->insert_id_used)
+      *id= thd->last_insert_id;
+    if (table->next_number_field)
+      table->next_number_field->reset();	// Clear for next record
+    if (line_cuted)
+      thd->cuted_fields++;			/* To long row */
+  }
+  return 0;
+}
+
+
+/*
+  Take the next chunk to parse; Returns 0 if none is read yet
+  Must be called with load->mutex locked
+*/
+
+static LOAD_CHUNK *take_load_chunk(LOAD_THREADS *load)
+{
+  if (load->abort || load->next_parse == load->next_read)
+    return 0;
+  return load->chunks + load->next_parse++ % load->chunk_count;
+}
+
+
+pthread_handler_decl(handle_load_parser,arg)
+{
+  LOAD_THREADS *load=(LOAD_THREADS*) arg;
+  sql_exchange *ex=load->ex;
+  LOAD_CHUNK *chunk;
+
+  if (!my_thread_init())
+  {
+    READ_INFO read_info(load->tot_length,*ex->field_term,*ex->line_start,
+			*ex->line_term,*ex->enclosed,load->escape_char);
+    pthread_mutex_lock(&load->mutex);
+    while (!read_info.error && !load->abort)
+    {
+      if (!(chunk=take_load_chunk(load)))
+      {
+	if (load->end_of_file)
+	  break;
+	pthread_cond_wait(&load->cond,&load->mutex);
+	continue;
+      }
+      pthread_mutex_unlock(&load->mutex);
+      bool error=parse_load_chunk(&read_info,chunk,load->field_count);
+      pthread_mutex_lock(&load->mutex);
+      chunk->error=error;
+      chunk->parsed=1;
+      pthread_cond_broadcast(&load->cond);
+    }
+    pthread_mutex_unlock(&load->mutex);
+  }
+  pthread_mutex_lock(&load->mutex);
+  load->running--;
+  pthread_cond_broadcast(&load->cond);
+  pthread_mutex_unlock(&load->mutex);
+  my_thread_end();
+  return 0;
+}
+
+
+/* Start the parser threads; Called with load->mutex locked */
+
+static void start_load_threads(LOAD_THREADS *load, uint thread_count)
+{
+  pthread_attr_t thr_attr;
+  pthread_t thr;
+
+  (void) pthread_attr_init(&thr_attr);
+  (void) pthread_attr_setdetachstate(&thr_attr,PTHREAD_CREATE_DETACHED);
+  while (thread_count--)
+  {
+    if (pthread_create(&thr,&thr_attr,handle_load_parser,(void*) load))
+    {
+      DBUG_PRINT("warning",("Can't create load thread; error: %d",errno));
+      break;				// The connection thread parses
+    }
+    load->running++;
+  }
+  (void) pthread_attr_destroy(&thr_attr);
+}
+
+
+/*
+  Load rows of delimited fields with several parser threads
+
+  NOTES
+    Gives the same rows and warnings as read_sep_field(). Used when
+    load_lines_can_be_split() is true.
+*/
+
+static int read_sep_field_threads(THD *thd, COPY_INFO &info, TABLE *table,
+				  List<Item> &fields, READ_INFO &read_info,
+				  sql_exchange *ex, uint tot_length,
+				  uint thread_count)
+{
+  LOAD_THREADS load;
+  LOAD_CHUNK *chunk,*prev=0;
+  ulonglong id=0;
+  int error=0;
+  bool started=0;
+  uint i;
+  DBUG_ENTER("read_sep_field_threads");
+
+  bzero((char*) &load,sizeof(load));
+  load.chunk_count=thread_count*2;
+  load.ex=ex;
+  load.tot_length=tot_length;
+  load.field_count=fields.elements;
+  load.escape_char=info.escape_char;
+  if (!(load.chunks=(LOAD_CHUNK*) my_malloc(sizeof(LOAD_CHUNK)*
+					    load.chunk_count,
+					    MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(1);
+  /* For the chunks the connection thread parses itself */
+  READ_INFO parse_info(tot_length,*ex->field_term,*ex->line_start,
+		       *ex->line_term,*ex->enclosed,info.escape_char);
+  if (parse_info.error)
+  {
+    my_free((gptr) load.chunks,MYF(0));
+    DBUG_RETURN(1);
+  }
+  pthread_mutex_init(&load.mutex,MY_MUTEX_INIT_FAST);
+  pthread_cond_init(&load.cond,0);
+
+  pthread_mutex_lock(&load.mutex);
+  for (;;)
+  {
+    /* Read ahead while there are free chunks */
+    while (!load.end_of_file &&
+	   load.next_read - load.next_store < load.chunk_count)
+    {
+      chunk=load.chunks + load.next_read % load.chunk_count;
+      pthread_mutex_unlock(&load.mutex);
+      error=read_load_chunk(read_info,&load,chunk,prev);
+      pthread_mutex_lock(&load.mutex);
+      if (error || !chunk->read_length)
+      {
+	load.end_of_file=1;
+	pthread_cond_broadcast(&load.cond);
+	break;
+      }
+      chunk->parsed=0;
+      prev=chunk;
+      load.next_read++;
+      pthread_cond_broadcast(&load.cond);
+      /* Files of one chunk are parsed without threads */
+      if (load.next_read == 2 && !started)
+      {
+	start_load_threads(&load,thread_count);
+	started=1;
+      }
+    }
+    if (error || load.next_store == load.next_read)
+      break;
+
+    /* Store the next chunk in file order; Parse it here if no one has */
+    chunk=load.chunks + load.next_store % load.chunk_count;
+    if (load.next_parse == load.next_store)
+    {
+      load.next_parse++;
+      pthread_mutex_unlock(&load.mutex);
+      chunk->error=parse_load_chunk(&parse_info,chunk,load.field_count);
+      pthread_mutex_lock(&load.mutex);
+      chunk->parsed=1;
+    }
+    while (!chunk->parsed)
+      pthread_cond_wait(&load.cond,&load.mutex);
+    pthread_mutex_unlock(&load.mutex);
+    if (chunk->error)
+    {
+      my_error(ER_OUT_OF_RESOURCES,MYF(0));
+      error=1;
+    }
+    else
+      error=store_load_chunk(thd,info,table,fields,chunk,&id);
+    pthread_mutex_lock(&load.mutex);
+    if (error)
+      break;
+    load.next_store++;
+    pthread_cond_broadcast(&load.cond);
+  }
+
+  /* Stop the threads; They finish the chunk they are parsing */
+  load.abort=1;
+  pthread_cond_broadcast(&load.cond);
+  while (load.running)
+    pthread_cond_wait(&load.cond,&load.mutex);
+  pthread_mutex_unlock(&load.mutex);
+  pthread_cond_destroy(&load.cond);
+  pthread_mutex_destroy(&load.mutex);
+
+  for (i=0 ; i < load.chunk_count ; i++)
+  {
+    my_free((gptr) load.chunks[i].text,MYF(MY_ALLOW_ZERO_PTR));
+    my_free((gptr) load.chunks[i].rows,MYF(MY_ALLOW_ZERO_PTR));
+  }
+  my_free((gptr) load.chunks,MYF(0));
+  if (id && !error)
+    thd->insert_id(id);			// For binary/update log
+  DBUG_RETURN(error);
+}
+#endif /* THREAD */
+
+
 /* Unescape all escape characters, mark \N as null */
 
 char
@@ -558,7 +1082,68 @@ READ_INFO::READ_INFO(File file_par, uint tot_length, String &field_term,
 		     String &line_start, String &line_term,
 		     String &enclosed_par, int escape, bool get_it_from_net,
 		     bool is_fifo)
-  :file(file_par),escape_char(escape)
+  :file(file_par),escape_char(escape),in_memory(0)
+{
+  init(tot_length, field_term, line_start, line_term, enclosed_par);
+  if (error)
+    return;
+  if (init_io_cache(&cache,(get_it_from_net) ? -1 : file, 0,
+		    (get_it_from_net) ? READ_NET :
+		    (is_fifo ? READ_FIFO : READ_CACHE),0L,1,
+		    MYF(MY_WME)))
+  {
+    my_free((gptr) buffer,MYF(0)); /* purecov: inspected */
+    error=1;
+  }
+  else 
+  {
+    /*
+      init_io_cache() will not initialize read_function member
+      if the cache is READ_NET. The reason is explained in
+      mysys/mf_iocache.c. So we work around the problem with a
+      manual assignment
+    */
+    if (get_it_from_net)
+      cache.read_function = _my_b_net_read;
+
+    need_end_io_cache = 1;
+    if (!opt_old_rpl_compat && mysql_bin_log.is_open())
+      cache.pre_read = cache.pre_close =
+	(IO_CACHE_CALLBACK) log_loaded_block;
+  }
+}
+
+
+/* read_function of a READ_INFO on memory; All text is in the cache */
+
+static int read_memory_eof(IO_CACHE *info __attribute__((unused)),
+			   byte *Buffer __attribute__((unused)),
+			   uint Count __attribute__((unused)))
+{
+  return 1;
+}
+
+
+/*
+  Read text given with set_data(); Used by the parser threads of
+  read_sep_field_threads(), which have no THD
+*/
+
+READ_INFO::READ_INFO(uint tot_length, String &field_term,
+		     String &line_start, String &line_term,
+		     String &enclosed_par, int escape)
+  :file(-1),escape_char(escape),in_memory(1)
+{
+  init(tot_length, field_term, line_start, line_term, enclosed_par);
+  bzero((char*) &cache,sizeof(cache));
+  cache.read_function= read_memory_eof;
+  need_end_io_cache= 0;
+}
+
+
+void READ_INFO::init(uint tot_length, String &field_term,
+		     String &line_start, String &line_term,
+		     String &enclosed_par)
 {
   field_term_ptr=(char*) field_term.ptr();
   field_term_length= field_term.length();
@@ -593,38 +1178,17 @@ READ_INFO::READ_INFO(File file_par, uint tot_length, String &field_term,
   /* Set of a stack for unget if long terminators */
   uint length=max(field_term_length,line_term_length)+1;
   set_if_bigger(length,line_start.length());
-  stack=stack_pos=(int*) sql_alloc(sizeof(int)*length);
+  /* Threads without THD can't use sql_alloc() */
+  if (in_memory)
+    stack=(int*) my_malloc(sizeof(int)*length,MYF(0));
+  else
+    stack=(int*) sql_alloc(sizeof(int)*length);
+  stack_pos=stack;
 
-  if (!(buffer=(byte*) my_malloc(buff_length+1,MYF(0))))
+  if (!stack || !(buffer=(byte*) my_malloc(buff_length+1,MYF(0))))
     error=1; /* purecov: inspected */
   else
-  {
     end_of_buff=buffer+buff_length;
-    if (init_io_cache(&cache,(get_it_from_net) ? -1 : file, 0,
-		      (get_it_from_net) ? READ_NET :
-		      (is_fifo ? READ_FIFO : READ_CACHE),0L,1,
-		      MYF(MY_WME)))
-    {
-      my_free((gptr) buffer,MYF(0)); /* purecov: inspected */
-      error=1;
-    }
-    else 
-    {
-      /*
-	init_io_cache() will not initialize read_function member
-	if the cache is READ_NET. The reason is explained in
-	mysys/mf_iocache.c. So we work around the problem with a
-	manual assignment
-      */
-      if (get_it_from_net)
-	cache.read_function = _my_b_net_read;
-
-      need_end_io_cache = 1;
-      if (!opt_old_rpl_compat && mysql_bin_log.is_open())
-	cache.pre_read = cache.pre_close =
-	  (IO_CACHE_CALLBACK) log_loaded_block;
-    }
-  }
 }
 
 
@@ -637,6 +1201,20 @@ READ_INFO::~READ_INFO()
     my_free((gptr) buffer,MYF(0));
     error=1;
   }
+  if (in_memory)
+    my_free((gptr) stack,MYF(MY_ALLOW_ZERO_PTR));
+}
+
+
+/* Start to read the text of a chunk in a READ_INFO on memory */
+
+void READ_INFO::set_data(byte *data, uint length)
+{
+  cache.read_pos= data;
+  cache.read_end= data+length;
+  stack_pos=stack;
+  eof=found_end_of_line=found_null=line_cuted=0;
+  start_of_line= line_start_ptr != 0;
 }
 
 
@@ -920,6 +1498,44 @@ int READ_INFO::next_line()
 }
 
 
+/*
+  Read raw text for the parser threads of read_sep_field_threads()
+
+  NOTES
+    Characters pushed back by next_line() are returned first. The cache
+    is refilled with my_b_get(), so each block is still given to
+    log_loaded_block() for the binary log.
+
+  RETURN
+    Number of bytes read; Less than length only at end of file
+*/
+
+uint READ_INFO::read_block(byte *to, uint length)
+{
+  byte *start=to, *end=to+length;
+  int chr;
+  if (eof)
+    return 0;
+  while (to != end && stack_pos != stack)
+    *to++= (byte) *--stack_pos;
+  while (to != end)
+  {
+    uint count=min((uint) (cache.read_end-cache.read_pos),(uint) (end-to));
+    memcpy(to,cache.read_pos,count);
+    cache.read_pos+=count;
+    if ((to+=count) == end)
+      break;
+    if ((chr=my_b_get(&cache)) == my_b_EOF)
+    {
+      eof=1;
+      break;
+    }
+    *to++= (byte) chr;
+  }
+  return (uint) (to-start);
+}
+
+
 bool READ_INFO::find_start_of_fields()
 {
   int chr;
@@ -57,7 +57,6 @@ static void decrease_user_connections(USER_CONN *uc);
 static bool check_db_used(THD *thd,TABLE_LIST *tables);
 static bool check_merge_table_access(THD *thd, char *db, TABLE_LIST *tables);
 static bool check_dup(const char *db, const char *name, TABLE_LIST *tables);
-static void mysql_init_query(THD *thd);
 static void remove_escape(char *name);
 static void refresh_status(void);
 static bool append_file_to_dir(THD *thd, char **filename_ptr,
@@ -71,6 +70,7 @@ const char *command_name[]={
   "Drop DB", "Refresh", "Shutdown", "Statistics", "Processlist",
   "Connect","Kill","Debug","Ping","Time","Delayed_insert","Change user",
   "Binlog Dump","Table Dump",  "Connect Out", "Register Slave",
+  "Prepare", "Execute", "Close stmt",
   "Error"					// Last command number
 };
 
@@ -633,6 +633,93 @@ check_connections(THD *thd)
 }
 
 
+/*
+  Authenticate a new connection and set up the session state
+
+  SYNOPSIS
+    login_connection()
+    thd			Thread handler of the new connection
+
+  NOTES
+    Used both by handle_one_connection() and by the pool-of-threads
+    scheduler, which runs the login on one of its worker threads.
+    thd->thread_stack must be set by the caller.
+
+  RETURN
+    0	ok; the connection is ready for do_command()
+    1	error; the caller should close the connection
+*/
+
+bool login_connection(THD *thd)
+{
+  int error;
+  NET *net= &thd->net;
+  DBUG_ENTER("login_connection");
+
+  if ((error=check_connections(thd)))
+  {						// Wrong permissions
+    if (error > 0)
+      net_printf(net,error,thd->host_or_ip);
+#ifdef __NT__
+    if (vio_type(net->vio) == VIO_TYPE_NAMEDPIPE)
+      sleep(1);					/* must wait after eof() */
+#endif
+    statistic_increment(aborted_connects,&LOCK_status);
+    DBUG_RETURN(1);
+  }
+#ifdef __NETWARE__
+  netware_reg_user(thd->ip, thd->user, "MySQL");
+#endif
+  if (thd->variables.max_join_size == HA_POS_ERROR)
+    thd->options |= OPTION_BIG_SELECTS;
+  if (thd->client_capabilities & CLIENT_COMPRESS)
+    net->compress=1;				// Use compression
+
+  thd->proc_info=0;				// Remove 'login'
+  thd->command=COM_SLEEP;
+  thd->version=refresh_version;
+  thd->set_time();
+  init_sql_alloc(&thd->mem_root, thd->variables.query_alloc_block_size,
+		 thd->variables.query_prealloc_size);
+  init_sql_alloc(&thd->transaction.mem_root,
+		 thd->variables.trans_alloc_block_size,
+		 thd->variables.trans_prealloc_size);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Release the session state of a connection that is about to be closed
+  and account for how it ended (aborted, killed or normal quit).
+  The caller still has to call close_connection() and free the THD.
+*/
+
+void end_connection(THD *thd)
+{
+  NET *net= &thd->net;
+
+  if (thd->user_connect)
+    decrease_user_connections(thd->user_connect);
+  free_root(&thd->mem_root,MYF(0));
+  if (net->error && net->vio != 0)
+  {
+    if (!thd->killed && thd->variables.log_warnings)
+      sql_print_error(ER(ER_NEW_ABORTING_CONNECTION),
+		      thd->thread_id,(thd->db ? thd->db : "unconnected"),
+		      thd->user ? thd->user : "unauthenticated",
+		      thd->host_or_ip,
+		      (net->last_errno ? ER(net->last_errno) :
+		       ER(ER_UNKNOWN_ERROR)));
+    send_error(net,net->last_errno,NullS);
+    statistic_increment(aborted_threads,&LOCK_status);
+  }
+  else if (thd->killed)
+  {
+    statistic_increment(aborted_threads,&LOCK_status);
+  }
+}
+
+
 pthread_handler_decl(handle_one_connection,arg)
 {
   THD *thd=(THD*) arg;
@@ -682,63 +769,18 @@ pthread_handler_decl(handle_one_connection,arg)
 
   do
   {
-    int error;
     NET *net= &thd->net;
     thd->thread_stack= (char*) &thd;
 
-    if ((error=check_connections(thd)))
-    {						// Wrong permissions
-      if (error > 0)
-	net_printf(net,error,thd->host_or_ip);
-#ifdef __NT__
-      if (vio_type(net->vio) == VIO_TYPE_NAMEDPIPE)
-	sleep(1);				/* must wait after eof() */
-#endif
-      statistic_increment(aborted_connects,&LOCK_status);
+    if (login_connection(thd))
       goto end_thread;
-    }
-#ifdef __NETWARE__
-    netware_reg_user(thd->ip, thd->user, "MySQL");
-#endif
-    if (thd->variables.max_join_size == HA_POS_ERROR)
-      thd->options |= OPTION_BIG_SELECTS;
-    if (thd->client_capabilities & CLIENT_COMPRESS)
-      net->compress=1;				// Use compression
-
-    thd->proc_info=0;				// Remove 'login'
-    thd->command=COM_SLEEP;
-    thd->version=refresh_version;
-    thd->set_time();
-    init_sql_alloc(&thd->mem_root, thd->variables.query_alloc_block_size,
-		   thd->variables.query_prealloc_size);
-    init_sql_alloc(&thd->transaction.mem_root,
-		   thd->variables.trans_alloc_block_size,
-		   thd->variables.trans_prealloc_size);
 
     while (!net->error && net->vio != 0 && !thd->killed)
     {
       if (do_command(thd))
 	break;
     }
-    if (thd->user_connect)
-      decrease_user_connections(thd->user_connect);
-    free_root(&thd->mem_root,MYF(0));
-    if (net->error && net->vio != 0)
-    {
-      if (!thd->killed && thd->variables.log_warnings)
-	sql_print_error(ER(ER_NEW_ABORTING_CONNECTION),
-			thd->thread_id,(thd->db ? thd->db : "unconnected"),
-			thd->user ? thd->user : "unauthenticated",
-			thd->host_or_ip,
-			(net->last_errno ? ER(net->last_errno) :
-			 ER(ER_UNKNOWN_ERROR)));
-      send_error(net,net->last_errno,NullS);
-      statistic_increment(aborted_threads,&LOCK_status);
-    }
-    else if (thd->killed)
-    {
-      statistic_increment(aborted_threads,&LOCK_status);
-    }
+    end_connection(thd);
     
 end_thread:
     close_connection(net);
@@ -832,7 +874,7 @@ end:
 }
 
 
-inline void free_items(THD *thd)
+void free_items(THD *thd)
 {
     /* This works because items are allocated with sql_alloc() */
   for (Item *item=thd->free_list ; item ; item=item->next)
@@ -1061,6 +1103,7 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
     mysql_log.write(thd,command,"%s",thd->query);
     DBUG_PRINT("query",("%-.4096s",thd->query));
     /* thd->query_length is set by mysql_parse() */
+    thd->profiling.start_query(thd);
     mysql_parse(thd,thd->query,packet_length);
     if (!(specialflag & SPECIAL_NO_PRIOR))
       my_pthread_setprio(pthread_self(),WAIT_PRIOR);
@@ -1253,6 +1296,15 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
     mysql_log.write(thd,command,NullS);
     send_eof(net);
     break;
+  case COM_PREPARE:
+    mysql_stmt_prepare(thd,packet,packet_length-1);	// Remove command byte
+    break;
+  case COM_EXECUTE:
+    mysql_stmt_execute(thd,packet,packet_length-1);
+    break;
+  case COM_CLOSE_STMT:
+    mysql_stmt_close(thd,packet,packet_length-1);
+    break;
   case COM_SLEEP:
   case COM_CONNECT:				// Impossible here
   case COM_TIME:				// Impossible from client
@@ -1264,7 +1316,7 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
   }
   if (thd->lock || thd->open_tables)
   {
-    thd->proc_info="closing tables";
+    thd->set_proc_info("closing tables");
     close_thread_tables(thd);			/* Free tables */
   }
 
@@ -1277,7 +1329,7 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
   /* If not reading from backup and if the query took too long */
   if (!slow_command && !thd->user_time) // do not log 'slow_command' queries
   {
-    thd->proc_info="logging slow query";
+    thd->set_proc_info("logging slow query");
 
     if ((ulong) (thd->start_time - thd->time_after_lock) >
 	thd->variables.long_query_time ||
@@ -1289,7 +1341,8 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
       mysql_slow_log.write(thd, thd->query, thd->query_length, start_of_query);
     }
   }
-  thd->proc_info="cleaning up";
+  thd->set_proc_info("cleaning up");
+  thd->profiling.end_query(thd);
   VOID(pthread_mutex_lock(&LOCK_thread_count)); // For process list
   thd->proc_info=0;
   thd->command=COM_SLEEP;
@@ -1520,6 +1573,23 @@ mysql_execute_command(void)
     UNLOCK_ACTIVE_MI;
     break;
   }
+  case SQLCOM_SHOW_PROFILES:
+    thd->profiling.discard();
+    res= thd->profiling.show_profiles(thd);
+    break;
+  case SQLCOM_SHOW_PROFILE:
+    thd->profiling.discard();
+    res= thd->profiling.show_profile(thd, lex->profile_query_id);
+    break;
+  case SQLCOM_SHOW_SLAVE_WORKERS:
+  {
+    if (check_global_access(thd, SUPER_ACL | REPL_CLIENT_ACL))
+      goto error;
+    LOCK_ACTIVE_MI;
+    res = show_slave_workers(thd,active_mi);
+    UNLOCK_ACTIVE_MI;
+    break;
+  }
   case SQLCOM_SHOW_MASTER_STAT:
   {
     /* Accept one of two privileges */
@@ -1944,7 +2014,7 @@ mysql_execute_command(void)
     if (grant_option && check_grant(thd,INSERT_ACL,tables))
       goto error;
     res = mysql_insert(thd,tables,lex->field_list,lex->many_values,
-		       lex->duplicates);
+		       lex->literal_values, lex->duplicates);
     break;
   case SQLCOM_REPLACE:
     if (check_access(thd,INSERT_ACL | DELETE_ACL,
@@ -1955,7 +2025,7 @@ mysql_execute_command(void)
 
       goto error;
     res = mysql_insert(thd,tables,lex->field_list,lex->many_values,
-		       DUP_REPLACE);
+		       lex->literal_values, DUP_REPLACE);
     break;
   case SQLCOM_REPLACE_SELECT:
   case SQLCOM_INSERT_SELECT:
@@ -2084,7 +2154,7 @@ mysql_execute_command(void)
       break;
     }
     tables->grant.want_privilege=(SELECT_ACL & ~tables->grant.privilege);
-    thd->proc_info="init";
+    thd->set_proc_info("init");
     if ((res=open_and_lock_tables(thd,tables)))
       break;
     /* Fix tables-to-be-deleted-from list to point at opened tables */
@@ -2158,6 +2228,10 @@ mysql_execute_command(void)
 			  thd->priv_user,lex->verbose);
     break;
   case SQLCOM_SHOW_STATUS:
+    update_key_cache_stats();
+#ifdef HAVE_QUERY_CACHE
+    query_cache.update_stats();
+#endif
     res= mysqld_show(thd,(lex->wild ? lex->wild->ptr() : NullS),status_vars,
 		     OPT_GLOBAL, &LOCK_status);
     break;
@@ -2604,7 +2678,7 @@ mysql_execute_command(void)
     send_ok(&thd->net);
     break;
   }
-  thd->proc_info="query end";			// QQ
+  thd->set_proc_info("query end");		// QQ
   if (res < 0)
     send_error(&thd->net,thd->killed ? ER_SERVER_SHUTDOWN : 0);
 
@@ -2880,7 +2954,7 @@ bool my_yyoverflow(short **yyss, YYSTYPE **yyvs, int *yystacksize)
 	Initialize global thd variables needed for query
 ****************************************************************************/
 
-static void
+void
 mysql_init_query(THD *thd)
 {
   DBUG_ENTER("mysql_init_query");
@@ -2898,7 +2972,8 @@ mysql_init_query(THD *thd)
   thd->last_insert_id_used=thd->query_start_used=thd->insert_id_used=0;
   thd->rand_used=0;
   thd->sent_row_count=thd->examined_row_count=0;
-  thd->safe_to_cache_query=1;
+  /* Binary rows of COM_EXECUTE can't be returned to a COM_QUERY */
+  thd->safe_to_cache_query= !thd->binary_rows;
   DBUG_VOID_RETURN;
 }
 
@@ -2955,11 +3030,15 @@ mysql_parse(THD *thd,char *inBuf,uint length)
 
   mysql_init_query(thd);
   thd->query_length = length;
-  if (query_cache_send_result_to_client(thd, inBuf, length) <= 0)
+  thd->profiling.status("checking query cache");
+  if (thd->binary_rows ||
+      query_cache_send_result_to_client(thd, inBuf, length) <= 0)
   {
     LEX *lex=lex_start(thd, (uchar*) inBuf, length);
+    thd->profiling.status("parsing");
     if (!yyparse() && ! thd->fatal_error)
     {
+      thd->profiling.status("executing");
       if (mqh_used && thd->user_connect &&
 	  check_mqh(thd, thd->lex.sql_command))
       {
@@ -2977,7 +3056,7 @@ mysql_parse(THD *thd,char *inBuf,uint length)
 			 thd->fatal_error));
       query_cache_abort(&thd->net);
     }
-    thd->proc_info="freeing items";
+    thd->set_proc_info("freeing items");
     free_items(thd);  /* Free strings used by items */
     lex_end(lex);
   }
@@ -3009,14 +3088,14 @@ bool add_field_to_list(char *field_name, enum_field_types type,
   if (type_modifier & PRI_KEY_FLAG)
   {
     lex->col_list.push_back(new key_part_spec(field_name,0));
-    lex->key_list.push_back(new Key(Key::PRIMARY,NullS,
+    lex->key_list.push_back(new Key(Key::PRIMARY,NullS,HA_KEY_ALG_UNDEF,
 				    lex->col_list));
     lex->col_list.empty();
   }
   if (type_modifier & (UNIQUE_FLAG | UNIQUE_KEY_FLAG))
   {
     lex->col_list.push_back(new key_part_spec(field_name,0));
-    lex->key_list.push_back(new Key(Key::UNIQUE,NullS,
+    lex->key_list.push_back(new Key(Key::UNIQUE,NullS,HA_KEY_ALG_UNDEF,
 				    lex->col_list));
     lex->col_list.empty();
   }
@@ -3741,6 +3820,10 @@ static void refresh_status(void)
     if (ptr->type == SHOW_LONG)
       *(ulong*) ptr->value=0;
   }
+  reset_key_cache_stats();
+#ifdef HAVE_QUERY_CACHE
+  query_cache.reset_stats();
+#endif
   pthread_mutex_unlock(&LOCK_status);
   pthread_mutex_unlock(&THR_LOCK_keycache);
 }
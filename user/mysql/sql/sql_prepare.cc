@@ -0,0 +1,1035 @@
+/* Copyright (C) 2000 MySQL AB & MySQL Finland AB & TCX DataKonsult AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+
+/*
+  Prepared statements: COM_PREPARE, COM_EXECUTE and COM_CLOSE_STMT
+
+  COM_PREPARE <query>
+    The query may have '?' markers where an expression is allowed.
+    The query is parsed to check it and to find the markers.
+    Reply: 0, statement id (4 bytes), number of parameters (2 bytes)
+
+  COM_EXECUTE <statement id (4 bytes)> <parameters>
+    The parameters are a bitmap with one bit set for each NULL parameter,
+    the type of each parameter as 2 bytes (FIELD_TYPE_XXX, with 0x8000
+    added for unsigned integers) and the value of each non NULL parameter:
+    integers and floating point numbers in binary, low byte first, and
+    other values as a length coded string.
+    Reply: As for COM_QUERY, but the rows of a result set are in the
+    binary format of net_store_binary_row().
+
+  COM_CLOSE_STMT <statement id (4 bytes)>
+    Frees the statement. There is no reply.
+
+  The item tree of a query is allocated in thd->mem_root and is changed
+  by fix_fields() and the optimizer, so it can't be kept from one
+  execution to the next (see the comment at the start of sql_handler.cc).
+  Instead the prepare stores what is needed to run the statement again:
+
+  - For a SELECT of some columns of one table with a WHERE that gives
+    values to all parts of a unique index on integer columns, a plan with
+    the table, index and columns is stored. COM_EXECUTE runs the plan with
+    a single index_read_idx(), without parsing or optimizing anything.
+  - Other statements, or a plan that can't be used any more (the table
+    was changed, LOCK TABLES is used...) are run by putting the parameter
+    values as literals in the query and running it as with COM_QUERY.
+    This saves the client from quoting the values and from converting
+    the result rows from text.
+*/
+
+#include "mysql_priv.h"
+#include "sql_acl.h"
+#include "sql_select.h"
+#include <m_ctype.h>
+
+#define NO_PARAM ((uint) ~0)
+
+/* A value given by COM_EXECUTE */
+
+typedef struct st_stmt_param
+{
+  enum Item_result type;		/* INT, REAL or STRING_RESULT */
+  bool null_value,unsigned_flag;
+  longlong int_value;
+  double real_value;
+  char *str_value;
+  ulong length;
+} STMT_PARAM;
+
+typedef struct st_stmt_key_part
+{
+  const char *field_name;
+  uint param;				/* Parameter number or NO_PARAM */
+  longlong value;			/* Value if param == NO_PARAM */
+  bool unsigned_flag;
+} STMT_KEY_PART;
+
+typedef struct st_stmt_column
+{
+  const char *field_name;		/* 0 for all columns ('*') */
+  const char *name;			/* Name of column in result */
+  uint fieldnr;				/* Position in table when prepared */
+} STMT_COLUMN;
+
+typedef struct st_stmt_plan
+{
+  char *db;				/* 0 if the current database */
+  char *table_name,*alias;
+  char *key_name;
+  uint keynr;				/* Index number when prepared */
+  uint key_parts,columns;
+  STMT_KEY_PART *key_part;		/* In the order of the index */
+  STMT_COLUMN *column;
+  thr_lock_type lock_type;
+} STMT_PLAN;
+
+/* field = value part of the WHERE of a query */
+
+typedef struct st_stmt_eq
+{
+  Item_field *field;
+  Item *value;				/* Item_param or Item_int */
+} STMT_EQ;
+
+
+class Prepared_statement
+{
+public:
+  Prepared_statement *next;
+  ulong id;
+  MEM_ROOT mem_root;			/* The members below are stored here */
+  char *query;
+  uint query_length;
+  uint param_count;
+  uint *param_pos;			/* Offset of each '?' in query */
+  STMT_PLAN *plan;			/* 0 if there is no plan */
+
+  Prepared_statement(ulong id_arg)
+    :next(0), id(id_arg), query(0), query_length(0), param_count(0),
+     param_pos(0), plan(0)
+  {
+    init_alloc_root(&mem_root, 1024, 0);
+  }
+  ~Prepared_statement()
+  {
+    free_root(&mem_root, MYF(0));
+  }
+};
+
+
+static bool stmt_command_allowed(enum enum_sql_command command)
+{
+  switch (command) {
+  case SQLCOM_SELECT:
+  case SQLCOM_INSERT:
+  case SQLCOM_INSERT_SELECT:
+  case SQLCOM_REPLACE:
+  case SQLCOM_REPLACE_SELECT:
+  case SQLCOM_UPDATE:
+  case SQLCOM_MULTI_UPDATE:
+  case SQLCOM_DELETE:
+  case SQLCOM_DELETE_MULTI:
+  case SQLCOM_DO:
+  case SQLCOM_SET_OPTION:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+
+static Prepared_statement *find_statement(THD *thd, ulong id)
+{
+  Prepared_statement *stmt;
+  for (stmt=thd->prepared_stmts ; stmt && stmt->id != id ; stmt=stmt->next) ;
+  return stmt;
+}
+
+
+/*
+  Check if an index can be used by a plan
+
+  SYNOPSIS
+    stmt_key_usable()
+    table		Table
+    keynr		Index number
+    key_parts		Number of 'field = value' in the WHERE
+
+  NOTES
+    The index must be a unique index where all key parts are whole integer
+    columns, so that the key can be made from integer values.
+
+  RETURN
+    0  The index can't be used
+    1  ok
+*/
+
+static bool stmt_key_usable(TABLE *table, uint keynr, uint key_parts)
+{
+  KEY *keyinfo=table->key_info+keynr;
+  KEY_PART_INFO *key_part,*end;
+
+  if (!(table->keys_in_use & ((key_map) 1 << keynr)) ||
+      !(keyinfo->flags & HA_NOSAME) || keyinfo->key_parts != key_parts)
+    return 0;
+  for (key_part=keyinfo->key_part, end=key_part+key_parts ;
+       key_part != end ;
+       key_part++)
+  {
+    Field *field=key_part->field;
+    switch (field->type()) {
+    case FIELD_TYPE_TINY:
+    case FIELD_TYPE_SHORT:
+    case FIELD_TYPE_INT24:
+    case FIELD_TYPE_LONG:
+    case FIELD_TYPE_LONGLONG:
+      break;
+    default:
+      return 0;
+    }
+    if (key_part->length != field->pack_length())
+      return 0;
+  }
+  return 1;
+}
+
+
+/* Check that a column of the query refers to the table of the plan */
+
+static bool stmt_field_in_table(Item_field *item, TABLE_LIST *tables)
+{
+  return ((!item->table_name || !strcmp(item->table_name,tables->alias)) &&
+	  (!item->db_name || !strcmp(item->db_name,tables->db)));
+}
+
+
+static bool get_eq_condition(Item *cond, STMT_EQ *eq)
+{
+  Item **args;
+  if (cond->type() != Item::FUNC_ITEM ||
+      ((Item_func*) cond)->functype() != Item_func::EQ_FUNC)
+    return 1;
+  args=((Item_func*) cond)->arguments();
+  eq->field=(Item_field*) args[0];
+  eq->value=args[1];
+  if (eq->field->type() != Item::FIELD_ITEM)
+  {
+    eq->field=(Item_field*) args[1];
+    eq->value=args[0];
+  }
+  return (eq->field->type() != Item::FIELD_ITEM ||
+	  (eq->value->type() != Item::PARAM_ITEM &&
+	   eq->value->type() != Item::INT_ITEM));
+}
+
+
+/*
+  Make a plan for a prepared statement, if possible
+
+  SYNOPSIS
+    make_stmt_plan()
+    thd			Thread handler. thd->lex is the parsed statement
+    stmt		The plan is stored here
+
+  NOTES
+    The table is opened to find the index to use. The index and columns
+    are found by name when the plan is executed, so that a plan of a
+    table that has been changed is not used.
+
+  RETURN
+    0  ok; stmt->plan is set if the statement can use a plan
+    1  Error (sent to client)
+*/
+
+static bool make_stmt_plan(THD *thd, Prepared_statement *stmt)
+{
+  LEX *lex= &thd->lex;
+  SELECT_LEX *select_lex= &lex->select_lex;
+  TABLE_LIST *tables=(TABLE_LIST*) select_lex->table_list.first;
+  STMT_EQ eq[MAX_REF_PARTS];
+  STMT_PLAN *plan;
+  MEM_ROOT *root= &stmt->mem_root;
+  TABLE *table;
+  KEY *keyinfo;
+  Item *cond,*item;
+  uint eq_count=0,keynr,i,j;
+  DBUG_ENTER("make_stmt_plan");
+
+  if (lex->sql_command != SQLCOM_SELECT || select_lex->next ||
+      lex->exchange || !tables || tables->next ||
+      (tables->lock_type != TL_READ &&
+       tables->lock_type != TL_READ_HIGH_PRIORITY) ||
+      !(cond=select_lex->where) || select_lex->having ||
+      select_lex->group_list.elements || select_lex->order_list.elements ||
+      lex->proc_list.first || select_lex->ftfunc_list.elements ||
+      (select_lex->options & (SELECT_DESCRIBE | OPTION_FOUND_ROWS)) ||
+      select_lex->offset_limit || !select_lex->select_limit)
+    DBUG_RETURN(0);
+
+  /* The WHERE must be 'field = value [AND field = value ...]' */
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    List_iterator_fast<Item> li(*((Item_cond*) cond)->argument_list());
+    while ((item=li++))
+    {
+      if (eq_count == MAX_REF_PARTS || get_eq_condition(item,eq+eq_count))
+	DBUG_RETURN(0);
+      eq_count++;
+    }
+  }
+  else if (get_eq_condition(cond,eq+eq_count++))
+    DBUG_RETURN(0);
+  for (i=0 ; i < eq_count ; i++)
+    if (!stmt_field_in_table(eq[i].field,tables))
+      DBUG_RETURN(0);
+
+  /* Without full SELECT privilege on the table columns must be checked */
+  if (check_table_access(thd,SELECT_ACL,tables,1) ||
+      !(tables->grant.privilege & SELECT_ACL))
+    DBUG_RETURN(0);
+  if (!(table=open_ltable(thd,tables,TL_UNLOCK)))
+  {
+    send_error(&thd->net,0);
+    DBUG_RETURN(1);
+  }
+
+  for (keynr=0 ; keynr < table->keys ; keynr++)
+  {
+    if (!stmt_key_usable(table,keynr,eq_count))
+      continue;
+    keyinfo=table->key_info+keynr;
+    for (i=0 ; i < eq_count ; i++)
+    {
+      const char *name=keyinfo->key_part[i].field->field_name;
+      for (j=0 ; j < eq_count && my_strcasecmp(eq[j].field->field_name,name);
+	   j++) ;
+      if (j == eq_count)
+	break;
+    }
+    if (i == eq_count)
+      break;
+  }
+  if (keynr == table->keys)
+    DBUG_RETURN(0);
+
+  {
+    List_iterator_fast<Item> it(select_lex->item_list);
+    while ((item=it++))
+    {
+      if (item->type() != Item::FIELD_ITEM ||
+	  !stmt_field_in_table((Item_field*) item,tables))
+	DBUG_RETURN(0);
+    }
+  }
+
+  /* All checks done; store the plan */
+  if (!(plan=(STMT_PLAN*) alloc_root(root,sizeof(STMT_PLAN))) ||
+      !(plan->key_part=(STMT_KEY_PART*) alloc_root(root,sizeof(STMT_KEY_PART)*
+						  eq_count)) ||
+      !(plan->column=(STMT_COLUMN*) alloc_root(root,sizeof(STMT_COLUMN)*
+					       select_lex->item_list.elements)) ||
+      !(plan->table_name=strdup_root(root,tables->real_name)) ||
+      !(plan->alias=strdup_root(root,tables->alias)) ||
+      !(plan->key_name=strdup_root(root,keyinfo->name)))
+    goto err;
+  plan->db=0;
+  if (tables->db != thd->db && !(plan->db=strdup_root(root,tables->db)))
+    goto err;
+  plan->keynr=keynr;
+  plan->key_parts=eq_count;
+  plan->lock_type=tables->lock_type;
+  for (i=0 ; i < eq_count ; i++)
+  {
+    STMT_KEY_PART *part=plan->key_part+i;
+    const char *name=keyinfo->key_part[i].field->field_name;
+    for (j=0 ; my_strcasecmp(eq[j].field->field_name,name) ; j++) ;
+    if (!(part->field_name=strdup_root(root,name)))
+      goto err;
+    if (eq[j].value->type() == Item::PARAM_ITEM)
+    {
+      part->param=((Item_param*) eq[j].value)->param_number;
+      part->value=0;
+      part->unsigned_flag=0;
+    }
+    else
+    {
+      part->param=NO_PARAM;
+      part->value=eq[j].value->val_int();
+      part->unsigned_flag=eq[j].value->unsigned_flag;
+    }
+  }
+
+  {
+    List_iterator_fast<Item> it(select_lex->item_list);
+    STMT_COLUMN *column=plan->column;
+    plan->columns=0;
+    while ((item=it++))
+    {
+      Item_field *field_item=(Item_field*) item;
+      if (!strcmp(field_item->field_name,"*"))
+      {
+	column->field_name=column->name=0;
+	column->fieldnr=0;
+      }
+      else
+      {
+	for (i=0 ; i < table->fields ; i++)
+	  if (!my_strcasecmp(table->field[i]->field_name,
+			     field_item->field_name))
+	    break;
+	if (i == table->fields)
+	  DBUG_RETURN(0);			// Error is given by execute
+	if (!(column->field_name=strdup_root(root,field_item->field_name)) ||
+	    !(column->name=strdup_root(root,item->name)))
+	  goto err;
+	column->fieldnr=i;
+      }
+      column++;
+      plan->columns++;
+    }
+  }
+  stmt->plan=plan;
+  DBUG_RETURN(0);
+
+err:
+  send_error(&thd->net,ER_OUT_OF_RESOURCES);
+  DBUG_RETURN(1);
+}
+
+
+/*
+  Read the parameters of COM_EXECUTE
+
+  RETURN
+    0  ok
+    1  Wrong packet
+*/
+
+static ulong get_param_length(uchar **packet, uchar *end)
+{
+  uchar *pos= *packet;
+  if (pos >= end)
+    return ~(ulong) 0;
+  if (*pos < 251)
+  {
+    (*packet)++;
+    return (ulong) *pos;
+  }
+  if (*pos == 252 && pos+3 <= end)
+  {
+    (*packet)+=3;
+    return (ulong) uint2korr(pos+1);
+  }
+  if (*pos == 253 && pos+4 <= end)
+  {
+    (*packet)+=4;
+    return (ulong) uint3korr(pos+1);
+  }
+  if (*pos == 254 && pos+9 <= end)
+  {
+    (*packet)+=9;
+    return (ulong) uint4korr(pos+1);
+  }
+  return ~(ulong) 0;
+}
+
+
+static bool get_params(Prepared_statement *stmt, STMT_PARAM *params,
+		       uchar *pos, uchar *end)
+{
+  uchar *null_bits=pos;
+  uchar *types=null_bits+(stmt->param_count+7)/8;
+  uint i;
+
+  pos=types+stmt->param_count*2;
+  if (pos > end)
+    return 1;
+  for (i=0 ; i < stmt->param_count ; i++)
+  {
+    STMT_PARAM *param=params+i;
+    uint type=uint2korr(types+i*2);
+    param->unsigned_flag= test(type & 0x8000);
+    param->type=INT_RESULT;
+    param->null_value=0;
+    if ((null_bits[i/8] & (1 << (i & 7))) ||
+	(type&= 0x7fff) == FIELD_TYPE_NULL)
+    {
+      param->null_value=1;
+      continue;
+    }
+    switch ((enum enum_field_types) type) {
+    case FIELD_TYPE_TINY:
+      if (pos+1 > end)
+	return 1;
+      param->int_value= (param->unsigned_flag ? (longlong) pos[0] :
+			 (longlong) (signed char) pos[0]);
+      pos++;
+      break;
+    case FIELD_TYPE_SHORT:
+      if (pos+2 > end)
+	return 1;
+      param->int_value= (param->unsigned_flag ? (longlong) uint2korr(pos) :
+			 (longlong) sint2korr(pos));
+      pos+=2;
+      break;
+    case FIELD_TYPE_INT24:
+    case FIELD_TYPE_LONG:
+      if (pos+4 > end)
+	return 1;
+      param->int_value= (param->unsigned_flag ? (longlong) uint4korr(pos) :
+			 (longlong) sint4korr(pos));
+      pos+=4;
+      break;
+    case FIELD_TYPE_LONGLONG:
+      if (pos+8 > end)
+	return 1;
+      param->int_value= sint8korr(pos);
+      pos+=8;
+      break;
+    case FIELD_TYPE_FLOAT:
+    {
+      float nr;
+      if (pos+4 > end)
+	return 1;
+      float4get(nr,pos);
+      param->real_value=(double) nr;
+      param->type=REAL_RESULT;
+      pos+=4;
+      break;
+    }
+    case FIELD_TYPE_DOUBLE:
+      if (pos+8 > end)
+	return 1;
+      float8get(param->real_value,pos);
+      param->type=REAL_RESULT;
+      pos+=8;
+      break;
+    default:
+      if ((param->length=get_param_length(&pos,end)) > (ulong) (end-pos))
+	return 1;
+      param->str_value=(char*) pos;
+      param->type=STRING_RESULT;
+      pos+=param->length;
+      break;
+    }
+  }
+  return 0;
+}
+
+
+/* Store a parameter as a SQL literal; to must have room for it */
+
+static char *store_param_literal(char *to, STMT_PARAM *param)
+{
+  if (param->null_value)
+    return strmov(to,"NULL");
+  switch (param->type) {
+  case INT_RESULT:
+    return longlong10_to_str(param->int_value,to,
+			     param->unsigned_flag ? 10 : -10);
+  case REAL_RESULT:
+    if (param->real_value - param->real_value != 0.0)
+      return strmov(to,"NULL");			// inf or nan has no literal
+    sprintf(to,"%.17g",param->real_value);
+    return strend(to);
+  default:
+    break;
+  }
+  const char *from=param->str_value, *end=from+param->length;
+  *to++= '\'';
+  for ( ; from != end ; from++)
+  {
+#ifdef USE_MB
+    int l;
+    if (use_mb(default_charset_info) &&
+	(l=my_ismbchar(default_charset_info,from,end)))
+    {
+      while (l--)
+	*to++= *from++;
+      from--;
+      continue;
+    }
+#endif
+    switch (*from) {
+    case 0:
+      *to++= '\\';
+      *to++= '0';
+      break;
+    case '\n':
+      *to++= '\\';
+      *to++= 'n';
+      break;
+    case '\r':
+      *to++= '\\';
+      *to++= 'r';
+      break;
+    case '\\':
+      *to++= '\\';
+      *to++= '\\';
+      break;
+    case '\'':
+      *to++= '\\';
+      *to++= '\'';
+      break;
+    case '\032':				// Win32 end of file
+      *to++= '\\';
+      *to++= 'Z';
+      break;
+    default:
+      *to++= *from;
+    }
+  }
+  *to++= '\'';
+  return to;
+}
+
+
+/*
+  Make the query to run for COM_EXECUTE
+
+  SYNOPSIS
+    expand_query()
+    thd			Thread handler; the query is allocated here
+    stmt		Statement
+    params		Values of the '?' in the statement
+    length		Length of the query is stored here
+
+  RETURN
+    0	    Out of memory
+    #	    Query with the '?' replaced by the values
+*/
+
+static char *expand_query(THD *thd, Prepared_statement *stmt,
+			  STMT_PARAM *params, uint *length)
+{
+  uint i,alloc_length=stmt->query_length+1;
+  const char *from=stmt->query;
+  char *query,*to;
+
+  for (i=0 ; i < stmt->param_count ; i++)
+  {
+    STMT_PARAM *param=params+i;
+    if (param->null_value)
+      alloc_length+=4;
+    else if (param->type == INT_RESULT)
+      alloc_length+=21;
+    else if (param->type == REAL_RESULT)
+      alloc_length+=32;
+    else
+      alloc_length+=param->length*2+2;
+  }
+  if (!(to=query=(char*) thd->alloc(alloc_length)))
+    return 0;
+  for (i=0 ; i < stmt->param_count ; i++)
+  {
+    const char *pos=stmt->query+stmt->param_pos[i];
+    memcpy(to,from,(uint) (pos-from));
+    to+= (uint) (pos-from);
+    from=pos+1;					// Skip '?'
+    to=store_param_literal(to,params+i);
+  }
+  to=strmov(to,from);
+  *length=(uint) (to-query);
+  return query;
+}
+
+
+/*
+  Run a statement with its plan
+
+  RETURN
+    0  The statement is done (result or error is sent)
+    1  The plan can't be used; run the statement as a query
+*/
+
+static bool execute_plan(THD *thd, Prepared_statement *stmt,
+			 STMT_PARAM *params)
+{
+  STMT_PLAN *plan=stmt->plan;
+  TABLE_LIST tables;
+  TABLE *table;
+  KEY *keyinfo;
+  KEY_PART_INFO *key_part;
+  List<Item> field_list;
+  byte *key;
+  bool found=1;
+  uint i;
+  int error;
+  DBUG_ENTER("execute_plan");
+
+  if (thd->locked_tables || !thd->variables.select_limit)
+    DBUG_RETURN(1);
+  for (i=0 ; i < plan->key_parts ; i++)
+  {
+    uint nr=plan->key_part[i].param;
+    if (nr != NO_PARAM && !params[nr].null_value &&
+	params[nr].type != INT_RESULT)
+      DBUG_RETURN(1);
+  }
+
+  bzero((char*) &tables,sizeof(tables));
+  if (!(tables.db= plan->db ? plan->db : thd->db))
+    DBUG_RETURN(1);
+  tables.real_name=plan->table_name;
+  tables.alias=plan->alias;
+  if (check_table_access(thd,SELECT_ACL,&tables,1) ||
+      !(tables.grant.privilege & SELECT_ACL))
+    DBUG_RETURN(1);
+
+  mysql_init_query(thd);
+  if (!(table=open_ltable(thd,&tables,plan->lock_type)))
+  {
+    statistic_increment(com_stat[SQLCOM_SELECT],&LOCK_status);
+    send_error(&thd->net,0);
+    DBUG_RETURN(0);
+  }
+
+  /* Check that the table has not been changed since the prepare */
+  keyinfo=table->key_info+plan->keynr;
+  if (plan->keynr >= table->keys ||
+      my_strcasecmp(keyinfo->name,plan->key_name) ||
+      !stmt_key_usable(table,plan->keynr,plan->key_parts))
+    goto use_query;
+  for (i=0, key_part=keyinfo->key_part ; i < plan->key_parts ; i++,key_part++)
+  {
+    if (my_strcasecmp(key_part->field->field_name,
+		      plan->key_part[i].field_name))
+      goto use_query;
+  }
+  for (i=0 ; i < plan->columns ; i++)
+  {
+    STMT_COLUMN *column=plan->column+i;
+    Item *item;
+    if (!column->field_name)
+    {
+      for (Field **ptr=table->field ; *ptr ; ptr++)
+      {
+	if (!(item=new Item_field(*ptr)) || field_list.push_back(item))
+	  goto use_query;
+	(*ptr)->query_id=thd->query_id;
+      }
+      continue;
+    }
+    if (column->fieldnr >= table->fields ||
+	my_strcasecmp(table->field[column->fieldnr]->field_name,
+		      column->field_name) ||
+	!(item=new Item_field(table->field[column->fieldnr])) ||
+	field_list.push_back(item))
+      goto use_query;
+    item->name=(char*) column->name;
+    table->field[column->fieldnr]->query_id=thd->query_id;
+  }
+  statistic_increment(com_stat[SQLCOM_SELECT],&LOCK_status);
+
+  /* Make the key; a value that doesn't fit in the column gives no row */
+  for (i=0, key_part=keyinfo->key_part ; i < plan->key_parts ; i++,key_part++)
+  {
+    STMT_KEY_PART *part=plan->key_part+i;
+    Field *field=key_part->field;
+    longlong nr=part->value;
+    bool unsigned_flag=part->unsigned_flag;
+    if (part->param != NO_PARAM)
+    {
+      STMT_PARAM *param=params+part->param;
+      if (param->null_value)
+      {
+	found=0;				// Nothing is = NULL
+	break;
+      }
+      nr=param->int_value;
+      unsigned_flag=param->unsigned_flag;
+    }
+    field->query_id=thd->query_id;
+    if (nr < 0 && unsigned_flag != ((Field_num*) field)->unsigned_flag)
+    {
+      found=0;
+      break;
+    }
+    field->set_notnull();
+    field->store(nr);
+    if (field->val_int() != nr)
+    {
+      found=0;
+      break;
+    }
+  }
+  if (found)
+  {
+    if (!(key=(byte*) thd->alloc(keyinfo->key_length)))
+    {
+      send_error(&thd->net,ER_OUT_OF_RESOURCES);
+      goto end;
+    }
+    key_copy(key,table,plan->keynr,0);
+    thd->proc_info="Sending data";
+    if ((error=table->file->index_read_idx(table->record[0],plan->keynr,
+					   key,keyinfo->key_length,
+					   HA_READ_KEY_EXACT)))
+    {
+      if (error != HA_ERR_KEY_NOT_FOUND && error != HA_ERR_END_OF_FILE)
+      {
+	table->file->print_error(error,MYF(0));
+	send_error(&thd->net,0);
+	goto end;
+      }
+      found=0;
+    }
+  }
+  thd->examined_row_count= (ha_rows) found;
+
+#ifdef HAVE_INNOBASE_DB
+  /* Release the InnoDB adaptive hash S-latch before sending to client */
+  if (thd->transaction.all.innobase_tid)
+    ha_release_temporary_latches(thd);
+#endif
+  if (send_fields(thd,field_list,1))
+    goto end;
+  if (found)
+  {
+    if (net_store_binary_row(thd,&thd->packet,field_list))
+    {
+      send_error(&thd->net,ER_OUT_OF_RESOURCES);
+      goto end;
+    }
+    if (my_net_write(&thd->net,(char*) thd->packet.ptr(),
+		     thd->packet.length()))
+      goto end;
+  }
+  thd->sent_row_count=thd->limit_found_rows= (ha_rows) found;
+  send_eof(&thd->net);
+  statistic_increment(prepared_stmt_plan_hits,&LOCK_status);
+
+end:
+  thd->proc_info=0;
+  free_items(thd);
+  DBUG_RETURN(0);
+
+use_query:
+  close_thread_tables(thd);
+  free_items(thd);
+  DBUG_RETURN(1);
+}
+
+
+/*
+  COM_PREPARE: Parse a query and store it as a prepared statement
+
+  SYNOPSIS
+    mysql_stmt_prepare()
+    thd			Thread handler
+    packet		Query
+    packet_length	Length of query
+*/
+
+void mysql_stmt_prepare(THD *thd, char *packet, uint packet_length)
+{
+  NET *net= &thd->net;
+  Prepared_statement *stmt;
+  LEX *lex;
+  char buff[7];
+  DBUG_ENTER("mysql_stmt_prepare");
+
+  statistic_increment(com_stmt_prepare,&LOCK_status);
+  /* Remove garbage at start and end of query, as for COM_QUERY */
+  while (packet_length > 0 && isspace(packet[0]))
+  {
+    packet++;
+    packet_length--;
+  }
+  while (packet_length > 0 && (packet[packet_length-1] == ';' ||
+			       isspace(packet[packet_length-1])))
+    packet_length--;
+
+  /*
+    The query is parsed from a copy, as the parser may change the query
+    (character set conversion of strings)
+  */
+  if (!(stmt=new Prepared_statement(thd->last_stmt_id+1)) ||
+      !(stmt->query=strmake_root(&stmt->mem_root,packet,packet_length)) ||
+      !(thd->query=(char*) thd->memdup(packet,packet_length+1)))
+  {
+    delete stmt;
+    send_error(net,ER_OUT_OF_RESOURCES);
+    DBUG_VOID_RETURN;
+  }
+  stmt->query_length=packet_length;
+  thd->query[packet_length]=0;
+  mysql_log.write(thd,COM_PREPARE,"%s",thd->query);
+  DBUG_PRINT("query",("%-.4096s",thd->query));
+
+  mysql_init_query(thd);
+  thd->query_length=packet_length;
+  lex=lex_start(thd,(uchar*) thd->query,packet_length);
+  if (yyparse() || thd->fatal_error)
+    goto err;					// Error is already sent
+  if (!stmt_command_allowed(lex->sql_command))
+  {
+    send_error(net,ER_NOT_ALLOWED_COMMAND);
+    goto err;
+  }
+  if ((stmt->param_count=lex->param_list.elements))
+  {
+    List_iterator_fast<Item> it(lex->param_list);
+    Item_param *param;
+    uint i;
+    if (!(stmt->param_pos=(uint*) alloc_root(&stmt->mem_root,
+					     sizeof(uint)*stmt->param_count)))
+    {
+      send_error(net,ER_OUT_OF_RESOURCES);
+      goto err;
+    }
+    for (i=0 ; (param=(Item_param*) it++) ; i++)
+    {
+      if (param->pos_in_query >= packet_length ||
+	  stmt->query[param->pos_in_query] != '?')
+      {
+	send_error(net,ER_SYNTAX_ERROR);
+	goto err;
+      }
+      stmt->param_pos[i]=param->pos_in_query;
+    }
+  }
+  if (make_stmt_plan(thd,stmt))
+    goto err;
+  free_items(thd);
+  lex_end(lex);
+
+  stmt->next=thd->prepared_stmts;
+  thd->prepared_stmts=stmt;
+  thd->last_stmt_id=stmt->id;
+  buff[0]=0;
+  int4store(buff+1,stmt->id);
+  int2store(buff+5,stmt->param_count);
+  VOID(my_net_write(net,buff,sizeof(buff)));
+  VOID(net_flush(net));
+  DBUG_VOID_RETURN;
+
+err:
+  free_items(thd);
+  lex_end(lex);
+  delete stmt;
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  COM_EXECUTE: Run a prepared statement
+
+  SYNOPSIS
+    mysql_stmt_execute()
+    thd			Thread handler
+    packet		Statement id and parameters
+    packet_length	Length of packet
+*/
+
+void mysql_stmt_execute(THD *thd, char *packet, uint packet_length)
+{
+  NET *net= &thd->net;
+  Prepared_statement *stmt;
+  STMT_PARAM *params=0;
+  char *query;
+  uint length;
+  DBUG_ENTER("mysql_stmt_execute");
+
+  statistic_increment(com_stmt_execute,&LOCK_status);
+  if (packet_length < 4 ||
+      !(stmt=find_statement(thd,(ulong) uint4korr(packet))))
+  {
+    net_printf(net,ER_WRONG_ARGUMENTS,"EXECUTE");
+    DBUG_VOID_RETURN;
+  }
+  if (stmt->param_count &&
+      !(params=(STMT_PARAM*) thd->alloc(sizeof(STMT_PARAM)*
+					stmt->param_count)))
+  {
+    send_error(net,ER_OUT_OF_RESOURCES);
+    DBUG_VOID_RETURN;
+  }
+  if (get_params(stmt,params,(uchar*) packet+4,
+		 (uchar*) packet+packet_length))
+  {
+    net_printf(net,ER_WRONG_ARGUMENTS,"EXECUTE");
+    DBUG_VOID_RETURN;
+  }
+
+  thd->binary_rows=1;
+  if (stmt->plan)
+  {
+    thd->query=stmt->query;
+    thd->query_length=stmt->query_length;
+    if (mysql_log.is_open() &&
+	(query=expand_query(thd,stmt,params,&length)))
+      mysql_log.write(thd,COM_EXECUTE,"%s",query);
+    if (!execute_plan(thd,stmt,params))
+      goto end;
+  }
+  if (!(query=expand_query(thd,stmt,params,&length)))
+  {
+    send_error(net,ER_OUT_OF_RESOURCES);
+    goto end;
+  }
+  thd->query=query;
+  if (!stmt->plan)
+    mysql_log.write(thd,COM_EXECUTE,"%s",query);
+  DBUG_PRINT("query",("%-.4096s",query));
+  mysql_parse(thd,query,length);
+
+end:
+  thd->binary_rows=0;
+  thd->binary_row_types=0;
+  DBUG_VOID_RETURN;
+}
+
+
+/* COM_CLOSE_STMT: Free a prepared statement. Nothing is sent to client */
+
+void mysql_stmt_close(THD *thd, char *packet, uint packet_length)
+{
+  Prepared_statement **prev,*stmt;
+  ulong id;
+  DBUG_ENTER("mysql_stmt_close");
+
+  statistic_increment(com_stmt_close,&LOCK_status);
+  if (packet_length < 4)
+    DBUG_VOID_RETURN;
+  id=(ulong) uint4korr(packet);
+  for (prev= &thd->prepared_stmts ; (stmt= *prev) ; prev= &stmt->next)
+  {
+    if (stmt->id == id)
+    {
+      *prev=stmt->next;
+      delete stmt;
+      break;
+    }
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+/* Free all prepared statements of a connection */
+
+void free_prepared_statements(THD *thd)
+{
+  Prepared_statement *stmt,*next;
+  for (stmt=thd->prepared_stmts ; stmt ; stmt=next)
+  {
+    next=stmt->next;
+    delete stmt;
+  }
+  thd->prepared_stmts=0;
+}
@@ -0,0 +1,264 @@
+/* Copyright (C) 2003 MySQL AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Profiling of statements for SHOW PROFILES and SHOW PROFILE;
+  See sql_profile.h
+*/
+
+#include "mysql_priv.h"
+#ifdef HAVE_INNOBASE_DB
+#include "ha_innodb.h"
+#endif
+
+
+PROFILING::PROFILING()
+  :history(0), current(0), history_size(0), history_count(0),
+   history_next(0), last_query_id(0)
+{}
+
+
+PROFILING::~PROFILING()
+{
+  my_free((gptr) history, MYF(MY_ALLOW_ZERO_PTR));
+}
+
+
+void PROFILING::read_counters(ulong *read_requests, ulong *reads,
+			      ulong *pages)
+{
+  get_key_cache_reads(read_requests, reads);
+  *pages= 0;
+#ifdef HAVE_INNOBASE_DB
+  if (have_innodb == SHOW_OPTION_YES)
+    *pages= innobase_get_pages_read();
+#endif
+}
+
+
+/* Find the stage with the given name, or add it */
+
+uint PROFILING::find_stage(const char *name)
+{
+  PROFILE_STAGE *stage, *end= current->stages + current->stage_count;
+  for (stage= current->stages ; stage != end ; stage++)
+  {
+    if (stage->status == name || !strcmp(stage->name, name))
+    {
+      stage->status= name;
+      return (uint) (stage - current->stages);
+    }
+  }
+  if (current->stage_count == PROFILE_MAX_STAGES)
+    return PROFILE_MAX_STAGES-1;		// Is "other stages"
+  bzero((char*) stage, sizeof(*stage));
+  stage->status= name;
+  strmake(stage->name,
+	  current->stage_count == PROFILE_MAX_STAGES-1 ? "other stages" : name,
+	  sizeof(stage->name)-1);
+  return current->stage_count++;
+}
+
+
+/* Add the time and reads since the last call to the current stage */
+
+void PROFILING::end_stage(uint next_stage)
+{
+  PROFILE_STAGE *stage= current->stages + current_stage;
+  ulonglong now= my_getsystime();
+  ulong read_requests, reads, pages;
+
+  read_counters(&read_requests, &reads, &pages);
+  stage->duration+= now - stage_start;
+  stage->key_read_requests+= read_requests - key_read_requests;
+  stage->key_reads+= reads - key_reads;
+  stage->pages_read+= pages - pages_read;
+  stage_start= now;
+  key_read_requests= read_requests;
+  key_reads= reads;
+  pages_read= pages;
+  current_stage= next_stage;
+}
+
+
+uint PROFILING::switch_stage(const char *name)
+{
+  uint old_stage= current_stage;
+  uint stage= find_stage(name);
+  if (stage != old_stage)
+  {
+    end_stage(stage);
+    current->stages[stage].calls++;
+  }
+  return old_stage;
+}
+
+
+/* Called at start of a query; Does nothing if profiling is not on */
+
+void PROFILING::start_query(THD *thd)
+{
+  uint size= (uint) thd->variables.profiling_history_size;
+  current= 0;
+  discard_query= 0;
+  if (!thd->variables.profiling || !size)
+    return;
+  if (size != history_size)
+  {
+    /* The old history is forgotten when the size is changed */
+    my_free((gptr) history, MYF(MY_ALLOW_ZERO_PTR));
+    history_size= history_count= history_next= 0;
+    if (!(history= (QUERY_PROFILE*) my_malloc(sizeof(QUERY_PROFILE)*size,
+					      MYF(0))))
+      return;
+    history_size= size;
+  }
+  current= history + history_next;
+  current->stage_count= 0;
+  query_start= stage_start= my_getsystime();
+  read_counters(&key_read_requests, &key_reads, &pages_read);
+  current_stage= find_stage("starting");
+  current->stages[current_stage].calls= 1;
+}
+
+
+/* Called at end of a query; Stores the profile in the history */
+
+void PROFILING::end_query(THD *thd)
+{
+  if (!current)
+    return;
+  end_stage(current_stage);
+  if (!discard_query)
+  {
+    current->query_id= ++last_query_id;
+    current->duration= stage_start - query_start;
+    strmake(current->query, thd->query ? thd->query : "",
+	    min(thd->query_length, PROFILE_QUERY_LENGTH));
+    history_next= (history_next+1) % history_size;
+    if (history_count < history_size)
+      history_count++;
+  }
+  current= 0;
+}
+
+
+/* Store the rows examined in a table of a join */
+
+void PROFILING::add_rows(const char *name, const char *table_name,
+			 ha_rows rows)
+{
+  char buff[PROFILE_STAGE_LENGTH];
+  PROFILE_STAGE *stage;
+  if (!current)
+    return;
+  strxnmov(buff, sizeof(buff)-1, name, " ", table_name, NullS);
+  stage= current->stages + find_stage(buff);
+  stage->rows+= rows;
+  stage->status= 0;				// buff is not kept
+}
+
+
+QUERY_PROFILE *PROFILING::find_query(ulong query_id)
+{
+  for (uint i= 0 ; i < history_count ; i++)
+  {
+    QUERY_PROFILE *query= (history +
+			   (history_next + history_size - 1 - i) %
+			   history_size);
+    if (!query_id || query->query_id == query_id)
+      return query;
+  }
+  return 0;
+}
+
+
+static void store_duration(String *packet, ulonglong duration)
+{
+  char buff[32];
+  sprintf(buff, "%.6f", (double) duration / 10000000.0);
+  net_store_data(packet, buff);
+}
+
+
+int PROFILING::show_profiles(THD *thd)
+{
+  String *packet= &thd->packet;
+  List<Item> field_list;
+  DBUG_ENTER("PROFILING::show_profiles");
+
+  field_list.push_back(new Item_empty_string("Query_ID", 10));
+  field_list.push_back(new Item_empty_string("Duration", 12));
+  field_list.push_back(new Item_empty_string("Query", PROFILE_QUERY_LENGTH));
+  if (send_fields(thd, field_list, 1))
+    DBUG_RETURN(-1);
+
+  for (uint i= 0 ; i < history_count ; i++)
+  {
+    QUERY_PROFILE *query= (history +
+			   (history_next + history_size - history_count + i) %
+			   history_size);
+    packet->length(0);
+    net_store_data(packet, (uint32) query->query_id);
+    store_duration(packet, query->duration);
+    net_store_data(packet, query->query);
+    if (my_net_write(&thd->net, (char*) packet->ptr(), packet->length()))
+      DBUG_RETURN(-1);
+  }
+  send_eof(&thd->net);
+  DBUG_RETURN(0);
+}
+
+
+/* Show the stages of a query; query_id 0 is the last query */
+
+int PROFILING::show_profile(THD *thd, ulong query_id)
+{
+  String *packet= &thd->packet;
+  List<Item> field_list;
+  QUERY_PROFILE *query;
+  DBUG_ENTER("PROFILING::show_profile");
+
+  field_list.push_back(new Item_empty_string("Status", PROFILE_STAGE_LENGTH));
+  field_list.push_back(new Item_empty_string("Calls", 10));
+  field_list.push_back(new Item_empty_string("Duration", 12));
+  field_list.push_back(new Item_empty_string("Rows_examined", 12));
+  field_list.push_back(new Item_empty_string("Key_read_requests", 10));
+  field_list.push_back(new Item_empty_string("Key_reads", 10));
+  field_list.push_back(new Item_empty_string("Innodb_pages_read", 10));
+  if (send_fields(thd, field_list, 1))
+    DBUG_RETURN(-1);
+
+  if ((query= find_query(query_id)))
+  {
+    PROFILE_STAGE *stage, *end= query->stages + query->stage_count;
+    for (stage= query->stages ; stage != end ; stage++)
+    {
+      packet->length(0);
+      net_store_data(packet, stage->name);
+      net_store_data(packet, (uint32) stage->calls);
+      store_duration(packet, stage->duration);
+      net_store_data(packet, (longlong) stage->rows);
+      net_store_data(packet, (uint32) stage->key_read_requests);
+      net_store_data(packet, (uint32) stage->key_reads);
+      net_store_data(packet, (uint32) stage->pages_read);
+      if (my_net_write(&thd->net, (char*) packet->ptr(), packet->length()))
+	DBUG_RETURN(-1);
+    }
+  }
+  send_eof(&thd->net);
+  DBUG_RETURN(0);
+}
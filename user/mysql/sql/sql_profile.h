@@ -0,0 +1,102 @@
+/* Copyright (C) 2003 MySQL AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#ifndef _SQL_PROFILE_H
+#define _SQL_PROFILE_H
+
+/*
+  Profiling of the statements of a connection, for SHOW PROFILES and
+  SHOW PROFILE
+
+  When the variable 'profiling' is set, each query is split in stages;
+  A new stage starts each time thd->set_proc_info() is called, and a few
+  places (parsing, filesort, writes to the client) measure a nested stage
+  and then resume the stage they were called in. The time of all calls to
+  a stage is added together, as are the key cache and InnoDB buffer pool
+  reads done during the stage. These reads are counted for the whole
+  server, so they include the reads of other connections. Rows examined
+  in each table of a join are stored as a stage with no time.
+
+  The last 'profiling_history_size' queries are kept. SHOW PROFILE and
+  SHOW PROFILES themselves are not stored.
+*/
+
+#define PROFILE_MAX_STAGES	32		/* Stages per query */
+#define PROFILE_STAGE_LENGTH	(NAME_LEN+16)	/* "examining " + table */
+#define PROFILE_QUERY_LENGTH	300		/* Start of query kept */
+#define PROFILE_MAX_HISTORY	100
+
+typedef struct st_profile_stage
+{
+  const char *status;			/* Last pointer given for name */
+  char name[PROFILE_STAGE_LENGTH];
+  ulonglong duration;			/* In 1/10 microseconds */
+  ulong calls;
+  ha_rows rows;				/* Rows examined in a table */
+  ulong key_read_requests,key_reads,pages_read;
+} PROFILE_STAGE;
+
+typedef struct st_query_profile
+{
+  ulong query_id;			/* Number in this connection */
+  ulonglong duration;
+  uint stage_count;
+  char query[PROFILE_QUERY_LENGTH+1];
+  PROFILE_STAGE stages[PROFILE_MAX_STAGES];
+} QUERY_PROFILE;
+
+class PROFILING
+{
+  QUERY_PROFILE *history, *current;
+  uint history_size, history_count, history_next;
+  ulong last_query_id;
+  uint current_stage;
+  bool discard_query;
+  ulonglong query_start, stage_start;
+  ulong key_read_requests, key_reads, pages_read;
+
+  void read_counters(ulong *read_requests, ulong *reads, ulong *pages);
+  uint find_stage(const char *name);
+  void end_stage(uint next_stage);
+  QUERY_PROFILE *find_query(ulong query_id);
+
+public:
+  PROFILING();
+  ~PROFILING();
+  void start_query(THD *thd);
+  void end_query(THD *thd);
+  void add_rows(const char *name, const char *table_name, ha_rows rows);
+  uint switch_stage(const char *name);
+
+  /* Start a stage; Returns the old stage for resume() */
+  inline uint status(const char *name)
+  {
+    return current ? switch_stage(name) : 0;
+  }
+  inline void resume(uint stage)
+  {
+    if (current)
+      end_stage(stage);
+  }
+  inline bool enabled() { return current != 0; }
+  /* Don't store the current query in the history */
+  inline void discard() { discard_query= 1; }
+
+  int show_profiles(THD *thd);
+  int show_profile(THD *thd, ulong query_id);
+};
+
+#endif /* _SQL_PROFILE_H */
@@ -39,6 +39,7 @@ static bool make_join_statistics(JOIN *join,TABLE_LIST *tables,COND *conds,
 static bool update_ref_and_keys(THD *thd, DYNAMIC_ARRAY *keyuse,
 				JOIN_TAB *join_tab,
                                 uint tables,COND *conds,table_map table_map);
+static bool make_hash_join_conds(JOIN *join,JOIN_TAB *stat,COND *cond);
 static int sort_keyuse(KEYUSE *a,KEYUSE *b);
 static void set_position(JOIN *join,uint index,JOIN_TAB *table,KEYUSE *key);
 static bool create_ref_for_key(JOIN *join, JOIN_TAB *j, KEYUSE *org_keyuse,
@@ -47,6 +48,10 @@ static void find_best_combination(JOIN *join,table_map rest_tables);
 static void find_best(JOIN *join,table_map rest_tables,uint index,
 		      double record_count,double read_time);
 static uint cache_record_length(JOIN *join,uint index);
+static bool hash_join_cost(JOIN *join,JOIN_TAB *s,uint idx,
+			   table_map rest_tables,double record_count,
+			   ha_rows rnd_records,double scan_time,double fills,
+			   uint cache_length,double *read_time);
 static double prev_record_reads(JOIN *join,table_map found_ref);
 static bool get_best_combination(JOIN *join);
 static store_key *get_store_key(THD *thd,
@@ -75,14 +80,22 @@ static bool create_myisam_tmp_table(TABLE *table,TMP_TABLE_PARAM *param,
 static int do_select(JOIN *join,List<Item> *fields,TABLE *tmp_table,
 		     Procedure *proc);
 static int sub_select_cache(JOIN *join,JOIN_TAB *join_tab,bool end_of_records);
+static int sub_select_hash(JOIN *join,JOIN_TAB *join_tab,bool end_of_records);
 static int sub_select(JOIN *join,JOIN_TAB *join_tab,bool end_of_records);
 static int flush_cached_records(JOIN *join,JOIN_TAB *join_tab,bool skipp_last);
+static int flush_hashed_records(JOIN *join,JOIN_TAB *join_tab);
+static int flush_batched_keys(JOIN *join,JOIN_TAB *join_tab);
+static int spill_hashed_records(JOIN_TAB *join_tab);
+static int join_hash_partitions(JOIN *join,JOIN_TAB *join_tab);
 static int end_send(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static int end_send_group(JOIN *join, JOIN_TAB *join_tab,bool end_of_records);
 static int end_write(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static int end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static int end_unique_update(JOIN *join,JOIN_TAB *join_tab,
 			     bool end_of_records);
+static int end_update_hash(JOIN *join,JOIN_TAB *join_tab,bool end_of_records);
+static bool setup_group_hash(JOIN *join,TABLE *table);
+static int flush_group_hash(JOIN *join);
 static int end_write_group(JOIN *join, JOIN_TAB *join_tab,
 			   bool end_of_records);
 static int test_if_group_changed(List<Item_buff> &list);
@@ -97,6 +110,7 @@ static int join_read_next(READ_RECORD *info);
 static int join_init_quick_read_record(JOIN_TAB *tab);
 static int test_if_quick_select(JOIN_TAB *tab);
 static int join_init_read_record(JOIN_TAB *tab);
+static void join_init_read_batch(JOIN *join,JOIN_TAB *tab,uint options);
 static int join_read_first(JOIN_TAB *tab);
 static int join_read_next(READ_RECORD *info);
 static int join_read_next_same(READ_RECORD *info);
@@ -121,10 +135,21 @@ static int remove_dup_with_hash_index(THD *thd, TABLE *table,
 				      uint field_count, Field **first_field,
 				      ulong key_length,Item *having);
 static int join_init_cache(THD *thd,JOIN_TAB *tables,uint table_count);
+static bool init_cache_fields(THD *thd,JOIN_CACHE *cache,JOIN_TAB *tables,
+			      uint table_count);
+static bool join_init_hash(JOIN *join,JOIN_TAB *tab,uint options);
+static bool test_if_batched_key_access(JOIN *join,JOIN_TAB *tab,uint idx);
+static void join_init_batched_keys(JOIN *join,JOIN_TAB *tab,uint options);
+static void join_end_hash(JOIN_HASH *hash);
+static bool join_hash_key(JOIN_HASH *hash,bool inner,uint32 *hashnr);
+static void join_hash_insert(JOIN_HASH *hash,JOIN_HASH_LINK *link,
+			     bool calc_hash);
+static void join_hash_reset(JOIN_CACHE *cache);
+static int join_hash_probe(JOIN *join,JOIN_TAB *join_tab,uint32 hashnr);
 static ulong used_blob_length(CACHE_FIELD **ptr);
 static bool store_record_in_cache(JOIN_CACHE *cache);
 static void reset_cache(JOIN_CACHE *cache);
-static void read_cached_record(JOIN_TAB *tab);
+static void read_cached_record(JOIN_CACHE *cache);
 static bool cmp_buffer_with_ref(JOIN_TAB *tab);
 static int setup_group(THD *thd,TABLE_LIST *tables,List<Item> &fields,
 		       List<Item> &all_fields, ORDER *order, bool *hidden);
@@ -228,7 +253,7 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
   select=0;
   no_order=skip_sort_order=0;
   bzero((char*) &keyuse,sizeof(keyuse));
-  thd->proc_info="init";
+  thd->set_proc_info("init");
   thd->used_tables=0;				// Updated by setup_fields
   /* select_limit is used to decide if we are likely to scan the whole table */
   select_limit= thd->select_limit;
@@ -330,11 +355,15 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
   join.tmp_table_param.end_write_records= HA_POS_ERROR;
   join.first_record=join.sort_and_group=0;
   join.select_options=select_options;
+  /* No join cache for MATCH */
+  if (cur_sel->ftfunc_list.elements)
+    join.select_options|= SELECT_NO_JOIN_CACHE;
   join.result=result;
   count_field_types(&join.tmp_table_param,all_fields,0);
   join.const_tables=0;
   join.having=0;
   join.do_send_rows = 1;
+  join.group_hash=0;
   join.group= group != 0;
   join.row_limit= ((select_distinct || order || group) ? HA_POS_ERROR :
 		   thd->select_limit);
@@ -448,11 +477,11 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
   join.sort_by_table=get_sort_by_table(order,group,tables);
 
   /* Calculate how to do the join */
-  thd->proc_info="statistics";
+  thd->set_proc_info("statistics");
   if (make_join_statistics(&join,tables,conds,&keyuse) || thd->fatal_error)
     goto err;
 
-  thd->proc_info="preparing";
+  thd->set_proc_info("preparing");
 
   select_distinct= select_distinct && (join.const_tables != join.tables);
 
@@ -629,12 +658,9 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
 	      (group && order) || 
 	      test(select_options & OPTION_BUFFER_RESULT)));
 
-  // No cache for MATCH
   make_join_readinfo(&join,
-		     (select_options & (SELECT_DESCRIBE |
-					SELECT_NO_JOIN_CACHE)) |
-		     (cur_sel->ftfunc_list.elements ? SELECT_NO_JOIN_CACHE :
-		      0));
+		     join.select_options & (SELECT_DESCRIBE |
+					    SELECT_NO_JOIN_CACHE));
   /*
     Need to tell Innobase that to play it safe, it should fetch all
     columns of the tables: this is because MySQL may build row
@@ -705,7 +731,7 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
   if (need_tmp)
   {
     DBUG_PRINT("info",("Creating tmp table"));
-    thd->proc_info="Creating tmp table";
+    thd->set_proc_info("Creating tmp table");
 
     join.tmp_table_param.hidden_field_count= (all_fields.elements -
 					      fields.elements);
@@ -728,7 +754,7 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
     if (group && simple_group)
     {
       DBUG_PRINT("info",("Sorting for group"));
-      thd->proc_info="Sorting for group";
+      thd->set_proc_info("Sorting for group");
       if (create_sort_index(&join.join_tab[join.const_tables],group,
 			    HA_POS_ERROR, HA_POS_ERROR) ||
 	  make_sum_func_list(&join,all_fields) ||
@@ -743,7 +769,7 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
       if (!group && ! tmp_table->distinct && order && simple_order)
       {
 	DBUG_PRINT("info",("Sorting for order"));
-	thd->proc_info="Sorting for order";
+	thd->set_proc_info("Sorting for order");
 	if (create_sort_index(&join.join_tab[join.const_tables],order,
 			      HA_POS_ERROR, HA_POS_ERROR))
 	  goto err;				/* purecov: inspected */
@@ -778,7 +804,7 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
     }
 
     /* Copy data to the temporary table */
-    thd->proc_info="Copying to tmp table";
+    thd->set_proc_info("Copying to tmp table");
     if ((tmp_error=do_select(&join,(List<Item> *) 0,tmp_table,0)))
     {
       error=tmp_error;
@@ -846,7 +872,7 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
 	goto err;				/* purecov: inspected */
       if (group)
       {
-	thd->proc_info="Creating sort index";
+	thd->set_proc_info("Creating sort index");
 	if (create_sort_index(join.join_tab,group,HA_POS_ERROR, HA_POS_ERROR) ||
 	    alloc_group_fields(&join,group))
 	{
@@ -855,7 +881,7 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
 	}
 	group=0;
       }
-      thd->proc_info="Copying to group table";
+      thd->set_proc_info("Copying to group table");
       tmp_error= -1;
       if (make_sum_func_list(&join,all_fields) ||
 	  (tmp_error=do_select(&join,(List<Item> *) 0,tmp_table2,0)))
@@ -882,7 +908,7 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
     join_free(&join);				/* Free quick selects */
     if (select_distinct && ! group)
     {
-      thd->proc_info="Removing duplicates";
+      thd->set_proc_info("Removing duplicates");
       if (having)
 	having->update_used_tables();
       if (remove_duplicates(&join,tmp_table,fields, having))
@@ -914,7 +940,7 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
   if (group || order)
   {
     DBUG_PRINT("info",("Sorting for send_fields"));
-    thd->proc_info="Sorting result";
+    thd->set_proc_info("Sorting result");
     /* If we have already done the group, add HAVING to sorted table */
     if (having && ! group && ! join.sort_and_group)
     {
@@ -975,23 +1001,23 @@ mysql_select(THD *thd,TABLE_LIST *tables,List<Item> &fields,COND *conds,
       goto err;
   }
   join.having=having;				// Actually a parameter
-  thd->proc_info="Sending data";
+  thd->set_proc_info("Sending data");
   error=do_select(&join,&fields,NULL,procedure);
 
 err:
   thd->limit_found_rows = join.send_records;
   thd->examined_row_count = join.examined_rows;
-  thd->proc_info="end";
+  thd->set_proc_info("end");
   join.lock=0;					// It's faster to unlock later
   join_free(&join);
-  thd->proc_info="end2";			// QQ
+  thd->set_proc_info("end2");			// QQ
   if (tmp_table)
     free_tmp_table(thd,tmp_table);
-  thd->proc_info="end3";			// QQ
+  thd->set_proc_info("end3");			// QQ
   delete select;
   delete_dynamic(&keyuse);
   delete procedure;
-  thd->proc_info="end4";			// QQ
+  thd->set_proc_info("end4");			// QQ
   DBUG_RETURN(error);
 }
 
@@ -1145,6 +1171,8 @@ make_join_statistics(JOIN *join,TABLE_LIST *tables,COND *conds,
     if (update_ref_and_keys(join->thd,keyuse_array,stat,join->tables,
                             conds,~outer_join))
       DBUG_RETURN(1);
+  if (conds && make_hash_join_conds(join,stat,conds))
+    DBUG_RETURN(1);
 
   /* Read tables with 0 or 1 rows (system tables) */
   join->const_table_map= 0;
@@ -1823,6 +1851,102 @@ update_ref_and_keys(THD *thd, DYNAMIC_ARRAY *keyuse,JOIN_TAB *join_tab,
 }
 
 
+/* Save item in hash_conds of its table if it is a hash join equality */
+
+static bool
+add_hash_join_cond(JOIN *join,JOIN_TAB *stat,Item *item,uint max_conds)
+{
+  Item_bool_func2 *eq=(Item_bool_func2*) item;
+  JOIN_TAB *stat_end=stat+join->tables;
+  Item_result cmp_type;
+
+  if (item->type() != Item::FUNC_ITEM ||
+      eq->functype() != Item_func::EQ_FUNC)
+    return 0;
+  if (eq->cmp_func == &Item_bool_func2::compare_int)
+    cmp_type=INT_RESULT;
+  else if (eq->cmp_func == &Item_bool_func2::compare_real)
+    cmp_type=REAL_RESULT;
+  else if (eq->cmp_func == &Item_bool_func2::compare_string)
+  {
+    cmp_type=STRING_RESULT;
+#ifdef USE_STRCOLL
+    if (!eq->binary && use_strcoll(default_charset_info))
+      return 0;
+#endif
+  }
+  else
+    return 0;
+
+  for (uint i=0 ; i < 2 ; i++)
+  {
+    Item *inner=eq->arguments()[i], *outer=eq->arguments()[1-i];
+    table_map map=inner->used_tables(), outer_map=outer->used_tables();
+    JOIN_TAB *s;
+
+    if (!map || (map & (map-1)) || !outer_map ||
+	((map | outer_map) & RAND_TABLE_BIT) || (outer_map & map))
+      continue;					// Not 'table = other tables'
+    for (s=stat ; s != stat_end && s->table->map != map ; s++) ;
+    if (s == stat_end)
+      continue;
+    if (!s->hash_conds &&
+	!(s->hash_conds=(HASH_JOIN_COND*)
+	  join->thd->alloc(sizeof(HASH_JOIN_COND)*max_conds)))
+      return 1;					/* purecov: inspected */
+    HASH_JOIN_COND *hash_cond=s->hash_conds+s->hash_cond_count++;
+    hash_cond->inner=inner;
+    hash_cond->outer=outer;
+    hash_cond->cmp_type=cmp_type;
+    hash_cond->binary=eq->binary;
+  }
+  return 0;
+}
+
+
+/*
+  Find equalities that a hash join can use
+
+  SYNOPSIS
+    make_hash_join_conds()
+    join		Join
+    stat		Join tabs in table number order
+    cond		WHERE condition
+
+  NOTES
+    Saves in join_tab->hash_conds all 'expr = expr' in the top AND level
+    of WHERE where one side only depends on the table and the other side
+    on other tables. find_best() and join_init_hash() choose among these
+    the ones where the other tables are before the table in the join.
+    Strings compared with strcoll() are not used as we can't make a hash
+    of them that is equal for all strings that compare equal.
+
+  RETURN
+    0	ok
+    1	Out of memory
+*/
+
+static bool
+make_hash_join_conds(JOIN *join,JOIN_TAB *stat,COND *cond)
+{
+  DBUG_ENTER("make_hash_join_conds");
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    List<Item> *list=((Item_cond*) cond)->argument_list();
+    List_iterator_fast<Item> li(*list);
+    Item *item;
+    while ((item=li++))
+    {
+      if (add_hash_join_cond(join,stat,item,list->elements))
+	DBUG_RETURN(1);				/* purecov: inspected */
+    }
+    DBUG_RETURN(0);
+  }
+  DBUG_RETURN(add_hash_join_cond(join,stat,cond,1));
+}
+
+
 /*****************************************************************************
   Go through all combinations of not marked tables and find the one
   which uses least records
@@ -1836,6 +1960,7 @@ set_position(JOIN *join,uint idx,JOIN_TAB *table,KEYUSE *key)
   join->positions[idx].table= table;
   join->positions[idx].key=key;
   join->positions[idx].records_read=1.0;	/* This is a const table */
+  join->positions[idx].use_hash_join=0;
 
   /* Move the const table as down as possible in best_ref */
   JOIN_TAB **pos=join->best_ref+idx+1;
@@ -1900,6 +2025,7 @@ find_best(JOIN *join,table_map rest_tables,uint idx,double record_count,
       KEYUSE *best_key=0;
       uint best_max_key_part=0;
       my_bool found_constraint= 0;
+      bool use_hash_join= 0;
 
       if (s->keyuse)
       {						/* Use key if possible */
@@ -2159,10 +2285,12 @@ find_best(JOIN *join,table_map rest_tables,uint idx,double record_count,
         }
         else
         {
+          double scan_time= tmp, fills;
+          uint cache_length= cache_record_length(join,idx);
           /* We read the table as many times as join buffer becomes full. */
-          tmp*= (1.0 + floor((double) cache_record_length(join,idx) *
-                             record_count /
-                             (double) thd->variables.join_buff_size));
+          fills= 1.0 + floor((double) cache_length * record_count /
+                             (double) thd->variables.join_buff_size);
+          tmp*= fills;
           /* 
             We don't make full cartesian product between rows in the scanned
             table and existing records because we skip all rows from the
@@ -2171,6 +2299,9 @@ find_best(JOIN *join,table_map rest_tables,uint idx,double record_count,
             take into account cost to read and skip these records.
           */
           tmp+= (s->records - rnd_records)/(double) TIME_FOR_COMPARE;
+          use_hash_join= hash_join_cost(join,s,idx,rest_tables,record_count,
+                                        rnd_records,scan_time,fills,
+                                        cache_length,&tmp);
         }
 
         /*
@@ -2190,10 +2321,13 @@ find_best(JOIN *join,table_map rest_tables,uint idx,double record_count,
 	  records= rows2double(rnd_records);
 	  best_key=0;
 	}
+	else
+	  use_hash_join= 0;
       }
       join->positions[idx].records_read= records;
       join->positions[idx].key=best_key;
       join->positions[idx].table= s;
+      join->positions[idx].use_hash_join= use_hash_join;
       if (!best_key && idx == join->const_tables &&
 	  s->table == join->sort_by_table &&
 	  join->thd->select_limit >= records)
@@ -2287,6 +2421,83 @@ cache_record_length(JOIN *join,uint idx)
 }
 
 
+/*
+  Check if a hash join is cheaper than the join cache for a table
+
+  SYNOPSIS
+    hash_join_cost()
+    join		Join
+    s			Table to read with a full scan
+    idx			Position of s in join
+    rest_tables		Tables not before s in join (including s)
+    record_count	Number of records of the previous tables
+    rnd_records		Rows of s that pass conditions on s only
+    scan_time		Cost of one scan of s
+    fills		How many times the join buffer gets full
+    cache_length	Length of a record in the join buffer
+    read_time		In:  Cost of reading s with the join cache
+			Out: Cost of reading s with a hash join
+
+  NOTES
+    The join cache compares each row of s with every cached record, a
+    hash join only with the records with the same hash. As we don't know
+    how many they are, we assume the equality matches each row of the
+    smaller side once.
+    Without blobs the hash join writes both sides to partition files when
+    the join buffer gets full, so s is read once and everything is
+    written and read back once instead of reading s 'fills' times.
+
+  RETURN
+    0	Use join cache
+    1	Use hash join, read_time is updated
+*/
+
+static bool
+hash_join_cost(JOIN *join,JOIN_TAB *s,uint idx,table_map rest_tables,
+	       double record_count,ha_rows rnd_records,double scan_time,
+	       double fills,uint cache_length,double *read_time)
+{
+  HASH_JOIN_COND *cond,*end;
+  double rows=rows2double(rnd_records),hash_time,hash_compare,matches;
+  bool spill;
+
+  for (cond=s->hash_conds,end=cond+s->hash_cond_count ; cond != end ; cond++)
+  {
+    table_map map=cond->outer->used_tables();
+    if (!(map & rest_tables) && (map & ~join->const_table_map))
+      break;
+  }
+  if (cond == end)
+    return 0;					// No equality with prev tables
+
+  if (!s->used_fieldlength)
+    calc_used_field_length(join->thd,s);
+  spill= fills > 1.0 && !s->used_blobs;
+  for (JOIN_TAB **pos=join->best_ref+join->const_tables,
+	 **end_pos=join->best_ref+idx ;
+       spill && pos != end_pos ;
+       pos++)
+    spill= !(*pos)->used_blobs;
+
+  hash_time= *read_time;
+  if (spill)
+  {
+    hash_time-= scan_time*(fills-1.0);
+    hash_time+= 2.0*((double) cache_length*record_count +
+		     (double) s->used_fieldlength*rows)/(double) IO_SIZE;
+    fills=1.0;
+  }
+  /* Hash all cached records and rows of s, compare with matches */
+  matches= record_count*rows/max(max(record_count,rows),1.0);
+  hash_compare= (record_count+rows*fills+matches)/(double) TIME_FOR_COMPARE;
+  if (hash_time+hash_compare >=
+      *read_time+record_count*rows/(double) TIME_FOR_COMPARE)
+    return 0;
+  *read_time=hash_time;
+  return 1;
+}
+
+
 static double
 prev_record_reads(JOIN *join,table_map found_ref)
 {
@@ -2351,6 +2562,9 @@ get_best_combination(JOIN *join)
     }
     else if (create_ref_for_key(join, j, keyuse, used_tables))
       return TRUE;				// Something went wrong
+    else if (!(join->select_options & SELECT_NO_JOIN_CACHE) &&
+	     test_if_batched_key_access(join, j, tablenr))
+      join->full_join=1;			// Uses the join cache
   }
 
   for (i=0 ; i < table_count ; i++)
@@ -2562,6 +2776,10 @@ make_simple_join(JOIN *join,TABLE *tmp_table)
   join->row_limit=join->thd->select_limit;
 
   join_tab->cache.buff=0;			/* No cacheing */
+  join_tab->cache.hash=0;
+  join_tab->examined_rows=0;
+  join_tab->cache.batched_keys=0;
+  join_tab->batch_rows=0;
   join_tab->table=tmp_table;
   join_tab->select=0;
   join_tab->select_cond=0;
@@ -2750,6 +2968,114 @@ make_join_select(JOIN *join,SQL_SELECT *select,COND *cond)
 }
 
 
+/*
+  Test if a table read by key can use batched key access
+
+  SYNOPSIS
+    test_if_batched_key_access()
+    join		Join
+    tab			Table
+    idx		Position of tab in the join
+
+  NOTES
+    The records of the previous tables are then stored in the join cache
+    of tab and their keys are read from tab in one batch, see
+    flush_batched_keys().  As this changes the order of the found rows
+    it's only done if the user has set batched_key_access.
+*/
+
+static bool
+test_if_batched_key_access(JOIN *join,JOIN_TAB *tab,uint idx)
+{
+  return (join->thd->variables.batched_key_access &&
+	  (tab->type == JT_EQ_REF || tab->type == JT_REF) &&
+	  idx != join->const_tables && !tab->on_expr &&
+	  (tab->table->file->table_flags() & HA_MULTI_RANGE_READ));
+}
+
+
+/*
+  Set up reading a table scan in batches
+
+  SYNOPSIS
+    join_init_read_batch()
+    join		Join
+    tab			Table read with join_init_read_record()
+    options		SELECT_DESCRIBE if we only explain the join
+
+  NOTES
+    Only done for SELECT, as the handler isn't positioned on the returned
+    row, and for tables without blobs, as the blob data of a row is
+    overwritten when the next row is read.
+    The comparisons of a column of the table with a constant in the top
+    AND level of select_cond are evaluated on the whole batch, see
+    init_read_record_batch(). This is not done for the inner table of an
+    outer join, as there a row that fails select_cond still matches.
+*/
+
+static void
+join_init_read_batch(JOIN *join,JOIN_TAB *tab,uint options)
+{
+  THD *thd=join->thd;
+  TABLE *table=tab->table;
+  uint rows=(uint) thd->variables.read_batch_rows;
+  DBUG_ENTER("join_init_read_batch");
+
+  tab->batch_rows=0;
+  if (rows <= 1 || (options & SELECT_DESCRIBE) ||
+      thd->lex.sql_command != SQLCOM_SELECT ||
+      !(table->file->table_flags() & HA_READ_BATCH) || table->blob_fields)
+    DBUG_VOID_RETURN;
+
+  if (!(tab->batch_buff=(byte*) thd->alloc(rows*table->reclength)) ||
+      !(tab->batch_match=(bool*) thd->alloc(rows*sizeof(bool))))
+    DBUG_VOID_RETURN;				/* purecov: inspected */
+  tab->batch_cond_count=0;
+  tab->batch_conds=0;
+
+  COND *cond=tab->select_cond;
+  if (cond && !tab->on_expr)
+  {
+    Item *item;
+    List<Item> single;
+    List<Item> *list=&single;
+    if (cond->type() == Item::COND_ITEM &&
+	((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+      list=((Item_cond*) cond)->argument_list();
+    else
+      single.push_back(cond);
+    if (!(tab->batch_conds=(Item**) thd->alloc(list->elements*
+					       sizeof(Item*))))
+      DBUG_VOID_RETURN;				/* purecov: inspected */
+    List_iterator_fast<Item> li(*list);
+    while ((item=li++))
+    {
+      if (item->type() == Item::FUNC_ITEM &&
+	  ((Item_func*) item)->select_optimize() == Item_func::OPTIMIZE_OP &&
+	  ((Item_bool_func2*) item)->can_eval_batch(table))
+	tab->batch_conds[tab->batch_cond_count++]=item;
+    }
+  }
+  DBUG_PRINT("info",("table: %s  rows: %u  conds: %u",
+		     table->table_name, rows, tab->batch_cond_count));
+  tab->batch_rows=rows;
+  DBUG_VOID_RETURN;
+}
+
+
+static void
+join_init_batched_keys(JOIN *join,JOIN_TAB *tab,uint options)
+{
+  if ((options & SELECT_DESCRIBE) ||
+      !join_init_cache(join->thd,join->join_tab+join->const_tables,
+		       (uint) (tab-join->join_tab)-join->const_tables))
+  {
+    tab[-1].next_select=sub_select_cache;	/* Patch previous */
+    tab->cache.batched_keys=1;
+  }
+}
+
+
 static void
 make_join_readinfo(JOIN *join,uint options)
 {
@@ -2793,6 +3119,9 @@ make_join_readinfo(JOIN *join,uint options)
 	table->key_read=1;
 	table->file->extra(HA_EXTRA_KEYREAD);
       }
+      if (!(options & SELECT_NO_JOIN_CACHE) &&
+	  test_if_batched_key_access(join,tab,i))
+	join_init_batched_keys(join,tab,options);
       break;
     case JT_REF:
       table->status=STATUS_NO_RECORD;
@@ -2812,6 +3141,9 @@ make_join_readinfo(JOIN *join,uint options)
 	table->key_read=1;
 	table->file->extra(HA_EXTRA_KEYREAD);
       }
+      if (!(options & SELECT_NO_JOIN_CACHE) &&
+	  test_if_batched_key_access(join,tab,i))
+	join_init_batched_keys(join,tab,options);
       break;
     case JT_FT:
       table->status=STATUS_NO_RECORD;
@@ -2832,6 +3164,8 @@ make_join_readinfo(JOIN *join,uint options)
 			     i-join->const_tables))
 	{
 	  tab[-1].next_select=sub_select_cache; /* Patch previous */
+	  if (join->best_positions[i].use_hash_join)
+	    (void) join_init_hash(join,tab,options);
 	}
       }
       /* These init changes read_record */
@@ -2844,6 +3178,7 @@ make_join_readinfo(JOIN *join,uint options)
       else
       {
 	tab->read_first_record= join_init_read_record;
+	join_init_read_batch(join,tab,options);
 	if (i == join->const_tables)
 	{
 	  if (tab->select && tab->select->quick)
@@ -2950,6 +3285,8 @@ join_free(JOIN *join)
       delete tab->select;
       delete tab->quick;
       x_free(tab->cache.buff);
+      if (tab->cache.hash)
+	join_end_hash(tab->cache.hash);
       if (tab->table)
       {
 	if (tab->table->key_read)
@@ -4513,8 +4850,16 @@ do_select(JOIN *join,List<Item> *fields,TABLE *table,Procedure *procedure)
     {
       if (table->keys)
       {
-	DBUG_PRINT("info",("Using end_update"));
-	end_select=end_update;
+	if (setup_group_hash(join,table))
+	{
+	  DBUG_PRINT("info",("Using end_update_hash"));
+	  end_select=end_update_hash;
+	}
+	else
+	{
+	  DBUG_PRINT("info",("Using end_update"));
+	  end_select=end_update;
+	}
 	table->file->index_init(0);
       }
       else
@@ -4559,6 +4904,19 @@ do_select(JOIN *join,List<Item> *fields,TABLE *table,Procedure *procedure)
     if (error == -3)
       error=0;					/* select_limit used */
   }
+  delete join->group_hash;
+  join->group_hash=0;
+  if (join->thd->profiling.enabled())
+  {
+    for (uint i=join->const_tables ; i < join->tables ; i++)
+    {
+      const char *name=join->join_tab[i].table->table_name;
+      if (!strncmp(name, tmp_file_prefix, tmp_file_prefix_length))
+	name="temporary table";			// Made by create_tmp_table()
+      join->thd->profiling.add_rows("examining", name,
+				    join->join_tab[i].examined_rows);
+    }
+  }
 
   /* Return 1 if error is sent;  -1 if error should be sent */
   if (error < 0)
@@ -4606,6 +4964,8 @@ sub_select_cache(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
 {
   int error;
 
+  if (join_tab->cache.hash)
+    return sub_select_hash(join,join_tab,end_of_records);
   if (end_of_records)
   {
     if ((error=flush_cached_records(join,join_tab,FALSE)) < 0)
@@ -4657,6 +5017,7 @@ sub_select(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
 	return -2;				/* purecov: inspected */
       }
       join->examined_rows++;
+      join_tab->examined_rows++;
       if (!on_expr || on_expr->val_int())
       {
 	found=1;
@@ -4702,6 +5063,8 @@ flush_cached_records(JOIN *join,JOIN_TAB *join_tab,bool skipp_last)
   int error;
   READ_RECORD *info;
 
+  if (join_tab->cache.batched_keys)
+    return flush_batched_keys(join,join_tab);
   if (!join_tab->cache.records)
     return 0;				/* Nothing to do */
   if (skipp_last)
@@ -4744,7 +5107,7 @@ flush_cached_records(JOIN *join,JOIN_TAB *join_tab,bool skipp_last)
       reset_cache(&join_tab->cache);
       for (i=(join_tab->cache.records- (skipp_last ? 1 : 0)) ; i-- > 0 ;)
       {
-	read_cached_record(join_tab);
+	read_cached_record(&join_tab->cache);
 	if (!select || !select->skipp_record())
 	  if ((error=(join_tab->next_select)(join,join_tab+1,0)) < 0)
 	    return error; /* purecov: inspected */
@@ -4753,7 +5116,7 @@ flush_cached_records(JOIN *join,JOIN_TAB *join_tab,bool skipp_last)
   } while (!(error=info->read_record(info)));
 
   if (skipp_last)
-    read_cached_record(join_tab);		// Restore current record
+    read_cached_record(&join_tab->cache);	// Restore current record
   reset_cache(&join_tab->cache);
   join_tab->cache.records=0; join_tab->cache.ptr_record= (uint) ~0;
   if (error > 0)				// Fatal error
@@ -4764,126 +5127,662 @@ flush_cached_records(JOIN *join,JOIN_TAB *join_tab,bool skipp_last)
 }
 
 
-/*****************************************************************************
-  The different ways to read a record
-  Returns -1 if row was not found, 0 if row was found and 1 on errors
-*****************************************************************************/
 static int
-join_read_const_table(JOIN_TAB *tab, POSITION *pos)
+join_batch_key_cmp(uint *key_length,JOIN_BATCH_KEY *a,JOIN_BATCH_KEY *b)
+{
+  int cmp;
+  if ((cmp=memcmp(a->key,b->key,*key_length)))
+    return cmp;
+  return (a->record_nr < b->record_nr ? -1 :
+	  a->record_nr > b->record_nr ? 1 : 0);
+}
+
+
+/*
+  Join the records in the join cache with a table read by key
+
+  SYNOPSIS
+    flush_batched_keys()
+    join		Join
+    join_tab		Table read with JT_REF or JT_EQ_REF
+
+  NOTES
+    The ref keys of all cached records are calculated and sorted, and
+    records with the same key are chained to one range.  The handler
+    returns the rows of all ranges with multi_range_read_next(), in data
+    file order if it supports HA_MULTI_RANGE_READ, and each row is joined
+    with the cached records of its range.
+
+  RETURN
+    0	ok
+    < 0	Error or abort (as from next_select)
+*/
+
+static int
+flush_batched_keys(JOIN *join,JOIN_TAB *join_tab)
 {
+  JOIN_CACHE *cache= &join_tab->cache;
+  TABLE *table=join_tab->table;
+  TABLE_REF *ref= &join_tab->ref;
+  COND *select_cond=join_tab->select_cond;
+  JOIN_BATCH_KEY *keys,*key,*end,*last;
+  KEY_MULTI_RANGE *ranges,*range;
+  JOIN_TAB *tmp;
+  uchar *key_buff;
+  char *range_ptr;
+  uint i,key_length=ref->key_length;
   int error;
-  DBUG_ENTER("join_read_const_table");
-  TABLE *table=tab->table;
-  table->const_table=1;
-  table->null_row=0;
-  table->status=STATUS_NO_RECORD;
-  
-  if (tab->type == JT_SYSTEM)
+  DBUG_ENTER("flush_batched_keys");
+
+  if (!cache->records)
+    DBUG_RETURN(0);				/* Nothing to do */
+  if (!(keys=(JOIN_BATCH_KEY*)
+	my_malloc(cache->records*(sizeof(JOIN_BATCH_KEY)+
+				  sizeof(KEY_MULTI_RANGE)+key_length),
+		  MYF(MY_WME))))
   {
-    if ((error=join_read_system(tab)))
-    {						// Info for DESCRIBE
-      tab->info="const row not found";
-      /* Mark for EXPLAIN that the row was not found */
-      pos->records_read=0.0;
-      if (!table->outer_join || error > 0)
-	DBUG_RETURN(error);
-    }
+    error= -1;
+    goto end;
   }
-  else
-  {
-    if ((error=join_read_const(tab)))
+  ranges=(KEY_MULTI_RANGE*) (keys+cache->records);
+  key_buff=(uchar*) (ranges+cache->records);
+
+  /* Calculate the keys of the cached records */
+  reset_cache(cache);
+  for (i=cache->records, end=keys ; i-- > 0 ; )
+  {
+    end->pos=cache->pos;
+    end->record_nr=cache->record_nr;
+    read_cached_record(cache);
+    if (cp_buffer_from_ref(ref))
+      continue;					// Can't match any row
+    end->key=key_buff;
+    memcpy(key_buff,ref->key_buff,key_length);
+    key_buff+=key_length;
+    end++;
+  }
+  qsort2((void*) keys,(uint) (end-keys),sizeof(JOIN_BATCH_KEY),
+	 (qsort2_cmp) join_batch_key_cmp,(void*) &key_length);
+
+  /* Make one range of each distinct key */
+  for (key=keys, range=ranges, last=0 ; key != end ; key++)
+  {
+    key->next=0;
+    if (last && !memcmp(last->key,key->key,key_length))
+      last->next=key;
+    else
     {
-      tab->info="unique row not found";
-      /* Mark for EXPLAIN that the row was not found */
-      pos->records_read=0.0;
-      if (!table->outer_join || error > 0)
-	DBUG_RETURN(error);
+      range->key=(byte*) key->key;
+      range->length=key_length;
+      range->ptr=(char*) key;
+      range++;
     }
+    last=key;
   }
-  if (tab->on_expr && !table->null_row)
-  {
-    if ((table->null_row= test(tab->on_expr->val_int() == 0)))
-      empty_record(table);
-    }
-  if (!table->null_row)
-    table->maybe_null=0;
-  DBUG_RETURN(0);
-}
-
+  DBUG_PRINT("info",("records: %u  ranges: %u",cache->records,
+		     (uint) (range-ranges)));
 
-static int
-join_read_system(JOIN_TAB *tab)
-{
-  TABLE *table= tab->table;
-  int error;
-  if (table->status & STATUS_GARBAGE)		// If first read
+  for (tmp=join->join_tab; tmp != join_tab ; tmp++)
   {
-    if ((error=table->file->read_first_row(table->record[0],
-					   table->primary_key)))
+    tmp->status=tmp->table->status;
+    tmp->table->status=0;
+  }
+  if ((error=table->file->multi_range_read_init(ranges,
+						(uint) (range-ranges))))
+    goto err;
+  while (!(error=table->file->multi_range_read_next(table->record[0],
+						     &range_ptr)))
+  {
+    if (join->thd->killed)
     {
-      if (error != HA_ERR_END_OF_FILE)
-      {
-	table->file->print_error(error,MYF(0));
-	return 1;
-      }
-      table->null_row=1;			// This is ok.
-      empty_record(table);			// Make empty record
-      return -1;
+      my_error(ER_SERVER_SHUTDOWN,MYF(0)); /* purecov: inspected */
+      error= -2;				// Aborted by user
+      goto end;
+    }
+    table->null_row=0;
+    for (key=(JOIN_BATCH_KEY*) range_ptr ; key ; key=key->next)
+    {
+      join->examined_rows++;
+      join_tab->examined_rows++;
+      cache->pos=key->pos;
+      cache->record_nr=key->record_nr;
+      read_cached_record(cache);
+      if (!select_cond || select_cond->val_int())
+	if ((error=(*join_tab->next_select)(join,join_tab+1,0)) < 0)
+	  goto end;
     }
-    store_record(table,1);
   }
-  else if (!table->status)			// Only happens with left join
-    restore_record(table,1);			// restore old record
-  table->null_row=0;
-  return table->status ? -1 : 0;
+  if (error == HA_ERR_END_OF_FILE)
+  {
+    error=0;
+    for (tmp=join->join_tab; tmp != join_tab ; tmp++)
+      tmp->table->status=tmp->status;
+    goto end;
+  }
+err:
+  table->file->print_error(error,MYF(0));
+  error= -1;
+end:
+  table->file->multi_range_read_end();
+  my_free((gptr) keys,MYF(MY_ALLOW_ZERO_PTR));
+  reset_cache(cache);
+  cache->records=0; cache->ptr_record= (uint) ~0;
+  DBUG_RETURN(error);
 }
 
 
+/*
+  Like sub_select_cache() for a hash join
+
+  NOTES
+    When the join buffer is full the cached records are written to the
+    partition files if we can use them (see spill_hashed_records()) and
+    the rows of the table are joined with them at end of records.
+    Else the table is scanned once for each full join buffer like with
+    the join cache.
+*/
+
 static int
-join_read_const(JOIN_TAB *tab)
+sub_select_hash(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
 {
   int error;
-  TABLE *table= tab->table;
-  if (table->status & STATUS_GARBAGE)		// If first read
+  JOIN_HASH *hash=join_tab->cache.hash;
+
+  if (end_of_records)
   {
-    if (cp_buffer_from_ref(&tab->ref))
-      error=HA_ERR_KEY_NOT_FOUND;
+    if (hash->outer_files)
+      error= spill_hashed_records(join_tab) ? -1 :
+	join_hash_partitions(join,join_tab);
     else
-    {
-      error=table->file->index_read_idx(table->record[0],tab->ref.key,
-					(byte*) tab->ref.key_buff,
-					tab->ref.key_length,HA_READ_KEY_EXACT);
-    }
-    if (error)
-    {
-      table->null_row=1;
-      empty_record(table);
-      if (error != HA_ERR_KEY_NOT_FOUND)
-      {
-	/* Locking reads can legally return also these errors, do not
-	   print them to the .err log */
-	if (error != HA_ERR_LOCK_DEADLOCK && error != HA_ERR_LOCK_WAIT_TIMEOUT)
-	  sql_print_error("read_const: Got error %d when reading table %s",
-			error, table->path);
-	table->file->print_error(error,MYF(0));
-	return 1;
-      }
-      return -1;
-    }
-    store_record(table,1);
+      error=flush_hashed_records(join,join_tab);
+    if (error < 0)
+      return error;
+    return sub_select(join,join_tab,end_of_records);
   }
-  else if (!(table->status & ~STATUS_NULL_ROW))	// Only happens with left join
+  if (join->thd->killed)		// If aborted by user
   {
-    table->status=0;
-    restore_record(table,1);			// restore old record
+    my_error(ER_SERVER_SHUTDOWN,MYF(0)); /* purecov: inspected */
+    return -2;				 /* purecov: inspected */
   }
-  table->null_row=0;
-  return table->status ? -1 : 0;
+  if (!store_record_in_cache(&join_tab->cache))
+    return 0;					// There is more room in cache
+  if (hash->partitions)
+    return spill_hashed_records(join_tab) ? -1 : 0;
+  return flush_hashed_records(join,join_tab);
 }
 
 
+/*
+  Join the rows of the table with the hashed records in the join buffer
+
+  NOTES
+    Like flush_cached_records(), but each row is only joined with the
+    records that have the same hash. The rows are compared with the
+    records in the order the records were cached, so the rows are
+    returned in the same order as with the join cache.
+*/
+
 static int
-join_read_key(JOIN_TAB *tab)
+flush_hashed_records(JOIN *join,JOIN_TAB *join_tab)
+{
+  int error;
+  READ_RECORD *info;
+  JOIN_CACHE *cache= &join_tab->cache;
+
+  if (!cache->records)
+    return 0;				/* Nothing to do */
+  if ((error=join_init_read_record(join_tab)))
+  {
+    join_hash_reset(cache);
+    return -error;			/* No records or error */
+  }
+
+  for (JOIN_TAB *tmp=join->join_tab; tmp != join_tab ; tmp++)
+  {
+    tmp->status=tmp->table->status;
+    tmp->table->status=0;
+  }
+
+  info= &join_tab->read_record;
+  do
+  {
+    uint32 hashnr;
+    if (join->thd->killed)
+    {
+      my_error(ER_SERVER_SHUTDOWN,MYF(0)); /* purecov: inspected */
+      return -2;				// Aborted by user /* purecov: inspected */
+    }
+    if (!error && (!cache->select || !cache->select->skipp_record()) &&
+	!join_hash_key(cache->hash,1,&hashnr))
+    {
+      if ((error=join_hash_probe(join,join_tab,hashnr)) < 0)
+	return error; /* purecov: inspected */
+    }
+  } while (!(error=info->read_record(info)));
+
+  join_hash_reset(cache);
+  if (error > 0)				// Fatal error
+    return -1;					/* purecov: inspected */
+  for (JOIN_TAB *tmp2=join->join_tab; tmp2 != join_tab ; tmp2++)
+    tmp2->table->status=tmp2->status;
+  return 0;
+}
+
+
+/* Join the current row of the table with the records with the same hash */
+
+static int
+join_hash_probe(JOIN *join,JOIN_TAB *join_tab,uint32 hashnr)
+{
+  int error;
+  JOIN_CACHE *cache= &join_tab->cache;
+  JOIN_HASH *hash=cache->hash;
+  SQL_SELECT *select=join_tab->select;
+  JOIN_HASH_LINK *link;
+
+  for (link=hash->buckets[((hashnr >> 8) % hash->bucket_count)*2] ;
+       link ;
+       link=link->next)
+  {
+    if (link->hashnr != hashnr)
+      continue;
+    cache->pos=(uchar*) link;
+    cache->record_nr=link->record_nr;
+    read_cached_record(cache);
+    if (!select || !select->skipp_record())
+      if ((error=(join_tab->next_select)(join,join_tab+1,0)) < 0)
+	return error; /* purecov: inspected */
+  }
+  return 0;
+}
+
+
+/*
+  Write a record to a partition file of a hash join
+
+  NOTES
+    The record is stored as length, hash and the record as packed by
+    store_record_in_cache().
+*/
+
+static bool
+write_hashed_record(IO_CACHE *file,uint32 hashnr,uchar *record,uint length)
+{
+  uchar head[8];
+  int4store(head,length);
+  int4store(head+4,hashnr);
+  return (my_b_write(file,(byte*) head,sizeof(head)) ||
+	  my_b_write(file,(byte*) record,length));
+}
+
+
+/*
+  Read a record written by write_hashed_record()
+
+  RETURN
+    0	ok
+    1	End of file
+    -1	Error
+*/
+
+static int
+read_hashed_record(IO_CACHE *file,uint32 *hashnr,uchar *record,uint *length,
+		   uint max_length)
+{
+  uchar head[8];
+  if (my_b_read(file,(byte*) head,sizeof(head)))
+    return file->error ? -1 : 1;
+  *length=uint4korr(head);
+  *hashnr=uint4korr(head+4);
+  if (*length > max_length || my_b_read(file,(byte*) record,*length))
+    return -1;					/* purecov: inspected */
+  return 0;
+}
+
+
+/*
+  Move the records in a full join buffer to the partition files
+
+  SYNOPSIS
+    spill_hashed_records()
+    join_tab		Table that is hash joined with the records
+
+  NOTES
+    The partition of a record is given by its hash. Records with a NULL
+    in the equalities can't match and are not saved.
+    The files are opened at the first call; a partition file only gets
+    created on disk when its buffer is full.
+
+  RETURN
+    0	ok
+    1	Error (error is given)
+*/
+
+static int
+spill_hashed_records(JOIN_TAB *join_tab)
+{
+  JOIN_CACHE *cache= &join_tab->cache;
+  JOIN_HASH *hash=cache->hash;
+  uchar *pos;
+  uint i;
+  DBUG_ENTER("spill_hashed_records");
+
+  if (!hash->outer_files)
+  {
+    if (!(hash->outer_files=(IO_CACHE*)
+	  sql_calloc(sizeof(IO_CACHE)*hash->partitions*2)))
+      DBUG_RETURN(1);				/* purecov: inspected */
+    hash->inner_files=hash->outer_files+hash->partitions;
+    for (i=0 ; i < hash->partitions*2 ; i++)
+    {
+      if (open_cached_file(hash->outer_files+i,mysql_tmpdir,TEMP_PREFIX,
+			   JOIN_HASH_BUFFER_SIZE,MYF(MY_WME)))
+	DBUG_RETURN(1);
+    }
+  }
+  for (pos=cache->buff,i=cache->records ; i-- > 0 ;)
+  {
+    JOIN_HASH_LINK *link=(JOIN_HASH_LINK*)
+      (cache->buff+ALIGN_SIZE((uint) (pos-cache->buff)));
+    if (!link->null_key &&
+	write_hashed_record(hash->outer_files+link->hashnr % hash->partitions,
+			    link->hashnr,(uchar*) (link+1),link->length))
+      DBUG_RETURN(1);
+    pos=(uchar*) (link+1)+link->length;
+  }
+  join_hash_reset(cache);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Read records of a partition file to the join buffer
+
+  RETURN
+    0	Join buffer is full
+    1	End of file
+    -1	Error
+*/
+
+static int
+load_hashed_records(JOIN_CACHE *cache,IO_CACHE *file)
+{
+  uchar *pos=cache->buff;
+  int error;
+
+  /* cache->length is the max space of a record with its link */
+  while ((uint) (cache->end-pos) >= cache->length)
+  {
+    JOIN_HASH_LINK *link=(JOIN_HASH_LINK*)
+      (cache->buff+ALIGN_SIZE((uint) (pos-cache->buff)));
+    if ((error=read_hashed_record(file,&link->hashnr,(uchar*) (link+1),
+				  &link->length,cache->length)))
+      return error;
+    link->record_nr=cache->records++;
+    link->null_key=0;
+    join_hash_insert(cache->hash,link,0);
+    pos=(uchar*) (link+1)+link->length;
+  }
+  return 0;
+}
+
+
+/*
+  Join the partition files of a hash join
+
+  SYNOPSIS
+    join_hash_partitions()
+    join		Join
+    join_tab		Table that is hash joined with the records
+
+  NOTES
+    Reads the table once and writes the rows that may match a record to
+    the partition file of their hash. Then each partition of records is
+    read to the join buffer and joined with the rows of the partition.
+    If the records of a partition don't fit in the join buffer, the rows
+    of the partition are read once for each full join buffer.
+    The partition files are closed when we are done.
+
+  RETURN
+    0	ok
+    1	The table is empty
+    <0	Error
+*/
+
+static int
+join_hash_partitions(JOIN *join,JOIN_TAB *join_tab)
+{
+  int error;
+  uint i,length;
+  uint32 hashnr;
+  READ_RECORD *info;
+  JOIN_CACHE *cache= &join_tab->cache;
+  JOIN_HASH *hash=cache->hash;
+  JOIN_CACHE *inner= &hash->inner;
+  DBUG_ENTER("join_hash_partitions");
+
+  if ((error=join_init_read_record(join_tab)))
+  {
+    error= -error;				/* No records or error */
+    goto end;
+  }
+  info= &join_tab->read_record;
+  do
+  {
+    if (join->thd->killed)
+    {
+      my_error(ER_SERVER_SHUTDOWN,MYF(0)); /* purecov: inspected */
+      error= -2;				/* purecov: inspected */
+      goto end;					/* purecov: inspected */
+    }
+    if (!error && (!cache->select || !cache->select->skipp_record()) &&
+	!join_hash_key(hash,1,&hashnr) &&
+	my_b_tell(hash->outer_files+hashnr % hash->partitions))
+    {
+      reset_cache(inner);
+      inner->records=0;
+      (void) store_record_in_cache(inner);
+      if (write_hashed_record(hash->inner_files+hashnr % hash->partitions,
+			      hashnr,inner->buff,
+			      (uint) (inner->pos-inner->buff)))
+      {
+	error= -1;
+	goto end;
+      }
+    }
+  } while (!(error=info->read_record(info)));
+  if (error > 0)				// Fatal error
+  {
+    error= -1;					/* purecov: inspected */
+    goto end;					/* purecov: inspected */
+  }
+
+  for (JOIN_TAB *tmp=join->join_tab; tmp != join_tab ; tmp++)
+  {
+    tmp->status=tmp->table->status;
+    tmp->table->status=0;
+  }
+  join_tab->table->status=0;
+  join_tab->table->null_row=0;
+
+  error=0;
+  for (i=0 ; i < hash->partitions && !error ; i++)
+  {
+    IO_CACHE *outer_file=hash->outer_files+i, *inner_file=hash->inner_files+i;
+    if (!my_b_tell(outer_file) || !my_b_tell(inner_file))
+      continue;					// Nothing can match
+    if (reinit_io_cache(outer_file,READ_CACHE,0L,0,0))
+    {
+      error= -1;				/* purecov: inspected */
+      break;					/* purecov: inspected */
+    }
+    for (;;)
+    {
+      int load_error=load_hashed_records(cache,outer_file);
+      if (load_error < 0 || reinit_io_cache(inner_file,READ_CACHE,0L,0,0))
+      {
+	error= -1;				/* purecov: inspected */
+	break;					/* purecov: inspected */
+      }
+      if (!cache->records)
+	break;
+      while (!(error=read_hashed_record(inner_file,&hashnr,inner->buff,
+					&length,inner->length)))
+      {
+	if (join->thd->killed)
+	{
+	  my_error(ER_SERVER_SHUTDOWN,MYF(0)); /* purecov: inspected */
+	  error= -2;				/* purecov: inspected */
+	  break;				/* purecov: inspected */
+	}
+	reset_cache(inner);
+	read_cached_record(inner);		// Restore row of table
+	if ((error=join_hash_probe(join,join_tab,hashnr)) < 0)
+	  break;				/* purecov: inspected */
+      }
+      join_hash_reset(cache);
+      if (error < 0)
+	break;
+      error=0;
+      if (load_error)
+	break;					// Whole partition is done
+    }
+  }
+  if (!error)
+  {
+    for (JOIN_TAB *tmp2=join->join_tab; tmp2 != join_tab ; tmp2++)
+      tmp2->table->status=tmp2->status;
+  }
+
+end:
+  join_hash_reset(cache);
+  for (i=0 ; i < hash->partitions*2 ; i++)
+    close_cached_file(hash->outer_files+i);
+  hash->outer_files=hash->inner_files=0;
+  DBUG_RETURN(error);
+}
+
+
+/*****************************************************************************
+  The different ways to read a record
+  Returns -1 if row was not found, 0 if row was found and 1 on errors
+*****************************************************************************/
+static int
+join_read_const_table(JOIN_TAB *tab, POSITION *pos)
+{
+  int error;
+  DBUG_ENTER("join_read_const_table");
+  TABLE *table=tab->table;
+  table->const_table=1;
+  table->null_row=0;
+  table->status=STATUS_NO_RECORD;
+  
+  if (tab->type == JT_SYSTEM)
+  {
+    if ((error=join_read_system(tab)))
+    {						// Info for DESCRIBE
+      tab->info="const row not found";
+      /* Mark for EXPLAIN that the row was not found */
+      pos->records_read=0.0;
+      if (!table->outer_join || error > 0)
+	DBUG_RETURN(error);
+    }
+  }
+  else
+  {
+    if ((error=join_read_const(tab)))
+    {
+      tab->info="unique row not found";
+      /* Mark for EXPLAIN that the row was not found */
+      pos->records_read=0.0;
+      if (!table->outer_join || error > 0)
+	DBUG_RETURN(error);
+    }
+  }
+  if (tab->on_expr && !table->null_row)
+  {
+    if ((table->null_row= test(tab->on_expr->val_int() == 0)))
+      empty_record(table);
+    }
+  if (!table->null_row)
+    table->maybe_null=0;
+  DBUG_RETURN(0);
+}
+
+
+static int
+join_read_system(JOIN_TAB *tab)
+{
+  TABLE *table= tab->table;
+  int error;
+  if (table->status & STATUS_GARBAGE)		// If first read
+  {
+    if ((error=table->file->read_first_row(table->record[0],
+					   table->primary_key)))
+    {
+      if (error != HA_ERR_END_OF_FILE)
+      {
+	table->file->print_error(error,MYF(0));
+	return 1;
+      }
+      table->null_row=1;			// This is ok.
+      empty_record(table);			// Make empty record
+      return -1;
+    }
+    store_record(table,1);
+  }
+  else if (!table->status)			// Only happens with left join
+    restore_record(table,1);			// restore old record
+  table->null_row=0;
+  return table->status ? -1 : 0;
+}
+
+
+static int
+join_read_const(JOIN_TAB *tab)
+{
+  int error;
+  TABLE *table= tab->table;
+  if (table->status & STATUS_GARBAGE)		// If first read
+  {
+    if (cp_buffer_from_ref(&tab->ref))
+      error=HA_ERR_KEY_NOT_FOUND;
+    else
+    {
+      error=table->file->index_read_idx(table->record[0],tab->ref.key,
+					(byte*) tab->ref.key_buff,
+					tab->ref.key_length,HA_READ_KEY_EXACT);
+    }
+    if (error)
+    {
+      table->null_row=1;
+      empty_record(table);
+      if (error != HA_ERR_KEY_NOT_FOUND)
+      {
+	/* Locking reads can legally return also these errors, do not
+	   print them to the .err log */
+	if (error != HA_ERR_LOCK_DEADLOCK && error != HA_ERR_LOCK_WAIT_TIMEOUT)
+	  sql_print_error("read_const: Got error %d when reading table %s",
+			error, table->path);
+	table->file->print_error(error,MYF(0));
+	return 1;
+      }
+      return -1;
+    }
+    store_record(table,1);
+  }
+  else if (!(table->status & ~STATUS_NULL_ROW))	// Only happens with left join
+  {
+    table->status=0;
+    restore_record(table,1);			// restore old record
+  }
+  table->null_row=0;
+  return table->status ? -1 : 0;
+}
+
+
+static int
+join_read_key(JOIN_TAB *tab)
 {
   int error;
   TABLE *table= tab->table;
@@ -5060,6 +5959,10 @@ join_init_read_record(JOIN_TAB *tab)
     tab->select->quick->reset();
   init_read_record(&tab->read_record, tab->join->thd, tab->table,
 		   tab->select,1,1);
+  if (tab->batch_rows)
+    init_read_record_batch(&tab->read_record, tab->batch_buff,
+			   tab->batch_match, tab->batch_rows,
+			   tab->batch_conds, tab->batch_cond_count);
   return (*tab->read_record.read_record)(&tab->read_record);
 }
 
@@ -5504,6 +6407,145 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
   DBUG_RETURN(0);
 }
 
+/*
+  Group by in a hash table before the temporary table
+
+  The groups of a HEAP table are collected in join->group_hash, keyed on
+  Field::sort_string() of the group fields, and written to the table at
+  end of records. If the hash table gets full, the groups in it are
+  written to the table and end_update() continues with the table, which
+  may then be converted to MyISAM as before.
+*/
+
+static bool setup_group_hash(JOIN *join,TABLE *table)
+{
+  ORDER *group;
+  uint key_length=0;
+  DBUG_ENTER("setup_group_hash");
+
+  if (table->db_type != DB_TYPE_HEAP)
+    DBUG_RETURN(0);
+  for (group=table->group ; group ; group=group->next)
+  {
+#ifdef USE_STRCOLL
+    if (use_strcoll(default_charset_info) && !group->field->binary())
+      DBUG_RETURN(0);				// Not equal as bytes
+#endif
+    key_length+= group->field->pack_length() +
+      ((*group->item)->maybe_null ? 1 : 0);
+  }
+  if (!(join->group_hash_key= (byte*) join->thd->alloc(key_length+1)) ||
+      !(join->group_hash= new Aggr_hash(key_length, table->reclength,
+					join->thd->variables.
+					tmp_table_size)))
+    DBUG_RETURN(0);				// Use end_update()
+  DBUG_RETURN(1);
+}
+
+
+/* Write the groups in the hash table to the temporary table */
+
+static int flush_group_hash(JOIN *join)
+{
+  TABLE *table=join->tmp_table;
+  Aggr_hash *hash=join->group_hash;
+  int error;
+  DBUG_ENTER("flush_group_hash");
+
+  for (byte *key=hash->first() ; key ; key=hash->next(key))
+  {
+    memcpy(table->record[0], hash->data(key), table->reclength);
+    if ((error=table->file->write_row(table->record[0])))
+    {
+      if (create_myisam_from_heap(join->thd, table, &join->tmp_table_param,
+				  error, 0))
+	DBUG_RETURN(-1);			// Not a table_is_full error
+      /* Change method to update rows */
+      table->file->index_init(0);
+      join->join_tab[join->tables-1].next_select=end_unique_update;
+    }
+  }
+  hash->reset();
+  DBUG_RETURN(0);
+}
+
+
+static int
+end_update_hash(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
+		bool end_of_records)
+{
+  TABLE *table=join->tmp_table;
+  ORDER   *group;
+  byte	  *key,*data;
+  bool	  inserted;
+  DBUG_ENTER("end_update_hash");
+
+  if (end_of_records)
+    DBUG_RETURN(flush_group_hash(join));
+  if (join->thd->killed)			// Aborted by user
+  {
+    my_error(ER_SERVER_SHUTDOWN,MYF(0));	/* purecov: inspected */
+    DBUG_RETURN(-2);				/* purecov: inspected */
+  }
+
+  join->found_records++;
+  copy_fields(&join->tmp_table_param);		// Groups are copied twice.
+  /* Make a key of the group fields that compares with memcmp() */
+  for (group=table->group, key=join->group_hash_key ; group ;
+       group=group->next)
+  {
+    Item *item= *group->item;
+    uint length=group->field->pack_length();
+    item->save_org_in_field(group->field);
+    if (item->maybe_null)
+    {
+      group->buff[-1]= *key++= item->null_value ? 1 : 0;
+      if (item->null_value)
+      {
+	bzero(key, length);
+	key+= length;
+	continue;
+      }
+    }
+    group->field->sort_string((char*) key, length);
+    key+= length;
+  }
+
+  if (!(data=join->group_hash->find_or_insert(join->group_hash_key,
+					      &inserted)))
+  {
+    if (!join->group_hash->is_full())
+      DBUG_RETURN(-1);				// Out of memory
+    /* Move the groups to the table and continue there */
+    join->join_tab[join->tables-1].next_select=end_update;
+    if (flush_group_hash(join))
+      DBUG_RETURN(-1);
+    join->found_records--;
+    DBUG_RETURN((*join->join_tab[join->tables-1].next_select)(join,join_tab,
+							      0));
+  }
+  if (!inserted)
+  {						/* Update old group */
+    memcpy(table->record[0], data, table->reclength);
+    update_tmptable_sum_func(join->sum_funcs,table);
+    memcpy(data, table->record[0], table->reclength);
+    DBUG_RETURN(0);
+  }
+
+  /* The null bits are already set */
+  KEY_PART_INFO *key_part;
+  for (group=table->group,key_part=table->key_info[0].key_part;
+       group ;
+       group=group->next,key_part++)
+    memcpy(table->record[0]+key_part->offset, group->buff, key_part->length);
+
+  init_tmptable_sum_functions(join->sum_funcs);
+  copy_funcs(join->tmp_table_param.items_to_copy);
+  memcpy(data, table->record[0], table->reclength);
+  join->send_records++;
+  DBUG_RETURN(0);
+}
+
 /* Like end_update, but this is done with unique constraints instead of keys */
 
 static int
@@ -6032,6 +7074,7 @@ create_sort_index(JOIN_TAB *tab, ORDER *order, ha_rows filesort_limit,
   tab->type=JT_ALL;				// Read with normal read_record
   tab->read_first_record= join_init_read_record;
   tab->join->examined_rows+=examined_rows;
+  tab->examined_rows+=examined_rows;
   if (table->key_read)				// Restore if we used indexes
   {
     table->key_read=0;
@@ -6393,14 +7436,50 @@ SORT_FIELD *make_unireg_sortorder(ORDER *order, uint *length)
 static int
 join_init_cache(THD *thd,JOIN_TAB *tables,uint table_count)
 {
-  reg1 uint i;
-  uint length,blobs,size;
-  CACHE_FIELD *copy,**blob_ptr;
+  uint size;
   JOIN_CACHE  *cache;
-  JOIN_TAB *join_tab;
   DBUG_ENTER("join_init_cache");
 
   cache= &tables[table_count].cache;
+  if (init_cache_fields(thd,cache,tables,table_count))
+  {
+    cache->buff=0;				/* purecov: inspected */
+    DBUG_RETURN(1);				/* purecov: inspected */
+  }
+  cache->records=0; cache->ptr_record= (uint) ~0;
+  size=max(thd->variables.join_buff_size, cache->length);
+  if (!(cache->buff=(uchar*) my_malloc(size,MYF(0))))
+    DBUG_RETURN(1);				/* Don't use cache */ /* purecov: inspected */
+  cache->end=cache->buff+size;
+  reset_cache(cache);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Set up the fields of tables to copy to a JOIN_CACHE
+
+  SYNOPSIS
+    init_cache_fields()
+    thd			Thread handler
+    cache		Cache to set up
+    tables		First table
+    table_count		Number of tables
+
+  RETURN
+    0	ok
+    1	Out of memory
+*/
+
+static bool
+init_cache_fields(THD *thd,JOIN_CACHE *cache,JOIN_TAB *tables,
+		  uint table_count)
+{
+  reg1 uint i;
+  uint length,blobs;
+  CACHE_FIELD *copy,**blob_ptr;
+  JOIN_TAB *join_tab;
+
   cache->fields=blobs=0;
 
   join_tab=tables;
@@ -6414,11 +7493,7 @@ join_init_cache(THD *thd,JOIN_TAB *tables,uint table_count)
   if (!(cache->field=(CACHE_FIELD*)
 	sql_alloc(sizeof(CACHE_FIELD)*(cache->fields+table_count*2)+(blobs+1)*
 		  sizeof(CACHE_FIELD*))))
-  {
-    my_free((gptr) cache->buff,MYF(0));		/* purecov: inspected */
-    cache->buff=0;				/* purecov: inspected */
-    DBUG_RETURN(1);				/* purecov: inspected */
-  }
+    return 1;					/* purecov: inspected */
   copy=cache->field;
   blob_ptr=cache->blob_ptr=(CACHE_FIELD**)
     (cache->field+cache->fields+table_count*2);
@@ -6469,16 +7544,10 @@ join_init_cache(THD *thd,JOIN_TAB *tables,uint table_count)
     }
   }
 
-  cache->records=0; cache->ptr_record= (uint) ~0;
   cache->length=length+blobs*sizeof(char*);
   cache->blobs=blobs;
   *blob_ptr=0;					/* End sequentel */
-  size=max(thd->variables.join_buff_size, cache->length);
-  if (!(cache->buff=(uchar*) my_malloc(size,MYF(0))))
-    DBUG_RETURN(1);				/* Don't use cache */ /* purecov: inspected */
-  cache->end=cache->buff+size;
-  reset_cache(cache);
-  DBUG_RETURN(0);
+  return 0;
 }
 
 
@@ -6503,9 +7572,17 @@ store_record_in_cache(JOIN_CACHE *cache)
   uchar *pos;
   CACHE_FIELD *copy,*end_field;
   bool last_record;
+  JOIN_HASH_LINK *link=0;
 
   pos=cache->pos;
   end_field=cache->field+cache->fields;
+  if (cache->hash)
+  {
+    /* Hashed records are aligned and start with a JOIN_HASH_LINK */
+    link=(JOIN_HASH_LINK*) (cache->buff+
+			    ALIGN_SIZE((uint) (pos-cache->buff)));
+    pos=(uchar*) (link+1);
+  }
 
   length=cache->length;
   if (cache->blobs)
@@ -6554,6 +7631,12 @@ store_record_in_cache(JOIN_CACHE *cache)
     }
   }
   cache->pos=pos;
+  if (link)
+  {
+    link->record_nr=cache->records-1;
+    link->length=(uint) (pos-(uchar*) (link+1));
+    join_hash_insert(cache->hash,link,1);
+  }
   return last_record || (uint) (cache->end -pos) < cache->length;
 }
 
@@ -6567,17 +7650,19 @@ reset_cache(JOIN_CACHE *cache)
 
 
 static void
-read_cached_record(JOIN_TAB *tab)
+read_cached_record(JOIN_CACHE *cache)
 {
   uchar *pos;
   uint length;
   bool last_record;
   CACHE_FIELD *copy,*end_field;
 
-  last_record=tab->cache.record_nr++ == tab->cache.ptr_record;
-  pos=tab->cache.pos;
+  last_record=cache->record_nr++ == cache->ptr_record;
+  pos=cache->pos;
+  if (cache->hash)
+    pos=(uchar*) (((JOIN_HASH_LINK*) pos)+1);	// Positioned by the hash
 
-  for (copy=tab->cache.field,end_field=copy+tab->cache.fields ;
+  for (copy=cache->field,end_field=copy+cache->fields ;
        copy < end_field;
        copy++)
   {
@@ -6609,11 +7694,240 @@ read_cached_record(JOIN_TAB *tab)
       }
     }
   }
-  tab->cache.pos=pos;
+  cache->pos=pos;
   return;
 }
 
 
+/*
+  Set up a hash join of a table with the records in its join cache
+
+  SYNOPSIS
+    join_init_hash()
+    join		Join
+    tab			Table read with join cache
+    options		SELECT_DESCRIBE if we only explain the join
+
+  NOTES
+    Uses the equalities in tab->hash_conds where the other side only
+    depends on tables before tab.
+    If there are no blobs we can write the records and rows to partition
+    files when the join buffer gets full. We use enough partitions for
+    the estimated records of a partition to fit in half the join buffer.
+
+  RETURN
+    0	ok, tab->cache.hash is set
+    1	Use the join cache
+*/
+
+static bool
+join_init_hash(JOIN *join,JOIN_TAB *tab,uint options)
+{
+  THD *thd=join->thd;
+  JOIN_CACHE *cache= &tab->cache;
+  JOIN_HASH *hash;
+  HASH_JOIN_COND *cond,*end;
+  table_map prev_tables=0;
+  double records=1.0;
+  uint i,buff_length,link_length;
+  bool binary=1;
+  DBUG_ENTER("join_init_hash");
+
+  for (JOIN_TAB *prev=join->join_tab ; prev != tab ; prev++)
+  {
+    prev_tables|= prev->table->map;
+    records*= join->best_positions[prev - join->join_tab].records_read;
+  }
+  if (!(hash=(JOIN_HASH*) thd->calloc(sizeof(JOIN_HASH))) ||
+      !(hash->keys=(HASH_JOIN_COND*)
+	thd->alloc(sizeof(HASH_JOIN_COND)*tab->hash_cond_count)))
+    DBUG_RETURN(1);				/* purecov: inspected */
+  for (cond=tab->hash_conds,end=cond+tab->hash_cond_count ; cond != end ;
+       cond++)
+  {
+    table_map map=cond->outer->used_tables();
+    if (!(map & ~prev_tables) && (map & ~join->const_table_map) &&
+	!(cond->inner->used_tables() & ~tab->table->map))
+    {
+      hash->keys[hash->key_count++]= *cond;
+      if (cond->cmp_type == STRING_RESULT && !cond->binary)
+	binary=0;
+    }
+  }
+  if (!hash->key_count)
+    DBUG_RETURN(1);
+  if (options & SELECT_DESCRIBE)
+  {
+    cache->hash=hash;				// For EXPLAIN
+    DBUG_RETURN(0);
+  }
+
+  buff_length=(uint) (cache->end-cache->buff);
+  link_length=sizeof(JOIN_HASH_LINK)+ALIGN_SIZE(1);
+  if (buff_length < cache->length+link_length)
+    DBUG_RETURN(1);
+  hash->bucket_count=buff_length/(cache->length+link_length)*2+1;
+  if (!(hash->buckets=(JOIN_HASH_LINK**)
+	thd->calloc(sizeof(JOIN_HASH_LINK*)*2*hash->bucket_count)))
+    DBUG_RETURN(1);				/* purecov: inspected */
+  if (!binary)
+  {
+    /* Strings that only differ in end space are equal */
+    if (!(hash->end_space=(uchar*) thd->calloc(256)))
+      DBUG_RETURN(1);				/* purecov: inspected */
+    for (i=0 ; i < 256 ; i++)
+      if (isspace(i))
+	hash->end_space[my_sort_order[i]]=1;
+  }
+
+  if (!tab->used_fieldlength)
+    calc_used_field_length(thd,tab);
+  if (!cache->blobs && !tab->used_blobs &&
+      !init_cache_fields(thd,&hash->inner,tab,1) &&
+      (hash->inner.buff=(uchar*) my_malloc(hash->inner.length,MYF(0))))
+  {
+    double partitions= records*(cache->length+link_length)*2.0/buff_length;
+    hash->inner.end=hash->inner.buff+hash->inner.length;
+    hash->inner.ptr_record= (uint) ~0;
+    hash->partitions= (partitions < JOIN_HASH_MIN_PARTITIONS ?
+		       JOIN_HASH_MIN_PARTITIONS :
+		       partitions > JOIN_HASH_MAX_PARTITIONS ?
+		       JOIN_HASH_MAX_PARTITIONS : (uint) partitions);
+  }
+  cache->length+=link_length;
+  cache->hash=hash;
+  DBUG_RETURN(0);
+}
+
+
+/* Free what join_init_hash() and the hash join allocated */
+
+static void
+join_end_hash(JOIN_HASH *hash)
+{
+  if (hash->outer_files)
+  {
+    for (uint i=0 ; i < hash->partitions*2 ; i++)
+      close_cached_file(hash->outer_files+i);
+    hash->outer_files=hash->inner_files=0;
+  }
+  x_free(hash->inner.buff);
+  hash->inner.buff=0;
+}
+
+
+/*
+  Calculate the hash of one side of the equalities of a hash join
+
+  SYNOPSIS
+    join_hash_key()
+    hash		Hash join
+    inner		1 for the table, 0 for the cached records
+    hashnr		Store hash here
+
+  NOTES
+    The values are hashed the way '=' compares them, so values that are
+    equal get the same hash: strings that are not binary are hashed on
+    my_sort_order without end space.
+
+  RETURN
+    0	ok
+    1	A value is NULL; this can't match anything
+*/
+
+static bool
+join_hash_key(JOIN_HASH *hash,bool inner,uint32 *hashnr)
+{
+  char buff[MAX_FIELD_WIDTH];
+  String tmp(buff,sizeof(buff)),*res;
+  register ulong nr=1,nr2=4;
+  HASH_JOIN_COND *key,*end;
+
+  for (key=hash->keys,end=key+hash->key_count ; key != end ; key++)
+  {
+    Item *item= inner ? key->inner : key->outer;
+    const uchar *pos,*end_pos,*sort_order=0;
+    longlong int_value;
+    double real_value;
+
+    switch (key->cmp_type) {
+    case INT_RESULT:
+      int_value=item->val_int();
+      pos=(const uchar*) &int_value;
+      end_pos=pos+sizeof(int_value);
+      break;
+    case REAL_RESULT:
+      if ((real_value=item->val()) == 0.0)
+	real_value=0.0;				// -0.0 = 0.0
+      pos=(const uchar*) &real_value;
+      end_pos=pos+sizeof(real_value);
+      break;
+    default:
+      if (!(res=item->val_str(&tmp)))
+	return 1;
+      pos=(const uchar*) res->ptr();
+      end_pos=pos+res->length();
+      if (!key->binary)
+      {
+	sort_order=my_sort_order;
+	while (end_pos > pos && hash->end_space[sort_order[end_pos[-1]]])
+	  end_pos--;
+      }
+      break;
+    }
+    if (item->null_value)
+      return 1;
+    for (; pos != end_pos ; pos++)
+    {
+      uint c= sort_order ? sort_order[*pos] : *pos;
+      nr^= (((nr & 63)+nr2)*c)+(nr << 8);
+      nr2+=3;
+    }
+  }
+  *hashnr=(uint32) nr;
+  return 0;
+}
+
+
+/*
+  Link a cached record into its bucket
+
+  NOTES
+    If calc_hash is set, the hash is calculated from the current rows of
+    the previous tables, else it's already in link->hashnr.
+    Records are added last in the bucket so that they are found in the
+    order they were cached.
+*/
+
+static void
+join_hash_insert(JOIN_HASH *hash,JOIN_HASH_LINK *link,bool calc_hash)
+{
+  JOIN_HASH_LINK **bucket;
+
+  link->next=0;
+  if (calc_hash && (link->null_key=join_hash_key(hash,0,&link->hashnr)))
+    return;					// Can't match anything
+  bucket=hash->buckets+((link->hashnr >> 8) % hash->bucket_count)*2;
+  if (bucket[1])
+    bucket[1]->next=link;
+  else
+    bucket[0]=link;
+  bucket[1]=link;
+}
+
+
+/* Empty join buffer of a hash join */
+
+static void
+join_hash_reset(JOIN_CACHE *cache)
+{
+  reset_cache(cache);
+  cache->records=0; cache->ptr_record= (uint) ~0;
+  bzero((char*) cache->hash->buckets,
+	sizeof(JOIN_HASH_LINK*)*2*cache->hash->bucket_count);
+}
+
+
 static bool
 cmp_buffer_with_ref(JOIN_TAB *tab)
 {
@@ -7504,6 +8818,10 @@ static void select_describe(JOIN *join, bool need_tmp_table, bool need_order,
 	  else
 	    buff_ptr=strmov(buff_ptr,"; Using where");
 	}
+	if (tab->cache.hash)
+	  buff_ptr= strmov(buff_ptr,"; Using hash join");
+	if (tab->cache.batched_keys)
+	  buff_ptr= strmov(buff_ptr,"; Using batched key access");
 	if (key_read)
 	  buff_ptr= strmov(buff_ptr,"; Using index");
 	if (table->reginfo.not_exists_optimize)
@@ -65,9 +65,67 @@ typedef struct st_join_cache {
   uint records,record_nr,ptr_record,fields,length,blobs;
   CACHE_FIELD *field,**blob_ptr;
   SQL_SELECT *select;
+  struct st_join_hash *hash;		/* Not 0 if hash join */
+  bool batched_keys;			/* Batched key access */
 } JOIN_CACHE;
 
 
+/*
+** An equality 'inner = outer' in WHERE where inner only depends on one
+** table and outer on other tables. Used to hash join the table with the
+** records in the join cache.
+*/
+
+typedef struct st_hash_join_cond {
+  Item *inner,*outer;
+  Item_result cmp_type;			/* How '=' compares the arguments */
+  bool binary;
+} HASH_JOIN_COND;
+
+
+/*
+** Hash join over a JOIN_CACHE (see join_init_hash()).
+** Each cached record is linked into a bucket on the hash of the outer
+** side of the equalities, so every row of the table is only compared
+** with the cached records that have the same hash. If the records don't
+** fit in the join buffer both sides are written to partition files on
+** the hash and joined one partition at a time.
+*/
+
+typedef struct st_join_hash_link {	/* Before each hashed record */
+  struct st_join_hash_link *next;	/* Next record in bucket */
+  uint32 hashnr;
+  uint record_nr,length;
+  bool null_key;			/* Record can't match */
+} JOIN_HASH_LINK;
+
+typedef struct st_join_hash {
+  HASH_JOIN_COND *keys;
+  uint key_count;
+  JOIN_HASH_LINK **buckets;		/* First and last record in bucket */
+  uint bucket_count;
+  uint partitions;			/* 0 if we can't use partition files */
+  uchar *end_space;			/* Sort values of end space */
+  IO_CACHE *outer_files,*inner_files;	/* Partition files, 0 if not used */
+  JOIN_CACHE inner;			/* Used fields of the table */
+} JOIN_HASH;
+
+
+/*
+** Batched key access (see flush_batched_keys()).
+** The ref keys of all records in the join cache are sorted and read with
+** one multi_range_read_init(), so the handler can fetch the rows in data
+** file order. Records with the same key share one range.
+*/
+
+typedef struct st_join_batch_key {
+  struct st_join_batch_key *next;	/* Next record with the same key */
+  uchar *key;
+  uchar *pos;				/* Record in join cache */
+  uint record_nr;
+} JOIN_BATCH_KEY;
+
+
 /*
 ** The structs which holds the join connections and join states
 */
@@ -93,11 +151,18 @@ typedef struct st_join_table {
   key_map	checked_keys;			/* Keys checked in find_best */
   key_map	needed_reg;
   ha_rows	records,found_records,read_time;
+  ha_rows	examined_rows;			/* For SHOW PROFILE */
   table_map	dependent,key_dependent;
   uint		keys;				/* all keys with can be used */
   uint		use_quick,index;
   uint		status;				// Save status for cache
   uint		used_fields,used_fieldlength,used_blobs;
+  uint		hash_cond_count;
+  HASH_JOIN_COND *hash_conds;			/* For hash join */
+  uint		batch_rows,batch_cond_count;	/* For batched table scan */
+  byte		*batch_buff;
+  bool		*batch_match;
+  Item		**batch_conds;
   enum join_type type;
   bool		cached_eq_ref_table,eq_ref_table,not_used_in_distinct;
   TABLE_REF	ref;
@@ -110,6 +175,7 @@ typedef struct st_position {			/* Used in find_best */
   double records_read;
   JOIN_TAB *table;
   KEYUSE *key;
+  bool use_hash_join;
 } POSITION;
 
 
@@ -174,6 +240,8 @@ class JOIN {
   select_result *result;
   TMP_TABLE_PARAM tmp_table_param;
   MYSQL_LOCK *lock;
+  Aggr_hash *group_hash;		// Groups for end_update_hash()
+  byte	    *group_hash_key;
 };
 
 
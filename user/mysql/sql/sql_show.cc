@@ -1178,6 +1178,45 @@ void mysqld_list_processes(THD *thd,const char *user, bool verbose)
 *****************************************************************************/
 
 
+/*
+  Send one row per counter and key cache partition:
+  Key_cache_part<N>_read_requests, ... Key_cache_part<N>_waits
+*/
+
+static bool show_key_cache_parts(THD *thd, const char *wild, CONVERT *convert)
+{
+  char buff[80], name[64];
+  String packet2(buff,sizeof(buff));
+  KEY_CACHE_PART_STATS stats;
+  DBUG_ENTER("show_key_cache_parts");
+
+  for (uint part=0 ; !get_key_cache_part_stats(part, &stats) ; part++)
+  {
+    struct { const char *suffix; ulong value; } counters[]=
+    {
+      {"blocks_used",	 stats.blocks_used},
+      {"read_requests",	 stats.r_requests},
+      {"reads",		 stats.reads},
+      {"write_requests", stats.w_requests},
+      {"writes",	 stats.writes},
+      {"waits",		 stats.lock_waits}
+    };
+    for (uint i=0 ; i < array_elements(counters) ; i++)
+    {
+      sprintf(name, "Key_cache_part%u_%s", part, counters[i].suffix);
+      if (wild && wild[0] && wild_case_compare(name,wild))
+	continue;
+      packet2.length(0);
+      net_store_data(&packet2,convert,name);
+      net_store_data(&packet2,(uint32) counters[i].value);
+      if (my_net_write(&thd->net, (char*) packet2.ptr(),packet2.length()))
+	DBUG_RETURN(1);
+    }
+  }
+  DBUG_RETURN(0);
+}
+
+
 int mysqld_show(THD *thd, const char *wild, show_var_st *variables,
 		enum enum_var_type value_type,
 		pthread_mutex_t *mutex)
@@ -1196,6 +1235,12 @@ int mysqld_show(THD *thd, const char *wild, show_var_st *variables,
   pthread_mutex_lock(mutex);
   for (; variables->name; variables++)
   {
+    if (variables->type == SHOW_KEY_CACHE_PARTS)
+    {
+      if (show_key_cache_parts(thd, wild, convert))
+	goto err;
+      continue;
+    }
     if (!(wild && wild[0] && wild_case_compare(variables->name,wild)))
     {
       packet2.length(0);
@@ -1263,6 +1308,14 @@ int mysqld_show(THD *thd, const char *wild, show_var_st *variables,
       case SHOW_OPENTABLES:
         net_store_data(&packet2,(uint32) cached_tables());
         break;
+      case SHOW_BINLOG_GROUP_SIZE:
+      {
+        char buff[22];
+        sprintf(buff, "%.2f", binlog_group_commits ?
+                (double) binlog_group_commit_trx / binlog_group_commits : 0.0);
+        net_store_data(&packet2,buff);
+        break;
+      }
       case SHOW_CHAR_PTR:
       {
 	value= *(char**) value;
@@ -1428,6 +1481,7 @@ int mysqld_show(THD *thd, const char *wild, show_var_st *variables,
 #endif /* HAVE_OPENSSL */
       case SHOW_UNDEF:				// Show never happen
       case SHOW_SYS:
+      case SHOW_KEY_CACHE_PARTS:
 	net_store_data(&packet2, "");		// Safety
 	break;
       }
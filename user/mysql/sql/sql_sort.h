@@ -38,6 +38,8 @@ typedef struct st_sort_param {
   SORT_FIELD *end;
   uchar *unique_buff;
   bool not_killable;
+  volatile bool *killed;		/* If not &current_thd->killed */
+  uint threads;				/* Threads to sort and merge with */
 #ifdef USE_STRCOLL
   char* tmp_buffer;
 #endif
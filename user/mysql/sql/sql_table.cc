@@ -35,6 +35,8 @@ static const char *primary_key_name="PRIMARY";
 
 static bool check_if_keyname_exists(const char *name,KEY *start, KEY *end);
 static char *make_unique_key_name(const char *field_name,KEY *start,KEY *end);
+static int build_keys_between_tables(TABLE *from,TABLE *to,
+				     ha_rows *copied);
 static int copy_data_between_tables(TABLE *from,TABLE *to,
 				    List<create_field> &create,
 				    enum enum_duplicates handle_duplicates,
@@ -1451,6 +1453,7 @@ int mysql_alter_table(THD *thd,char *new_db, char *new_name,
   ha_rows copied,deleted;
   ulonglong next_insert_id;
   uint save_time_stamp,db_create_options, used_fields;
+  bool keys_only;
   enum db_type old_db_type,new_db_type;
   DBUG_ENTER("mysql_alter_table");
 
@@ -1579,6 +1582,23 @@ int mysql_alter_table(THD *thd,char *new_db, char *new_name,
   List<create_field> create_list;		// Add new fields here
   List<Key> key_list;				// Add new keys here
 
+  /*
+    If only keys are added or dropped, the handler may be able to create
+    the new table without copying the rows one by one
+  */
+  keys_only= (!fields.elements && !alter_list.elements && !order &&
+	      !used_fields && handle_duplicates == DUP_ERROR &&
+	      keys_onoff == LEAVE_AS_IS && new_db_type == old_db_type);
+  {
+    Alter_drop *drop;
+    while ((drop=drop_it++))
+    {
+      if (drop->type == Alter_drop::COLUMN)
+	keys_only=0;
+    }
+    drop_it.rewind();
+  }
+
   /*
   ** First collect all fields from table which isn't in drop_list
   */
@@ -1766,7 +1786,10 @@ int mysql_alter_table(THD *thd,char *new_db, char *new_name,
 				  Key::PRIMARY  : Key::UNIQUE) :
                                  (key_info->flags & HA_FULLTEXT ?
                                  Key::FULLTEXT : Key::MULTIPLE),
-				 key_name,key_parts));
+				 key_name,
+				 (key_info->algorithm == HA_KEY_ALG_FULLTEXT ?
+				  HA_KEY_ALG_UNDEF : key_info->algorithm),
+				 key_parts));
   }
   key_it.rewind();
   {
@@ -1895,9 +1918,15 @@ int mysql_alter_table(THD *thd,char *new_db, char *new_name,
   next_insert_id=thd->next_insert_id;		// Remember for loggin
   copied=deleted=0;
   if (!new_table->is_view)
-    error=copy_data_between_tables(table,new_table,create_list,
-				   handle_duplicates,
-				   order, &copied, &deleted);
+  {
+    error=1;
+    if (keys_only)
+      error=build_keys_between_tables(table,new_table,&copied);
+    if (error > 0)
+      error=copy_data_between_tables(table,new_table,create_list,
+				     handle_duplicates,
+				     order, &copied, &deleted);
+  }
   thd->last_insert_id=next_insert_id;		// Needed for correct log
   thd->count_cuted_fields=0;			// Don`t calc cuted fields
   new_table->time_stamp=save_time_stamp;
@@ -2106,6 +2135,52 @@ end_temporary:
 }
 
 
+/*
+  Create the new table of an ALTER TABLE that only adds or drops keys
+
+  SYNOPSIS
+    build_keys_between_tables()
+    from		Old table
+    to			New, empty table with the same columns
+    copied		Store number of rows here
+
+  NOTES
+    The old table is only locked against writes, so it can be read
+    while the new keys are created.
+
+  RETURN
+    0	ok
+    1	Not supported by the handler; Use copy_data_between_tables()
+    -1	Error
+*/
+
+static int build_keys_between_tables(TABLE *from, TABLE *to,
+				     ha_rows *copied)
+{
+  int error;
+  THD *thd= current_thd;
+  DBUG_ENTER("build_keys_between_tables");
+
+  if ((error=to->file->external_lock(thd,F_WRLCK)))
+  {
+    to->file->print_error(error,MYF(0));
+    DBUG_RETURN(-1);
+  }
+  from->file->info(HA_STATUS_VARIABLE);
+  error=to->file->build_keys_from(thd,from);
+  if (ha_commit_stmt(thd) || ha_commit(thd))
+    error= -1;
+  if (to->file->external_lock(thd,F_UNLCK) && !error)
+    error= -1;
+  if (error == HA_ERR_WRONG_COMMAND)
+    DBUG_RETURN(1);
+  if (error)
+    DBUG_RETURN(-1);
+  *copied= from->file->records;
+  DBUG_RETURN(0);
+}
+
+
 static int
 copy_data_between_tables(TABLE *from,TABLE *to,
                          List<create_field> &create,
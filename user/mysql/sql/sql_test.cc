@@ -212,6 +212,7 @@ void mysql_print_status(THD *thd)
   if (thd)
     thd->proc_info="key cache";
   pthread_mutex_lock(&THR_LOCK_keycache);
+  update_key_cache_stats();
   printf("key_cache status:\n\
 blocks used:%10lu\n\
 not flushed:%10lu\n\
@@ -1,12 +1,14 @@
-/* A Bison parser, made from sql_yacc.yy, by GNU bison 1.75.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton parser for Yacc-like parsing with Bison,
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002 Free Software Foundation, Inc.
+/* Bison interface for Yacc-like parsers in C
 
-   This program is free software; you can redistribute it and/or modify
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -14,817 +16,845 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 59 Temple Place - Suite 330,
-   Boston, MA 02111-1307, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
 
-/* As a special exception, when this file is copied by Bison into a
-   Bison output file, you may use that output file without restriction.
-   This special exception was added by the Free Software Foundation
-   in version 1.24 of Bison.  */
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
 
-#ifndef BISON_Y_TAB_H
-# define BISON_Y_TAB_H
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
 
-/* Tokens.  */
+#ifndef YY_YY_Y_TAB_H_INCLUDED
+# define YY_YY_Y_TAB_H_INCLUDED
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     END_OF_INPUT = 258,
-     CLOSE_SYM = 259,
-     HANDLER_SYM = 260,
-     LAST_SYM = 261,
-     NEXT_SYM = 262,
-     PREV_SYM = 263,
-     EQ = 264,
-     EQUAL_SYM = 265,
-     GE = 266,
-     GT_SYM = 267,
-     LE = 268,
-     LT = 269,
-     NE = 270,
-     IS = 271,
-     SHIFT_LEFT = 272,
-     SHIFT_RIGHT = 273,
-     SET_VAR = 274,
-     ABORT_SYM = 275,
-     ADD = 276,
-     AFTER_SYM = 277,
-     ALTER = 278,
-     ANALYZE_SYM = 279,
-     AVG_SYM = 280,
-     BEGIN_SYM = 281,
-     BINLOG_SYM = 282,
-     CHANGE = 283,
-     CLIENT_SYM = 284,
-     COMMENT_SYM = 285,
-     COMMIT_SYM = 286,
-     COUNT_SYM = 287,
-     CREATE = 288,
-     CROSS = 289,
-     CUBE_SYM = 290,
-     DELETE_SYM = 291,
-     DO_SYM = 292,
-     DROP = 293,
-     EVENTS_SYM = 294,
-     EXECUTE_SYM = 295,
-     FLUSH_SYM = 296,
-     INSERT = 297,
-     IO_THREAD = 298,
-     KILL_SYM = 299,
-     LOAD = 300,
-     LOCKS_SYM = 301,
-     LOCK_SYM = 302,
-     MASTER_SYM = 303,
-     MAX_SYM = 304,
-     MIN_SYM = 305,
-     NONE_SYM = 306,
-     OPTIMIZE = 307,
-     PURGE = 308,
-     REPAIR = 309,
-     REPLICATION = 310,
-     RESET_SYM = 311,
-     ROLLBACK_SYM = 312,
-     ROLLUP_SYM = 313,
-     SAVEPOINT_SYM = 314,
-     SELECT_SYM = 315,
-     SHOW = 316,
-     SLAVE = 317,
-     SQL_THREAD = 318,
-     START_SYM = 319,
-     STD_SYM = 320,
-     STOP_SYM = 321,
-     SUM_SYM = 322,
-     SUPER_SYM = 323,
-     TRUNCATE_SYM = 324,
-     UNLOCK_SYM = 325,
-     UPDATE_SYM = 326,
-     ACTION = 327,
-     AGGREGATE_SYM = 328,
-     ALL = 329,
-     AND = 330,
-     AS = 331,
-     ASC = 332,
-     AUTO_INC = 333,
-     AVG_ROW_LENGTH = 334,
-     BACKUP_SYM = 335,
-     BERKELEY_DB_SYM = 336,
-     BINARY = 337,
-     BIT_SYM = 338,
-     BOOL_SYM = 339,
-     BOOLEAN_SYM = 340,
-     BOTH = 341,
-     BY = 342,
-     CACHE_SYM = 343,
-     CASCADE = 344,
-     CAST_SYM = 345,
-     CHARSET = 346,
-     CHECKSUM_SYM = 347,
-     CHECK_SYM = 348,
-     COMMITTED_SYM = 349,
-     COLUMNS = 350,
-     COLUMN_SYM = 351,
-     CONCURRENT = 352,
-     CONSTRAINT = 353,
-     CONVERT_SYM = 354,
-     DATABASES = 355,
-     DATA_SYM = 356,
-     DEFAULT = 357,
-     DELAYED_SYM = 358,
-     DELAY_KEY_WRITE_SYM = 359,
-     DESC = 360,
-     DESCRIBE = 361,
-     DES_KEY_FILE = 362,
-     DISABLE_SYM = 363,
-     DISTINCT = 364,
-     DYNAMIC_SYM = 365,
-     ENABLE_SYM = 366,
-     ENCLOSED = 367,
-     ESCAPED = 368,
-     DIRECTORY_SYM = 369,
-     ESCAPE_SYM = 370,
-     EXISTS = 371,
-     EXTENDED_SYM = 372,
-     FILE_SYM = 373,
-     FIRST_SYM = 374,
-     FIXED_SYM = 375,
-     FLOAT_NUM = 376,
-     FORCE_SYM = 377,
-     FOREIGN = 378,
-     FROM = 379,
-     FULL = 380,
-     FULLTEXT_SYM = 381,
-     GLOBAL_SYM = 382,
-     GRANT = 383,
-     GRANTS = 384,
-     GREATEST_SYM = 385,
-     GROUP = 386,
-     HAVING = 387,
-     HEAP_SYM = 388,
-     HEX_NUM = 389,
-     HIGH_PRIORITY = 390,
-     HOSTS_SYM = 391,
-     IDENT = 392,
-     IGNORE_SYM = 393,
-     INDEX = 394,
-     INDEXES = 395,
-     INFILE = 396,
-     INNER_SYM = 397,
-     INNOBASE_SYM = 398,
-     INTO = 399,
-     IN_SYM = 400,
-     ISOLATION = 401,
-     ISAM_SYM = 402,
-     JOIN_SYM = 403,
-     KEYS = 404,
-     KEY_SYM = 405,
-     LEADING = 406,
-     LEAST_SYM = 407,
-     LEVEL_SYM = 408,
-     LEX_HOSTNAME = 409,
-     LIKE = 410,
-     LINES = 411,
-     LOCAL_SYM = 412,
-     LOG_SYM = 413,
-     LOGS_SYM = 414,
-     LONG_NUM = 415,
-     LONG_SYM = 416,
-     LOW_PRIORITY = 417,
-     MASTER_HOST_SYM = 418,
-     MASTER_USER_SYM = 419,
-     MASTER_LOG_FILE_SYM = 420,
-     MASTER_LOG_POS_SYM = 421,
-     MASTER_PASSWORD_SYM = 422,
-     MASTER_PORT_SYM = 423,
-     MASTER_CONNECT_RETRY_SYM = 424,
-     MASTER_SERVER_ID_SYM = 425,
-     RELAY_LOG_FILE_SYM = 426,
-     RELAY_LOG_POS_SYM = 427,
-     MATCH = 428,
-     MAX_ROWS = 429,
-     MAX_CONNECTIONS_PER_HOUR = 430,
-     MAX_QUERIES_PER_HOUR = 431,
-     MAX_UPDATES_PER_HOUR = 432,
-     MEDIUM_SYM = 433,
-     MERGE_SYM = 434,
-     MEMORY_SYM = 435,
-     MIN_ROWS = 436,
-     MYISAM_SYM = 437,
-     NATIONAL_SYM = 438,
-     NATURAL = 439,
-     NEW_SYM = 440,
-     NCHAR_SYM = 441,
-     NOT = 442,
-     NO_SYM = 443,
-     NULL_SYM = 444,
-     NUM = 445,
-     OFFSET_SYM = 446,
-     ON = 447,
-     OPEN_SYM = 448,
-     OPTION = 449,
-     OPTIONALLY = 450,
-     OR = 451,
-     OR_OR_CONCAT = 452,
-     ORDER_SYM = 453,
-     OUTER = 454,
-     OUTFILE = 455,
-     DUMPFILE = 456,
-     PACK_KEYS_SYM = 457,
-     PARTIAL = 458,
-     PRIMARY_SYM = 459,
-     PRIVILEGES = 460,
-     PROCESS = 461,
-     PROCESSLIST_SYM = 462,
-     QUERY_SYM = 463,
-     RAID_0_SYM = 464,
-     RAID_STRIPED_SYM = 465,
-     RAID_TYPE = 466,
-     RAID_CHUNKS = 467,
-     RAID_CHUNKSIZE = 468,
-     READ_SYM = 469,
-     REAL_NUM = 470,
-     REFERENCES = 471,
-     REGEXP = 472,
-     RELOAD = 473,
-     RENAME = 474,
-     REPEATABLE_SYM = 475,
-     REQUIRE_SYM = 476,
-     RESOURCES = 477,
-     RESTORE_SYM = 478,
-     RESTRICT = 479,
-     REVOKE = 480,
-     ROWS_SYM = 481,
-     ROW_FORMAT_SYM = 482,
-     ROW_SYM = 483,
-     SET = 484,
-     SERIALIZABLE_SYM = 485,
-     SESSION_SYM = 486,
-     SHUTDOWN = 487,
-     SSL_SYM = 488,
-     STARTING = 489,
-     STATUS_SYM = 490,
-     STRAIGHT_JOIN = 491,
-     SUBJECT_SYM = 492,
-     TABLES = 493,
-     TABLE_SYM = 494,
-     TEMPORARY = 495,
-     TERMINATED = 496,
-     TEXT_STRING = 497,
-     TO_SYM = 498,
-     TRAILING = 499,
-     TRANSACTION_SYM = 500,
-     TYPE_SYM = 501,
-     FUNC_ARG0 = 502,
-     FUNC_ARG1 = 503,
-     FUNC_ARG2 = 504,
-     FUNC_ARG3 = 505,
-     UDF_RETURNS_SYM = 506,
-     UDF_SONAME_SYM = 507,
-     UDF_SYM = 508,
-     UNCOMMITTED_SYM = 509,
-     UNION_SYM = 510,
-     UNIQUE_SYM = 511,
-     USAGE = 512,
-     USE_FRM = 513,
-     USE_SYM = 514,
-     USING = 515,
-     VALUES = 516,
-     VARIABLES = 517,
-     WHERE = 518,
-     WITH = 519,
-     WRITE_SYM = 520,
-     X509_SYM = 521,
-     XOR = 522,
-     COMPRESSED_SYM = 523,
-     BIGINT = 524,
-     BLOB_SYM = 525,
-     CHAR_SYM = 526,
-     CHANGED = 527,
-     COALESCE = 528,
-     DATETIME = 529,
-     DATE_SYM = 530,
-     DECIMAL_SYM = 531,
-     DOUBLE_SYM = 532,
-     ENUM = 533,
-     FAST_SYM = 534,
-     FLOAT_SYM = 535,
-     INT_SYM = 536,
-     LIMIT = 537,
-     LONGBLOB = 538,
-     LONGTEXT = 539,
-     MEDIUMBLOB = 540,
-     MEDIUMINT = 541,
-     MEDIUMTEXT = 542,
-     NUMERIC_SYM = 543,
-     PRECISION = 544,
-     QUICK = 545,
-     REAL = 546,
-     SIGNED_SYM = 547,
-     SMALLINT = 548,
-     STRING_SYM = 549,
-     TEXT_SYM = 550,
-     TIMESTAMP = 551,
-     TIME_SYM = 552,
-     TINYBLOB = 553,
-     TINYINT = 554,
-     TINYTEXT = 555,
-     ULONGLONG_NUM = 556,
-     UNSIGNED = 557,
-     VARBINARY = 558,
-     VARCHAR = 559,
-     VARYING = 560,
-     ZEROFILL = 561,
-     AGAINST = 562,
-     ATAN = 563,
-     BETWEEN_SYM = 564,
-     BIT_AND = 565,
-     BIT_OR = 566,
-     CASE_SYM = 567,
-     CONCAT = 568,
-     CONCAT_WS = 569,
-     CURDATE = 570,
-     CURTIME = 571,
-     DATABASE = 572,
-     DATE_ADD_INTERVAL = 573,
-     DATE_SUB_INTERVAL = 574,
-     DAY_HOUR_SYM = 575,
-     DAY_MINUTE_SYM = 576,
-     DAY_SECOND_SYM = 577,
-     DAY_SYM = 578,
-     DECODE_SYM = 579,
-     DES_ENCRYPT_SYM = 580,
-     DES_DECRYPT_SYM = 581,
-     ELSE = 582,
-     ELT_FUNC = 583,
-     ENCODE_SYM = 584,
-     ENCRYPT = 585,
-     EXPORT_SET = 586,
-     EXTRACT_SYM = 587,
-     FIELD_FUNC = 588,
-     FORMAT_SYM = 589,
-     FOR_SYM = 590,
-     FROM_UNIXTIME = 591,
-     GROUP_UNIQUE_USERS = 592,
-     HOUR_MINUTE_SYM = 593,
-     HOUR_SECOND_SYM = 594,
-     HOUR_SYM = 595,
-     IDENTIFIED_SYM = 596,
-     IF = 597,
-     INSERT_METHOD = 598,
-     INTERVAL_SYM = 599,
-     LAST_INSERT_ID = 600,
-     LEFT = 601,
-     LOCATE = 602,
-     MAKE_SET_SYM = 603,
-     MASTER_POS_WAIT = 604,
-     MINUTE_SECOND_SYM = 605,
-     MINUTE_SYM = 606,
-     MODE_SYM = 607,
-     MODIFY_SYM = 608,
-     MONTH_SYM = 609,
-     NOW_SYM = 610,
-     PASSWORD = 611,
-     POSITION_SYM = 612,
-     PROCEDURE = 613,
-     RAND = 614,
-     REPLACE = 615,
-     RIGHT = 616,
-     ROUND = 617,
-     SECOND_SYM = 618,
-     SHARE_SYM = 619,
-     SUBSTRING = 620,
-     SUBSTRING_INDEX = 621,
-     TRIM = 622,
-     UDA_CHAR_SUM = 623,
-     UDA_FLOAT_SUM = 624,
-     UDA_INT_SUM = 625,
-     UDF_CHAR_FUNC = 626,
-     UDF_FLOAT_FUNC = 627,
-     UDF_INT_FUNC = 628,
-     UNIQUE_USERS = 629,
-     UNIX_TIMESTAMP = 630,
-     USER = 631,
-     WEEK_SYM = 632,
-     WHEN_SYM = 633,
-     WORK_SYM = 634,
-     YEAR_MONTH_SYM = 635,
-     YEAR_SYM = 636,
-     YEARWEEK = 637,
-     BENCHMARK_SYM = 638,
-     END = 639,
-     THEN_SYM = 640,
-     SQL_BIG_RESULT = 641,
-     SQL_CACHE_SYM = 642,
-     SQL_CALC_FOUND_ROWS = 643,
-     SQL_NO_CACHE_SYM = 644,
-     SQL_SMALL_RESULT = 645,
-     SQL_BUFFER_RESULT = 646,
-     ISSUER_SYM = 647,
-     CIPHER_SYM = 648,
-     NEG = 649
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    END_OF_INPUT = 258,            /* END_OF_INPUT  */
+    CLOSE_SYM = 259,               /* CLOSE_SYM  */
+    HANDLER_SYM = 260,             /* HANDLER_SYM  */
+    HASH_SYM = 261,                /* HASH_SYM  */
+    LAST_SYM = 262,                /* LAST_SYM  */
+    NEXT_SYM = 263,                /* NEXT_SYM  */
+    PREV_SYM = 264,                /* PREV_SYM  */
+    EQ = 265,                      /* EQ  */
+    EQUAL_SYM = 266,               /* EQUAL_SYM  */
+    GE = 267,                      /* GE  */
+    GT_SYM = 268,                  /* GT_SYM  */
+    LE = 269,                      /* LE  */
+    LT = 270,                      /* LT  */
+    NE = 271,                      /* NE  */
+    IS = 272,                      /* IS  */
+    SHIFT_LEFT = 273,              /* SHIFT_LEFT  */
+    SHIFT_RIGHT = 274,             /* SHIFT_RIGHT  */
+    SET_VAR = 275,                 /* SET_VAR  */
+    ABORT_SYM = 276,               /* ABORT_SYM  */
+    ADD = 277,                     /* ADD  */
+    AFTER_SYM = 278,               /* AFTER_SYM  */
+    ALTER = 279,                   /* ALTER  */
+    ANALYZE_SYM = 280,             /* ANALYZE_SYM  */
+    AVG_SYM = 281,                 /* AVG_SYM  */
+    BEGIN_SYM = 282,               /* BEGIN_SYM  */
+    BINLOG_SYM = 283,              /* BINLOG_SYM  */
+    CHANGE = 284,                  /* CHANGE  */
+    CLIENT_SYM = 285,              /* CLIENT_SYM  */
+    COMMENT_SYM = 286,             /* COMMENT_SYM  */
+    COMMIT_SYM = 287,              /* COMMIT_SYM  */
+    COUNT_SYM = 288,               /* COUNT_SYM  */
+    CREATE = 289,                  /* CREATE  */
+    CROSS = 290,                   /* CROSS  */
+    CUBE_SYM = 291,                /* CUBE_SYM  */
+    DELETE_SYM = 292,              /* DELETE_SYM  */
+    DO_SYM = 293,                  /* DO_SYM  */
+    DROP = 294,                    /* DROP  */
+    EVENTS_SYM = 295,              /* EVENTS_SYM  */
+    EXECUTE_SYM = 296,             /* EXECUTE_SYM  */
+    FLUSH_SYM = 297,               /* FLUSH_SYM  */
+    INSERT = 298,                  /* INSERT  */
+    IO_THREAD = 299,               /* IO_THREAD  */
+    KILL_SYM = 300,                /* KILL_SYM  */
+    LOAD = 301,                    /* LOAD  */
+    LOCKS_SYM = 302,               /* LOCKS_SYM  */
+    LOCK_SYM = 303,                /* LOCK_SYM  */
+    MASTER_SYM = 304,              /* MASTER_SYM  */
+    MAX_SYM = 305,                 /* MAX_SYM  */
+    MIN_SYM = 306,                 /* MIN_SYM  */
+    NONE_SYM = 307,                /* NONE_SYM  */
+    OPTIMIZE = 308,                /* OPTIMIZE  */
+    PURGE = 309,                   /* PURGE  */
+    REPAIR = 310,                  /* REPAIR  */
+    REPLICATION = 311,             /* REPLICATION  */
+    RESET_SYM = 312,               /* RESET_SYM  */
+    ROLLBACK_SYM = 313,            /* ROLLBACK_SYM  */
+    ROLLUP_SYM = 314,              /* ROLLUP_SYM  */
+    SAVEPOINT_SYM = 315,           /* SAVEPOINT_SYM  */
+    SELECT_SYM = 316,              /* SELECT_SYM  */
+    SHOW = 317,                    /* SHOW  */
+    SLAVE = 318,                   /* SLAVE  */
+    SQL_THREAD = 319,              /* SQL_THREAD  */
+    START_SYM = 320,               /* START_SYM  */
+    STD_SYM = 321,                 /* STD_SYM  */
+    STOP_SYM = 322,                /* STOP_SYM  */
+    SUM_SYM = 323,                 /* SUM_SYM  */
+    SUPER_SYM = 324,               /* SUPER_SYM  */
+    TRUNCATE_SYM = 325,            /* TRUNCATE_SYM  */
+    UNLOCK_SYM = 326,              /* UNLOCK_SYM  */
+    UPDATE_SYM = 327,              /* UPDATE_SYM  */
+    ACTION = 328,                  /* ACTION  */
+    AGGREGATE_SYM = 329,           /* AGGREGATE_SYM  */
+    ALL = 330,                     /* ALL  */
+    AND = 331,                     /* AND  */
+    AS = 332,                      /* AS  */
+    ASC = 333,                     /* ASC  */
+    AUTO_INC = 334,                /* AUTO_INC  */
+    AVG_ROW_LENGTH = 335,          /* AVG_ROW_LENGTH  */
+    BACKUP_SYM = 336,              /* BACKUP_SYM  */
+    BERKELEY_DB_SYM = 337,         /* BERKELEY_DB_SYM  */
+    BINARY = 338,                  /* BINARY  */
+    BIT_SYM = 339,                 /* BIT_SYM  */
+    BOOL_SYM = 340,                /* BOOL_SYM  */
+    BOOLEAN_SYM = 341,             /* BOOLEAN_SYM  */
+    BOTH = 342,                    /* BOTH  */
+    BTREE_SYM = 343,               /* BTREE_SYM  */
+    BY = 344,                      /* BY  */
+    CACHE_SYM = 345,               /* CACHE_SYM  */
+    CASCADE = 346,                 /* CASCADE  */
+    CAST_SYM = 347,                /* CAST_SYM  */
+    CHARSET = 348,                 /* CHARSET  */
+    CHECKSUM_SYM = 349,            /* CHECKSUM_SYM  */
+    CHECK_SYM = 350,               /* CHECK_SYM  */
+    COMMITTED_SYM = 351,           /* COMMITTED_SYM  */
+    COLUMNS = 352,                 /* COLUMNS  */
+    COLUMN_SYM = 353,              /* COLUMN_SYM  */
+    CONCURRENT = 354,              /* CONCURRENT  */
+    CONSTRAINT = 355,              /* CONSTRAINT  */
+    CONVERT_SYM = 356,             /* CONVERT_SYM  */
+    DATABASES = 357,               /* DATABASES  */
+    DATA_SYM = 358,                /* DATA_SYM  */
+    DEFAULT = 359,                 /* DEFAULT  */
+    DELAYED_SYM = 360,             /* DELAYED_SYM  */
+    DELAY_KEY_WRITE_SYM = 361,     /* DELAY_KEY_WRITE_SYM  */
+    DESC = 362,                    /* DESC  */
+    DESCRIBE = 363,                /* DESCRIBE  */
+    DES_KEY_FILE = 364,            /* DES_KEY_FILE  */
+    DISABLE_SYM = 365,             /* DISABLE_SYM  */
+    DISTINCT = 366,                /* DISTINCT  */
+    DYNAMIC_SYM = 367,             /* DYNAMIC_SYM  */
+    ENABLE_SYM = 368,              /* ENABLE_SYM  */
+    ENCLOSED = 369,                /* ENCLOSED  */
+    ESCAPED = 370,                 /* ESCAPED  */
+    DIRECTORY_SYM = 371,           /* DIRECTORY_SYM  */
+    ESCAPE_SYM = 372,              /* ESCAPE_SYM  */
+    EXISTS = 373,                  /* EXISTS  */
+    EXTENDED_SYM = 374,            /* EXTENDED_SYM  */
+    FILE_SYM = 375,                /* FILE_SYM  */
+    FIRST_SYM = 376,               /* FIRST_SYM  */
+    FIXED_SYM = 377,               /* FIXED_SYM  */
+    FLOAT_NUM = 378,               /* FLOAT_NUM  */
+    FORCE_SYM = 379,               /* FORCE_SYM  */
+    FOREIGN = 380,                 /* FOREIGN  */
+    FROM = 381,                    /* FROM  */
+    FULL = 382,                    /* FULL  */
+    FULLTEXT_SYM = 383,            /* FULLTEXT_SYM  */
+    GLOBAL_SYM = 384,              /* GLOBAL_SYM  */
+    GRANT = 385,                   /* GRANT  */
+    GRANTS = 386,                  /* GRANTS  */
+    GREATEST_SYM = 387,            /* GREATEST_SYM  */
+    GROUP = 388,                   /* GROUP  */
+    HAVING = 389,                  /* HAVING  */
+    HEAP_SYM = 390,                /* HEAP_SYM  */
+    HEX_NUM = 391,                 /* HEX_NUM  */
+    HIGH_PRIORITY = 392,           /* HIGH_PRIORITY  */
+    HOSTS_SYM = 393,               /* HOSTS_SYM  */
+    IDENT = 394,                   /* IDENT  */
+    IGNORE_SYM = 395,              /* IGNORE_SYM  */
+    INDEX = 396,                   /* INDEX  */
+    INDEXES = 397,                 /* INDEXES  */
+    INFILE = 398,                  /* INFILE  */
+    INNER_SYM = 399,               /* INNER_SYM  */
+    INNOBASE_SYM = 400,            /* INNOBASE_SYM  */
+    INTO = 401,                    /* INTO  */
+    IN_SYM = 402,                  /* IN_SYM  */
+    ISOLATION = 403,               /* ISOLATION  */
+    ISAM_SYM = 404,                /* ISAM_SYM  */
+    JOIN_SYM = 405,                /* JOIN_SYM  */
+    KEYS = 406,                    /* KEYS  */
+    KEY_SYM = 407,                 /* KEY_SYM  */
+    LEADING = 408,                 /* LEADING  */
+    LEAST_SYM = 409,               /* LEAST_SYM  */
+    LEVEL_SYM = 410,               /* LEVEL_SYM  */
+    LEX_HOSTNAME = 411,            /* LEX_HOSTNAME  */
+    LIKE = 412,                    /* LIKE  */
+    LINES = 413,                   /* LINES  */
+    LOCAL_SYM = 414,               /* LOCAL_SYM  */
+    LOG_SYM = 415,                 /* LOG_SYM  */
+    LOGS_SYM = 416,                /* LOGS_SYM  */
+    LONG_NUM = 417,                /* LONG_NUM  */
+    LONG_SYM = 418,                /* LONG_SYM  */
+    LOW_PRIORITY = 419,            /* LOW_PRIORITY  */
+    MASTER_HOST_SYM = 420,         /* MASTER_HOST_SYM  */
+    MASTER_USER_SYM = 421,         /* MASTER_USER_SYM  */
+    MASTER_LOG_FILE_SYM = 422,     /* MASTER_LOG_FILE_SYM  */
+    MASTER_LOG_POS_SYM = 423,      /* MASTER_LOG_POS_SYM  */
+    MASTER_PASSWORD_SYM = 424,     /* MASTER_PASSWORD_SYM  */
+    MASTER_PORT_SYM = 425,         /* MASTER_PORT_SYM  */
+    MASTER_CONNECT_RETRY_SYM = 426, /* MASTER_CONNECT_RETRY_SYM  */
+    MASTER_SERVER_ID_SYM = 427,    /* MASTER_SERVER_ID_SYM  */
+    RELAY_LOG_FILE_SYM = 428,      /* RELAY_LOG_FILE_SYM  */
+    RELAY_LOG_POS_SYM = 429,       /* RELAY_LOG_POS_SYM  */
+    MATCH = 430,                   /* MATCH  */
+    MAX_ROWS = 431,                /* MAX_ROWS  */
+    MAX_CONNECTIONS_PER_HOUR = 432, /* MAX_CONNECTIONS_PER_HOUR  */
+    MAX_QUERIES_PER_HOUR = 433,    /* MAX_QUERIES_PER_HOUR  */
+    MAX_UPDATES_PER_HOUR = 434,    /* MAX_UPDATES_PER_HOUR  */
+    MEDIUM_SYM = 435,              /* MEDIUM_SYM  */
+    MERGE_SYM = 436,               /* MERGE_SYM  */
+    MEMORY_SYM = 437,              /* MEMORY_SYM  */
+    MIN_ROWS = 438,                /* MIN_ROWS  */
+    MYISAM_SYM = 439,              /* MYISAM_SYM  */
+    NATIONAL_SYM = 440,            /* NATIONAL_SYM  */
+    NATURAL = 441,                 /* NATURAL  */
+    NEW_SYM = 442,                 /* NEW_SYM  */
+    NCHAR_SYM = 443,               /* NCHAR_SYM  */
+    NOT = 444,                     /* NOT  */
+    NO_SYM = 445,                  /* NO_SYM  */
+    NULL_SYM = 446,                /* NULL_SYM  */
+    NUM = 447,                     /* NUM  */
+    OFFSET_SYM = 448,              /* OFFSET_SYM  */
+    ON = 449,                      /* ON  */
+    OPEN_SYM = 450,                /* OPEN_SYM  */
+    OPTION = 451,                  /* OPTION  */
+    OPTIONALLY = 452,              /* OPTIONALLY  */
+    OR = 453,                      /* OR  */
+    OR_OR_CONCAT = 454,            /* OR_OR_CONCAT  */
+    ORDER_SYM = 455,               /* ORDER_SYM  */
+    OUTER = 456,                   /* OUTER  */
+    OUTFILE = 457,                 /* OUTFILE  */
+    DUMPFILE = 458,                /* DUMPFILE  */
+    PACK_KEYS_SYM = 459,           /* PACK_KEYS_SYM  */
+    PARTIAL = 460,                 /* PARTIAL  */
+    PRIMARY_SYM = 461,             /* PRIMARY_SYM  */
+    PRIVILEGES = 462,              /* PRIVILEGES  */
+    PROCESS = 463,                 /* PROCESS  */
+    PROCESSLIST_SYM = 464,         /* PROCESSLIST_SYM  */
+    PROFILE_SYM = 465,             /* PROFILE_SYM  */
+    PROFILES_SYM = 466,            /* PROFILES_SYM  */
+    QUERY_SYM = 467,               /* QUERY_SYM  */
+    RAID_0_SYM = 468,              /* RAID_0_SYM  */
+    RAID_STRIPED_SYM = 469,        /* RAID_STRIPED_SYM  */
+    RAID_TYPE = 470,               /* RAID_TYPE  */
+    RAID_CHUNKS = 471,             /* RAID_CHUNKS  */
+    RAID_CHUNKSIZE = 472,          /* RAID_CHUNKSIZE  */
+    READ_SYM = 473,                /* READ_SYM  */
+    REAL_NUM = 474,                /* REAL_NUM  */
+    REFERENCES = 475,              /* REFERENCES  */
+    REGEXP = 476,                  /* REGEXP  */
+    RELOAD = 477,                  /* RELOAD  */
+    RENAME = 478,                  /* RENAME  */
+    REPEATABLE_SYM = 479,          /* REPEATABLE_SYM  */
+    REQUIRE_SYM = 480,             /* REQUIRE_SYM  */
+    RESOURCES = 481,               /* RESOURCES  */
+    RESTORE_SYM = 482,             /* RESTORE_SYM  */
+    RESTRICT = 483,                /* RESTRICT  */
+    REVOKE = 484,                  /* REVOKE  */
+    ROWS_SYM = 485,                /* ROWS_SYM  */
+    ROW_FORMAT_SYM = 486,          /* ROW_FORMAT_SYM  */
+    ROW_SYM = 487,                 /* ROW_SYM  */
+    SET = 488,                     /* SET  */
+    SERIALIZABLE_SYM = 489,        /* SERIALIZABLE_SYM  */
+    SESSION_SYM = 490,             /* SESSION_SYM  */
+    SHUTDOWN = 491,                /* SHUTDOWN  */
+    SSL_SYM = 492,                 /* SSL_SYM  */
+    STARTING = 493,                /* STARTING  */
+    STATUS_SYM = 494,              /* STATUS_SYM  */
+    STRAIGHT_JOIN = 495,           /* STRAIGHT_JOIN  */
+    SUBJECT_SYM = 496,             /* SUBJECT_SYM  */
+    TABLES = 497,                  /* TABLES  */
+    TABLE_SYM = 498,               /* TABLE_SYM  */
+    TEMPORARY = 499,               /* TEMPORARY  */
+    TERMINATED = 500,              /* TERMINATED  */
+    TEXT_STRING = 501,             /* TEXT_STRING  */
+    TO_SYM = 502,                  /* TO_SYM  */
+    TRAILING = 503,                /* TRAILING  */
+    TRANSACTION_SYM = 504,         /* TRANSACTION_SYM  */
+    TYPE_SYM = 505,                /* TYPE_SYM  */
+    FUNC_ARG0 = 506,               /* FUNC_ARG0  */
+    FUNC_ARG1 = 507,               /* FUNC_ARG1  */
+    FUNC_ARG2 = 508,               /* FUNC_ARG2  */
+    FUNC_ARG3 = 509,               /* FUNC_ARG3  */
+    UDF_RETURNS_SYM = 510,         /* UDF_RETURNS_SYM  */
+    UDF_SONAME_SYM = 511,          /* UDF_SONAME_SYM  */
+    UDF_SYM = 512,                 /* UDF_SYM  */
+    UNCOMMITTED_SYM = 513,         /* UNCOMMITTED_SYM  */
+    UNION_SYM = 514,               /* UNION_SYM  */
+    UNIQUE_SYM = 515,              /* UNIQUE_SYM  */
+    USAGE = 516,                   /* USAGE  */
+    USE_FRM = 517,                 /* USE_FRM  */
+    USE_SYM = 518,                 /* USE_SYM  */
+    USING = 519,                   /* USING  */
+    VALUES = 520,                  /* VALUES  */
+    VARIABLES = 521,               /* VARIABLES  */
+    WHERE = 522,                   /* WHERE  */
+    WITH = 523,                    /* WITH  */
+    WRITE_SYM = 524,               /* WRITE_SYM  */
+    X509_SYM = 525,                /* X509_SYM  */
+    XOR = 526,                     /* XOR  */
+    COMPRESSED_SYM = 527,          /* COMPRESSED_SYM  */
+    BIGINT = 528,                  /* BIGINT  */
+    BLOB_SYM = 529,                /* BLOB_SYM  */
+    CHAR_SYM = 530,                /* CHAR_SYM  */
+    CHANGED = 531,                 /* CHANGED  */
+    COALESCE = 532,                /* COALESCE  */
+    DATETIME = 533,                /* DATETIME  */
+    DATE_SYM = 534,                /* DATE_SYM  */
+    DECIMAL_SYM = 535,             /* DECIMAL_SYM  */
+    DOUBLE_SYM = 536,              /* DOUBLE_SYM  */
+    ENUM = 537,                    /* ENUM  */
+    FAST_SYM = 538,                /* FAST_SYM  */
+    FLOAT_SYM = 539,               /* FLOAT_SYM  */
+    INT_SYM = 540,                 /* INT_SYM  */
+    LIMIT = 541,                   /* LIMIT  */
+    LONGBLOB = 542,                /* LONGBLOB  */
+    LONGTEXT = 543,                /* LONGTEXT  */
+    MEDIUMBLOB = 544,              /* MEDIUMBLOB  */
+    MEDIUMINT = 545,               /* MEDIUMINT  */
+    MEDIUMTEXT = 546,              /* MEDIUMTEXT  */
+    NUMERIC_SYM = 547,             /* NUMERIC_SYM  */
+    PRECISION = 548,               /* PRECISION  */
+    QUICK = 549,                   /* QUICK  */
+    REAL = 550,                    /* REAL  */
+    SIGNED_SYM = 551,              /* SIGNED_SYM  */
+    SMALLINT = 552,                /* SMALLINT  */
+    STRING_SYM = 553,              /* STRING_SYM  */
+    TEXT_SYM = 554,                /* TEXT_SYM  */
+    TIMESTAMP = 555,               /* TIMESTAMP  */
+    TIME_SYM = 556,                /* TIME_SYM  */
+    TINYBLOB = 557,                /* TINYBLOB  */
+    TINYINT = 558,                 /* TINYINT  */
+    TINYTEXT = 559,                /* TINYTEXT  */
+    ULONGLONG_NUM = 560,           /* ULONGLONG_NUM  */
+    UNSIGNED = 561,                /* UNSIGNED  */
+    VARBINARY = 562,               /* VARBINARY  */
+    VARCHAR = 563,                 /* VARCHAR  */
+    VARYING = 564,                 /* VARYING  */
+    ZEROFILL = 565,                /* ZEROFILL  */
+    AGAINST = 566,                 /* AGAINST  */
+    ATAN = 567,                    /* ATAN  */
+    BETWEEN_SYM = 568,             /* BETWEEN_SYM  */
+    BIT_AND = 569,                 /* BIT_AND  */
+    BIT_OR = 570,                  /* BIT_OR  */
+    CASE_SYM = 571,                /* CASE_SYM  */
+    CONCAT = 572,                  /* CONCAT  */
+    CONCAT_WS = 573,               /* CONCAT_WS  */
+    CURDATE = 574,                 /* CURDATE  */
+    CURTIME = 575,                 /* CURTIME  */
+    DATABASE = 576,                /* DATABASE  */
+    DATE_ADD_INTERVAL = 577,       /* DATE_ADD_INTERVAL  */
+    DATE_SUB_INTERVAL = 578,       /* DATE_SUB_INTERVAL  */
+    DAY_HOUR_SYM = 579,            /* DAY_HOUR_SYM  */
+    DAY_MINUTE_SYM = 580,          /* DAY_MINUTE_SYM  */
+    DAY_SECOND_SYM = 581,          /* DAY_SECOND_SYM  */
+    DAY_SYM = 582,                 /* DAY_SYM  */
+    DECODE_SYM = 583,              /* DECODE_SYM  */
+    DES_ENCRYPT_SYM = 584,         /* DES_ENCRYPT_SYM  */
+    DES_DECRYPT_SYM = 585,         /* DES_DECRYPT_SYM  */
+    ELSE = 586,                    /* ELSE  */
+    ELT_FUNC = 587,                /* ELT_FUNC  */
+    ENCODE_SYM = 588,              /* ENCODE_SYM  */
+    ENCRYPT = 589,                 /* ENCRYPT  */
+    EXPORT_SET = 590,              /* EXPORT_SET  */
+    EXTRACT_SYM = 591,             /* EXTRACT_SYM  */
+    FIELD_FUNC = 592,              /* FIELD_FUNC  */
+    FORMAT_SYM = 593,              /* FORMAT_SYM  */
+    FOR_SYM = 594,                 /* FOR_SYM  */
+    FROM_UNIXTIME = 595,           /* FROM_UNIXTIME  */
+    GROUP_UNIQUE_USERS = 596,      /* GROUP_UNIQUE_USERS  */
+    HOUR_MINUTE_SYM = 597,         /* HOUR_MINUTE_SYM  */
+    HOUR_SECOND_SYM = 598,         /* HOUR_SECOND_SYM  */
+    HOUR_SYM = 599,                /* HOUR_SYM  */
+    IDENTIFIED_SYM = 600,          /* IDENTIFIED_SYM  */
+    IF = 601,                      /* IF  */
+    INSERT_METHOD = 602,           /* INSERT_METHOD  */
+    INTERVAL_SYM = 603,            /* INTERVAL_SYM  */
+    LAST_INSERT_ID = 604,          /* LAST_INSERT_ID  */
+    LEFT = 605,                    /* LEFT  */
+    LOCATE = 606,                  /* LOCATE  */
+    MAKE_SET_SYM = 607,            /* MAKE_SET_SYM  */
+    MASTER_POS_WAIT = 608,         /* MASTER_POS_WAIT  */
+    MINUTE_SECOND_SYM = 609,       /* MINUTE_SECOND_SYM  */
+    MINUTE_SYM = 610,              /* MINUTE_SYM  */
+    MODE_SYM = 611,                /* MODE_SYM  */
+    MODIFY_SYM = 612,              /* MODIFY_SYM  */
+    MONTH_SYM = 613,               /* MONTH_SYM  */
+    NOW_SYM = 614,                 /* NOW_SYM  */
+    PASSWORD = 615,                /* PASSWORD  */
+    POSITION_SYM = 616,            /* POSITION_SYM  */
+    PROCEDURE = 617,               /* PROCEDURE  */
+    RAND = 618,                    /* RAND  */
+    REPLACE = 619,                 /* REPLACE  */
+    RIGHT = 620,                   /* RIGHT  */
+    ROUND = 621,                   /* ROUND  */
+    SECOND_SYM = 622,              /* SECOND_SYM  */
+    SHARE_SYM = 623,               /* SHARE_SYM  */
+    SUBSTRING = 624,               /* SUBSTRING  */
+    SUBSTRING_INDEX = 625,         /* SUBSTRING_INDEX  */
+    TRIM = 626,                    /* TRIM  */
+    UDA_CHAR_SUM = 627,            /* UDA_CHAR_SUM  */
+    UDA_FLOAT_SUM = 628,           /* UDA_FLOAT_SUM  */
+    UDA_INT_SUM = 629,             /* UDA_INT_SUM  */
+    UDF_CHAR_FUNC = 630,           /* UDF_CHAR_FUNC  */
+    UDF_FLOAT_FUNC = 631,          /* UDF_FLOAT_FUNC  */
+    UDF_INT_FUNC = 632,            /* UDF_INT_FUNC  */
+    UNIQUE_USERS = 633,            /* UNIQUE_USERS  */
+    UNIX_TIMESTAMP = 634,          /* UNIX_TIMESTAMP  */
+    USER = 635,                    /* USER  */
+    WEEK_SYM = 636,                /* WEEK_SYM  */
+    WHEN_SYM = 637,                /* WHEN_SYM  */
+    WORK_SYM = 638,                /* WORK_SYM  */
+    WORKERS_SYM = 639,             /* WORKERS_SYM  */
+    YEAR_MONTH_SYM = 640,          /* YEAR_MONTH_SYM  */
+    YEAR_SYM = 641,                /* YEAR_SYM  */
+    YEARWEEK = 642,                /* YEARWEEK  */
+    BENCHMARK_SYM = 643,           /* BENCHMARK_SYM  */
+    END = 644,                     /* END  */
+    THEN_SYM = 645,                /* THEN_SYM  */
+    SQL_BIG_RESULT = 646,          /* SQL_BIG_RESULT  */
+    SQL_CACHE_SYM = 647,           /* SQL_CACHE_SYM  */
+    SQL_CALC_FOUND_ROWS = 648,     /* SQL_CALC_FOUND_ROWS  */
+    SQL_NO_CACHE_SYM = 649,        /* SQL_NO_CACHE_SYM  */
+    SQL_SMALL_RESULT = 650,        /* SQL_SMALL_RESULT  */
+    SQL_BUFFER_RESULT = 651,       /* SQL_BUFFER_RESULT  */
+    ISSUER_SYM = 652,              /* ISSUER_SYM  */
+    CIPHER_SYM = 653,              /* CIPHER_SYM  */
+    NEG = 654                      /* NEG  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
 #define END_OF_INPUT 258
 #define CLOSE_SYM 259
 #define HANDLER_SYM 260
-#define LAST_SYM 261
-#define NEXT_SYM 262
-#define PREV_SYM 263
-#define EQ 264
-#define EQUAL_SYM 265
-#define GE 266
-#define GT_SYM 267
-#define LE 268
-#define LT 269
-#define NE 270
-#define IS 271
-#define SHIFT_LEFT 272
-#define SHIFT_RIGHT 273
-#define SET_VAR 274
-#define ABORT_SYM 275
-#define ADD 276
-#define AFTER_SYM 277
-#define ALTER 278
-#define ANALYZE_SYM 279
-#define AVG_SYM 280
-#define BEGIN_SYM 281
-#define BINLOG_SYM 282
-#define CHANGE 283
-#define CLIENT_SYM 284
-#define COMMENT_SYM 285
-#define COMMIT_SYM 286
-#define COUNT_SYM 287
-#define CREATE 288
-#define CROSS 289
-#define CUBE_SYM 290
-#define DELETE_SYM 291
-#define DO_SYM 292
-#define DROP 293
-#define EVENTS_SYM 294
-#define EXECUTE_SYM 295
-#define FLUSH_SYM 296
-#define INSERT 297
-#define IO_THREAD 298
-#define KILL_SYM 299
-#define LOAD 300
-#define LOCKS_SYM 301
-#define LOCK_SYM 302
-#define MASTER_SYM 303
-#define MAX_SYM 304
-#define MIN_SYM 305
-#define NONE_SYM 306
-#define OPTIMIZE 307
-#define PURGE 308
-#define REPAIR 309
-#define REPLICATION 310
-#define RESET_SYM 311
-#define ROLLBACK_SYM 312
-#define ROLLUP_SYM 313
-#define SAVEPOINT_SYM 314
-#define SELECT_SYM 315
-#define SHOW 316
-#define SLAVE 317
-#define SQL_THREAD 318
-#define START_SYM 319
-#define STD_SYM 320
-#define STOP_SYM 321
-#define SUM_SYM 322
-#define SUPER_SYM 323
-#define TRUNCATE_SYM 324
-#define UNLOCK_SYM 325
-#define UPDATE_SYM 326
-#define ACTION 327
-#define AGGREGATE_SYM 328
-#define ALL 329
-#define AND 330
-#define AS 331
-#define ASC 332
-#define AUTO_INC 333
-#define AVG_ROW_LENGTH 334
-#define BACKUP_SYM 335
-#define BERKELEY_DB_SYM 336
-#define BINARY 337
-#define BIT_SYM 338
-#define BOOL_SYM 339
-#define BOOLEAN_SYM 340
-#define BOTH 341
-#define BY 342
-#define CACHE_SYM 343
-#define CASCADE 344
-#define CAST_SYM 345
-#define CHARSET 346
-#define CHECKSUM_SYM 347
-#define CHECK_SYM 348
-#define COMMITTED_SYM 349
-#define COLUMNS 350
-#define COLUMN_SYM 351
-#define CONCURRENT 352
-#define CONSTRAINT 353
-#define CONVERT_SYM 354
-#define DATABASES 355
-#define DATA_SYM 356
-#define DEFAULT 357
-#define DELAYED_SYM 358
-#define DELAY_KEY_WRITE_SYM 359
-#define DESC 360
-#define DESCRIBE 361
-#define DES_KEY_FILE 362
-#define DISABLE_SYM 363
-#define DISTINCT 364
-#define DYNAMIC_SYM 365
-#define ENABLE_SYM 366
-#define ENCLOSED 367
-#define ESCAPED 368
-#define DIRECTORY_SYM 369
-#define ESCAPE_SYM 370
-#define EXISTS 371
-#define EXTENDED_SYM 372
-#define FILE_SYM 373
-#define FIRST_SYM 374
-#define FIXED_SYM 375
-#define FLOAT_NUM 376
-#define FORCE_SYM 377
-#define FOREIGN 378
-#define FROM 379
-#define FULL 380
-#define FULLTEXT_SYM 381
-#define GLOBAL_SYM 382
-#define GRANT 383
-#define GRANTS 384
-#define GREATEST_SYM 385
-#define GROUP 386
-#define HAVING 387
-#define HEAP_SYM 388
-#define HEX_NUM 389
-#define HIGH_PRIORITY 390
-#define HOSTS_SYM 391
-#define IDENT 392
-#define IGNORE_SYM 393
-#define INDEX 394
-#define INDEXES 395
-#define INFILE 396
-#define INNER_SYM 397
-#define INNOBASE_SYM 398
-#define INTO 399
-#define IN_SYM 400
-#define ISOLATION 401
-#define ISAM_SYM 402
-#define JOIN_SYM 403
-#define KEYS 404
-#define KEY_SYM 405
-#define LEADING 406
-#define LEAST_SYM 407
-#define LEVEL_SYM 408
-#define LEX_HOSTNAME 409
-#define LIKE 410
-#define LINES 411
-#define LOCAL_SYM 412
-#define LOG_SYM 413
-#define LOGS_SYM 414
-#define LONG_NUM 415
-#define LONG_SYM 416
-#define LOW_PRIORITY 417
-#define MASTER_HOST_SYM 418
-#define MASTER_USER_SYM 419
-#define MASTER_LOG_FILE_SYM 420
-#define MASTER_LOG_POS_SYM 421
-#define MASTER_PASSWORD_SYM 422
-#define MASTER_PORT_SYM 423
-#define MASTER_CONNECT_RETRY_SYM 424
-#define MASTER_SERVER_ID_SYM 425
-#define RELAY_LOG_FILE_SYM 426
-#define RELAY_LOG_POS_SYM 427
-#define MATCH 428
-#define MAX_ROWS 429
-#define MAX_CONNECTIONS_PER_HOUR 430
-#define MAX_QUERIES_PER_HOUR 431
-#define MAX_UPDATES_PER_HOUR 432
-#define MEDIUM_SYM 433
-#define MERGE_SYM 434
-#define MEMORY_SYM 435
-#define MIN_ROWS 436
-#define MYISAM_SYM 437
-#define NATIONAL_SYM 438
-#define NATURAL 439
-#define NEW_SYM 440
-#define NCHAR_SYM 441
-#define NOT 442
-#define NO_SYM 443
-#define NULL_SYM 444
-#define NUM 445
-#define OFFSET_SYM 446
-#define ON 447
-#define OPEN_SYM 448
-#define OPTION 449
-#define OPTIONALLY 450
-#define OR 451
-#define OR_OR_CONCAT 452
-#define ORDER_SYM 453
-#define OUTER 454
-#define OUTFILE 455
-#define DUMPFILE 456
-#define PACK_KEYS_SYM 457
-#define PARTIAL 458
-#define PRIMARY_SYM 459
-#define PRIVILEGES 460
-#define PROCESS 461
-#define PROCESSLIST_SYM 462
-#define QUERY_SYM 463
-#define RAID_0_SYM 464
-#define RAID_STRIPED_SYM 465
-#define RAID_TYPE 466
-#define RAID_CHUNKS 467
-#define RAID_CHUNKSIZE 468
-#define READ_SYM 469
-#define REAL_NUM 470
-#define REFERENCES 471
-#define REGEXP 472
-#define RELOAD 473
-#define RENAME 474
-#define REPEATABLE_SYM 475
-#define REQUIRE_SYM 476
-#define RESOURCES 477
-#define RESTORE_SYM 478
-#define RESTRICT 479
-#define REVOKE 480
-#define ROWS_SYM 481
-#define ROW_FORMAT_SYM 482
-#define ROW_SYM 483
-#define SET 484
-#define SERIALIZABLE_SYM 485
-#define SESSION_SYM 486
-#define SHUTDOWN 487
-#define SSL_SYM 488
-#define STARTING 489
-#define STATUS_SYM 490
-#define STRAIGHT_JOIN 491
-#define SUBJECT_SYM 492
-#define TABLES 493
-#define TABLE_SYM 494
-#define TEMPORARY 495
-#define TERMINATED 496
-#define TEXT_STRING 497
-#define TO_SYM 498
-#define TRAILING 499
-#define TRANSACTION_SYM 500
-#define TYPE_SYM 501
-#define FUNC_ARG0 502
-#define FUNC_ARG1 503
-#define FUNC_ARG2 504
-#define FUNC_ARG3 505
-#define UDF_RETURNS_SYM 506
-#define UDF_SONAME_SYM 507
-#define UDF_SYM 508
-#define UNCOMMITTED_SYM 509
-#define UNION_SYM 510
-#define UNIQUE_SYM 511
-#define USAGE 512
-#define USE_FRM 513
-#define USE_SYM 514
-#define USING 515
-#define VALUES 516
-#define VARIABLES 517
-#define WHERE 518
-#define WITH 519
-#define WRITE_SYM 520
-#define X509_SYM 521
-#define XOR 522
-#define COMPRESSED_SYM 523
-#define BIGINT 524
-#define BLOB_SYM 525
-#define CHAR_SYM 526
-#define CHANGED 527
-#define COALESCE 528
-#define DATETIME 529
-#define DATE_SYM 530
-#define DECIMAL_SYM 531
-#define DOUBLE_SYM 532
-#define ENUM 533
-#define FAST_SYM 534
-#define FLOAT_SYM 535
-#define INT_SYM 536
-#define LIMIT 537
-#define LONGBLOB 538
-#define LONGTEXT 539
-#define MEDIUMBLOB 540
-#define MEDIUMINT 541
-#define MEDIUMTEXT 542
-#define NUMERIC_SYM 543
-#define PRECISION 544
-#define QUICK 545
-#define REAL 546
-#define SIGNED_SYM 547
-#define SMALLINT 548
-#define STRING_SYM 549
-#define TEXT_SYM 550
-#define TIMESTAMP 551
-#define TIME_SYM 552
-#define TINYBLOB 553
-#define TINYINT 554
-#define TINYTEXT 555
-#define ULONGLONG_NUM 556
-#define UNSIGNED 557
-#define VARBINARY 558
-#define VARCHAR 559
-#define VARYING 560
-#define ZEROFILL 561
-#define AGAINST 562
-#define ATAN 563
-#define BETWEEN_SYM 564
-#define BIT_AND 565
-#define BIT_OR 566
-#define CASE_SYM 567
-#define CONCAT 568
-#define CONCAT_WS 569
-#define CURDATE 570
-#define CURTIME 571
-#define DATABASE 572
-#define DATE_ADD_INTERVAL 573
-#define DATE_SUB_INTERVAL 574
-#define DAY_HOUR_SYM 575
-#define DAY_MINUTE_SYM 576
-#define DAY_SECOND_SYM 577
-#define DAY_SYM 578
-#define DECODE_SYM 579
-#define DES_ENCRYPT_SYM 580
-#define DES_DECRYPT_SYM 581
-#define ELSE 582
-#define ELT_FUNC 583
-#define ENCODE_SYM 584
-#define ENCRYPT 585
-#define EXPORT_SET 586
-#define EXTRACT_SYM 587
-#define FIELD_FUNC 588
-#define FORMAT_SYM 589
-#define FOR_SYM 590
-#define FROM_UNIXTIME 591
-#define GROUP_UNIQUE_USERS 592
-#define HOUR_MINUTE_SYM 593
-#define HOUR_SECOND_SYM 594
-#define HOUR_SYM 595
-#define IDENTIFIED_SYM 596
-#define IF 597
-#define INSERT_METHOD 598
-#define INTERVAL_SYM 599
-#define LAST_INSERT_ID 600
-#define LEFT 601
-#define LOCATE 602
-#define MAKE_SET_SYM 603
-#define MASTER_POS_WAIT 604
-#define MINUTE_SECOND_SYM 605
-#define MINUTE_SYM 606
-#define MODE_SYM 607
-#define MODIFY_SYM 608
-#define MONTH_SYM 609
-#define NOW_SYM 610
-#define PASSWORD 611
-#define POSITION_SYM 612
-#define PROCEDURE 613
-#define RAND 614
-#define REPLACE 615
-#define RIGHT 616
-#define ROUND 617
-#define SECOND_SYM 618
-#define SHARE_SYM 619
-#define SUBSTRING 620
-#define SUBSTRING_INDEX 621
-#define TRIM 622
-#define UDA_CHAR_SUM 623
-#define UDA_FLOAT_SUM 624
-#define UDA_INT_SUM 625
-#define UDF_CHAR_FUNC 626
-#define UDF_FLOAT_FUNC 627
-#define UDF_INT_FUNC 628
-#define UNIQUE_USERS 629
-#define UNIX_TIMESTAMP 630
-#define USER 631
-#define WEEK_SYM 632
-#define WHEN_SYM 633
-#define WORK_SYM 634
-#define YEAR_MONTH_SYM 635
-#define YEAR_SYM 636
-#define YEARWEEK 637
-#define BENCHMARK_SYM 638
-#define END 639
-#define THEN_SYM 640
-#define SQL_BIG_RESULT 641
-#define SQL_CACHE_SYM 642
-#define SQL_CALC_FOUND_ROWS 643
-#define SQL_NO_CACHE_SYM 644
-#define SQL_SMALL_RESULT 645
-#define SQL_BUFFER_RESULT 646
-#define ISSUER_SYM 647
-#define CIPHER_SYM 648
-#define NEG 649
-
-
-
+#define HASH_SYM 261
+#define LAST_SYM 262
+#define NEXT_SYM 263
+#define PREV_SYM 264
+#define EQ 265
+#define EQUAL_SYM 266
+#define GE 267
+#define GT_SYM 268
+#define LE 269
+#define LT 270
+#define NE 271
+#define IS 272
+#define SHIFT_LEFT 273
+#define SHIFT_RIGHT 274
+#define SET_VAR 275
+#define ABORT_SYM 276
+#define ADD 277
+#define AFTER_SYM 278
+#define ALTER 279
+#define ANALYZE_SYM 280
+#define AVG_SYM 281
+#define BEGIN_SYM 282
+#define BINLOG_SYM 283
+#define CHANGE 284
+#define CLIENT_SYM 285
+#define COMMENT_SYM 286
+#define COMMIT_SYM 287
+#define COUNT_SYM 288
+#define CREATE 289
+#define CROSS 290
+#define CUBE_SYM 291
+#define DELETE_SYM 292
+#define DO_SYM 293
+#define DROP 294
+#define EVENTS_SYM 295
+#define EXECUTE_SYM 296
+#define FLUSH_SYM 297
+#define INSERT 298
+#define IO_THREAD 299
+#define KILL_SYM 300
+#define LOAD 301
+#define LOCKS_SYM 302
+#define LOCK_SYM 303
+#define MASTER_SYM 304
+#define MAX_SYM 305
+#define MIN_SYM 306
+#define NONE_SYM 307
+#define OPTIMIZE 308
+#define PURGE 309
+#define REPAIR 310
+#define REPLICATION 311
+#define RESET_SYM 312
+#define ROLLBACK_SYM 313
+#define ROLLUP_SYM 314
+#define SAVEPOINT_SYM 315
+#define SELECT_SYM 316
+#define SHOW 317
+#define SLAVE 318
+#define SQL_THREAD 319
+#define START_SYM 320
+#define STD_SYM 321
+#define STOP_SYM 322
+#define SUM_SYM 323
+#define SUPER_SYM 324
+#define TRUNCATE_SYM 325
+#define UNLOCK_SYM 326
+#define UPDATE_SYM 327
+#define ACTION 328
+#define AGGREGATE_SYM 329
+#define ALL 330
+#define AND 331
+#define AS 332
+#define ASC 333
+#define AUTO_INC 334
+#define AVG_ROW_LENGTH 335
+#define BACKUP_SYM 336
+#define BERKELEY_DB_SYM 337
+#define BINARY 338
+#define BIT_SYM 339
+#define BOOL_SYM 340
+#define BOOLEAN_SYM 341
+#define BOTH 342
+#define BTREE_SYM 343
+#define BY 344
+#define CACHE_SYM 345
+#define CASCADE 346
+#define CAST_SYM 347
+#define CHARSET 348
+#define CHECKSUM_SYM 349
+#define CHECK_SYM 350
+#define COMMITTED_SYM 351
+#define COLUMNS 352
+#define COLUMN_SYM 353
+#define CONCURRENT 354
+#define CONSTRAINT 355
+#define CONVERT_SYM 356
+#define DATABASES 357
+#define DATA_SYM 358
+#define DEFAULT 359
+#define DELAYED_SYM 360
+#define DELAY_KEY_WRITE_SYM 361
+#define DESC 362
+#define DESCRIBE 363
+#define DES_KEY_FILE 364
+#define DISABLE_SYM 365
+#define DISTINCT 366
+#define DYNAMIC_SYM 367
+#define ENABLE_SYM 368
+#define ENCLOSED 369
+#define ESCAPED 370
+#define DIRECTORY_SYM 371
+#define ESCAPE_SYM 372
+#define EXISTS 373
+#define EXTENDED_SYM 374
+#define FILE_SYM 375
+#define FIRST_SYM 376
+#define FIXED_SYM 377
+#define FLOAT_NUM 378
+#define FORCE_SYM 379
+#define FOREIGN 380
+#define FROM 381
+#define FULL 382
+#define FULLTEXT_SYM 383
+#define GLOBAL_SYM 384
+#define GRANT 385
+#define GRANTS 386
+#define GREATEST_SYM 387
+#define GROUP 388
+#define HAVING 389
+#define HEAP_SYM 390
+#define HEX_NUM 391
+#define HIGH_PRIORITY 392
+#define HOSTS_SYM 393
+#define IDENT 394
+#define IGNORE_SYM 395
+#define INDEX 396
+#define INDEXES 397
+#define INFILE 398
+#define INNER_SYM 399
+#define INNOBASE_SYM 400
+#define INTO 401
+#define IN_SYM 402
+#define ISOLATION 403
+#define ISAM_SYM 404
+#define JOIN_SYM 405
+#define KEYS 406
+#define KEY_SYM 407
+#define LEADING 408
+#define LEAST_SYM 409
+#define LEVEL_SYM 410
+#define LEX_HOSTNAME 411
+#define LIKE 412
+#define LINES 413
+#define LOCAL_SYM 414
+#define LOG_SYM 415
+#define LOGS_SYM 416
+#define LONG_NUM 417
+#define LONG_SYM 418
+#define LOW_PRIORITY 419
+#define MASTER_HOST_SYM 420
+#define MASTER_USER_SYM 421
+#define MASTER_LOG_FILE_SYM 422
+#define MASTER_LOG_POS_SYM 423
+#define MASTER_PASSWORD_SYM 424
+#define MASTER_PORT_SYM 425
+#define MASTER_CONNECT_RETRY_SYM 426
+#define MASTER_SERVER_ID_SYM 427
+#define RELAY_LOG_FILE_SYM 428
+#define RELAY_LOG_POS_SYM 429
+#define MATCH 430
+#define MAX_ROWS 431
+#define MAX_CONNECTIONS_PER_HOUR 432
+#define MAX_QUERIES_PER_HOUR 433
+#define MAX_UPDATES_PER_HOUR 434
+#define MEDIUM_SYM 435
+#define MERGE_SYM 436
+#define MEMORY_SYM 437
+#define MIN_ROWS 438
+#define MYISAM_SYM 439
+#define NATIONAL_SYM 440
+#define NATURAL 441
+#define NEW_SYM 442
+#define NCHAR_SYM 443
+#define NOT 444
+#define NO_SYM 445
+#define NULL_SYM 446
+#define NUM 447
+#define OFFSET_SYM 448
+#define ON 449
+#define OPEN_SYM 450
+#define OPTION 451
+#define OPTIONALLY 452
+#define OR 453
+#define OR_OR_CONCAT 454
+#define ORDER_SYM 455
+#define OUTER 456
+#define OUTFILE 457
+#define DUMPFILE 458
+#define PACK_KEYS_SYM 459
+#define PARTIAL 460
+#define PRIMARY_SYM 461
+#define PRIVILEGES 462
+#define PROCESS 463
+#define PROCESSLIST_SYM 464
+#define PROFILE_SYM 465
+#define PROFILES_SYM 466
+#define QUERY_SYM 467
+#define RAID_0_SYM 468
+#define RAID_STRIPED_SYM 469
+#define RAID_TYPE 470
+#define RAID_CHUNKS 471
+#define RAID_CHUNKSIZE 472
+#define READ_SYM 473
+#define REAL_NUM 474
+#define REFERENCES 475
+#define REGEXP 476
+#define RELOAD 477
+#define RENAME 478
+#define REPEATABLE_SYM 479
+#define REQUIRE_SYM 480
+#define RESOURCES 481
+#define RESTORE_SYM 482
+#define RESTRICT 483
+#define REVOKE 484
+#define ROWS_SYM 485
+#define ROW_FORMAT_SYM 486
+#define ROW_SYM 487
+#define SET 488
+#define SERIALIZABLE_SYM 489
+#define SESSION_SYM 490
+#define SHUTDOWN 491
+#define SSL_SYM 492
+#define STARTING 493
+#define STATUS_SYM 494
+#define STRAIGHT_JOIN 495
+#define SUBJECT_SYM 496
+#define TABLES 497
+#define TABLE_SYM 498
+#define TEMPORARY 499
+#define TERMINATED 500
+#define TEXT_STRING 501
+#define TO_SYM 502
+#define TRAILING 503
+#define TRANSACTION_SYM 504
+#define TYPE_SYM 505
+#define FUNC_ARG0 506
+#define FUNC_ARG1 507
+#define FUNC_ARG2 508
+#define FUNC_ARG3 509
+#define UDF_RETURNS_SYM 510
+#define UDF_SONAME_SYM 511
+#define UDF_SYM 512
+#define UNCOMMITTED_SYM 513
+#define UNION_SYM 514
+#define UNIQUE_SYM 515
+#define USAGE 516
+#define USE_FRM 517
+#define USE_SYM 518
+#define USING 519
+#define VALUES 520
+#define VARIABLES 521
+#define WHERE 522
+#define WITH 523
+#define WRITE_SYM 524
+#define X509_SYM 525
+#define XOR 526
+#define COMPRESSED_SYM 527
+#define BIGINT 528
+#define BLOB_SYM 529
+#define CHAR_SYM 530
+#define CHANGED 531
+#define COALESCE 532
+#define DATETIME 533
+#define DATE_SYM 534
+#define DECIMAL_SYM 535
+#define DOUBLE_SYM 536
+#define ENUM 537
+#define FAST_SYM 538
+#define FLOAT_SYM 539
+#define INT_SYM 540
+#define LIMIT 541
+#define LONGBLOB 542
+#define LONGTEXT 543
+#define MEDIUMBLOB 544
+#define MEDIUMINT 545
+#define MEDIUMTEXT 546
+#define NUMERIC_SYM 547
+#define PRECISION 548
+#define QUICK 549
+#define REAL 550
+#define SIGNED_SYM 551
+#define SMALLINT 552
+#define STRING_SYM 553
+#define TEXT_SYM 554
+#define TIMESTAMP 555
+#define TIME_SYM 556
+#define TINYBLOB 557
+#define TINYINT 558
+#define TINYTEXT 559
+#define ULONGLONG_NUM 560
+#define UNSIGNED 561
+#define VARBINARY 562
+#define VARCHAR 563
+#define VARYING 564
+#define ZEROFILL 565
+#define AGAINST 566
+#define ATAN 567
+#define BETWEEN_SYM 568
+#define BIT_AND 569
+#define BIT_OR 570
+#define CASE_SYM 571
+#define CONCAT 572
+#define CONCAT_WS 573
+#define CURDATE 574
+#define CURTIME 575
+#define DATABASE 576
+#define DATE_ADD_INTERVAL 577
+#define DATE_SUB_INTERVAL 578
+#define DAY_HOUR_SYM 579
+#define DAY_MINUTE_SYM 580
+#define DAY_SECOND_SYM 581
+#define DAY_SYM 582
+#define DECODE_SYM 583
+#define DES_ENCRYPT_SYM 584
+#define DES_DECRYPT_SYM 585
+#define ELSE 586
+#define ELT_FUNC 587
+#define ENCODE_SYM 588
+#define ENCRYPT 589
+#define EXPORT_SET 590
+#define EXTRACT_SYM 591
+#define FIELD_FUNC 592
+#define FORMAT_SYM 593
+#define FOR_SYM 594
+#define FROM_UNIXTIME 595
+#define GROUP_UNIQUE_USERS 596
+#define HOUR_MINUTE_SYM 597
+#define HOUR_SECOND_SYM 598
+#define HOUR_SYM 599
+#define IDENTIFIED_SYM 600
+#define IF 601
+#define INSERT_METHOD 602
+#define INTERVAL_SYM 603
+#define LAST_INSERT_ID 604
+#define LEFT 605
+#define LOCATE 606
+#define MAKE_SET_SYM 607
+#define MASTER_POS_WAIT 608
+#define MINUTE_SECOND_SYM 609
+#define MINUTE_SYM 610
+#define MODE_SYM 611
+#define MODIFY_SYM 612
+#define MONTH_SYM 613
+#define NOW_SYM 614
+#define PASSWORD 615
+#define POSITION_SYM 616
+#define PROCEDURE 617
+#define RAND 618
+#define REPLACE 619
+#define RIGHT 620
+#define ROUND 621
+#define SECOND_SYM 622
+#define SHARE_SYM 623
+#define SUBSTRING 624
+#define SUBSTRING_INDEX 625
+#define TRIM 626
+#define UDA_CHAR_SUM 627
+#define UDA_FLOAT_SUM 628
+#define UDA_INT_SUM 629
+#define UDF_CHAR_FUNC 630
+#define UDF_FLOAT_FUNC 631
+#define UDF_INT_FUNC 632
+#define UNIQUE_USERS 633
+#define UNIX_TIMESTAMP 634
+#define USER 635
+#define WEEK_SYM 636
+#define WHEN_SYM 637
+#define WORK_SYM 638
+#define WORKERS_SYM 639
+#define YEAR_MONTH_SYM 640
+#define YEAR_SYM 641
+#define YEARWEEK 642
+#define BENCHMARK_SYM 643
+#define END 644
+#define THEN_SYM 645
+#define SQL_BIG_RESULT 646
+#define SQL_CACHE_SYM 647
+#define SQL_CALC_FOUND_ROWS 648
+#define SQL_NO_CACHE_SYM 649
+#define SQL_SMALL_RESULT 650
+#define SQL_BUFFER_RESULT 651
+#define ISSUER_SYM 652
+#define CIPHER_SYM 653
+#define NEG 654
 
-#ifndef YYSTYPE
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
 #line 44 "sql_yacc.yy"
-typedef union {
+
   int  num;
   ulong ulong_num;
   ulonglong ulonglong_number;
@@ -843,6 +873,7 @@ typedef union {
   LEX_USER *lex_user;
   sys_var *variable;
   Key::Keytype key_type;
+  enum ha_key_alg key_alg;
   enum db_type db_type;
   enum row_type row_type;
   enum ha_rkey_function ha_rkey_mode;
@@ -851,14 +882,19 @@ typedef union {
   enum Item_udftype udf_type;
   thr_lock_type lock_type;
   interval_type interval;
-} yystype;
-/* Line 1281 of /usr/share/bison/yacc.c.  */
-#line 857 "y.tab.h"
-# define YYSTYPE yystype
+
+#line 895 "y.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
 
 
 
-#endif /* not BISON_Y_TAB_H */
+int yyparse (void);
+
 
+#endif /* !YY_YY_Y_TAB_H_INCLUDED  */
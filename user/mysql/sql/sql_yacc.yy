@@ -60,6 +60,7 @@ inline Item *or_or_concat(Item* A, Item* B)
   LEX_USER *lex_user;
   sys_var *variable;
   Key::Keytype key_type;
+  enum ha_key_alg key_alg;
   enum db_type db_type;
   enum row_type row_type;
   enum ha_rkey_function ha_rkey_mode;
@@ -80,6 +81,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b,int *yystacksize);
 
 %token CLOSE_SYM
 %token HANDLER_SYM
+%token HASH_SYM
 %token LAST_SYM
 %token NEXT_SYM
 %token PREV_SYM
@@ -164,6 +166,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b,int *yystacksize);
 %token	BOOL_SYM
 %token	BOOLEAN_SYM
 %token	BOTH
+%token	BTREE_SYM
 %token	BY
 %token	CACHE_SYM
 %token	CASCADE
@@ -285,6 +288,8 @@ bool my_yyoverflow(short **a, YYSTYPE **b,int *yystacksize);
 %token	PRIVILEGES
 %token	PROCESS
 %token	PROCESSLIST_SYM
+%token	PROFILE_SYM
+%token	PROFILES_SYM
 %token	QUERY_SYM
 %token	RAID_0_SYM
 %token	RAID_STRIPED_SYM
@@ -459,6 +464,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b,int *yystacksize);
 %token	WEEK_SYM
 %token	WHEN_SYM
 %token	WORK_SYM
+%token	WORKERS_SYM
 %token	YEAR_MONTH_SYM
 %token	YEAR_SYM
 %token	YEARWEEK
@@ -529,7 +535,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b,int *yystacksize);
 	literal text_literal insert_ident order_ident
 	simple_ident select_item2 expr opt_expr opt_else sum_expr in_sum_expr
 	table_wild opt_pad no_in_expr expr_expr simple_expr no_and_expr
-	using_list expr_or_default set_expr_or_default
+	using_list expr_or_default set_expr_or_default param_marker
 
 %type <item_list>
 	expr_list udf_expr_list when_list ident_list ident_list_arg
@@ -537,6 +543,9 @@ bool my_yyoverflow(short **a, YYSTYPE **b,int *yystacksize);
 %type <key_type>
 	key_type opt_unique_or_fulltext
 
+%type <key_alg>
+	key_alg opt_btree_or_hash
+
 %type <string_list>
 	key_usage_list
 
@@ -763,11 +772,11 @@ create:
 	}
 	create2
 	  {Lex->select= &Lex->select_lex;}
-	| CREATE opt_unique_or_fulltext INDEX ident ON table_ident
+	| CREATE opt_unique_or_fulltext INDEX ident key_alg ON table_ident
 	  {
 	    LEX *lex=Lex;
 	    lex->sql_command= SQLCOM_CREATE_INDEX;
-	    if (!add_table_to_list($6, NULL, TL_OPTION_UPDATING))
+	    if (!add_table_to_list($7, NULL, TL_OPTION_UPDATING))
 	      YYABORT;
 	    lex->create_list.empty();
 	    lex->key_list.empty();
@@ -777,7 +786,7 @@ create:
 	  '(' key_list ')'
 	  {
 	    LEX *lex=Lex;
-	    lex->key_list.push_back(new Key($2,$4.str,lex->col_list));
+	    lex->key_list.push_back(new Key($2,$4.str,$5,lex->col_list));
 	    lex->col_list.empty();
 	  }
 	| CREATE DATABASE opt_if_not_exists ident
@@ -954,10 +963,10 @@ column_def:
         ;
 
 key_def:
-	  key_type opt_ident '(' key_list ')'
+	  key_type opt_ident key_alg '(' key_list ')'
 	  {
 	    LEX *lex=Lex;
-	    lex->key_list.push_back(new Key($1,$2,lex->col_list));
+	    lex->key_list.push_back(new Key($1,$2,$3,lex->col_list));
 	    lex->col_list.empty();		/* Alloced by sql_alloc */
 	  }
 	| opt_constraint FOREIGN KEY_SYM opt_ident '(' key_list ')' references
@@ -1197,6 +1206,14 @@ key_part:
 	ident			{ $$=new key_part_spec($1.str); }
 	| ident '(' NUM ')'	{ $$=new key_part_spec($1.str,(uint) atoi($3.str)); };
 
+key_alg:
+	/* empty */		   { $$= HA_KEY_ALG_UNDEF; }
+	| USING opt_btree_or_hash  { $$= $2; };
+
+opt_btree_or_hash:
+	BTREE_SYM	{ $$= HA_KEY_ALG_BTREE; }
+	| HASH_SYM	{ $$= HA_KEY_ALG_HASH; };
+
 opt_ident:
 	/* empty */	{ $$=(char*) 0; }	/* Defaultlength */
 	| field_ident	{ $$=$1.str; };
@@ -1761,6 +1778,7 @@ no_and_expr:
 simple_expr:
 	simple_ident
 	| literal
+	| param_marker
 	| '@' ident_or_text SET_VAR expr
 	  {
 	    $$= new Item_func_set_user_var($2,$4);
@@ -2656,7 +2674,24 @@ fields:
 	| insert_ident		{ Lex->field_list.push_back($1); };
 
 insert_values:
-	VALUES	values_list  {}
+	VALUES	values_list
+	  {
+	    /* A row after the rows read by the lexer must follow a ',' */
+	    if (Lex->literal_values.elements)
+	    {
+	      yyerror(ER(ER_SYNTAX_ERROR));
+	      YYABORT;
+	    }
+	  }
+	| VALUES opt_more_values
+	  {
+	    /* The lexer has read the first rows to lex->literal_values */
+	    if (!Lex->literal_values.elements)
+	    {
+	      yyerror(ER(ER_SYNTAX_ERROR));
+	      YYABORT;
+	    }
+	  }
 	|     create_select     { Select->braces= 0;} opt_union {}
 	| '(' create_select ')' { Select->braces= 1;} union_opt {}
         ;
@@ -2665,6 +2700,10 @@ values_list:
 	values_list ','  no_braces
 	| no_braces;
 
+opt_more_values:
+	/* empty */ {}
+	| ',' values_list {};
+
 ident_eq_list:
 	ident_eq_list ',' ident_eq_value
 	|
@@ -2915,6 +2954,10 @@ show_param:
           { Lex->sql_command = SQLCOM_SHOW_INNODB_STATUS;}
 	| opt_full PROCESSLIST_SYM
 	  { Lex->sql_command= SQLCOM_SHOW_PROCESSLIST;}
+	| PROFILES_SYM
+	  { Lex->sql_command= SQLCOM_SHOW_PROFILES; }
+	| PROFILE_SYM opt_profile_query
+	  { Lex->sql_command= SQLCOM_SHOW_PROFILE; }
 	| opt_var_type VARIABLES wild
 	{
 	    THD *thd= current_thd;
@@ -2943,8 +2986,16 @@ show_param:
         | SLAVE STATUS_SYM
           {
 	    Lex->sql_command = SQLCOM_SHOW_SLAVE_STAT;
+          }
+        | SLAVE WORKERS_SYM
+          {
+	    Lex->sql_command = SQLCOM_SHOW_SLAVE_WORKERS;
           };
 
+opt_profile_query:
+	/* empty */  { Lex->profile_query_id= 0; }
+	| FOR_SYM QUERY_SYM ULONG_NUM { Lex->profile_query_id= $3; };
+
 opt_db:
 	/* empty */  { $$= 0; }
 	| from_or_in ident { $$= $2.str; };
@@ -3195,6 +3246,25 @@ literal:
 	| TIME_SYM text_literal { $$ = $2; }
 	| TIMESTAMP text_literal { $$ = $2; };
 
+param_marker:
+	'?'
+	{
+	  THD *thd=current_thd;
+	  LEX *lex=Lex;
+	  Item_param *item;
+	  if (thd->command != COM_PREPARE)
+	  {
+	    yyerror(ER(ER_SYNTAX_ERROR));
+	    YYABORT;
+	  }
+	  if (!(item= new Item_param((uint) (lex->tok_start -
+					     (uchar*) thd->query),
+				     lex->param_list.elements)) ||
+	      lex->param_list.push_back(item))
+	    YYABORT;
+	  $$= item;
+	};
+
 /**********************************************************************
 ** Createing different items.
 **********************************************************************/
@@ -3294,6 +3364,7 @@ keyword:
 	| BIT_SYM		{}
 	| BOOL_SYM		{}
 	| BOOLEAN_SYM		{}
+	| BTREE_SYM		{}
 	| CACHE_SYM		{}
 	| CHANGED		{}
 	| CHARSET		{}
@@ -3335,6 +3406,7 @@ keyword:
 	| GLOBAL_SYM		{}
 	| HEAP_SYM		{}
 	| HANDLER_SYM		{}
+	| HASH_SYM		{}
 	| HOSTS_SYM		{}
 	| HOUR_SYM		{}
 	| IDENTIFIED_SYM	{}
@@ -3384,6 +3456,8 @@ keyword:
 	| PREV_SYM		{}
 	| PROCESS		{}
 	| PROCESSLIST_SYM	{}
+	| PROFILE_SYM		{}
+	| PROFILES_SYM		{}
 	| QUERY_SYM		{}
 	| QUICK			{}
 	| RAID_0_SYM            {}
@@ -3435,6 +3509,7 @@ keyword:
 	| USE_FRM		{}
 	| VARIABLES		{}
 	| WORK_SYM		{}
+	| WORKERS_SYM		{}
 	| X509_SYM		{}
 	| YEAR_SYM		{};
 
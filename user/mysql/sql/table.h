@@ -98,6 +98,7 @@ struct st_table {
   my_bool db_low_byte_first;		/* Portable row format */
   my_bool locked_by_flush;
   my_bool locked_by_name;
+  my_bool thread_cached;		/* In in_use->cached_tables */
   my_bool fulltext_searched;
   my_bool crashed;
   my_bool is_view;
@@ -64,6 +64,13 @@
 
 #define MAX_SORT_MEMORY (2048*1024-MALLOC_OVERHEAD)
 #define MIN_SORT_MEMORY (32*1024-MALLOC_OVERHEAD)
+#define MAX_SORT_THREADS 64			/* Max threads in one filesort */
+#define MIN_SORT_THREAD_KEYS 4096		/* Don't sort less per thread */
+#define MAX_LOAD_THREADS 16			/* Parser threads of LOAD DATA */
+#define LOAD_CHUNK_SIZE	(256*1024)		/* Text given to a parser thread */
+#define JOIN_HASH_MIN_PARTITIONS 4		/* Partition files of hash join */
+#define JOIN_HASH_MAX_PARTITIONS 32
+#define AGGR_HASH_PART_BITS	4		/* 16 files per spilled level */
 #define EXTRA_RECORDS	10			/* Extra records in sort */
 #define SCROLL_EXTRA	5			/* Extra scroll-rows. */
 #define FIELD_NAME_USED ((uint) 32768)		/* Bit set if fieldname used */
@@ -75,6 +82,7 @@
 
 #define READ_RECORD_BUFFER	(uint) (IO_SIZE*8) /* Pointer_buffer_size */
 #define DISK_BUFFER_SIZE	(uint) (IO_SIZE*16) /* Size of diskbuffer */
+#define JOIN_HASH_BUFFER_SIZE	(uint) (IO_SIZE*2) /* Buffer of hash partition */
 #define POSTFIX_ERROR		DBL_MAX
 
 #define ME_INFO (ME_HOLDTANG+ME_OLDWIN+ME_NOREFRESH)
@@ -0,0 +1,404 @@
+/* Copyright (C) 2000 MySQL AB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Test of the prepared statements of the client library: mysql_prepare(),
+  mysql_execute() and mysql_close_stmt(), and of the binary rows that
+  mysql_execute() returns.
+
+  Usage: client_test [database [user [password [host]]]]
+
+  The table client_test is created in the database (default 'test') and
+  dropped at the end. The program prints the name of each test as it is
+  run and exits with 1 at the first failure.
+*/
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+#include "mysql.h"
+#include "mysqld_error.h"
+
+static MYSQL mysql;
+static const char *test_name;
+
+#define COLUMNS 11
+
+static const char *insert_query=
+"insert into client_test values (?,?,?,?,?,?,?,?,?,?,?)";
+
+static const char *select_query=
+"select id,ti,si,mi,bi,fl,db,ch,vc,yr,dt from client_test where id=?";
+
+
+static void die(const char *message)
+{
+  fprintf(stderr,"%s: %s\n",test_name,message);
+  if (mysql_errno(&mysql))
+    fprintf(stderr,"Error %u: %s\n",mysql_errno(&mysql),mysql_error(&mysql));
+  mysql_close(&mysql);
+  exit(1);
+}
+
+
+static void start_test(const char *name)
+{
+  test_name=name;
+  printf("%s\n",name);
+  fflush(stdout);
+}
+
+
+static void run_query(const char *query)
+{
+  if (mysql_query(&mysql,query))
+    die(query);
+}
+
+
+static ulong plan_hits()
+{
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  ulong hits;
+
+  run_query("show status like 'Prepared_stmt_plan_hits'");
+  if (!(res=mysql_store_result(&mysql)) || !(row=mysql_fetch_row(res)))
+    die("Prepared_stmt_plan_hits not found");
+  hits=strtoul(row[1],NULL,10);
+  mysql_free_result(res);
+  return hits;
+}
+
+
+/* Values of one row of client_test, as given to and read from the server */
+
+typedef struct st_test_row
+{
+  int32 id;
+  signed char ti;
+  short si;
+  int32 mi;
+  longlong bi;
+  float fl;
+  double db;
+  const char *ch,*vc;
+  short yr;
+  const char *dt;
+  my_bool null_values;			/* All columns but id are NULL */
+} TEST_ROW;
+
+static TEST_ROW test_rows[]=
+{
+  { 1, 1, 2, 3, LL(4), 1.5, 2.25, "a", "b", 2001, "2003-01-02", 0 },
+  { 2, -128, -32768, -8388608, LL(-9223372036854775807)-1, -1.5, -0.125,
+    "", "", 1970, "0000-00-00", 0 },
+  { 3, 127, 32767, 8388607, LL(9223372036854775807), 0, 1e300,
+    "c'd", "e\\f\"g", 2155, "9999-12-31", 0 },
+  { 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 }
+};
+
+#define TEST_ROWS (sizeof(test_rows)/sizeof(test_rows[0]))
+
+
+static void bind_param(MYSQL_BIND *bind, enum enum_field_types type,
+		       void *buffer, ulong length, my_bool is_null)
+{
+  bzero((char*) bind,sizeof(*bind));
+  bind->buffer_type=type;
+  bind->buffer=(char*) buffer;
+  bind->length=length;
+  bind->is_null=is_null;
+}
+
+
+static void insert_rows()
+{
+  ulong stmt_id;
+  uint param_count,i;
+  MYSQL_BIND params[COLUMNS];
+
+  start_test("insert with parameters of each type");
+  if (!(stmt_id=mysql_prepare(&mysql,insert_query,strlen(insert_query),
+			      &param_count)))
+    die("mysql_prepare failed");
+  if (param_count != COLUMNS)
+    die("wrong parameter count");
+  for (i=0 ; i < TEST_ROWS ; i++)
+  {
+    TEST_ROW *row=test_rows+i;
+    my_bool n=row->null_values;
+    bind_param(params,FIELD_TYPE_LONG,&row->id,0,0);
+    bind_param(params+1,FIELD_TYPE_TINY,&row->ti,0,n);
+    bind_param(params+2,FIELD_TYPE_SHORT,&row->si,0,n);
+    bind_param(params+3,FIELD_TYPE_INT24,&row->mi,0,n);
+    bind_param(params+4,FIELD_TYPE_LONGLONG,&row->bi,0,n);
+    bind_param(params+5,FIELD_TYPE_FLOAT,&row->fl,0,n);
+    bind_param(params+6,FIELD_TYPE_DOUBLE,&row->db,0,n);
+    bind_param(params+7,FIELD_TYPE_STRING,(void*) row->ch,
+	       n ? 0 : strlen(row->ch),n);
+    bind_param(params+8,FIELD_TYPE_VAR_STRING,(void*) row->vc,
+	       n ? 0 : strlen(row->vc),n);
+    bind_param(params+9,FIELD_TYPE_SHORT,&row->yr,0,n);
+    bind_param(params+10,FIELD_TYPE_STRING,(void*) row->dt,
+	       n ? 0 : strlen(row->dt),n);
+    if (mysql_execute(&mysql,stmt_id,params,COLUMNS) || mysql_errno(&mysql))
+      die("mysql_execute of insert failed");
+    if (mysql_affected_rows(&mysql) != 1)
+      die("insert didn't insert one row");
+  }
+  if (mysql_close_stmt(&mysql,stmt_id))
+    die("mysql_close_stmt failed");
+}
+
+
+static void check_string(const char *value, ulong length, const char *expected)
+{
+  if (!value || length != strlen(expected) || memcmp(value,expected,length))
+    die("wrong string value");
+}
+
+
+/* Check a binary row of select_query against test_rows */
+
+static void check_row(MYSQL_RES *res, TEST_ROW *row)
+{
+  MYSQL_ROW values;
+  ulong *lengths;
+  int32 id,mi;
+  signed char ti;
+  short si,yr;
+  longlong bi;
+  float fl;
+  double db;
+  uint i;
+
+  if (!(values=mysql_fetch_row(res)))
+    die("row not found");
+  lengths=mysql_fetch_lengths(res);
+  memcpy((char*) &id,values[0],sizeof(id));
+  if (lengths[0] != sizeof(id) || id != row->id)
+    die("wrong id");
+  if (row->null_values)
+  {
+    for (i=1 ; i < COLUMNS ; i++)
+      if (values[i])
+	die("column is not NULL");
+    return;
+  }
+  for (i=1 ; i < COLUMNS ; i++)
+    if (!values[i])
+      die("column is NULL");
+  ti= (signed char) values[1][0];
+  memcpy((char*) &si,values[2],sizeof(si));
+  memcpy((char*) &mi,values[3],sizeof(mi));
+  memcpy((char*) &bi,values[4],sizeof(bi));
+  memcpy((char*) &fl,values[5],sizeof(fl));
+  memcpy((char*) &db,values[6],sizeof(db));
+  memcpy((char*) &yr,values[9],sizeof(yr));
+  if (lengths[1] != 1 || ti != row->ti)
+    die("wrong tinyint");
+  if (lengths[2] != 2 || si != row->si)
+    die("wrong smallint");
+  if (lengths[3] != 4 || mi != row->mi)
+    die("wrong mediumint");
+  if (lengths[4] != 8 || bi != row->bi)
+    die("wrong bigint");
+  if (lengths[5] != 4 || fl != row->fl)
+    die("wrong float");
+  if (lengths[6] != 8 || db != row->db)
+    die("wrong double");
+  check_string(values[7],lengths[7],row->ch);
+  check_string(values[8],lengths[8],row->vc);
+  if (lengths[9] != 2 || yr != row->yr)
+    die("wrong year");
+  check_string(values[10],lengths[10],row->dt);
+}
+
+
+static void select_rows()
+{
+  ulong stmt_id,hits;
+  uint param_count,i;
+  MYSQL_BIND param;
+  MYSQL_RES *res;
+  int32 id;
+
+  start_test("select of each row through the stored plan");
+  if (!(stmt_id=mysql_prepare(&mysql,select_query,strlen(select_query),
+			      &param_count)))
+    die("mysql_prepare failed");
+  if (param_count != 1)
+    die("wrong parameter count");
+  hits=plan_hits();
+  for (i=0 ; i < TEST_ROWS ; i++)
+  {
+    id=test_rows[i].id;
+    bind_param(&param,FIELD_TYPE_LONG,&id,0,0);
+    if (!(res=mysql_execute(&mysql,stmt_id,&param,1)))
+      die("mysql_execute of select failed");
+    if (mysql_num_fields(res) != COLUMNS || mysql_num_rows(res) != 1)
+      die("wrong result set");
+    check_row(res,test_rows+i);
+    mysql_free_result(res);
+  }
+  if (plan_hits() != hits+TEST_ROWS)
+    die("the select didn't use the stored plan");
+
+  start_test("select of a missing row and of NULL through the stored plan");
+  id=5;
+  bind_param(&param,FIELD_TYPE_LONG,&id,0,0);
+  if (!(res=mysql_execute(&mysql,stmt_id,&param,1)))
+    die("mysql_execute of select failed");
+  if (mysql_num_rows(res) != 0)
+    die("found a missing row");
+  mysql_free_result(res);
+  bind_param(&param,FIELD_TYPE_LONG,&id,0,1);
+  if (!(res=mysql_execute(&mysql,stmt_id,&param,1)))
+    die("mysql_execute of select failed");
+  if (mysql_num_rows(res) != 0)
+    die("found a row with id = NULL");
+  mysql_free_result(res);
+
+  start_test("select with a string parameter, without the stored plan");
+  hits=plan_hits();
+  bind_param(&param,FIELD_TYPE_STRING,(void*) "3",1,0);
+  if (!(res=mysql_execute(&mysql,stmt_id,&param,1)))
+    die("mysql_execute of select failed");
+  if (mysql_num_rows(res) != 1)
+    die("wrong result set");
+  check_row(res,test_rows+2);
+  mysql_free_result(res);
+  if (plan_hits() != hits)
+    die("the stored plan was used for a string parameter");
+
+  start_test("execute of a closed statement");
+  if (mysql_close_stmt(&mysql,stmt_id))
+    die("mysql_close_stmt failed");
+  bind_param(&param,FIELD_TYPE_LONG,&id,0,0);
+  if ((res=mysql_execute(&mysql,stmt_id,&param,1)))
+    die("a closed statement was executed");
+  if (mysql_errno(&mysql) != ER_WRONG_ARGUMENTS)
+    die("wrong error for a closed statement");
+}
+
+
+/* A statement that is run as a query, with NULL and empty strings */
+
+static void select_query_rows()
+{
+  static const char *query=
+    "select id,concat(vc,?),ch from client_test where id > ? order by id";
+  ulong stmt_id;
+  uint param_count;
+  MYSQL_BIND params[2];
+  MYSQL_RES *res;
+  MYSQL_ROW values;
+  ulong *lengths;
+  int32 id;
+  longlong from=1;
+
+  start_test("select of several rows with NULL and empty columns");
+  if (!(stmt_id=mysql_prepare(&mysql,query,strlen(query),&param_count)))
+    die("mysql_prepare failed");
+  if (param_count != 2)
+    die("wrong parameter count");
+  bind_param(params,FIELD_TYPE_STRING,(void*) "",0,0);
+  bind_param(params+1,FIELD_TYPE_LONGLONG,&from,0,0);
+  if (!(res=mysql_execute(&mysql,stmt_id,params,2)))
+    die("mysql_execute of select failed");
+  if (mysql_num_fields(res) != 3 || mysql_num_rows(res) != 3)
+    die("wrong result set");
+
+  values=mysql_fetch_row(res);			/* id 2: empty strings */
+  lengths=mysql_fetch_lengths(res);
+  memcpy((char*) &id,values[0],sizeof(id));
+  if (id != 2)
+    die("wrong id");
+  check_string(values[1],lengths[1],"");
+  check_string(values[2],lengths[2],"");
+
+  values=mysql_fetch_row(res);			/* id 3 */
+  lengths=mysql_fetch_lengths(res);
+  check_string(values[1],lengths[1],"e\\f\"g");
+  check_string(values[2],lengths[2],"c'd");
+
+  values=mysql_fetch_row(res);			/* id 4: NULL */
+  memcpy((char*) &id,values[0],sizeof(id));
+  if (id != 4 || values[1] || values[2])
+    die("NULL columns are not NULL");
+  if (mysql_fetch_row(res))
+    die("too many rows");
+  mysql_free_result(res);
+  mysql_close_stmt(&mysql,stmt_id);
+}
+
+
+static void errors()
+{
+  static const char *show_query= "show tables";
+  static const char *bad_query= "select * from client_test where";
+  uint param_count;
+
+  start_test("prepare of a statement that is not allowed");
+  if (mysql_prepare(&mysql,show_query,strlen(show_query),&param_count))
+    die("SHOW was prepared");
+  if (mysql_errno(&mysql) != ER_NOT_ALLOWED_COMMAND)
+    die("wrong error for SHOW");
+
+  start_test("prepare of a statement with a syntax error");
+  if (mysql_prepare(&mysql,bad_query,strlen(bad_query),&param_count))
+    die("a bad statement was prepared");
+  if (mysql_errno(&mysql) != ER_PARSE_ERROR)
+    die("wrong error for a syntax error");
+
+  start_test("execute of an unknown statement");
+  if (mysql_execute(&mysql,~(ulong) 0,0,0))
+    die("an unknown statement was executed");
+  if (mysql_errno(&mysql) != ER_WRONG_ARGUMENTS)
+    die("wrong error for an unknown statement");
+}
+
+
+int main(int argc, char **argv)
+{
+  const char *db= argc > 1 ? argv[1] : "test";
+  const char *user= argc > 2 ? argv[2] : 0;
+  const char *password= argc > 3 ? argv[3] : 0;
+  const char *host= argc > 4 ? argv[4] : 0;
+
+  MY_INIT(argv[0]);
+  test_name="connect";
+  mysql_init(&mysql);
+  if (!mysql_real_connect(&mysql,host,user,password,db,0,NULL,0))
+    die("Couldn't connect to the server");
+
+  run_query("drop table if exists client_test");
+  run_query("create table client_test (id int not null primary key, "
+	    "ti tinyint, si smallint, mi mediumint, bi bigint, fl float, "
+	    "db double, ch char(10), vc varchar(20), yr year, dt date)");
+  insert_rows();
+  select_rows();
+  select_query_rows();
+  errors();
+  run_query("drop table client_test");
+
+  mysql_close(&mysql);
+  printf("ok\n");
+  my_end(0);
+  exit(0);
+  return 0;					/* Keep some compilers happy */
+}